@@ -480,6 +480,23 @@ Object *ClassDB::instance(const StringName &p_class) {
 
 	return ti->creation_func();
 }
+const ClassDB::ClassInfo *ClassDB::get_instantiable_class(const StringName &p_class) {
+
+	OBJTYPE_RLOCK;
+
+	ClassInfo *ti = classes.getptr(p_class);
+	if (!ti || ti->disabled || !ti->creation_func) {
+		if (compat_classes.has(p_class)) {
+			ti = classes.getptr(compat_classes[p_class]);
+		}
+	}
+
+	if (!ti || ti->disabled || !ti->creation_func)
+		return NULL;
+
+	return ti;
+}
+
 bool ClassDB::can_instance(const StringName &p_class) {
 
 	OBJTYPE_RLOCK;
@@ -1002,6 +1019,20 @@ bool ClassDB::set_property(Object *p_object, const StringName &p_property, const
 
 	return false;
 }
+const ClassDB::PropertySetGet *ClassDB::get_property_setget(const StringName &p_class, const StringName &p_property) {
+
+	ClassInfo *check = classes.getptr(p_class);
+	while (check) {
+		const PropertySetGet *psg = check->property_setget.getptr(p_property);
+		if (psg)
+			return psg;
+
+		check = check->inherits_ptr;
+	}
+
+	return NULL;
+}
+
 bool ClassDB::get_property(Object *p_object, const StringName &p_property, Variant &r_value) {
 
 	ClassInfo *type = classes.getptr(p_object->get_class_name());
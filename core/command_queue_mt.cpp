@@ -31,85 +31,105 @@
 
 #include "os/os.h"
 
-void CommandQueueMT::lock() {
+void CommandQueueMT::wait_for_flush() {
 
-	if (mutex)
-		mutex->lock();
+	// wait one millisecond for a flush to happen
+	OS::get_singleton()->delay_usec(1000);
 }
 
-void CommandQueueMT::unlock() {
+void CommandQueueMT::_wait_for_room(uint32_t p_end) {
 
-	if (mutex)
-		mutex->unlock();
-}
+	while (p_end - static_cast<volatile uint32_t &>(read_pos) > COMMAND_MEM_SIZE) {
 
-void CommandQueueMT::wait_for_flush() {
-
-	// wait one millisecond for a flush to happen
-	OS::get_singleton()->delay_usec(1000);
+		// The queue is full, make sure it's being flushed.
+		if (sync)
+			sync->post();
+		wait_for_flush();
+	}
 }
 
 CommandQueueMT::SyncSemaphore *CommandQueueMT::_alloc_sync_sem() {
 
-	int idx = -1;
-
 	while (true) {
 
-		lock();
 		for (int i = 0; i < SYNC_SEMAPHORES; i++) {
 
-			if (!sync_sems[i].in_use) {
-				sync_sems[i].in_use = true;
-				idx = i;
-				break;
-			}
-		}
-		unlock();
+			if (static_cast<volatile uint32_t &>(sync_sems[i].in_use))
+				continue;
 
-		if (idx == -1) {
-			wait_for_flush();
-		} else {
-			break;
+			if (atomic_increment(&sync_sems[i].in_use) == 1)
+				return &sync_sems[i];
+
+			atomic_decrement(&sync_sems[i].in_use);
 		}
+
+		wait_for_flush();
 	}
+}
 
-	return &sync_sems[idx];
+void CommandQueueMT::_free_sync_sem(SyncSemaphore *p_sem) {
+
+	atomic_decrement(&p_sem->in_use);
 }
 
-bool CommandQueueMT::dealloc_one() {
-tryagain:
-	if (dealloc_ptr == write_ptr) {
-		// The queue is empty
-		return false;
-	}
+void CommandQueueMT::sync_rets() {
+
+	SyncSemaphore *ss = _alloc_sync_sem();
+	SyncPointCommand *cmd = allocate<SyncPointCommand>();
+	cmd->sync_sem = ss;
+	commit(cmd);
+	ss->sem->wait();
+	_free_sync_sem(ss);
+}
+
+void CommandQueueMT::wait_and_flush_one() {
+
+	ERR_FAIL_COND(!sync);
+
+	while (!flush_one()) {
 
-	uint32_t size = *(uint32_t *)&command_mem[dealloc_ptr];
+		if (!_is_empty()) {
+			// A producer is still writing the next command.
+			OS::get_singleton()->delay_usec(0);
+			continue;
+		}
+
+		atomic_increment(&sleeping);
 
-	if (size == 0) {
-		// End of command buffer wrap down
-		dealloc_ptr = 0;
-		goto tryagain;
+		// Check again now that producers can see us sleeping, or a wakeup could be lost.
+		if (_is_empty())
+			sync->wait();
+
+		atomic_decrement(&sleeping);
 	}
+}
+
+void CommandQueueMT::flush_all() {
+
+	// Commands reserved before this call are waited for, even if they are still being written.
+	uint32_t end = static_cast<volatile uint32_t &>(write_pos);
+
+	while (int32_t(end - static_cast<volatile uint32_t &>(read_pos)) > 0) {
 
-	if (size & 1) {
-		// Still used, nothing can be deallocated
-		return false;
+		if (!flush_one())
+			OS::get_singleton()->delay_usec(0);
 	}
 
-	dealloc_ptr += (size >> 1) + sizeof(uint32_t);
-	return true;
+	while (flush_one())
+		;
 }
 
 CommandQueueMT::CommandQueueMT(bool p_sync) {
 
-	read_ptr = 0;
-	write_ptr = 0;
-	mutex = Mutex::create();
+	zeromem(command_mem, COMMAND_MEM_SIZE);
+	write_pos = 0;
+	read_pos = 0;
+	sleeping = 0;
 
 	for (int i = 0; i < SYNC_SEMAPHORES; i++) {
 
 		sync_sems[i].sem = Semaphore::create();
-		sync_sems[i].in_use = false;
+		sync_sems[i].in_use = 0;
 	}
 	if (p_sync)
 		sync = Semaphore::create();
@@ -121,7 +141,6 @@ CommandQueueMT::~CommandQueueMT() {
 
 	if (sync)
 		memdelete(sync);
-	memdelete(mutex);
 	for (int i = 0; i < SYNC_SEMAPHORES; i++) {
 
 		memdelete(sync_sems[i].sem);
@@ -30,9 +30,10 @@
 #ifndef COMMAND_QUEUE_MT_H
 #define COMMAND_QUEUE_MT_H
 
+#include "os/copymem.h"
 #include "os/memory.h"
-#include "os/mutex.h"
 #include "os/semaphore.h"
+#include "safe_refcount.h"
 #include "simple_type.h"
 #include "typedefs.h"
 /**
@@ -220,12 +221,11 @@
 #define DECL_PUSH(N)                                                         \
 	template <class T, class M COMMA(N) COMMA_SEP_LIST(TYPE_PARAM, N)>       \
 	void push(T *p_instance, M p_method COMMA(N) COMMA_SEP_LIST(PARAM, N)) { \
-		CMD_TYPE(N) *cmd = allocate_and_lock<CMD_TYPE(N)>();                 \
+		CMD_TYPE(N) *cmd = allocate<CMD_TYPE(N)>();                          \
 		cmd->instance = p_instance;                                          \
 		cmd->method = p_method;                                              \
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                 \
-		unlock();                                                            \
-		if (sync) sync->post();                                              \
+		commit(cmd);                                                         \
 	}
 
 #define CMD_RET_TYPE(N) CommandRet##N<T, M, COMMA_SEP_LIST(TYPE_ARG, N) COMMA(N) R>
@@ -234,15 +234,27 @@
 	template <class T, class M, COMMA_SEP_LIST(TYPE_PARAM, N) COMMA(N) class R>                \
 	void push_and_ret(T *p_instance, M p_method, COMMA_SEP_LIST(PARAM, N) COMMA(N) R *r_ret) { \
 		SyncSemaphore *ss = _alloc_sync_sem();                                                 \
-		CMD_RET_TYPE(N) *cmd = allocate_and_lock<CMD_RET_TYPE(N)>();                           \
+		CMD_RET_TYPE(N) *cmd = allocate<CMD_RET_TYPE(N)>();                                    \
 		cmd->instance = p_instance;                                                            \
 		cmd->method = p_method;                                                                \
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                                   \
 		cmd->ret = r_ret;                                                                      \
 		cmd->sync_sem = ss;                                                                    \
-		unlock();                                                                              \
-		if (sync) sync->post();                                                                \
+		commit(cmd);                                                                           \
 		ss->sem->wait();                                                                       \
+		_free_sync_sem(ss);                                                                    \
+	}
+
+#define DECL_PUSH_RET(N)                                                                   \
+	template <class T, class M, COMMA_SEP_LIST(TYPE_PARAM, N) COMMA(N) class R>            \
+	void push_ret(T *p_instance, M p_method, COMMA_SEP_LIST(PARAM, N) COMMA(N) R *r_ret) { \
+		CMD_RET_TYPE(N) *cmd = allocate<CMD_RET_TYPE(N)>();                                \
+		cmd->instance = p_instance;                                                        \
+		cmd->method = p_method;                                                            \
+		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                               \
+		cmd->ret = r_ret;                                                                  \
+		cmd->sync_sem = NULL;                                                              \
+		commit(cmd);                                                                       \
 	}
 
 #define CMD_SYNC_TYPE(N) CommandSync##N<T, M COMMA(N) COMMA_SEP_LIST(TYPE_ARG, N)>
@@ -251,24 +263,31 @@
 	template <class T, class M COMMA(N) COMMA_SEP_LIST(TYPE_PARAM, N)>                \
 	void push_and_sync(T *p_instance, M p_method COMMA(N) COMMA_SEP_LIST(PARAM, N)) { \
 		SyncSemaphore *ss = _alloc_sync_sem();                                        \
-		CMD_SYNC_TYPE(N) *cmd = allocate_and_lock<CMD_SYNC_TYPE(N)>();                \
+		CMD_SYNC_TYPE(N) *cmd = allocate<CMD_SYNC_TYPE(N)>();                         \
 		cmd->instance = p_instance;                                                   \
 		cmd->method = p_method;                                                       \
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                          \
 		cmd->sync_sem = ss;                                                           \
-		unlock();                                                                     \
-		if (sync) sync->post();                                                       \
+		commit(cmd);                                                                  \
 		ss->sem->wait();                                                              \
+		_free_sync_sem(ss);                                                           \
 	}
 
 #define MAX_CMD_PARAMS 12
 
+/**
+	Commands are pushed without locks: producers reserve their space in the ring with an atomic add,
+	write the command and then publish it by setting its header, so the position in the ring orders
+	the commands of all producers while keeping the order of each one of them. A single thread flushes,
+	and it is only woken up when it went to sleep on an empty queue.
+*/
+
 class CommandQueueMT {
 
 	struct SyncSemaphore {
 
 		Semaphore *sem;
-		bool in_use;
+		uint32_t in_use; // owner plus the callers that failed to take it
 	};
 
 	struct CommandBase {
@@ -280,14 +299,19 @@ class CommandQueueMT {
 
 	struct SyncCommand : public CommandBase {
 
-		SyncSemaphore *sync_sem;
+		SyncSemaphore *sync_sem; // NULL if nobody waits for this command
 
 		virtual void post() {
-			sync_sem->sem->post();
-			sync_sem->in_use = false;
+			if (sync_sem)
+				sync_sem->sem->post();
 		}
 	};
 
+	struct SyncPointCommand : public SyncCommand {
+
+		virtual void call() {}
+	};
+
 	DECL_CMD(0)
 	SPACE_SEP_LIST(DECL_CMD, 12)
 
@@ -304,129 +328,115 @@ class CommandQueueMT {
 	enum {
 		COMMAND_MEM_SIZE_KB = 256,
 		COMMAND_MEM_SIZE = COMMAND_MEM_SIZE_KB * 1024,
-		SYNC_SEMAPHORES = 8
+		COMMAND_MEM_MASK = COMMAND_MEM_SIZE - 1,
+		COMMAND_ALIGN = 8,
+		SYNC_SEMAPHORES = 16
 	};
 
-	uint8_t command_mem[COMMAND_MEM_SIZE];
-	uint32_t read_ptr;
-	uint32_t write_ptr;
-	uint32_t dealloc_ptr;
+	// Every command starts with a header, which stays zero until the command is published.
+	enum {
+		HEADER_SIZE = 8, // keeps the commands aligned
+		HEADER_PUBLISHED = 1,
+		HEADER_PADDING = 2, // no command, the space was skipped to not wrap one around the end
+		HEADER_FLAGS = COMMAND_ALIGN - 1
+	};
+
+	uint8_t command_mem[COMMAND_MEM_SIZE]; // unused space is kept zeroed
+	uint32_t write_pos; // reserved by producers, only grows (wrapping around)
+	uint32_t read_pos; // flushed, only grows (wrapping around)
+	uint32_t sleeping;
 	SyncSemaphore sync_sems[SYNC_SEMAPHORES];
-	Mutex *mutex;
 	Semaphore *sync;
 
 	template <class T>
-	T *allocate() {
+	_FORCE_INLINE_ static uint32_t _get_slot_size() {
 
-		// alloc size is size+T+safeguard
-		uint32_t alloc_size = sizeof(T) + sizeof(uint32_t);
-
-	tryagain:
-
-		if (write_ptr < dealloc_ptr) {
-			// behind dealloc_ptr, check that there is room
-			if ((dealloc_ptr - write_ptr) <= alloc_size) {
+		return (HEADER_SIZE + sizeof(T) + COMMAND_ALIGN - 1) & ~uint32_t(COMMAND_ALIGN - 1);
+	}
 
-				// There is no more room, try to deallocate something
-				if (dealloc_one()) {
-					goto tryagain;
-				}
-				return NULL;
-			}
-		} else if (write_ptr >= dealloc_ptr) {
-			// ahead of dealloc_ptr, check that there is room
+	template <class T>
+	T *allocate() {
 
-			if ((COMMAND_MEM_SIZE - write_ptr) < alloc_size + sizeof(uint32_t)) {
-				// no room at the end, wrap down;
+		uint32_t size = _get_slot_size<T>();
+		uint32_t offset;
 
-				if (dealloc_ptr == 0) { // don't want write_ptr to become dealloc_ptr
+		while (true) {
 
-					// There is no more room, try to deallocate something
-					if (dealloc_one()) {
-						goto tryagain;
-					}
-					return NULL;
-				}
+			uint32_t pos = atomic_add(&write_pos, size) - size;
+			_wait_for_room(pos + size);
 
-				// if this happens, it's a bug
-				ERR_FAIL_COND_V((COMMAND_MEM_SIZE - write_ptr) < sizeof(uint32_t), NULL);
-				// zero means, wrap to beginning
+			offset = pos & COMMAND_MEM_MASK;
+			if (offset + size <= COMMAND_MEM_SIZE)
+				break;
 
-				uint32_t *p = (uint32_t *)&command_mem[write_ptr];
-				*p = 0;
-				write_ptr = 0;
-				goto tryagain;
-			}
+			// The space wraps around the end, give up both parts and reserve again.
+			uint32_t tail = COMMAND_MEM_SIZE - offset;
+			_publish(offset, tail | HEADER_PADDING);
+			_publish(0, (size - tail) | HEADER_PADDING);
 		}
-		// Allocate the size and the 'in use' bit.
-		// First bit used to mark if command is still in use (1)
-		// or if it has been destroyed and can be deallocated (0).
-		uint32_t *p = (uint32_t *)&command_mem[write_ptr];
-		*p = (sizeof(T) << 1) | 1;
-		write_ptr += sizeof(uint32_t);
-		// allocate the command
-		T *cmd = memnew_placement(&command_mem[write_ptr], T);
-		write_ptr += sizeof(T);
-		return cmd;
+
+		return memnew_placement(&command_mem[offset + HEADER_SIZE], T);
 	}
 
 	template <class T>
-	T *allocate_and_lock() {
+	_FORCE_INLINE_ void commit(T *p_cmd) {
 
-		lock();
-		T *ret;
+		uint32_t offset = reinterpret_cast<uint8_t *>(p_cmd) - command_mem - HEADER_SIZE;
+		_publish(offset, _get_slot_size<T>());
+	}
 
-		while ((ret = allocate<T>()) == NULL) {
+	_FORCE_INLINE_ void _publish(uint32_t p_offset, uint32_t p_header) {
 
-			unlock();
-			// sleep a little until fetch happened and some room is made
-			wait_for_flush();
-			lock();
-		}
+		// The atomic add is a full barrier, the command is written before it can be seen published.
+		atomic_add(reinterpret_cast<uint32_t *>(&command_mem[p_offset]), p_header | HEADER_PUBLISHED);
 
-		return ret;
+		// Wakeups are only needed when the flushing thread went to sleep, not for every command.
+		if (sync && static_cast<volatile uint32_t &>(sleeping) > 0)
+			sync->post();
 	}
 
-	bool flush_one(bool p_lock = true) {
-		if (p_lock) lock();
-	tryagain:
+	_FORCE_INLINE_ bool _is_empty() const {
 
-		// tried to read an empty queue
-		if (read_ptr == write_ptr)
-			return false;
+		return static_cast<const volatile uint32_t &>(read_pos) == static_cast<const volatile uint32_t &>(write_pos);
+	}
 
-		uint32_t size_ptr = read_ptr;
-		uint32_t size = *(uint32_t *)&command_mem[read_ptr] >> 1;
+	bool flush_one() {
 
-		if (size == 0) {
-			//end of ringbuffer, wrap
-			read_ptr = 0;
-			goto tryagain;
-		}
+		while (!_is_empty()) {
 
-		read_ptr += sizeof(uint32_t);
+			uint32_t offset = read_pos & COMMAND_MEM_MASK;
+			uint32_t *header = reinterpret_cast<uint32_t *>(&command_mem[offset]);
 
-		CommandBase *cmd = reinterpret_cast<CommandBase *>(&command_mem[read_ptr]);
+			// Read with a barrier, the command must not be read before its header.
+			uint32_t h = atomic_add(header, 0);
+			if (!(h & HEADER_PUBLISHED))
+				return false; // reserved, but still being written
 
-		read_ptr += size;
+			uint32_t size = h & ~uint32_t(HEADER_FLAGS);
 
-		if (p_lock) unlock();
-		cmd->call();
-		if (p_lock) lock();
+			if (!(h & HEADER_PADDING)) {
 
-		cmd->post();
-		cmd->~CommandBase();
-		*(uint32_t *)&command_mem[size_ptr] &= ~1;
+				CommandBase *cmd = reinterpret_cast<CommandBase *>(&command_mem[offset + HEADER_SIZE]);
+				cmd->call();
+				cmd->post();
+				cmd->~CommandBase();
+			}
+
+			// Producers may write here again once read_pos is past it.
+			zeromem(header, size);
+			atomic_add(&read_pos, size);
+
+			if (!(h & HEADER_PADDING))
+				return true;
+		}
 
-		if (p_lock) unlock();
-		return true;
+		return false;
 	}
 
-	void lock();
-	void unlock();
 	void wait_for_flush();
+	void _wait_for_room(uint32_t p_end);
 	SyncSemaphore *_alloc_sync_sem();
-	bool dealloc_one();
+	void _free_sync_sem(SyncSemaphore *p_sem);
 
 public:
 	/* NORMAL PUSH COMMANDS */
@@ -437,24 +447,19 @@ public:
 	DECL_PUSH_AND_RET(0)
 	SPACE_SEP_LIST(DECL_PUSH_AND_RET, 12)
 
+	/* PUSH RET COMMANDS, the results are ready once sync_rets() returns */
+	DECL_PUSH_RET(0)
+	SPACE_SEP_LIST(DECL_PUSH_RET, 12)
+
 	/* PUSH AND RET SYNC COMMANDS*/
 	DECL_PUSH_AND_SYNC(0)
 	SPACE_SEP_LIST(DECL_PUSH_AND_SYNC, 12)
 
-	void wait_and_flush_one() {
-		ERR_FAIL_COND(!sync);
-		sync->wait();
-		flush_one();
-	}
-
-	void flush_all() {
+	// Waits for the commands pushed before by this thread, so several push_ret() cost a single wait.
+	void sync_rets();
 
-		//ERR_FAIL_COND(sync);
-		lock();
-		while (flush_one(false))
-			;
-		unlock();
-	}
+	void wait_and_flush_one();
+	void flush_all();
 
 	CommandQueueMT(bool p_sync);
 	~CommandQueueMT();
@@ -473,6 +478,7 @@ public:
 #undef DECL_PUSH
 #undef CMD_RET_TYPE
 #undef DECL_PUSH_AND_RET
+#undef DECL_PUSH_RET
 #undef CMD_SYNC_TYPE
 #undef DECL_CMD_SYNC
 
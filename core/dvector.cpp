@@ -29,6 +29,8 @@
 /*************************************************************************/
 #include "dvector.h"
 
+#include "os/os.h"
+
 Mutex *dvector_lock = NULL;
 
 PoolAllocator *MemoryPool::memory_pool = NULL;
@@ -44,6 +46,162 @@ Mutex *MemoryPool::alloc_mutex = NULL;
 size_t MemoryPool::total_memory = 0;
 size_t MemoryPool::max_memory = 0;
 
+MemoryPool::ThreadCache *MemoryPool::thread_caches = NULL;
+
+#if defined(NO_THREADS)
+static MemoryPool::ThreadCache *thread_cache = NULL;
+#elif defined(_MSC_VER)
+static __declspec(thread) MemoryPool::ThreadCache *thread_cache = NULL;
+#else
+static __thread MemoryPool::ThreadCache *thread_cache = NULL;
+#endif
+
+MemoryPool::ThreadCache *MemoryPool::_get_thread_cache() {
+
+	if (likely(thread_cache))
+		return thread_cache;
+
+	alloc_mutex->lock();
+
+	// Caches are kept on the heap, so their allocs can still be taken after their thread is gone.
+	ThreadCache *cache = thread_caches;
+	while (cache && cache->in_use) {
+		cache = cache->next;
+	}
+
+	if (!cache) {
+		cache = memnew(ThreadCache);
+		cache->lock = 0;
+		cache->free_list = NULL;
+		cache->count = 0;
+		cache->next = thread_caches;
+		thread_caches = cache;
+	}
+
+	cache->in_use = true;
+
+	alloc_mutex->unlock();
+
+	thread_cache = cache;
+	return cache;
+}
+
+void MemoryPool::_wait_for_cache(ThreadCache *p_cache) {
+
+	int spins = 0;
+	do {
+		atomic_decrement(&p_cache->lock);
+		while (static_cast<volatile uint32_t &>(p_cache->lock)) {
+			if (++spins > 64 && OS::get_singleton()) {
+				// the owner may not be running, give it the chance
+				OS::get_singleton()->delay_usec(0);
+			}
+		}
+	} while (atomic_increment(&p_cache->lock) != 1);
+}
+
+bool MemoryPool::_refill(ThreadCache *p_cache) {
+
+	alloc_mutex->lock();
+
+	if (!free_list) {
+
+		ThreadCache *caches = thread_caches;
+		alloc_mutex->unlock();
+
+		// Take all the allocs some other thread keeps, it may never use them again.
+		// The own cache is empty, and unlocked meanwhile so two threads doing this can't deadlock.
+		_unlock_cache(p_cache);
+
+		Alloc *taken = NULL;
+		uint32_t count = 0;
+		for (ThreadCache *cache = caches; cache && !taken; cache = cache->next) {
+
+			if (cache == p_cache)
+				continue;
+
+			_lock_cache(cache);
+			taken = cache->free_list;
+			count = cache->count;
+			cache->free_list = NULL;
+			cache->count = 0;
+			_unlock_cache(cache);
+		}
+
+		_lock_cache(p_cache);
+
+		if (!taken)
+			return false;
+
+		// only this thread adds to its cache, so it's still empty
+		p_cache->free_list = taken;
+		p_cache->count = count;
+		return true;
+	}
+
+	Alloc *first = free_list;
+	Alloc *last = first;
+	uint32_t count = 1;
+	while (count < ALLOC_BATCH && last->free_list) {
+		last = last->free_list;
+		count++;
+	}
+
+	free_list = last->free_list;
+	allocs_used += count;
+
+	alloc_mutex->unlock();
+
+	last->free_list = p_cache->free_list;
+	p_cache->free_list = first;
+	p_cache->count += count;
+
+	return true;
+}
+
+void MemoryPool::_flush(ThreadCache *p_cache, uint32_t p_count) {
+
+	if (p_count == 0)
+		return;
+
+	Alloc *first = p_cache->free_list;
+	Alloc *last = first;
+	for (uint32_t i = 1; i < p_count; i++) {
+		last = last->free_list;
+	}
+
+	p_cache->free_list = last->free_list;
+	p_cache->count -= p_count;
+
+	alloc_mutex->lock();
+
+	last->free_list = free_list;
+	free_list = first;
+	allocs_used -= p_count;
+
+	alloc_mutex->unlock();
+}
+
+void MemoryPool::release_thread_cache() {
+
+	if (!alloc_mutex)
+		return; // not set up yet or already cleaned up
+
+	ThreadCache *cache = thread_cache;
+	if (!cache)
+		return;
+
+	_lock_cache(cache);
+	_flush(cache, cache->count);
+	_unlock_cache(cache);
+
+	alloc_mutex->lock();
+	cache->in_use = false;
+	alloc_mutex->unlock();
+
+	thread_cache = NULL;
+}
+
 void MemoryPool::setup(uint32_t p_max_allocs) {
 
 	allocs = memnew_arr(Alloc, p_max_allocs);
@@ -62,8 +220,20 @@ void MemoryPool::setup(uint32_t p_max_allocs) {
 
 void MemoryPool::cleanup() {
 
+	release_thread_cache();
+
+	// threads not created by Thread never release theirs
+	while (thread_caches) {
+
+		ThreadCache *next = thread_caches->next;
+		allocs_used -= thread_caches->count;
+		memdelete(thread_caches);
+		thread_caches = next;
+	}
+
 	memdelete_arr(allocs);
 	memdelete(alloc_mutex);
+	alloc_mutex = NULL;
 
 	ERR_EXPLAINC("There are still MemoryPool allocs in use at exit!");
 	ERR_FAIL_COND(allocs_used > 0);
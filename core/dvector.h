@@ -64,14 +64,110 @@ struct MemoryPool {
 		}
 	};
 
+	/*
+	Each thread keeps a few free allocs of its own and trades them in batches
+	with the shared free list, so alloc_mutex is only taken once every
+	ALLOC_BATCH allocations or frees. Allocs freed by a thread other than the
+	one that took them go to the freeing thread, which gives back the excess.
+
+	When the shared list runs out, the allocs kept by other threads are taken
+	instead, so threads that went idle, or that were not created by Thread
+	and never release their cache, don't make the pool look exhausted.
+	*/
+
+	enum {
+		ALLOC_BATCH = 32
+	};
+
+	struct ThreadCache {
+
+		uint32_t lock; // the owner takes it around every use, other threads to take its allocs
+		Alloc *free_list;
+		uint32_t count;
+		bool in_use; // false once released, then the next new thread takes it
+		ThreadCache *next;
+	};
+
 	static Alloc *allocs;
 	static Alloc *free_list;
 	static uint32_t alloc_count;
-	static uint32_t allocs_used;
+	static uint32_t allocs_used; // out of the shared free list, includes the ones kept by threads
 	static Mutex *alloc_mutex;
+	static ThreadCache *thread_caches; // all of them, kept until cleanup
 	static size_t total_memory;
 	static size_t max_memory;
 
+	static ThreadCache *_get_thread_cache();
+	static void _wait_for_cache(ThreadCache *p_cache);
+	static bool _refill(ThreadCache *p_cache);
+	static void _flush(ThreadCache *p_cache, uint32_t p_count);
+
+	_FORCE_INLINE_ static void _lock_cache(ThreadCache *p_cache) {
+
+		if (unlikely(atomic_increment(&p_cache->lock) != 1))
+			_wait_for_cache(p_cache);
+	}
+
+	_FORCE_INLINE_ static void _unlock_cache(ThreadCache *p_cache) {
+
+		atomic_decrement(&p_cache->lock);
+	}
+
+	// NULL if all allocs are in use.
+	_FORCE_INLINE_ static Alloc *take_alloc() {
+
+		ThreadCache *cache = _get_thread_cache();
+		_lock_cache(cache);
+
+		Alloc *alloc = cache->free_list;
+		if (unlikely(!alloc)) {
+
+			if (!_refill(cache)) {
+				_unlock_cache(cache);
+				return NULL;
+			}
+			alloc = cache->free_list;
+		}
+
+		cache->free_list = alloc->free_list;
+		cache->count--;
+
+		_unlock_cache(cache);
+		return alloc;
+	}
+
+	_FORCE_INLINE_ static void give_back_alloc(Alloc *p_alloc) {
+
+		ThreadCache *cache = _get_thread_cache();
+		_lock_cache(cache);
+
+		p_alloc->free_list = cache->free_list;
+		cache->free_list = p_alloc;
+		cache->count++;
+
+		if (unlikely(cache->count > ALLOC_BATCH * 2)) {
+			_flush(cache, ALLOC_BATCH);
+		}
+
+		_unlock_cache(cache);
+	}
+
+	// Gives the allocs kept by the calling thread back to the shared free list, threads call it when they end.
+	static void release_thread_cache();
+
+#ifdef DEBUG_ENABLED
+	_FORCE_INLINE_ static void memory_added(size_t p_size) {
+
+		size_t total = atomic_add(&total_memory, p_size);
+		atomic_exchange_if_greater(&max_memory, total);
+	}
+
+	_FORCE_INLINE_ static void memory_removed(size_t p_size) {
+
+		atomic_sub(&total_memory, p_size);
+	}
+#endif
+
 	static void setup(uint32_t p_max_allocs = (1 << 16));
 	static void cleanup();
 };
@@ -98,20 +194,14 @@ class PoolVector {
 
 		//must allocate something
 
-		MemoryPool::alloc_mutex->lock();
-		if (MemoryPool::allocs_used == MemoryPool::alloc_count) {
-			MemoryPool::alloc_mutex->unlock();
+		MemoryPool::Alloc *new_alloc = MemoryPool::take_alloc();
+		if (!new_alloc) {
 			ERR_EXPLAINC("All memory pool allocations are in use, can't COW.");
 			ERR_FAIL();
 		}
 
 		MemoryPool::Alloc *old_alloc = alloc;
-
-		//take one from the free list
-		alloc = MemoryPool::free_list;
-		MemoryPool::free_list = alloc->free_list;
-		//increment the used counter
-		MemoryPool::allocs_used++;
+		alloc = new_alloc;
 
 		//copy the alloc data
 		alloc->size = old_alloc->size;
@@ -120,14 +210,9 @@ class PoolVector {
 		alloc->lock = 0;
 
 #ifdef DEBUG_ENABLED
-		MemoryPool::total_memory += alloc->size;
-		if (MemoryPool::total_memory > MemoryPool::max_memory) {
-			MemoryPool::max_memory = MemoryPool::total_memory;
-		}
+		MemoryPool::memory_added(alloc->size);
 #endif
 
-		MemoryPool::alloc_mutex->unlock();
-
 		if (MemoryPool::memory_pool) {
 
 		} else {
@@ -152,9 +237,7 @@ class PoolVector {
 		//this should never happen but..
 
 #ifdef DEBUG_ENABLED
-			MemoryPool::alloc_mutex->lock();
-			MemoryPool::total_memory -= old_alloc->size;
-			MemoryPool::alloc_mutex->unlock();
+			MemoryPool::memory_removed(old_alloc->size);
 #endif
 
 			{
@@ -178,11 +261,7 @@ class PoolVector {
 				old_alloc->mem = NULL;
 				old_alloc->size = 0;
 
-				MemoryPool::alloc_mutex->lock();
-				old_alloc->free_list = MemoryPool::free_list;
-				MemoryPool::free_list = old_alloc;
-				MemoryPool::allocs_used--;
-				MemoryPool::alloc_mutex->unlock();
+				MemoryPool::give_back_alloc(old_alloc);
 			}
 		}
 	}
@@ -231,9 +310,7 @@ class PoolVector {
 		}
 
 #ifdef DEBUG_ENABLED
-		MemoryPool::alloc_mutex->lock();
-		MemoryPool::total_memory -= alloc->size;
-		MemoryPool::alloc_mutex->unlock();
+		MemoryPool::memory_removed(alloc->size);
 #endif
 
 		if (MemoryPool::memory_pool) {
@@ -246,11 +323,7 @@ class PoolVector {
 			alloc->mem = NULL;
 			alloc->size = 0;
 
-			MemoryPool::alloc_mutex->lock();
-			alloc->free_list = MemoryPool::free_list;
-			MemoryPool::free_list = alloc;
-			MemoryPool::allocs_used--;
-			MemoryPool::alloc_mutex->unlock();
+			MemoryPool::give_back_alloc(alloc);
 		}
 
 		alloc = NULL;
@@ -516,24 +589,16 @@ Error PoolVector<T>::resize(int p_size) {
 			return OK; //nothing to do here
 
 		//must allocate something
-		MemoryPool::alloc_mutex->lock();
-		if (MemoryPool::allocs_used == MemoryPool::alloc_count) {
-			MemoryPool::alloc_mutex->unlock();
+		alloc = MemoryPool::take_alloc();
+		if (!alloc) {
 			ERR_EXPLAINC("All memory pool allocations are in use.");
 			ERR_FAIL_V(ERR_OUT_OF_MEMORY);
 		}
 
-		//take one from the free list
-		alloc = MemoryPool::free_list;
-		MemoryPool::free_list = alloc->free_list;
-		//increment the used counter
-		MemoryPool::allocs_used++;
-
 		//cleanup the alloc
 		alloc->size = 0;
 		alloc->refcount.init();
 		alloc->pool_id = POOL_ALLOCATOR_INVALID_ID;
-		MemoryPool::alloc_mutex->unlock();
 
 	} else {
 
@@ -553,13 +618,11 @@ Error PoolVector<T>::resize(int p_size) {
 	_copy_on_write(); // make it unique
 
 #ifdef DEBUG_ENABLED
-	MemoryPool::alloc_mutex->lock();
-	MemoryPool::total_memory -= alloc->size;
-	MemoryPool::total_memory += new_size;
-	if (MemoryPool::total_memory > MemoryPool::max_memory) {
-		MemoryPool::max_memory = MemoryPool::total_memory;
+	if (new_size > alloc->size) {
+		MemoryPool::memory_added(new_size - alloc->size);
+	} else {
+		MemoryPool::memory_removed(alloc->size - new_size);
 	}
-	MemoryPool::alloc_mutex->unlock();
 #endif
 
 	int cur_elements = alloc->size / sizeof(T);
@@ -609,11 +672,7 @@ Error PoolVector<T>::resize(int p_size) {
 				alloc->mem = NULL;
 				alloc->size = 0;
 
-				MemoryPool::alloc_mutex->lock();
-				alloc->free_list = MemoryPool::free_list;
-				MemoryPool::free_list = alloc;
-				MemoryPool::allocs_used--;
-				MemoryPool::alloc_mutex->unlock();
+				MemoryPool::give_back_alloc(alloc);
 
 			} else {
 				alloc->mem = memrealloc(alloc->mem, new_size);
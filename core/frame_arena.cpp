@@ -0,0 +1,109 @@
+/*************************************************************************/
+/*  frame_arena.cpp                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "frame_arena.h"
+
+void *FrameArena::_alloc_chunk(size_t p_bytes) {
+
+	if (chunks) {
+		used += chunks->used;
+	}
+
+	size_t size = MAX(chunk_size, p_bytes);
+	Chunk *chunk = (Chunk *)memalloc(HEADER_SIZE + size);
+	ERR_FAIL_COND_V(!chunk, NULL);
+
+	chunk->next = chunks;
+	chunk->size = size;
+	chunk->used = p_bytes;
+	chunks = chunk;
+	chunk_count++;
+
+	return (uint8_t *)chunk + HEADER_SIZE;
+}
+
+void FrameArena::reset() {
+
+	alloc_count = 0;
+	used = 0;
+
+	if (!chunks)
+		return;
+
+	if (chunks->next) {
+
+		// Several chunks were needed, make one that fits all of them.
+		size_t size = 0;
+		while (chunks) {
+			Chunk *next = chunks->next;
+			size += chunks->size;
+			memfree(chunks);
+			chunks = next;
+		}
+
+		chunk_size = MAX(chunk_size, size);
+		chunk_count = 0;
+		_alloc_chunk(0);
+	}
+
+	chunks->used = 0;
+}
+
+size_t FrameArena::get_used_memory() const {
+
+	return used + (chunks ? chunks->used : 0);
+}
+
+size_t FrameArena::get_reserved_memory() const {
+
+	size_t reserved = 0;
+	for (Chunk *chunk = chunks; chunk; chunk = chunk->next) {
+		reserved += chunk->size;
+	}
+
+	return reserved;
+}
+
+FrameArena::FrameArena(size_t p_chunk_size) {
+
+	chunks = NULL;
+	chunk_size = p_chunk_size;
+	used = 0;
+	alloc_count = 0;
+	chunk_count = 0;
+}
+
+FrameArena::~FrameArena() {
+
+	while (chunks) {
+		Chunk *next = chunks->next;
+		memfree(chunks);
+		chunks = next;
+	}
+}
@@ -0,0 +1,303 @@
+/*************************************************************************/
+/*  frame_arena.h                                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include "error_macros.h"
+#include "os/memory.h"
+
+/**
+	Bump allocator for scratch data that lives until the end of a frame or a physics step.
+	Allocating is a pointer increment and nothing is freed until reset(), which makes all of
+	it available again at once. When a frame needed more than one chunk, reset() replaces them
+	with a single chunk as big as all of them, so from then on frames don't touch the heap.
+
+	Not thread safe. Memory can be read from any thread, but only one must allocate.
+*/
+
+class FrameArena {
+
+	struct Chunk {
+
+		Chunk *next;
+		size_t size;
+		size_t used;
+	};
+
+	enum {
+		ALIGN = 16,
+		HEADER_SIZE = (sizeof(Chunk) + ALIGN - 1) & ~(ALIGN - 1)
+	};
+
+	Chunk *chunks; // the one being filled goes first
+	size_t chunk_size;
+	size_t used; // by full chunks
+	uint32_t alloc_count;
+	uint32_t chunk_count;
+
+	void *_alloc_chunk(size_t p_bytes);
+
+public:
+	_FORCE_INLINE_ void *alloc(size_t p_bytes) {
+
+		p_bytes = (p_bytes + ALIGN - 1) & ~size_t(ALIGN - 1);
+		alloc_count++;
+
+		Chunk *chunk = chunks;
+		if (likely(chunk && chunk->used + p_bytes <= chunk->size)) {
+
+			uint8_t *mem = (uint8_t *)chunk + HEADER_SIZE + chunk->used;
+			chunk->used += p_bytes;
+			return mem;
+		}
+
+		return _alloc_chunk(p_bytes);
+	}
+
+	// Not constructed, meant for plain types.
+	template <class T>
+	_FORCE_INLINE_ T *alloc_array(int p_count) {
+
+		return (T *)alloc(sizeof(T) * p_count);
+	}
+
+	// Everything allocated before becomes invalid.
+	void reset();
+
+	uint32_t get_alloc_count() const { return alloc_count; } // since the last reset
+	uint32_t get_chunk_count() const { return chunk_count; } // taken from the heap, in use now
+	size_t get_used_memory() const;
+	size_t get_reserved_memory() const;
+
+	FrameArena(size_t p_chunk_size = 64 * 1024);
+	~FrameArena();
+};
+
+/**
+	Growable array in a FrameArena, with the part of the Vector API used for scratch arrays.
+	Growing leaves the old elements in the arena until it resets. clear() keeps the memory
+	for the next elements; reset() forgets it, and must be called before the arena resets.
+*/
+
+template <class T>
+class ArenaVector {
+
+	FrameArena *arena;
+	T *data;
+	int count;
+	int capacity;
+
+	void _grow(int p_capacity) {
+
+		T *new_data = arena->alloc_array<T>(p_capacity);
+		for (int i = 0; i < count; i++) {
+			memnew_placement(&new_data[i], T(data[i]));
+			data[i].~T();
+		}
+
+		data = new_data;
+		capacity = p_capacity;
+	}
+
+	ArenaVector(const ArenaVector &);
+	ArenaVector &operator=(const ArenaVector &);
+
+public:
+	_FORCE_INLINE_ int size() const { return count; }
+	_FORCE_INLINE_ bool empty() const { return count == 0; }
+
+	_FORCE_INLINE_ T *ptrw() { return data; }
+	_FORCE_INLINE_ const T *ptr() const { return data; }
+
+	_FORCE_INLINE_ T &operator[](int p_index) {
+
+		CRASH_BAD_INDEX(p_index, count);
+		return data[p_index];
+	}
+
+	_FORCE_INLINE_ const T &operator[](int p_index) const {
+
+		CRASH_BAD_INDEX(p_index, count);
+		return data[p_index];
+	}
+
+	_FORCE_INLINE_ T get(int p_index) const { return operator[](p_index); }
+	_FORCE_INLINE_ void set(int p_index, const T &p_elem) { operator[](p_index) = p_elem; }
+
+	void push_back(const T &p_elem) {
+
+		if (count == capacity) {
+			_grow(MAX(capacity * 2, 8));
+		}
+
+		memnew_placement(&data[count], T(p_elem));
+		count++;
+	}
+
+	void resize(int p_size) {
+
+		ERR_FAIL_COND(p_size < 0);
+
+		if (p_size > capacity) {
+			_grow(MAX(capacity * 2, p_size));
+		}
+
+		for (int i = count; i < p_size; i++) {
+			memnew_placement(&data[i], T);
+		}
+		for (int i = p_size; i < count; i++) {
+			data[i].~T();
+		}
+
+		count = p_size;
+	}
+
+	void clear() { resize(0); }
+
+	void reset() {
+
+		clear();
+		data = NULL;
+		capacity = 0;
+	}
+
+	explicit ArenaVector(FrameArena *p_arena) {
+
+		arena = p_arena;
+		data = NULL;
+		count = 0;
+		capacity = 0;
+	}
+
+	~ArenaVector() { clear(); }
+};
+
+/**
+	Linked list in a FrameArena, with the part of the List API used for scratch lists.
+	Elements can't be erased one by one, their memory stays in the arena until it resets.
+*/
+
+template <class T>
+class ArenaList {
+public:
+	class Element {
+
+		friend class ArenaList<T>;
+
+		T value;
+		Element *next_ptr;
+		Element *prev_ptr;
+
+		Element(const T &p_value) :
+				value(p_value) {}
+
+	public:
+		_FORCE_INLINE_ Element *next() { return next_ptr; }
+		_FORCE_INLINE_ const Element *next() const { return next_ptr; }
+		_FORCE_INLINE_ Element *prev() { return prev_ptr; }
+		_FORCE_INLINE_ const Element *prev() const { return prev_ptr; }
+
+		_FORCE_INLINE_ T &get() { return value; }
+		_FORCE_INLINE_ const T &get() const { return value; }
+	};
+
+private:
+	FrameArena *arena;
+	Element *first;
+	Element *last;
+	int count;
+
+	ArenaList(const ArenaList &);
+	ArenaList &operator=(const ArenaList &);
+
+public:
+	_FORCE_INLINE_ Element *front() { return first; }
+	_FORCE_INLINE_ const Element *front() const { return first; }
+	_FORCE_INLINE_ Element *back() { return last; }
+	_FORCE_INLINE_ const Element *back() const { return last; }
+
+	_FORCE_INLINE_ int size() const { return count; }
+	_FORCE_INLINE_ bool empty() const { return count == 0; }
+
+	Element *push_back(const T &p_value) {
+
+		Element *e = memnew_placement(arena->alloc(sizeof(Element)), Element(p_value));
+		e->next_ptr = NULL;
+		e->prev_ptr = last;
+		if (last)
+			last->next_ptr = e;
+		else
+			first = e;
+		last = e;
+		count++;
+		return e;
+	}
+
+	Element *push_front(const T &p_value) {
+
+		Element *e = memnew_placement(arena->alloc(sizeof(Element)), Element(p_value));
+		e->next_ptr = first;
+		e->prev_ptr = NULL;
+		if (first)
+			first->prev_ptr = e;
+		else
+			last = e;
+		first = e;
+		count++;
+		return e;
+	}
+
+	// Must be called before the arena resets if the elements need destruction.
+	void clear() {
+
+		Element *e = first;
+		while (e) {
+			Element *next = e->next_ptr;
+			e->~Element();
+			e = next;
+		}
+
+		first = NULL;
+		last = NULL;
+		count = 0;
+	}
+
+	explicit ArenaList(FrameArena *p_arena) {
+
+		arena = p_arena;
+		first = NULL;
+		last = NULL;
+		count = 0;
+	}
+
+	~ArenaList() { clear(); }
+};
+
+#endif // FRAME_ARENA_H
@@ -1414,3 +1414,320 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 
 	return OK;
 }
+
+/* COMPACT ENCODING */
+
+enum CompactTag {
+
+	COMPACT_NIL,
+	COMPACT_FALSE,
+	COMPACT_TRUE,
+	COMPACT_INT8,
+	COMPACT_INT16,
+	COMPACT_INT32,
+	COMPACT_INT64,
+	COMPACT_REAL32,
+	COMPACT_REAL64,
+	COMPACT_STRING,
+	COMPACT_VECTOR2,
+	COMPACT_VECTOR3,
+	COMPACT_QUAT,
+	COMPACT_COLOR,
+	COMPACT_VARIANT, // anything else, in the regular encoding
+	COMPACT_SMALL_INT = 0x80 // integers 0 to 127 fit in the tag itself
+};
+
+static int _encode_varint(uint32_t p_value, uint8_t *r_buffer) {
+
+	int len = 0;
+	do {
+		uint8_t byte = p_value & 0x7F;
+		p_value >>= 7;
+		if (p_value)
+			byte |= 0x80;
+		if (r_buffer)
+			r_buffer[len] = byte;
+		len++;
+	} while (p_value);
+
+	return len;
+}
+
+static Error _decode_varint(const uint8_t *p_buffer, int p_len, uint32_t *r_value, int *r_len) {
+
+	uint32_t value = 0;
+	for (int i = 0; i < 5; i++) {
+
+		ERR_FAIL_COND_V(i >= p_len, ERR_INVALID_DATA);
+		value |= uint32_t(p_buffer[i] & 0x7F) << (i * 7);
+		if (!(p_buffer[i] & 0x80)) {
+			*r_value = value;
+			*r_len = i + 1;
+			return OK;
+		}
+	}
+
+	ERR_FAIL_V(ERR_INVALID_DATA);
+}
+
+Error encode_variant_compact(const Variant &p_variant, uint8_t *r_buffer, int &r_len) {
+
+	uint8_t *buf = r_buffer;
+
+	switch (p_variant.get_type()) {
+
+		case Variant::NIL: {
+
+			if (buf)
+				buf[0] = COMPACT_NIL;
+			r_len = 1;
+		} break;
+		case Variant::BOOL: {
+
+			if (buf)
+				buf[0] = p_variant.operator bool() ? COMPACT_TRUE : COMPACT_FALSE;
+			r_len = 1;
+		} break;
+		case Variant::INT: {
+
+			int64_t val = p_variant;
+			if (val >= 0 && val < 0x80) {
+				if (buf)
+					buf[0] = COMPACT_SMALL_INT | uint8_t(val);
+				r_len = 1;
+			} else if (val >= -0x80 && val < 0x80) {
+				if (buf) {
+					buf[0] = COMPACT_INT8;
+					buf[1] = uint8_t(int8_t(val));
+				}
+				r_len = 2;
+			} else if (val >= -0x8000 && val < 0x8000) {
+				if (buf) {
+					buf[0] = COMPACT_INT16;
+					encode_uint16(uint16_t(int16_t(val)), &buf[1]);
+				}
+				r_len = 3;
+			} else if (val >= -0x80000000LL && val <= 0x7FFFFFFFLL) {
+				if (buf) {
+					buf[0] = COMPACT_INT32;
+					encode_uint32(uint32_t(int32_t(val)), &buf[1]);
+				}
+				r_len = 5;
+			} else {
+				if (buf) {
+					buf[0] = COMPACT_INT64;
+					encode_uint64(val, &buf[1]);
+				}
+				r_len = 9;
+			}
+		} break;
+		case Variant::REAL: {
+
+			double d = p_variant;
+			float f = d;
+			if (double(f) == d) {
+				if (buf) {
+					buf[0] = COMPACT_REAL32;
+					encode_float(f, &buf[1]);
+				}
+				r_len = 5;
+			} else {
+				if (buf) {
+					buf[0] = COMPACT_REAL64;
+					encode_double(d, &buf[1]);
+				}
+				r_len = 9;
+			}
+		} break;
+		case Variant::STRING: {
+
+			CharString utf8 = p_variant.operator String().utf8();
+			int len = utf8.length();
+			int len_size = _encode_varint(len, buf ? &buf[1] : NULL);
+			if (buf) {
+				buf[0] = COMPACT_STRING;
+				copymem(&buf[1 + len_size], utf8.get_data(), len);
+			}
+			r_len = 1 + len_size + len;
+		} break;
+		case Variant::VECTOR2: {
+
+			if (buf) {
+				Vector2 v = p_variant;
+				buf[0] = COMPACT_VECTOR2;
+				encode_float(v.x, &buf[1]);
+				encode_float(v.y, &buf[5]);
+			}
+			r_len = 1 + 4 * 2;
+		} break;
+		case Variant::VECTOR3: {
+
+			if (buf) {
+				Vector3 v = p_variant;
+				buf[0] = COMPACT_VECTOR3;
+				encode_float(v.x, &buf[1]);
+				encode_float(v.y, &buf[5]);
+				encode_float(v.z, &buf[9]);
+			}
+			r_len = 1 + 4 * 3;
+		} break;
+		case Variant::QUAT: {
+
+			if (buf) {
+				Quat q = p_variant;
+				buf[0] = COMPACT_QUAT;
+				encode_float(q.x, &buf[1]);
+				encode_float(q.y, &buf[5]);
+				encode_float(q.z, &buf[9]);
+				encode_float(q.w, &buf[13]);
+			}
+			r_len = 1 + 4 * 4;
+		} break;
+		case Variant::COLOR: {
+
+			if (buf) {
+				Color c = p_variant;
+				buf[0] = COMPACT_COLOR;
+				encode_float(c.r, &buf[1]);
+				encode_float(c.g, &buf[5]);
+				encode_float(c.b, &buf[9]);
+				encode_float(c.a, &buf[13]);
+			}
+			r_len = 1 + 4 * 4;
+		} break;
+		default: {
+
+			int len;
+			Error err = encode_variant(p_variant, buf ? &buf[1] : NULL, len);
+			if (err != OK)
+				return err;
+			if (buf)
+				buf[0] = COMPACT_VARIANT;
+			r_len = 1 + len;
+		}
+	}
+
+	return OK;
+}
+
+Error decode_variant_compact(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len, bool p_allow_objects) {
+
+	ERR_FAIL_COND_V(p_len < 1, ERR_INVALID_DATA);
+
+	const uint8_t *buf = &p_buffer[1];
+	int len = p_len - 1;
+	int size = 1;
+
+	uint8_t tag = p_buffer[0];
+
+	if (tag & COMPACT_SMALL_INT) {
+
+		r_variant = int(tag & 0x7F);
+
+	} else {
+
+		switch (tag) {
+
+			case COMPACT_NIL: {
+
+				r_variant = Variant();
+			} break;
+			case COMPACT_FALSE: {
+
+				r_variant = false;
+			} break;
+			case COMPACT_TRUE: {
+
+				r_variant = true;
+			} break;
+			case COMPACT_INT8: {
+
+				ERR_FAIL_COND_V(len < 1, ERR_INVALID_DATA);
+				r_variant = int(int8_t(buf[0]));
+				size += 1;
+			} break;
+			case COMPACT_INT16: {
+
+				ERR_FAIL_COND_V(len < 2, ERR_INVALID_DATA);
+				r_variant = int(int16_t(decode_uint16(buf)));
+				size += 2;
+			} break;
+			case COMPACT_INT32: {
+
+				ERR_FAIL_COND_V(len < 4, ERR_INVALID_DATA);
+				r_variant = int(int32_t(decode_uint32(buf)));
+				size += 4;
+			} break;
+			case COMPACT_INT64: {
+
+				ERR_FAIL_COND_V(len < 8, ERR_INVALID_DATA);
+				r_variant = int64_t(decode_uint64(buf));
+				size += 8;
+			} break;
+			case COMPACT_REAL32: {
+
+				ERR_FAIL_COND_V(len < 4, ERR_INVALID_DATA);
+				r_variant = decode_float(buf);
+				size += 4;
+			} break;
+			case COMPACT_REAL64: {
+
+				ERR_FAIL_COND_V(len < 8, ERR_INVALID_DATA);
+				r_variant = decode_double(buf);
+				size += 8;
+			} break;
+			case COMPACT_STRING: {
+
+				uint32_t str_len;
+				int len_size;
+				Error err = _decode_varint(buf, len, &str_len, &len_size);
+				if (err != OK)
+					return err;
+				ERR_FAIL_COND_V(int(str_len) < 0 || int(str_len) > len - len_size, ERR_INVALID_DATA);
+
+				String str;
+				str.parse_utf8((const char *)&buf[len_size], str_len);
+				r_variant = str;
+				size += len_size + str_len;
+			} break;
+			case COMPACT_VECTOR2: {
+
+				ERR_FAIL_COND_V(len < 4 * 2, ERR_INVALID_DATA);
+				r_variant = Vector2(decode_float(&buf[0]), decode_float(&buf[4]));
+				size += 4 * 2;
+			} break;
+			case COMPACT_VECTOR3: {
+
+				ERR_FAIL_COND_V(len < 4 * 3, ERR_INVALID_DATA);
+				r_variant = Vector3(decode_float(&buf[0]), decode_float(&buf[4]), decode_float(&buf[8]));
+				size += 4 * 3;
+			} break;
+			case COMPACT_QUAT: {
+
+				ERR_FAIL_COND_V(len < 4 * 4, ERR_INVALID_DATA);
+				r_variant = Quat(decode_float(&buf[0]), decode_float(&buf[4]), decode_float(&buf[8]), decode_float(&buf[12]));
+				size += 4 * 4;
+			} break;
+			case COMPACT_COLOR: {
+
+				ERR_FAIL_COND_V(len < 4 * 4, ERR_INVALID_DATA);
+				r_variant = Color(decode_float(&buf[0]), decode_float(&buf[4]), decode_float(&buf[8]), decode_float(&buf[12]));
+				size += 4 * 4;
+			} break;
+			case COMPACT_VARIANT: {
+
+				int vlen;
+				Error err = decode_variant(r_variant, buf, len, &vlen, p_allow_objects);
+				if (err != OK)
+					return err;
+				size += vlen;
+			} break;
+			default: { ERR_FAIL_V(ERR_INVALID_DATA); }
+		}
+	}
+
+	if (r_len)
+		*r_len = size;
+
+	return OK;
+}
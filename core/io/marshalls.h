@@ -201,4 +201,8 @@ public:
 Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len = NULL, bool p_allow_objects = true);
 Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bool p_object_as_id = false);
 
+// Tighter encoding for small messages (e.g. RPCs): one byte tags, small integers and common math types without padding.
+Error decode_variant_compact(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len = NULL, bool p_allow_objects = true);
+Error encode_variant_compact(const Variant &p_variant, uint8_t *r_buffer, int &r_len);
+
 #endif
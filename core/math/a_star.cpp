@@ -29,8 +29,10 @@
 /*************************************************************************/
 #include "a_star.h"
 #include "geometry.h"
+#include "message_queue.h"
 #include "scene/scene_string_names.h"
 #include "script_language.h"
+#include "sort.h"
 
 int AStar::get_available_point_id() const {
 
@@ -38,7 +40,7 @@ int AStar::get_available_point_id() const {
 		return 1;
 	}
 
-	return points.back()->key() + 1;
+	return max_point_id + 1;
 }
 
 void AStar::add_point(int p_id, const Vector3 &p_pos, real_t p_weight_scale) {
@@ -46,89 +48,156 @@ void AStar::add_point(int p_id, const Vector3 &p_pos, real_t p_weight_scale) {
 	ERR_FAIL_COND(p_id < 0);
 	ERR_FAIL_COND(p_weight_scale < 1);
 
-	if (!points.has(p_id)) {
-		Point *pt = memnew(Point);
-		pt->id = p_id;
-		pt->pos = p_pos;
-		pt->weight_scale = p_weight_scale;
-		pt->prev_point = NULL;
-		pt->last_pass = 0;
-		points[p_id] = pt;
+	int idx = _get_point_index(p_id);
+
+	if (idx < 0) {
+		Point pt;
+		pt.id = p_id;
+		pt.pos = p_pos;
+		pt.weight_scale = p_weight_scale;
+		point_indices.set(p_id, points.size());
+		points.push_back(pt);
+		max_point_id = MAX(max_point_id, p_id);
 	} else {
-		points[p_id]->pos = p_pos;
-		points[p_id]->weight_scale = p_weight_scale;
+		Point &pt = points[idx];
+		pt.pos = p_pos;
+		pt.weight_scale = p_weight_scale;
+		segment_bvh.dirty = true;
 	}
+
+	point_bvh.dirty = true;
 }
 
 Vector3 AStar::get_point_position(int p_id) const {
 
-	ERR_FAIL_COND_V(!points.has(p_id), Vector3());
+	int idx = _get_point_index(p_id);
+	ERR_FAIL_COND_V(idx < 0, Vector3());
 
-	return points[p_id]->pos;
+	return points[idx].pos;
 }
 
 void AStar::set_point_position(int p_id, const Vector3 &p_pos) {
 
-	ERR_FAIL_COND(!points.has(p_id));
+	int idx = _get_point_index(p_id);
+	ERR_FAIL_COND(idx < 0);
 
-	points[p_id]->pos = p_pos;
+	points[idx].pos = p_pos;
+	point_bvh.dirty = true;
+	segment_bvh.dirty = true;
 }
 
 real_t AStar::get_point_weight_scale(int p_id) const {
 
-	ERR_FAIL_COND_V(!points.has(p_id), 0);
+	int idx = _get_point_index(p_id);
+	ERR_FAIL_COND_V(idx < 0, 0);
 
-	return points[p_id]->weight_scale;
+	return points[idx].weight_scale;
 }
 
 void AStar::set_point_weight_scale(int p_id, real_t p_weight_scale) {
 
-	ERR_FAIL_COND(!points.has(p_id));
+	int idx = _get_point_index(p_id);
+	ERR_FAIL_COND(idx < 0);
 	ERR_FAIL_COND(p_weight_scale < 1);
 
-	points[p_id]->weight_scale = p_weight_scale;
+	points[idx].weight_scale = p_weight_scale;
+}
+
+static void _replace_index(Vector<int> &r_indices, int p_from, int p_to) {
+
+	int pos = r_indices.find(p_from);
+	if (pos >= 0) {
+		r_indices[pos] = p_to;
+	}
 }
 
 void AStar::remove_point(int p_id) {
 
-	ERR_FAIL_COND(!points.has(p_id));
+	int idx = _get_point_index(p_id);
+	ERR_FAIL_COND(idx < 0);
 
-	Point *p = points[p_id];
+	Point *pts = points.ptrw();
+	Point &p = pts[idx];
 
-	for (int i = 0; i < p->neighbours.size(); i++) {
+	for (int i = 0; i < p.neighbours.size(); i++) {
 
-		Segment s(p_id, p->neighbours[i]->id);
-		segments.erase(s);
-		p->neighbours[i]->neighbours.erase(p);
+		Point &n = pts[p.neighbours[i]];
+		segments.erase(Segment(p_id, n.id));
+		n.neighbours.erase(idx);
+		n.unlinked_neighbours.erase(idx);
 	}
 
-	memdelete(p);
-	points.erase(p_id);
+	for (int i = 0; i < p.unlinked_neighbours.size(); i++) {
+
+		Point &n = pts[p.unlinked_neighbours[i]];
+		segments.erase(Segment(p_id, n.id));
+		n.neighbours.erase(idx);
+		n.unlinked_neighbours.erase(idx);
+	}
+
+	// Keep storage contiguous, move the last point into the hole.
+	int last = points.size() - 1;
+	if (idx != last) {
+
+		Point &moved = pts[last];
+
+		for (int i = 0; i < moved.neighbours.size(); i++) {
+			Point &n = pts[moved.neighbours[i]];
+			_replace_index(n.neighbours, last, idx);
+			_replace_index(n.unlinked_neighbours, last, idx);
+		}
+
+		for (int i = 0; i < moved.unlinked_neighbours.size(); i++) {
+			Point &n = pts[moved.unlinked_neighbours[i]];
+			_replace_index(n.neighbours, last, idx);
+			_replace_index(n.unlinked_neighbours, last, idx);
+		}
+
+		pts[idx] = moved;
+		point_indices.set(moved.id, idx);
+	}
+
+	points.resize(last);
+	point_indices.erase(p_id);
+
+	if (p_id == max_point_id) {
+		max_point_id = 0;
+		for (int i = 0; i < points.size(); i++) {
+			max_point_id = MAX(max_point_id, points[i].id);
+		}
+	}
+
+	point_bvh.dirty = true;
+	segment_bvh.dirty = true;
 }
 
 void AStar::connect_points(int p_id, int p_with_id, bool bidirectional) {
 
-	ERR_FAIL_COND(!points.has(p_id));
-	ERR_FAIL_COND(!points.has(p_with_id));
+	int a = _get_point_index(p_id);
+	int b = _get_point_index(p_with_id);
+	ERR_FAIL_COND(a < 0);
+	ERR_FAIL_COND(b < 0);
 	ERR_FAIL_COND(p_id == p_with_id);
 
-	Point *a = points[p_id];
-	Point *b = points[p_with_id];
-	a->neighbours.push_back(b);
+	Point *pts = points.ptrw();
 
-	if (bidirectional)
-		b->neighbours.push_back(a);
+	if (pts[a].neighbours.find(b) < 0) {
+		pts[a].neighbours.push_back(b);
+	}
+	pts[a].unlinked_neighbours.erase(b);
 
-	Segment s(p_id, p_with_id);
-	if (s.from == p_id) {
-		s.from_point = a;
-		s.to_point = b;
-	} else {
-		s.from_point = b;
-		s.to_point = a;
+	if (pts[b].neighbours.find(a) < 0) {
+
+		if (bidirectional) {
+			pts[b].neighbours.push_back(a);
+			pts[b].unlinked_neighbours.erase(a);
+		} else if (pts[b].unlinked_neighbours.find(a) < 0) {
+			pts[b].unlinked_neighbours.push_back(a);
+		}
 	}
 
-	segments.insert(s);
+	segments.insert(Segment(p_id, p_with_id));
+	segment_bvh.dirty = true;
 }
 void AStar::disconnect_points(int p_id, int p_with_id) {
 
@@ -137,23 +206,36 @@ void AStar::disconnect_points(int p_id, int p_with_id) {
 
 	segments.erase(s);
 
-	Point *a = points[p_id];
-	Point *b = points[p_with_id];
-	a->neighbours.erase(b);
-	b->neighbours.erase(a);
+	int a = _get_point_index(p_id);
+	int b = _get_point_index(p_with_id);
+
+	Point *pts = points.ptrw();
+	pts[a].neighbours.erase(b);
+	pts[a].unlinked_neighbours.erase(b);
+	pts[b].neighbours.erase(a);
+	pts[b].unlinked_neighbours.erase(a);
+
+	segment_bvh.dirty = true;
 }
 
 bool AStar::has_point(int p_id) const {
 
-	return points.has(p_id);
+	return point_indices.has(p_id);
 }
 
 Array AStar::get_points() {
 
+	Vector<int> ids;
+	ids.resize(points.size());
+	for (int i = 0; i < points.size(); i++) {
+		ids[i] = points[i].id;
+	}
+	ids.sort();
+
 	Array point_list;
 
-	for (const Map<int, Point *>::Element *E = points.front(); E; E = E->next()) {
-		point_list.push_back(E->key());
+	for (int i = 0; i < ids.size(); i++) {
+		point_list.push_back(ids[i]);
 	}
 
 	return point_list;
@@ -161,14 +243,15 @@ Array AStar::get_points() {
 
 PoolVector<int> AStar::get_point_connections(int p_id) {
 
-	ERR_FAIL_COND_V(!points.has(p_id), PoolVector<int>());
+	int idx = _get_point_index(p_id);
+	ERR_FAIL_COND_V(idx < 0, PoolVector<int>());
 
 	PoolVector<int> point_list;
 
-	Point *p = points[p_id];
+	const Point &p = points[idx];
 
-	for (int i = 0; i < p->neighbours.size(); i++) {
-		point_list.push_back(p->neighbours[i]->id);
+	for (int i = 0; i < p.neighbours.size(); i++) {
+		point_list.push_back(points[p.neighbours[i]].id);
 	}
 
 	return point_list;
@@ -182,29 +265,197 @@ bool AStar::are_points_connected(int p_id, int p_with_id) const {
 
 void AStar::clear() {
 
-	for (const Map<int, Point *>::Element *E = points.front(); E; E = E->next()) {
+	points.clear();
+	point_indices.clear();
+	segments.clear();
+	max_point_id = 0;
 
-		memdelete(E->get());
+	point_bvh.dirty = true;
+	segment_bvh.dirty = true;
+}
+
+/* SPATIAL INDEX */
+
+struct _AStarBVHCenterSort {
+
+	const Vector3 *centers;
+	int axis;
+
+	bool operator()(int p_a, int p_b) const {
+
+		return centers[p_a][axis] < centers[p_b][axis];
 	}
-	segments.clear();
-	points.clear();
+};
+
+int AStar::BVH::_build(const AABB *p_bounds, const Vector3 *p_centers, int *p_items, int p_from, int p_count) {
+
+	enum {
+		MAX_LEAF_ITEMS = 4
+	};
+
+	Node node;
+	node.aabb = p_bounds[p_items[p_from]];
+	for (int i = 1; i < p_count; i++) {
+		node.aabb.merge_with(p_bounds[p_items[p_from + i]]);
+	}
+	node.children[0] = -1;
+	node.children[1] = -1;
+	node.from = p_from;
+	node.count = p_count;
+
+	int index = nodes.size();
+	nodes.push_back(node);
+
+	if (p_count <= MAX_LEAF_ITEMS)
+		return index;
+
+	// Split at the median along the longest axis of the centers.
+	AABB center_bounds(p_centers[p_items[p_from]], Vector3());
+	for (int i = 1; i < p_count; i++) {
+		center_bounds.expand_to(p_centers[p_items[p_from + i]]);
+	}
+
+	SortArray<int, _AStarBVHCenterSort> sorter;
+	sorter.compare.centers = p_centers;
+	sorter.compare.axis = center_bounds.get_longest_axis_index();
+
+	int half = p_count / 2;
+	sorter.nth_element(p_from, p_from + p_count, p_from + half, p_items);
+
+	node.count = 0;
+	node.children[0] = _build(p_bounds, p_centers, p_items, p_from, half);
+	node.children[1] = _build(p_bounds, p_centers, p_items, p_from + half, p_count - half);
+	nodes[index] = node;
+
+	return index;
+}
+
+void AStar::BVH::build(const Vector<AABB> &p_bounds) {
+
+	nodes.clear();
+	items.resize(p_bounds.size());
+	dirty = false;
+
+	if (p_bounds.empty())
+		return;
+
+	Vector<Vector3> centers;
+	centers.resize(p_bounds.size());
+	for (int i = 0; i < p_bounds.size(); i++) {
+		centers[i] = p_bounds[i].position + p_bounds[i].size * 0.5;
+		items[i] = i;
+	}
+
+	_build(p_bounds.ptr(), centers.ptr(), items.ptrw(), 0, p_bounds.size());
+}
+
+static _FORCE_INLINE_ real_t _get_aabb_distance_squared(const AABB &p_aabb, const Vector3 &p_point) {
+
+	Vector3 d;
+	for (int i = 0; i < 3; i++) {
+
+		real_t begin = p_aabb.position[i];
+		real_t end = begin + p_aabb.size[i];
+		if (p_point[i] < begin) {
+			d[i] = begin - p_point[i];
+		} else if (p_point[i] > end) {
+			d[i] = p_point[i] - end;
+		}
+	}
+
+	return d.length_squared();
+}
+
+void AStar::_update_point_bvh() const {
+
+	if (!point_bvh.dirty)
+		return;
+
+	Vector<AABB> bounds;
+	bounds.resize(points.size());
+	for (int i = 0; i < points.size(); i++) {
+		bounds[i] = AABB(points[i].pos, Vector3());
+	}
+
+	point_bvh.build(bounds);
+}
+
+void AStar::_update_segment_bvh() const {
+
+	if (!segment_bvh.dirty)
+		return;
+
+	segment_points.resize(segments.size() * 2);
+
+	Vector<AABB> bounds;
+	bounds.resize(segments.size());
+
+	int i = 0;
+	for (const Set<Segment>::Element *E = segments.front(); E; E = E->next()) {
+
+		int from = _get_point_index(E->get().from);
+		int to = _get_point_index(E->get().to);
+		segment_points[i * 2 + 0] = from;
+		segment_points[i * 2 + 1] = to;
+
+		bounds[i] = AABB(points[from].pos, Vector3());
+		bounds[i].expand_to(points[to].pos);
+		i++;
+	}
+
+	segment_bvh.build(bounds);
 }
 
 int AStar::get_closest_point(const Vector3 &p_point) const {
 
-	int closest_id = -1;
+	if (points.empty())
+		return -1;
+
+	_update_point_bvh();
+
+	const Point *pts = points.ptr();
+	const BVH::Node *nodes = point_bvh.nodes.ptr();
+	const int *items = point_bvh.items.ptr();
+
+	int closest = -1;
 	real_t closest_dist = 1e20;
 
-	for (const Map<int, Point *>::Element *E = points.front(); E; E = E->next()) {
+	// A balanced tree, so the depth is logarithmic.
+	int stack[64];
+	int stack_size = 1;
+	stack[0] = 0;
+
+	while (stack_size) {
+
+		const BVH::Node &node = nodes[stack[--stack_size]];
+
+		if (closest >= 0 && _get_aabb_distance_squared(node.aabb, p_point) > closest_dist)
+			continue;
+
+		if (node.count) {
+
+			for (int i = node.from; i < node.from + node.count; i++) {
 
-		real_t d = p_point.distance_squared_to(E->get()->pos);
-		if (closest_id < 0 || d < closest_dist) {
-			closest_dist = d;
-			closest_id = E->key();
+				const Point &p = pts[items[i]];
+				real_t d = p_point.distance_squared_to(p.pos);
+				// On ties, the lowest id wins, as when points were sorted by id.
+				if (closest < 0 || d < closest_dist || (d == closest_dist && p.id < pts[closest].id)) {
+					closest_dist = d;
+					closest = items[i];
+				}
+			}
+			continue;
 		}
+
+		// Visit the nearest child first, it tightens the bound faster.
+		real_t d0 = _get_aabb_distance_squared(nodes[node.children[0]].aabb, p_point);
+		real_t d1 = _get_aabb_distance_squared(nodes[node.children[1]].aabb, p_point);
+		int near = d0 <= d1 ? 0 : 1;
+		stack[stack_size++] = node.children[1 - near];
+		stack[stack_size++] = node.children[near];
 	}
 
-	return closest_id;
+	return pts[closest].id;
 }
 
 Vector3 AStar::get_closest_position_in_segment(const Vector3 &p_point) const {
@@ -213,120 +464,292 @@ Vector3 AStar::get_closest_position_in_segment(const Vector3 &p_point) const {
 	bool found = false;
 	Vector3 closest_point;
 
-	for (const Set<Segment>::Element *E = segments.front(); E; E = E->next()) {
+	if (segments.size() == 0)
+		return closest_point;
+
+	_update_segment_bvh();
+
+	const Point *pts = points.ptr();
+	const BVH::Node *nodes = segment_bvh.nodes.ptr();
+	const int *items = segment_bvh.items.ptr();
+	const int *seg_points = segment_points.ptr();
+
+	int stack[64];
+	int stack_size = 1;
+	stack[0] = 0;
+
+	while (stack_size) {
+
+		const BVH::Node &node = nodes[stack[--stack_size]];
 
-		Vector3 segment[2] = {
-			E->get().from_point->pos,
-			E->get().to_point->pos,
-		};
+		if (found && _get_aabb_distance_squared(node.aabb, p_point) >= closest_dist)
+			continue;
 
-		Vector3 p = Geometry::get_closest_point_to_segment(p_point, segment);
-		real_t d = p_point.distance_squared_to(p);
-		if (!found || d < closest_dist) {
+		if (node.count) {
 
-			closest_point = p;
-			closest_dist = d;
-			found = true;
+			for (int i = node.from; i < node.from + node.count; i++) {
+
+				Vector3 segment[2] = {
+					pts[seg_points[items[i] * 2 + 0]].pos,
+					pts[seg_points[items[i] * 2 + 1]].pos,
+				};
+
+				Vector3 p = Geometry::get_closest_point_to_segment(p_point, segment);
+				real_t d = p_point.distance_squared_to(p);
+				if (!found || d < closest_dist) {
+
+					closest_point = p;
+					closest_dist = d;
+					found = true;
+				}
+			}
+			continue;
 		}
+
+		real_t d0 = _get_aabb_distance_squared(nodes[node.children[0]].aabb, p_point);
+		real_t d1 = _get_aabb_distance_squared(nodes[node.children[1]].aabb, p_point);
+		int near = d0 <= d1 ? 0 : 1;
+		stack[stack_size++] = node.children[1 - near];
+		stack[stack_size++] = node.children[near];
 	}
 
 	return closest_point;
 }
 
-bool AStar::_solve(Point *begin_point, Point *end_point) {
+/* PATHFINDING */
+
+static _FORCE_INLINE_ bool _is_cheaper(real_t p_f_a, real_t p_g_a, real_t p_f_b, real_t p_g_b) {
+
+	// On ties, prefer points that are further along.
+	return p_f_a < p_f_b || (p_f_a == p_f_b && p_g_a > p_g_b);
+}
+
+void AStar::Solver::prepare(int p_point_count) {
+
+	if (states.size() < p_point_count) {
+
+		int from = states.size();
+		states.resize(p_point_count);
+		State *s = states.ptrw();
+		for (int i = from; i < p_point_count; i++) {
+			s[i].open_pass = 0;
+			s[i].closed_pass = 0;
+		}
+	}
 
 	pass++;
+	open_heap_size = 0;
+}
 
-	SelfList<Point>::List open_list;
+void AStar::Solver::heap_push(int p_index) {
 
-	bool found_route = false;
+	if (open_heap_size == open_heap.size()) {
+		open_heap.resize(MAX(open_heap_size * 2, 64));
+	}
+
+	open_heap[open_heap_size] = p_index;
+	states[p_index].heap_index = open_heap_size;
+	open_heap_size++;
 
-	for (int i = 0; i < begin_point->neighbours.size(); i++) {
+	heap_decrease_key(p_index);
+}
 
-		Point *n = begin_point->neighbours[i];
-		n->prev_point = begin_point;
-		n->distance = _compute_cost(begin_point->id, n->id) * n->weight_scale;
-		n->last_pass = pass;
-		open_list.add(&n->list);
+void AStar::Solver::heap_decrease_key(int p_index) {
 
-		if (end_point == n) {
-			found_route = true;
+	int *heap = open_heap.ptrw();
+	State *s = states.ptrw();
+	State &p = s[p_index];
+	int pos = p.heap_index;
+
+	while (pos > 0) {
+
+		int parent = (pos - 1) / 2;
+		State &pp = s[heap[parent]];
+		if (!_is_cheaper(p.f_score, p.g_score, pp.f_score, pp.g_score))
 			break;
-		}
+
+		heap[pos] = heap[parent];
+		pp.heap_index = pos;
+		pos = parent;
 	}
 
-	while (!found_route) {
+	heap[pos] = p_index;
+	p.heap_index = pos;
+}
+
+int AStar::Solver::heap_pop() {
+
+	int *heap = open_heap.ptrw();
+	State *s = states.ptrw();
+	int top = heap[0];
+	s[top].heap_index = -1;
 
-		if (open_list.first() == NULL) {
-			// No path found
+	open_heap_size--;
+	if (open_heap_size == 0)
+		return top;
+
+	// Sift the last element down from the root.
+	int last = heap[open_heap_size];
+	State &p = s[last];
+	int pos = 0;
+
+	while (true) {
+
+		int child = pos * 2 + 1;
+		if (child >= open_heap_size)
 			break;
+
+		if (child + 1 < open_heap_size) {
+			const State &l = s[heap[child]];
+			const State &r = s[heap[child + 1]];
+			if (_is_cheaper(r.f_score, r.g_score, l.f_score, l.g_score))
+				child++;
 		}
-		// Check open list
 
-		SelfList<Point> *least_cost_point = NULL;
-		real_t least_cost = 1e30;
+		State &c = s[heap[child]];
+		if (!_is_cheaper(c.f_score, c.g_score, p.f_score, p.g_score))
+			break;
 
-		// TODO: Cache previous results
-		for (SelfList<Point> *E = open_list.first(); E; E = E->next()) {
+		heap[pos] = heap[child];
+		c.heap_index = pos;
+		pos = child;
+	}
+
+	heap[pos] = last;
+	p.heap_index = pos;
 
-			Point *p = E->self();
+	return top;
+}
 
-			real_t cost = p->distance;
-			cost += _estimate_cost(p->id, end_point->id);
+bool AStar::_solve(Solver *r_solver, const Point *p_points, int p_point_count, int p_begin_point, int p_end_point, AStar *p_costs) {
 
-			if (cost < least_cost) {
+	r_solver->prepare(p_point_count);
 
-				least_cost_point = E;
-				least_cost = cost;
-			}
+	uint64_t pass = r_solver->pass;
+	Solver::State *states = r_solver->states.ptrw();
+	const Point &end = p_points[p_end_point];
+
+	Solver::State &begin = states[p_begin_point];
+	begin.prev_point = -1;
+	begin.g_score = 0;
+	begin.f_score = p_costs ? p_costs->_estimate_cost(p_points[p_begin_point].id, end.id) : p_points[p_begin_point].pos.distance_to(end.pos);
+	begin.open_pass = pass;
+	r_solver->heap_push(p_begin_point);
+
+	bool found_route = false;
+
+	while (r_solver->open_heap_size) {
+
+		int current = r_solver->heap_pop();
+
+		if (current == p_end_point) {
+			found_route = true;
+			break;
 		}
 
-		Point *p = least_cost_point->self();
-		// Open the neighbours for search
-		int es = p->neighbours.size();
+		const Point &p = p_points[current];
+		Solver::State &ps = states[current];
+		ps.closed_pass = pass;
 
-		for (int i = 0; i < es; i++) {
+		// Open the neighbours for search
+		int neighbour_count = p.neighbours.size();
+		const int *neighbours = p.neighbours.ptr();
 
-			Point *e = p->neighbours[i];
+		for (int i = 0; i < neighbour_count; i++) {
 
-			real_t distance = _compute_cost(p->id, e->id) * e->weight_scale + p->distance;
+			int ei = neighbours[i];
+			const Point &e = p_points[ei];
+			Solver::State &es = states[ei];
 
-			if (e->last_pass == pass) {
-				// Already visited, is this cheaper?
+			if (es.closed_pass == pass)
+				continue;
 
-				if (e->distance > distance) {
+			real_t cost = p_costs ? p_costs->_compute_cost(p.id, e.id) : p.pos.distance_to(e.pos);
+			real_t g_score = ps.g_score + cost * e.weight_scale;
 
-					e->prev_point = p;
-					e->distance = distance;
-				}
-			} else {
+			if (es.open_pass != pass) {
 				// Add to open neighbours
 
-				e->prev_point = p;
-				e->distance = distance;
-				e->last_pass = pass; // Mark as used
-				open_list.add(&e->list);
+				es.open_pass = pass;
+				es.prev_point = current;
+				es.g_score = g_score;
+				es.f_score = g_score + (p_costs ? p_costs->_estimate_cost(e.id, end.id) : e.pos.distance_to(end.pos));
+				r_solver->heap_push(ei);
 
-				if (e == end_point) {
-					// End reached; stop algorithm
-					found_route = true;
-					break;
-				}
+			} else if (g_score < es.g_score) {
+				// Already open, and this is cheaper
+
+				es.prev_point = current;
+				es.f_score += g_score - es.g_score;
+				es.g_score = g_score;
+				r_solver->heap_decrease_key(ei);
 			}
 		}
+	}
 
-		if (found_route)
-			break;
+	return found_route;
+}
+
+PoolVector<Vector3> AStar::_get_point_path(const Solver &p_solver, const Point *p_points, int p_begin_point, int p_end_point) {
 
-		open_list.remove(least_cost_point);
+	const Solver::State *states = p_solver.states.ptr();
+
+	// Midpoints
+	int p = p_end_point;
+	int pc = 1; // Begin point
+	while (p != p_begin_point) {
+		pc++;
+		p = states[p].prev_point;
 	}
 
-	// Clear the openf list
-	while (open_list.first()) {
-		open_list.remove(open_list.first());
+	PoolVector<Vector3> path;
+	path.resize(pc);
+
+	{
+		PoolVector<Vector3>::Write w = path.write();
+
+		p = p_end_point;
+		int idx = pc - 1;
+		while (p != p_begin_point) {
+			w[idx--] = p_points[p].pos;
+			p = states[p].prev_point;
+		}
+
+		w[0] = p_points[p].pos; // Assign first
 	}
 
-	return found_route;
+	return path;
+}
+
+PoolVector<int> AStar::_get_id_path(const Solver &p_solver, const Point *p_points, int p_begin_point, int p_end_point) {
+
+	const Solver::State *states = p_solver.states.ptr();
+
+	// Midpoints
+	int p = p_end_point;
+	int pc = 1; // Begin point
+	while (p != p_begin_point) {
+		pc++;
+		p = states[p].prev_point;
+	}
+
+	PoolVector<int> path;
+	path.resize(pc);
+
+	{
+		PoolVector<int>::Write w = path.write();
+
+		p = p_end_point;
+		int idx = pc - 1;
+		while (p != p_begin_point) {
+			w[idx--] = p_points[p].id;
+			p = states[p].prev_point;
+		}
+
+		w[0] = p_points[p].id; // Assign first
+	}
+
+	return path;
 }
 
 float AStar::_estimate_cost(int p_from_id, int p_to_id) {
@@ -334,7 +757,7 @@ float AStar::_estimate_cost(int p_from_id, int p_to_id) {
 	if (get_script_instance() && get_script_instance()->has_method(SceneStringNames::get_singleton()->_estimate_cost))
 		return get_script_instance()->call(SceneStringNames::get_singleton()->_estimate_cost, p_from_id, p_to_id);
 
-	return points[p_from_id]->pos.distance_to(points[p_to_id]->pos);
+	return points[_get_point_index(p_from_id)].pos.distance_to(points[_get_point_index(p_to_id)].pos);
 }
 
 float AStar::_compute_cost(int p_from_id, int p_to_id) {
@@ -342,109 +765,243 @@ float AStar::_compute_cost(int p_from_id, int p_to_id) {
 	if (get_script_instance() && get_script_instance()->has_method(SceneStringNames::get_singleton()->_compute_cost))
 		return get_script_instance()->call(SceneStringNames::get_singleton()->_compute_cost, p_from_id, p_to_id);
 
-	return points[p_from_id]->pos.distance_to(points[p_to_id]->pos);
+	return points[_get_point_index(p_from_id)].pos.distance_to(points[_get_point_index(p_to_id)].pos);
 }
 
 PoolVector<Vector3> AStar::get_point_path(int p_from_id, int p_to_id) {
 
-	ERR_FAIL_COND_V(!points.has(p_from_id), PoolVector<Vector3>());
-	ERR_FAIL_COND_V(!points.has(p_to_id), PoolVector<Vector3>());
+	int begin_point = _get_point_index(p_from_id);
+	int end_point = _get_point_index(p_to_id);
+	ERR_FAIL_COND_V(begin_point < 0, PoolVector<Vector3>());
+	ERR_FAIL_COND_V(end_point < 0, PoolVector<Vector3>());
 
-	pass++;
-
-	Point *a = points[p_from_id];
-	Point *b = points[p_to_id];
-
-	if (a == b) {
+	if (begin_point == end_point) {
 		PoolVector<Vector3> ret;
-		ret.push_back(a->pos);
+		ret.push_back(points[begin_point].pos);
 		return ret;
 	}
 
-	Point *begin_point = a;
-	Point *end_point = b;
+	if (!_solve(&solver, points.ptr(), points.size(), begin_point, end_point, this))
+		return PoolVector<Vector3>();
 
-	bool found_route = _solve(begin_point, end_point);
+	return _get_point_path(solver, points.ptr(), begin_point, end_point);
+}
 
-	if (!found_route)
-		return PoolVector<Vector3>();
+PoolVector<int> AStar::get_id_path(int p_from_id, int p_to_id) {
 
-	// Midpoints
-	Point *p = end_point;
-	int pc = 1; // Begin point
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
+	int begin_point = _get_point_index(p_from_id);
+	int end_point = _get_point_index(p_to_id);
+	ERR_FAIL_COND_V(begin_point < 0, PoolVector<int>());
+	ERR_FAIL_COND_V(end_point < 0, PoolVector<int>());
+
+	if (begin_point == end_point) {
+		PoolVector<int> ret;
+		ret.push_back(p_from_id);
+		return ret;
 	}
 
-	PoolVector<Vector3> path;
-	path.resize(pc);
+	if (!_solve(&solver, points.ptr(), points.size(), begin_point, end_point, this))
+		return PoolVector<int>();
 
-	{
-		PoolVector<Vector3>::Write w = path.write();
+	return _get_id_path(solver, points.ptr(), begin_point, end_point);
+}
 
-		Point *p = end_point;
-		int idx = pc - 1;
-		while (p != begin_point) {
-			w[idx--] = p->pos;
-			p = p->prev_point;
+/* PATH BATCHES */
+
+void AStar::_solve_path_batch(void *p_batch, uint32_t p_chunk) {
+
+	PathBatch *batch = (PathBatch *)p_batch;
+
+	const Point *pts = batch->points.ptr();
+	const int *queries = batch->queries.ptr();
+	Variant *paths = batch->paths.ptrw();
+
+	int from = p_chunk * batch->chunk_size;
+	int to = MIN(from + batch->chunk_size, batch->paths.size());
+
+	// Each chunk has its own scratch state, the points are only read.
+	Solver chunk_solver;
+
+	for (int i = from; i < to; i++) {
+
+		int begin_point = queries[i * 2 + 0];
+		int end_point = queries[i * 2 + 1];
+
+		if (begin_point < 0 || end_point < 0)
+			continue;
+
+		if (begin_point == end_point) {
+
+			if (batch->point_paths) {
+				PoolVector<Vector3> path;
+				path.push_back(pts[begin_point].pos);
+				paths[i] = path;
+			} else {
+				PoolVector<int> path;
+				path.push_back(pts[begin_point].id);
+				paths[i] = path;
+			}
+			continue;
 		}
 
-		w[0] = p->pos; // Assign first
+		if (!_solve(&chunk_solver, pts, batch->points.size(), begin_point, end_point, batch->costs))
+			continue;
+
+		if (batch->point_paths) {
+			paths[i] = _get_point_path(chunk_solver, pts, begin_point, end_point);
+		} else {
+			paths[i] = _get_id_path(chunk_solver, pts, begin_point, end_point);
+		}
 	}
+}
 
-	return path;
+void AStar::_path_batch_done(void *p_batch) {
+
+	PathBatch *batch = (PathBatch *)p_batch;
+	MessageQueue::get_singleton()->push_call(batch->owner, "_path_batch_solved", batch->id);
 }
 
-PoolVector<int> AStar::get_id_path(int p_from_id, int p_to_id) {
+AStar::PathBatch *AStar::_create_path_batch(const PoolVector<int> &p_from_to, bool p_point_paths) {
 
-	ERR_FAIL_COND_V(!points.has(p_from_id), PoolVector<int>());
-	ERR_FAIL_COND_V(!points.has(p_to_id), PoolVector<int>());
+	ERR_FAIL_COND_V(p_from_to.size() % 2 != 0, NULL);
 
-	pass++;
+	PathBatch *batch = memnew(PathBatch);
+	batch->id = ++last_batch_id;
+	batch->owner = get_instance_id();
+	batch->point_paths = p_point_paths;
+	batch->points = points;
+	// scripts that don't override the costs are solved on the job system like any other
+	bool script_costs = has_method(SceneStringNames::get_singleton()->_compute_cost) || has_method(SceneStringNames::get_singleton()->_estimate_cost);
+	batch->costs = script_costs ? this : NULL;
 
-	Point *a = points[p_from_id];
-	Point *b = points[p_to_id];
+	int count = p_from_to.size() / 2;
+	batch->queries.resize(count * 2);
+	batch->paths.resize(count);
 
-	if (a == b) {
-		PoolVector<int> ret;
-		ret.push_back(a->id);
-		return ret;
+	PoolVector<int>::Read r = p_from_to.read();
+	int *queries = batch->queries.ptrw();
+
+	for (int i = 0; i < count * 2; i++) {
+
+		queries[i] = _get_point_index(r[i]);
+		if (queries[i] < 0) {
+			ERR_PRINTS("Can't find a path from or to AStar point " + itos(r[i]) + ", it doesn't exist.");
+		}
 	}
 
-	Point *begin_point = a;
-	Point *end_point = b;
+	return batch;
+}
 
-	bool found_route = _solve(begin_point, end_point);
+void AStar::_run_path_batch(PathBatch *p_batch, bool p_notify) {
 
-	if (!found_route)
-		return PoolVector<int>();
+	JobSystem *job_system = JobSystem::get_singleton();
 
-	// Midpoints
-	Point *p = end_point;
-	int pc = 1; // Begin point
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
+	if (p_notify) {
+		job_system->set_completion_callback(&p_batch->group, _path_batch_done, p_batch);
 	}
 
-	PoolVector<int> path;
-	path.resize(pc);
+	int count = p_batch->paths.size();
 
-	{
-		PoolVector<int>::Write w = path.write();
+	if (p_batch->costs) {
 
-		p = end_point;
-		int idx = pc - 1;
-		while (p != begin_point) {
-			w[idx--] = p->id;
-			p = p->prev_point;
-		}
+		// Costs come from the script, which can only run here.
+		p_batch->chunk_size = MAX(count, 1);
+		_solve_path_batch(p_batch, 0);
+		job_system->close(&p_batch->group);
+		return;
+	}
+
+	// A few chunks per thread balance the load without paying for many solvers.
+	int chunks = MIN(count, (job_system->get_thread_count() + 1) * 4);
+	p_batch->chunk_size = chunks > 0 ? (count + chunks - 1) / chunks : 1;
+	chunks = (count + p_batch->chunk_size - 1) / p_batch->chunk_size;
+
+	job_system->submit(&p_batch->group, _solve_path_batch, p_batch, chunks);
+	job_system->close(&p_batch->group);
+}
+
+Array AStar::_get_batch_paths(PathBatch *p_batch) {
 
-		w[0] = p->id; // Assign first
+	Array paths;
+	paths.resize(p_batch->paths.size());
+
+	for (int i = 0; i < p_batch->paths.size(); i++) {
+
+		if (p_batch->paths[i].get_type() == Variant::NIL) {
+			paths[i] = p_batch->point_paths ? Variant(PoolVector<Vector3>()) : Variant(PoolVector<int>());
+		} else {
+			paths[i] = p_batch->paths[i];
+		}
 	}
 
-	return path;
+	return paths;
+}
+
+Array AStar::get_point_paths(const PoolVector<int> &p_from_to) {
+
+	PathBatch *batch = _create_path_batch(p_from_to, true);
+	ERR_FAIL_COND_V(!batch, Array());
+
+	_run_path_batch(batch, false);
+	JobSystem::get_singleton()->wait(&batch->group);
+
+	Array paths = _get_batch_paths(batch);
+	memdelete(batch);
+
+	return paths;
+}
+
+Array AStar::get_id_paths(const PoolVector<int> &p_from_to) {
+
+	PathBatch *batch = _create_path_batch(p_from_to, false);
+	ERR_FAIL_COND_V(!batch, Array());
+
+	_run_path_batch(batch, false);
+	JobSystem::get_singleton()->wait(&batch->group);
+
+	Array paths = _get_batch_paths(batch);
+	memdelete(batch);
+
+	return paths;
+}
+
+int AStar::request_point_paths(const PoolVector<int> &p_from_to) {
+
+	PathBatch *batch = _create_path_batch(p_from_to, true);
+	ERR_FAIL_COND_V(!batch, -1);
+
+	path_batches[batch->id] = batch;
+	_run_path_batch(batch, true);
+
+	return batch->id;
+}
+
+int AStar::request_id_paths(const PoolVector<int> &p_from_to) {
+
+	PathBatch *batch = _create_path_batch(p_from_to, false);
+	ERR_FAIL_COND_V(!batch, -1);
+
+	path_batches[batch->id] = batch;
+	_run_path_batch(batch, true);
+
+	return batch->id;
+}
+
+void AStar::_path_batch_solved(int p_id) {
+
+	Map<int, PathBatch *>::Element *E = path_batches.find(p_id);
+	ERR_FAIL_COND(!E);
+
+	PathBatch *batch = E->get();
+	path_batches.erase(E);
+
+	// The message is sent right before the group is flagged as completed.
+	JobSystem::get_singleton()->wait(&batch->group);
+
+	Array paths = _get_batch_paths(batch);
+	memdelete(batch);
+
+	emit_signal("paths_solved", p_id, paths);
 }
 
 void AStar::_bind_methods() {
@@ -473,17 +1030,33 @@ void AStar::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_point_path", "from_id", "to_id"), &AStar::get_point_path);
 	ClassDB::bind_method(D_METHOD("get_id_path", "from_id", "to_id"), &AStar::get_id_path);
 
+	ClassDB::bind_method(D_METHOD("get_point_paths", "from_to_ids"), &AStar::get_point_paths);
+	ClassDB::bind_method(D_METHOD("get_id_paths", "from_to_ids"), &AStar::get_id_paths);
+	ClassDB::bind_method(D_METHOD("request_point_paths", "from_to_ids"), &AStar::request_point_paths);
+	ClassDB::bind_method(D_METHOD("request_id_paths", "from_to_ids"), &AStar::request_id_paths);
+
+	ClassDB::bind_method(D_METHOD("_path_batch_solved", "request_id"), &AStar::_path_batch_solved);
+
 	BIND_VMETHOD(MethodInfo(Variant::REAL, "_estimate_cost", PropertyInfo(Variant::INT, "from_id"), PropertyInfo(Variant::INT, "to_id")));
 	BIND_VMETHOD(MethodInfo(Variant::REAL, "_compute_cost", PropertyInfo(Variant::INT, "from_id"), PropertyInfo(Variant::INT, "to_id")));
+
+	ADD_SIGNAL(MethodInfo("paths_solved", PropertyInfo(Variant::INT, "request_id"), PropertyInfo(Variant::ARRAY, "paths")));
 }
 
 AStar::AStar() {
 
-	pass = 1;
+	max_point_id = 0;
+	last_batch_id = 0;
 }
 
 AStar::~AStar() {
 
-	pass = 1;
+	for (Map<int, PathBatch *>::Element *E = path_batches.front(); E; E = E->next()) {
+
+		JobSystem::get_singleton()->wait(&E->get()->group);
+		memdelete(E->get());
+	}
+	path_batches.clear();
+
 	clear();
 }
@@ -30,8 +30,10 @@
 #ifndef ASTAR_H
 #define ASTAR_H
 
+#include "hash_map.h"
+#include "os/job_system.h"
 #include "reference.h"
-#include "self_list.h"
+#include "set.h"
 /**
 	A* pathfinding algorithm
 
@@ -42,28 +44,54 @@ class AStar : public Reference {
 
 	GDCLASS(AStar, Reference)
 
-	uint64_t pass;
-
+	// Points are stored contiguously, neighbours refer to them by index.
 	struct Point {
 
-		SelfList<Point> list;
-
 		int id;
 		Vector3 pos;
 		real_t weight_scale;
-		uint64_t last_pass;
 
-		Vector<Point *> neighbours;
+		Vector<int> neighbours;
+		Vector<int> unlinked_neighbours; // points connected one way to this one
+	};
+
+	// Scratch state of a search, kept apart from the points so several searches can run at once.
+	struct Solver {
+
+		struct State {
+
+			uint64_t open_pass;
+			uint64_t closed_pass;
+			int prev_point;
+			int heap_index;
+			real_t g_score;
+			real_t f_score;
+		};
+
+		uint64_t pass;
+		Vector<State> states;
+
+		// Open set, a binary heap of point indices sorted by f_score.
+		Vector<int> open_heap;
+		int open_heap_size;
 
-		// Used for pathfinding
-		Point *prev_point;
-		real_t distance;
+		void prepare(int p_point_count);
 
-		Point() :
-				list(this) {}
+		void heap_push(int p_index);
+		void heap_decrease_key(int p_index);
+		int heap_pop();
+
+		Solver() {
+			pass = 0;
+			open_heap_size = 0;
+		}
 	};
 
-	Map<int, Point *> points;
+	Solver solver;
+
+	Vector<Point> points;
+	HashMap<int, int> point_indices;
+	int max_point_id; // kept for get_available_point_id(), rescanned only when removed
 
 	struct Segment {
 		union {
@@ -74,9 +102,6 @@ class AStar : public Reference {
 			uint64_t key;
 		};
 
-		Point *from_point;
-		Point *to_point;
-
 		bool operator<(const Segment &p_s) const { return key < p_s.key; }
 		Segment() { key = 0; }
 		Segment(int p_from, int p_to) {
@@ -91,7 +116,71 @@ class AStar : public Reference {
 
 	Set<Segment> segments;
 
-	bool _solve(Point *begin_point, Point *end_point);
+	// Bounding volume hierarchy, rebuilt lazily when queried after changes.
+	struct BVH {
+
+		struct Node {
+
+			AABB aabb;
+			int children[2];
+			int from; // leaves only
+			int count;
+		};
+
+		Vector<Node> nodes;
+		Vector<int> items;
+		bool dirty;
+
+		void build(const Vector<AABB> &p_bounds);
+
+		BVH() { dirty = true; }
+
+	private:
+		int _build(const AABB *p_bounds, const Vector3 *p_centers, int *p_items, int p_from, int p_count);
+	};
+
+	mutable BVH point_bvh;
+	mutable BVH segment_bvh;
+	mutable Vector<int> segment_points; // point index pairs, the items of segment_bvh
+
+	void _update_point_bvh() const;
+	void _update_segment_bvh() const;
+
+	_FORCE_INLINE_ int _get_point_index(int p_id) const {
+
+		const int *idx = point_indices.getptr(p_id);
+		return idx ? *idx : -1;
+	}
+
+	// Costs are asked to p_costs when given, straight distances are used otherwise.
+	static bool _solve(Solver *r_solver, const Point *p_points, int p_point_count, int p_begin_point, int p_end_point, AStar *p_costs);
+	static PoolVector<Vector3> _get_point_path(const Solver &p_solver, const Point *p_points, int p_begin_point, int p_end_point);
+	static PoolVector<int> _get_id_path(const Solver &p_solver, const Point *p_points, int p_begin_point, int p_end_point);
+
+	// Batches of path queries, solved on the job system over a copy of the points.
+	struct PathBatch {
+
+		int id;
+		ObjectID owner;
+		bool point_paths;
+		AStar *costs; // set if the script computes costs, then the batch runs on the calling thread
+		Vector<Point> points; // copy on write, so edits don't touch what the batch reads
+		Vector<int> queries; // begin and end point index pairs, -1 if invalid
+		Vector<Variant> paths;
+		int chunk_size;
+		JobSystem::Group group;
+	};
+
+	Map<int, PathBatch *> path_batches;
+	int last_batch_id;
+
+	PathBatch *_create_path_batch(const PoolVector<int> &p_from_to, bool p_point_paths);
+	void _run_path_batch(PathBatch *p_batch, bool p_notify);
+	Array _get_batch_paths(PathBatch *p_batch);
+	void _path_batch_solved(int p_id);
+
+	static void _solve_path_batch(void *p_batch, uint32_t p_chunk);
+	static void _path_batch_done(void *p_batch);
 
 protected:
 	static void _bind_methods();
@@ -124,6 +213,11 @@ public:
 	PoolVector<Vector3> get_point_path(int p_from_id, int p_to_id);
 	PoolVector<int> get_id_path(int p_from_id, int p_to_id);
 
+	Array get_point_paths(const PoolVector<int> &p_from_to);
+	Array get_id_paths(const PoolVector<int> &p_from_to);
+	int request_point_paths(const PoolVector<int> &p_from_to);
+	int request_id_paths(const PoolVector<int> &p_from_to);
+
 	AStar();
 	~AStar();
 };
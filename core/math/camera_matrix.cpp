@@ -265,7 +265,8 @@ void CameraMatrix::get_viewport_size(real_t &r_width, real_t &r_height) const {
 
 bool CameraMatrix::get_endpoints(const Transform &p_transform, Vector3 *p_8points) const {
 
-	Vector<Plane> planes = get_projection_planes(Transform());
+	Plane planes[6];
+	get_projection_planes(Transform(), planes);
 	const Planes intersections[8][3] = {
 		{ PLANE_FAR, PLANE_LEFT, PLANE_TOP },
 		{ PLANE_FAR, PLANE_LEFT, PLANE_BOTTOM },
@@ -288,7 +289,7 @@ bool CameraMatrix::get_endpoints(const Transform &p_transform, Vector3 *p_8point
 	return true;
 }
 
-Vector<Plane> CameraMatrix::get_projection_planes(const Transform &p_transform) const {
+void CameraMatrix::get_projection_planes(const Transform &p_transform, Plane *r_planes) const {
 
 	/** Fast Plane Extraction from combined modelview/projection matrices.
 	 * References:
@@ -296,8 +297,6 @@ Vector<Plane> CameraMatrix::get_projection_planes(const Transform &p_transform)
 	 * http://www2.ravensoft.com/users/ggribb/plane%20extraction.pdf
 	 */
 
-	Vector<Plane> planes;
-
 	const real_t *matrix = (const real_t *)this->matrix;
 
 	Plane new_plane;
@@ -311,7 +310,7 @@ Vector<Plane> CameraMatrix::get_projection_planes(const Transform &p_transform)
 	new_plane.normal = -new_plane.normal;
 	new_plane.normalize();
 
-	planes.push_back(p_transform.xform(new_plane));
+	r_planes[0] = p_transform.xform(new_plane);
 
 	///////--- Far Plane ---///////
 	new_plane = Plane(matrix[3] - matrix[2],
@@ -322,7 +321,7 @@ Vector<Plane> CameraMatrix::get_projection_planes(const Transform &p_transform)
 	new_plane.normal = -new_plane.normal;
 	new_plane.normalize();
 
-	planes.push_back(p_transform.xform(new_plane));
+	r_planes[1] = p_transform.xform(new_plane);
 
 	///////--- Left Plane ---///////
 	new_plane = Plane(matrix[3] + matrix[0],
@@ -333,7 +332,7 @@ Vector<Plane> CameraMatrix::get_projection_planes(const Transform &p_transform)
 	new_plane.normal = -new_plane.normal;
 	new_plane.normalize();
 
-	planes.push_back(p_transform.xform(new_plane));
+	r_planes[2] = p_transform.xform(new_plane);
 
 	///////--- Top Plane ---///////
 	new_plane = Plane(matrix[3] - matrix[1],
@@ -344,7 +343,7 @@ Vector<Plane> CameraMatrix::get_projection_planes(const Transform &p_transform)
 	new_plane.normal = -new_plane.normal;
 	new_plane.normalize();
 
-	planes.push_back(p_transform.xform(new_plane));
+	r_planes[3] = p_transform.xform(new_plane);
 
 	///////--- Right Plane ---///////
 	new_plane = Plane(matrix[3] - matrix[0],
@@ -355,7 +354,7 @@ Vector<Plane> CameraMatrix::get_projection_planes(const Transform &p_transform)
 	new_plane.normal = -new_plane.normal;
 	new_plane.normalize();
 
-	planes.push_back(p_transform.xform(new_plane));
+	r_planes[4] = p_transform.xform(new_plane);
 
 	///////--- Bottom Plane ---///////
 	new_plane = Plane(matrix[3] + matrix[1],
@@ -366,7 +365,14 @@ Vector<Plane> CameraMatrix::get_projection_planes(const Transform &p_transform)
 	new_plane.normal = -new_plane.normal;
 	new_plane.normalize();
 
-	planes.push_back(p_transform.xform(new_plane));
+	r_planes[5] = p_transform.xform(new_plane);
+}
+
+Vector<Plane> CameraMatrix::get_projection_planes(const Transform &p_transform) const {
+
+	Vector<Plane> planes;
+	planes.resize(6);
+	get_projection_planes(p_transform, planes.ptrw());
 
 	return planes;
 }
@@ -348,8 +348,38 @@ private:
 		int *result_idx;
 		int result_max;
 		uint32_t mask;
+		bool read_only;
+		Octant *root;
 	};
 
+	// Without the pass counter, an element found in several octants is reported from the first one the cull visits.
+	_FORCE_INLINE_ bool _cull_convex_is_first_owner(const Element *p_element, const Octant *p_octant, const _CullConvexData *p_cull) const {
+
+		for (const typename List<typename Element::OctantOwner, AL>::Element *F = p_element->octant_owners.front(); F; F = F->next()) {
+
+			const Octant *o = F->get().octant;
+			if (o == p_octant)
+				return true;
+			if (o == p_cull->root || o->aabb.intersects_convex_shape(p_cull->planes, p_cull->plane_count))
+				return false; // visited through another octant
+		}
+
+		return true;
+	}
+
+	_FORCE_INLINE_ bool _cull_convex_check_pass(Element *p_element, const Octant *p_octant, const _CullConvexData *p_cull) {
+
+		if (!p_cull->read_only) {
+
+			if (p_element->last_pass == pass)
+				return false;
+			p_element->last_pass = pass;
+			return true;
+		}
+
+		return p_element->octant_owners.size() == 1 || _cull_convex_is_first_owner(p_element, p_octant, p_cull);
+	}
+
 	void _cull_convex(Octant *p_octant, _CullConvexData *p_cull);
 	void _cull_aabb(Octant *p_octant, const AABB &p_aabb, T **p_result_array, int *p_result_idx, int p_result_max, int *p_subindex_array, uint32_t p_mask);
 	void _cull_segment(Octant *p_octant, const Vector3 &p_from, const Vector3 &p_to, T **p_result_array, int *p_result_idx, int p_result_max, int *p_subindex_array, uint32_t p_mask);
@@ -380,6 +410,10 @@ public:
 	int get_subindex(OctreeElementID p_id) const;
 
 	int cull_convex(const Vector<Plane> &p_convex, T **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF);
+	int cull_convex(const Plane *p_planes, int p_plane_count, T **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF);
+	// Doesn't write to the octree, so several can run at once on different threads, as long as nothing is modified meanwhile.
+	int cull_convex_read_only(const Vector<Plane> &p_convex, T **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF) const;
+	int cull_convex_read_only(const Plane *p_planes, int p_plane_count, T **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF) const;
 	int cull_aabb(const AABB &p_aabb, T **p_result_array, int p_result_max, int *p_subindex_array = NULL, uint32_t p_mask = 0xFFFFFFFF);
 	int cull_segment(const Vector3 &p_from, const Vector3 &p_to, T **p_result_array, int p_result_max, int *p_subindex_array = NULL, uint32_t p_mask = 0xFFFFFFFF);
 
@@ -1019,9 +1053,8 @@ void Octree<T, use_pairs, AL>::_cull_convex(Octant *p_octant, _CullConvexData *p
 
 			Element *e = I->get();
 
-			if (e->last_pass == pass || (use_pairs && !(e->pairable_type & p_cull->mask)))
+			if ((use_pairs && !(e->pairable_type & p_cull->mask)) || !_cull_convex_check_pass(e, p_octant, p_cull))
 				continue;
-			e->last_pass = pass;
 
 			if (e->aabb.intersects_convex_shape(p_cull->planes, p_cull->plane_count)) {
 
@@ -1045,9 +1078,8 @@ void Octree<T, use_pairs, AL>::_cull_convex(Octant *p_octant, _CullConvexData *p
 
 			Element *e = I->get();
 
-			if (e->last_pass == pass || (use_pairs && !(e->pairable_type & p_cull->mask)))
+			if ((use_pairs && !(e->pairable_type & p_cull->mask)) || !_cull_convex_check_pass(e, p_octant, p_cull))
 				continue;
-			e->last_pass = pass;
 
 			if (e->aabb.intersects_convex_shape(p_cull->planes, p_cull->plane_count)) {
 
@@ -1294,24 +1326,61 @@ void Octree<T, use_pairs, AL>::_cull_point(Octant *p_octant, const Vector3 &p_po
 template <class T, bool use_pairs, class AL>
 int Octree<T, use_pairs, AL>::cull_convex(const Vector<Plane> &p_convex, T **p_result_array, int p_result_max, uint32_t p_mask) {
 
+	return cull_convex(p_convex.ptr(), p_convex.size(), p_result_array, p_result_max, p_mask);
+}
+
+template <class T, bool use_pairs, class AL>
+int Octree<T, use_pairs, AL>::cull_convex(const Plane *p_planes, int p_plane_count, T **p_result_array, int p_result_max, uint32_t p_mask) {
+
 	if (!root)
 		return 0;
 
 	int result_count = 0;
 	pass++;
 	_CullConvexData cdata;
-	cdata.planes = &p_convex[0];
-	cdata.plane_count = p_convex.size();
+	cdata.planes = p_planes;
+	cdata.plane_count = p_plane_count;
 	cdata.result_array = p_result_array;
 	cdata.result_max = p_result_max;
 	cdata.result_idx = &result_count;
 	cdata.mask = p_mask;
+	cdata.read_only = false;
+	cdata.root = root;
 
 	_cull_convex(root, &cdata);
 
 	return result_count;
 }
 
+template <class T, bool use_pairs, class AL>
+int Octree<T, use_pairs, AL>::cull_convex_read_only(const Vector<Plane> &p_convex, T **p_result_array, int p_result_max, uint32_t p_mask) const {
+
+	return cull_convex_read_only(p_convex.ptr(), p_convex.size(), p_result_array, p_result_max, p_mask);
+}
+
+template <class T, bool use_pairs, class AL>
+int Octree<T, use_pairs, AL>::cull_convex_read_only(const Plane *p_planes, int p_plane_count, T **p_result_array, int p_result_max, uint32_t p_mask) const {
+
+	if (!root)
+		return 0;
+
+	int result_count = 0;
+	_CullConvexData cdata;
+	cdata.planes = p_planes;
+	cdata.plane_count = p_plane_count;
+	cdata.result_array = p_result_array;
+	cdata.result_max = p_result_max;
+	cdata.result_idx = &result_count;
+	cdata.mask = p_mask;
+	cdata.read_only = true;
+	cdata.root = root;
+
+	// the pass counter is left alone in read only mode
+	const_cast<Octree *>(this)->_cull_convex(root, &cdata);
+
+	return result_count;
+}
+
 template <class T, bool use_pairs, class AL>
 int Octree<T, use_pairs, AL>::cull_aabb(const AABB &p_aabb, T **p_result_array, int p_result_max, int *p_subindex_array, uint32_t p_mask) {
 
@@ -30,6 +30,7 @@
 #include "message_queue.h"
 
 #include "project_settings.h"
+#include "safe_refcount.h"
 #include "script_language.h"
 
 MessageQueue *MessageQueue::singleton = NULL;
@@ -39,42 +40,289 @@ MessageQueue *MessageQueue::get_singleton() {
 	return singleton;
 }
 
-Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error) {
+MessageQueue::ThreadBuffer *MessageQueue::_get_thread_buffer() {
+
+	Thread::ID caller = Thread::get_caller_id();
+
+	uint32_t count = static_cast<volatile uint32_t &>(thread_buffer_count);
+	for (uint32_t i = 0; i < count; i++) {
+
+		ThreadBuffer *buffer = &thread_buffers[i];
+		if (static_cast<volatile uint32_t &>(buffer->ready) && buffer->thread == caller)
+			return buffer;
+	}
+
+	// First push from this thread.
+	thread_buffer_mutex->lock();
+
+	// Take the buffer of a thread that exited first, what it pushed is still flushed with it.
+	ThreadBuffer *buffer = NULL;
+	for (uint32_t i = 1; i < thread_buffer_count; i++) {
+		if (thread_buffers[i].thread == NO_THREAD) {
+			buffer = &thread_buffers[i];
+			break;
+		}
+	}
+
+	if (!buffer) {
 
-	_THREAD_SAFE_METHOD_
+		if (thread_buffer_count == MAX_THREAD_BUFFERS) {
+			// Too many threads, the others share the buffer of the main thread.
+			thread_buffer_mutex->unlock();
+			return &thread_buffers[0];
+		}
+
+		buffer = &thread_buffers[thread_buffer_count];
+		buffer->mutex = Mutex::create();
+		buffer->first = NULL;
+		buffer->last = NULL;
+		buffer->thread = caller;
+		atomic_increment(&buffer->ready);
+		atomic_increment(&thread_buffer_count);
+	} else {
+		buffer->thread = caller;
+	}
+
+	thread_buffer_mutex->unlock();
+
+	return buffer;
+}
 
-	int room_needed = sizeof(Message) + sizeof(Variant) * p_argcount;
+void MessageQueue::_release_thread_buffer() {
+
+	Thread::ID caller = Thread::get_caller_id();
+
+	thread_buffer_mutex->lock();
+
+	// the first buffer is kept by the main thread (and shared by threads that found no buffer left)
+	for (uint32_t i = 1; i < thread_buffer_count; i++) {
+		if (thread_buffers[i].thread == caller) {
+			thread_buffers[i].thread = NO_THREAD;
+			break;
+		}
+	}
+
+	thread_buffer_mutex->unlock();
+}
+
+void MessageQueue::release_thread_buffer() {
+
+	if (singleton)
+		singleton->_release_thread_buffer();
+}
+
+MessageQueue::Chunk *MessageQueue::_alloc_chunk(uint32_t p_size) {
+
+	uint32_t size = MAX(p_size, uint32_t(CHUNK_SIZE_KB * 1024));
+	Chunk *chunk = NULL;
+
+	if (size == CHUNK_SIZE_KB * 1024) {
+
+		chunk_mutex->lock();
+		chunk = free_chunks;
+		if (chunk) {
+			free_chunks = chunk->next;
+			free_size -= size;
+		}
+		chunk_mutex->unlock();
+	}
+
+	if (!chunk) {
+
+		chunk = (Chunk *)memalloc(sizeof(Chunk) + size);
+		ERR_FAIL_COND_V(!chunk, NULL);
+		chunk->size = size;
+	}
+
+	chunk->next = NULL;
+	chunk->end = 0;
+	return chunk;
+}
+
+void MessageQueue::_free_chunk(Chunk *p_chunk) {
+
+	if (p_chunk->size == CHUNK_SIZE_KB * 1024) {
+
+		chunk_mutex->lock();
+		bool keep = free_size + p_chunk->size <= max_free_size;
+		if (keep) {
+			p_chunk->next = free_chunks;
+			free_chunks = p_chunk;
+			free_size += p_chunk->size;
+		}
+		chunk_mutex->unlock();
 
-	if ((buffer_end + room_needed) >= buffer_size) {
-		String type;
-		if (ObjectDB::get_instance(p_id))
-			type = ObjectDB::get_instance(p_id)->get_class();
-		print_line("failed method: " + type + ":" + p_method + " target ID: " + itos(p_id));
-		statistics();
-		ERR_EXPLAIN("Message queue out of memory. Try increasing 'message_queue_size_kb' in project settings");
+		if (keep)
+			return;
+	}
+
+	memfree(p_chunk);
+}
+
+MessageQueue::Message *MessageQueue::_alloc_message(ThreadBuffer *p_buffer, uint32_t p_size) {
+
+	Chunk *chunk = p_buffer->last;
+
+	if (!chunk || chunk->end + p_size > chunk->size) {
+
+		Chunk *new_chunk = _alloc_chunk(p_size);
+		if (!new_chunk)
+			return NULL;
+
+		if (chunk)
+			chunk->next = new_chunk;
+		else
+			p_buffer->first = new_chunk;
+		p_buffer->last = new_chunk;
+		chunk = new_chunk;
+	}
+
+	Message *msg = memnew_placement(&chunk->get_data()[chunk->end], Message);
+	chunk->end += p_size;
+	return msg;
+}
+
+MessageQueue::Chunk *MessageQueue::_take_chunks(uint32_t *r_size) {
+
+	Chunk *first = NULL;
+	Chunk *last = NULL;
+
+	uint32_t count = static_cast<volatile uint32_t &>(thread_buffer_count);
+	for (uint32_t i = 0; i < count; i++) {
+
+		ThreadBuffer *buffer = &thread_buffers[i];
+		if (!static_cast<volatile uint32_t &>(buffer->ready) || !static_cast<Chunk *volatile &>(buffer->first))
+			continue;
+
+		buffer->mutex->lock();
+		if (buffer->first) {
+			if (last)
+				last->next = buffer->first;
+			else
+				first = buffer->first;
+			last = buffer->last;
+			buffer->first = NULL;
+			buffer->last = NULL;
+		}
+		buffer->mutex->unlock();
+	}
+
+	*r_size = 0;
+	for (Chunk *chunk = first; chunk; chunk = chunk->next) {
+		*r_size += chunk->end;
+	}
+
+	return first;
+}
+
+void MessageQueue::_free_messages(Chunk *p_chunk) {
+
+	while (p_chunk) {
+
+		uint32_t read_pos = 0;
+		while (read_pos < p_chunk->end) {
+
+			Message *message = (Message *)&p_chunk->get_data()[read_pos];
+			read_pos += sizeof(Message);
+
+			if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+				Variant *args = (Variant *)(message + 1);
+				for (int i = 0; i < message->args; i++)
+					args[i].~Variant();
+				read_pos += sizeof(Variant) * message->args;
+			}
+
+			message->~Message();
+		}
+
+		Chunk *next = p_chunk->next;
+		_free_chunk(p_chunk);
+		p_chunk = next;
+	}
+}
+
+Error MessageQueue::_push_call(ObjectID p_id, Object *p_object, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error) {
+
+	// Scripts can override methods, so calls to objects with scripts are looked up by name when flushed.
+	MethodBind *method = NULL;
+	if (p_object && !p_object->get_script_instance())
+		method = ClassDB::get_method(p_object->get_class_name(), p_method);
+
+	ThreadBuffer *buffer = _get_thread_buffer();
+	buffer->mutex->lock();
+
+	Message *msg = _alloc_message(buffer, sizeof(Message) + sizeof(Variant) * p_argcount);
+	if (!msg) {
+		buffer->mutex->unlock();
+		print_line("failed method: " + p_method + " target ID: " + itos(p_id));
+		ERR_EXPLAIN("Message queue out of memory.");
 		ERR_FAIL_V(ERR_OUT_OF_MEMORY);
 	}
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
 	msg->args = p_argcount;
 	msg->instance_ID = p_id;
 	msg->target = p_method;
+	msg->method = method;
+	msg->index = -1;
 	msg->type = TYPE_CALL;
 	if (p_show_error)
 		msg->type |= FLAG_SHOW_ERROR;
 
-	buffer_end += sizeof(Message);
-
+	Variant *args = (Variant *)(msg + 1);
 	for (int i = 0; i < p_argcount; i++) {
 
-		Variant *v = memnew_placement(&buffer[buffer_end], Variant);
-		buffer_end += sizeof(Variant);
+		Variant *v = memnew_placement(&args[i], Variant);
 		*v = *p_args[i];
 	}
 
+	buffer->mutex->unlock();
+	return OK;
+}
+
+Error MessageQueue::_push_set(ObjectID p_id, Object *p_object, const StringName &p_prop, const Variant &p_value) {
+
+	// Same setter Object::set() would find, unless a script handles the property.
+	MethodBind *setter = NULL;
+	int index = -1;
+	if (p_object && !p_object->get_script_instance()) {
+
+		const ClassDB::PropertySetGet *psg = ClassDB::get_property_setget(p_object->get_class_name(), p_prop);
+		if (psg && psg->_setptr) {
+			setter = psg->_setptr;
+			index = psg->index;
+		}
+	}
+
+	ThreadBuffer *buffer = _get_thread_buffer();
+	buffer->mutex->lock();
+
+	Message *msg = _alloc_message(buffer, sizeof(Message) + sizeof(Variant));
+	if (!msg) {
+		buffer->mutex->unlock();
+		print_line("failed set: " + p_prop + " target ID: " + itos(p_id));
+		ERR_EXPLAIN("Message queue out of memory.");
+		ERR_FAIL_V(ERR_OUT_OF_MEMORY);
+	}
+
+	msg->args = 1;
+	msg->instance_ID = p_id;
+	msg->target = p_prop;
+	msg->method = setter;
+	msg->index = index;
+	msg->type = TYPE_SET;
+
+	Variant *v = memnew_placement((Variant *)(msg + 1), Variant);
+	*v = p_value;
+
+	buffer->mutex->unlock();
 	return OK;
 }
 
+Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error) {
+
+	return _push_call(p_id, NULL, p_method, p_args, p_argcount, p_show_error);
+}
+
 Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, VARIANT_ARG_DECLARE) {
 
 	VARIANT_ARGPTRS;
@@ -92,68 +340,53 @@ Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, VARIANT
 
 Error MessageQueue::push_set(ObjectID p_id, const StringName &p_prop, const Variant &p_value) {
 
-	_THREAD_SAFE_METHOD_
-
-	uint8_t room_needed = sizeof(Message) + sizeof(Variant);
-
-	if ((buffer_end + room_needed) >= buffer_size) {
-		String type;
-		if (ObjectDB::get_instance(p_id))
-			type = ObjectDB::get_instance(p_id)->get_class();
-		print_line("failed set: " + type + ":" + p_prop + " target ID: " + itos(p_id));
-		statistics();
-		ERR_EXPLAIN("Message queue out of memory. Try increasing 'message_queue_size_kb' in project settings");
-		ERR_FAIL_V(ERR_OUT_OF_MEMORY);
-	}
-
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
-	msg->args = 1;
-	msg->instance_ID = p_id;
-	msg->target = p_prop;
-	msg->type = TYPE_SET;
-
-	buffer_end += sizeof(Message);
-
-	Variant *v = memnew_placement(&buffer[buffer_end], Variant);
-	buffer_end += sizeof(Variant);
-	*v = p_value;
-
-	return OK;
+	return _push_set(p_id, NULL, p_prop, p_value);
 }
 
 Error MessageQueue::push_notification(ObjectID p_id, int p_notification) {
 
-	_THREAD_SAFE_METHOD_
-
 	ERR_FAIL_COND_V(p_notification < 0, ERR_INVALID_PARAMETER);
 
-	uint8_t room_needed = sizeof(Message);
+	ThreadBuffer *buffer = _get_thread_buffer();
+	buffer->mutex->lock();
 
-	if ((buffer_end + room_needed) >= buffer_size) {
-		String type;
-		if (ObjectDB::get_instance(p_id))
-			type = ObjectDB::get_instance(p_id)->get_class();
+	Message *msg = _alloc_message(buffer, sizeof(Message));
+	if (!msg) {
+		buffer->mutex->unlock();
 		print_line("failed notification: " + itos(p_notification) + " target ID: " + itos(p_id));
-		statistics();
-		ERR_EXPLAIN("Message queue out of memory. Try increasing 'message_queue_size_kb' in project settings");
+		ERR_EXPLAIN("Message queue out of memory.");
 		ERR_FAIL_V(ERR_OUT_OF_MEMORY);
 	}
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
-
 	msg->type = TYPE_NOTIFICATION;
 	msg->instance_ID = p_id;
 	//msg->target;
+	msg->method = NULL;
+	msg->index = -1;
 	msg->notification = p_notification;
 
-	buffer_end += sizeof(Message);
-
+	buffer->mutex->unlock();
 	return OK;
 }
 
+Error MessageQueue::push_call(Object *p_object, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error) {
+
+	return _push_call(p_object->get_instance_id(), p_object, p_method, p_args, p_argcount, p_show_error);
+}
+
 Error MessageQueue::push_call(Object *p_object, const StringName &p_method, VARIANT_ARG_DECLARE) {
 
-	return push_call(p_object->get_instance_id(), p_method, VARIANT_ARG_PASS);
+	VARIANT_ARGPTRS;
+
+	int argc = 0;
+
+	for (int i = 0; i < VARIANT_ARG_MAX; i++) {
+		if (argptr[i]->get_type() == Variant::NIL)
+			break;
+		argc++;
+	}
+
+	return push_call(p_object, p_method, argptr, argc, false);
 }
 
 Error MessageQueue::push_notification(Object *p_object, int p_notification) {
@@ -162,7 +395,7 @@ Error MessageQueue::push_notification(Object *p_object, int p_notification) {
 }
 Error MessageQueue::push_set(Object *p_object, const StringName &p_prop, const Variant &p_value) {
 
-	return push_set(p_object->get_instance_id(), p_prop, p_value);
+	return _push_set(p_object->get_instance_id(), p_object, p_prop, p_value);
 }
 
 void MessageQueue::statistics() {
@@ -171,57 +404,74 @@ void MessageQueue::statistics() {
 	Map<int, int> notify_count;
 	Map<StringName, int> call_count;
 	int null_count = 0;
+	uint32_t total_bytes = 0;
 
-	uint32_t read_pos = 0;
-	while (read_pos < buffer_end) {
-		Message *message = (Message *)&buffer[read_pos];
+	for (uint32_t i = 0; i < thread_buffer_count; i++) {
 
-		Object *target = ObjectDB::get_instance(message->instance_ID);
+		ThreadBuffer *buffer = &thread_buffers[i];
+		if (!buffer->ready)
+			continue;
 
-		if (target != NULL) {
+		buffer->mutex->lock();
 
-			switch (message->type & FLAG_MASK) {
+		for (Chunk *chunk = buffer->first; chunk; chunk = chunk->next) {
 
-				case TYPE_CALL: {
+			total_bytes += chunk->end;
 
-					if (!call_count.has(message->target))
-						call_count[message->target] = 0;
+			uint32_t read_pos = 0;
+			while (read_pos < chunk->end) {
+				Message *message = (Message *)&chunk->get_data()[read_pos];
 
-					call_count[message->target]++;
+				Object *target = ObjectDB::get_instance(message->instance_ID);
 
-				} break;
-				case TYPE_NOTIFICATION: {
+				if (target != NULL) {
 
-					if (!notify_count.has(message->notification))
-						notify_count[message->notification] = 0;
+					switch (message->type & FLAG_MASK) {
 
-					notify_count[message->notification]++;
+						case TYPE_CALL: {
 
-				} break;
-				case TYPE_SET: {
+							if (!call_count.has(message->target))
+								call_count[message->target] = 0;
 
-					if (!set_count.has(message->target))
-						set_count[message->target] = 0;
+							call_count[message->target]++;
 
-					set_count[message->target]++;
+						} break;
+						case TYPE_NOTIFICATION: {
 
-				} break;
-			}
+							if (!notify_count.has(message->notification))
+								notify_count[message->notification] = 0;
+
+							notify_count[message->notification]++;
+
+						} break;
+						case TYPE_SET: {
 
-			//object was deleted
-			//WARN_PRINT("Object was deleted while awaiting a callback")
-			//should it print a warning?
-		} else {
+							if (!set_count.has(message->target))
+								set_count[message->target] = 0;
 
-			null_count++;
+							set_count[message->target]++;
+
+						} break;
+					}
+
+					//object was deleted
+					//WARN_PRINT("Object was deleted while awaiting a callback")
+					//should it print a warning?
+				} else {
+
+					null_count++;
+				}
+
+				read_pos += sizeof(Message);
+				if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION)
+					read_pos += sizeof(Variant) * message->args;
+			}
 		}
 
-		read_pos += sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION)
-			read_pos += sizeof(Variant) * message->args;
+		buffer->mutex->unlock();
 	}
 
-	print_line("TOTAL BYTES: " + itos(buffer_end));
+	print_line("TOTAL BYTES: " + itos(total_bytes));
 	print_line("NULL count: " + itos(null_count));
 
 	for (Map<StringName, int>::Element *E = set_count.front(); E; E = E->next()) {
@@ -245,7 +495,7 @@ int MessageQueue::get_max_buffer_usage() const {
 	return buffer_max_used;
 }
 
-void MessageQueue::_call_function(Object *p_target, const StringName &p_func, const Variant *p_args, int p_argcount, bool p_show_error) {
+void MessageQueue::_call_function(Object *p_target, const StringName &p_func, MethodBind *p_method, const Variant *p_args, int p_argcount, bool p_show_error) {
 
 	const Variant **argptrs = NULL;
 	if (p_argcount) {
@@ -256,7 +506,16 @@ void MessageQueue::_call_function(Object *p_target, const StringName &p_func, co
 	}
 
 	Variant::CallError ce;
-	p_target->call(p_func, argptrs, p_argcount, ce);
+	if (p_method && !p_target->get_script_instance()) {
+		// resolved when pushed, and no script was set since, so do what Object::call would
+#ifdef DEBUG_ENABLED
+		_ObjectDebugLock target_lock(p_target);
+#endif
+		ce.error = Variant::CallError::CALL_OK;
+		p_method->call(p_target, argptrs, p_argcount, ce);
+	} else {
+		p_target->call(p_func, argptrs, p_argcount, ce);
+	}
 	if (p_show_error && ce.error != Variant::CallError::CALL_OK) {
 
 		ERR_PRINTS("Error calling deferred method: " + Variant::get_call_error_text(p_target, p_func, argptrs, p_argcount, ce));
@@ -265,73 +524,90 @@ void MessageQueue::_call_function(Object *p_target, const StringName &p_func, co
 
 void MessageQueue::flush() {
 
-	if (buffer_end > buffer_max_used) {
-		buffer_max_used = buffer_end;
-		//statistics();
-	}
+	uint32_t size;
+	Chunk *chunks;
 
-	uint32_t read_pos = 0;
+	// Messages pushed while flushing, from this thread or others, are taken in the next round.
+	while ((chunks = _take_chunks(&size))) {
 
-	//using reverse locking strategy
-	_THREAD_SAFE_LOCK_
+		if (size > buffer_max_used) {
+			buffer_max_used = size;
+			//statistics();
+		}
 
-	while (read_pos < buffer_end) {
+		while (chunks) {
 
-		//lock on each interation, so a call can re-add itself to the message queue
+			Chunk *chunk = chunks;
+			uint32_t read_pos = 0;
 
-		Message *message = (Message *)&buffer[read_pos];
+			while (read_pos < chunk->end) {
 
-		uint32_t advance = sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION)
-			advance += sizeof(Variant) * message->args;
+				Message *message = (Message *)&chunk->get_data()[read_pos];
 
-		//pre-advance so this function is reentrant
-		read_pos += advance;
+				read_pos += sizeof(Message);
+				if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION)
+					read_pos += sizeof(Variant) * message->args;
 
-		_THREAD_SAFE_UNLOCK_
+				Object *target = ObjectDB::get_instance(message->instance_ID);
 
-		Object *target = ObjectDB::get_instance(message->instance_ID);
+				if (target != NULL) {
 
-		if (target != NULL) {
+					switch (message->type & FLAG_MASK) {
+						case TYPE_CALL: {
 
-			switch (message->type & FLAG_MASK) {
-				case TYPE_CALL: {
+							Variant *args = (Variant *)(message + 1);
 
-					Variant *args = (Variant *)(message + 1);
+							// messages don't expect a return value
 
-					// messages don't expect a return value
+							_call_function(target, message->target, message->method, args, message->args, message->type & FLAG_SHOW_ERROR);
 
-					_call_function(target, message->target, args, message->args, message->type & FLAG_SHOW_ERROR);
+						} break;
+						case TYPE_NOTIFICATION: {
 
-					for (int i = 0; i < message->args; i++) {
-						args[i].~Variant();
-					}
+							// messages don't expect a return value
+							target->notification(message->notification);
 
-				} break;
-				case TYPE_NOTIFICATION: {
+						} break;
+						case TYPE_SET: {
 
-					// messages don't expect a return value
-					target->notification(message->notification);
+							Variant *arg = (Variant *)(message + 1);
+							// messages don't expect a return value
+							if (message->method && !target->get_script_instance()) {
 
-				} break;
-				case TYPE_SET: {
+								Variant::CallError ce;
+								if (message->index >= 0) {
+									Variant index = message->index;
+									const Variant *args[2] = { &index, arg };
+									message->method->call(target, args, 2, ce);
+								} else {
+									const Variant *args[1] = { arg };
+									message->method->call(target, args, 1, ce);
+								}
+#ifdef TOOLS_ENABLED
+								target->set_edited(true);
+#endif
+							} else {
+								target->set(message->target, *arg);
+							}
 
-					Variant *arg = (Variant *)(message + 1);
-					// messages don't expect a return value
-					target->set(message->target, *arg);
+						} break;
+					}
+				}
 
-					arg->~Variant();
-				} break;
-			}
-		}
+				if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+					Variant *args = (Variant *)(message + 1);
+					for (int i = 0; i < message->args; i++) {
+						args[i].~Variant();
+					}
+				}
 
-		message->~Message();
+				message->~Message();
+			}
 
-		_THREAD_SAFE_LOCK_
+			chunks = chunk->next;
+			_free_chunk(chunk);
+		}
 	}
-
-	buffer_end = 0; // reset buffer
-	_THREAD_SAFE_UNLOCK_
 }
 
 MessageQueue::MessageQueue() {
@@ -339,33 +615,49 @@ MessageQueue::MessageQueue() {
 	ERR_FAIL_COND(singleton != NULL);
 	singleton = this;
 
-	buffer_end = 0;
+	for (int i = 0; i < MAX_THREAD_BUFFERS; i++) {
+
+		thread_buffers[i].mutex = NULL;
+		thread_buffers[i].ready = 0;
+	}
+
+	// the main thread creates the queue, so it gets the first buffer
+	thread_buffer_mutex = Mutex::create();
+	thread_buffer_count = 0;
+	_get_thread_buffer();
+
+	chunk_mutex = Mutex::create();
+	free_chunks = NULL;
+	free_size = 0;
+
+	// not a limit anymore, chunks are added when needed, this much is kept for reuse
+	max_free_size = GLOBAL_DEF("memory/limits/message_queue/max_size_kb", DEFAULT_QUEUE_SIZE_KB);
+	max_free_size *= 1024;
+
 	buffer_max_used = 0;
-	buffer_size = GLOBAL_DEF("memory/limits/message_queue/max_size_kb", DEFAULT_QUEUE_SIZE_KB);
-	buffer_size *= 1024;
-	buffer = memnew_arr(uint8_t, buffer_size);
 }
 
 MessageQueue::~MessageQueue() {
 
-	uint32_t read_pos = 0;
+	for (uint32_t i = 0; i < thread_buffer_count; i++) {
 
-	while (read_pos < buffer_end) {
+		ThreadBuffer *buffer = &thread_buffers[i];
+		if (!buffer->ready)
+			continue;
 
-		Message *message = (Message *)&buffer[read_pos];
-		Variant *args = (Variant *)(message + 1);
-		int argc = message->args;
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			for (int i = 0; i < argc; i++)
-				args[i].~Variant();
-		}
-		message->~Message();
+		_free_messages(buffer->first);
+		memdelete(buffer->mutex);
+	}
+
+	memdelete(thread_buffer_mutex);
+
+	while (free_chunks) {
 
-		read_pos += sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION)
-			read_pos += sizeof(Variant) * message->args;
+		Chunk *next = free_chunks->next;
+		memfree(free_chunks);
+		free_chunks = next;
 	}
 
+	memdelete(chunk_mutex);
 	singleton = NULL;
-	memdelete_arr(buffer);
 }
@@ -32,19 +32,17 @@
 
 #include "object.h"
 #include "os/mutex.h"
-#include "os/thread_safe.h"
+#include "os/thread.h"
 
 class MessageQueue {
 
-	_THREAD_SAFE_CLASS_
-
 	enum {
 
-		DEFAULT_QUEUE_SIZE_KB = 1024
+		DEFAULT_QUEUE_SIZE_KB = 1024,
+		CHUNK_SIZE_KB = 64,
+		MAX_THREAD_BUFFERS = 64
 	};
 
-	Mutex *mutex;
-
 	enum {
 		TYPE_CALL,
 		TYPE_NOTIFICATION,
@@ -58,6 +56,8 @@ class MessageQueue {
 
 		ObjectID instance_ID;
 		StringName target;
+		MethodBind *method; // resolved when pushed if possible, looked up by name when flushed otherwise
+		int index; // of the property, for setters
 		int16_t type;
 		union {
 			int16_t notification;
@@ -65,12 +65,51 @@ class MessageQueue {
 		};
 	};
 
-	uint8_t *buffer;
-	uint32_t buffer_end;
+	// Messages are appended to chunks, which are recycled after being flushed.
+	struct Chunk {
+
+		Chunk *next;
+		uint32_t end;
+		uint32_t size;
+
+		_FORCE_INLINE_ uint8_t *get_data() { return reinterpret_cast<uint8_t *>(this + 1); }
+	};
+
+	// Each thread pushes to its own buffer, the lock is only shared with flush() taking the chunks.
+	struct ThreadBuffer {
+
+		Thread::ID thread;
+		Mutex *mutex;
+		Chunk *first;
+		Chunk *last;
+		uint32_t ready;
+	};
+
+	ThreadBuffer thread_buffers[MAX_THREAD_BUFFERS]; // the first one belongs to the main thread
+	uint32_t thread_buffer_count;
+	Mutex *thread_buffer_mutex; // taking and releasing buffers, pushing doesn't need it
+
+	static const Thread::ID NO_THREAD = Thread::ID(-1); // owner of a released buffer
+
+	Mutex *chunk_mutex;
+	Chunk *free_chunks;
+	uint32_t free_size;
+	uint32_t max_free_size;
+
 	uint32_t buffer_max_used;
-	uint32_t buffer_size;
 
-	void _call_function(Object *p_target, const StringName &p_func, const Variant *p_args, int p_argcount, bool p_show_error);
+	ThreadBuffer *_get_thread_buffer();
+	void _release_thread_buffer();
+	Chunk *_alloc_chunk(uint32_t p_size);
+	void _free_chunk(Chunk *p_chunk);
+	Message *_alloc_message(ThreadBuffer *p_buffer, uint32_t p_size);
+	Chunk *_take_chunks(uint32_t *r_size);
+	void _free_messages(Chunk *p_chunk);
+
+	Error _push_call(ObjectID p_id, Object *p_object, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error);
+	Error _push_set(ObjectID p_id, Object *p_object, const StringName &p_prop, const Variant &p_value);
+
+	void _call_function(Object *p_target, const StringName &p_func, MethodBind *p_method, const Variant *p_args, int p_argcount, bool p_show_error);
 
 	static MessageQueue *singleton;
 
@@ -82,6 +121,7 @@ public:
 	Error push_notification(ObjectID p_id, int p_notification);
 	Error push_set(ObjectID p_id, const StringName &p_prop, const Variant &p_value);
 
+	Error push_call(Object *p_object, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error = false);
 	Error push_call(Object *p_object, const StringName &p_method, VARIANT_ARG_LIST);
 	Error push_notification(Object *p_object, int p_notification);
 	Error push_set(Object *p_object, const StringName &p_prop, const Variant &p_value);
@@ -89,6 +129,9 @@ public:
 	void statistics();
 	void flush();
 
+	// Called by threads when they exit, so their buffer can be taken by new ones.
+	static void release_thread_buffer();
+
 	int get_max_buffer_usage() const;
 
 	MessageQueue();
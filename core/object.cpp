@@ -40,19 +40,6 @@
 
 #ifdef DEBUG_ENABLED
 
-struct _ObjectDebugLock {
-
-	Object *obj;
-
-	_ObjectDebugLock(Object *p_obj) {
-		obj = p_obj;
-		obj->_lock_index.ref();
-	}
-	~_ObjectDebugLock() {
-		obj->_lock_index.unref();
-	}
-};
-
 #define OBJ_DEBUG_LOCK _ObjectDebugLock _debug_lock(this);
 
 #else
@@ -665,7 +652,7 @@ Variant Object::_call_deferred_bind(const Variant **p_args, int p_argcount, Vari
 
 	StringName method = *p_args[0];
 
-	MessageQueue::get_singleton()->push_call(get_instance_id(), method, &p_args[1], p_argcount - 1);
+	MessageQueue::get_singleton()->push_call(this, method, &p_args[1], p_argcount - 1);
 
 	return Variant();
 }
@@ -1088,13 +1075,6 @@ bool Object::_has_user_signal(const StringName &p_name) const {
 	return signal_map[p_name].user.name.length() > 0;
 }
 
-struct _ObjectSignalDisconnectData {
-
-	StringName signal;
-	Object *target;
-	StringName method;
-};
-
 Variant Object::_emit_signal(const Variant **p_args, int p_argcount, Variant::CallError &r_error) {
 
 	r_error.error = Variant::CallError::CALL_ERROR_TOO_FEW_ARGUMENTS;
@@ -1142,24 +1122,37 @@ Error Object::emit_signal(const StringName &p_name, const Variant **p_args, int
 		return ERR_UNAVAILABLE;
 	}
 
-	List<_ObjectSignalDisconnectData> disconnect_data;
-
-	//copy on write will ensure that disconnecting the signal or even deleting the object will not affect the signal calling.
-	//this happens automatically and will not change the performance of calling.
-	//awesome, isn't it?
-	VMap<Signal::Target, Signal::Slot> slot_map = s->slot_map;
+	// Taking a reference to the slot array keeps it alive, unchanged, while it is being called.
+	// Connecting or disconnecting (or even deleting this object) from a callback makes the
+	// signal copy its own array on write instead, so emitting never copies the slots.
+	// All access below must go through the const reference, or copy on write triggers here.
+	const VMap<Signal::Target, Signal::Slot> slot_map_ref = s->slot_map;
+	const VMap<Signal::Target, Signal::Slot> &slot_map = slot_map_ref;
 
 	int ssize = slot_map.size();
 
 	OBJ_DEBUG_LOCK
 
-	Vector<const Variant *> bind_mem;
+	int max_binds = 0;
+	for (int i = 0; i < ssize; i++) {
+		max_binds = MAX(max_binds, slot_map.getv(i).conn.binds.size());
+	}
+
+	const Variant **bind_mem = NULL;
+	if (max_binds) {
+		bind_mem = (const Variant **)alloca(sizeof(Variant *) * (p_argcount + max_binds));
+		for (int j = 0; j < p_argcount; j++) {
+			bind_mem[j] = p_args[j];
+		}
+	}
 
 	Error err = OK;
+	bool oneshot = false;
 
 	for (int i = 0; i < ssize; i++) {
 
-		const Connection &c = slot_map.getv(i).conn;
+		const Signal::Slot &slot = slot_map.getv(i);
+		const Connection &c = slot.conn;
 
 		Object *target;
 #ifdef DEBUG_ENABLED
@@ -1174,24 +1167,28 @@ Error Object::emit_signal(const StringName &p_name, const Variant **p_args, int
 
 		if (c.binds.size()) {
 			//handle binds
-			bind_mem.resize(p_argcount + c.binds.size());
-
-			for (int j = 0; j < p_argcount; j++) {
-				bind_mem[j] = p_args[j];
-			}
 			for (int j = 0; j < c.binds.size(); j++) {
 				bind_mem[p_argcount + j] = &c.binds[j];
 			}
 
-			args = (const Variant **)bind_mem.ptr();
-			argc = bind_mem.size();
+			args = bind_mem;
+			argc = p_argcount + c.binds.size();
 		}
 
 		if (c.flags & CONNECT_DEFERRED) {
-			MessageQueue::get_singleton()->push_call(target->get_instance_id(), c.method, args, argc, true);
+			MessageQueue::get_singleton()->push_call(target, c.method, args, argc, true);
 		} else {
 			Variant::CallError ce;
-			target->call(c.method, args, argc, ce);
+			if (slot.method && !target->get_script_instance()) {
+				// same as Object::call would end up doing, without looking the method up by name
+#ifdef DEBUG_ENABLED
+				_ObjectDebugLock target_lock(target);
+#endif
+				ce.error = Variant::CallError::CALL_OK; // vararg binds may return early without setting it
+				slot.method->call(target, args, argc, ce);
+			} else {
+				target->call(c.method, args, argc, ce);
+			}
 
 			if (ce.error != Variant::CallError::CALL_OK) {
 
@@ -1205,19 +1202,28 @@ Error Object::emit_signal(const StringName &p_name, const Variant **p_args, int
 		}
 
 		if (c.flags & CONNECT_ONESHOT) {
-			_ObjectSignalDisconnectData dd;
-			dd.signal = p_name;
-			dd.target = target;
-			dd.method = c.method;
-			disconnect_data.push_back(dd);
+			oneshot = true;
 		}
 	}
 
-	while (!disconnect_data.empty()) {
+	if (oneshot) {
+		// the slot array is still the one that was called, so disconnect from it after the fact
+		for (int i = 0; i < ssize; i++) {
+
+			const Connection &c = slot_map.getv(i).conn;
+			if (!(c.flags & CONNECT_ONESHOT))
+				continue;
 
-		const _ObjectSignalDisconnectData &dd = disconnect_data.front()->get();
-		disconnect(dd.signal, dd.target, dd.method);
-		disconnect_data.pop_front();
+			Object *target;
+#ifdef DEBUG_ENABLED
+			target = ObjectDB::get_instance(slot_map.getk(i)._id);
+			if (!target)
+				continue;
+#else
+			target = c.target;
+#endif
+			disconnect(p_name, target, c.method);
+		}
 	}
 
 	return err;
@@ -1423,6 +1429,7 @@ Error Object::connect(const StringName &p_signal, Object *p_to_object, const Str
 	conn.binds = p_binds;
 	slot.conn = conn;
 	slot.cE = p_to_object->connections.push_back(conn);
+	slot.method = ClassDB::get_method(p_to_object->get_class_name(), p_to_method);
 	s->slot_map[target] = slot;
 
 	return OK;
@@ -378,6 +378,7 @@ public:                                                        \
 private:
 
 class ScriptInstance;
+class MethodBind;
 typedef uint64_t ObjectID;
 
 class Object {
@@ -414,7 +415,7 @@ private:
 	};
 
 #ifdef DEBUG_ENABLED
-	friend class _ObjectDebugLock;
+	friend struct _ObjectDebugLock;
 #endif
 	friend bool predelete_handler(Object *);
 	friend void postinitialize_handler(Object *);
@@ -439,6 +440,11 @@ private:
 
 			Connection conn;
 			List<Connection>::Element *cE;
+			MethodBind *method; // resolved on connect, only valid while the target has no script instance
+			Slot() {
+				cE = NULL;
+				method = NULL;
+			}
 		};
 
 		MethodInfo user;
@@ -723,6 +729,24 @@ public:
 bool predelete_handler(Object *p_object);
 void postinitialize_handler(Object *p_object);
 
+#ifdef DEBUG_ENABLED
+
+// Catches objects deleted while one of their methods runs.
+struct _ObjectDebugLock {
+
+	Object *obj;
+
+	_ObjectDebugLock(Object *p_obj) {
+		obj = p_obj;
+		obj->_lock_index.ref();
+	}
+	~_ObjectDebugLock() {
+		obj->_lock_index.unref();
+	}
+};
+
+#endif
+
 class ObjectDB {
 
 	struct ObjectPtrHash {
@@ -0,0 +1,453 @@
+/*************************************************************************/
+/*  job_system.cpp                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "job_system.h"
+
+#include "os/os.h"
+
+JobSystem *JobSystem::singleton = NULL;
+
+/* JOB QUEUE */
+
+void JobSystem::JobQueue::push(const Job &p_job) {
+
+	mutex->lock();
+
+	if (tail - head == capacity) {
+
+		uint32_t new_capacity = capacity << 1;
+		Job *new_jobs = memnew_arr(Job, new_capacity);
+		for (uint32_t i = head; i != tail; i++) {
+			new_jobs[i & (new_capacity - 1)] = jobs[i & (capacity - 1)];
+		}
+		memdelete_arr(jobs);
+		jobs = new_jobs;
+		capacity = new_capacity;
+	}
+
+	jobs[tail & (capacity - 1)] = p_job;
+	tail++;
+
+	mutex->unlock();
+}
+
+bool JobSystem::JobQueue::pop(Job *r_job) {
+
+	mutex->lock();
+
+	if (head == tail) {
+		mutex->unlock();
+		return false;
+	}
+
+	tail--;
+	*r_job = jobs[tail & (capacity - 1)];
+
+	mutex->unlock();
+	return true;
+}
+
+bool JobSystem::JobQueue::steal(Job *r_job) {
+
+	mutex->lock();
+
+	if (head == tail) {
+		mutex->unlock();
+		return false;
+	}
+
+	*r_job = jobs[head & (capacity - 1)];
+	head++;
+
+	mutex->unlock();
+	return true;
+}
+
+bool JobSystem::JobQueue::is_empty() {
+
+	mutex->lock();
+	bool empty = head == tail;
+	mutex->unlock();
+	return empty;
+}
+
+JobSystem::JobQueue::JobQueue() {
+
+	mutex = Mutex::create(false);
+	capacity = 64;
+	jobs = memnew_arr(Job, capacity);
+	head = 0;
+	tail = 0;
+}
+
+JobSystem::JobQueue::~JobQueue() {
+
+	memdelete_arr(jobs);
+	memdelete(mutex);
+}
+
+/* GROUP */
+
+JobSystem::Group::Group() {
+
+	pending = 1;
+	completed = 0;
+	closed = false;
+	submitted = false;
+	has_dependencies = false;
+	unresolved = 0;
+	completion_func = NULL;
+	completion_userdata = NULL;
+}
+
+JobSystem::Group::~Group() {
+
+	ERR_FAIL_COND(closed && !is_completed());
+}
+
+/* JOB SYSTEM */
+
+JobSystem *JobSystem::get_singleton() {
+
+	return singleton;
+}
+
+int JobSystem::get_thread_count() const {
+
+	return worker_count;
+}
+
+void JobSystem::_worker_thread(void *p_worker) {
+
+	Worker *worker = (Worker *)p_worker;
+	JobSystem *pool = worker->pool;
+	worker->id = Thread::get_caller_id();
+
+	while (!pool->exit_threads) {
+
+		Job job;
+		if (pool->_fetch(worker->index, &job)) {
+			pool->_execute(worker->index, job);
+			continue;
+		}
+
+		atomic_increment(&pool->sleeping);
+
+		// Check again now that pushers can see us sleeping, or a wakeup could be lost.
+		if (pool->_has_work() || pool->exit_threads) {
+			atomic_decrement(&pool->sleeping);
+			continue;
+		}
+
+		pool->work_semaphore->wait();
+		atomic_decrement(&pool->sleeping);
+	}
+}
+
+int JobSystem::_get_queue_index() const {
+
+	Thread::ID caller = Thread::get_caller_id();
+	for (int i = 0; i < worker_count; i++) {
+		if (workers[i].id == caller)
+			return i;
+	}
+
+	return worker_count;
+}
+
+void JobSystem::_push(int p_queue, const Job &p_job) {
+
+	queues[p_queue].push(p_job);
+
+	if (static_cast<volatile uint32_t &>(sleeping) > 0) {
+		work_semaphore->post();
+	}
+}
+
+bool JobSystem::_fetch(int p_queue, Job *r_job) {
+
+	if (queues[p_queue].pop(r_job))
+		return true;
+
+	for (int i = 1; i < queue_count; i++) {
+
+		if (queues[(p_queue + i) % queue_count].steal(r_job))
+			return true;
+	}
+
+	return false;
+}
+
+bool JobSystem::_has_work() {
+
+	for (int i = 0; i < queue_count; i++) {
+		if (!queues[i].is_empty())
+			return true;
+	}
+
+	return false;
+}
+
+void JobSystem::_execute(int p_queue, Job p_job) {
+
+	// Keep the lower half, let the upper half be stolen.
+	while (p_job.to - p_job.from > p_job.grain) {
+
+		Job upper = p_job;
+		upper.from = p_job.from + (p_job.to - p_job.from) / 2;
+		p_job.to = upper.from;
+
+		atomic_increment(&p_job.group->pending);
+		_push(p_queue, upper);
+	}
+
+	for (uint32_t i = p_job.from; i < p_job.to; i++) {
+		p_job.func(p_job.userdata, i);
+	}
+
+	_finish(p_job.group);
+}
+
+void JobSystem::_finish(Group *p_group) {
+
+	if (atomic_decrement(&p_group->pending) == 0) {
+		_complete(p_group);
+	}
+}
+
+void JobSystem::_complete(Group *p_group) {
+
+	int queue = _get_queue_index();
+
+	if (p_group->completion_func) {
+		p_group->completion_func(p_group->completion_userdata);
+	}
+
+	group_mutex->lock();
+
+	Vector<Group *> dependents = p_group->dependents;
+	p_group->dependents.clear();
+
+	for (int i = 0; i < dependents.size(); i++) {
+
+		Group *dependent = dependents[i];
+		dependent->unresolved--;
+		if (dependent->unresolved > 0)
+			continue;
+
+		for (int j = 0; j < dependent->held.size(); j++) {
+			_push(queue, dependent->held[j]);
+		}
+		dependent->held.clear();
+	}
+
+	// Last write to the group, the waiter may destroy it right after.
+	atomic_increment(&p_group->completed);
+
+	group_mutex->unlock();
+
+	// Dependents can't complete before this point, even if they have no jobs.
+	for (int i = 0; i < dependents.size(); i++) {
+		_finish(dependents[i]);
+	}
+}
+
+void JobSystem::add_dependency(Group *p_group, Group *p_depends_on) {
+
+	ERR_FAIL_COND(p_group == p_depends_on);
+	ERR_FAIL_COND(p_group->closed || p_group->submitted);
+
+	p_group->has_dependencies = true;
+
+	group_mutex->lock();
+
+	if (!p_depends_on->is_completed()) {
+		p_group->unresolved++;
+		atomic_increment(&p_group->pending);
+		p_depends_on->dependents.push_back(p_group);
+	}
+
+	group_mutex->unlock();
+}
+
+void JobSystem::submit(Group *p_group, JobFunc p_func, void *p_userdata, uint32_t p_elements, uint32_t p_grain) {
+
+	ERR_FAIL_COND(p_group->closed);
+
+	if (p_elements == 0)
+		return;
+
+	Job job;
+	job.func = p_func;
+	job.userdata = p_userdata;
+	job.from = 0;
+	job.to = p_elements;
+	job.grain = MAX(p_grain, 1);
+	job.group = p_group;
+
+	p_group->submitted = true;
+	atomic_increment(&p_group->pending);
+
+	if (p_group->has_dependencies) {
+
+		group_mutex->lock();
+		if (p_group->unresolved > 0) {
+			p_group->held.push_back(job);
+			group_mutex->unlock();
+			return;
+		}
+		group_mutex->unlock();
+	}
+
+	_push(_get_queue_index(), job);
+}
+
+void JobSystem::set_completion_callback(Group *p_group, CompletionFunc p_func, void *p_userdata) {
+
+	ERR_FAIL_COND(p_group->closed);
+
+	p_group->completion_func = p_func;
+	p_group->completion_userdata = p_userdata;
+}
+
+void JobSystem::close(Group *p_group) {
+
+	if (p_group->closed)
+		return;
+
+	p_group->closed = true;
+	_finish(p_group);
+}
+
+void JobSystem::wait(Group *p_group) {
+
+	close(p_group);
+
+	int queue = _get_queue_index();
+
+	while (!p_group->is_completed()) {
+
+		Job job;
+		if (_fetch(queue, &job)) {
+			_execute(queue, job);
+		} else {
+			// The remaining jobs are running on other threads.
+			OS::get_singleton()->delay_usec(0);
+		}
+	}
+}
+
+void JobSystem::parallel_for(uint32_t p_elements, JobFunc p_func, void *p_userdata, uint32_t p_grain) {
+
+	Group group;
+	submit(&group, p_func, p_userdata, p_elements, p_grain);
+	wait(&group);
+}
+
+void JobSystem::init(int p_threads) {
+
+	ERR_FAIL_COND(queues);
+
+#ifdef NO_THREADS
+	worker_count = 0;
+#else
+	// The thread waiting on a group works too, so leave one core for it.
+	worker_count = p_threads >= 0 ? p_threads : MAX(OS::get_singleton()->get_processor_count() - 1, 0);
+#endif
+
+	queue_count = worker_count + 1;
+	queues = memnew_arr(JobQueue, queue_count);
+
+	if (worker_count == 0)
+		return;
+
+	workers = memnew_arr(Worker, worker_count);
+	for (int i = 0; i < worker_count; i++) {
+		workers[i].pool = this;
+		workers[i].index = i;
+		// Workers set their id when they start, until then no caller must match
+		// them (the main thread's id is 0).
+		workers[i].id = Thread::ID(-1);
+	}
+
+	for (int i = 0; i < worker_count; i++) {
+		workers[i].thread = Thread::create(_worker_thread, &workers[i]);
+	}
+}
+
+void JobSystem::finish() {
+
+	if (workers) {
+
+		exit_threads = true;
+		for (int i = 0; i < worker_count; i++) {
+			work_semaphore->post();
+		}
+		for (int i = 0; i < worker_count; i++) {
+			Thread::wait_to_finish(workers[i].thread);
+			memdelete(workers[i].thread);
+		}
+
+		memdelete_arr(workers);
+		workers = NULL;
+	}
+
+	if (queues) {
+		memdelete_arr(queues);
+		queues = NULL;
+	}
+
+	worker_count = 0;
+	queue_count = 0;
+}
+
+JobSystem::JobSystem() {
+
+	singleton = this;
+
+	workers = NULL;
+	worker_count = 0;
+	queues = NULL;
+	queue_count = 0;
+	sleeping = 0;
+	exit_threads = false;
+
+	work_semaphore = Semaphore::create();
+	group_mutex = Mutex::create(false);
+}
+
+JobSystem::~JobSystem() {
+
+	finish();
+
+	memdelete(work_semaphore);
+	memdelete(group_mutex);
+
+	singleton = NULL;
+}
@@ -0,0 +1,180 @@
+/*************************************************************************/
+/*  job_system.h                                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include "os/mutex.h"
+#include "os/semaphore.h"
+#include "os/thread.h"
+#include "safe_refcount.h"
+#include "vector.h"
+
+/**
+	Persistent pool of worker threads, started once with the core types.
+
+	Every thread has its own deque of jobs: it pops from the back of its own
+	deque and steals from the front of the others when it runs dry. Threads
+	that are not workers (main thread, render thread...) share one extra
+	deque. Callers waiting on a group help executing jobs instead of blocking,
+	so nested waits from within jobs are fine.
+
+	A job processes a range of indices. Ranges larger than their grain are
+	split in halves as they run, so idle workers can steal the other half.
+
+	Usage:
+
+		JobSystem::Group group;
+		JobSystem::get_singleton()->submit(&group, _process, this, count, 16);
+		JobSystem::get_singleton()->wait(&group);
+
+	Groups may depend on other groups. Jobs submitted to a group only start
+	once all the groups it depends on are complete. A group completes once it
+	has been closed (see close() and wait()) and all its jobs are done.
+*/
+
+class JobSystem {
+public:
+	typedef void (*JobFunc)(void *p_userdata, uint32_t p_index);
+	typedef void (*CompletionFunc)(void *p_userdata);
+
+	class Group;
+
+private:
+	struct Job {
+
+		JobFunc func;
+		void *userdata;
+		uint32_t from;
+		uint32_t to;
+		uint32_t grain;
+		Group *group;
+	};
+
+	struct JobQueue {
+
+		Mutex *mutex;
+		Job *jobs;
+		uint32_t capacity; // always a power of 2
+		uint32_t head; // thieves take from here
+		uint32_t tail; // owner pushes and pops here
+
+		void push(const Job &p_job);
+		bool pop(Job *r_job);
+		bool steal(Job *r_job);
+		bool is_empty();
+
+		JobQueue();
+		~JobQueue();
+	};
+
+	struct Worker {
+
+		JobSystem *pool;
+		Thread *thread;
+		Thread::ID id;
+		int index;
+	};
+
+	static JobSystem *singleton;
+
+	Worker *workers;
+	int worker_count;
+
+	// one per worker, plus one shared by all non-worker threads
+	JobQueue *queues;
+	int queue_count;
+
+	Semaphore *work_semaphore;
+	uint32_t sleeping;
+	volatile bool exit_threads;
+
+	Mutex *group_mutex;
+
+	static void _worker_thread(void *p_worker);
+
+	int _get_queue_index() const;
+	void _push(int p_queue, const Job &p_job);
+	bool _fetch(int p_queue, Job *r_job);
+	bool _has_work();
+	void _execute(int p_queue, Job p_job);
+	void _finish(Group *p_group);
+	void _complete(Group *p_group);
+
+public:
+	class Group {
+
+		friend class JobSystem;
+
+		uint32_t pending; // jobs in flight, plus one until closed, plus one per unresolved dependency
+		uint32_t completed;
+		bool closed;
+		bool submitted;
+		bool has_dependencies;
+		int unresolved;
+		Vector<Group *> dependents;
+		Vector<Job> held;
+		CompletionFunc completion_func;
+		void *completion_userdata;
+
+	public:
+		_FORCE_INLINE_ bool is_completed() const { return static_cast<const volatile uint32_t &>(completed) != 0; }
+
+		Group();
+		~Group();
+	};
+
+	static JobSystem *get_singleton();
+
+	int get_thread_count() const;
+
+	// Must be called before anything is submitted to p_group.
+	void add_dependency(Group *p_group, Group *p_depends_on);
+
+	void submit(Group *p_group, JobFunc p_func, void *p_userdata, uint32_t p_elements, uint32_t p_grain = 1);
+
+	// Called from the thread that finishes the last job, right before the group is marked as completed.
+	void set_completion_callback(Group *p_group, CompletionFunc p_func, void *p_userdata);
+
+	// No more jobs will be submitted, the group can complete.
+	void close(Group *p_group);
+
+	// Closes the group and runs jobs (of any group) until it is complete.
+	void wait(Group *p_group);
+
+	void parallel_for(uint32_t p_elements, JobFunc p_func, void *p_userdata, uint32_t p_grain = 1);
+
+	void init(int p_threads = -1);
+	void finish();
+
+	JobSystem();
+	~JobSystem();
+};
+
+#endif // JOB_SYSTEM_H
@@ -31,6 +31,7 @@
 #include "copymem.h"
 #include "core/safe_refcount.h"
 #include "error_macros.h"
+#include "slab_allocator.h"
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -71,15 +72,37 @@ uint64_t Memory::max_usage = 0;
 
 uint64_t Memory::alloc_count = 0;
 
+#ifdef SLAB_ALLOCATOR_ENABLED
+// The class of a block follows from the size kept in its header, which stays in the same class on realloc.
+static _FORCE_INLINE_ void *_alloc_block(size_t p_bytes) {
+
+	int size_class = SlabAllocator::get_size_class(p_bytes + PAD_ALIGN);
+	return size_class >= 0 ? SlabAllocator::alloc(size_class) : malloc(p_bytes + PAD_ALIGN);
+}
+
+static _FORCE_INLINE_ void _free_block(void *p_mem) {
+
+	int size_class = SlabAllocator::get_size_class(*(uint64_t *)p_mem + PAD_ALIGN);
+	if (size_class >= 0)
+		SlabAllocator::free(p_mem, size_class);
+	else
+		free(p_mem);
+}
+#endif
+
 void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
 
-#ifdef DEBUG_ENABLED
+#if defined(DEBUG_ENABLED) || defined(SLAB_ALLOCATOR_ENABLED)
 	bool prepad = true;
 #else
 	bool prepad = p_pad_align;
 #endif
 
+#ifdef SLAB_ALLOCATOR_ENABLED
+	void *mem = _alloc_block(p_bytes);
+#else
 	void *mem = malloc(p_bytes + (prepad ? PAD_ALIGN : 0));
+#endif
 
 	ERR_FAIL_COND_V(!mem, NULL);
 
@@ -109,7 +132,7 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 
 	uint8_t *mem = (uint8_t *)p_memory;
 
-#ifdef DEBUG_ENABLED
+#if defined(DEBUG_ENABLED) || defined(SLAB_ALLOCATOR_ENABLED)
 	bool prepad = true;
 #else
 	bool prepad = p_pad_align;
@@ -128,6 +151,35 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 		}
 #endif
 
+#ifdef SLAB_ALLOCATOR_ENABLED
+		if (p_bytes == 0) {
+			_free_block(mem);
+			return NULL;
+		}
+
+		int size_class = SlabAllocator::get_size_class(*s + PAD_ALIGN);
+		int new_size_class = SlabAllocator::get_size_class(p_bytes + PAD_ALIGN);
+
+		if (size_class >= 0 || new_size_class >= 0) {
+
+			if (size_class == new_size_class) {
+				*s = p_bytes;
+				return mem + PAD_ALIGN;
+			}
+
+			// Slab blocks can't grow, move to a block of the new size. The padding goes along,
+			// Vector keeps its refcount and size there.
+			uint8_t *new_mem = (uint8_t *)_alloc_block(p_bytes);
+			ERR_FAIL_COND_V(!new_mem, NULL);
+
+			copymem(new_mem, mem, PAD_ALIGN + MIN(*s, p_bytes));
+			_free_block(mem);
+
+			*(uint64_t *)new_mem = p_bytes;
+			return new_mem + PAD_ALIGN;
+		}
+#endif
+
 		if (p_bytes == 0) {
 			free(mem);
 			return NULL;
@@ -159,7 +211,7 @@ void Memory::free_static(void *p_ptr, bool p_pad_align) {
 
 	uint8_t *mem = (uint8_t *)p_ptr;
 
-#ifdef DEBUG_ENABLED
+#if defined(DEBUG_ENABLED) || defined(SLAB_ALLOCATOR_ENABLED)
 	bool prepad = true;
 #else
 	bool prepad = p_pad_align;
@@ -175,7 +227,11 @@ void Memory::free_static(void *p_ptr, bool p_pad_align) {
 		atomic_sub(&mem_usage, *s);
 #endif
 
+#ifdef SLAB_ALLOCATOR_ENABLED
+		_free_block(mem);
+#else
 		free(mem);
+#endif
 	} else {
 
 		free(mem);
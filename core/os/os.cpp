@@ -32,6 +32,7 @@
 #include "dir_access.h"
 #include "input.h"
 #include "os/file_access.h"
+#include "os/slab_allocator.h"
 #include "project_settings.h"
 #include "version_generated.gen.h"
 
@@ -229,6 +230,28 @@ void OS::print_all_resources(String p_to_file) {
 
 	ObjectDB::debug_objects(_OS_printres);
 
+	for (int i = 0; i < SlabAllocator::SIZE_CLASS_COUNT; i++) {
+
+		SlabAllocator::Stats stats;
+		SlabAllocator::get_stats(i, &stats);
+		if (stats.slab_count == 0)
+			continue;
+
+		String str = "Slabs of " + itos(stats.block_size) + " bytes: " + itos(stats.slab_count) + " slabs, " + itos(stats.block_count - stats.free_count) + " used blocks, " + itos(stats.free_count) + " free blocks";
+		if (_OSPRF)
+			_OSPRF->store_line(str);
+		else
+			print_line(str);
+	}
+
+	StringName::TableStats sn_stats;
+	StringName::get_table_stats(&sn_stats);
+	String sn_str = "StringNames: " + itos(sn_stats.name_count) + " names in " + itos(sn_stats.used_bucket_count) + " of " + itos(sn_stats.bucket_count) + " buckets, longest chain " + itos(sn_stats.longest_chain) + ", " + itos(sn_stats.static_name_count) + " static names";
+	if (_OSPRF)
+		_OSPRF->store_line(sn_str);
+	else
+		print_line(sn_str);
+
 	if (p_to_file != "") {
 
 		if (_OSPRF)
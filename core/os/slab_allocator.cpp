@@ -0,0 +1,250 @@
+/*************************************************************************/
+/*  slab_allocator.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "slab_allocator.h"
+
+#include "os/os.h"
+#include "safe_refcount.h"
+
+#include <stdlib.h>
+
+// Sizes include the header Memory puts before each block.
+const uint32_t SlabAllocator::block_sizes[SIZE_CLASS_COUNT] = { 16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048 };
+
+const uint8_t SlabAllocator::size_classes[MAX_BLOCK_SIZE / 16 + 1] = {
+	0, 0, 1, 2, 3, 4, 4, 5, 5, 6, 6, 6, 6, 7, 7, 7,
+	7, 8, 8, 8, 8, 8, 8, 8, 8, 9, 9, 9, 9, 9, 9, 9,
+	9, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+	10, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11,
+	11, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+	12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+	12, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13,
+	13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13,
+	13
+};
+
+// Zero initialized before any constructor runs, so allocations can happen at any time.
+SlabAllocator::Depot SlabAllocator::depots[SIZE_CLASS_COUNT];
+
+SlabAllocator::ThreadCache *SlabAllocator::_get_thread_cache() {
+
+#if defined(NO_THREADS)
+	static ThreadCache cache;
+#elif defined(_MSC_VER)
+	static __declspec(thread) ThreadCache cache;
+#else
+	static __thread ThreadCache cache;
+#endif
+
+	return &cache;
+}
+
+// Can't use Mutex, it allocates, so the depots take a lock of their own.
+static _FORCE_INLINE_ void _lock(uint32_t *p_lock) {
+
+	int spins = 0;
+	while (atomic_increment(p_lock) != 1) {
+
+		atomic_decrement(p_lock);
+		while (static_cast<volatile uint32_t &>(*p_lock)) {
+			if (++spins > 64 && OS::get_singleton()) {
+				// the owner may not be running, give it the chance
+				OS::get_singleton()->delay_usec(0);
+			}
+		}
+	}
+}
+
+static _FORCE_INLINE_ void _unlock(uint32_t *p_lock) {
+
+	atomic_decrement(p_lock);
+}
+
+uint32_t SlabAllocator::_get_batch_size(int p_class) {
+
+	uint32_t batch = SLAB_SIZE / block_sizes[p_class] / 8;
+	return CLAMP(batch, 4, 32);
+}
+
+bool SlabAllocator::_refill(ThreadCache *p_cache, int p_class) {
+
+	Depot *depot = &depots[p_class];
+	uint32_t batch = _get_batch_size(p_class);
+
+	_lock(&depot->lock);
+
+	if (depot->free_count < batch) {
+
+		_unlock(&depot->lock);
+
+		// Carve a new slab before taking the lock again.
+		uint8_t *slab = (uint8_t *)malloc(SLAB_SIZE);
+		if (!slab)
+			return false;
+
+		uint32_t block_size = block_sizes[p_class];
+		uint32_t count = SLAB_SIZE / block_size;
+		for (uint32_t i = 0; i < count - 1; i++) {
+			((FreeBlock *)&slab[i * block_size])->next = (FreeBlock *)&slab[(i + 1) * block_size];
+		}
+
+		FreeBlock *last = (FreeBlock *)&slab[(count - 1) * block_size];
+
+		_lock(&depot->lock);
+
+		last->next = depot->free_list;
+		depot->free_list = (FreeBlock *)slab;
+		depot->free_count += count;
+		depot->slab_count++;
+	}
+
+	FreeBlock *first = depot->free_list;
+	FreeBlock *last = first;
+	for (uint32_t i = 1; i < batch; i++) {
+		last = last->next;
+	}
+
+	depot->free_list = last->next;
+	depot->free_count -= batch;
+
+	_unlock(&depot->lock);
+
+	last->next = p_cache->free_list[p_class];
+	p_cache->free_list[p_class] = first;
+	p_cache->count[p_class] += batch;
+
+	return true;
+}
+
+void SlabAllocator::_flush(ThreadCache *p_cache, int p_class, uint32_t p_count) {
+
+	if (p_count == 0)
+		return;
+
+	FreeBlock *first = p_cache->free_list[p_class];
+	FreeBlock *last = first;
+	for (uint32_t i = 1; i < p_count; i++) {
+		last = last->next;
+	}
+
+	p_cache->free_list[p_class] = last->next;
+	p_cache->count[p_class] -= p_count;
+
+	Depot *depot = &depots[p_class];
+
+	_lock(&depot->lock);
+
+	last->next = depot->free_list;
+	depot->free_list = first;
+	depot->free_count += p_count;
+
+	_unlock(&depot->lock);
+}
+
+void *SlabAllocator::alloc(int p_class) {
+
+	ThreadCache *cache = _get_thread_cache();
+
+	FreeBlock *block = cache->free_list[p_class];
+	if (unlikely(!block)) {
+
+		if (!_refill(cache, p_class))
+			return NULL;
+		block = cache->free_list[p_class];
+	}
+
+	cache->free_list[p_class] = block->next;
+	cache->count[p_class]--;
+
+	return block;
+}
+
+void SlabAllocator::free(void *p_block, int p_class) {
+
+	ThreadCache *cache = _get_thread_cache();
+
+	FreeBlock *block = (FreeBlock *)p_block;
+	block->next = cache->free_list[p_class];
+	cache->free_list[p_class] = block;
+	cache->count[p_class]++;
+
+	// Blocks freed by a thread other than the allocating one pile up here, give some back.
+	uint32_t batch = _get_batch_size(p_class);
+	if (unlikely(cache->count[p_class] > batch * 2)) {
+		_flush(cache, p_class, batch);
+	}
+}
+
+void SlabAllocator::release_thread_cache() {
+
+	ThreadCache *cache = _get_thread_cache();
+
+	for (int i = 0; i < SIZE_CLASS_COUNT; i++) {
+		_flush(cache, i, cache->count[i]);
+	}
+}
+
+void SlabAllocator::get_stats(int p_class, Stats *r_stats) {
+
+	ERR_FAIL_INDEX(p_class, SIZE_CLASS_COUNT);
+
+	Depot *depot = &depots[p_class];
+
+	_lock(&depot->lock);
+
+	r_stats->block_size = block_sizes[p_class];
+	r_stats->slab_count = depot->slab_count;
+	r_stats->block_count = uint64_t(depot->slab_count) * (SLAB_SIZE / block_sizes[p_class]);
+	r_stats->free_count = depot->free_count;
+
+	_unlock(&depot->lock);
+}
+
+uint64_t SlabAllocator::get_reserved_memory() {
+
+	uint64_t reserved = 0;
+	for (int i = 0; i < SIZE_CLASS_COUNT; i++) {
+		reserved += uint64_t(static_cast<volatile uint32_t &>(depots[i].slab_count)) * SLAB_SIZE;
+	}
+
+	return reserved;
+}
+
+uint64_t SlabAllocator::get_free_memory() {
+
+	uint64_t free_memory = 0;
+	for (int i = 0; i < SIZE_CLASS_COUNT; i++) {
+
+		Stats stats;
+		get_stats(i, &stats);
+		free_memory += stats.free_count * stats.block_size;
+	}
+
+	return free_memory;
+}
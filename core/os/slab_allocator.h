@@ -0,0 +1,112 @@
+/*************************************************************************/
+/*  slab_allocator.h                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef SLAB_ALLOCATOR_H
+#define SLAB_ALLOCATOR_H
+
+#include "typedefs.h"
+
+/**
+	Small blocks of a few size classes, carved from big slabs. Each thread keeps some free
+	blocks of every class, so most allocations and frees don't synchronize at all; blocks
+	move in batches between the threads and a depot shared by all of them.
+
+	Memory uses it for small allocations when built with slab_allocator=yes. Slabs are never
+	returned to the system, the stats tell how much of them is free.
+*/
+
+class SlabAllocator {
+public:
+	enum {
+		SIZE_CLASS_COUNT = 14,
+		MAX_BLOCK_SIZE = 2048,
+		SLAB_SIZE = 64 * 1024
+	};
+
+	struct Stats {
+
+		uint32_t block_size;
+		uint32_t slab_count;
+		uint64_t block_count;
+		uint64_t free_count; // in the depot, blocks kept by threads count as used
+	};
+
+private:
+	struct FreeBlock {
+
+		FreeBlock *next;
+	};
+
+	struct Depot {
+
+		uint32_t lock;
+		FreeBlock *free_list;
+		uint64_t free_count;
+		uint32_t slab_count;
+	};
+
+	struct ThreadCache {
+
+		FreeBlock *free_list[SIZE_CLASS_COUNT];
+		uint32_t count[SIZE_CLASS_COUNT];
+	};
+
+	static const uint32_t block_sizes[SIZE_CLASS_COUNT];
+	static const uint8_t size_classes[MAX_BLOCK_SIZE / 16 + 1]; // by size in 16 byte steps
+	static Depot depots[SIZE_CLASS_COUNT];
+
+	static ThreadCache *_get_thread_cache();
+	static uint32_t _get_batch_size(int p_class);
+	static bool _refill(ThreadCache *p_cache, int p_class);
+	static void _flush(ThreadCache *p_cache, int p_class, uint32_t p_count);
+
+public:
+	// -1 if the size is bigger than the biggest class
+	_FORCE_INLINE_ static int get_size_class(size_t p_bytes) {
+
+		if (p_bytes > MAX_BLOCK_SIZE)
+			return -1;
+
+		return size_classes[(p_bytes + 15) >> 4];
+	}
+
+	_FORCE_INLINE_ static uint32_t get_block_size(int p_class) { return block_sizes[p_class]; }
+
+	static void *alloc(int p_class);
+	static void free(void *p_block, int p_class);
+
+	// Gives the blocks kept by the calling thread back to the depot, threads call it when they end.
+	static void release_thread_cache();
+
+	static void get_stats(int p_class, Stats *r_stats);
+	static uint64_t get_reserved_memory();
+	static uint64_t get_free_memory();
+};
+
+#endif // SLAB_ALLOCATOR_H
@@ -1,6 +1,7 @@
 #ifndef THREADED_ARRAY_PROCESSOR_H
 #define THREADED_ARRAY_PROCESSOR_H
 
+#include "os/job_system.h"
 #include "os/mutex.h"
 #include "os/os.h"
 #include "os/thread.h"
@@ -18,24 +19,15 @@ struct ThreadArrayProcessData {
 	void process(uint32_t p_index) {
 		(instance->*method)(p_index, userdata);
 	}
-};
-
-#ifndef NO_THREADS
-
-template <class T>
-void process_array_thread(void *ud) {
 
-	T &data = *(T *)ud;
-	while (true) {
-		uint32_t index = atomic_increment(&data.index);
-		if (index >= data.elements)
-			break;
-		data.process(index);
+	static void process_job(void *p_data, uint32_t p_index) {
+		((ThreadArrayProcessData *)p_data)->process(p_index);
 	}
-}
+};
 
+// Runs on the persistent JobSystem workers, the calling thread helps until all elements are done.
 template <class C, class M, class U>
-void thread_process_array(uint32_t p_elements, C *p_instance, M p_method, U p_userdata) {
+void thread_process_array(uint32_t p_elements, C *p_instance, M p_method, U p_userdata, uint32_t p_grain = 1) {
 
 	ThreadArrayProcessData<C, U> data;
 	data.method = p_method;
@@ -43,38 +35,16 @@ void thread_process_array(uint32_t p_elements, C *p_instance, M p_method, U p_us
 	data.userdata = p_userdata;
 	data.index = 0;
 	data.elements = p_elements;
-	data.process(data.index); //process first, let threads increment for next
-
-	Vector<Thread *> threads;
 
-	threads.resize(OS::get_singleton()->get_processor_count());
-
-	for (int i = 0; i < threads.size(); i++) {
-		threads[i] = Thread::create(process_array_thread<ThreadArrayProcessData<C, U> >, &data);
+	JobSystem *job_system = JobSystem::get_singleton();
+	if (!job_system) {
+		for (uint32_t i = 0; i < p_elements; i++) {
+			data.process(i);
+		}
+		return;
 	}
 
-	for (int i = 0; i < threads.size(); i++) {
-		Thread::wait_to_finish(threads[i]);
-		memdelete(threads[i]);
-	}
+	job_system->parallel_for(p_elements, ThreadArrayProcessData<C, U>::process_job, &data, p_grain);
 }
 
-#else
-
-template <class C, class M, class U>
-void thread_process_array(uint32_t p_elements, C *p_instance, M p_method, U p_userdata) {
-
-	ThreadArrayProcessData<C, U> data;
-	data.method = p_method;
-	data.instance = p_instance;
-	data.userdata = p_userdata;
-	data.index = 0;
-	data.elements = p_elements;
-	for (uint32_t i = 0; i < p_elements; i++) {
-		data.process(i);
-	}
-}
-
-#endif
-
 #endif // THREADED_ARRAY_PROCESSOR_H
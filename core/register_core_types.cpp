@@ -53,6 +53,7 @@
 #include "math/a_star.h"
 #include "math/triangle_mesh.h"
 #include "os/input.h"
+#include "os/job_system.h"
 #include "os/main_loop.h"
 #include "packed_data_container.h"
 #include "path_remap.h"
@@ -76,6 +77,8 @@ static IP *ip = NULL;
 
 static _Geometry *_geometry = NULL;
 
+static JobSystem *job_system = NULL;
+
 extern Mutex *_global_mutex;
 
 extern void register_global_constants();
@@ -91,6 +94,9 @@ void register_core_types() {
 
 	_global_mutex = Mutex::create();
 
+	job_system = memnew(JobSystem);
+	job_system->init();
+
 	StringName::setup();
 
 	register_global_constants();
@@ -224,6 +230,8 @@ void register_core_singletons() {
 
 void unregister_core_types() {
 
+	memdelete(job_system);
+
 	memdelete(_resource_loader);
 	memdelete(_resource_saver);
 	memdelete(_os);
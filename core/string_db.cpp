@@ -46,23 +46,62 @@ StringName _scs_create(const char *p_chr) {
 }
 
 bool StringName::configured = false;
-Mutex *StringName::lock = NULL;
+Mutex *StringName::locks[STRING_TABLE_LOCK_COUNT];
+uint32_t StringName::name_count = 0;
 
-void StringName::setup() {
+struct StringName::_StaticName {
+
+	const char *key;
+	StringName name;
+	_StaticName *next;
+};
+
+StringName::_StaticName *StringName::static_names[STATIC_NAME_CACHE_LEN];
+StringName::_StaticName *StringName::static_name_list = NULL;
+uint32_t StringName::static_name_count = 0;
+Mutex *StringName::static_name_lock = NULL;
 
-	lock = Mutex::create();
+void StringName::setup() {
 
 	ERR_FAIL_COND(configured);
+	for (int i = 0; i < STRING_TABLE_LOCK_COUNT; i++) {
+
+		locks[i] = Mutex::create();
+	}
 	for (int i = 0; i < STRING_TABLE_LEN; i++) {
 
 		_table[i] = NULL;
 	}
+	for (int i = 0; i < STATIC_NAME_CACHE_LEN; i++) {
+
+		static_names[i] = NULL;
+	}
+	static_name_lock = Mutex::create();
 	configured = true;
 }
 
 void StringName::cleanup() {
 
-	lock->lock();
+	// static names hold a reference, release them before looking for orphans
+	static_name_lock->lock();
+	for (int i = 0; i < STATIC_NAME_CACHE_LEN; i++) {
+
+		static_names[i] = NULL;
+	}
+	while (static_name_list) {
+
+		_StaticName *sn = static_name_list;
+		static_name_list = sn->next;
+		memdelete(sn);
+	}
+	static_name_count = 0;
+	static_name_lock->unlock();
+	memdelete(static_name_lock);
+
+	for (int i = 0; i < STRING_TABLE_LOCK_COUNT; i++) {
+
+		locks[i]->lock();
+	}
 
 	int lost_strings = 0;
 	for (int i = 0; i < STRING_TABLE_LEN; i++) {
@@ -87,9 +126,13 @@ void StringName::cleanup() {
 	if (OS::get_singleton()->is_stdout_verbose() && lost_strings) {
 		print_line("StringName: " + itos(lost_strings) + " unclaimed string names at exit.");
 	}
-	lock->unlock();
+	name_count = 0;
 
-	memdelete(lock);
+	for (int i = 0; i < STRING_TABLE_LOCK_COUNT; i++) {
+
+		locks[i]->unlock();
+		memdelete(locks[i]);
+	}
 }
 
 void StringName::unref() {
@@ -98,6 +141,7 @@ void StringName::unref() {
 
 	if (_data && _data->refcount.unref()) {
 
+		Mutex *lock = _get_lock(_data->idx);
 		lock->lock();
 
 		if (_data->prev) {
@@ -113,6 +157,7 @@ void StringName::unref() {
 			_data->next->prev = _data->prev;
 		}
 		memdelete(_data);
+		atomic_decrement(&name_count);
 		lock->unlock();
 	}
 
@@ -191,12 +236,13 @@ StringName::StringName(const char *p_name) {
 	if (!p_name || p_name[0] == 0)
 		return; //empty, ignore
 
-	lock->lock();
-
 	uint32_t hash = String::hash(p_name);
 
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
+	Mutex *lock = _get_lock(idx);
+	lock->lock();
+
 	_data = _table[idx];
 
 	while (_data) {
@@ -227,6 +273,7 @@ StringName::StringName(const char *p_name) {
 	if (_table[idx])
 		_table[idx]->prev = _data;
 	_table[idx] = _data;
+	atomic_increment(&name_count);
 
 	lock->unlock();
 }
@@ -239,12 +286,13 @@ StringName::StringName(const StaticCString &p_static_string) {
 
 	ERR_FAIL_COND(!p_static_string.ptr || !p_static_string.ptr[0]);
 
-	lock->lock();
-
 	uint32_t hash = String::hash(p_static_string.ptr);
 
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
+	Mutex *lock = _get_lock(idx);
+	lock->lock();
+
 	_data = _table[idx];
 
 	while (_data) {
@@ -275,6 +323,7 @@ StringName::StringName(const StaticCString &p_static_string) {
 	if (_table[idx])
 		_table[idx]->prev = _data;
 	_table[idx] = _data;
+	atomic_increment(&name_count);
 
 	lock->unlock();
 }
@@ -288,12 +337,13 @@ StringName::StringName(const String &p_name) {
 	if (p_name == String())
 		return;
 
-	lock->lock();
-
 	uint32_t hash = p_name.hash();
 
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
+	Mutex *lock = _get_lock(idx);
+	lock->lock();
+
 	_data = _table[idx];
 
 	while (_data) {
@@ -323,6 +373,7 @@ StringName::StringName(const String &p_name) {
 	if (_table[idx])
 		_table[idx]->prev = _data;
 	_table[idx] = _data;
+	atomic_increment(&name_count);
 
 	lock->unlock();
 }
@@ -335,12 +386,13 @@ StringName StringName::search(const char *p_name) {
 	if (!p_name[0])
 		return StringName();
 
-	lock->lock();
-
 	uint32_t hash = String::hash(p_name);
 
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
+	Mutex *lock = _get_lock(idx);
+	lock->lock();
+
 	_Data *_data = _table[idx];
 
 	while (_data) {
@@ -369,12 +421,13 @@ StringName StringName::search(const CharType *p_name) {
 	if (!p_name[0])
 		return StringName();
 
-	lock->lock();
-
 	uint32_t hash = String::hash(p_name);
 
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
+	Mutex *lock = _get_lock(idx);
+	lock->lock();
+
 	_Data *_data = _table[idx];
 
 	while (_data) {
@@ -397,12 +450,13 @@ StringName StringName::search(const String &p_name) {
 
 	ERR_FAIL_COND_V(p_name == "", StringName());
 
-	lock->lock();
-
 	uint32_t hash = p_name.hash();
 
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
+	Mutex *lock = _get_lock(idx);
+	lock->lock();
+
 	_Data *_data = _table[idx];
 
 	while (_data) {
@@ -422,6 +476,99 @@ StringName StringName::search(const String &p_name) {
 	return StringName(); //does not exist
 }
 
+const StringName &StringName::get_static(const char *p_name) {
+
+	// Keyed by the address of the literal, the text is only hashed the first time.
+	uint32_t hash = hash_one_uint64((uint64_t)(uintptr_t)p_name);
+
+	for (int i = 0; i < STATIC_NAME_CACHE_LEN; i++) {
+
+		// Entries are complete before they are published and never change afterwards.
+		_StaticName *sn = static_cast<_StaticName *volatile &>(static_names[(hash + i) & STATIC_NAME_CACHE_MASK]);
+		if (!sn)
+			break;
+		if (sn->key == p_name)
+			return sn->name;
+	}
+
+	return _add_static(p_name, hash);
+}
+
+const StringName &StringName::_add_static(const char *p_name, uint32_t p_hash) {
+
+	CRASH_COND(!configured);
+
+	static_name_lock->lock();
+
+	// Another thread may have added it, or the cache is full and it is only in the list.
+	for (_StaticName *sn = static_name_list; sn; sn = sn->next) {
+
+		if (sn->key == p_name) {
+			static_name_lock->unlock();
+			return sn->name;
+		}
+	}
+
+	_StaticName *sn = memnew(_StaticName);
+	sn->key = p_name;
+	sn->name = _scs_create(p_name);
+	sn->next = static_name_list;
+	static_name_list = sn;
+
+	// The atomic increment is a full barrier, the entry is complete before it is published.
+	if (atomic_increment(&static_name_count) <= STATIC_NAME_CACHE_LEN / 2) {
+
+		for (int i = 0; i < STATIC_NAME_CACHE_LEN; i++) {
+
+			int idx = (p_hash + i) & STATIC_NAME_CACHE_MASK;
+			if (!static_names[idx]) {
+				static_cast<_StaticName *volatile &>(static_names[idx]) = sn;
+				break;
+			}
+		}
+	}
+
+	static_name_lock->unlock();
+
+	return sn->name;
+}
+
+int StringName::get_name_count() {
+
+	return static_cast<volatile uint32_t &>(name_count);
+}
+
+void StringName::get_table_stats(TableStats *r_stats) {
+
+	ERR_FAIL_COND(!configured);
+
+	r_stats->name_count = 0;
+	r_stats->bucket_count = STRING_TABLE_LEN;
+	r_stats->used_bucket_count = 0;
+	r_stats->longest_chain = 0;
+
+	for (int i = 0; i < STRING_TABLE_LEN; i++) {
+
+		Mutex *lock = _get_lock(i);
+		lock->lock();
+
+		int chain = 0;
+		for (_Data *d = _table[i]; d; d = d->next) {
+			chain++;
+		}
+
+		lock->unlock();
+
+		r_stats->name_count += chain;
+		if (chain) {
+			r_stats->used_bucket_count++;
+		}
+		r_stats->longest_chain = MAX(r_stats->longest_chain, chain);
+	}
+
+	r_stats->static_name_count = static_cast<volatile uint32_t &>(static_name_count);
+}
+
 StringName::StringName() {
 
 	_data = NULL;
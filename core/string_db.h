@@ -50,7 +50,13 @@ class StringName {
 
 		STRING_TABLE_BITS = 12,
 		STRING_TABLE_LEN = 1 << STRING_TABLE_BITS,
-		STRING_TABLE_MASK = STRING_TABLE_LEN - 1
+		STRING_TABLE_MASK = STRING_TABLE_LEN - 1,
+		// each lock guards the buckets sharing its low bits, so lookups of different names rarely contend
+		STRING_TABLE_LOCK_BITS = 6,
+		STRING_TABLE_LOCK_COUNT = 1 << STRING_TABLE_LOCK_BITS,
+		STRING_TABLE_LOCK_MASK = STRING_TABLE_LOCK_COUNT - 1,
+		STATIC_NAME_CACHE_LEN = 1024,
+		STATIC_NAME_CACHE_MASK = STATIC_NAME_CACHE_LEN - 1
 	};
 
 	struct _Data {
@@ -84,7 +90,18 @@ class StringName {
 	friend void register_core_types();
 	friend void unregister_core_types();
 
-	static Mutex *lock;
+	static Mutex *locks[STRING_TABLE_LOCK_COUNT];
+	static uint32_t name_count;
+
+	_FORCE_INLINE_ static Mutex *_get_lock(uint32_t p_idx) { return locks[p_idx & STRING_TABLE_LOCK_MASK]; }
+
+	struct _StaticName;
+	static _StaticName *static_names[STATIC_NAME_CACHE_LEN];
+	static _StaticName *static_name_list;
+	static uint32_t static_name_count;
+	static Mutex *static_name_lock;
+	static const StringName &_add_static(const char *p_name, uint32_t p_hash);
+
 	static void setup();
 	static void cleanup();
 	static bool configured;
@@ -134,6 +151,21 @@ public:
 	static StringName search(const CharType *p_name);
 	static StringName search(const String &p_name);
 
+	// Use through SNAME(), p_name must be a string literal.
+	static const StringName &get_static(const char *p_name);
+
+	struct TableStats {
+
+		int name_count;
+		int bucket_count;
+		int used_bucket_count;
+		int longest_chain;
+		int static_name_count;
+	};
+
+	static int get_name_count();
+	static void get_table_stats(TableStats *r_stats);
+
 	struct AlphCompare {
 
 		_FORCE_INLINE_ bool operator()(const StringName &l, const StringName &r) const {
@@ -173,4 +205,7 @@ struct StringNameHasher {
 
 StringName _scs_create(const char *p_chr);
 
+// Cached StringName for a string literal, the table is only searched the first time each literal is used.
+#define SNAME(m_arg) StringName::get_static("" m_arg)
+
 #endif
@@ -360,6 +360,22 @@ public:
 
 	static String get_call_error_text(Object *p_base, const StringName &p_method, const Variant **p_argptrs, int p_argcount, const Variant::CallError &ce);
 
+	// Built-in method resolved once, callers can keep it and skip the lookup by name.
+	struct BuiltInMethod {
+
+		typedef void (*Function)(Variant &r_ret, Variant &p_self, const Variant **p_args);
+
+		Type type;
+		Function function; // takes exactly arg_count arguments, already validated
+		int arg_count;
+
+		// Checks the argument count and types, r_args receives the arguments completed with the defaults.
+		bool validate_arguments(const Variant **p_args, int p_argcount, const Variant **r_args, CallError &r_error) const;
+		void call(Variant &p_self, const Variant **p_args, int p_argcount, Variant *r_ret, CallError &r_error) const;
+	};
+
+	static const BuiltInMethod *get_builtin_method(Variant::Type p_type, const StringName &p_method);
+
 	static Variant construct(const Variant::Type, const Variant **p_args, int p_argcount, CallError &r_error, bool p_strict = true);
 
 	void get_method_list(List<MethodInfo> *p_list) const;
@@ -45,9 +45,8 @@ struct _VariantCall {
 		r_ret = reinterpret_cast<Vector3 *>(p_self._data._mem)->dot(*reinterpret_cast<const Vector3 *>(p_args[0]->_data._mem));
 	}
 
-	struct FuncData {
+	struct FuncData : public Variant::BuiltInMethod {
 
-		int arg_count;
 		Vector<Variant> default_args;
 		Vector<Variant::Type> arg_types;
 		Vector<StringName> arg_names;
@@ -56,14 +55,12 @@ struct _VariantCall {
 		bool _const;
 		bool returns;
 
-		VariantFunc func;
-
-		_FORCE_INLINE_ bool verify_arguments(const Variant **p_args, Variant::CallError &r_error) {
+		_FORCE_INLINE_ bool verify_arguments(const Variant **p_args, Variant::CallError &r_error) const {
 
 			if (arg_count == 0)
 				return true;
 
-			Variant::Type *tptr = &arg_types[0];
+			const Variant::Type *tptr = &arg_types[0];
 
 			for (int i = 0; i < arg_count; i++) {
 
@@ -79,7 +76,7 @@ struct _VariantCall {
 			return true;
 		}
 
-		_FORCE_INLINE_ void call(Variant &r_ret, Variant &p_self, const Variant **p_args, int p_argcount, Variant::CallError &r_error) {
+		_FORCE_INLINE_ void call(Variant &r_ret, Variant &p_self, const Variant **p_args, int p_argcount, Variant::CallError &r_error) const {
 #ifdef DEBUG_ENABLED
 			if (p_argcount > arg_count) {
 				r_error.error = Variant::CallError::CALL_ERROR_TOO_MANY_ARGUMENTS;
@@ -109,20 +106,21 @@ struct _VariantCall {
 				if (!verify_arguments(newargs, r_error))
 					return;
 #endif
-				func(r_ret, p_self, newargs);
+				function(r_ret, p_self, newargs);
 			} else {
 #ifdef DEBUG_ENABLED
 				if (!verify_arguments(p_args, r_error))
 					return;
 #endif
-				func(r_ret, p_self, p_args);
+				function(r_ret, p_self, p_args);
 			}
 		}
 	};
 
 	struct TypeFunc {
 
-		Map<StringName, FuncData> functions;
+		Map<StringName, FuncData> functions; // sorted, for listing
+		HashMap<StringName, FuncData *, StringNameHasher> function_index; // points into functions, for calls
 	};
 
 	static TypeFunc *type_funcs;
@@ -149,7 +147,8 @@ struct _VariantCall {
 	static void addfunc(bool p_const, Variant::Type p_type, Variant::Type p_return, bool p_has_return, const StringName &p_name, VariantFunc p_func, const Vector<Variant> &p_defaultarg, const Arg &p_argtype1 = Arg(), const Arg &p_argtype2 = Arg(), const Arg &p_argtype3 = Arg(), const Arg &p_argtype4 = Arg(), const Arg &p_argtype5 = Arg()) {
 
 		FuncData funcdata;
-		funcdata.func = p_func;
+		funcdata.type = p_type;
+		funcdata.function = p_func;
 		funcdata.default_args = p_defaultarg;
 		funcdata._const = p_const;
 #ifdef DEBUG_ENABLED
@@ -203,7 +202,8 @@ struct _VariantCall {
 	end:
 
 		funcdata.arg_count = funcdata.arg_types.size();
-		type_funcs[p_type].functions[p_name] = funcdata;
+		Map<StringName, FuncData>::Element *E = type_funcs[p_type].functions.insert(p_name, funcdata);
+		type_funcs[p_type].function_index.set(p_name, &E->get());
 	}
 
 #define VCALL_LOCALMEM0(m_type, m_method) \
@@ -795,9 +795,21 @@ struct _VariantCall {
 		VariantConstructFunc func;
 	};
 
+	enum {
+		MAX_CONSTRUCT_ARGS = 4
+	};
+
 	struct ConstructFunc {
 
 		List<ConstructData> constructors;
+		// Construction only ever tries the first constructor taking as many arguments as given.
+		const ConstructData *by_arg_count[MAX_CONSTRUCT_ARGS + 1];
+
+		ConstructFunc() {
+			for (int i = 0; i <= MAX_CONSTRUCT_ARGS; i++) {
+				by_arg_count[i] = NULL;
+			}
+		}
 	};
 
 	static ConstructFunc *construct_funcs;
@@ -956,7 +968,11 @@ struct _VariantCall {
 
 	end:
 
-		construct_funcs[p_type].constructors.push_back(cd);
+		ConstructFunc &c = construct_funcs[p_type];
+		List<ConstructData>::Element *E = c.constructors.push_back(cd);
+		if (!c.by_arg_count[cd.arg_count]) {
+			c.by_arg_count[cd.arg_count] = &E->get();
+		}
 	}
 
 	struct ConstantData {
@@ -1017,15 +1033,14 @@ void Variant::call_ptr(const StringName &p_method, const Variant **p_args, int p
 
 		r_error.error = Variant::CallError::CALL_OK;
 
-		Map<StringName, _VariantCall::FuncData>::Element *E = _VariantCall::type_funcs[type].functions.find(p_method);
+		_VariantCall::FuncData **funcdata = _VariantCall::type_funcs[type].function_index.getptr(p_method);
 #ifdef DEBUG_ENABLED
-		if (!E) {
+		if (!funcdata) {
 			r_error.error = Variant::CallError::CALL_ERROR_INVALID_METHOD;
 			return;
 		}
 #endif
-		_VariantCall::FuncData &funcdata = E->get();
-		funcdata.call(ret, *this, p_args, p_argcount, r_error);
+		(*funcdata)->call(ret, *this, p_args, p_argcount, r_error);
 	}
 
 	if (r_error.error == Variant::CallError::CALL_OK && r_ret)
@@ -1089,26 +1104,22 @@ Variant Variant::construct(const Variant::Type p_type, const Variant **p_args, i
 
 	} else if (p_argcount > 1) {
 
-		_VariantCall::ConstructFunc &c = _VariantCall::construct_funcs[p_type];
-
-		for (List<_VariantCall::ConstructData>::Element *E = c.constructors.front(); E; E = E->next()) {
-			const _VariantCall::ConstructData &cd = E->get();
+		const _VariantCall::ConstructData *cd = p_argcount <= _VariantCall::MAX_CONSTRUCT_ARGS ? _VariantCall::construct_funcs[p_type].by_arg_count[p_argcount] : NULL;
 
-			if (cd.arg_count != p_argcount)
-				continue;
+		if (cd) {
 
 			//validate parameters
-			for (int i = 0; i < cd.arg_count; i++) {
-				if (!Variant::can_convert(p_args[i]->type, cd.arg_types[i])) {
+			for (int i = 0; i < cd->arg_count; i++) {
+				if (!Variant::can_convert(p_args[i]->type, cd->arg_types[i])) {
 					r_error.error = Variant::CallError::CALL_ERROR_INVALID_ARGUMENT; //no such constructor
 					r_error.argument = i;
-					r_error.expected = cd.arg_types[i];
+					r_error.expected = cd->arg_types[i];
 					return Variant();
 				}
 			}
 
 			Variant v;
-			cd.func(v, p_args);
+			cd->func(v, p_args);
 			return v;
 		}
 
@@ -1191,65 +1202,116 @@ bool Variant::has_method(const StringName &p_method) const {
 	}
 
 	const _VariantCall::TypeFunc &fd = _VariantCall::type_funcs[type];
-	return fd.functions.has(p_method);
+	return fd.function_index.has(p_method);
+}
+
+bool Variant::BuiltInMethod::validate_arguments(const Variant **p_args, int p_argcount, const Variant **r_args, CallError &r_error) const {
+
+	const _VariantCall::FuncData *funcdata = static_cast<const _VariantCall::FuncData *>(this);
+
+	if (p_argcount > arg_count) {
+		r_error.error = Variant::CallError::CALL_ERROR_TOO_MANY_ARGUMENTS;
+		r_error.argument = arg_count;
+		return false;
+	}
+
+	int def_argcount = funcdata->default_args.size();
+	if (p_argcount < arg_count - def_argcount) {
+		r_error.error = Variant::CallError::CALL_ERROR_TOO_FEW_ARGUMENTS;
+		r_error.argument = arg_count - def_argcount;
+		return false;
+	}
+
+	for (int i = 0; i < p_argcount; i++)
+		r_args[i] = p_args[i];
+	int first_default_arg = arg_count - def_argcount;
+	for (int i = p_argcount; i < arg_count; i++)
+		r_args[i] = &funcdata->default_args[i - first_default_arg];
+
+	r_error.error = Variant::CallError::CALL_OK;
+	return funcdata->verify_arguments(r_args, r_error);
+}
+
+void Variant::BuiltInMethod::call(Variant &p_self, const Variant **p_args, int p_argcount, Variant *r_ret, CallError &r_error) const {
+
+	if (p_self.type != type) {
+		r_error.error = Variant::CallError::CALL_ERROR_INVALID_METHOD;
+		return;
+	}
+
+	r_error.error = Variant::CallError::CALL_OK;
+
+	Variant ret;
+	static_cast<const _VariantCall::FuncData *>(this)->call(ret, p_self, p_args, p_argcount, r_error);
+
+	if (r_error.error == Variant::CallError::CALL_OK && r_ret)
+		*r_ret = ret;
+}
+
+const Variant::BuiltInMethod *Variant::get_builtin_method(Variant::Type p_type, const StringName &p_method) {
+
+	ERR_FAIL_INDEX_V(p_type, VARIANT_MAX, NULL);
+
+	_VariantCall::FuncData *const *funcdata = _VariantCall::type_funcs[p_type].function_index.getptr(p_method);
+	return funcdata ? *funcdata : NULL;
 }
 
 Vector<Variant::Type> Variant::get_method_argument_types(Variant::Type p_type, const StringName &p_method) {
 
 	const _VariantCall::TypeFunc &fd = _VariantCall::type_funcs[p_type];
 
-	const Map<StringName, _VariantCall::FuncData>::Element *E = fd.functions.find(p_method);
+	_VariantCall::FuncData *const *E = fd.function_index.getptr(p_method);
 	if (!E)
 		return Vector<Variant::Type>();
 
-	return E->get().arg_types;
+	return (*E)->arg_types;
 }
 
 bool Variant::is_method_const(Variant::Type p_type, const StringName &p_method) {
 
 	const _VariantCall::TypeFunc &fd = _VariantCall::type_funcs[p_type];
 
-	const Map<StringName, _VariantCall::FuncData>::Element *E = fd.functions.find(p_method);
+	_VariantCall::FuncData *const *E = fd.function_index.getptr(p_method);
 	if (!E)
 		return false;
 
-	return E->get()._const;
+	return (*E)->_const;
 }
 
 Vector<StringName> Variant::get_method_argument_names(Variant::Type p_type, const StringName &p_method) {
 
 	const _VariantCall::TypeFunc &fd = _VariantCall::type_funcs[p_type];
 
-	const Map<StringName, _VariantCall::FuncData>::Element *E = fd.functions.find(p_method);
+	_VariantCall::FuncData *const *E = fd.function_index.getptr(p_method);
 	if (!E)
 		return Vector<StringName>();
 
-	return E->get().arg_names;
+	return (*E)->arg_names;
 }
 
 Variant::Type Variant::get_method_return_type(Variant::Type p_type, const StringName &p_method, bool *r_has_return) {
 
 	const _VariantCall::TypeFunc &fd = _VariantCall::type_funcs[p_type];
 
-	const Map<StringName, _VariantCall::FuncData>::Element *E = fd.functions.find(p_method);
+	_VariantCall::FuncData *const *E = fd.function_index.getptr(p_method);
 	if (!E)
 		return Variant::NIL;
 
 	if (r_has_return)
-		*r_has_return = E->get().returns;
+		*r_has_return = (*E)->returns;
 
-	return E->get().return_type;
+	return (*E)->return_type;
 }
 
 Vector<Variant> Variant::get_method_default_arguments(Variant::Type p_type, const StringName &p_method) {
 
 	const _VariantCall::TypeFunc &fd = _VariantCall::type_funcs[p_type];
 
-	const Map<StringName, _VariantCall::FuncData>::Element *E = fd.functions.find(p_method);
+	_VariantCall::FuncData *const *E = fd.function_index.getptr(p_method);
 	if (!E)
 		return Vector<Variant>();
 
-	return E->get().default_args;
+	return (*E)->default_args;
 }
 
 void Variant::get_method_list(List<MethodInfo> *p_list) const {
@@ -36,7 +36,18 @@
 
 CharType VariantParser::StreamFile::get_char() {
 
-	return f->get_8();
+	if (unlikely(readahead_pointer == readahead_filled || f != readahead_file)) {
+
+		// a new file was set, drop what was read from the old one
+		readahead_file = f;
+		readahead_pointer = 0;
+		readahead_filled = f->get_buffer(readahead_buffer, READAHEAD_SIZE);
+		eof = readahead_filled == 0;
+		if (eof)
+			return 0;
+	}
+
+	return readahead_buffer[readahead_pointer++];
 }
 
 bool VariantParser::StreamFile::is_utf8() const {
@@ -45,7 +56,24 @@ bool VariantParser::StreamFile::is_utf8() const {
 }
 bool VariantParser::StreamFile::is_eof() const {
 
-	return f->eof_reached();
+	return f == readahead_file ? eof : f->eof_reached();
+}
+
+uint64_t VariantParser::StreamFile::get_position() const {
+
+	if (f != readahead_file)
+		return f->get_position();
+
+	return f->get_position() - (readahead_filled - readahead_pointer);
+}
+
+VariantParser::StreamFile::StreamFile() {
+
+	f = NULL;
+	readahead_file = NULL;
+	readahead_pointer = 0;
+	readahead_filled = 0;
+	eof = false;
 }
 
 CharType VariantParser::StreamString::get_char() {
@@ -84,6 +112,80 @@ const char *VariantParser::tk_name[TK_MAX] = {
 	"ERROR"
 };
 
+// Reads a number starting with p_first, leaving the character after it in saved. Returns whether it's a float.
+static bool _read_number(VariantParser::Stream *p_stream, CharType p_first, StringBuffer &r_num) {
+
+#define READING_SIGN 0
+#define READING_INT 1
+#define READING_DEC 2
+#define READING_EXP 3
+#define READING_DONE 4
+	int reading = READING_INT;
+
+	CharType c = p_first;
+	if (c == '-') {
+		r_num += '-';
+		c = p_stream->get_char();
+	}
+
+	bool exp_sign = false;
+	bool exp_beg = false;
+	bool is_float = false;
+
+	while (true) {
+
+		switch (reading) {
+			case READING_INT: {
+
+				if (c >= '0' && c <= '9') {
+					//pass
+				} else if (c == '.') {
+					reading = READING_DEC;
+					is_float = true;
+				} else if (c == 'e') {
+					reading = READING_EXP;
+					is_float = true;
+				} else {
+					reading = READING_DONE;
+				}
+
+			} break;
+			case READING_DEC: {
+
+				if (c >= '0' && c <= '9') {
+
+				} else if (c == 'e') {
+					reading = READING_EXP;
+				} else {
+					reading = READING_DONE;
+				}
+
+			} break;
+			case READING_EXP: {
+
+				if (c >= '0' && c <= '9') {
+					exp_beg = true;
+
+				} else if ((c == '-' || c == '+') && !exp_sign && !exp_beg) {
+					exp_sign = true;
+
+				} else {
+					reading = READING_DONE;
+				}
+			} break;
+		}
+
+		if (reading == READING_DONE)
+			break;
+		r_num += c;
+		c = p_stream->get_char();
+	}
+
+	p_stream->saved = c;
+
+	return is_float;
+}
+
 Error VariantParser::get_token(Stream *p_stream, Token &r_token, int &line, String &r_err_str) {
 
 	while (true) {
@@ -299,73 +401,7 @@ Error VariantParser::get_token(Stream *p_stream, Token &r_token, int &line, Stri
 					//a number
 
 					StringBuffer num;
-#define READING_SIGN 0
-#define READING_INT 1
-#define READING_DEC 2
-#define READING_EXP 3
-#define READING_DONE 4
-					int reading = READING_INT;
-
-					if (cchar == '-') {
-						num += '-';
-						cchar = p_stream->get_char();
-					}
-
-					CharType c = cchar;
-					bool exp_sign = false;
-					bool exp_beg = false;
-					bool is_float = false;
-
-					while (true) {
-
-						switch (reading) {
-							case READING_INT: {
-
-								if (c >= '0' && c <= '9') {
-									//pass
-								} else if (c == '.') {
-									reading = READING_DEC;
-									is_float = true;
-								} else if (c == 'e') {
-									reading = READING_EXP;
-									is_float = true;
-								} else {
-									reading = READING_DONE;
-								}
-
-							} break;
-							case READING_DEC: {
-
-								if (c >= '0' && c <= '9') {
-
-								} else if (c == 'e') {
-									reading = READING_EXP;
-								} else {
-									reading = READING_DONE;
-								}
-
-							} break;
-							case READING_EXP: {
-
-								if (c >= '0' && c <= '9') {
-									exp_beg = true;
-
-								} else if ((c == '-' || c == '+') && !exp_sign && !exp_beg) {
-									exp_sign = true;
-
-								} else {
-									reading = READING_DONE;
-								}
-							} break;
-						}
-
-						if (reading == READING_DONE)
-							break;
-						num += c;
-						c = p_stream->get_char();
-					}
-
-					p_stream->saved = c;
+					bool is_float = _read_number(p_stream, cchar, num);
 
 					r_token.type = TK_NUMBER;
 
@@ -439,6 +475,42 @@ Error VariantParser::_parse_enginecfg(Stream *p_stream, Vector<String> &strings,
 	return OK;
 }
 
+// Numbers in constructors are most of what big meshes and tile maps hold, so they
+// are read here directly instead of as tokens. False if the next thing isn't one.
+bool VariantParser::_parse_number(Stream *p_stream, int &line, double &r_value) {
+
+	CharType c;
+	while (true) {
+
+		if (p_stream->saved) {
+			c = p_stream->saved;
+			p_stream->saved = 0;
+		} else {
+			c = p_stream->get_char();
+		}
+
+		if (c == '\n') {
+			line++;
+		} else if (c > 32 || c == 0) {
+			break;
+		}
+	}
+
+	if (c != '-' && (c < '0' || c > '9')) {
+		p_stream->saved = c;
+		return false;
+	}
+
+	StringBuffer num;
+	if (_read_number(p_stream, c, num)) {
+		r_value = num.as_double();
+	} else {
+		r_value = num.as_int();
+	}
+
+	return true;
+}
+
 template <class T>
 Error VariantParser::_parse_construct(Stream *p_stream, Vector<T> &r_construct, int &line, String &r_err_str) {
 
@@ -463,6 +535,15 @@ Error VariantParser::_parse_construct(Stream *p_stream, Vector<T> &r_construct,
 				return ERR_PARSE_ERROR;
 			}
 		}
+
+		double number;
+		if (_parse_number(p_stream, line, number)) {
+			r_construct.push_back(number);
+			first = false;
+			continue;
+		}
+
+		// anything else, such as comments
 		get_token(p_stream, token, line, r_err_str);
 
 		if (first && token.type == TK_PARENTHESIS_CLOSE) {
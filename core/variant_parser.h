@@ -48,15 +48,30 @@ public:
 		virtual ~Stream() {}
 	};
 
+	// Reads the file in blocks instead of a character at a time, so the file's own
+	// position is ahead of the parser's; use get_position() instead.
 	struct StreamFile : public Stream {
 
+		enum {
+			READAHEAD_SIZE = 4096
+		};
+
 		FileAccess *f;
 
 		virtual CharType get_char();
 		virtual bool is_utf8() const;
 		virtual bool is_eof() const;
 
-		StreamFile() { f = NULL; }
+		uint64_t get_position() const;
+
+		StreamFile();
+
+	private:
+		FileAccess *readahead_file;
+		uint8_t readahead_buffer[READAHEAD_SIZE];
+		uint32_t readahead_pointer;
+		uint32_t readahead_filled;
+		bool eof;
 	};
 
 	struct StreamString : public Stream {
@@ -124,6 +139,7 @@ public:
 private:
 	static const char *tk_name[TK_MAX];
 
+	static bool _parse_number(Stream *p_stream, int &line, double &r_value);
 	template <class T>
 	static Error _parse_construct(Stream *p_stream, Vector<T> &r_construct, int &line, String &r_err_str);
 	static Error _parse_enginecfg(Stream *p_stream, Vector<String> &strings, int &line, String &r_err_str);
@@ -0,0 +1,1824 @@
+/*************************************************************************/
+/*  rasterizer_dummy.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "rasterizer_dummy.h"
+
+/* ENVIRONMENT API */
+
+RID RasterizerSceneDummy::environment_create() {
+
+	Environment *env = memnew(Environment);
+	return environment_owner.make_rid(env);
+}
+
+void RasterizerSceneDummy::environment_set_background(RID p_env, VS::EnvironmentBG p_bg) {
+
+	Environment *env = environment_owner.getornull(p_env);
+	ERR_FAIL_COND(!env);
+	env->bg_mode = p_bg;
+}
+
+void RasterizerSceneDummy::environment_set_canvas_max_layer(RID p_env, int p_max_layer) {
+
+	Environment *env = environment_owner.getornull(p_env);
+	ERR_FAIL_COND(!env);
+	env->canvas_max_layer = p_max_layer;
+}
+
+bool RasterizerSceneDummy::is_environment(RID p_env) {
+
+	return environment_owner.owns(p_env);
+}
+
+VS::EnvironmentBG RasterizerSceneDummy::environment_get_background(RID p_env) {
+
+	const Environment *env = environment_owner.getornull(p_env);
+	ERR_FAIL_COND_V(!env, VS::ENV_BG_MAX);
+	return env->bg_mode;
+}
+
+int RasterizerSceneDummy::environment_get_canvas_max_layer(RID p_env) {
+
+	const Environment *env = environment_owner.getornull(p_env);
+	ERR_FAIL_COND_V(!env, -1);
+	return env->canvas_max_layer;
+}
+
+bool RasterizerSceneDummy::free(RID p_rid) {
+
+	if (environment_owner.owns(p_rid)) {
+
+		Environment *env = environment_owner.get(p_rid);
+		environment_owner.free(p_rid);
+		memdelete(env);
+	} else {
+		return false;
+	}
+
+	return true;
+}
+
+/* TEXTURE API */
+
+RID RasterizerStorageDummy::texture_create() {
+
+	Texture *texture = memnew(Texture);
+	return texture_owner.make_rid(texture);
+}
+
+void RasterizerStorageDummy::texture_allocate(RID p_texture, int p_width, int p_height, Image::Format p_format, uint32_t p_flags) {
+
+	Texture *texture = texture_owner.getornull(p_texture);
+	ERR_FAIL_COND(!texture);
+	texture->width = p_width;
+	texture->height = p_height;
+	texture->format = p_format;
+	texture->flags = p_flags;
+}
+
+void RasterizerStorageDummy::texture_set_data(RID p_texture, const Ref<Image> &p_image, VS::CubeMapSide p_cube_side) {
+
+	Texture *texture = texture_owner.getornull(p_texture);
+	ERR_FAIL_COND(!texture);
+	ERR_FAIL_COND(p_image.is_null());
+
+	// Nothing to upload to, only remember what was given.
+	texture->width = p_image->get_width();
+	texture->height = p_image->get_height();
+	texture->format = p_image->get_format();
+}
+
+Ref<Image> RasterizerStorageDummy::texture_get_data(RID p_texture, VS::CubeMapSide p_cube_side) const {
+
+	return Ref<Image>();
+}
+
+void RasterizerStorageDummy::texture_set_flags(RID p_texture, uint32_t p_flags) {
+
+	Texture *texture = texture_owner.getornull(p_texture);
+	ERR_FAIL_COND(!texture);
+	texture->flags = p_flags;
+}
+
+uint32_t RasterizerStorageDummy::texture_get_flags(RID p_texture) const {
+
+	const Texture *texture = texture_owner.getornull(p_texture);
+	ERR_FAIL_COND_V(!texture, 0);
+	return texture->flags;
+}
+
+Image::Format RasterizerStorageDummy::texture_get_format(RID p_texture) const {
+
+	const Texture *texture = texture_owner.getornull(p_texture);
+	ERR_FAIL_COND_V(!texture, Image::FORMAT_L8);
+	return texture->format;
+}
+
+uint32_t RasterizerStorageDummy::texture_get_width(RID p_texture) const {
+
+	const Texture *texture = texture_owner.getornull(p_texture);
+	ERR_FAIL_COND_V(!texture, 0);
+	if (texture->proxy)
+		return texture->proxy->width;
+	return texture->width;
+}
+
+uint32_t RasterizerStorageDummy::texture_get_height(RID p_texture) const {
+
+	const Texture *texture = texture_owner.getornull(p_texture);
+	ERR_FAIL_COND_V(!texture, 0);
+	if (texture->proxy)
+		return texture->proxy->height;
+	return texture->height;
+}
+
+void RasterizerStorageDummy::texture_set_size_override(RID p_texture, int p_width, int p_height) {
+
+	Texture *texture = texture_owner.getornull(p_texture);
+	ERR_FAIL_COND(!texture);
+	ERR_FAIL_COND(p_width <= 0 || p_width > 16384);
+	ERR_FAIL_COND(p_height <= 0 || p_height > 16384);
+	texture->width = p_width;
+	texture->height = p_height;
+}
+
+void RasterizerStorageDummy::texture_set_path(RID p_texture, const String &p_path) {
+
+	Texture *texture = texture_owner.getornull(p_texture);
+	ERR_FAIL_COND(!texture);
+	texture->path = p_path;
+}
+
+String RasterizerStorageDummy::texture_get_path(RID p_texture) const {
+
+	const Texture *texture = texture_owner.getornull(p_texture);
+	ERR_FAIL_COND_V(!texture, String());
+	return texture->path;
+}
+
+void RasterizerStorageDummy::texture_debug_usage(List<VS::TextureInfo> *r_info) {
+
+	List<RID> textures;
+	texture_owner.get_owned_list(&textures);
+
+	for (List<RID>::Element *E = textures.front(); E; E = E->next()) {
+
+		Texture *t = texture_owner.get(E->get());
+		VS::TextureInfo tinfo;
+		tinfo.path = t->path;
+		tinfo.format = t->format;
+		tinfo.size.x = t->width;
+		tinfo.size.y = t->height;
+		tinfo.bytes = 0;
+		r_info->push_back(tinfo);
+	}
+}
+
+void RasterizerStorageDummy::texture_set_proxy(RID p_proxy, RID p_base) {
+
+	Texture *texture = texture_owner.getornull(p_proxy);
+	ERR_FAIL_COND(!texture);
+
+	if (texture->proxy) {
+		texture->proxy->proxy_owners.erase(texture);
+		texture->proxy = NULL;
+	}
+
+	if (p_base.is_valid()) {
+		Texture *base = texture_owner.getornull(p_base);
+		ERR_FAIL_COND(!base);
+		ERR_FAIL_COND(base->proxy); //can't proxy a proxy
+
+		texture->proxy = base;
+		base->proxy_owners.insert(texture);
+	}
+}
+
+/* SHADER API */
+
+RID RasterizerStorageDummy::shader_create() {
+
+	Shader *shader = memnew(Shader);
+	return shader_owner.make_rid(shader);
+}
+
+void RasterizerStorageDummy::shader_set_code(RID p_shader, const String &p_code) {
+
+	Shader *shader = shader_owner.getornull(p_shader);
+	ERR_FAIL_COND(!shader);
+	shader->code = p_code;
+}
+
+String RasterizerStorageDummy::shader_get_code(RID p_shader) const {
+
+	const Shader *shader = shader_owner.getornull(p_shader);
+	ERR_FAIL_COND_V(!shader, String());
+	return shader->code;
+}
+
+void RasterizerStorageDummy::shader_set_default_texture_param(RID p_shader, const StringName &p_name, RID p_texture) {
+
+	Shader *shader = shader_owner.getornull(p_shader);
+	ERR_FAIL_COND(!shader);
+
+	if (p_texture.is_valid() && texture_owner.owns(p_texture)) {
+		shader->default_textures[p_name] = p_texture;
+	} else {
+		shader->default_textures.erase(p_name);
+	}
+}
+
+RID RasterizerStorageDummy::shader_get_default_texture_param(RID p_shader, const StringName &p_name) const {
+
+	const Shader *shader = shader_owner.getornull(p_shader);
+	ERR_FAIL_COND_V(!shader, RID());
+
+	const Map<StringName, RID>::Element *E = shader->default_textures.find(p_name);
+	if (!E)
+		return RID();
+	return E->get();
+}
+
+/* COMMON MATERIAL API */
+
+RID RasterizerStorageDummy::material_create() {
+
+	Material *material = memnew(Material);
+	return material_owner.make_rid(material);
+}
+
+void RasterizerStorageDummy::material_set_shader(RID p_shader_material, RID p_shader) {
+
+	Material *material = material_owner.getornull(p_shader_material);
+	ERR_FAIL_COND(!material);
+	material->shader = p_shader;
+}
+
+RID RasterizerStorageDummy::material_get_shader(RID p_shader_material) const {
+
+	const Material *material = material_owner.getornull(p_shader_material);
+	ERR_FAIL_COND_V(!material, RID());
+	return material->shader;
+}
+
+void RasterizerStorageDummy::material_set_param(RID p_material, const StringName &p_param, const Variant &p_value) {
+
+	Material *material = material_owner.getornull(p_material);
+	ERR_FAIL_COND(!material);
+
+	if (p_value.get_type() == Variant::NIL)
+		material->params.erase(p_param);
+	else
+		material->params[p_param] = p_value;
+}
+
+Variant RasterizerStorageDummy::material_get_param(RID p_material, const StringName &p_param) const {
+
+	const Material *material = material_owner.getornull(p_material);
+	ERR_FAIL_COND_V(!material, Variant());
+
+	if (material->params.has(p_param))
+		return material->params[p_param];
+
+	return Variant();
+}
+
+void RasterizerStorageDummy::material_set_next_pass(RID p_material, RID p_next_material) {
+
+	Material *material = material_owner.getornull(p_material);
+	ERR_FAIL_COND(!material);
+	material->next_pass = p_next_material;
+}
+
+/* MESH API */
+
+RID RasterizerStorageDummy::mesh_create() {
+
+	Mesh *mesh = memnew(Mesh);
+	return mesh_owner.make_rid(mesh);
+}
+
+void RasterizerStorageDummy::mesh_add_surface(RID p_mesh, uint32_t p_format, VS::PrimitiveType p_primitive, const PoolVector<uint8_t> &p_array, int p_vertex_count, const PoolVector<uint8_t> &p_index_array, int p_index_count, const AABB &p_aabb, const Vector<PoolVector<uint8_t> > &p_blend_shapes, const Vector<AABB> &p_bone_aabbs) {
+
+	Mesh *mesh = mesh_owner.getornull(p_mesh);
+	ERR_FAIL_COND(!mesh);
+
+	Surface s;
+	s.format = p_format;
+	s.primitive = p_primitive;
+	s.array = p_array;
+	s.array_len = p_vertex_count;
+	s.index_array = p_index_array;
+	s.index_array_len = p_index_count;
+	s.aabb = p_aabb;
+	s.blend_shapes = p_blend_shapes;
+	s.skeleton_aabb = p_bone_aabbs;
+
+	mesh->surfaces.push_back(s);
+	mesh->instance_change_notify();
+}
+
+void RasterizerStorageDummy::mesh_set_blend_shape_count(RID p_mesh, int p_amount) {
+
+	Mesh *mesh = mesh_owner.getornull(p_mesh);
+	ERR_FAIL_COND(!mesh);
+	ERR_FAIL_COND(mesh->surfaces.size() != 0);
+	ERR_FAIL_COND(p_amount < 0);
+	mesh->blend_shape_count = p_amount;
+}
+
+int RasterizerStorageDummy::mesh_get_blend_shape_count(RID p_mesh) const {
+
+	const Mesh *mesh = mesh_owner.getornull(p_mesh);
+	ERR_FAIL_COND_V(!mesh, 0);
+	return mesh->blend_shape_count;
+}
+
+void RasterizerStorageDummy::mesh_set_blend_shape_mode(RID p_mesh, VS::BlendShapeMode p_mode) {
+
+	Mesh *mesh = mesh_owner.getornull(p_mesh);
+	ERR_FAIL_COND(!mesh);
+	mesh->blend_shape_mode = p_mode;
+}
+
+VS::BlendShapeMode RasterizerStorageDummy::mesh_get_blend_shape_mode(RID p_mesh) const {
+
+	const Mesh *mesh = mesh_owner.getornull(p_mesh);
+	ERR_FAIL_COND_V(!mesh, VS::BLEND_SHAPE_MODE_NORMALIZED);
+	return mesh->blend_shape_mode;
+}
+
+void RasterizerStorageDummy::mesh_surface_update_region(RID p_mesh, int p_surface, int p_offset, const PoolVector<uint8_t> &p_data) {
+
+	Mesh *mesh = mesh_owner.getornull(p_mesh);
+	ERR_FAIL_COND(!mesh);
+	ERR_FAIL_INDEX(p_surface, mesh->surfaces.size());
+
+	Surface &s = mesh->surfaces[p_surface];
+	int total_size = p_data.size();
+	ERR_FAIL_COND(p_offset + total_size > s.array.size());
+
+	PoolVector<uint8_t>::Write w = s.array.write();
+	PoolVector<uint8_t>::Read r = p_data.read();
+	copymem(&w[p_offset], r.ptr(), total_size);
+}
+
+void RasterizerStorageDummy::mesh_surface_set_material(RID p_mesh, int p_surface, RID p_material) {
+
+	Mesh *mesh = mesh_owner.getornull(p_mesh);
+	ERR_FAIL_COND(!mesh);
+	ERR_FAIL_INDEX(p_surface, mesh->surfaces.size());
+	mesh->surfaces[p_surface].material = p_material;
+}
+
+RID RasterizerStorageDummy::mesh_surface_get_material(RID p_mesh, int p_surface) const {
+
+	const Mesh *mesh = mesh_owner.getornull(p_mesh);
+	ERR_FAIL_COND_V(!mesh, RID());
+	ERR_FAIL_INDEX_V(p_surface, mesh->surfaces.size(), RID());
+	return mesh->surfaces[p_surface].material;
+}
+
+int RasterizerStorageDummy::mesh_surface_get_array_len(RID p_mesh, int p_surface) const {
+
+	const Mesh *mesh = mesh_owner.getornull(p_mesh);
+	ERR_FAIL_COND_V(!mesh, 0);
+	ERR_FAIL_INDEX_V(p_surface, mesh->surfaces.size(), 0);
+	return mesh->surfaces[p_surface].array_len;
+}
+
+int RasterizerStorageDummy::mesh_surface_get_array_index_len(RID p_mesh, int p_surface) const {
+
+	const Mesh *mesh = mesh_owner.getornull(p_mesh);
+	ERR_FAIL_COND_V(!mesh, 0);
+	ERR_FAIL_INDEX_V(p_surface, mesh->surfaces.size(), 0);
+	return mesh->surfaces[p_surface].index_array_len;
+}
+
+PoolVector<uint8_t> RasterizerStorageDummy::mesh_surface_get_array(RID p_mesh, int p_surface) const {
+
+	const Mesh *mesh = mesh_owner.getornull(p_mesh);
+	ERR_FAIL_COND_V(!mesh, PoolVector<uint8_t>());
+	ERR_FAIL_INDEX_V(p_surface, mesh->surfaces.size(), PoolVector<uint8_t>());
+	return mesh->surfaces[p_surface].array;
+}
+
+PoolVector<uint8_t> RasterizerStorageDummy::mesh_surface_get_index_array(RID p_mesh, int p_surface) const {
+
+	const Mesh *mesh = mesh_owner.getornull(p_mesh);
+	ERR_FAIL_COND_V(!mesh, PoolVector<uint8_t>());
+	ERR_FAIL_INDEX_V(p_surface, mesh->surfaces.size(), PoolVector<uint8_t>());
+	return mesh->surfaces[p_surface].index_array;
+}
+
+uint32_t RasterizerStorageDummy::mesh_surface_get_format(RID p_mesh, int p_surface) const {
+
+	const Mesh *mesh = mesh_owner.getornull(p_mesh);
+	ERR_FAIL_COND_V(!mesh, 0);
+	ERR_FAIL_INDEX_V(p_surface, mesh->surfaces.size(), 0);
+	return mesh->surfaces[p_surface].format;
+}
+
+VS::PrimitiveType RasterizerStorageDummy::mesh_surface_get_primitive_type(RID p_mesh, int p_surface) const {
+
+	const Mesh *mesh = mesh_owner.getornull(p_mesh);
+	ERR_FAIL_COND_V(!mesh, VS::PRIMITIVE_MAX);
+	ERR_FAIL_INDEX_V(p_surface, mesh->surfaces.size(), VS::PRIMITIVE_MAX);
+	return mesh->surfaces[p_surface].primitive;
+}
+
+AABB RasterizerStorageDummy::mesh_surface_get_aabb(RID p_mesh, int p_surface) const {
+
+	const Mesh *mesh = mesh_owner.getornull(p_mesh);
+	ERR_FAIL_COND_V(!mesh, AABB());
+	ERR_FAIL_INDEX_V(p_surface, mesh->surfaces.size(), AABB());
+	return mesh->surfaces[p_surface].aabb;
+}
+
+Vector<PoolVector<uint8_t> > RasterizerStorageDummy::mesh_surface_get_blend_shapes(RID p_mesh, int p_surface) const {
+
+	const Mesh *mesh = mesh_owner.getornull(p_mesh);
+	ERR_FAIL_COND_V(!mesh, Vector<PoolVector<uint8_t> >());
+	ERR_FAIL_INDEX_V(p_surface, mesh->surfaces.size(), Vector<PoolVector<uint8_t> >());
+	return mesh->surfaces[p_surface].blend_shapes;
+}
+
+Vector<AABB> RasterizerStorageDummy::mesh_surface_get_skeleton_aabb(RID p_mesh, int p_surface) const {
+
+	const Mesh *mesh = mesh_owner.getornull(p_mesh);
+	ERR_FAIL_COND_V(!mesh, Vector<AABB>());
+	ERR_FAIL_INDEX_V(p_surface, mesh->surfaces.size(), Vector<AABB>());
+	return mesh->surfaces[p_surface].skeleton_aabb;
+}
+
+void RasterizerStorageDummy::mesh_remove_surface(RID p_mesh, int p_index) {
+
+	Mesh *mesh = mesh_owner.getornull(p_mesh);
+	ERR_FAIL_COND(!mesh);
+	ERR_FAIL_INDEX(p_index, mesh->surfaces.size());
+
+	mesh->surfaces.remove(p_index);
+	mesh->instance_change_notify();
+}
+
+int RasterizerStorageDummy::mesh_get_surface_count(RID p_mesh) const {
+
+	const Mesh *mesh = mesh_owner.getornull(p_mesh);
+	ERR_FAIL_COND_V(!mesh, 0);
+	return mesh->surfaces.size();
+}
+
+void RasterizerStorageDummy::mesh_set_custom_aabb(RID p_mesh, const AABB &p_aabb) {
+
+	Mesh *mesh = mesh_owner.getornull(p_mesh);
+	ERR_FAIL_COND(!mesh);
+
+	mesh->custom_aabb = p_aabb;
+	mesh->instance_change_notify();
+}
+
+AABB RasterizerStorageDummy::mesh_get_custom_aabb(RID p_mesh) const {
+
+	const Mesh *mesh = mesh_owner.getornull(p_mesh);
+	ERR_FAIL_COND_V(!mesh, AABB());
+	return mesh->custom_aabb;
+}
+
+AABB RasterizerStorageDummy::mesh_get_aabb(RID p_mesh, RID p_skeleton) const {
+
+	const Mesh *mesh = mesh_owner.getornull(p_mesh);
+	ERR_FAIL_COND_V(!mesh, AABB());
+
+	if (mesh->custom_aabb != AABB())
+		return mesh->custom_aabb;
+
+	AABB aabb;
+	for (int i = 0; i < mesh->surfaces.size(); i++) {
+
+		if (i == 0)
+			aabb = mesh->surfaces[i].aabb;
+		else
+			aabb.merge_with(mesh->surfaces[i].aabb);
+	}
+
+	return aabb;
+}
+
+void RasterizerStorageDummy::mesh_clear(RID p_mesh) {
+
+	Mesh *mesh = mesh_owner.getornull(p_mesh);
+	ERR_FAIL_COND(!mesh);
+
+	mesh->surfaces.clear();
+	mesh->instance_change_notify();
+}
+
+/* MULTIMESH API */
+
+RID RasterizerStorageDummy::multimesh_create() {
+
+	MultiMesh *multimesh = memnew(MultiMesh);
+	return multimesh_owner.make_rid(multimesh);
+}
+
+void RasterizerStorageDummy::multimesh_allocate(RID p_multimesh, int p_instances, VS::MultimeshTransformFormat p_transform_format, VS::MultimeshColorFormat p_color_format) {
+
+	MultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+	ERR_FAIL_COND(!multimesh);
+
+	multimesh->size = p_instances;
+	multimesh->transform_format = p_transform_format;
+	multimesh->color_format = p_color_format;
+	multimesh->transforms.resize(p_instances);
+	multimesh->colors.resize(p_color_format == VS::MULTIMESH_COLOR_NONE ? 0 : p_instances);
+	multimesh->instance_change_notify();
+}
+
+int RasterizerStorageDummy::multimesh_get_instance_count(RID p_multimesh) const {
+
+	const MultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+	ERR_FAIL_COND_V(!multimesh, 0);
+	return multimesh->size;
+}
+
+void RasterizerStorageDummy::multimesh_set_mesh(RID p_multimesh, RID p_mesh) {
+
+	MultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+	ERR_FAIL_COND(!multimesh);
+
+	multimesh->mesh = p_mesh;
+	multimesh->instance_change_notify();
+}
+
+void RasterizerStorageDummy::multimesh_instance_set_transform(RID p_multimesh, int p_index, const Transform &p_transform) {
+
+	MultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+	ERR_FAIL_COND(!multimesh);
+	ERR_FAIL_INDEX(p_index, multimesh->size);
+	ERR_FAIL_COND(multimesh->transform_format == VS::MULTIMESH_TRANSFORM_2D);
+
+	multimesh->transforms[p_index] = p_transform;
+}
+
+void RasterizerStorageDummy::multimesh_instance_set_transform_2d(RID p_multimesh, int p_index, const Transform2D &p_transform) {
+
+	MultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+	ERR_FAIL_COND(!multimesh);
+	ERR_FAIL_INDEX(p_index, multimesh->size);
+	ERR_FAIL_COND(multimesh->transform_format == VS::MULTIMESH_TRANSFORM_3D);
+
+	Transform xform;
+	xform.basis.set_axis(0, Vector3(p_transform.elements[0].x, p_transform.elements[0].y, 0));
+	xform.basis.set_axis(1, Vector3(p_transform.elements[1].x, p_transform.elements[1].y, 0));
+	xform.origin = Vector3(p_transform.elements[2].x, p_transform.elements[2].y, 0);
+	multimesh->transforms[p_index] = xform;
+}
+
+void RasterizerStorageDummy::multimesh_instance_set_color(RID p_multimesh, int p_index, const Color &p_color) {
+
+	MultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+	ERR_FAIL_COND(!multimesh);
+	ERR_FAIL_INDEX(p_index, multimesh->size);
+	ERR_FAIL_COND(multimesh->color_format == VS::MULTIMESH_COLOR_NONE);
+
+	multimesh->colors[p_index] = p_color;
+}
+
+void RasterizerStorageDummy::multimesh_set_as_bulk_array(RID p_multimesh, const PoolVector<float> &p_array) {
+
+	MultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+	ERR_FAIL_COND(!multimesh);
+
+	// same layout as the GLES3 storage: rows of the transform, then the color
+	int xform_floats = multimesh->transform_format == VS::MULTIMESH_TRANSFORM_2D ? 8 : 12;
+	int color_floats = multimesh->color_format == VS::MULTIMESH_COLOR_NONE ? 0 : (multimesh->color_format == VS::MULTIMESH_COLOR_8BIT ? 1 : 4);
+	int stride = xform_floats + color_floats;
+
+	ERR_FAIL_COND(p_array.size() != multimesh->size * stride);
+
+	PoolVector<float>::Read r = p_array.read();
+
+	for (int i = 0; i < multimesh->size; i++) {
+
+		const float *dataptr = &r[i * stride];
+
+		Transform &xform = multimesh->transforms[i];
+		if (multimesh->transform_format == VS::MULTIMESH_TRANSFORM_2D) {
+			xform.basis.set(dataptr[0], dataptr[1], 0, dataptr[4], dataptr[5], 0, 0, 0, 1);
+			xform.origin = Vector3(dataptr[3], dataptr[7], 0);
+		} else {
+			xform.basis.set(dataptr[0], dataptr[1], dataptr[2], dataptr[4], dataptr[5], dataptr[6], dataptr[8], dataptr[9], dataptr[10]);
+			xform.origin = Vector3(dataptr[3], dataptr[7], dataptr[11]);
+		}
+
+		if (multimesh->color_format == VS::MULTIMESH_COLOR_8BIT) {
+
+			const uint8_t *data8 = (const uint8_t *)&dataptr[xform_floats];
+			multimesh->colors[i] = Color(data8[0] / 255.0, data8[1] / 255.0, data8[2] / 255.0, data8[3] / 255.0);
+
+		} else if (multimesh->color_format == VS::MULTIMESH_COLOR_FLOAT) {
+			multimesh->colors[i] = Color(dataptr[xform_floats + 0], dataptr[xform_floats + 1], dataptr[xform_floats + 2], dataptr[xform_floats + 3]);
+		}
+	}
+}
+
+RID RasterizerStorageDummy::multimesh_get_mesh(RID p_multimesh) const {
+
+	const MultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+	ERR_FAIL_COND_V(!multimesh, RID());
+	return multimesh->mesh;
+}
+
+Transform RasterizerStorageDummy::multimesh_instance_get_transform(RID p_multimesh, int p_index) const {
+
+	const MultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+	ERR_FAIL_COND_V(!multimesh, Transform());
+	ERR_FAIL_INDEX_V(p_index, multimesh->size, Transform());
+	ERR_FAIL_COND_V(multimesh->transform_format == VS::MULTIMESH_TRANSFORM_2D, Transform());
+
+	return multimesh->transforms[p_index];
+}
+
+Transform2D RasterizerStorageDummy::multimesh_instance_get_transform_2d(RID p_multimesh, int p_index) const {
+
+	const MultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+	ERR_FAIL_COND_V(!multimesh, Transform2D());
+	ERR_FAIL_INDEX_V(p_index, multimesh->size, Transform2D());
+	ERR_FAIL_COND_V(multimesh->transform_format == VS::MULTIMESH_TRANSFORM_3D, Transform2D());
+
+	const Transform &xform = multimesh->transforms[p_index];
+	Transform2D xform2d;
+	xform2d.elements[0] = Vector2(xform.basis.get_axis(0).x, xform.basis.get_axis(0).y);
+	xform2d.elements[1] = Vector2(xform.basis.get_axis(1).x, xform.basis.get_axis(1).y);
+	xform2d.elements[2] = Vector2(xform.origin.x, xform.origin.y);
+	return xform2d;
+}
+
+Color RasterizerStorageDummy::multimesh_instance_get_color(RID p_multimesh, int p_index) const {
+
+	const MultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+	ERR_FAIL_COND_V(!multimesh, Color());
+	ERR_FAIL_INDEX_V(p_index, multimesh->size, Color());
+	ERR_FAIL_COND_V(multimesh->color_format == VS::MULTIMESH_COLOR_NONE, Color());
+
+	return multimesh->colors[p_index];
+}
+
+void RasterizerStorageDummy::multimesh_set_visible_instances(RID p_multimesh, int p_visible) {
+
+	MultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+	ERR_FAIL_COND(!multimesh);
+	multimesh->visible_instances = p_visible;
+}
+
+int RasterizerStorageDummy::multimesh_get_visible_instances(RID p_multimesh) const {
+
+	const MultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+	ERR_FAIL_COND_V(!multimesh, -1);
+	return multimesh->visible_instances;
+}
+
+AABB RasterizerStorageDummy::multimesh_get_aabb(RID p_multimesh) const {
+
+	const MultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+	ERR_FAIL_COND_V(!multimesh, AABB());
+
+	if (!multimesh->mesh.is_valid() || multimesh->size == 0)
+		return AABB();
+
+	AABB mesh_aabb = mesh_get_aabb(multimesh->mesh, RID());
+	AABB aabb;
+	for (int i = 0; i < multimesh->size; i++) {
+
+		AABB xf_aabb = multimesh->transforms[i].xform(mesh_aabb);
+		if (i == 0)
+			aabb = xf_aabb;
+		else
+			aabb.merge_with(xf_aabb);
+	}
+
+	return aabb;
+}
+
+/* IMMEDIATE API */
+
+RID RasterizerStorageDummy::immediate_create() {
+
+	Immediate *immediate = memnew(Immediate);
+	return immediate_owner.make_rid(immediate);
+}
+
+void RasterizerStorageDummy::immediate_set_material(RID p_immediate, RID p_material) {
+
+	Immediate *immediate = immediate_owner.getornull(p_immediate);
+	ERR_FAIL_COND(!immediate);
+	immediate->material = p_material;
+}
+
+RID RasterizerStorageDummy::immediate_get_material(RID p_immediate) const {
+
+	const Immediate *immediate = immediate_owner.getornull(p_immediate);
+	ERR_FAIL_COND_V(!immediate, RID());
+	return immediate->material;
+}
+
+/* SKELETON API */
+
+RID RasterizerStorageDummy::skeleton_create() {
+
+	Skeleton *skeleton = memnew(Skeleton);
+	return skeleton_owner.make_rid(skeleton);
+}
+
+void RasterizerStorageDummy::skeleton_allocate(RID p_skeleton, int p_bones, bool p_2d_skeleton) {
+
+	Skeleton *skeleton = skeleton_owner.getornull(p_skeleton);
+	ERR_FAIL_COND(!skeleton);
+	ERR_FAIL_COND(p_bones < 0);
+	skeleton->size = p_bones;
+	skeleton->use_2d = p_2d_skeleton;
+}
+
+int RasterizerStorageDummy::skeleton_get_bone_count(RID p_skeleton) const {
+
+	const Skeleton *skeleton = skeleton_owner.getornull(p_skeleton);
+	ERR_FAIL_COND_V(!skeleton, 0);
+	return skeleton->size;
+}
+
+/* Light API */
+
+RID RasterizerStorageDummy::light_create(VS::LightType p_type) {
+
+	Light *light = memnew(Light);
+	light->type = p_type;
+
+	light->param[VS::LIGHT_PARAM_ENERGY] = 1.0;
+	light->param[VS::LIGHT_PARAM_INDIRECT_ENERGY] = 1.0;
+	light->param[VS::LIGHT_PARAM_SPECULAR] = 0.5;
+	light->param[VS::LIGHT_PARAM_RANGE] = 1.0;
+	light->param[VS::LIGHT_PARAM_SPOT_ANGLE] = 45;
+	light->param[VS::LIGHT_PARAM_SPOT_ATTENUATION] = 1.0;
+	light->param[VS::LIGHT_PARAM_ATTENUATION] = 1.0;
+	light->param[VS::LIGHT_PARAM_CONTACT_SHADOW_SIZE] = 45;
+	light->param[VS::LIGHT_PARAM_SHADOW_MAX_DISTANCE] = 0;
+	light->param[VS::LIGHT_PARAM_SHADOW_SPLIT_1_OFFSET] = 0.1;
+	light->param[VS::LIGHT_PARAM_SHADOW_SPLIT_2_OFFSET] = 0.3;
+	light->param[VS::LIGHT_PARAM_SHADOW_SPLIT_3_OFFSET] = 0.6;
+	light->param[VS::LIGHT_PARAM_SHADOW_NORMAL_BIAS] = 0.1;
+	light->param[VS::LIGHT_PARAM_SHADOW_BIAS] = 0.1;
+	light->param[VS::LIGHT_PARAM_SHADOW_BIAS_SPLIT_SCALE] = 0.1;
+
+	light->color = Color(1, 1, 1, 1);
+	light->shadow = false;
+	light->cull_mask = 0xFFFFFFFF;
+	light->directional_shadow_mode = VS::LIGHT_DIRECTIONAL_SHADOW_ORTHOGONAL;
+	light->omni_shadow_mode = VS::LIGHT_OMNI_SHADOW_DUAL_PARABOLOID;
+	light->directional_blend_splits = false;
+	light->directional_range_mode = VS::LIGHT_DIRECTIONAL_SHADOW_DEPTH_RANGE_STABLE;
+	light->version = 0;
+
+	return light_owner.make_rid(light);
+}
+
+void RasterizerStorageDummy::light_set_color(RID p_light, const Color &p_color) {
+
+	Light *light = light_owner.getornull(p_light);
+	ERR_FAIL_COND(!light);
+	light->color = p_color;
+}
+
+void RasterizerStorageDummy::light_set_param(RID p_light, VS::LightParam p_param, float p_value) {
+
+	Light *light = light_owner.getornull(p_light);
+	ERR_FAIL_COND(!light);
+	ERR_FAIL_INDEX(p_param, VS::LIGHT_PARAM_MAX);
+
+	switch (p_param) {
+		case VS::LIGHT_PARAM_RANGE:
+		case VS::LIGHT_PARAM_SPOT_ANGLE:
+		case VS::LIGHT_PARAM_SHADOW_MAX_DISTANCE:
+		case VS::LIGHT_PARAM_SHADOW_SPLIT_1_OFFSET:
+		case VS::LIGHT_PARAM_SHADOW_SPLIT_2_OFFSET:
+		case VS::LIGHT_PARAM_SHADOW_SPLIT_3_OFFSET:
+		case VS::LIGHT_PARAM_SHADOW_NORMAL_BIAS:
+		case VS::LIGHT_PARAM_SHADOW_BIAS: {
+
+			light->version++;
+			light->instance_change_notify();
+		} break;
+		default: {}
+	}
+
+	light->param[p_param] = p_value;
+}
+
+void RasterizerStorageDummy::light_set_shadow(RID p_light, bool p_enabled) {
+
+	Light *light = light_owner.getornull(p_light);
+	ERR_FAIL_COND(!light);
+	light->shadow = p_enabled;
+
+	light->version++;
+	light->instance_change_notify();
+}
+
+void RasterizerStorageDummy::light_set_cull_mask(RID p_light, uint32_t p_mask) {
+
+	Light *light = light_owner.getornull(p_light);
+	ERR_FAIL_COND(!light);
+	light->cull_mask = p_mask;
+
+	light->version++;
+	light->instance_change_notify();
+}
+
+void RasterizerStorageDummy::light_omni_set_shadow_mode(RID p_light, VS::LightOmniShadowMode p_mode) {
+
+	Light *light = light_owner.getornull(p_light);
+	ERR_FAIL_COND(!light);
+	light->omni_shadow_mode = p_mode;
+
+	light->version++;
+	light->instance_change_notify();
+}
+
+void RasterizerStorageDummy::light_directional_set_shadow_mode(RID p_light, VS::LightDirectionalShadowMode p_mode) {
+
+	Light *light = light_owner.getornull(p_light);
+	ERR_FAIL_COND(!light);
+	light->directional_shadow_mode = p_mode;
+
+	light->version++;
+	light->instance_change_notify();
+}
+
+void RasterizerStorageDummy::light_directional_set_blend_splits(RID p_light, bool p_enable) {
+
+	Light *light = light_owner.getornull(p_light);
+	ERR_FAIL_COND(!light);
+	light->directional_blend_splits = p_enable;
+
+	light->version++;
+	light->instance_change_notify();
+}
+
+bool RasterizerStorageDummy::light_directional_get_blend_splits(RID p_light) const {
+
+	const Light *light = light_owner.getornull(p_light);
+	ERR_FAIL_COND_V(!light, false);
+	return light->directional_blend_splits;
+}
+
+void RasterizerStorageDummy::light_directional_set_shadow_depth_range_mode(RID p_light, VS::LightDirectionalShadowDepthRangeMode p_range_mode) {
+
+	Light *light = light_owner.getornull(p_light);
+	ERR_FAIL_COND(!light);
+	light->directional_range_mode = p_range_mode;
+}
+
+VS::LightDirectionalShadowDepthRangeMode RasterizerStorageDummy::light_directional_get_shadow_depth_range_mode(RID p_light) const {
+
+	const Light *light = light_owner.getornull(p_light);
+	ERR_FAIL_COND_V(!light, VS::LIGHT_DIRECTIONAL_SHADOW_DEPTH_RANGE_STABLE);
+	return light->directional_range_mode;
+}
+
+VS::LightDirectionalShadowMode RasterizerStorageDummy::light_directional_get_shadow_mode(RID p_light) {
+
+	const Light *light = light_owner.getornull(p_light);
+	ERR_FAIL_COND_V(!light, VS::LIGHT_DIRECTIONAL_SHADOW_ORTHOGONAL);
+	return light->directional_shadow_mode;
+}
+
+VS::LightOmniShadowMode RasterizerStorageDummy::light_omni_get_shadow_mode(RID p_light) {
+
+	const Light *light = light_owner.getornull(p_light);
+	ERR_FAIL_COND_V(!light, VS::LIGHT_OMNI_SHADOW_CUBE);
+	return light->omni_shadow_mode;
+}
+
+bool RasterizerStorageDummy::light_has_shadow(RID p_light) const {
+
+	const Light *light = light_owner.getornull(p_light);
+	ERR_FAIL_COND_V(!light, false);
+	return light->shadow;
+}
+
+VS::LightType RasterizerStorageDummy::light_get_type(RID p_light) const {
+
+	const Light *light = light_owner.getornull(p_light);
+	ERR_FAIL_COND_V(!light, VS::LIGHT_DIRECTIONAL);
+	return light->type;
+}
+
+AABB RasterizerStorageDummy::light_get_aabb(RID p_light) const {
+
+	const Light *light = light_owner.getornull(p_light);
+	ERR_FAIL_COND_V(!light, AABB());
+
+	switch (light->type) {
+
+		case VS::LIGHT_SPOT: {
+
+			float len = light->param[VS::LIGHT_PARAM_RANGE];
+			float size = Math::tan(Math::deg2rad(light->param[VS::LIGHT_PARAM_SPOT_ANGLE])) * len;
+			return AABB(Vector3(-size, -size, -len), Vector3(size * 2, size * 2, len));
+		} break;
+		case VS::LIGHT_OMNI: {
+
+			float r = light->param[VS::LIGHT_PARAM_RANGE];
+			return AABB(-Vector3(r, r, r), Vector3(r, r, r) * 2);
+		} break;
+		case VS::LIGHT_DIRECTIONAL: {
+
+			return AABB();
+		} break;
+		default: {}
+	}
+
+	ERR_FAIL_V(AABB());
+	return AABB();
+}
+
+float RasterizerStorageDummy::light_get_param(RID p_light, VS::LightParam p_param) {
+
+	const Light *light = light_owner.getornull(p_light);
+	ERR_FAIL_COND_V(!light, 0);
+	ERR_FAIL_INDEX_V(p_param, VS::LIGHT_PARAM_MAX, 0);
+	return light->param[p_param];
+}
+
+Color RasterizerStorageDummy::light_get_color(RID p_light) {
+
+	const Light *light = light_owner.getornull(p_light);
+	ERR_FAIL_COND_V(!light, Color());
+	return light->color;
+}
+
+uint64_t RasterizerStorageDummy::light_get_version(RID p_light) const {
+
+	const Light *light = light_owner.getornull(p_light);
+	ERR_FAIL_COND_V(!light, 0);
+	return light->version;
+}
+
+/* PROBE API */
+
+RID RasterizerStorageDummy::reflection_probe_create() {
+
+	ReflectionProbe *reflection_probe = memnew(ReflectionProbe);
+
+	reflection_probe->update_mode = VS::REFLECTION_PROBE_UPDATE_ONCE;
+	reflection_probe->max_distance = 0;
+	reflection_probe->extents = Vector3(1, 1, 1);
+	reflection_probe->enable_shadows = false;
+	reflection_probe->cull_mask = (1 << 20) - 1;
+
+	return reflection_probe_owner.make_rid(reflection_probe);
+}
+
+void RasterizerStorageDummy::reflection_probe_set_update_mode(RID p_probe, VS::ReflectionProbeUpdateMode p_mode) {
+
+	ReflectionProbe *reflection_probe = reflection_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND(!reflection_probe);
+	reflection_probe->update_mode = p_mode;
+	reflection_probe->instance_change_notify();
+}
+
+void RasterizerStorageDummy::reflection_probe_set_max_distance(RID p_probe, float p_distance) {
+
+	ReflectionProbe *reflection_probe = reflection_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND(!reflection_probe);
+	reflection_probe->max_distance = p_distance;
+	reflection_probe->instance_change_notify();
+}
+
+void RasterizerStorageDummy::reflection_probe_set_extents(RID p_probe, const Vector3 &p_extents) {
+
+	ReflectionProbe *reflection_probe = reflection_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND(!reflection_probe);
+	reflection_probe->extents = p_extents;
+	reflection_probe->instance_change_notify();
+}
+
+void RasterizerStorageDummy::reflection_probe_set_origin_offset(RID p_probe, const Vector3 &p_offset) {
+
+	ReflectionProbe *reflection_probe = reflection_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND(!reflection_probe);
+	reflection_probe->origin_offset = p_offset;
+	reflection_probe->instance_change_notify();
+}
+
+void RasterizerStorageDummy::reflection_probe_set_enable_shadows(RID p_probe, bool p_enable) {
+
+	ReflectionProbe *reflection_probe = reflection_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND(!reflection_probe);
+	reflection_probe->enable_shadows = p_enable;
+	reflection_probe->instance_change_notify();
+}
+
+void RasterizerStorageDummy::reflection_probe_set_cull_mask(RID p_probe, uint32_t p_layers) {
+
+	ReflectionProbe *reflection_probe = reflection_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND(!reflection_probe);
+	reflection_probe->cull_mask = p_layers;
+	reflection_probe->instance_change_notify();
+}
+
+AABB RasterizerStorageDummy::reflection_probe_get_aabb(RID p_probe) const {
+
+	const ReflectionProbe *reflection_probe = reflection_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND_V(!reflection_probe, AABB());
+
+	AABB aabb;
+	aabb.position = -reflection_probe->extents;
+	aabb.size = reflection_probe->extents * 2.0;
+	return aabb;
+}
+
+VS::ReflectionProbeUpdateMode RasterizerStorageDummy::reflection_probe_get_update_mode(RID p_probe) const {
+
+	const ReflectionProbe *reflection_probe = reflection_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND_V(!reflection_probe, VS::REFLECTION_PROBE_UPDATE_ALWAYS);
+	return reflection_probe->update_mode;
+}
+
+uint32_t RasterizerStorageDummy::reflection_probe_get_cull_mask(RID p_probe) const {
+
+	const ReflectionProbe *reflection_probe = reflection_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND_V(!reflection_probe, 0);
+	return reflection_probe->cull_mask;
+}
+
+Vector3 RasterizerStorageDummy::reflection_probe_get_extents(RID p_probe) const {
+
+	const ReflectionProbe *reflection_probe = reflection_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND_V(!reflection_probe, Vector3());
+	return reflection_probe->extents;
+}
+
+Vector3 RasterizerStorageDummy::reflection_probe_get_origin_offset(RID p_probe) const {
+
+	const ReflectionProbe *reflection_probe = reflection_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND_V(!reflection_probe, Vector3());
+	return reflection_probe->origin_offset;
+}
+
+float RasterizerStorageDummy::reflection_probe_get_origin_max_distance(RID p_probe) const {
+
+	const ReflectionProbe *reflection_probe = reflection_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND_V(!reflection_probe, 0);
+	return reflection_probe->max_distance;
+}
+
+bool RasterizerStorageDummy::reflection_probe_renders_shadows(RID p_probe) const {
+
+	const ReflectionProbe *reflection_probe = reflection_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND_V(!reflection_probe, false);
+	return reflection_probe->enable_shadows;
+}
+
+void RasterizerStorageDummy::instance_add_dependency(RID p_base, RasterizerScene::InstanceBase *p_instance) {
+
+	Instantiable *inst = NULL;
+	switch (p_instance->base_type) {
+		case VS::INSTANCE_MESH: {
+			inst = mesh_owner.getornull(p_base);
+			ERR_FAIL_COND(!inst);
+		} break;
+		case VS::INSTANCE_MULTIMESH: {
+			inst = multimesh_owner.getornull(p_base);
+			ERR_FAIL_COND(!inst);
+		} break;
+		case VS::INSTANCE_IMMEDIATE: {
+			inst = immediate_owner.getornull(p_base);
+			ERR_FAIL_COND(!inst);
+		} break;
+		case VS::INSTANCE_PARTICLES: {
+			inst = particles_owner.getornull(p_base);
+			ERR_FAIL_COND(!inst);
+		} break;
+		case VS::INSTANCE_REFLECTION_PROBE: {
+			inst = reflection_probe_owner.getornull(p_base);
+			ERR_FAIL_COND(!inst);
+		} break;
+		case VS::INSTANCE_LIGHT: {
+			inst = light_owner.getornull(p_base);
+			ERR_FAIL_COND(!inst);
+		} break;
+		case VS::INSTANCE_GI_PROBE: {
+			inst = gi_probe_owner.getornull(p_base);
+			ERR_FAIL_COND(!inst);
+		} break;
+		case VS::INSTANCE_LIGHTMAP_CAPTURE: {
+			inst = lightmap_capture_data_owner.getornull(p_base);
+			ERR_FAIL_COND(!inst);
+		} break;
+		default: {
+			if (!inst) {
+				ERR_FAIL();
+			}
+		}
+	}
+
+	inst->instance_list.add(&p_instance->dependency_item);
+}
+
+void RasterizerStorageDummy::instance_remove_dependency(RID p_base, RasterizerScene::InstanceBase *p_instance) {
+
+	Instantiable *inst = NULL;
+
+	switch (p_instance->base_type) {
+		case VS::INSTANCE_MESH: {
+			inst = mesh_owner.getornull(p_base);
+			ERR_FAIL_COND(!inst);
+		} break;
+		case VS::INSTANCE_MULTIMESH: {
+			inst = multimesh_owner.getornull(p_base);
+			ERR_FAIL_COND(!inst);
+		} break;
+		case VS::INSTANCE_IMMEDIATE: {
+			inst = immediate_owner.getornull(p_base);
+			ERR_FAIL_COND(!inst);
+		} break;
+		case VS::INSTANCE_PARTICLES: {
+			inst = particles_owner.getornull(p_base);
+			ERR_FAIL_COND(!inst);
+		} break;
+		case VS::INSTANCE_REFLECTION_PROBE: {
+			inst = reflection_probe_owner.getornull(p_base);
+			ERR_FAIL_COND(!inst);
+		} break;
+		case VS::INSTANCE_LIGHT: {
+			inst = light_owner.getornull(p_base);
+			ERR_FAIL_COND(!inst);
+		} break;
+		case VS::INSTANCE_GI_PROBE: {
+			inst = gi_probe_owner.getornull(p_base);
+			ERR_FAIL_COND(!inst);
+		} break;
+		case VS::INSTANCE_LIGHTMAP_CAPTURE: {
+			inst = lightmap_capture_data_owner.getornull(p_base);
+			ERR_FAIL_COND(!inst);
+		} break;
+		default: {
+
+			if (!inst) {
+				ERR_FAIL();
+			}
+		}
+	}
+
+	ERR_FAIL_COND(!inst);
+
+	inst->instance_list.remove(&p_instance->dependency_item);
+}
+
+/* GI PROBE API */
+
+RID RasterizerStorageDummy::gi_probe_create() {
+
+	GIProbe *gipo = memnew(GIProbe);
+
+	gipo->bounds = AABB(Vector3(), Vector3(1, 1, 1));
+	gipo->dynamic_range = 1.0;
+	gipo->energy = 1.0;
+	gipo->propagation = 1.0;
+	gipo->bias = 0.4;
+	gipo->normal_bias = 0.4;
+	gipo->interior = false;
+	gipo->compress = false;
+	gipo->version = 1;
+	gipo->cell_size = 1.0;
+
+	return gi_probe_owner.make_rid(gipo);
+}
+
+void RasterizerStorageDummy::gi_probe_set_bounds(RID p_probe, const AABB &p_bounds) {
+
+	GIProbe *gip = gi_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND(!gip);
+
+	gip->bounds = p_bounds;
+	gip->version++;
+	gip->instance_change_notify();
+}
+
+AABB RasterizerStorageDummy::gi_probe_get_bounds(RID p_probe) const {
+
+	const GIProbe *gip = gi_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND_V(!gip, AABB());
+	return gip->bounds;
+}
+
+void RasterizerStorageDummy::gi_probe_set_cell_size(RID p_probe, float p_size) {
+
+	GIProbe *gip = gi_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND(!gip);
+
+	gip->cell_size = p_size;
+	gip->version++;
+	gip->instance_change_notify();
+}
+
+float RasterizerStorageDummy::gi_probe_get_cell_size(RID p_probe) const {
+
+	const GIProbe *gip = gi_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND_V(!gip, 0);
+	return gip->cell_size;
+}
+
+void RasterizerStorageDummy::gi_probe_set_to_cell_xform(RID p_probe, const Transform &p_xform) {
+
+	GIProbe *gip = gi_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND(!gip);
+	gip->to_cell = p_xform;
+}
+
+Transform RasterizerStorageDummy::gi_probe_get_to_cell_xform(RID p_probe) const {
+
+	const GIProbe *gip = gi_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND_V(!gip, Transform());
+	return gip->to_cell;
+}
+
+void RasterizerStorageDummy::gi_probe_set_dynamic_data(RID p_probe, const PoolVector<int> &p_data) {
+
+	GIProbe *gip = gi_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND(!gip);
+
+	gip->dynamic_data = p_data;
+	gip->version++;
+	gip->instance_change_notify();
+}
+
+PoolVector<int> RasterizerStorageDummy::gi_probe_get_dynamic_data(RID p_probe) const {
+
+	const GIProbe *gip = gi_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND_V(!gip, PoolVector<int>());
+	return gip->dynamic_data;
+}
+
+void RasterizerStorageDummy::gi_probe_set_dynamic_range(RID p_probe, int p_range) {
+
+	GIProbe *gip = gi_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND(!gip);
+	gip->dynamic_range = p_range;
+}
+
+int RasterizerStorageDummy::gi_probe_get_dynamic_range(RID p_probe) const {
+
+	const GIProbe *gip = gi_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND_V(!gip, 0);
+	return gip->dynamic_range;
+}
+
+void RasterizerStorageDummy::gi_probe_set_energy(RID p_probe, float p_range) {
+
+	GIProbe *gip = gi_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND(!gip);
+	gip->energy = p_range;
+}
+
+float RasterizerStorageDummy::gi_probe_get_energy(RID p_probe) const {
+
+	const GIProbe *gip = gi_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND_V(!gip, 0);
+	return gip->energy;
+}
+
+void RasterizerStorageDummy::gi_probe_set_bias(RID p_probe, float p_range) {
+
+	GIProbe *gip = gi_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND(!gip);
+	gip->bias = p_range;
+}
+
+float RasterizerStorageDummy::gi_probe_get_bias(RID p_probe) const {
+
+	const GIProbe *gip = gi_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND_V(!gip, 0);
+	return gip->bias;
+}
+
+void RasterizerStorageDummy::gi_probe_set_normal_bias(RID p_probe, float p_range) {
+
+	GIProbe *gip = gi_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND(!gip);
+	gip->normal_bias = p_range;
+}
+
+float RasterizerStorageDummy::gi_probe_get_normal_bias(RID p_probe) const {
+
+	const GIProbe *gip = gi_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND_V(!gip, 0);
+	return gip->normal_bias;
+}
+
+void RasterizerStorageDummy::gi_probe_set_propagation(RID p_probe, float p_range) {
+
+	GIProbe *gip = gi_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND(!gip);
+	gip->propagation = p_range;
+}
+
+float RasterizerStorageDummy::gi_probe_get_propagation(RID p_probe) const {
+
+	const GIProbe *gip = gi_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND_V(!gip, 0);
+	return gip->propagation;
+}
+
+void RasterizerStorageDummy::gi_probe_set_interior(RID p_probe, bool p_enable) {
+
+	GIProbe *gip = gi_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND(!gip);
+	gip->interior = p_enable;
+}
+
+bool RasterizerStorageDummy::gi_probe_is_interior(RID p_probe) const {
+
+	const GIProbe *gip = gi_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND_V(!gip, false);
+	return gip->interior;
+}
+
+void RasterizerStorageDummy::gi_probe_set_compress(RID p_probe, bool p_enable) {
+
+	GIProbe *gip = gi_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND(!gip);
+	gip->compress = p_enable;
+}
+
+bool RasterizerStorageDummy::gi_probe_is_compressed(RID p_probe) const {
+
+	const GIProbe *gip = gi_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND_V(!gip, false);
+	return gip->compress;
+}
+
+uint32_t RasterizerStorageDummy::gi_probe_get_version(RID p_probe) {
+
+	const GIProbe *gip = gi_probe_owner.getornull(p_probe);
+	ERR_FAIL_COND_V(!gip, 0);
+	return gip->version;
+}
+
+/* LIGHTMAP CAPTURE */
+
+RID RasterizerStorageDummy::lightmap_capture_create() {
+
+	LightmapCapture *capture = memnew(LightmapCapture);
+	return lightmap_capture_data_owner.make_rid(capture);
+}
+
+void RasterizerStorageDummy::lightmap_capture_set_bounds(RID p_capture, const AABB &p_bounds) {
+
+	LightmapCapture *capture = lightmap_capture_data_owner.getornull(p_capture);
+	ERR_FAIL_COND(!capture);
+	capture->bounds = p_bounds;
+	capture->instance_change_notify();
+}
+
+AABB RasterizerStorageDummy::lightmap_capture_get_bounds(RID p_capture) const {
+
+	const LightmapCapture *capture = lightmap_capture_data_owner.getornull(p_capture);
+	ERR_FAIL_COND_V(!capture, AABB());
+	return capture->bounds;
+}
+
+void RasterizerStorageDummy::lightmap_capture_set_octree(RID p_capture, const PoolVector<uint8_t> &p_octree) {
+
+	LightmapCapture *capture = lightmap_capture_data_owner.getornull(p_capture);
+	ERR_FAIL_COND(!capture);
+
+	ERR_FAIL_COND(p_octree.size() == 0 || (p_octree.size() % sizeof(LightmapCaptureOctree)) != 0);
+
+	capture->octree.resize(p_octree.size() / sizeof(LightmapCaptureOctree));
+	if (p_octree.size()) {
+		PoolVector<LightmapCaptureOctree>::Write w = capture->octree.write();
+		PoolVector<uint8_t>::Read r = p_octree.read();
+		copymem(w.ptr(), r.ptr(), p_octree.size());
+	}
+	capture->instance_change_notify();
+}
+
+PoolVector<uint8_t> RasterizerStorageDummy::lightmap_capture_get_octree(RID p_capture) const {
+
+	const LightmapCapture *capture = lightmap_capture_data_owner.getornull(p_capture);
+	ERR_FAIL_COND_V(!capture, PoolVector<uint8_t>());
+
+	if (capture->octree.size() == 0)
+		return PoolVector<uint8_t>();
+
+	PoolVector<uint8_t> ret;
+	ret.resize(capture->octree.size() * sizeof(LightmapCaptureOctree));
+	{
+		PoolVector<LightmapCaptureOctree>::Read r = capture->octree.read();
+		PoolVector<uint8_t>::Write w = ret.write();
+		copymem(w.ptr(), r.ptr(), ret.size());
+	}
+
+	return ret;
+}
+
+void RasterizerStorageDummy::lightmap_capture_set_octree_cell_transform(RID p_capture, const Transform &p_xform) {
+
+	LightmapCapture *capture = lightmap_capture_data_owner.getornull(p_capture);
+	ERR_FAIL_COND(!capture);
+	capture->cell_xform = p_xform;
+}
+
+Transform RasterizerStorageDummy::lightmap_capture_get_octree_cell_transform(RID p_capture) const {
+
+	const LightmapCapture *capture = lightmap_capture_data_owner.getornull(p_capture);
+	ERR_FAIL_COND_V(!capture, Transform());
+	return capture->cell_xform;
+}
+
+void RasterizerStorageDummy::lightmap_capture_set_octree_cell_subdiv(RID p_capture, int p_subdiv) {
+
+	LightmapCapture *capture = lightmap_capture_data_owner.getornull(p_capture);
+	ERR_FAIL_COND(!capture);
+	capture->cell_subdiv = p_subdiv;
+}
+
+int RasterizerStorageDummy::lightmap_capture_get_octree_cell_subdiv(RID p_capture) const {
+
+	const LightmapCapture *capture = lightmap_capture_data_owner.getornull(p_capture);
+	ERR_FAIL_COND_V(!capture, 0);
+	return capture->cell_subdiv;
+}
+
+void RasterizerStorageDummy::lightmap_capture_set_energy(RID p_capture, float p_energy) {
+
+	LightmapCapture *capture = lightmap_capture_data_owner.getornull(p_capture);
+	ERR_FAIL_COND(!capture);
+	capture->energy = p_energy;
+}
+
+float RasterizerStorageDummy::lightmap_capture_get_energy(RID p_capture) const {
+
+	const LightmapCapture *capture = lightmap_capture_data_owner.getornull(p_capture);
+	ERR_FAIL_COND_V(!capture, 0);
+	return capture->energy;
+}
+
+const PoolVector<RasterizerStorage::LightmapCaptureOctree> *RasterizerStorageDummy::lightmap_capture_get_octree_ptr(RID p_capture) const {
+
+	const LightmapCapture *capture = lightmap_capture_data_owner.getornull(p_capture);
+	ERR_FAIL_COND_V(!capture, NULL);
+	return &capture->octree;
+}
+
+/* PARTICLES */
+
+RID RasterizerStorageDummy::particles_create() {
+
+	Particles *particles = memnew(Particles);
+	return particles_owner.make_rid(particles);
+}
+
+void RasterizerStorageDummy::particles_set_emitting(RID p_particles, bool p_emitting) {
+
+	Particles *particles = particles_owner.getornull(p_particles);
+	ERR_FAIL_COND(!particles);
+	particles->emitting = p_emitting;
+}
+
+bool RasterizerStorageDummy::particles_get_emitting(RID p_particles) {
+
+	const Particles *particles = particles_owner.getornull(p_particles);
+	ERR_FAIL_COND_V(!particles, false);
+	return particles->emitting;
+}
+
+void RasterizerStorageDummy::particles_set_custom_aabb(RID p_particles, const AABB &p_aabb) {
+
+	Particles *particles = particles_owner.getornull(p_particles);
+	ERR_FAIL_COND(!particles);
+	particles->custom_aabb = p_aabb;
+	particles->instance_change_notify();
+}
+
+void RasterizerStorageDummy::particles_set_draw_passes(RID p_particles, int p_count) {
+
+	Particles *particles = particles_owner.getornull(p_particles);
+	ERR_FAIL_COND(!particles);
+	particles->draw_passes.resize(p_count);
+}
+
+void RasterizerStorageDummy::particles_set_draw_pass_mesh(RID p_particles, int p_pass, RID p_mesh) {
+
+	Particles *particles = particles_owner.getornull(p_particles);
+	ERR_FAIL_COND(!particles);
+	ERR_FAIL_INDEX(p_pass, particles->draw_passes.size());
+	particles->draw_passes[p_pass] = p_mesh;
+}
+
+AABB RasterizerStorageDummy::particles_get_current_aabb(RID p_particles) {
+
+	const Particles *particles = particles_owner.getornull(p_particles);
+	ERR_FAIL_COND_V(!particles, AABB());
+	return particles->custom_aabb;
+}
+
+AABB RasterizerStorageDummy::particles_get_aabb(RID p_particles) const {
+
+	const Particles *particles = particles_owner.getornull(p_particles);
+	ERR_FAIL_COND_V(!particles, AABB());
+	return particles->custom_aabb;
+}
+
+int RasterizerStorageDummy::particles_get_draw_passes(RID p_particles) const {
+
+	const Particles *particles = particles_owner.getornull(p_particles);
+	ERR_FAIL_COND_V(!particles, 0);
+	return particles->draw_passes.size();
+}
+
+RID RasterizerStorageDummy::particles_get_draw_pass_mesh(RID p_particles, int p_pass) const {
+
+	const Particles *particles = particles_owner.getornull(p_particles);
+	ERR_FAIL_COND_V(!particles, RID());
+	ERR_FAIL_INDEX_V(p_pass, particles->draw_passes.size(), RID());
+	return particles->draw_passes[p_pass];
+}
+
+/* RENDER TARGET */
+
+RID RasterizerStorageDummy::render_target_create() {
+
+	RenderTarget *rt = memnew(RenderTarget);
+	rt->used = false;
+	rt->texture = texture_create();
+	return render_target_owner.make_rid(rt);
+}
+
+void RasterizerStorageDummy::render_target_set_size(RID p_render_target, int p_width, int p_height) {
+
+	RenderTarget *rt = render_target_owner.getornull(p_render_target);
+	ERR_FAIL_COND(!rt);
+
+	Texture *texture = texture_owner.getornull(rt->texture);
+	ERR_FAIL_COND(!texture);
+	texture->width = p_width;
+	texture->height = p_height;
+}
+
+RID RasterizerStorageDummy::render_target_get_texture(RID p_render_target) const {
+
+	const RenderTarget *rt = render_target_owner.getornull(p_render_target);
+	ERR_FAIL_COND_V(!rt, RID());
+	return rt->texture;
+}
+
+bool RasterizerStorageDummy::render_target_was_used(RID p_render_target) {
+
+	const RenderTarget *rt = render_target_owner.getornull(p_render_target);
+	ERR_FAIL_COND_V(!rt, false);
+	return rt->used;
+}
+
+void RasterizerStorageDummy::render_target_clear_used(RID p_render_target) {
+
+	RenderTarget *rt = render_target_owner.getornull(p_render_target);
+	ERR_FAIL_COND(!rt);
+	rt->used = false;
+}
+
+/* LIGHT SHADOW MAPPING */
+
+RID RasterizerStorageDummy::canvas_light_occluder_create() {
+
+	CanvasOccluder *co = memnew(CanvasOccluder);
+	return canvas_occluder_owner.make_rid(co);
+}
+
+void RasterizerStorageDummy::canvas_light_occluder_set_polylines(RID p_occluder, const PoolVector<Vector2> &p_lines) {
+
+	CanvasOccluder *co = canvas_occluder_owner.getornull(p_occluder);
+	ERR_FAIL_COND(!co);
+	co->lines = p_lines;
+}
+
+VS::InstanceType RasterizerStorageDummy::get_base_type(RID p_rid) const {
+
+	if (mesh_owner.owns(p_rid)) {
+		return VS::INSTANCE_MESH;
+	}
+
+	if (multimesh_owner.owns(p_rid)) {
+		return VS::INSTANCE_MULTIMESH;
+	}
+
+	if (immediate_owner.owns(p_rid)) {
+		return VS::INSTANCE_IMMEDIATE;
+	}
+
+	if (particles_owner.owns(p_rid)) {
+		return VS::INSTANCE_PARTICLES;
+	}
+
+	if (light_owner.owns(p_rid)) {
+		return VS::INSTANCE_LIGHT;
+	}
+
+	if (reflection_probe_owner.owns(p_rid)) {
+		return VS::INSTANCE_REFLECTION_PROBE;
+	}
+
+	if (gi_probe_owner.owns(p_rid)) {
+		return VS::INSTANCE_GI_PROBE;
+	}
+
+	if (lightmap_capture_data_owner.owns(p_rid)) {
+		return VS::INSTANCE_LIGHTMAP_CAPTURE;
+	}
+
+	return VS::INSTANCE_NONE;
+}
+
+bool RasterizerStorageDummy::free(RID p_rid) {
+
+	if (render_target_owner.owns(p_rid)) {
+
+		RenderTarget *rt = render_target_owner.get(p_rid);
+		free(rt->texture);
+		render_target_owner.free(p_rid);
+		memdelete(rt);
+
+	} else if (texture_owner.owns(p_rid)) {
+
+		Texture *texture = texture_owner.get(p_rid);
+		texture_owner.free(p_rid);
+		memdelete(texture);
+
+	} else if (shader_owner.owns(p_rid)) {
+
+		Shader *shader = shader_owner.get(p_rid);
+		shader_owner.free(p_rid);
+		memdelete(shader);
+
+	} else if (material_owner.owns(p_rid)) {
+
+		Material *material = material_owner.get(p_rid);
+		material_owner.free(p_rid);
+		memdelete(material);
+
+	} else if (mesh_owner.owns(p_rid)) {
+
+		Mesh *mesh = mesh_owner.get(p_rid);
+		mesh->instance_remove_deps();
+		mesh_clear(p_rid);
+
+		// Multimeshes do not keep instances of the mesh, just detach them.
+		List<RID> multimeshes;
+		multimesh_owner.get_owned_list(&multimeshes);
+		for (List<RID>::Element *E = multimeshes.front(); E; E = E->next()) {
+
+			MultiMesh *multimesh = multimesh_owner.get(E->get());
+			if (multimesh->mesh == p_rid) {
+				multimesh->mesh = RID();
+				multimesh->instance_change_notify();
+			}
+		}
+
+		mesh_owner.free(p_rid);
+		memdelete(mesh);
+
+	} else if (multimesh_owner.owns(p_rid)) {
+
+		MultiMesh *multimesh = multimesh_owner.get(p_rid);
+		multimesh->instance_remove_deps();
+		multimesh_owner.free(p_rid);
+		memdelete(multimesh);
+
+	} else if (immediate_owner.owns(p_rid)) {
+
+		Immediate *immediate = immediate_owner.get(p_rid);
+		immediate->instance_remove_deps();
+		immediate_owner.free(p_rid);
+		memdelete(immediate);
+
+	} else if (skeleton_owner.owns(p_rid)) {
+
+		Skeleton *skeleton = skeleton_owner.get(p_rid);
+		skeleton_owner.free(p_rid);
+		memdelete(skeleton);
+
+	} else if (light_owner.owns(p_rid)) {
+
+		Light *light = light_owner.get(p_rid);
+		light->instance_remove_deps();
+		light_owner.free(p_rid);
+		memdelete(light);
+
+	} else if (reflection_probe_owner.owns(p_rid)) {
+
+		ReflectionProbe *reflection_probe = reflection_probe_owner.get(p_rid);
+		reflection_probe->instance_remove_deps();
+		reflection_probe_owner.free(p_rid);
+		memdelete(reflection_probe);
+
+	} else if (gi_probe_owner.owns(p_rid)) {
+
+		GIProbe *gi_probe = gi_probe_owner.get(p_rid);
+		gi_probe->instance_remove_deps();
+		gi_probe_owner.free(p_rid);
+		memdelete(gi_probe);
+
+	} else if (lightmap_capture_data_owner.owns(p_rid)) {
+
+		LightmapCapture *capture = lightmap_capture_data_owner.get(p_rid);
+		capture->instance_remove_deps();
+		lightmap_capture_data_owner.free(p_rid);
+		memdelete(capture);
+
+	} else if (particles_owner.owns(p_rid)) {
+
+		Particles *particles = particles_owner.get(p_rid);
+		particles->instance_remove_deps();
+		particles_owner.free(p_rid);
+		memdelete(particles);
+
+	} else if (canvas_occluder_owner.owns(p_rid)) {
+
+		CanvasOccluder *co = canvas_occluder_owner.get(p_rid);
+		canvas_occluder_owner.free(p_rid);
+		memdelete(co);
+
+	} else {
+		return false;
+	}
+
+	return true;
+}
+
+/* RASTERIZER */
+
+RasterizerStorage *RasterizerDummy::get_storage() {
+
+	return storage;
+}
+
+RasterizerCanvas *RasterizerDummy::get_canvas() {
+
+	return canvas;
+}
+
+RasterizerScene *RasterizerDummy::get_scene() {
+
+	return scene;
+}
+
+Rasterizer *RasterizerDummy::_create_current() {
+
+	return memnew(RasterizerDummy);
+}
+
+void RasterizerDummy::make_current() {
+
+	_create_func = _create_current;
+}
+
+RasterizerDummy::RasterizerDummy() {
+
+	storage = memnew(RasterizerStorageDummy);
+	canvas = memnew(RasterizerCanvasDummy);
+	scene = memnew(RasterizerSceneDummy);
+}
+
+RasterizerDummy::~RasterizerDummy() {
+
+	memdelete(storage);
+	memdelete(canvas);
+	memdelete(scene);
+}
@@ -0,0 +1,780 @@
+/*************************************************************************/
+/*  rasterizer_dummy.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef RASTERIZER_DUMMY_H
+#define RASTERIZER_DUMMY_H
+
+#include "servers/visual/rasterizer.h"
+
+/**
+	Rasterizer used by headless builds (dedicated servers, CI). It keeps the
+	same RID bookkeeping the real drivers do, so scenes can be loaded, queried
+	and saved, but it never touches a GPU and discards all pixel data.
+*/
+
+class RasterizerSceneDummy : public RasterizerScene {
+public:
+	struct Environment : public RID_Data {
+
+		VS::EnvironmentBG bg_mode;
+		int canvas_max_layer;
+
+		Environment() {
+			bg_mode = VS::ENV_BG_CLEAR_COLOR;
+			canvas_max_layer = 0;
+		}
+	};
+
+	mutable RID_Owner<Environment> environment_owner;
+
+	/* SHADOW ATLAS API */
+
+	RID shadow_atlas_create() { return RID(); }
+	void shadow_atlas_set_size(RID p_atlas, int p_size) {}
+	void shadow_atlas_set_quadrant_subdivision(RID p_atlas, int p_quadrant, int p_subdivision) {}
+	bool shadow_atlas_update_light(RID p_atlas, RID p_light_intance, float p_coverage, uint64_t p_light_version) { return false; }
+
+	int get_directional_light_shadow_size(RID p_light_intance) { return 0; }
+	void set_directional_shadow_count(int p_count) {}
+
+	/* ENVIRONMENT API */
+
+	RID environment_create();
+
+	void environment_set_background(RID p_env, VS::EnvironmentBG p_bg);
+	void environment_set_sky(RID p_env, RID p_sky) {}
+	void environment_set_sky_custom_fov(RID p_env, float p_scale) {}
+	void environment_set_bg_color(RID p_env, const Color &p_color) {}
+	void environment_set_bg_energy(RID p_env, float p_energy) {}
+	void environment_set_canvas_max_layer(RID p_env, int p_max_layer);
+	void environment_set_ambient_light(RID p_env, const Color &p_color, float p_energy = 1.0, float p_sky_contribution = 0.0) {}
+
+	void environment_set_dof_blur_near(RID p_env, bool p_enable, float p_distance, float p_transition, float p_far_amount, VS::EnvironmentDOFBlurQuality p_quality) {}
+	void environment_set_dof_blur_far(RID p_env, bool p_enable, float p_distance, float p_transition, float p_far_amount, VS::EnvironmentDOFBlurQuality p_quality) {}
+	void environment_set_glow(RID p_env, bool p_enable, int p_level_flags, float p_intensity, float p_strength, float p_bloom_threshold, VS::EnvironmentGlowBlendMode p_blend_mode, float p_hdr_bleed_threshold, float p_hdr_bleed_scale, bool p_bicubic_upscale) {}
+	void environment_set_fog(RID p_env, bool p_enable, float p_begin, float p_end, RID p_gradient_texture) {}
+
+	void environment_set_ssr(RID p_env, bool p_enable, int p_max_steps, float p_fade_int, float p_fade_out, float p_depth_tolerance, bool p_roughness) {}
+	void environment_set_ssao(RID p_env, bool p_enable, float p_radius, float p_intensity, float p_radius2, float p_intensity2, float p_bias, float p_light_affect, const Color &p_color, VS::EnvironmentSSAOQuality p_quality, VS::EnvironmentSSAOBlur p_blur, float p_bilateral_sharpness) {}
+
+	void environment_set_tonemap(RID p_env, VS::EnvironmentToneMapper p_tone_mapper, float p_exposure, float p_white, bool p_auto_exposure, float p_min_luminance, float p_max_luminance, float p_auto_exp_speed, float p_auto_exp_scale) {}
+
+	void environment_set_adjustment(RID p_env, bool p_enable, float p_brightness, float p_contrast, float p_saturation, RID p_ramp) {}
+
+	void environment_set_fog(RID p_env, bool p_enable, const Color &p_color, const Color &p_sun_color, float p_sun_amount) {}
+	void environment_set_fog_depth(RID p_env, bool p_enable, float p_depth_begin, float p_depth_curve, bool p_transmit, float p_transmit_curve) {}
+	void environment_set_fog_height(RID p_env, bool p_enable, float p_min_height, float p_max_height, float p_height_curve) {}
+
+	bool is_environment(RID p_env);
+	VS::EnvironmentBG environment_get_background(RID p_env);
+	int environment_get_canvas_max_layer(RID p_env);
+
+	/* LIGHT INSTANCE, PROBE INSTANCE */
+
+	RID light_instance_create(RID p_light) { return RID(); }
+	void light_instance_set_transform(RID p_light_instance, const Transform &p_transform) {}
+	void light_instance_set_shadow_transform(RID p_light_instance, const CameraMatrix &p_projection, const Transform &p_transform, float p_far, float p_split, int p_pass, float p_bias_scale = 1.0) {}
+	void light_instance_mark_visible(RID p_light_instance) {}
+
+	RID reflection_atlas_create() { return RID(); }
+	void reflection_atlas_set_size(RID p_ref_atlas, int p_size) {}
+	void reflection_atlas_set_subdivision(RID p_ref_atlas, int p_subdiv) {}
+
+	RID reflection_probe_instance_create(RID p_probe) { return RID(); }
+	void reflection_probe_instance_set_transform(RID p_instance, const Transform &p_transform) {}
+	void reflection_probe_release_atlas_index(RID p_instance) {}
+	bool reflection_probe_instance_needs_redraw(RID p_instance) { return false; }
+	bool reflection_probe_instance_has_reflection(RID p_instance) { return false; }
+	bool reflection_probe_instance_begin_render(RID p_instance, RID p_reflection_atlas) { return false; }
+	bool reflection_probe_instance_postprocess_step(RID p_instance) { return true; }
+
+	RID gi_probe_instance_create() { return RID(); }
+	void gi_probe_instance_set_light_data(RID p_probe, RID p_base, RID p_data) {}
+	void gi_probe_instance_set_transform_to_data(RID p_probe, const Transform &p_xform) {}
+	void gi_probe_instance_set_bounds(RID p_probe, const Vector3 &p_bounds) {}
+
+	void render_scene(const Transform &p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_ortogonal, InstanceBase **p_cull_result, int p_cull_count, RID *p_light_cull_result, int p_light_cull_count, RID *p_reflection_probe_cull_result, int p_reflection_probe_cull_count, RID p_environment, RID p_shadow_atlas, RID p_reflection_atlas, RID p_reflection_probe, int p_reflection_probe_pass) {}
+	void render_shadow(RID p_light, RID p_shadow_atlas, int p_pass, InstanceBase **p_cull_result, int p_cull_count) {}
+
+	void set_scene_pass(uint64_t p_pass) {}
+	void set_debug_draw_mode(VS::ViewportDebugDraw p_debug_draw) {}
+
+	bool free(RID p_rid);
+
+	RasterizerSceneDummy() {}
+	~RasterizerSceneDummy() {}
+};
+
+class RasterizerStorageDummy : public RasterizerStorage {
+public:
+	struct Instantiable : public RID_Data {
+
+		SelfList<RasterizerScene::InstanceBase>::List instance_list;
+
+		_FORCE_INLINE_ void instance_change_notify() {
+
+			SelfList<RasterizerScene::InstanceBase> *instances = instance_list.first();
+			while (instances) {
+
+				instances->self()->base_changed();
+				instances = instances->next();
+			}
+		}
+
+		_FORCE_INLINE_ void instance_remove_deps() {
+
+			SelfList<RasterizerScene::InstanceBase> *instances = instance_list.first();
+			while (instances) {
+
+				SelfList<RasterizerScene::InstanceBase> *next = instances->next();
+				instances->self()->base_removed();
+				instances = next;
+			}
+		}
+
+		Instantiable() {}
+		virtual ~Instantiable() {}
+	};
+
+	/* TEXTURE API */
+
+	// Only the metadata is kept, image data is dropped on upload.
+	struct Texture : public RID_Data {
+
+		int width, height;
+		uint32_t flags;
+		Image::Format format;
+		String path;
+
+		Texture *proxy;
+		Set<Texture *> proxy_owners;
+
+		Texture() {
+			width = 0;
+			height = 0;
+			flags = 0;
+			format = Image::FORMAT_RGBA8;
+			proxy = NULL;
+		}
+
+		~Texture() {
+
+			if (proxy) {
+				proxy->proxy_owners.erase(this);
+			}
+			for (Set<Texture *>::Element *E = proxy_owners.front(); E; E = E->next()) {
+				E->get()->proxy = NULL;
+			}
+		}
+	};
+
+	mutable RID_Owner<Texture> texture_owner;
+
+	RID texture_create();
+	void texture_allocate(RID p_texture, int p_width, int p_height, Image::Format p_format, uint32_t p_flags = VS::TEXTURE_FLAGS_DEFAULT);
+	void texture_set_data(RID p_texture, const Ref<Image> &p_image, VS::CubeMapSide p_cube_side = VS::CUBEMAP_LEFT);
+	Ref<Image> texture_get_data(RID p_texture, VS::CubeMapSide p_cube_side = VS::CUBEMAP_LEFT) const;
+	void texture_set_flags(RID p_texture, uint32_t p_flags);
+	uint32_t texture_get_flags(RID p_texture) const;
+	Image::Format texture_get_format(RID p_texture) const;
+	uint32_t texture_get_texid(RID p_texture) const { return 0; }
+	uint32_t texture_get_width(RID p_texture) const;
+	uint32_t texture_get_height(RID p_texture) const;
+	void texture_set_size_override(RID p_texture, int p_width, int p_height);
+
+	void texture_set_path(RID p_texture, const String &p_path);
+	String texture_get_path(RID p_texture) const;
+
+	void texture_set_shrink_all_x2_on_set_data(bool p_enable) {}
+
+	void texture_debug_usage(List<VS::TextureInfo> *r_info);
+
+	RID texture_create_radiance_cubemap(RID p_source, int p_resolution = -1) const { return RID(); }
+
+	void texture_set_detect_3d_callback(RID p_texture, VisualServer::TextureDetectCallback p_callback, void *p_userdata) {}
+	void texture_set_detect_srgb_callback(RID p_texture, VisualServer::TextureDetectCallback p_callback, void *p_userdata) {}
+	void texture_set_detect_normal_callback(RID p_texture, VisualServer::TextureDetectCallback p_callback, void *p_userdata) {}
+
+	void textures_keep_original(bool p_enable) {}
+
+	void texture_set_proxy(RID p_proxy, RID p_base);
+
+	/* SKY API */
+
+	RID sky_create() { return RID(); }
+	void sky_set_texture(RID p_sky, RID p_cube_map, int p_radiance_size) {}
+
+	/* SHADER API */
+
+	struct Shader : public RID_Data {
+
+		String code;
+		Map<StringName, RID> default_textures;
+	};
+
+	mutable RID_Owner<Shader> shader_owner;
+
+	RID shader_create();
+
+	void shader_set_code(RID p_shader, const String &p_code);
+	String shader_get_code(RID p_shader) const;
+	void shader_get_param_list(RID p_shader, List<PropertyInfo> *p_param_list) const {}
+
+	void shader_set_default_texture_param(RID p_shader, const StringName &p_name, RID p_texture);
+	RID shader_get_default_texture_param(RID p_shader, const StringName &p_name) const;
+
+	/* COMMON MATERIAL API */
+
+	struct Material : public RID_Data {
+
+		RID shader;
+		RID next_pass;
+		Map<StringName, Variant> params;
+	};
+
+	mutable RID_Owner<Material> material_owner;
+
+	RID material_create();
+
+	void material_set_render_priority(RID p_material, int priority) {}
+	void material_set_shader(RID p_shader_material, RID p_shader);
+	RID material_get_shader(RID p_shader_material) const;
+
+	void material_set_param(RID p_material, const StringName &p_param, const Variant &p_value);
+	Variant material_get_param(RID p_material, const StringName &p_param) const;
+
+	void material_set_line_width(RID p_material, float p_width) {}
+
+	void material_set_next_pass(RID p_material, RID p_next_material);
+
+	bool material_is_animated(RID p_material) { return false; }
+	bool material_casts_shadows(RID p_material) { return false; }
+
+	void material_add_instance_owner(RID p_material, RasterizerScene::InstanceBase *p_instance) {}
+	void material_remove_instance_owner(RID p_material, RasterizerScene::InstanceBase *p_instance) {}
+
+	/* MESH API */
+
+	// Surface arrays are kept (they are shared, not copied) because collision
+	// and navigation generation read them back through the server.
+	struct Surface {
+
+		uint32_t format;
+		VS::PrimitiveType primitive;
+		PoolVector<uint8_t> array;
+		int array_len;
+		PoolVector<uint8_t> index_array;
+		int index_array_len;
+		AABB aabb;
+		Vector<PoolVector<uint8_t> > blend_shapes;
+		Vector<AABB> skeleton_aabb;
+		RID material;
+	};
+
+	struct Mesh : public Instantiable {
+
+		Vector<Surface> surfaces;
+		int blend_shape_count;
+		VS::BlendShapeMode blend_shape_mode;
+		AABB custom_aabb;
+
+		Mesh() {
+			blend_shape_count = 0;
+			blend_shape_mode = VS::BLEND_SHAPE_MODE_NORMALIZED;
+		}
+	};
+
+	mutable RID_Owner<Mesh> mesh_owner;
+
+	RID mesh_create();
+
+	void mesh_add_surface(RID p_mesh, uint32_t p_format, VS::PrimitiveType p_primitive, const PoolVector<uint8_t> &p_array, int p_vertex_count, const PoolVector<uint8_t> &p_index_array, int p_index_count, const AABB &p_aabb, const Vector<PoolVector<uint8_t> > &p_blend_shapes = Vector<PoolVector<uint8_t> >(), const Vector<AABB> &p_bone_aabbs = Vector<AABB>());
+
+	void mesh_set_blend_shape_count(RID p_mesh, int p_amount);
+	int mesh_get_blend_shape_count(RID p_mesh) const;
+
+	void mesh_set_blend_shape_mode(RID p_mesh, VS::BlendShapeMode p_mode);
+	VS::BlendShapeMode mesh_get_blend_shape_mode(RID p_mesh) const;
+
+	void mesh_surface_update_region(RID p_mesh, int p_surface, int p_offset, const PoolVector<uint8_t> &p_data);
+
+	void mesh_surface_set_material(RID p_mesh, int p_surface, RID p_material);
+	RID mesh_surface_get_material(RID p_mesh, int p_surface) const;
+
+	int mesh_surface_get_array_len(RID p_mesh, int p_surface) const;
+	int mesh_surface_get_array_index_len(RID p_mesh, int p_surface) const;
+
+	PoolVector<uint8_t> mesh_surface_get_array(RID p_mesh, int p_surface) const;
+	PoolVector<uint8_t> mesh_surface_get_index_array(RID p_mesh, int p_surface) const;
+
+	uint32_t mesh_surface_get_format(RID p_mesh, int p_surface) const;
+	VS::PrimitiveType mesh_surface_get_primitive_type(RID p_mesh, int p_surface) const;
+
+	AABB mesh_surface_get_aabb(RID p_mesh, int p_surface) const;
+	Vector<PoolVector<uint8_t> > mesh_surface_get_blend_shapes(RID p_mesh, int p_surface) const;
+	Vector<AABB> mesh_surface_get_skeleton_aabb(RID p_mesh, int p_surface) const;
+
+	void mesh_remove_surface(RID p_mesh, int p_index);
+	int mesh_get_surface_count(RID p_mesh) const;
+
+	void mesh_set_custom_aabb(RID p_mesh, const AABB &p_aabb);
+	AABB mesh_get_custom_aabb(RID p_mesh) const;
+
+	AABB mesh_get_aabb(RID p_mesh, RID p_skeleton) const;
+	void mesh_clear(RID p_mesh);
+
+	/* MULTIMESH API */
+
+	struct MultiMesh : public Instantiable {
+
+		RID mesh;
+		int size;
+		VS::MultimeshTransformFormat transform_format;
+		VS::MultimeshColorFormat color_format;
+		Vector<Transform> transforms;
+		Vector<Color> colors;
+		int visible_instances;
+
+		MultiMesh() {
+			size = 0;
+			transform_format = VS::MULTIMESH_TRANSFORM_3D;
+			color_format = VS::MULTIMESH_COLOR_NONE;
+			visible_instances = -1;
+		}
+	};
+
+	mutable RID_Owner<MultiMesh> multimesh_owner;
+
+	RID multimesh_create();
+
+	void multimesh_allocate(RID p_multimesh, int p_instances, VS::MultimeshTransformFormat p_transform_format, VS::MultimeshColorFormat p_color_format);
+	int multimesh_get_instance_count(RID p_multimesh) const;
+
+	void multimesh_set_mesh(RID p_multimesh, RID p_mesh);
+	void multimesh_instance_set_transform(RID p_multimesh, int p_index, const Transform &p_transform);
+	void multimesh_instance_set_transform_2d(RID p_multimesh, int p_index, const Transform2D &p_transform);
+	void multimesh_instance_set_color(RID p_multimesh, int p_index, const Color &p_color);
+	void multimesh_set_as_bulk_array(RID p_multimesh, const PoolVector<float> &p_array);
+
+	RID multimesh_get_mesh(RID p_multimesh) const;
+
+	Transform multimesh_instance_get_transform(RID p_multimesh, int p_index) const;
+	Transform2D multimesh_instance_get_transform_2d(RID p_multimesh, int p_index) const;
+	Color multimesh_instance_get_color(RID p_multimesh, int p_index) const;
+
+	void multimesh_set_visible_instances(RID p_multimesh, int p_visible);
+	int multimesh_get_visible_instances(RID p_multimesh) const;
+
+	AABB multimesh_get_aabb(RID p_multimesh) const;
+
+	/* IMMEDIATE API */
+
+	struct Immediate : public Instantiable {
+
+		RID material;
+	};
+
+	mutable RID_Owner<Immediate> immediate_owner;
+
+	RID immediate_create();
+	void immediate_begin(RID p_immediate, VS::PrimitiveType p_rimitive, RID p_texture = RID()) {}
+	void immediate_vertex(RID p_immediate, const Vector3 &p_vertex) {}
+	void immediate_normal(RID p_immediate, const Vector3 &p_normal) {}
+	void immediate_tangent(RID p_immediate, const Plane &p_tangent) {}
+	void immediate_color(RID p_immediate, const Color &p_color) {}
+	void immediate_uv(RID p_immediate, const Vector2 &tex_uv) {}
+	void immediate_uv2(RID p_immediate, const Vector2 &tex_uv) {}
+	void immediate_end(RID p_immediate) {}
+	void immediate_clear(RID p_immediate) {}
+	void immediate_set_material(RID p_immediate, RID p_material);
+	RID immediate_get_material(RID p_immediate) const;
+	AABB immediate_get_aabb(RID p_immediate) const { return AABB(); }
+
+	/* SKELETON API */
+
+	struct Skeleton : public RID_Data {
+
+		int size;
+		bool use_2d;
+
+		Skeleton() {
+			size = 0;
+			use_2d = false;
+		}
+	};
+
+	mutable RID_Owner<Skeleton> skeleton_owner;
+
+	RID skeleton_create();
+	void skeleton_allocate(RID p_skeleton, int p_bones, bool p_2d_skeleton = false);
+	int skeleton_get_bone_count(RID p_skeleton) const;
+	void skeleton_bone_set_transform(RID p_skeleton, int p_bone, const Transform &p_transform) {}
+	Transform skeleton_bone_get_transform(RID p_skeleton, int p_bone) const { return Transform(); }
+	void skeleton_bone_set_transform_2d(RID p_skeleton, int p_bone, const Transform2D &p_transform) {}
+	Transform2D skeleton_bone_get_transform_2d(RID p_skeleton, int p_bone) const { return Transform2D(); }
+
+	/* Light API */
+
+	struct Light : public Instantiable {
+
+		VS::LightType type;
+		float param[VS::LIGHT_PARAM_MAX];
+		Color color;
+		bool shadow;
+		uint32_t cull_mask;
+		VS::LightOmniShadowMode omni_shadow_mode;
+		VS::LightDirectionalShadowMode directional_shadow_mode;
+		VS::LightDirectionalShadowDepthRangeMode directional_range_mode;
+		bool directional_blend_splits;
+		uint64_t version;
+	};
+
+	mutable RID_Owner<Light> light_owner;
+
+	RID light_create(VS::LightType p_type);
+
+	void light_set_color(RID p_light, const Color &p_color);
+	void light_set_param(RID p_light, VS::LightParam p_param, float p_value);
+	void light_set_shadow(RID p_light, bool p_enabled);
+	void light_set_shadow_color(RID p_light, const Color &p_color) {}
+	void light_set_projector(RID p_light, RID p_texture) {}
+	void light_set_negative(RID p_light, bool p_enable) {}
+	void light_set_cull_mask(RID p_light, uint32_t p_mask);
+	void light_set_reverse_cull_face_mode(RID p_light, bool p_enabled) {}
+
+	void light_omni_set_shadow_mode(RID p_light, VS::LightOmniShadowMode p_mode);
+	void light_omni_set_shadow_detail(RID p_light, VS::LightOmniShadowDetail p_detail) {}
+
+	void light_directional_set_shadow_mode(RID p_light, VS::LightDirectionalShadowMode p_mode);
+	void light_directional_set_blend_splits(RID p_light, bool p_enable);
+	bool light_directional_get_blend_splits(RID p_light) const;
+	void light_directional_set_shadow_depth_range_mode(RID p_light, VS::LightDirectionalShadowDepthRangeMode p_range_mode);
+	VS::LightDirectionalShadowDepthRangeMode light_directional_get_shadow_depth_range_mode(RID p_light) const;
+
+	VS::LightDirectionalShadowMode light_directional_get_shadow_mode(RID p_light);
+	VS::LightOmniShadowMode light_omni_get_shadow_mode(RID p_light);
+
+	bool light_has_shadow(RID p_light) const;
+
+	VS::LightType light_get_type(RID p_light) const;
+	AABB light_get_aabb(RID p_light) const;
+	float light_get_param(RID p_light, VS::LightParam p_param);
+	Color light_get_color(RID p_light);
+	uint64_t light_get_version(RID p_light) const;
+
+	/* PROBE API */
+
+	struct ReflectionProbe : public Instantiable {
+
+		VS::ReflectionProbeUpdateMode update_mode;
+		float max_distance;
+		Vector3 extents;
+		Vector3 origin_offset;
+		bool enable_shadows;
+		uint32_t cull_mask;
+	};
+
+	mutable RID_Owner<ReflectionProbe> reflection_probe_owner;
+
+	RID reflection_probe_create();
+
+	void reflection_probe_set_update_mode(RID p_probe, VS::ReflectionProbeUpdateMode p_mode);
+	void reflection_probe_set_intensity(RID p_probe, float p_intensity) {}
+	void reflection_probe_set_interior_ambient(RID p_probe, const Color &p_ambient) {}
+	void reflection_probe_set_interior_ambient_energy(RID p_probe, float p_energy) {}
+	void reflection_probe_set_interior_ambient_probe_contribution(RID p_probe, float p_contrib) {}
+	void reflection_probe_set_max_distance(RID p_probe, float p_distance);
+	void reflection_probe_set_extents(RID p_probe, const Vector3 &p_extents);
+	void reflection_probe_set_origin_offset(RID p_probe, const Vector3 &p_offset);
+	void reflection_probe_set_as_interior(RID p_probe, bool p_enable) {}
+	void reflection_probe_set_enable_box_projection(RID p_probe, bool p_enable) {}
+	void reflection_probe_set_enable_shadows(RID p_probe, bool p_enable);
+	void reflection_probe_set_cull_mask(RID p_probe, uint32_t p_layers);
+
+	AABB reflection_probe_get_aabb(RID p_probe) const;
+	VS::ReflectionProbeUpdateMode reflection_probe_get_update_mode(RID p_probe) const;
+	uint32_t reflection_probe_get_cull_mask(RID p_probe) const;
+	Vector3 reflection_probe_get_extents(RID p_probe) const;
+	Vector3 reflection_probe_get_origin_offset(RID p_probe) const;
+	float reflection_probe_get_origin_max_distance(RID p_probe) const;
+	bool reflection_probe_renders_shadows(RID p_probe) const;
+
+	void instance_add_skeleton(RID p_skeleton, RasterizerScene::InstanceBase *p_instance) {}
+	void instance_remove_skeleton(RID p_skeleton, RasterizerScene::InstanceBase *p_instance) {}
+
+	void instance_add_dependency(RID p_base, RasterizerScene::InstanceBase *p_instance);
+	void instance_remove_dependency(RID p_base, RasterizerScene::InstanceBase *p_instance);
+
+	/* GI PROBE API */
+
+	struct GIProbe : public Instantiable {
+
+		AABB bounds;
+		Transform to_cell;
+		float cell_size;
+		int dynamic_range;
+		float energy;
+		float bias;
+		float normal_bias;
+		float propagation;
+		bool interior;
+		bool compress;
+		uint32_t version;
+		PoolVector<int> dynamic_data;
+	};
+
+	mutable RID_Owner<GIProbe> gi_probe_owner;
+
+	RID gi_probe_create();
+
+	void gi_probe_set_bounds(RID p_probe, const AABB &p_bounds);
+	AABB gi_probe_get_bounds(RID p_probe) const;
+
+	void gi_probe_set_cell_size(RID p_probe, float p_size);
+	float gi_probe_get_cell_size(RID p_probe) const;
+
+	void gi_probe_set_to_cell_xform(RID p_probe, const Transform &p_xform);
+	Transform gi_probe_get_to_cell_xform(RID p_probe) const;
+
+	void gi_probe_set_dynamic_data(RID p_probe, const PoolVector<int> &p_data);
+	PoolVector<int> gi_probe_get_dynamic_data(RID p_probe) const;
+
+	void gi_probe_set_dynamic_range(RID p_probe, int p_range);
+	int gi_probe_get_dynamic_range(RID p_probe) const;
+
+	void gi_probe_set_energy(RID p_probe, float p_range);
+	float gi_probe_get_energy(RID p_probe) const;
+
+	void gi_probe_set_bias(RID p_probe, float p_range);
+	float gi_probe_get_bias(RID p_probe) const;
+
+	void gi_probe_set_normal_bias(RID p_probe, float p_range);
+	float gi_probe_get_normal_bias(RID p_probe) const;
+
+	void gi_probe_set_propagation(RID p_probe, float p_range);
+	float gi_probe_get_propagation(RID p_probe) const;
+
+	void gi_probe_set_interior(RID p_probe, bool p_enable);
+	bool gi_probe_is_interior(RID p_probe) const;
+
+	void gi_probe_set_compress(RID p_probe, bool p_enable);
+	bool gi_probe_is_compressed(RID p_probe) const;
+
+	uint32_t gi_probe_get_version(RID p_probe);
+
+	GIProbeCompression gi_probe_get_dynamic_data_get_preferred_compression() const { return GI_PROBE_UNCOMPRESSED; }
+	RID gi_probe_dynamic_data_create(int p_width, int p_height, int p_depth, GIProbeCompression p_compression) { return RID(); }
+	void gi_probe_dynamic_data_update(RID p_gi_probe_data, int p_depth_slice, int p_slice_count, int p_mipmap, const void *p_data) {}
+
+	/* LIGHTMAP CAPTURE */
+
+	struct LightmapCapture : public Instantiable {
+
+		PoolVector<LightmapCaptureOctree> octree;
+		AABB bounds;
+		Transform cell_xform;
+		int cell_subdiv;
+		float energy;
+
+		LightmapCapture() {
+			energy = 1.0;
+			cell_subdiv = 1;
+		}
+	};
+
+	mutable RID_Owner<LightmapCapture> lightmap_capture_data_owner;
+
+	RID lightmap_capture_create();
+	void lightmap_capture_set_bounds(RID p_capture, const AABB &p_bounds);
+	AABB lightmap_capture_get_bounds(RID p_capture) const;
+	void lightmap_capture_set_octree(RID p_capture, const PoolVector<uint8_t> &p_octree);
+	PoolVector<uint8_t> lightmap_capture_get_octree(RID p_capture) const;
+	void lightmap_capture_set_octree_cell_transform(RID p_capture, const Transform &p_xform);
+	Transform lightmap_capture_get_octree_cell_transform(RID p_capture) const;
+	void lightmap_capture_set_octree_cell_subdiv(RID p_capture, int p_subdiv);
+	int lightmap_capture_get_octree_cell_subdiv(RID p_capture) const;
+	void lightmap_capture_set_energy(RID p_capture, float p_energy);
+	float lightmap_capture_get_energy(RID p_capture) const;
+	const PoolVector<LightmapCaptureOctree> *lightmap_capture_get_octree_ptr(RID p_capture) const;
+
+	/* PARTICLES */
+
+	struct Particles : public Instantiable {
+
+		bool emitting;
+		AABB custom_aabb;
+		Vector<RID> draw_passes;
+
+		Particles() {
+			emitting = false;
+			custom_aabb = AABB(Vector3(-4, -4, -4), Vector3(8, 8, 8));
+		}
+	};
+
+	mutable RID_Owner<Particles> particles_owner;
+
+	RID particles_create();
+
+	void particles_set_emitting(RID p_particles, bool p_emitting);
+	bool particles_get_emitting(RID p_particles);
+	void particles_set_amount(RID p_particles, int p_amount) {}
+	void particles_set_lifetime(RID p_particles, float p_lifetime) {}
+	void particles_set_one_shot(RID p_particles, bool p_one_shot) {}
+	void particles_set_pre_process_time(RID p_particles, float p_time) {}
+	void particles_set_explosiveness_ratio(RID p_particles, float p_ratio) {}
+	void particles_set_randomness_ratio(RID p_particles, float p_ratio) {}
+	void particles_set_custom_aabb(RID p_particles, const AABB &p_aabb);
+	void particles_set_speed_scale(RID p_particles, float p_scale) {}
+	void particles_set_use_local_coordinates(RID p_particles, bool p_enable) {}
+	void particles_set_process_material(RID p_particles, RID p_material) {}
+	void particles_set_fixed_fps(RID p_particles, int p_fps) {}
+	void particles_set_fractional_delta(RID p_particles, bool p_enable) {}
+	void particles_restart(RID p_particles) {}
+
+	void particles_set_draw_order(RID p_particles, VS::ParticlesDrawOrder p_order) {}
+
+	void particles_set_draw_passes(RID p_particles, int p_count);
+	void particles_set_draw_pass_mesh(RID p_particles, int p_pass, RID p_mesh);
+
+	void particles_request_process(RID p_particles) {}
+	AABB particles_get_current_aabb(RID p_particles);
+	AABB particles_get_aabb(RID p_particles) const;
+
+	void particles_set_emission_transform(RID p_particles, const Transform &p_transform) {}
+
+	int particles_get_draw_passes(RID p_particles) const;
+	RID particles_get_draw_pass_mesh(RID p_particles, int p_pass) const;
+
+	/* RENDER TARGET */
+
+	struct RenderTarget : public RID_Data {
+
+		RID texture;
+		bool used;
+	};
+
+	mutable RID_Owner<RenderTarget> render_target_owner;
+
+	RID render_target_create();
+	void render_target_set_size(RID p_render_target, int p_width, int p_height);
+	RID render_target_get_texture(RID p_render_target) const;
+	void render_target_set_flag(RID p_render_target, RenderTargetFlags p_flag, bool p_value) {}
+	bool render_target_was_used(RID p_render_target);
+	void render_target_clear_used(RID p_render_target);
+	void render_target_set_msaa(RID p_render_target, VS::ViewportMSAA p_msaa) {}
+
+	/* CANVAS SHADOW */
+
+	RID canvas_light_shadow_buffer_create(int p_width) { return RID(); }
+
+	/* LIGHT SHADOW MAPPING */
+
+	struct CanvasOccluder : public RID_Data {
+
+		PoolVector<Vector2> lines;
+	};
+
+	mutable RID_Owner<CanvasOccluder> canvas_occluder_owner;
+
+	RID canvas_light_occluder_create();
+	void canvas_light_occluder_set_polylines(RID p_occluder, const PoolVector<Vector2> &p_lines);
+
+	VS::InstanceType get_base_type(RID p_rid) const;
+
+	bool free(RID p_rid);
+
+	bool has_os_feature(const String &p_feature) const { return false; }
+
+	void update_dirty_resources() {}
+
+	void set_debug_generate_wireframes(bool p_generate) {}
+
+	void render_info_begin_capture() {}
+	void render_info_end_capture() {}
+	int get_captured_render_info(VS::RenderInfo p_info) { return 0; }
+
+	int get_render_info(VS::RenderInfo p_info) { return 0; }
+
+	RasterizerStorageDummy() {}
+	~RasterizerStorageDummy() {}
+};
+
+class RasterizerCanvasDummy : public RasterizerCanvas {
+public:
+	RID light_internal_create() { return RID(); }
+	void light_internal_update(RID p_rid, Light *p_light) {}
+	void light_internal_free(RID p_rid) {}
+
+	void canvas_begin() {}
+	void canvas_end() {}
+
+	void canvas_render_items(Item *p_item_list, int p_z, const Color &p_modulate, Light *p_light) {}
+	void canvas_debug_viewport_shadows(Light *p_lights_with_shadow) {}
+
+	void canvas_light_shadow_buffer_update(RID p_buffer, const Transform2D &p_light_xform, int p_light_mask, float p_near, float p_far, LightOccluderInstance *p_occluders, CameraMatrix *p_xform_cache) {}
+
+	void reset_canvas() {}
+
+	void draw_window_margins(int *p_margins, RID *p_margin_textures) {}
+
+	RasterizerCanvasDummy() {}
+	~RasterizerCanvasDummy() {}
+};
+
+class RasterizerDummy : public Rasterizer {
+
+	static Rasterizer *_create_current();
+
+	RasterizerStorageDummy *storage;
+	RasterizerCanvasDummy *canvas;
+	RasterizerSceneDummy *scene;
+
+public:
+	virtual RasterizerStorage *get_storage();
+	virtual RasterizerCanvas *get_canvas();
+	virtual RasterizerScene *get_scene();
+
+	virtual void set_boot_image(const Ref<Image> &p_image, const Color &p_color, bool p_scale) {}
+
+	virtual void initialize() {}
+	virtual void begin_frame() {}
+	virtual void set_current_render_target(RID p_render_target) {}
+	virtual void restore_render_target() {}
+	virtual void clear_render_target(const Color &p_color) {}
+	virtual void blit_render_target_to_screen(RID p_render_target, const Rect2 &p_screen_rect, int p_screen = 0) {}
+	virtual void end_frame(bool p_swap_buffers) {}
+	virtual void finalize() {}
+
+	static void make_current();
+
+	RasterizerDummy();
+	~RasterizerDummy();
+};
+
+#endif // RASTERIZER_DUMMY_H
@@ -36,8 +36,11 @@
 #include <pthread_np.h>
 #endif
 
+#include "core/dvector.h"
+#include "core/message_queue.h"
 #include "core/safe_refcount.h"
 #include "os/memory.h"
+#include "os/slab_allocator.h"
 
 static pthread_key_t _create_thread_id_key() {
 	pthread_key_t key;
@@ -69,6 +72,9 @@ void *ThreadPosix::thread_callback(void *userdata) {
 	t->callback(t->user);
 
 	ScriptServer::thread_exit();
+	MessageQueue::release_thread_buffer();
+	MemoryPool::release_thread_cache();
+	SlabAllocator::release_thread_cache();
 
 	return NULL;
 }
@@ -31,7 +31,10 @@
 
 #if defined(WINDOWS_ENABLED) && !defined(UWP_ENABLED)
 
+#include "dvector.h"
+#include "message_queue.h"
 #include "os/memory.h"
+#include "os/slab_allocator.h"
 
 Thread::ID ThreadWindows::get_id() const {
 
@@ -53,6 +56,9 @@ DWORD ThreadWindows::thread_callback(LPVOID userdata) {
 	t->callback(t->user);
 
 	ScriptServer::thread_exit();
+	MessageQueue::release_thread_buffer();
+	MemoryPool::release_thread_cache();
+	SlabAllocator::release_thread_cache();
 
 	return 0;
 }
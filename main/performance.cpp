@@ -30,6 +30,8 @@
 #include "performance.h"
 #include "message_queue.h"
 #include "os/os.h"
+#include "os/slab_allocator.h"
+#include "scene/main/scene_pool.h"
 #include "scene/main/scene_tree.h"
 #include "servers/physics_2d_server.h"
 #include "servers/physics_server.h"
@@ -67,6 +69,11 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(PHYSICS_3D_ACTIVE_OBJECTS);
 	BIND_ENUM_CONSTANT(PHYSICS_3D_COLLISION_PAIRS);
 	BIND_ENUM_CONSTANT(PHYSICS_3D_ISLAND_COUNT);
+	BIND_ENUM_CONSTANT(OBJECT_POOLED_NODE_COUNT);
+	BIND_ENUM_CONSTANT(OBJECT_POOL_IN_USE_COUNT);
+	BIND_ENUM_CONSTANT(MEMORY_SLAB_RESERVED);
+	BIND_ENUM_CONSTANT(MEMORY_SLAB_FREE);
+	BIND_ENUM_CONSTANT(OBJECT_STRING_NAME_COUNT);
 
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
@@ -103,6 +110,11 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		"physics_3d/active_objects",
 		"physics_3d/collision_pairs",
 		"physics_3d/islands",
+		"object/pooled_nodes",
+		"object/pool_in_use",
+		"memory/slab_reserved",
+		"memory/slab_free",
+		"object/string_names",
 
 	};
 
@@ -146,6 +158,11 @@ float Performance::get_monitor(Monitor p_monitor) const {
 		case PHYSICS_3D_ACTIVE_OBJECTS: return PhysicsServer::get_singleton()->get_process_info(PhysicsServer::INFO_ACTIVE_OBJECTS);
 		case PHYSICS_3D_COLLISION_PAIRS: return PhysicsServer::get_singleton()->get_process_info(PhysicsServer::INFO_COLLISION_PAIRS);
 		case PHYSICS_3D_ISLAND_COUNT: return PhysicsServer::get_singleton()->get_process_info(PhysicsServer::INFO_ISLAND_COUNT);
+		case OBJECT_POOLED_NODE_COUNT: return ScenePool::get_singleton()->get_available_count();
+		case OBJECT_POOL_IN_USE_COUNT: return ScenePool::get_singleton()->get_in_use_count();
+		case MEMORY_SLAB_RESERVED: return SlabAllocator::get_reserved_memory();
+		case MEMORY_SLAB_FREE: return SlabAllocator::get_free_memory();
+		case OBJECT_STRING_NAME_COUNT: return StringName::get_name_count();
 
 		default: {}
 	}
@@ -185,6 +202,11 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_QUANTITY,
 
 	};
 
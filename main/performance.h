@@ -75,6 +75,11 @@ public:
 		PHYSICS_3D_ACTIVE_OBJECTS,
 		PHYSICS_3D_COLLISION_PAIRS,
 		PHYSICS_3D_ISLAND_COUNT,
+		OBJECT_POOLED_NODE_COUNT,
+		OBJECT_POOL_IN_USE_COUNT,
+		MEMORY_SLAB_RESERVED,
+		MEMORY_SLAB_FREE,
+		OBJECT_STRING_NAME_COUNT,
 		//physics
 		MONITOR_MAX
 	};
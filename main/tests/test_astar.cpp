@@ -0,0 +1,244 @@
+/*************************************************************************/
+/*  test_astar.cpp                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_astar.h"
+
+#include "core/math/a_star.h"
+#include "core/math/math_funcs.h"
+#include "core/os/os.h"
+
+namespace TestAStar {
+
+enum {
+	GRID_WIDTH = 250,
+	GRID_HEIGHT = 200,
+	QUERIES = 200,
+};
+
+static int grid_id(int p_x, int p_y) {
+
+	return p_y * GRID_WIDTH + p_x + 1;
+}
+
+static void build_grid(AStar *p_astar) {
+
+	for (int y = 0; y < GRID_HEIGHT; y++) {
+		for (int x = 0; x < GRID_WIDTH; x++) {
+			p_astar->add_point(grid_id(x, y), Vector3(x, 0, y));
+		}
+	}
+
+	for (int y = 0; y < GRID_HEIGHT; y++) {
+		for (int x = 0; x < GRID_WIDTH; x++) {
+			if (x + 1 < GRID_WIDTH)
+				p_astar->connect_points(grid_id(x, y), grid_id(x + 1, y));
+			if (y + 1 < GRID_HEIGHT)
+				p_astar->connect_points(grid_id(x, y), grid_id(x, y + 1));
+		}
+	}
+}
+
+static bool test_small_graph() {
+
+	Ref<AStar> a;
+	a.instance();
+
+	a->add_point(1, Vector3(0, 0, 0));
+	a->add_point(2, Vector3(1, 0, 0));
+	a->add_point(3, Vector3(2, 0, 0));
+	a->add_point(4, Vector3(1, 5, 0));
+	a->connect_points(1, 2);
+	a->connect_points(2, 3);
+	a->connect_points(1, 4);
+	a->connect_points(4, 3, false);
+
+	PoolVector<int> path = a->get_id_path(1, 3);
+	if (path.size() != 3 || path[0] != 1 || path[1] != 2 || path[2] != 3) {
+		OS::get_singleton()->print("\tFAIL: shortest path 1 -> 3\n");
+		return false;
+	}
+
+	// One way connection, 3 can't go back through 4.
+	a->remove_point(2);
+	if (a->get_id_path(1, 3).size() != 3 || a->get_id_path(3, 1).size() != 0) {
+		OS::get_singleton()->print("\tFAIL: one way path after removal\n");
+		return false;
+	}
+
+	if (a->has_point(2) || a->are_points_connected(1, 2) || !a->are_points_connected(3, 4)) {
+		OS::get_singleton()->print("\tFAIL: connections after removal\n");
+		return false;
+	}
+
+	if (a->get_closest_point(Vector3(1.9, 0, 0)) != 3 || a->get_available_point_id() != 5) {
+		OS::get_singleton()->print("\tFAIL: closest point after removal\n");
+		return false;
+	}
+
+	Vector3 p = a->get_closest_position_in_segment(Vector3(0.5, 1, 0));
+	if (p.distance_to(Vector3(5.5 / 26.0, 27.5 / 26.0, 0)) > 0.001) {
+		OS::get_singleton()->print("\tFAIL: closest position in segment\n");
+		return false;
+	}
+
+	a->add_point(10, Vector3(10, 0, 0));
+	bool id_after_add = a->get_available_point_id() == 11;
+	a->remove_point(10);
+	if (!id_after_add || a->get_available_point_id() != 5) {
+		OS::get_singleton()->print("\tFAIL: available point id\n");
+		return false;
+	}
+
+	return true;
+}
+
+static bool test_grid() {
+
+	Ref<AStar> a;
+	a.instance();
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	build_grid(a.ptr());
+	OS::get_singleton()->print("\tbuilt %d points in %f ms\n", GRID_WIDTH * GRID_HEIGHT, (OS::get_singleton()->get_ticks_usec() - t) / 1000.0);
+
+	// Corner to corner on a grid is a Manhattan walk.
+	t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < QUERIES; i++) {
+
+		int x0 = Math::rand() % GRID_WIDTH;
+		int y0 = Math::rand() % GRID_HEIGHT;
+		int x1 = Math::rand() % GRID_WIDTH;
+		int y1 = Math::rand() % GRID_HEIGHT;
+
+		PoolVector<int> path = a->get_id_path(grid_id(x0, y0), grid_id(x1, y1));
+		if (path.size() != ABS(x1 - x0) + ABS(y1 - y0) + 1) {
+			OS::get_singleton()->print("\tFAIL: path length %d, expected %d\n", path.size(), ABS(x1 - x0) + ABS(y1 - y0) + 1);
+			return false;
+		}
+	}
+	OS::get_singleton()->print("\t%d paths in %f ms\n", QUERIES, (OS::get_singleton()->get_ticks_usec() - t) / 1000.0);
+
+	t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < QUERIES * 10; i++) {
+
+		Vector3 pos(Math::random(-10.0, GRID_WIDTH + 10.0), Math::random(-5.0, 5.0), Math::random(-10.0, GRID_HEIGHT + 10.0));
+		int closest = a->get_closest_point(pos);
+		Vector3 expected(CLAMP(Math::round(pos.x), 0, GRID_WIDTH - 1), 0, CLAMP(Math::round(pos.z), 0, GRID_HEIGHT - 1));
+
+		if (pos.distance_squared_to(a->get_point_position(closest)) > pos.distance_squared_to(expected) + CMP_EPSILON) {
+			OS::get_singleton()->print("\tFAIL: closest point to %s\n", String(pos).utf8().get_data());
+			return false;
+		}
+	}
+	OS::get_singleton()->print("\t%d closest point queries in %f ms\n", QUERIES * 10, (OS::get_singleton()->get_ticks_usec() - t) / 1000.0);
+
+	// Removing points moves others around in storage, paths must stay valid.
+	for (int x = 1; x < GRID_WIDTH - 1; x++) {
+		a->remove_point(grid_id(x, GRID_HEIGHT / 2));
+	}
+
+	PoolVector<int> path = a->get_id_path(grid_id(GRID_WIDTH / 2, 0), grid_id(GRID_WIDTH / 2, GRID_HEIGHT - 1));
+	if (path.size() != GRID_HEIGHT + GRID_WIDTH - 2) {
+		OS::get_singleton()->print("\tFAIL: detour length %d, expected %d\n", path.size(), GRID_HEIGHT + GRID_WIDTH - 2);
+		return false;
+	}
+
+	return true;
+}
+
+static bool test_batch() {
+
+	Ref<AStar> a;
+	a.instance();
+	build_grid(a.ptr());
+
+	PoolVector<int> from_to;
+	for (int i = 0; i < QUERIES; i++) {
+		from_to.push_back(grid_id(Math::rand() % GRID_WIDTH, Math::rand() % GRID_HEIGHT));
+		from_to.push_back(grid_id(Math::rand() % GRID_WIDTH, Math::rand() % GRID_HEIGHT));
+	}
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	Array paths = a->get_id_paths(from_to);
+	OS::get_singleton()->print("\t%d batched paths in %f ms\n", QUERIES, (OS::get_singleton()->get_ticks_usec() - t) / 1000.0);
+
+	if (paths.size() != QUERIES) {
+		OS::get_singleton()->print("\tFAIL: %d paths in batch, expected %d\n", paths.size(), QUERIES);
+		return false;
+	}
+
+	for (int i = 0; i < QUERIES; i++) {
+
+		PoolVector<int> batched = paths[i];
+		PoolVector<int> single = a->get_id_path(from_to[i * 2 + 0], from_to[i * 2 + 1]);
+		if (batched.size() != single.size() || batched[batched.size() - 1] != from_to[i * 2 + 1]) {
+			OS::get_singleton()->print("\tFAIL: batched path %d differs\n", i);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+typedef bool (*TestFunc)(void);
+
+TestFunc test_funcs[] = {
+
+	test_small_graph,
+	test_grid,
+	test_batch,
+	0
+};
+
+MainLoop *test() {
+
+	int count = 0;
+	int passed = 0;
+
+	while (true) {
+		if (!test_funcs[count])
+			break;
+		bool pass = test_funcs[count]();
+		if (pass)
+			passed++;
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+
+		count++;
+	}
+
+	OS::get_singleton()->print("\n\n\n");
+	OS::get_singleton()->print("*************\n");
+	OS::get_singleton()->print("***TOTALS!***\n");
+	OS::get_singleton()->print("*************\n");
+
+	OS::get_singleton()->print("Passed %i of %i tests\n", passed, count);
+
+	return NULL;
+}
+} // namespace TestAStar
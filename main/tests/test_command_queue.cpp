@@ -0,0 +1,374 @@
+/*************************************************************************/
+/*  test_command_queue.cpp                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_command_queue.h"
+
+#include "core/command_queue_mt.h"
+#include "core/math/transform.h"
+#include "core/os/mutex.h"
+#include "core/os/os.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
+
+namespace TestCommandQueue {
+
+enum {
+	PRODUCERS = 4,
+	COMMANDS_PER_PRODUCER = 50000,
+	BENCHMARK_COMMANDS = 200000,
+	LOCKED_QUEUE_SIZE = 4096,
+};
+
+class Receiver {
+public:
+	uint32_t next_seq[PRODUCERS];
+	uint32_t received;
+	bool in_order;
+	bool exit;
+
+	void add(int p_producer, uint32_t p_seq) {
+
+		if (next_seq[p_producer] != p_seq)
+			in_order = false;
+		next_seq[p_producer] = p_seq + 1;
+		received++;
+	}
+
+	// Big enough to make commands wrap around the end of the ring often.
+	void add_transform(int p_producer, uint32_t p_seq, const Transform &p_xform, const Transform &p_xform2) {
+
+		if (p_xform.origin.x != p_seq || p_xform2.origin.y != p_producer)
+			in_order = false;
+		add(p_producer, p_seq);
+	}
+
+	int get_sum(int p_a, int p_b) {
+
+		return p_a + p_b;
+	}
+
+	void nop() {
+	}
+
+	void quit() {
+
+		exit = true;
+	}
+
+	Receiver() {
+
+		for (int i = 0; i < PRODUCERS; i++) {
+			next_seq[i] = 0;
+		}
+		received = 0;
+		in_order = true;
+		exit = false;
+	}
+};
+
+// What the queue did before, for the benchmark: a mutex taken on every push and pop, a semaphore posted for every command.
+class LockedQueue {
+
+	Mutex *mutex;
+	Semaphore *sem;
+	Receiver *receivers[LOCKED_QUEUE_SIZE];
+	void (Receiver::*methods[LOCKED_QUEUE_SIZE])();
+	uint32_t read_pos;
+	uint32_t write_pos;
+
+public:
+	void push(Receiver *p_instance, void (Receiver::*p_method)()) {
+
+		mutex->lock();
+		while (write_pos - read_pos == LOCKED_QUEUE_SIZE) {
+			mutex->unlock();
+			OS::get_singleton()->delay_usec(1000);
+			mutex->lock();
+		}
+		receivers[write_pos % LOCKED_QUEUE_SIZE] = p_instance;
+		methods[write_pos % LOCKED_QUEUE_SIZE] = p_method;
+		write_pos++;
+		mutex->unlock();
+		sem->post();
+	}
+
+	void wait_and_flush_one() {
+
+		sem->wait();
+		mutex->lock();
+		Receiver *instance = receivers[read_pos % LOCKED_QUEUE_SIZE];
+		void (Receiver::*method)() = methods[read_pos % LOCKED_QUEUE_SIZE];
+		mutex->unlock();
+		(instance->*method)();
+		mutex->lock();
+		read_pos++;
+		mutex->unlock();
+	}
+
+	LockedQueue() {
+
+		mutex = Mutex::create();
+		sem = Semaphore::create();
+		read_pos = 0;
+		write_pos = 0;
+	}
+
+	~LockedQueue() {
+
+		memdelete(mutex);
+		memdelete(sem);
+	}
+};
+
+template <class Q>
+struct Context {
+
+	Q *queue;
+	Receiver receiver;
+	uint32_t producer_index;
+	int commands;
+	bool ok;
+};
+
+template <class Q>
+static void consumer_loop(void *p_context) {
+
+	Context<Q> *context = (Context<Q> *)p_context;
+	while (!context->receiver.exit) {
+		context->queue->wait_and_flush_one();
+	}
+}
+
+static void producer_loop(void *p_context) {
+
+	Context<CommandQueueMT> *context = (Context<CommandQueueMT> *)p_context;
+	int index = atomic_increment(&context->producer_index) - 1;
+
+	for (int i = 0; i < context->commands; i++) {
+
+		if (i % 3 == 0) {
+			context->queue->push(&context->receiver, &Receiver::add_transform, index, i, Transform(Basis(), Vector3(i, 0, 0)), Transform(Basis(), Vector3(0, index, 0)));
+		} else {
+			context->queue->push(&context->receiver, &Receiver::add, index, i);
+		}
+
+		if (i % 1000 == 0) {
+			int sum = 0;
+			context->queue->push_and_ret(&context->receiver, &Receiver::get_sum, i, index, &sum);
+			if (sum != i + index)
+				context->ok = false;
+		}
+	}
+}
+
+static void benchmark_producer_loop(void *p_context) {
+
+	Context<CommandQueueMT> *context = (Context<CommandQueueMT> *)p_context;
+	for (int i = 0; i < context->commands; i++) {
+		context->queue->push(&context->receiver, &Receiver::nop);
+	}
+}
+
+static void locked_benchmark_producer_loop(void *p_context) {
+
+	Context<LockedQueue> *context = (Context<LockedQueue> *)p_context;
+	for (int i = 0; i < context->commands; i++) {
+		context->queue->push(&context->receiver, &Receiver::nop);
+	}
+}
+
+static bool test_order() {
+
+	OS::get_singleton()->print("\n\nTest 1: Commands of %d producers\n", PRODUCERS);
+
+	Context<CommandQueueMT> context;
+	context.queue = memnew(CommandQueueMT(true));
+	context.producer_index = 0;
+	context.commands = COMMANDS_PER_PRODUCER;
+	context.ok = true;
+
+	Thread *consumer = Thread::create(consumer_loop<CommandQueueMT>, &context);
+
+	Thread *producers[PRODUCERS];
+	for (int i = 0; i < PRODUCERS; i++) {
+		producers[i] = Thread::create(producer_loop, &context);
+	}
+	for (int i = 0; i < PRODUCERS; i++) {
+		Thread::wait_to_finish(producers[i]);
+		memdelete(producers[i]);
+	}
+
+	context.queue->push(&context.receiver, &Receiver::quit);
+	Thread::wait_to_finish(consumer);
+	memdelete(consumer);
+	memdelete(context.queue);
+
+	OS::get_singleton()->print("\treceived %d of %d commands, %s\n", context.receiver.received, PRODUCERS * COMMANDS_PER_PRODUCER, context.receiver.in_order ? "in order" : "out of order");
+
+	return context.ok && context.receiver.in_order && context.receiver.received == PRODUCERS * COMMANDS_PER_PRODUCER;
+}
+
+static bool test_rets() {
+
+	OS::get_singleton()->print("\n\nTest 2: Coalesced rets\n");
+
+	Context<CommandQueueMT> context;
+	context.queue = memnew(CommandQueueMT(true));
+
+	Thread *consumer = Thread::create(consumer_loop<CommandQueueMT>, &context);
+
+	int sums[64];
+	for (int i = 0; i < 64; i++) {
+		sums[i] = -1;
+		context.queue->push_ret(&context.receiver, &Receiver::get_sum, i, 1000, &sums[i]);
+	}
+	context.queue->sync_rets();
+
+	bool ok = true;
+	for (int i = 0; i < 64; i++) {
+		ok = ok && sums[i] == i + 1000;
+	}
+
+	context.queue->push(&context.receiver, &Receiver::quit);
+	Thread::wait_to_finish(consumer);
+	memdelete(consumer);
+	memdelete(context.queue);
+
+	// Without a flushing thread, the producer flushes by itself.
+	CommandQueueMT *queue = memnew(CommandQueueMT(false));
+	Receiver receiver;
+	for (uint32_t i = 0; i < 20000; i++) {
+		queue->push(&receiver, &Receiver::add_transform, 0, i, Transform(Basis(), Vector3(i, 0, 0)), Transform());
+		if (i % 100 == 0)
+			queue->flush_all();
+	}
+	queue->flush_all();
+	memdelete(queue);
+
+	return ok && receiver.in_order && receiver.received == 20000;
+}
+
+static bool test_benchmark() {
+
+	OS::get_singleton()->print("\n\nTest 3: Commands per second, %d producers\n", PRODUCERS);
+
+	double rates[2];
+
+	for (int pass = 0; pass < 2; pass++) {
+
+		Context<CommandQueueMT> context;
+		Context<LockedQueue> locked_context;
+		context.commands = BENCHMARK_COMMANDS / PRODUCERS;
+		locked_context.commands = BENCHMARK_COMMANDS / PRODUCERS;
+
+		Thread *consumer;
+		Thread *producers[PRODUCERS];
+
+		uint64_t t = OS::get_singleton()->get_ticks_usec();
+
+		if (pass == 0) {
+
+			locked_context.queue = memnew(LockedQueue);
+			consumer = Thread::create(consumer_loop<LockedQueue>, &locked_context);
+			for (int i = 0; i < PRODUCERS; i++) {
+				producers[i] = Thread::create(locked_benchmark_producer_loop, &locked_context);
+			}
+		} else {
+
+			context.queue = memnew(CommandQueueMT(true));
+			consumer = Thread::create(consumer_loop<CommandQueueMT>, &context);
+			for (int i = 0; i < PRODUCERS; i++) {
+				producers[i] = Thread::create(benchmark_producer_loop, &context);
+			}
+		}
+
+		for (int i = 0; i < PRODUCERS; i++) {
+			Thread::wait_to_finish(producers[i]);
+			memdelete(producers[i]);
+		}
+
+		if (pass == 0) {
+			locked_context.queue->push(&locked_context.receiver, &Receiver::quit);
+		} else {
+			context.queue->push(&context.receiver, &Receiver::quit);
+		}
+		Thread::wait_to_finish(consumer);
+		memdelete(consumer);
+
+		uint64_t usec = OS::get_singleton()->get_ticks_usec() - t;
+		rates[pass] = BENCHMARK_COMMANDS * 1000000.0 / MAX(usec, 1);
+
+		if (pass == 0) {
+			memdelete(locked_context.queue);
+		} else {
+			memdelete(context.queue);
+		}
+	}
+
+	OS::get_singleton()->print("\tlocked: %f commands/sec, lock free: %f commands/sec\n", rates[0], rates[1]);
+
+	return true;
+}
+
+typedef bool (*TestFunc)(void);
+
+TestFunc test_funcs[] = {
+
+	test_order,
+	test_rets,
+	test_benchmark,
+	0
+};
+
+MainLoop *test() {
+
+	int count = 0;
+	int passed = 0;
+
+	while (true) {
+		if (!test_funcs[count])
+			break;
+		bool pass = test_funcs[count]();
+		if (pass)
+			passed++;
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+
+		count++;
+	}
+
+	OS::get_singleton()->print("\n\n\n");
+	OS::get_singleton()->print("*************\n");
+	OS::get_singleton()->print("***TOTALS!***\n");
+	OS::get_singleton()->print("*************\n");
+
+	OS::get_singleton()->print("Passed %i of %i tests\n", passed, count);
+
+	return NULL;
+}
+} // namespace TestCommandQueue
@@ -0,0 +1,247 @@
+/*************************************************************************/
+/*  test_frame_arena.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_frame_arena.h"
+
+#include "core/frame_arena.h"
+#include "core/os/os.h"
+#include "core/ustring.h"
+#include "core/vector.h"
+
+namespace TestFrameArena {
+
+struct Counted {
+
+	static int alive;
+	int value;
+
+	Counted() {
+		value = 0;
+		alive++;
+	}
+	Counted(const Counted &p_from) {
+		value = p_from.value;
+		alive++;
+	}
+	~Counted() { alive--; }
+};
+
+int Counted::alive = 0;
+
+bool test_alloc_reset() {
+
+	OS::get_singleton()->print("\n\nTest 1: Allocate and reset\n");
+
+	FrameArena arena(1024);
+	bool ok = true;
+
+	uint8_t *prev = NULL;
+	for (int i = 0; i < 100; i++) {
+
+		uint8_t *mem = (uint8_t *)arena.alloc(1 + i % 40);
+		ok = ok && (size_t(mem) % 16) == 0 && mem != prev;
+		memset(mem, i, 1 + i % 40);
+		prev = mem;
+	}
+
+	int chunks = arena.get_chunk_count();
+	size_t reserved = arena.get_reserved_memory();
+	OS::get_singleton()->print("\t%i allocations took %i chunks, %i bytes used\n", int(arena.get_alloc_count()), chunks, int(arena.get_used_memory()));
+	ok = ok && chunks > 1 && arena.get_used_memory() <= reserved;
+
+	// All the chunks become one, so the same frame fits without taking more memory.
+	arena.reset();
+	ok = ok && arena.get_chunk_count() == 1 && arena.get_reserved_memory() >= reserved && arena.get_used_memory() == 0;
+
+	for (int i = 0; i < 100; i++) {
+		arena.alloc(1 + i % 40);
+	}
+
+	OS::get_singleton()->print("\tafter reset: %i chunk, %i bytes reserved\n", int(arena.get_chunk_count()), int(arena.get_reserved_memory()));
+	ok = ok && arena.get_chunk_count() == 1;
+
+	return ok;
+}
+
+bool test_vector() {
+
+	OS::get_singleton()->print("\n\nTest 2: ArenaVector\n");
+
+	FrameArena arena;
+	bool ok = true;
+
+	{
+		ArenaVector<String> strings(&arena);
+		for (int i = 0; i < 100; i++) {
+			strings.push_back(itos(i));
+		}
+
+		for (int i = 0; i < strings.size(); i++) {
+			ok = ok && strings[i] == itos(i);
+		}
+
+		strings.resize(10);
+		ok = ok && strings.size() == 10 && strings[9] == "9";
+		strings.resize(20);
+		ok = ok && strings.size() == 20 && strings[19] == "";
+	}
+
+	{
+		ArenaVector<Counted> counted(&arena);
+		for (int i = 0; i < 50; i++) {
+			Counted c;
+			c.value = i;
+			counted.push_back(c);
+		}
+
+		ok = ok && Counted::alive == 50 && counted[49].value == 49;
+		counted.clear();
+		ok = ok && Counted::alive == 0;
+
+		counted.resize(5);
+		ok = ok && Counted::alive == 5;
+	}
+
+	OS::get_singleton()->print("\telements constructed and destroyed: %s\n", ok && Counted::alive == 0 ? "yes" : "no");
+
+	return ok && Counted::alive == 0;
+}
+
+bool test_list() {
+
+	OS::get_singleton()->print("\n\nTest 3: ArenaList\n");
+
+	FrameArena arena;
+	ArenaList<int> list(&arena);
+
+	for (int i = 0; i < 10; i++) {
+		list.push_back(i);
+	}
+	list.push_front(-1);
+
+	bool ok = list.size() == 11 && list.front()->get() == -1 && list.back()->get() == 9;
+
+	int expected = -1;
+	for (ArenaList<int>::Element *E = list.front(); E; E = E->next()) {
+		ok = ok && E->get() == expected++;
+	}
+
+	expected = 9;
+	for (ArenaList<int>::Element *E = list.back(); E; E = E->prev()) {
+		ok = ok && E->get() == expected--;
+	}
+
+	list.clear();
+	ok = ok && list.empty() && !list.front();
+
+	OS::get_singleton()->print("\telements in order: %s\n", ok ? "yes" : "no");
+
+	return ok;
+}
+
+bool test_benchmark() {
+
+	OS::get_singleton()->print("\n\nTest 4: Scratch arrays against Vector\n");
+
+	const int frames = 1000;
+	const int items = 1000;
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	uint64_t sum_vector = 0;
+
+	Vector<int> vector;
+	for (int f = 0; f < frames; f++) {
+
+		vector.clear();
+		for (int i = 0; i < items; i++) {
+			vector.push_back(i);
+		}
+		sum_vector += vector[f % items];
+	}
+
+	uint64_t vector_usec = OS::get_singleton()->get_ticks_usec() - begin;
+	begin = OS::get_singleton()->get_ticks_usec();
+	uint64_t sum_arena = 0;
+
+	FrameArena arena;
+	ArenaVector<int> arena_vector(&arena);
+	for (int f = 0; f < frames; f++) {
+
+		arena_vector.reset();
+		arena.reset();
+		for (int i = 0; i < items; i++) {
+			arena_vector.push_back(i);
+		}
+		sum_arena += arena_vector[f % items];
+	}
+
+	uint64_t arena_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	OS::get_singleton()->print("\t%i frames of %i items: Vector %i msec, ArenaVector %i msec\n", frames, items, int(vector_usec / 1000), int(arena_usec / 1000));
+
+	return sum_vector == sum_arena && arena.get_chunk_count() == 1;
+}
+
+typedef bool (*TestFunc)(void);
+
+TestFunc test_funcs[] = {
+
+	test_alloc_reset,
+	test_vector,
+	test_list,
+	test_benchmark,
+	0
+};
+
+MainLoop *test() {
+
+	int count = 0;
+	int passed = 0;
+
+	while (true) {
+		if (!test_funcs[count])
+			break;
+		bool pass = test_funcs[count]();
+		if (pass)
+			passed++;
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+
+		count++;
+	}
+
+	OS::get_singleton()->print("\n\n\n");
+	OS::get_singleton()->print("*************\n");
+	OS::get_singleton()->print("***TOTALS!***\n");
+	OS::get_singleton()->print("*************\n");
+
+	OS::get_singleton()->print("Passed %i of %i tests\n", passed, count);
+
+	return NULL;
+}
+} // namespace TestFrameArena
@@ -36,6 +36,7 @@
 #ifdef GDSCRIPT_ENABLED
 
 #include "modules/gdscript/gdscript.h"
+#include "modules/gdscript/gdscript_compiled_buffer.h"
 #include "modules/gdscript/gdscript_compiler.h"
 #include "modules/gdscript/gdscript_parser.h"
 #include "modules/gdscript/gdscript_tokenizer.h"
@@ -613,20 +614,20 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 					txt += "[\"";
 					txt += func.get_global_name(code[ip + 2]);
 					txt += "\"]=";
-					txt += DADDR(3);
-					incr += 4;
+					txt += DADDR(4);
+					incr += 5;
 
 				} break;
 				case GDScriptFunction::OPCODE_GET_NAMED: {
 
 					txt += " get_named ";
-					txt += DADDR(3);
+					txt += DADDR(4);
 					txt += "=";
 					txt += DADDR(1);
 					txt += "[\"";
 					txt += func.get_global_name(code[ip + 2]);
 					txt += "\"]";
-					incr += 4;
+					incr += 5;
 
 				} break;
 				case GDScriptFunction::OPCODE_SET_MEMBER: {
@@ -747,7 +748,7 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 
 					int argc = code[ip + 1];
 					if (ret) {
-						txt += DADDR(4 + argc) + "=";
+						txt += DADDR(5 + argc) + "=";
 					}
 
 					txt += DADDR(2) + ".";
@@ -757,11 +758,11 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 					for (int i = 0; i < argc; i++) {
 						if (i > 0)
 							txt += ", ";
-						txt += DADDR(4 + i);
+						txt += DADDR(5 + i);
 					}
 					txt += ")";
 
-					incr = 5 + argc;
+					incr = 6 + argc;
 
 				} break;
 				case GDScriptFunction::OPCODE_CALL_BUILT_IN: {
@@ -783,6 +784,27 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 
 					incr = 4 + argc;
 
+				} break;
+				case GDScriptFunction::OPCODE_CALL_BUILT_IN_METHOD: {
+
+					txt += " call-built-in-method ";
+
+					int argc = code[ip + 1];
+					txt += DADDR(5 + argc) + "=";
+
+					txt += DADDR(2) + ".";
+					txt += String(func.get_global_name(code[ip + 3]));
+					txt += "(";
+
+					for (int i = 0; i < argc; i++) {
+						if (i > 0)
+							txt += ", ";
+						txt += DADDR(5 + i);
+					}
+					txt += ")";
+
+					incr = 6 + argc;
+
 				} break;
 				case GDScriptFunction::OPCODE_CALL_SELF_BASE: {
 
@@ -911,8 +933,258 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 	}
 }
 
+#define BENCHMARK_ITERATIONS 200000
+
+static const char *_benchmark_target_source =
+		"extends Reference\n"
+		"\n"
+		"var value = 0\n"
+		"\n"
+		"func add(a):\n"
+		"\tvalue += a * %MULT%\n"
+		"\treturn value\n";
+
+static const char *_benchmark_driver_source =
+		"extends Reference\n"
+		"\n"
+		"var value = 0\n"
+		"var other\n"
+		"var res = Resource.new()\n"
+		"var array = [1, 2, 3]\n"
+		"\n"
+		"func add(a):\n"
+		"\tvalue += a\n"
+		"\treturn value\n"
+		"\n"
+		"func self_calls(n):\n"
+		"\tvalue = 0\n"
+		"\tfor i in range(n):\n"
+		"\t\tadd(1)\n"
+		"\treturn value\n"
+		"\n"
+		"func script_calls(n):\n"
+		"\tother.value = 0\n"
+		"\tfor i in range(n):\n"
+		"\t\tother.add(1)\n"
+		"\treturn other.value\n"
+		"\n"
+		"func native_calls(n):\n"
+		"\tvar count = 0\n"
+		"\tres.resource_name = \"x\"\n"
+		"\tfor i in range(n):\n"
+		"\t\tcount += len(res.get_name())\n"
+		"\treturn count\n"
+		"\n"
+		"func built_in_calls(n):\n"
+		"\tvar count = 0\n"
+		"\tfor i in range(n):\n"
+		"\t\tcount += array.size()\n"
+		"\treturn count\n"
+		"\n"
+		"func member_access(n):\n"
+		"\tother.value = 0\n"
+		"\tfor i in range(n):\n"
+		"\t\tother.value = other.value + 1\n"
+		"\treturn other.value\n"
+		"\n"
+		"func property_access(n):\n"
+		"\tvar count = 0\n"
+		"\tfor i in range(n):\n"
+		"\t\tres.resource_name = \"x\"\n"
+		"\t\tcount += len(res.resource_name)\n"
+		"\treturn count\n";
+
+struct Benchmark {
+
+	const char *name;
+	const char *method;
+	int result_per_iteration;
+};
+
+static const Benchmark _benchmarks[] = {
+
+	{ "Calls on self", "self_calls", 1 },
+	{ "Calls on another script instance", "script_calls", 1 },
+	{ "Native method calls", "native_calls", 1 },
+	{ "Built-in type method calls", "built_in_calls", 3 },
+	{ "Script member get/set", "member_access", 1 },
+	{ "Native property get/set", "property_access", 1 },
+	{ NULL, NULL, 0 }
+};
+
+static Ref<GDScript> _benchmark_script(const String &p_source) {
+
+	Ref<GDScript> script;
+	script.instance();
+	script->set_source_code(p_source);
+	Error err = script->reload();
+	ERR_FAIL_COND_V(err != OK, Ref<GDScript>());
+
+	return script;
+}
+
+static bool _benchmark_run(Variant &p_driver, const Benchmark &p_benchmark, int p_result_per_iteration) {
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	Variant ret = p_driver.call(p_benchmark.method, BENCHMARK_ITERATIONS);
+	uint64_t usec = MAX(OS::get_singleton()->get_ticks_usec() - from, (uint64_t)1);
+
+	int expected = BENCHMARK_ITERATIONS * p_result_per_iteration;
+	OS::get_singleton()->print("\t%s: %i ms, %i ops/s\n", p_benchmark.name, int(usec / 1000), int(uint64_t(BENCHMARK_ITERATIONS) * 1000000 / usec));
+	if (ret.get_type() != Variant::INT || int(ret) != expected) {
+		OS::get_singleton()->print("\t\tFAILED: expected %i, got %ls\n", expected, String(ret).c_str());
+		return false;
+	}
+
+	return true;
+}
+
+static void _benchmark() {
+
+	Ref<GDScript> target = _benchmark_script(String(_benchmark_target_source).replace("%MULT%", "1"));
+	Ref<GDScript> driver_script = _benchmark_script(_benchmark_driver_source);
+	ERR_FAIL_COND(target.is_null() || driver_script.is_null());
+
+	Variant driver = Variant(driver_script).call("new");
+	Variant other = Variant(target).call("new");
+	ERR_FAIL_COND(driver.get_type() != Variant::OBJECT || other.get_type() != Variant::OBJECT);
+	bool valid;
+	driver.set_named("other", other, &valid);
+	ERR_FAIL_COND(!valid);
+
+	OS::get_singleton()->print("GDScript benchmark, %i iterations each\n", BENCHMARK_ITERATIONS);
+
+	int passed = 0;
+	int count = 0;
+	for (int i = 0; _benchmarks[i].name; i++) {
+
+		passed += _benchmark_run(driver, _benchmarks[i], _benchmarks[i].result_per_iteration) ? 1 : 0;
+		count++;
+	}
+
+	// calls resolved before a reload must not reach the old functions
+	target->set_source_code(String(_benchmark_target_source).replace("%MULT%", "2"));
+	Error err = target->reload(true);
+	ERR_FAIL_COND(err != OK);
+
+	OS::get_singleton()->print("After reloading the called script:\n");
+	passed += _benchmark_run(driver, _benchmarks[1], 2) ? 1 : 0;
+	count++;
+
+	OS::get_singleton()->print("Passed %i of %i checks\n", passed, count);
+}
+
+#define LOAD_ITERATIONS 200
+
+static const char *_load_source =
+		"extends Reference\n"
+		"\n"
+		"signal done(value)\n"
+		"\n"
+		"const LIMITS = [1, 2, 3]\n"
+		"\n"
+		"class Inner:\n"
+		"\tvar base_value = 5\n"
+		"\tfunc get_value():\n"
+		"\t\treturn base_value\n"
+		"\n"
+		"class Derived extends Inner:\n"
+		"\tvar extra = 3\n"
+		"\tfunc get_value():\n"
+		"\t\treturn .get_value() + extra\n"
+		"\n"
+		"var counter = 0 setget set_counter\n"
+		"\n"
+		"func set_counter(value):\n"
+		"\tcounter = value * 2\n"
+		"\n"
+		"static func twice(a, b = 3):\n"
+		"\treturn (a + b) * 2\n"
+		"\n"
+		"func run():\n"
+		"\tvar result = []\n"
+		"\tresult.append(twice(1))\n"
+		"\tresult.append(Derived.new().get_value())\n"
+		"\tself.counter = 3\n"
+		"\tresult.append(counter)\n"
+		"\tresult.append(LIMITS.find(1))\n"
+		"\tresult.append(typeof(Resource.new()) == TYPE_OBJECT)\n"
+		"\tresult.append(LIMITS.size())\n"
+		"\tresult.append(str(KEY_A))\n"
+		"\tvar total = 0\n"
+		"\tfor i in LIMITS:\n"
+		"\t\tif i != 2:\n"
+		"\t\t\ttotal += i\n"
+		"\tresult.append(total)\n"
+		"\tresult.append(get_script().has_script_signal(\"done\"))\n"
+		"\treturn result\n";
+
+static const char *_load_expected = "[8, 8, 6, 0, True, 3, 65, 4, True]";
+
+static bool _load_check(const String &p_name, const String &p_path, const Vector<uint8_t> &p_file) {
+
+	FileAccess *f = FileAccess::open(p_path, FileAccess::WRITE);
+	ERR_FAIL_COND_V(!f, false);
+	f->store_buffer(p_file.ptr(), p_file.size());
+	memdelete(f);
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	Ref<GDScript> script;
+	for (int i = 0; i < LOAD_ITERATIONS; i++) {
+
+		script.instance();
+		Error err = script->load_byte_code(p_path);
+		ERR_FAIL_COND_V(err != OK, false);
+	}
+	uint64_t usec = MAX(OS::get_singleton()->get_ticks_usec() - from, (uint64_t)1);
+
+	String ret = Variant(script).call("new").call("run");
+	OS::get_singleton()->print("\t%ls: %i bytes, %i us per load\n", p_name.c_str(), p_file.size(), int(usec / LOAD_ITERATIONS));
+	if (ret != _load_expected) {
+		OS::get_singleton()->print("\t\tFAILED: expected %s, got %ls\n", _load_expected, ret.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+static void _benchmark_load() {
+
+	// what the exporter gets from the editor
+	Ref<GDScript> script = _benchmark_script(_load_source);
+	ERR_FAIL_COND(script.is_null());
+
+	Vector<uint8_t> tokens = GDScriptTokenizerBuffer::parse_code_string(_load_source);
+	Vector<uint8_t> compiled_debug = GDScriptCompiledBuffer::make_buffer(script, tokens, true);
+	Vector<uint8_t> compiled_release = GDScriptCompiledBuffer::make_buffer(script, tokens, false);
+	ERR_FAIL_COND(tokens.empty() || compiled_debug.empty() || compiled_release.empty());
+
+	// made by another version, must fall back to the tokens
+	Vector<uint8_t> mismatched = compiled_release;
+	mismatched[4] ^= 0xFF;
+
+	String path = OS::get_singleton()->get_cache_path().plus_file("gdscript_load_benchmark.gdc");
+
+	OS::get_singleton()->print("GDScript load benchmark, %i loads each\n", LOAD_ITERATIONS);
+
+	int passed = 0;
+	passed += _load_check("Tokens", path, tokens) ? 1 : 0;
+	passed += _load_check("Compiled (debug)", path, compiled_debug) ? 1 : 0;
+	passed += _load_check("Compiled (release)", path, compiled_release) ? 1 : 0;
+	passed += _load_check("Compiled, other version", path, mismatched) ? 1 : 0;
+
+	OS::get_singleton()->print("Passed %i of %i checks\n", passed, 4);
+}
+
 MainLoop *test(TestType p_type) {
 
+	if (p_type == TEST_BENCHMARK) {
+
+		_benchmark();
+		_benchmark_load();
+		return NULL;
+	}
+
 	List<String> cmdlargs = OS::get_singleton()->get_cmdline_args();
 
 	if (cmdlargs.empty()) {
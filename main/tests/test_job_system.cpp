@@ -0,0 +1,250 @@
+/*************************************************************************/
+/*  test_job_system.cpp                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_job_system.h"
+
+#include "core/os/job_system.h"
+#include "core/os/os.h"
+#include "core/safe_refcount.h"
+#include "core/vector.h"
+
+namespace TestJobSystem {
+
+struct Counters {
+
+	Vector<uint32_t> storage;
+	uint32_t *hits; // taken once, jobs can't go through Vector's copy on write
+	uint32_t size;
+	uint32_t total;
+	uint32_t after; // set by jobs that must run after another group
+	uint32_t early; // jobs of the dependent group that ran too soon
+	uint32_t callbacks;
+	uint32_t done_at_callback;
+
+	void reset(int p_size) {
+
+		storage.resize(p_size);
+		hits = storage.ptrw();
+		size = p_size;
+		for (int i = 0; i < p_size; i++) {
+			hits[i] = 0;
+		}
+		total = 0;
+		after = 0;
+		early = 0;
+		callbacks = 0;
+		done_at_callback = 0;
+	}
+
+	bool all_hit_once() const {
+
+		for (uint32_t i = 0; i < size; i++) {
+			if (hits[i] != 1)
+				return false;
+		}
+		return true;
+	}
+};
+
+static void _hit(void *p_userdata, uint32_t p_index) {
+
+	Counters *c = (Counters *)p_userdata;
+	atomic_increment(&c->hits[p_index]);
+	atomic_increment(&c->total);
+}
+
+static void _hit_after(void *p_userdata, uint32_t p_index) {
+
+	Counters *c = (Counters *)p_userdata;
+	if (c->total != c->size)
+		atomic_increment(&c->early);
+	atomic_increment(&c->after);
+}
+
+static void _nested(void *p_userdata, uint32_t p_index) {
+
+	Counters *c = (Counters *)p_userdata;
+
+	// waits from within a job run other jobs instead of blocking the worker
+	JobSystem::Group group;
+	JobSystem::get_singleton()->submit(&group, _hit, c, 8, 2);
+	JobSystem::get_singleton()->submit(&group, _hit, c, 8, 1);
+	JobSystem::get_singleton()->wait(&group);
+	atomic_increment(&c->after);
+}
+
+static void _completed(void *p_userdata) {
+
+	Counters *c = (Counters *)p_userdata;
+	c->done_at_callback = c->total;
+	atomic_increment(&c->callbacks);
+}
+
+bool test_parallel_for() {
+
+	OS::get_singleton()->print("\n\nTest 1: parallel_for\n");
+	OS::get_singleton()->print("\t%i worker threads\n", JobSystem::get_singleton()->get_thread_count());
+
+	Counters c;
+	bool ok = true;
+
+	const uint32_t grains[] = { 1, 7, 64, 100000 };
+	for (int i = 0; i < 4; i++) {
+
+		c.reset(10000);
+		JobSystem::get_singleton()->parallel_for(10000, _hit, &c, grains[i]);
+		OS::get_singleton()->print("\tgrain %i: %i of 10000 indices processed\n", int(grains[i]), int(c.total));
+		ok = ok && c.total == 10000 && c.all_hit_once();
+	}
+
+	// nothing to do must not hang
+	JobSystem::get_singleton()->parallel_for(0, _hit, &c, 1);
+
+	return ok;
+}
+
+bool test_group_wait() {
+
+	OS::get_singleton()->print("\n\nTest 2: Group wait\n");
+
+	Counters c;
+	c.reset(1000);
+
+	JobSystem::Group group;
+	JobSystem::get_singleton()->submit(&group, _hit, &c, 500, 16);
+	JobSystem::get_singleton()->submit(&group, _hit, &c, 500, 1);
+	JobSystem::get_singleton()->wait(&group);
+
+	// hits are counted by index, so the second submit lands on the first 500 too
+	bool ok = group.is_completed() && c.total == 1000;
+	for (int i = 0; i < 500; i++) {
+		ok = ok && c.hits[i] == 2;
+	}
+
+	OS::get_singleton()->print("\ttwo submits: %i jobs done, completed: %s\n", int(c.total), group.is_completed() ? "yes" : "no");
+
+	c.reset(16 * 16);
+	JobSystem::Group nested;
+	JobSystem::get_singleton()->submit(&nested, _nested, &c, 16);
+	JobSystem::get_singleton()->wait(&nested);
+
+	OS::get_singleton()->print("\tnested waits: %i of 16 outer jobs, %i of 256 inner jobs\n", int(c.after), int(c.total));
+
+	return ok && nested.is_completed() && c.after == 16 && c.total == 256;
+}
+
+bool test_dependencies() {
+
+	OS::get_singleton()->print("\n\nTest 3: Dependencies\n");
+
+	Counters c;
+	c.reset(2000);
+
+	JobSystem::Group first;
+	JobSystem::Group second;
+	JobSystem::get_singleton()->add_dependency(&second, &first);
+
+	// submitted before what it depends on, so it has to be held back
+	JobSystem::get_singleton()->submit(&second, _hit_after, &c, 100, 4);
+	JobSystem::get_singleton()->submit(&first, _hit, &c, 2000, 8);
+
+	// first is still open, so second can't complete however long we look
+	JobSystem::get_singleton()->close(&second);
+	bool ok = !second.is_completed();
+
+	JobSystem::get_singleton()->close(&first);
+	JobSystem::get_singleton()->wait(&second);
+
+	OS::get_singleton()->print("\t%i dependent jobs, %i ran before their dependency completed\n", int(c.after), int(c.early));
+
+	return ok && first.is_completed() && second.is_completed() && c.after == 100 && c.early == 0 && c.all_hit_once();
+}
+
+bool test_completion_callback() {
+
+	OS::get_singleton()->print("\n\nTest 4: Completion callback\n");
+
+	Counters c;
+	c.reset(5000);
+
+	JobSystem::Group group;
+	JobSystem::get_singleton()->set_completion_callback(&group, _completed, &c);
+	JobSystem::get_singleton()->submit(&group, _hit, &c, 5000, 32);
+	JobSystem::get_singleton()->wait(&group);
+
+	OS::get_singleton()->print("\tcalled %i time(s), %i of 5000 jobs done by then\n", int(c.callbacks), int(c.done_at_callback));
+
+	bool ok = c.callbacks == 1 && c.done_at_callback == 5000;
+
+	// a group without jobs completes, and calls back, once closed
+	c.reset(0);
+	JobSystem::Group empty;
+	JobSystem::get_singleton()->set_completion_callback(&empty, _completed, &c);
+	JobSystem::get_singleton()->wait(&empty);
+
+	return ok && empty.is_completed() && c.callbacks == 1;
+}
+
+typedef bool (*TestFunc)(void);
+
+TestFunc test_funcs[] = {
+
+	test_parallel_for,
+	test_group_wait,
+	test_dependencies,
+	test_completion_callback,
+	0
+};
+
+MainLoop *test() {
+
+	int count = 0;
+	int passed = 0;
+
+	while (true) {
+		if (!test_funcs[count])
+			break;
+		bool pass = test_funcs[count]();
+		if (pass)
+			passed++;
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+
+		count++;
+	}
+
+	OS::get_singleton()->print("\n\n\n");
+	OS::get_singleton()->print("*************\n");
+	OS::get_singleton()->print("***TOTALS!***\n");
+	OS::get_singleton()->print("*************\n");
+
+	OS::get_singleton()->print("Passed %i of %i tests\n", passed, count);
+
+	return NULL;
+}
+} // namespace TestJobSystem
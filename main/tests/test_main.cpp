@@ -32,18 +32,30 @@
 
 #ifdef DEBUG_ENABLED
 
+#include "test_astar.h"
+#include "test_command_queue.h"
+#include "test_frame_arena.h"
 #include "test_gdscript.h"
 #include "test_gui.h"
 #include "test_image.h"
 #include "test_io.h"
+#include "test_job_system.h"
 #include "test_math.h"
+#include "test_message_queue.h"
+#include "test_network.h"
+#include "test_node.h"
 #include "test_oa_hash_map.h"
 #include "test_ordered_hash_map.h"
 #include "test_physics.h"
 #include "test_physics_2d.h"
+#include "test_pool_vector.h"
 #include "test_render.h"
 #include "test_shader_lang.h"
+#include "test_signals.h"
+#include "test_slab_allocator.h"
 #include "test_string.h"
+#include "test_string_name.h"
+#include "test_variant_parser.h"
 
 const char **tests_get_names() {
 
@@ -52,12 +64,30 @@ const char **tests_get_names() {
 		"containers",
 		"math",
 		"render",
+		"render_cull",
 		"multimesh",
 		"gui",
 		"io",
 		"shaderlang",
 		"physics",
+		"physics_broad_phase",
+		"physics_batch_queries",
+		"physics_step_determinism",
+		"physics_2d_step_determinism",
+		"physics_2d_overlapped_step",
 		"oa_hash_map",
+		"astar",
+		"network",
+		"node",
+		"command_queue",
+		"message_queue",
+		"slab_allocator",
+		"pool_vector",
+		"frame_arena",
+		"job_system",
+		"signals",
+		"string_name",
+		"variant_parser",
 		NULL
 	};
 
@@ -81,16 +111,46 @@ MainLoop *test_main(String p_test, const List<String> &p_args) {
 		return TestPhysics::test();
 	}
 
+	if (p_test == "physics_broad_phase") {
+
+		return TestPhysics::test_broad_phase();
+	}
+
+	if (p_test == "physics_batch_queries") {
+
+		return TestPhysics::test_batch_queries();
+	}
+
+	if (p_test == "physics_step_determinism") {
+
+		return TestPhysics::test_step_determinism();
+	}
+
 	if (p_test == "physics_2d") {
 
 		return TestPhysics2D::test();
 	}
 
+	if (p_test == "physics_2d_step_determinism") {
+
+		return TestPhysics2D::test_step_determinism();
+	}
+
+	if (p_test == "physics_2d_overlapped_step") {
+
+		return TestPhysics2D::test_overlapped_step();
+	}
+
 	if (p_test == "render") {
 
 		return TestRender::test();
 	}
 
+	if (p_test == "render_cull") {
+
+		return TestRender::test_cull();
+	}
+
 	if (p_test == "oa_hash_map") {
 
 		return TestOAHashMap::test();
@@ -133,6 +193,11 @@ MainLoop *test_main(String p_test, const List<String> &p_args) {
 		return TestGDScript::test(TestGDScript::TEST_BYTECODE);
 	}
 
+	if (p_test == "gd_benchmark") {
+
+		return TestGDScript::test(TestGDScript::TEST_BENCHMARK);
+	}
+
 	if (p_test == "image") {
 
 		return TestImage::test();
@@ -143,6 +208,66 @@ MainLoop *test_main(String p_test, const List<String> &p_args) {
 		return TestOrderedHashMap::test();
 	}
 
+	if (p_test == "astar") {
+
+		return TestAStar::test();
+	}
+
+	if (p_test == "node") {
+
+		return TestNode::test();
+	}
+
+	if (p_test == "command_queue") {
+
+		return TestCommandQueue::test();
+	}
+
+	if (p_test == "message_queue") {
+
+		return TestMessageQueue::test();
+	}
+
+	if (p_test == "slab_allocator") {
+
+		return TestSlabAllocator::test();
+	}
+
+	if (p_test == "pool_vector") {
+
+		return TestPoolVector::test();
+	}
+
+	if (p_test == "frame_arena") {
+
+		return TestFrameArena::test();
+	}
+
+	if (p_test == "job_system") {
+
+		return TestJobSystem::test();
+	}
+
+	if (p_test == "signals") {
+
+		return TestSignals::test();
+	}
+
+	if (p_test == "string_name") {
+
+		return TestStringName::test();
+	}
+
+	if (p_test == "variant_parser") {
+
+		return TestVariantParser::test();
+	}
+
+	if (p_test == "network") {
+
+		return TestNetwork::test();
+	}
+
 	return NULL;
 }
 
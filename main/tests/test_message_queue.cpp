@@ -0,0 +1,260 @@
+/*************************************************************************/
+/*  test_message_queue.cpp                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_message_queue.h"
+
+#include "core/message_queue.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
+
+namespace TestMessageQueue {
+
+enum {
+	THREADS = 4,
+	MESSAGES_PER_THREAD = 20000, // far more than the old 1 MB buffer could hold
+	SHORT_THREADS = 200, // more than the queue has thread buffers
+	MESSAGES_PER_SHORT_THREAD = 100,
+};
+
+class MessageTarget : public Object {
+
+	GDCLASS(MessageTarget, Object);
+
+	int value;
+
+protected:
+	static void _bind_methods() {
+
+		ClassDB::bind_method(D_METHOD("add", "thread", "seq"), &MessageTarget::add);
+		ClassDB::bind_method(D_METHOD("set_value", "value"), &MessageTarget::set_value);
+		ClassDB::bind_method(D_METHOD("get_value"), &MessageTarget::get_value);
+
+		ADD_PROPERTY(PropertyInfo(Variant::INT, "value"), "set_value", "get_value");
+	}
+
+public:
+	int next_seq[THREADS + 1];
+	int received;
+	bool in_order;
+
+	void add(int p_thread, int p_seq) {
+
+		if (next_seq[p_thread] != p_seq)
+			in_order = false;
+		next_seq[p_thread] = p_seq + 1;
+		received++;
+	}
+
+	void set_value(int p_value) { value = p_value; }
+	int get_value() const { return value; }
+
+	MessageTarget() {
+
+		for (int i = 0; i <= THREADS; i++) {
+			next_seq[i] = 0;
+		}
+		received = 0;
+		in_order = true;
+		value = 0;
+	}
+};
+
+struct Context {
+
+	MessageTarget *target;
+	uint32_t thread_index;
+	bool by_id;
+};
+
+static void push_loop(void *p_context) {
+
+	Context *context = (Context *)p_context;
+	int index = atomic_increment(&context->thread_index) - 1;
+
+	for (int i = 0; i < MESSAGES_PER_THREAD; i++) {
+
+		if (context->by_id) {
+			MessageQueue::get_singleton()->push_call(context->target->get_instance_id(), "add", index, i);
+		} else {
+			MessageQueue::get_singleton()->push_call(context->target, "add", index, i);
+		}
+	}
+}
+
+static bool test_threads(bool p_by_id) {
+
+	Context context;
+	context.target = memnew(MessageTarget);
+	context.thread_index = 0;
+	context.by_id = p_by_id;
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+
+	Thread *threads[THREADS];
+	for (int i = 0; i < THREADS; i++) {
+		threads[i] = Thread::create(push_loop, &context);
+	}
+
+	// The main thread pushes at the same time.
+	for (int i = 0; i < MESSAGES_PER_THREAD; i++) {
+		MessageQueue::get_singleton()->push_call(context.target, "add", THREADS, i);
+	}
+
+	for (int i = 0; i < THREADS; i++) {
+		Thread::wait_to_finish(threads[i]);
+		memdelete(threads[i]);
+	}
+
+	uint64_t push_usec = OS::get_singleton()->get_ticks_usec() - t;
+	t = OS::get_singleton()->get_ticks_usec();
+
+	MessageQueue::get_singleton()->flush();
+
+	uint64_t flush_usec = OS::get_singleton()->get_ticks_usec() - t;
+
+	int total = (THREADS + 1) * MESSAGES_PER_THREAD;
+	OS::get_singleton()->print("\treceived %d of %d calls, %s\n", context.target->received, total, context.target->in_order ? "in order" : "out of order");
+	OS::get_singleton()->print("\tpush: %f calls/sec, flush: %f calls/sec\n", total * 1000000.0 / MAX(push_usec, 1), total * 1000000.0 / MAX(flush_usec, 1));
+
+	bool ok = context.target->received == total && context.target->in_order;
+	memdelete(context.target);
+	return ok;
+}
+
+static bool test_threads_resolved() {
+
+	OS::get_singleton()->print("\n\nTest 1: Calls to a known object from %d threads\n", THREADS + 1);
+	return test_threads(false);
+}
+
+static bool test_threads_by_id() {
+
+	OS::get_singleton()->print("\n\nTest 2: Calls to an object id from %d threads\n", THREADS + 1);
+	return test_threads(true);
+}
+
+static bool test_set_and_free() {
+
+	OS::get_singleton()->print("\n\nTest 3: Deferred set and free\n");
+
+	MessageTarget *target = memnew(MessageTarget);
+	ObjectID id = target->get_instance_id();
+
+	MessageQueue::get_singleton()->push_set(target, "value", 42);
+	MessageQueue::get_singleton()->push_call(target, "add", Variant(0), Variant(0));
+	MessageQueue::get_singleton()->push_call(target, "free");
+	MessageQueue::get_singleton()->push_call(id, "add", Variant(0), Variant(1)); // the object is gone by then
+	MessageQueue::get_singleton()->flush();
+
+	bool ok = ObjectDB::get_instance(id) == NULL;
+
+	target = memnew(MessageTarget);
+	MessageQueue::get_singleton()->push_set(target->get_instance_id(), "value", 7);
+	MessageQueue::get_singleton()->push_set(target, "value", 8);
+	MessageQueue::get_singleton()->flush();
+
+	ok = ok && target->get_value() == 8;
+	memdelete(target);
+
+	return ok;
+}
+
+static void push_and_exit(void *p_context) {
+
+	Context *context = (Context *)p_context;
+	int first = atomic_add(&context->thread_index, uint32_t(MESSAGES_PER_SHORT_THREAD)) - MESSAGES_PER_SHORT_THREAD;
+
+	for (int i = 0; i < MESSAGES_PER_SHORT_THREAD; i++) {
+		MessageQueue::get_singleton()->push_call(context->target, "add", Variant(0), first + i);
+	}
+}
+
+static bool test_short_lived_threads() {
+
+	OS::get_singleton()->print("\n\nTest 4: Calls from %d threads that exit before the flush\n", SHORT_THREADS);
+
+	Context context;
+	context.target = memnew(MessageTarget);
+	context.thread_index = 0;
+	context.by_id = false;
+
+	// One after the other, so each takes the buffer the previous one gave back.
+	for (int i = 0; i < SHORT_THREADS; i++) {
+		Thread *thread = Thread::create(push_and_exit, &context);
+		Thread::wait_to_finish(thread);
+		memdelete(thread);
+	}
+
+	MessageQueue::get_singleton()->flush();
+
+	int total = SHORT_THREADS * MESSAGES_PER_SHORT_THREAD;
+	OS::get_singleton()->print("\treceived %d of %d calls, %s\n", context.target->received, total, context.target->in_order ? "in order" : "out of order");
+
+	bool ok = context.target->received == total && context.target->in_order;
+	memdelete(context.target);
+	return ok;
+}
+
+typedef bool (*TestFunc)(void);
+
+TestFunc test_funcs[] = {
+
+	test_threads_resolved,
+	test_threads_by_id,
+	test_set_and_free,
+	test_short_lived_threads,
+	0
+};
+
+MainLoop *test() {
+
+	int count = 0;
+	int passed = 0;
+
+	while (true) {
+		if (!test_funcs[count])
+			break;
+		bool pass = test_funcs[count]();
+		if (pass)
+			passed++;
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+
+		count++;
+	}
+
+	OS::get_singleton()->print("\n\n\n");
+	OS::get_singleton()->print("*************\n");
+	OS::get_singleton()->print("***TOTALS!***\n");
+	OS::get_singleton()->print("*************\n");
+
+	OS::get_singleton()->print("Passed %i of %i tests\n", passed, count);
+
+	return NULL;
+}
+} // namespace TestMessageQueue
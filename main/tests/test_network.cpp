@@ -0,0 +1,283 @@
+/*************************************************************************/
+/*  test_network.cpp                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_network.h"
+
+#include "core/io/marshalls.h"
+#include "core/io/networked_multiplayer_peer.h"
+#include "core/os/os.h"
+#include "core/print_string.h"
+#include "scene/main/scene_tree.h"
+#include "scene/main/viewport.h"
+
+namespace TestNetwork {
+
+enum {
+	WARMUP_FRAMES = 2, // path and name caches are negotiated here
+	MEASURED_FRAMES = 20,
+	RPCS_PER_FRAME = 64, // one per player on a busy server
+};
+
+// Packets sent are received back as if they came from peer 2, so one tree talks to itself.
+class LoopbackPeer : public NetworkedMultiplayerPeer {
+
+	GDCLASS(LoopbackPeer, NetworkedMultiplayerPeer);
+
+	List<Vector<uint8_t> > packets;
+	Vector<uint8_t> current;
+
+public:
+	int bytes_sent;
+	int packets_sent;
+
+	virtual void set_transfer_mode(TransferMode p_mode) {}
+	virtual void set_target_peer(int p_peer_id) {}
+
+	virtual int get_packet_peer() const { return 2; }
+
+	virtual bool is_server() const { return true; }
+
+	virtual void poll() {}
+
+	virtual int get_unique_id() const { return 1; }
+
+	virtual void set_refuse_new_connections(bool p_enable) {}
+	virtual bool is_refusing_new_connections() const { return false; }
+
+	virtual ConnectionStatus get_connection_status() const { return CONNECTION_CONNECTED; }
+
+	virtual int get_available_packet_count() const { return packets.size(); }
+
+	virtual Error get_packet(const uint8_t **r_buffer, int &r_buffer_size) {
+
+		ERR_FAIL_COND_V(packets.empty(), ERR_UNAVAILABLE);
+
+		current = packets.front()->get();
+		packets.pop_front();
+
+		*r_buffer = current.ptr();
+		r_buffer_size = current.size();
+		return OK;
+	}
+
+	virtual Error put_packet(const uint8_t *p_buffer, int p_buffer_size) {
+
+		Vector<uint8_t> packet;
+		packet.resize(p_buffer_size);
+		copymem(packet.ptrw(), p_buffer, p_buffer_size);
+		packets.push_back(packet);
+
+		bytes_sent += p_buffer_size;
+		packets_sent++;
+		return OK;
+	}
+
+	virtual int get_max_packet_size() const { return 1 << 24; }
+
+	LoopbackPeer() {
+
+		bytes_sent = 0;
+		packets_sent = 0;
+	}
+};
+
+class RPCTarget : public Node {
+
+	GDCLASS(RPCTarget, Node);
+
+	Vector3 position;
+
+protected:
+	static void _bind_methods() {
+
+		ClassDB::bind_method(D_METHOD("set_position", "position"), &RPCTarget::set_position);
+		ClassDB::bind_method(D_METHOD("get_position"), &RPCTarget::get_position);
+		ClassDB::bind_method(D_METHOD("update_state", "position", "velocity", "health", "running"), &RPCTarget::update_state);
+
+		ADD_PROPERTY(PropertyInfo(Variant::VECTOR3, "position"), "set_position", "get_position");
+	}
+
+public:
+	int sets;
+	int calls;
+	int last_health;
+
+	void set_position(const Vector3 &p_position) {
+
+		position = p_position;
+		sets++;
+	}
+	Vector3 get_position() const { return position; }
+
+	void update_state(const Vector3 &p_position, const Vector3 &p_velocity, int p_health, bool p_running) {
+
+		position = p_position;
+		last_health = p_health;
+		calls++;
+	}
+
+	RPCTarget() {
+
+		sets = 0;
+		calls = 0;
+		last_health = 0;
+	}
+};
+
+// Size of the packet sent before method and property names were cached and arguments encoded compactly.
+static int _get_uncached_rpc_size(bool p_set, const StringName &p_name, const Variant **p_args, int p_argcount) {
+
+	int size = 1 + 4; // command and path id
+	size += String(p_name).utf8().length() + 1;
+	if (!p_set)
+		size += 1; // argument count
+
+	for (int i = 0; i < p_argcount; i++) {
+		int len;
+		encode_variant(*p_args[i], NULL, len);
+		size += len;
+	}
+
+	return size;
+}
+
+class TestMainLoop : public SceneTree {
+
+	Ref<LoopbackPeer> peer;
+	RPCTarget *target;
+	int frame;
+
+	int set_bytes;
+	int call_bytes;
+	int uncached_set_bytes;
+	int uncached_call_bytes;
+
+	Vector3 _get_player_position(int p_player) const {
+
+		return Vector3(p_player * 2.5, 0.5, frame * 0.25);
+	}
+
+	void _send_sets() {
+
+		for (int i = 0; i < RPCS_PER_FRAME; i++) {
+
+			Variant pos = _get_player_position(i);
+			const Variant *args[1] = { &pos };
+
+			int bytes = peer->bytes_sent;
+			target->rset_unreliable("position", pos);
+			set_bytes += peer->bytes_sent - bytes;
+			uncached_set_bytes += _get_uncached_rpc_size(true, "position", args, 1);
+		}
+	}
+
+	void _send_calls() {
+
+		for (int i = 0; i < RPCS_PER_FRAME; i++) {
+
+			Variant pos = _get_player_position(i);
+			Variant vel = Vector3(1, 0, 0);
+			Variant health = 100 - i;
+			Variant running = (i & 1) != 0;
+			const Variant *args[4] = { &pos, &vel, &health, &running };
+
+			int bytes = peer->bytes_sent;
+			target->rpc_unreliable("update_state", pos, vel, health, running);
+			call_bytes += peer->bytes_sent - bytes;
+			uncached_call_bytes += _get_uncached_rpc_size(false, "update_state", args, 4);
+		}
+	}
+
+public:
+	virtual void request_quit() {
+
+		quit();
+	}
+
+	virtual void init() {
+
+		SceneTree::init();
+
+		target = memnew(RPCTarget);
+		target->set_name("Player");
+		get_root()->add_child(target);
+		target->rset_config("position", Node::RPC_MODE_REMOTE);
+		target->rpc_config("update_state", Node::RPC_MODE_REMOTE);
+
+		peer.instance();
+		set_network_peer(peer);
+		peer->emit_signal("peer_connected", 2);
+
+		frame = 0;
+		set_bytes = 0;
+		call_bytes = 0;
+		uncached_set_bytes = 0;
+		uncached_call_bytes = 0;
+	}
+
+	virtual bool idle(float p_time) {
+
+		if (frame < WARMUP_FRAMES) {
+
+			target->rset_unreliable("position", Vector3());
+			target->rpc_unreliable("update_state", Vector3(), Vector3(), 0, false);
+
+		} else if (frame < WARMUP_FRAMES + MEASURED_FRAMES) {
+
+			_send_sets();
+			_send_calls();
+		}
+
+		bool quit = SceneTree::idle(p_time); // receives what was just sent
+		frame++;
+
+		if (frame < WARMUP_FRAMES + MEASURED_FRAMES)
+			return quit;
+
+		int count = MEASURED_FRAMES * RPCS_PER_FRAME;
+
+		print_line("rset_unreliable(\"position\", Vector3): " + itos(uncached_set_bytes / count) + " bytes per RPC before, " + itos(set_bytes / count) + " after.");
+		print_line("rpc_unreliable(\"update_state\", Vector3, Vector3, int, bool): " + itos(uncached_call_bytes / count) + " bytes per RPC before, " + itos(call_bytes / count) + " after.");
+		print_line("Bytes per tick for " + itos(RPCS_PER_FRAME) + " players: " + itos((uncached_set_bytes + uncached_call_bytes) / MEASURED_FRAMES) + " before, " + itos((set_bytes + call_bytes) / MEASURED_FRAMES) + " after.");
+
+		int expected = (WARMUP_FRAMES + MEASURED_FRAMES * RPCS_PER_FRAME);
+		bool received = target->sets == expected && target->calls == expected && target->get_position() == _get_player_position(RPCS_PER_FRAME - 1) - Vector3(0, 0, 0.25);
+		print_line(String("All RPCs received: ") + (received ? "yes" : "no"));
+
+		set_network_peer(Ref<NetworkedMultiplayerPeer>());
+
+		return true;
+	}
+};
+
+MainLoop *test() {
+
+	return memnew(TestMainLoop);
+}
+}
@@ -0,0 +1,404 @@
+/*************************************************************************/
+/*  test_node.cpp                                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_node.h"
+
+#include "core/os/os.h"
+#include "scene/main/node.h"
+#include "scene/main/scene_pool.h"
+#include "scene/main/timer.h"
+#include "scene/resources/packed_scene.h"
+
+namespace TestNode {
+
+enum {
+	SPAWN_COUNT = 20000,
+	LEGIBLE_SPAWN_COUNT = 5000,
+	SPAWN_ROUNDS = 4,
+	INSTANCE_COUNT = 5000,
+};
+
+static uint32_t random(uint32_t &r_seed) {
+
+	r_seed = r_seed * 1664525 + 1013904223;
+	return r_seed >> 8;
+}
+
+// Every child must be found by its name, and names must be unique.
+static bool check_children(Node *p_parent) {
+
+	Set<StringName> names;
+
+	for (int i = 0; i < p_parent->get_child_count(); i++) {
+
+		Node *child = p_parent->get_child(i);
+		if (names.has(child->get_name())) {
+			OS::get_singleton()->print("\tname %ls is repeated\n", String(child->get_name()).c_str());
+			return false;
+		}
+		names.insert(child->get_name());
+
+		if (p_parent->get_node(NodePath(child->get_name())) != child) {
+			OS::get_singleton()->print("\tchild %ls not found by name\n", String(child->get_name()).c_str());
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Adds and removes lots of children in random order, like bullets in a container.
+static bool spawn(int p_count, bool p_legible_names) {
+
+	Node *parent = memnew(Node);
+	Vector<Node *> nodes;
+	uint32_t seed = 1234;
+
+	uint64_t add_usec = 0;
+	uint64_t find_usec = 0;
+	uint64_t remove_usec = 0;
+
+	for (int r = 0; r < SPAWN_ROUNDS; r++) {
+
+		uint64_t t = OS::get_singleton()->get_ticks_usec();
+
+		while (nodes.size() < p_count) {
+
+			Node *node = memnew(Node);
+			node->set_name("Bullet");
+			parent->add_child(node, p_legible_names);
+			nodes.push_back(node);
+		}
+
+		add_usec += OS::get_singleton()->get_ticks_usec() - t;
+		t = OS::get_singleton()->get_ticks_usec();
+
+		for (int i = 0; i < nodes.size(); i++) {
+
+			if (parent->get_node(NodePath(nodes[i]->get_name())) != nodes[i]) {
+				OS::get_singleton()->print("\tget_node() failed for %ls\n", String(nodes[i]->get_name()).c_str());
+				memdelete(parent);
+				return false;
+			}
+		}
+
+		find_usec += OS::get_singleton()->get_ticks_usec() - t;
+
+		if (r == 0 && !check_children(parent)) {
+			memdelete(parent);
+			return false;
+		}
+
+		t = OS::get_singleton()->get_ticks_usec();
+
+		// despawn half of them
+		for (int i = 0; i < p_count / 2; i++) {
+
+			int idx = random(seed) % nodes.size();
+			Node *node = nodes[idx];
+			nodes.set(idx, nodes[nodes.size() - 1]);
+			nodes.resize(nodes.size() - 1);
+
+			parent->remove_child(node);
+			memdelete(node);
+		}
+
+		remove_usec += OS::get_singleton()->get_ticks_usec() - t;
+	}
+
+	bool ok = check_children(parent);
+
+	if (p_legible_names) {
+
+		// freed names are reused, lowest number first
+		Node *first = parent->get_child(0);
+		parent->remove_child(first);
+
+		Set<String> taken;
+		for (int i = 0; i < parent->get_child_count(); i++) {
+			taken.insert(parent->get_child(i)->get_name());
+		}
+
+		String name = "Bullet";
+		for (int i = 2; taken.has(name); i++) {
+			name = "Bullet" + itos(i);
+		}
+
+		Node *node = memnew(Node);
+		node->set_name("Bullet");
+		parent->add_child(node, true);
+
+		if (String(node->get_name()) != name) {
+			OS::get_singleton()->print("\texpected name %ls, got %ls\n", name.c_str(), String(node->get_name()).c_str());
+			ok = false;
+		}
+
+		memdelete(first);
+	}
+
+	int spawned = p_count + (SPAWN_ROUNDS - 1) * (p_count / 2);
+	OS::get_singleton()->print("\tadd_child: %f us, get_node: %f us, remove_child: %f us\n", double(add_usec) / spawned, double(find_usec) / (SPAWN_ROUNDS * p_count), double(remove_usec) / (SPAWN_ROUNDS * (p_count / 2)));
+
+	memdelete(parent);
+	return ok;
+}
+
+static bool test_spawn() {
+
+	OS::get_singleton()->print("\n\nTest 1: Spawn and despawn %i children\n", int(SPAWN_COUNT));
+	return spawn(SPAWN_COUNT, false);
+}
+
+static bool test_spawn_legible_names() {
+
+	OS::get_singleton()->print("\n\nTest 2: Spawn and despawn %i children with readable names\n", int(LEGIBLE_SPAWN_COUNT));
+	return spawn(LEGIBLE_SPAWN_COUNT, true);
+}
+
+static bool test_rename() {
+
+	OS::get_singleton()->print("\n\nTest 3: Rename children\n");
+
+	Node *parent = memnew(Node);
+
+	for (int i = 0; i < 200; i++) {
+		Node *node = memnew(Node);
+		node->set_name("Item" + itos(i));
+		parent->add_child(node);
+	}
+
+	Node *node = parent->get_child(10);
+	node->set_name("Renamed");
+
+	bool ok = parent->get_node(NodePath("Renamed")) == node && !parent->has_node(NodePath("Item10"));
+
+	// taking the name of a sibling gives a unique one instead
+	parent->get_child(20)->set_name("Renamed");
+	ok = ok && parent->get_child(20)->get_name() != StringName("Renamed") && parent->get_node(NodePath("Renamed")) == node;
+
+	// moving children around doesn't change what names find
+	parent->move_child(node, 150);
+	ok = ok && parent->get_node(NodePath("Renamed")) == node && check_children(parent);
+
+	memdelete(parent);
+	return ok;
+}
+
+static Ref<PackedScene> make_enemy_scene() {
+
+	Node *root = memnew(Node);
+	root->set_name("Enemy");
+	root->set_pause_mode(Node::PAUSE_MODE_STOP);
+
+	for (int i = 0; i < 4; i++) {
+
+		Timer *timer = memnew(Timer);
+		timer->set_name("Cooldown" + itos(i));
+		timer->set_wait_time(0.5 + i);
+		timer->set_one_shot(true);
+		timer->set_timer_process_mode(Timer::TIMER_PROCESS_PHYSICS);
+		root->add_child(timer);
+		timer->set_owner(root);
+		timer->connect("timeout", root, "queue_free", Vector<Variant>(), Object::CONNECT_PERSIST);
+
+		Node *state = memnew(Node);
+		state->set_name("State");
+		state->set_pause_mode(Node::PAUSE_MODE_PROCESS);
+		timer->add_child(state);
+		state->set_owner(root);
+	}
+
+	Ref<PackedScene> scene;
+	scene.instance();
+	scene->pack(root);
+
+	memdelete(root);
+	return scene;
+}
+
+static bool check_enemy(Node *p_enemy) {
+
+	if (p_enemy->get_child_count() != 4 || p_enemy->get_pause_mode() != Node::PAUSE_MODE_STOP)
+		return false;
+
+	for (int i = 0; i < 4; i++) {
+
+		Timer *timer = Object::cast_to<Timer>(p_enemy->get_node(NodePath("Cooldown" + itos(i))));
+		if (!timer || timer->get_wait_time() != 0.5 + i || !timer->is_one_shot() || timer->get_timer_process_mode() != Timer::TIMER_PROCESS_PHYSICS)
+			return false;
+		if (!timer->is_connected("timeout", p_enemy, "queue_free"))
+			return false;
+
+		Node *state = timer->get_node(NodePath("State"));
+		if (!state || state->get_pause_mode() != Node::PAUSE_MODE_PROCESS || state->get_owner() != p_enemy)
+			return false;
+	}
+
+	return true;
+}
+
+static double instance_rate(const Ref<PackedScene> &p_scene, bool &r_ok) {
+
+	Vector<Node *> instances;
+	instances.resize(INSTANCE_COUNT);
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+
+	for (int i = 0; i < INSTANCE_COUNT; i++) {
+		instances[i] = p_scene->instance();
+	}
+
+	uint64_t usec = OS::get_singleton()->get_ticks_usec() - t;
+
+	for (int i = 0; i < INSTANCE_COUNT; i++) {
+
+		if (!instances[i] || !check_enemy(instances[i])) {
+			r_ok = false;
+		}
+		if (instances[i]) {
+			memdelete(instances[i]);
+		}
+	}
+
+	return INSTANCE_COUNT * 1000000.0 / MAX(usec, 1);
+}
+
+static bool test_instance() {
+
+	OS::get_singleton()->print("\n\nTest 4: Instance a packed scene %i times\n", int(INSTANCE_COUNT));
+
+	Ref<PackedScene> scene = make_enemy_scene();
+	bool ok = true;
+
+	SceneState::set_disable_instance_plans(true);
+	double without_plans = instance_rate(scene, ok);
+	SceneState::set_disable_instance_plans(false);
+	double with_plans = instance_rate(scene, ok);
+
+	OS::get_singleton()->print("\tinstances/sec: %f without plans, %f with plans\n", without_plans, with_plans);
+
+	return ok;
+}
+
+static bool test_pool() {
+
+	OS::get_singleton()->print("\n\nTest 5: Spawn and despawn a packed scene %i times through the pool\n", int(INSTANCE_COUNT));
+
+	Ref<PackedScene> scene = make_enemy_scene();
+	ScenePool *pool = ScenePool::get_singleton();
+	Node *parent = memnew(Node);
+	bool ok = true;
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+
+	for (int i = 0; i < INSTANCE_COUNT; i++) {
+
+		Node *enemy = scene->instance();
+		parent->add_child(enemy);
+		parent->remove_child(enemy);
+		memdelete(enemy);
+	}
+
+	uint64_t instance_usec = OS::get_singleton()->get_ticks_usec() - t;
+
+	pool->prefill(scene, 16);
+	uint64_t misses = pool->get_miss_count();
+	Set<ObjectID> ids;
+
+	t = OS::get_singleton()->get_ticks_usec();
+
+	for (int i = 0; i < INSTANCE_COUNT; i++) {
+
+		Node *enemy = pool->acquire(scene);
+		parent->add_child(enemy);
+		ids.insert(enemy->get_instance_id());
+		pool->release(enemy);
+	}
+
+	uint64_t pool_usec = OS::get_singleton()->get_ticks_usec() - t;
+
+	// one instance, reused every time
+	ok = ok && ids.size() == 1 && pool->get_miss_count() == misses && pool->get_in_use_count() == 0;
+	ok = ok && pool->get_available(scene) == 16 && parent->get_child_count() == 0;
+
+	Node *enemy = pool->acquire(scene);
+	ok = ok && pool->is_pooled(enemy) && check_enemy(enemy);
+	memdelete(enemy); // freed instead of released
+	ok = ok && pool->get_in_use_count() == 0;
+
+	pool->set_max_available(scene, 4);
+	ok = ok && pool->get_available(scene) == 4 && pool->get_available_count() == 4;
+
+	pool->clear(scene);
+	ok = ok && pool->get_available(scene) == 0 && pool->get_available_count() == 0;
+
+	OS::get_singleton()->print("\tinstances/sec: %f instancing, %f pooled\n", INSTANCE_COUNT * 1000000.0 / MAX(instance_usec, 1), INSTANCE_COUNT * 1000000.0 / MAX(pool_usec, 1));
+
+	memdelete(parent);
+	return ok;
+}
+
+typedef bool (*TestFunc)(void);
+
+TestFunc test_funcs[] = {
+
+	test_spawn,
+	test_spawn_legible_names,
+	test_rename,
+	test_instance,
+	test_pool,
+	0
+};
+
+MainLoop *test() {
+
+	int count = 0;
+	int passed = 0;
+
+	while (true) {
+		if (!test_funcs[count])
+			break;
+		bool pass = test_funcs[count]();
+		if (pass)
+			passed++;
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+
+		count++;
+	}
+
+	OS::get_singleton()->print("\n\n\n");
+	OS::get_singleton()->print("*************\n");
+	OS::get_singleton()->print("***TOTALS!***\n");
+	OS::get_singleton()->print("*************\n");
+
+	OS::get_singleton()->print("Passed %i of %i tests\n", passed, count);
+
+	return NULL;
+}
+} // namespace TestNode
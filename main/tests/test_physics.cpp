@@ -31,10 +31,15 @@
 
 #include "map.h"
 #include "math_funcs.h"
+#include "os/job_system.h"
 #include "os/main_loop.h"
 #include "os/os.h"
 #include "print_string.h"
+#include "project_settings.h"
 #include "quick_hull.h"
+#include "servers/physics/body_sw.h"
+#include "servers/physics/broad_phase_aabb_tree.h"
+#include "servers/physics/broad_phase_octree.h"
 #include "servers/physics_server.h"
 #include "servers/visual_server.h"
 
@@ -435,4 +440,466 @@ MainLoop *test() {
 
 	return memnew(TestPhysicsMainLoop);
 }
+
+/* BROAD PHASE BENCHMARK */
+
+enum {
+	BP_OBJECTS = 8000,
+	BP_STATIC_EVERY = 10, // one in ten objects doesn't move
+	BP_FRAMES = 120,
+	BP_QUERIES = 20000,
+};
+
+static const real_t BP_WORLD_SIZE = 200.0;
+
+struct BroadPhaseStats {
+
+	int pair_events;
+	int colliding_pairs;
+};
+
+static void *_bp_pair(CollisionObjectSW *A, int p_subindex_A, CollisionObjectSW *B, int p_subindex_B, void *p_userdata) {
+
+	BroadPhaseStats *stats = (BroadPhaseStats *)p_userdata;
+	stats->pair_events++;
+	stats->colliding_pairs++;
+	return NULL;
+}
+
+static void _bp_unpair(CollisionObjectSW *A, int p_subindex_A, CollisionObjectSW *B, int p_subindex_B, void *p_data, void *p_userdata) {
+
+	BroadPhaseStats *stats = (BroadPhaseStats *)p_userdata;
+	stats->pair_events++;
+	stats->colliding_pairs--;
+}
+
+static uint32_t _bp_random(uint32_t &r_seed) {
+
+	r_seed = r_seed * 1664525 + 1013904223;
+	return r_seed >> 8;
+}
+
+static real_t _bp_randf(uint32_t &r_seed) {
+
+	return (_bp_random(r_seed) & 0xFFFF) / real_t(0xFFFF);
+}
+
+static int _benchmark_broad_phase(const char *p_name, BroadPhaseSW *p_broad_phase, BodySW **p_objects) {
+
+	BroadPhaseStats stats;
+	stats.pair_events = 0;
+	stats.colliding_pairs = 0;
+	p_broad_phase->set_pair_callback(_bp_pair, &stats);
+	p_broad_phase->set_unpair_callback(_bp_unpair, &stats);
+
+	uint32_t seed = 1234;
+	Vector<BroadPhaseSW::ID> ids;
+	Vector<Vector3> positions;
+	Vector<Vector3> velocities;
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+
+	for (int i = 0; i < BP_OBJECTS; i++) {
+
+		BroadPhaseSW::ID id = p_broad_phase->create(p_objects[i]);
+		p_broad_phase->set_static(id, i % BP_STATIC_EVERY == 0);
+
+		Vector3 pos(_bp_randf(seed), _bp_randf(seed), _bp_randf(seed));
+		Vector3 vel(_bp_randf(seed) - 0.5, _bp_randf(seed) - 0.5, _bp_randf(seed) - 0.5);
+		p_broad_phase->move(id, AABB(pos * BP_WORLD_SIZE, Vector3(2, 2, 2)));
+
+		ids.push_back(id);
+		positions.push_back(pos * BP_WORLD_SIZE);
+		velocities.push_back(vel * 0.5);
+	}
+
+	uint64_t insert_usec = OS::get_singleton()->get_ticks_usec() - t;
+	int insert_events = stats.pair_events;
+
+	t = OS::get_singleton()->get_ticks_usec();
+	int moves = 0;
+
+	for (int f = 0; f < BP_FRAMES; f++) {
+
+		for (int i = 0; i < BP_OBJECTS; i++) {
+
+			if (i % BP_STATIC_EVERY == 0)
+				continue;
+
+			Vector3 pos = positions[i] + velocities[i];
+			for (int j = 0; j < 3; j++) {
+				if (pos[j] < 0 || pos[j] > BP_WORLD_SIZE) {
+					velocities[i][j] = -velocities[i][j];
+				}
+			}
+
+			positions[i] = pos;
+			p_broad_phase->move(ids[i], AABB(pos, Vector3(2, 2, 2)));
+			moves++;
+		}
+
+		p_broad_phase->update();
+	}
+
+	uint64_t move_usec = OS::get_singleton()->get_ticks_usec() - t;
+	int move_events = stats.pair_events - insert_events;
+
+	static CollisionObjectSW *results[1024];
+	int found = 0;
+
+	t = OS::get_singleton()->get_ticks_usec();
+
+	for (int i = 0; i < BP_QUERIES; i++) {
+
+		Vector3 pos(_bp_randf(seed), _bp_randf(seed), _bp_randf(seed));
+		found += p_broad_phase->cull_aabb(AABB(pos * BP_WORLD_SIZE, Vector3(5, 5, 5)), results, 1024);
+	}
+
+	uint64_t query_usec = OS::get_singleton()->get_ticks_usec() - t;
+
+	OS::get_singleton()->print("%s:\n", p_name);
+	OS::get_singleton()->print("\tinsert %d objects: %f ms\n", BP_OBJECTS, insert_usec / 1000.0);
+	OS::get_singleton()->print("\tmove: %f us per move, %d pair events (%f pair events/sec)\n", double(move_usec) / moves, move_events, move_usec ? move_events * 1000000.0 / move_usec : 0.0);
+	OS::get_singleton()->print("\tcull_aabb: %f us per query, %d results\n", double(query_usec) / BP_QUERIES, found);
+	OS::get_singleton()->print("\tcolliding pairs at the end: %d\n", stats.colliding_pairs);
+
+	for (int i = 0; i < ids.size(); i++) {
+		p_broad_phase->remove(ids[i]);
+	}
+
+	if (stats.colliding_pairs != 0) {
+		OS::get_singleton()->print("\tFAIL: %d pairs left after removing everything\n", stats.colliding_pairs);
+	}
+
+	return found;
+}
+
+MainLoop *test_broad_phase() {
+
+	Vector<BodySW *> objects;
+	for (int i = 0; i < BP_OBJECTS; i++) {
+		objects.push_back(memnew(BodySW));
+	}
+
+	BroadPhaseSW *octree = BroadPhaseOctree::_create();
+	int octree_found = _benchmark_broad_phase("Octree", octree, objects.ptrw());
+	memdelete(octree);
+
+	BroadPhaseSW *tree = BroadPhaseAABBTree::_create();
+	int tree_found = _benchmark_broad_phase("AABBTree", tree, objects.ptrw());
+	memdelete(tree);
+
+	// Both see the same objects, so queries must find the same amount.
+	OS::get_singleton()->print("%s\n", octree_found == tree_found ? "PASS" : "FAILED: query results differ");
+
+	for (int i = 0; i < objects.size(); i++) {
+		memdelete(objects[i]);
+	}
+
+	return NULL;
+}
+
+/* BATCHED QUERIES */
+
+enum {
+	BQ_BODIES = 4000,
+	BQ_EXCLUDED = 200,
+	BQ_RAYS = 20000,
+	BQ_SHAPES = 5000,
+};
+
+static const real_t BQ_WORLD_SIZE = 200.0;
+
+static bool _same_ray_result(const PhysicsDirectSpaceState::RayResult &p_a, const PhysicsDirectSpaceState::RayResult &p_b) {
+
+	return p_a.rid == p_b.rid && p_a.shape == p_b.shape && p_a.position == p_b.position && p_a.normal == p_b.normal;
+}
+
+MainLoop *test_batch_queries() {
+
+	PhysicsServer *ps = PhysicsServer::get_singleton();
+
+	RID space = ps->space_create();
+	ps->space_set_active(space, true);
+
+	RID box = ps->shape_create(PhysicsServer::SHAPE_BOX);
+	ps->shape_set_data(box, Vector3(1, 1, 1));
+	RID sphere = ps->shape_create(PhysicsServer::SHAPE_SPHERE);
+	ps->shape_set_data(sphere, 2.0);
+
+	uint32_t seed = 4321;
+	Vector<RID> bodies;
+	for (int i = 0; i < BQ_BODIES; i++) {
+
+		RID body = ps->body_create(PhysicsServer::BODY_MODE_STATIC);
+		ps->body_set_space(body, space);
+		ps->body_add_shape(body, box);
+		ps->body_set_collision_layer(body, i % 3 == 0 ? 2 : 1);
+		Vector3 pos(_bp_randf(seed), _bp_randf(seed), _bp_randf(seed));
+		ps->body_set_state(body, PhysicsServer::BODY_STATE_TRANSFORM, Transform(Basis(Vector3(0, 1, 0), _bp_randf(seed)), pos * BQ_WORLD_SIZE));
+		bodies.push_back(body);
+	}
+
+	Vector<RID> exclude;
+	Set<RID> exclude_set;
+	for (int i = 0; i < BQ_EXCLUDED; i++) {
+		exclude.push_back(bodies[i * (BQ_BODIES / BQ_EXCLUDED)]);
+		exclude_set.insert(exclude[i]);
+	}
+
+	uint32_t mask = 1;
+
+	Vector<Vector3> from;
+	Vector<Vector3> to;
+	for (int i = 0; i < BQ_RAYS; i++) {
+		from.push_back(Vector3(_bp_randf(seed), _bp_randf(seed), _bp_randf(seed)) * BQ_WORLD_SIZE);
+		to.push_back(Vector3(_bp_randf(seed), _bp_randf(seed), _bp_randf(seed)) * BQ_WORLD_SIZE);
+	}
+
+	Vector<Transform> xforms;
+	Vector<Vector3> motions;
+	for (int i = 0; i < BQ_SHAPES; i++) {
+		xforms.push_back(Transform(Basis(), Vector3(_bp_randf(seed), _bp_randf(seed), _bp_randf(seed)) * BQ_WORLD_SIZE));
+		motions.push_back(Vector3(_bp_randf(seed) - 0.5, _bp_randf(seed) - 0.5, _bp_randf(seed) - 0.5) * 20.0);
+	}
+
+	PhysicsDirectSpaceState *dss = ps->space_get_direct_state(space);
+	int mismatches = 0;
+
+	// rays
+
+	Vector<PhysicsDirectSpaceState::RayResult> single_rays;
+	single_rays.resize(BQ_RAYS);
+	Vector<bool> single_hits;
+	single_hits.resize(BQ_RAYS);
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < BQ_RAYS; i++) {
+		single_hits[i] = dss->intersect_ray(from[i], to[i], single_rays[i], exclude_set, mask);
+	}
+	uint64_t single_usec = OS::get_singleton()->get_ticks_usec() - t;
+
+	Vector<PhysicsDirectSpaceState::RayResult> batch_rays;
+	batch_rays.resize(BQ_RAYS);
+	Vector<bool> batch_hits;
+	batch_hits.resize(BQ_RAYS);
+
+	t = OS::get_singleton()->get_ticks_usec();
+	int hit_count = dss->intersect_ray_batch(from.ptr(), to.ptr(), BQ_RAYS, batch_rays.ptrw(), batch_hits.ptrw(), exclude, mask);
+	uint64_t batch_usec = OS::get_singleton()->get_ticks_usec() - t;
+
+	for (int i = 0; i < BQ_RAYS; i++) {
+		if (single_hits[i] != batch_hits[i] || (single_hits[i] && !_same_ray_result(single_rays[i], batch_rays[i])))
+			mismatches++;
+	}
+
+	OS::get_singleton()->print("intersect_ray, %d rays, %d hits:\n", BQ_RAYS, hit_count);
+	OS::get_singleton()->print("\tone by one: %f ms\n\tbatched: %f ms\n", single_usec / 1000.0, batch_usec / 1000.0);
+
+	// shapes
+
+	enum {
+		MAX_RESULTS = 8
+	};
+
+	Vector<PhysicsDirectSpaceState::ShapeResult> single_shapes;
+	single_shapes.resize(BQ_SHAPES * MAX_RESULTS);
+	Vector<int> single_counts;
+	single_counts.resize(BQ_SHAPES);
+
+	t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < BQ_SHAPES; i++) {
+		single_counts[i] = dss->intersect_shape(sphere, xforms[i], 0, &single_shapes[i * MAX_RESULTS], MAX_RESULTS, exclude_set, mask);
+	}
+	single_usec = OS::get_singleton()->get_ticks_usec() - t;
+
+	Vector<PhysicsDirectSpaceState::ShapeResult> batch_shapes;
+	batch_shapes.resize(BQ_SHAPES * MAX_RESULTS);
+	Vector<int> batch_counts;
+	batch_counts.resize(BQ_SHAPES);
+
+	t = OS::get_singleton()->get_ticks_usec();
+	dss->intersect_shape_batch(sphere, xforms.ptr(), BQ_SHAPES, 0, batch_shapes.ptrw(), MAX_RESULTS, batch_counts.ptrw(), exclude, mask);
+	batch_usec = OS::get_singleton()->get_ticks_usec() - t;
+
+	int found = 0;
+	for (int i = 0; i < BQ_SHAPES; i++) {
+
+		found += batch_counts[i];
+		if (single_counts[i] != batch_counts[i]) {
+			mismatches++;
+			continue;
+		}
+
+		for (int j = 0; j < batch_counts[i]; j++) {
+			const PhysicsDirectSpaceState::ShapeResult &a = single_shapes[i * MAX_RESULTS + j];
+			const PhysicsDirectSpaceState::ShapeResult &b = batch_shapes[i * MAX_RESULTS + j];
+			if (a.rid != b.rid || a.shape != b.shape)
+				mismatches++;
+		}
+	}
+
+	OS::get_singleton()->print("intersect_shape, %d spheres, %d results:\n", BQ_SHAPES, found);
+	OS::get_singleton()->print("\tone by one: %f ms\n\tbatched: %f ms\n", single_usec / 1000.0, batch_usec / 1000.0);
+
+	// motions
+
+	Vector<real_t> single_safe;
+	single_safe.resize(BQ_SHAPES);
+	Vector<real_t> single_unsafe;
+	single_unsafe.resize(BQ_SHAPES);
+
+	t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < BQ_SHAPES; i++) {
+
+		float safe, unsafe;
+		if (dss->cast_motion(sphere, xforms[i], motions[i], 0, safe, unsafe, exclude_set, mask)) {
+			single_safe[i] = safe;
+			single_unsafe[i] = unsafe;
+		} else {
+			single_safe[i] = 0;
+			single_unsafe[i] = 0;
+		}
+	}
+	single_usec = OS::get_singleton()->get_ticks_usec() - t;
+
+	Vector<real_t> batch_safe;
+	batch_safe.resize(BQ_SHAPES);
+	Vector<real_t> batch_unsafe;
+	batch_unsafe.resize(BQ_SHAPES);
+
+	t = OS::get_singleton()->get_ticks_usec();
+	dss->cast_motion_batch(sphere, xforms.ptr(), motions.ptr(), BQ_SHAPES, 0, batch_safe.ptrw(), batch_unsafe.ptrw(), exclude, mask);
+	batch_usec = OS::get_singleton()->get_ticks_usec() - t;
+
+	int blocked = 0;
+	for (int i = 0; i < BQ_SHAPES; i++) {
+
+		if (batch_safe[i] < 1)
+			blocked++;
+		if (single_safe[i] != batch_safe[i] || single_unsafe[i] != batch_unsafe[i])
+			mismatches++;
+	}
+
+	OS::get_singleton()->print("cast_motion, %d spheres, %d blocked:\n", BQ_SHAPES, blocked);
+	OS::get_singleton()->print("\tone by one: %f ms\n\tbatched: %f ms\n", single_usec / 1000.0, batch_usec / 1000.0);
+
+	// Batches must find exactly what the queries find one by one.
+	if (mismatches) {
+		OS::get_singleton()->print("FAILED: %d results differ\n", mismatches);
+	} else {
+		OS::get_singleton()->print("PASS\n");
+	}
+
+	for (int i = 0; i < bodies.size(); i++) {
+		ps->free(bodies[i]);
+	}
+	ps->free(sphere);
+	ps->free(box);
+	ps->free(space);
+
+	return NULL;
+}
+
+/* STEP DETERMINISM */
+
+enum {
+	SD_STACKS = 8, // per side
+	SD_STACK_HEIGHT = 5,
+	SD_FRAMES = 240,
+};
+
+static void _step_stacks(int p_thread_count, Vector<Transform> &r_transforms, Vector<bool> &r_sleeping) {
+
+	PhysicsServer *ps = PhysicsServer::get_singleton();
+
+	// the step reads its thread count when the server inits
+	ProjectSettings::get_singleton()->set("physics/3d/thread_count", p_thread_count);
+	ps->finish();
+	ps->init();
+
+	RID space = ps->space_create();
+	ps->space_set_active(space, true);
+
+	RID plane = ps->shape_create(PhysicsServer::SHAPE_PLANE);
+	ps->shape_set_data(plane, Plane(Vector3(0, 1, 0), 0));
+	RID box = ps->shape_create(PhysicsServer::SHAPE_BOX);
+	ps->shape_set_data(box, Vector3(0.5, 0.5, 0.5));
+
+	RID ground = ps->body_create(PhysicsServer::BODY_MODE_STATIC);
+	ps->body_set_space(ground, space);
+	ps->body_add_shape(ground, plane);
+
+	// stacks apart from each other, so there are many islands to spread among threads
+	Vector<RID> bodies;
+	for (int x = 0; x < SD_STACKS; x++) {
+		for (int z = 0; z < SD_STACKS; z++) {
+			for (int y = 0; y < SD_STACK_HEIGHT; y++) {
+
+				RID body = ps->body_create(PhysicsServer::BODY_MODE_RIGID);
+				ps->body_set_space(body, space);
+				ps->body_add_shape(body, box);
+				ps->body_set_state(body, PhysicsServer::BODY_STATE_TRANSFORM, Transform(Basis(Vector3(0, 1, 0), 0.1 * x), Vector3(x * 3, 0.5 + y * 1.01, z * 3)));
+				bodies.push_back(body);
+			}
+		}
+	}
+
+	for (int i = 0; i < SD_FRAMES; i++) {
+		ps->step(1.0 / 60.0);
+		ps->flush_queries();
+	}
+
+	r_transforms.resize(bodies.size());
+	r_sleeping.resize(bodies.size());
+	for (int i = 0; i < bodies.size(); i++) {
+		r_transforms[i] = ps->body_get_state(bodies[i], PhysicsServer::BODY_STATE_TRANSFORM);
+		r_sleeping[i] = ps->body_get_state(bodies[i], PhysicsServer::BODY_STATE_SLEEPING);
+		ps->free(bodies[i]);
+	}
+	ps->free(ground);
+	ps->free(box);
+	ps->free(plane);
+	ps->free(space);
+}
+
+MainLoop *test_step_determinism() {
+
+	int prev_thread_count = ProjectSettings::get_singleton()->get("physics/3d/thread_count");
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	Vector<Transform> serial;
+	Vector<bool> serial_sleeping;
+	_step_stacks(0, serial, serial_sleeping);
+	uint64_t serial_usec = OS::get_singleton()->get_ticks_usec() - t;
+
+	t = OS::get_singleton()->get_ticks_usec();
+	Vector<Transform> parallel;
+	Vector<bool> parallel_sleeping;
+	_step_stacks(-1, parallel, parallel_sleeping);
+	uint64_t parallel_usec = OS::get_singleton()->get_ticks_usec() - t;
+
+	ProjectSettings::get_singleton()->set("physics/3d/thread_count", prev_thread_count);
+	PhysicsServer::get_singleton()->finish();
+	PhysicsServer::get_singleton()->init();
+
+	int workers = JobSystem::get_singleton() ? JobSystem::get_singleton()->get_thread_count() : 0;
+	OS::get_singleton()->print("%d bodies, %d frames:\n", serial.size(), SD_FRAMES);
+	OS::get_singleton()->print("\tthread_count 0: %f ms\n\tthread_count -1 (%d workers): %f ms\n", serial_usec / 1000.0, workers, parallel_usec / 1000.0);
+
+	// Islands are stepped on one thread each, so the results must be the same bit by bit.
+	int mismatches = 0;
+	for (int i = 0; i < serial.size(); i++) {
+		if (serial[i] != parallel[i] || serial_sleeping[i] != parallel_sleeping[i])
+			mismatches++;
+	}
+
+	if (mismatches) {
+		OS::get_singleton()->print("FAILED: %d bodies differ\n", mismatches);
+	} else {
+		OS::get_singleton()->print("PASS\n");
+	}
+
+	return NULL;
+}
 } // namespace TestPhysics
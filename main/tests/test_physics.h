@@ -39,6 +39,9 @@
 namespace TestPhysics {
 
 MainLoop *test();
+MainLoop *test_broad_phase();
+MainLoop *test_batch_queries();
+MainLoop *test_step_determinism();
 }
 
 #endif
@@ -30,10 +30,15 @@
 #include "test_physics_2d.h"
 
 #include "map.h"
+#include "os/job_system.h"
 #include "os/main_loop.h"
 #include "os/os.h"
+#include "os/thread.h"
 #include "print_string.h"
+#include "project_settings.h"
 #include "scene/resources/texture.h"
+#include "servers/physics_2d/physics_2d_server_sw.h"
+#include "servers/physics_2d/physics_2d_server_wrap_mt.h"
 #include "servers/physics_2d_server.h"
 #include "servers/visual_server.h"
 
@@ -431,4 +436,220 @@ MainLoop *test() {
 
 	return memnew(TestPhysics2DMainLoop);
 }
+
+/* STEP DETERMINISM AND OVERLAPPED STEP */
+
+// These create servers of their own, which take over the 2D server singletons
+// from the engine's server, so they can only run as tests of their own.
+
+enum {
+	SD_COLUMNS = 40,
+	SD_COLUMN_HEIGHT = 10,
+	SD_FRAMES = 300,
+};
+
+struct SecondThreadCalls {
+
+	Physics2DServer *ps;
+	RID body;
+	volatile bool exit;
+	volatile bool done;
+	int calls;
+	int mismatches;
+};
+
+static void _second_thread_calls(void *p_userdata) {
+
+	SecondThreadCalls *c = (SecondThreadCalls *)p_userdata;
+
+	// the setter is queued and the getter waits for it, whichever thread runs them
+	while (!c->exit) {
+
+		c->calls++;
+		c->ps->body_set_param(c->body, Physics2DServer::BODY_PARAM_MASS, c->calls);
+		if (c->ps->body_get_param(c->body, Physics2DServer::BODY_PARAM_MASS) != c->calls)
+			c->mismatches++;
+	}
+
+	c->done = true;
+}
+
+static int _step_columns(int p_thread_count, bool p_overlapped, int p_frames, Vector<Transform2D> &r_transforms, Vector<bool> &r_sleeping, SecondThreadCalls *r_calls = NULL) {
+
+	// the step reads its thread count when the server inits
+	ProjectSettings::get_singleton()->set("physics/2d/thread_count", p_thread_count);
+
+	Physics2DServer *ps;
+	if (p_overlapped) {
+		ps = memnew(Physics2DServerWrapMT(memnew(Physics2DServerSW), true, true));
+	} else {
+		ps = memnew(Physics2DServerSW);
+	}
+	ps->init();
+
+	RID space = ps->space_create();
+	ps->space_set_active(space, true);
+
+	RID segment = ps->segment_shape_create();
+	ps->shape_set_data(segment, Rect2(-1000, 0, 2000, 0));
+	RID box = ps->rectangle_shape_create();
+	ps->shape_set_data(box, Vector2(5, 5));
+
+	RID ground = ps->body_create();
+	ps->body_set_mode(ground, Physics2DServer::BODY_MODE_STATIC);
+	ps->body_set_space(ground, space);
+	ps->body_add_shape(ground, segment);
+
+	// columns apart from each other, so there are many islands to spread among threads
+	Vector<RID> bodies;
+	for (int x = 0; x < SD_COLUMNS; x++) {
+		for (int y = 0; y < SD_COLUMN_HEIGHT; y++) {
+
+			RID body = ps->body_create();
+			ps->body_set_space(body, space);
+			ps->body_add_shape(body, box);
+			ps->body_set_state(body, Physics2DServer::BODY_STATE_TRANSFORM, Transform2D(0.05 * x, Vector2(x * 30 - 600, -5 - y * 10.1)));
+			bodies.push_back(body);
+		}
+	}
+
+	Thread *thread = NULL;
+	if (r_calls) {
+		r_calls->ps = ps;
+		r_calls->body = ps->body_create(); // not in the space, so it doesn't change the results
+		r_calls->exit = false;
+		r_calls->done = false;
+		r_calls->calls = 0;
+		r_calls->mismatches = 0;
+		thread = Thread::create(_second_thread_calls, r_calls);
+	}
+
+	// same order as Main::iteration()
+	int frames = 0;
+	for (; frames < p_frames || (r_calls && !r_calls->done); frames++) {
+
+		if (r_calls && frames == p_frames)
+			r_calls->exit = true; // keep stepping, the last getter waits for the next step to run
+
+		ps->sync();
+		ps->flush_queries();
+		ps->end_sync();
+		ps->step(1.0 / 60.0);
+
+		// called while the step runs, when it's overlapped
+		ps->body_set_param(bodies[frames % bodies.size()], Physics2DServer::BODY_PARAM_BOUNCE, 0.0);
+	}
+
+	if (thread) {
+		Thread::wait_to_finish(thread);
+		memdelete(thread);
+		ps->free(r_calls->body);
+	}
+
+	ps->sync();
+
+	r_transforms.resize(bodies.size());
+	r_sleeping.resize(bodies.size());
+	for (int i = 0; i < bodies.size(); i++) {
+		r_transforms[i] = ps->body_get_state(bodies[i], Physics2DServer::BODY_STATE_TRANSFORM);
+		r_sleeping[i] = ps->body_get_state(bodies[i], Physics2DServer::BODY_STATE_SLEEPING);
+	}
+
+	ps->end_sync();
+
+	for (int i = 0; i < bodies.size(); i++) {
+		ps->free(bodies[i]);
+	}
+	ps->free(ground);
+	ps->free(box);
+	ps->free(segment);
+	ps->free(space);
+
+	ps->finish();
+	memdelete(ps);
+
+	return frames;
+}
+
+static int _count_mismatches(const Vector<Transform2D> &p_transforms_a, const Vector<bool> &p_sleeping_a, const Vector<Transform2D> &p_transforms_b, const Vector<bool> &p_sleeping_b) {
+
+	int mismatches = 0;
+	for (int i = 0; i < p_transforms_a.size(); i++) {
+		if (p_transforms_a[i] != p_transforms_b[i] || p_sleeping_a[i] != p_sleeping_b[i])
+			mismatches++;
+	}
+
+	return mismatches;
+}
+
+MainLoop *test_step_determinism() {
+
+	int prev_thread_count = ProjectSettings::get_singleton()->get("physics/2d/thread_count");
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	Vector<Transform2D> serial;
+	Vector<bool> serial_sleeping;
+	_step_columns(0, false, SD_FRAMES, serial, serial_sleeping);
+	uint64_t serial_usec = OS::get_singleton()->get_ticks_usec() - t;
+
+	t = OS::get_singleton()->get_ticks_usec();
+	Vector<Transform2D> parallel;
+	Vector<bool> parallel_sleeping;
+	_step_columns(-1, false, SD_FRAMES, parallel, parallel_sleeping);
+	uint64_t parallel_usec = OS::get_singleton()->get_ticks_usec() - t;
+
+	ProjectSettings::get_singleton()->set("physics/2d/thread_count", prev_thread_count);
+
+	int workers = JobSystem::get_singleton() ? JobSystem::get_singleton()->get_thread_count() : 0;
+	OS::get_singleton()->print("%d bodies, %d frames:\n", serial.size(), SD_FRAMES);
+	OS::get_singleton()->print("\tthread_count 0: %f ms\n\tthread_count -1 (%d workers): %f ms\n", serial_usec / 1000.0, workers, parallel_usec / 1000.0);
+
+	// Islands are stepped on one thread each, so the results must be the same bit by bit.
+	int mismatches = _count_mismatches(serial, serial_sleeping, parallel, parallel_sleeping);
+	if (mismatches) {
+		OS::get_singleton()->print("FAILED: %d bodies differ\n", mismatches);
+	} else {
+		OS::get_singleton()->print("PASS\n");
+	}
+
+	return NULL;
+}
+
+MainLoop *test_overlapped_step() {
+
+	int prev_thread_count = ProjectSettings::get_singleton()->get("physics/2d/thread_count");
+
+	// the server checks the thread model to know whether it runs on a thread of its own
+	int prev_thread_model = ProjectSettings::get_singleton()->get("physics/2d/thread_model");
+	ProjectSettings::get_singleton()->set("physics/2d/thread_model", 3);
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	Vector<Transform2D> overlapped;
+	Vector<bool> overlapped_sleeping;
+	SecondThreadCalls calls;
+	int frames = _step_columns(-1, true, SD_FRAMES, overlapped, overlapped_sleeping, &calls);
+	uint64_t overlapped_usec = OS::get_singleton()->get_ticks_usec() - t;
+
+	ProjectSettings::get_singleton()->set("physics/2d/thread_model", prev_thread_model);
+
+	// as many frames as it took the second thread to stop
+	Vector<Transform2D> serial;
+	Vector<bool> serial_sleeping;
+	_step_columns(0, false, frames, serial, serial_sleeping);
+
+	ProjectSettings::get_singleton()->set("physics/2d/thread_count", prev_thread_count);
+
+	OS::get_singleton()->print("%d bodies, %d frames overlapped: %f ms\n", overlapped.size(), frames, overlapped_usec / 1000.0);
+	OS::get_singleton()->print("\t%d calls from a second thread, %d returned a stale value\n", calls.calls, calls.mismatches);
+
+	// Stepping on the server thread must not change the results either.
+	int mismatches = _count_mismatches(serial, serial_sleeping, overlapped, overlapped_sleeping);
+	if (mismatches || calls.mismatches || calls.calls == 0) {
+		OS::get_singleton()->print("FAILED: %d bodies differ, %d calls from the second thread went wrong\n", mismatches, calls.mismatches);
+	} else {
+		OS::get_singleton()->print("PASS\n");
+	}
+
+	return NULL;
+}
 } // namespace TestPhysics2D
@@ -35,6 +35,8 @@
 namespace TestPhysics2D {
 
 MainLoop *test();
+MainLoop *test_step_determinism();
+MainLoop *test_overlapped_step();
 }
 
 #endif // TEST_PHYSICS_2D_H
@@ -0,0 +1,330 @@
+/*************************************************************************/
+/*  test_pool_vector.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_pool_vector.h"
+
+#include "core/dvector.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/safe_refcount.h"
+
+namespace TestPoolVector {
+
+enum {
+	THREADS = 4,
+	SHARED_VECTORS = 256,
+	LIVE_VECTORS = 256,
+	ROUNDS = 100000,
+	ALLOC_KEPT = 40, // fewer than a thread keeps before giving some back
+};
+
+static uint32_t _rand(uint32_t *p_seed) {
+
+	*p_seed = *p_seed * 1103515245 + 12345;
+	return (*p_seed >> 16) & 0x7FFF;
+}
+
+static void _fill(PoolVector<int> &p_vector, int p_size, int p_value) {
+
+	p_vector.resize(p_size);
+	PoolVector<int>::Write w = p_vector.write();
+	for (int i = 0; i < p_size; i++) {
+		w[i] = p_value + i;
+	}
+}
+
+static bool _check(const PoolVector<int> &p_vector, int p_value) {
+
+	PoolVector<int>::Read r = p_vector.read();
+	for (int i = 0; i < p_vector.size(); i++) {
+		if (r[i] != p_value + i)
+			return false;
+	}
+	return true;
+}
+
+struct Slot {
+
+	PoolVector<int> vector;
+	int value;
+};
+
+// Every thread starts with copies of the same vectors, so their allocs are shared until written and freed by whichever thread drops them last.
+static Slot copies[THREADS][SHARED_VECTORS];
+
+struct ThreadData {
+
+	int index;
+	uint32_t seed;
+	bool ok;
+};
+
+static ThreadData thread_data[THREADS];
+
+static void _thread_func(void *p_userdata) {
+
+	ThreadData *td = (ThreadData *)p_userdata;
+	Slot *slots = copies[td->index];
+
+	for (int i = 0; i < ROUNDS; i++) {
+
+		// a write by another thread to a vector still shared would show here
+		Slot &slot = slots[_rand(&td->seed) % SHARED_VECTORS];
+		if (!_check(slot.vector, slot.value))
+			td->ok = false;
+
+		switch (_rand(&td->seed) % 3) {
+
+			case 0: {
+				// copy on write, or new contents if it was dropped
+				int size = slot.vector.size() ? slot.vector.size() : 1 + _rand(&td->seed) % 64;
+				slot.value = td->index * 100000 + i;
+				_fill(slot.vector, size, slot.value);
+			} break;
+			case 1: {
+				// share with another slot of this thread
+				Slot &other = slots[_rand(&td->seed) % SHARED_VECTORS];
+				slot.vector = other.vector;
+				slot.value = other.value;
+			} break;
+			case 2: {
+				slot.vector = PoolVector<int>();
+			} break;
+		}
+	}
+
+	for (int i = 0; i < SHARED_VECTORS; i++) {
+		if (!_check(slots[i].vector, slots[i].value))
+			td->ok = false;
+		slots[i].vector = PoolVector<int>();
+	}
+}
+
+bool test_threads() {
+
+	OS::get_singleton()->print("\n\nTest 1: Copy on write of vectors shared by threads\n");
+
+	MemoryPool::release_thread_cache();
+	uint32_t used_before = MemoryPool::allocs_used;
+
+	// allocated here, the threads hold the only references
+	for (int i = 0; i < SHARED_VECTORS; i++) {
+
+		PoolVector<int> vector;
+		_fill(vector, 1 + i % 64, i);
+
+		for (int j = 0; j < THREADS; j++) {
+			copies[j][i].vector = vector;
+			copies[j][i].value = i;
+		}
+	}
+
+	Thread *threads[THREADS];
+	for (int i = 0; i < THREADS; i++) {
+		thread_data[i].index = i;
+		thread_data[i].seed = 1234 + i;
+		thread_data[i].ok = true;
+	}
+	for (int i = 0; i < THREADS; i++) {
+		threads[i] = Thread::create(_thread_func, &thread_data[i]);
+	}
+
+	bool ok = true;
+	for (int i = 0; i < THREADS; i++) {
+		Thread::wait_to_finish(threads[i]);
+		memdelete(threads[i]);
+		ok = ok && thread_data[i].ok;
+	}
+
+	OS::get_singleton()->print("\tvectors kept their contents: %s\n", ok ? "yes" : "no");
+
+	// Threads give their cached allocs back when they end, so all of them must be free again.
+	MemoryPool::release_thread_cache();
+	uint32_t used_after = MemoryPool::allocs_used;
+	OS::get_singleton()->print("\tallocs in use before: %i, after: %i\n", int(used_before), int(used_after));
+
+	return ok && used_before == used_after;
+}
+
+struct IdleThread {
+
+	uint32_t kept;
+	uint32_t ready;
+	uint32_t done;
+};
+
+// Frees some vectors and waits, keeping their allocs in its cache.
+static void _idle_func(void *p_userdata) {
+
+	IdleThread *it = (IdleThread *)p_userdata;
+
+	{
+		PoolVector<uint8_t> vectors[ALLOC_KEPT];
+		for (int i = 0; i < ALLOC_KEPT; i++) {
+			vectors[i].resize(1);
+		}
+	}
+
+	it->kept = MemoryPool::_get_thread_cache()->count;
+	atomic_increment(&it->ready);
+
+	while (static_cast<volatile uint32_t &>(it->done) == 0) {
+		OS::get_singleton()->delay_usec(100);
+	}
+}
+
+bool test_exhaustion() {
+
+	OS::get_singleton()->print("\n\nTest 2: All allocs in use\n");
+
+	IdleThread idle;
+	idle.kept = 0;
+	idle.ready = 0;
+	idle.done = 0;
+	Thread *thread = Thread::create(_idle_func, &idle);
+	while (static_cast<volatile uint32_t &>(idle.ready) == 0) {
+		OS::get_singleton()->delay_usec(100);
+	}
+
+	// The allocs kept by the idle thread count as used, but must be taken too.
+	MemoryPool::release_thread_cache();
+	int available = MemoryPool::alloc_count - MemoryPool::allocs_used + idle.kept;
+
+	PoolVector<uint8_t> *vectors = memnew_arr(PoolVector<uint8_t>, available + 1);
+	int allocated = 0;
+	for (int i = 0; i < available; i++) {
+		if (vectors[i].resize(1) == OK)
+			allocated++;
+	}
+
+	// must fail without touching anything
+	Error err = vectors[available].resize(1);
+	bool ok = idle.kept > 0 && allocated == available && err == ERR_OUT_OF_MEMORY && vectors[available].size() == 0;
+
+	memdelete_arr(vectors);
+	MemoryPool::release_thread_cache();
+
+	atomic_increment(&idle.done);
+	Thread::wait_to_finish(thread);
+	memdelete(thread);
+
+	OS::get_singleton()->print("\tallocated %i of %i (%i kept by an idle thread), then %s\n", allocated, available, int(idle.kept), err == ERR_OUT_OF_MEMORY ? "out of memory" : "no error");
+	ok = ok && MemoryPool::alloc_count - MemoryPool::allocs_used == uint32_t(available);
+
+	return ok;
+}
+
+static void _bench_func(void *p_userdata) {
+
+	uint32_t seed = 4321 + (int)(intptr_t)p_userdata;
+	PoolVector<uint8_t> vectors[LIVE_VECTORS];
+
+	for (int i = 0; i < ROUNDS * 4; i++) {
+
+		PoolVector<uint8_t> &v = vectors[_rand(&seed) % LIVE_VECTORS];
+		if (v.size()) {
+			// a copy written to, like most script and resource code does
+			PoolVector<uint8_t> copy = v;
+			copy.set(0, 1);
+			v = PoolVector<uint8_t>();
+		} else {
+			v.resize(1 + _rand(&seed) % 32);
+		}
+	}
+}
+
+static uint64_t _run_bench(int p_threads) {
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+
+	Thread *threads[THREADS];
+	for (int i = 0; i < p_threads; i++) {
+		threads[i] = Thread::create(_bench_func, (void *)(intptr_t)i);
+	}
+	for (int i = 0; i < p_threads; i++) {
+		Thread::wait_to_finish(threads[i]);
+		memdelete(threads[i]);
+	}
+
+	return OS::get_singleton()->get_ticks_usec() - begin;
+}
+
+bool test_benchmark() {
+
+	OS::get_singleton()->print("\n\nTest 3: Benchmark\n");
+
+	MemoryPool::release_thread_cache();
+	uint32_t used_before = MemoryPool::allocs_used;
+
+	for (int threads = 1; threads <= THREADS; threads *= 2) {
+
+		uint64_t usec = _run_bench(threads);
+		OS::get_singleton()->print("\t%i threads, %i operations each: %i msec\n", threads, ROUNDS * 4, int(usec / 1000));
+	}
+
+	MemoryPool::release_thread_cache();
+	return MemoryPool::allocs_used == used_before;
+}
+
+typedef bool (*TestFunc)(void);
+
+TestFunc test_funcs[] = {
+
+	test_threads,
+	test_exhaustion,
+	test_benchmark,
+	0
+};
+
+MainLoop *test() {
+
+	int count = 0;
+	int passed = 0;
+
+	while (true) {
+		if (!test_funcs[count])
+			break;
+		bool pass = test_funcs[count]();
+		if (pass)
+			passed++;
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+
+		count++;
+	}
+
+	OS::get_singleton()->print("\n\n\n");
+	OS::get_singleton()->print("*************\n");
+	OS::get_singleton()->print("***TOTALS!***\n");
+	OS::get_singleton()->print("*************\n");
+
+	OS::get_singleton()->print("Passed %i of %i tests\n", passed, count);
+
+	return NULL;
+}
+} // namespace TestPoolVector
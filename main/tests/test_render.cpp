@@ -241,4 +241,136 @@ MainLoop *test() {
 
 	return memnew(TestMainLoop);
 }
+
+/* CULL BENCHMARK */
+
+#define CULL_OBJECT_COUNT 20000
+#define CULL_LIGHT_COUNT 32
+#define CULL_FRAMES 100
+
+// Times whole frames of a large scene with shadowed lights, works with the headless server too.
+class TestCullMainLoop : public MainLoop {
+
+	RID mesh;
+	RID camera;
+	RID viewport;
+	RID scenario;
+	Vector<RID> instances;
+	Vector<RID> lights;
+
+	int frame;
+	uint64_t frame_usec;
+	uint64_t last_ticks;
+
+public:
+	virtual void input_event(const Ref<InputEvent> &p_event) {
+	}
+
+	virtual void init() {
+
+		VisualServer *vs = VisualServer::get_singleton();
+		scenario = vs->scenario_create();
+		mesh = vs->get_test_cube();
+
+		List<String> cmdline = OS::get_singleton()->get_cmdline_args();
+		int object_count = CULL_OBJECT_COUNT;
+		if (cmdline.size() > 0 && cmdline[cmdline.size() - 1].to_int()) {
+			object_count = cmdline[cmdline.size() - 1].to_int();
+		}
+
+		Math::seed(1234);
+
+		for (int i = 0; i < object_count; i++) {
+
+			RID instance = vs->instance_create2(mesh, scenario);
+			vs->instance_set_transform(instance, Transform(Basis(), Vector3(Math::random(-200, 200), Math::random(0, 20), Math::random(-200, 200))));
+			instances.push_back(instance);
+		}
+
+		for (int i = 0; i < CULL_LIGHT_COUNT; i++) {
+
+			RID light = i % 2 ? vs->omni_light_create() : vs->spot_light_create();
+			vs->light_set_param(light, VisualServer::LIGHT_PARAM_RANGE, 20);
+			vs->light_set_shadow(light, true);
+			if (i % 4 == 1) {
+				vs->light_omni_set_shadow_mode(light, VisualServer::LIGHT_OMNI_SHADOW_CUBE);
+			}
+			lights.push_back(light);
+
+			RID instance = vs->instance_create2(light, scenario);
+			vs->instance_set_transform(instance, Transform(Basis(Vector3(1, 0, 0), -0.5), Vector3(Math::random(-50, 50), 5, Math::random(-100, 0))));
+			instances.push_back(instance);
+		}
+
+		RID sun = vs->directional_light_create();
+		vs->light_set_shadow(sun, true);
+		vs->light_directional_set_shadow_mode(sun, VisualServer::LIGHT_DIRECTIONAL_SHADOW_PARALLEL_4_SPLITS);
+		lights.push_back(sun);
+
+		RID sun_instance = vs->instance_create2(sun, scenario);
+		vs->instance_set_transform(sun_instance, Transform(Basis(Vector3(1, 0, 0), -0.8), Vector3()));
+		instances.push_back(sun_instance);
+
+		camera = vs->camera_create();
+		vs->camera_set_perspective(camera, 70, 0.1, 300);
+
+		viewport = vs->viewport_create();
+		Size2i screen_size = OS::get_singleton()->get_window_size();
+		vs->viewport_set_size(viewport, MAX(screen_size.x, 1), MAX(screen_size.y, 1));
+		vs->viewport_attach_to_screen(viewport, Rect2(Vector2(), screen_size));
+		vs->viewport_set_active(viewport, true);
+		vs->viewport_attach_camera(viewport, camera);
+		vs->viewport_set_scenario(viewport, scenario);
+		vs->viewport_set_shadow_atlas_size(viewport, 4096);
+
+		frame = 0;
+		frame_usec = 0;
+		last_ticks = OS::get_singleton()->get_ticks_usec();
+
+		OS::get_singleton()->print("%d objects, %d shadowed lights\n", object_count, lights.size());
+	}
+
+	virtual bool iteration(float p_time) {
+
+		uint64_t ticks = OS::get_singleton()->get_ticks_usec();
+		if (frame > 0) { // the first frame pairs everything
+			frame_usec += ticks - last_ticks;
+		}
+		last_ticks = ticks;
+
+		VisualServer::get_singleton()->camera_set_transform(camera, Transform(Basis(Vector3(0, 1, 0), frame * 0.05), Vector3(0, 10, 0)));
+
+		frame++;
+		if (frame <= CULL_FRAMES)
+			return false;
+
+		OS::get_singleton()->print("average frame: %f ms\n", frame_usec / 1000.0 / (CULL_FRAMES - 1));
+		return true;
+	}
+
+	virtual bool idle(float p_time) {
+		return false;
+	}
+
+	virtual void finish() {
+
+		VisualServer *vs = VisualServer::get_singleton();
+
+		for (int i = 0; i < instances.size(); i++) {
+			vs->free(instances[i]);
+		}
+		for (int i = 0; i < lights.size(); i++) {
+			vs->free(lights[i]);
+		}
+
+		vs->free(viewport);
+		vs->free(camera);
+		vs->free(scenario);
+	}
+};
+
+MainLoop *test_cull() {
+
+	return memnew(TestCullMainLoop);
+}
 } // namespace TestRender
@@ -39,6 +39,7 @@
 namespace TestRender {
 
 MainLoop *test();
+MainLoop *test_cull();
 }
 
 #endif
@@ -0,0 +1,221 @@
+/*************************************************************************/
+/*  test_signals.cpp                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_signals.h"
+
+#include "core/class_db.h"
+#include "core/os/os.h"
+
+namespace TestSignals {
+
+enum {
+	RECEIVERS = 8,
+	EMISSIONS = 100000,
+};
+
+class Emitter : public Object {
+
+	GDCLASS(Emitter, Object);
+
+protected:
+	static void _bind_methods() {
+
+		ADD_SIGNAL(MethodInfo("fired", PropertyInfo(Variant::INT, "value")));
+	}
+};
+
+class Receiver : public Object {
+
+	GDCLASS(Receiver, Object);
+
+protected:
+	static void _bind_methods() {
+
+		ClassDB::bind_method(D_METHOD("_on_fired", "value"), &Receiver::_on_fired);
+		ClassDB::bind_method(D_METHOD("_on_fired_bound", "value", "extra"), &Receiver::_on_fired_bound);
+		ClassDB::bind_method(D_METHOD("_on_fired_disconnect", "value"), &Receiver::_on_fired_disconnect);
+	}
+
+public:
+	Emitter *emitter;
+	Receiver *other;
+	int calls;
+	int sum;
+
+	void _on_fired(int p_value) {
+
+		calls++;
+		sum += p_value;
+	}
+
+	void _on_fired_bound(int p_value, int p_extra) {
+
+		calls++;
+		sum += p_value + p_extra;
+	}
+
+	void _on_fired_disconnect(int p_value) {
+
+		calls++;
+		// changes the slots of the signal being emitted
+		emitter->disconnect("fired", other, "_on_fired");
+		emitter->disconnect("fired", this, "_on_fired_disconnect");
+		emitter->connect("fired", this, "_on_fired");
+	}
+
+	Receiver() {
+
+		emitter = NULL;
+		other = NULL;
+		calls = 0;
+		sum = 0;
+	}
+};
+
+static bool test_emit_throughput() {
+
+	OS::get_singleton()->print("\n\nTest 1: Emit a signal with %d receivers %d times\n", RECEIVERS, EMISSIONS);
+
+	Emitter *emitter = memnew(Emitter);
+	Receiver *receivers[RECEIVERS];
+	for (int i = 0; i < RECEIVERS; i++) {
+		receivers[i] = memnew(Receiver);
+		if (i % 2) {
+			emitter->connect("fired", receivers[i], "_on_fired_bound", varray(i));
+		} else {
+			emitter->connect("fired", receivers[i], "_on_fired");
+		}
+	}
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+
+	for (int i = 0; i < EMISSIONS; i++) {
+		emitter->emit_signal("fired", 1);
+	}
+
+	uint64_t usec = OS::get_singleton()->get_ticks_usec() - t;
+	OS::get_singleton()->print("\t%f emissions/sec, %f calls/sec\n", EMISSIONS * 1000000.0 / MAX(usec, 1), EMISSIONS * RECEIVERS * 1000000.0 / MAX(usec, 1));
+
+	bool ok = true;
+	for (int i = 0; i < RECEIVERS; i++) {
+		int expected = i % 2 ? EMISSIONS * (1 + i) : EMISSIONS;
+		ok = ok && receivers[i]->calls == EMISSIONS && receivers[i]->sum == expected;
+		memdelete(receivers[i]);
+	}
+	memdelete(emitter);
+
+	return ok;
+}
+
+static bool test_disconnect_while_emitting() {
+
+	OS::get_singleton()->print("\n\nTest 2: Connect and disconnect from a receiver while emitting\n");
+
+	Emitter *emitter = memnew(Emitter);
+	Receiver *a = memnew(Receiver);
+	Receiver *b = memnew(Receiver);
+	a->emitter = emitter;
+	a->other = b;
+	emitter->connect("fired", a, "_on_fired_disconnect");
+	emitter->connect("fired", b, "_on_fired");
+
+	// the slots are kept as they were when the emission started
+	emitter->emit_signal("fired", 1);
+	bool ok = a->calls == 1 && b->calls == 1;
+
+	emitter->emit_signal("fired", 1);
+	ok = ok && a->calls == 2 && a->sum == 1 && b->calls == 1;
+	ok = ok && emitter->is_connected("fired", a, "_on_fired") && !emitter->is_connected("fired", b, "_on_fired");
+
+	memdelete(a);
+	memdelete(b);
+	memdelete(emitter);
+
+	return ok;
+}
+
+static bool test_oneshot() {
+
+	OS::get_singleton()->print("\n\nTest 3: One shot connections\n");
+
+	Emitter *emitter = memnew(Emitter);
+	Receiver *a = memnew(Receiver);
+	Receiver *b = memnew(Receiver);
+	emitter->connect("fired", a, "_on_fired", varray(), Object::CONNECT_ONESHOT);
+	emitter->connect("fired", b, "_on_fired_bound", varray(2), Object::CONNECT_ONESHOT);
+
+	emitter->emit_signal("fired", 1);
+	emitter->emit_signal("fired", 1);
+
+	bool ok = a->calls == 1 && b->calls == 1 && b->sum == 3;
+	ok = ok && !emitter->is_connected("fired", a, "_on_fired") && !emitter->is_connected("fired", b, "_on_fired_bound");
+
+	memdelete(a);
+	memdelete(b);
+	memdelete(emitter);
+
+	return ok;
+}
+
+typedef bool (*TestFunc)(void);
+
+TestFunc test_funcs[] = {
+
+	test_emit_throughput,
+	test_disconnect_while_emitting,
+	test_oneshot,
+	0
+};
+
+MainLoop *test() {
+
+	int count = 0;
+	int passed = 0;
+
+	while (true) {
+		if (!test_funcs[count])
+			break;
+		bool pass = test_funcs[count]();
+		if (pass)
+			passed++;
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+
+		count++;
+	}
+
+	OS::get_singleton()->print("\n\n\n");
+	OS::get_singleton()->print("*************\n");
+	OS::get_singleton()->print("***TOTALS!***\n");
+	OS::get_singleton()->print("*************\n");
+
+	OS::get_singleton()->print("Passed %i of %i tests\n", passed, count);
+
+	return NULL;
+}
+} // namespace TestSignals
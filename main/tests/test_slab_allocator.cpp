@@ -0,0 +1,331 @@
+/*************************************************************************/
+/*  test_slab_allocator.cpp                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_slab_allocator.h"
+
+#include "core/os/os.h"
+#include "core/os/slab_allocator.h"
+#include "core/os/thread.h"
+#include "core/safe_refcount.h"
+
+#include <stdlib.h>
+
+namespace TestSlabAllocator {
+
+enum {
+	THREADS = 4,
+	LIVE_BLOCKS = 1024,
+	ROUNDS = 200000,
+};
+
+static void _fill(uint8_t *p_block, uint32_t p_size, uint8_t p_value) {
+
+	for (uint32_t i = sizeof(void *); i < p_size; i++) {
+		p_block[i] = p_value;
+	}
+}
+
+static bool _check(const uint8_t *p_block, uint32_t p_size, uint8_t p_value) {
+
+	for (uint32_t i = sizeof(void *); i < p_size; i++) {
+		if (p_block[i] != p_value)
+			return false;
+	}
+	return true;
+}
+
+struct Slot {
+
+	uint8_t *block;
+	int size_class;
+	uint8_t value;
+};
+
+// Blocks handed from one thread to the next, so they are freed by a thread that didn't allocate them.
+static Slot handoff[THREADS][LIVE_BLOCKS];
+
+struct ThreadData {
+
+	int index;
+	uint32_t seed;
+	uint32_t handoff_ready;
+	bool ok;
+};
+
+static ThreadData thread_data[THREADS];
+
+static uint32_t _rand(uint32_t *p_seed) {
+
+	*p_seed = *p_seed * 1103515245 + 12345;
+	return (*p_seed >> 16) & 0x7FFF;
+}
+
+static void _thread_func(void *p_userdata) {
+
+	ThreadData *td = (ThreadData *)p_userdata;
+	Slot *slots = handoff[td->index];
+
+	for (int i = 0; i < LIVE_BLOCKS; i++) {
+		slots[i].block = NULL;
+	}
+
+	for (int i = 0; i < ROUNDS; i++) {
+
+		Slot &slot = slots[_rand(&td->seed) % LIVE_BLOCKS];
+		if (slot.block) {
+			if (!_check(slot.block, SlabAllocator::get_block_size(slot.size_class), slot.value))
+				td->ok = false;
+			SlabAllocator::free(slot.block, slot.size_class);
+		}
+
+		slot.size_class = SlabAllocator::get_size_class(1 + _rand(&td->seed) % SlabAllocator::MAX_BLOCK_SIZE);
+		slot.value = td->index * 64 + i % 64;
+		slot.block = (uint8_t *)SlabAllocator::alloc(slot.size_class);
+		if (!slot.block || (size_t(slot.block) & 15)) {
+			td->ok = false;
+			slot.block = NULL;
+			continue;
+		}
+		_fill(slot.block, SlabAllocator::get_block_size(slot.size_class), slot.value);
+	}
+
+	atomic_increment(&td->handoff_ready);
+
+	// Free what the previous thread left.
+	ThreadData *prev = &thread_data[(td->index + THREADS - 1) % THREADS];
+	while (static_cast<volatile uint32_t &>(prev->handoff_ready) == 0) {
+		OS::get_singleton()->delay_usec(100);
+	}
+
+	Slot *prev_slots = handoff[prev->index];
+	for (int i = 0; i < LIVE_BLOCKS; i++) {
+		if (!prev_slots[i].block)
+			continue;
+		if (!_check(prev_slots[i].block, SlabAllocator::get_block_size(prev_slots[i].size_class), prev_slots[i].value))
+			td->ok = false;
+		SlabAllocator::free(prev_slots[i].block, prev_slots[i].size_class);
+	}
+}
+
+static uint64_t _get_used_blocks() {
+
+	uint64_t used = 0;
+	for (int i = 0; i < SlabAllocator::SIZE_CLASS_COUNT; i++) {
+		SlabAllocator::Stats stats;
+		SlabAllocator::get_stats(i, &stats);
+		used += stats.block_count - stats.free_count;
+	}
+	return used;
+}
+
+bool test_size_classes() {
+
+	OS::get_singleton()->print("\n\nTest 1: Size classes\n");
+
+	bool ok = true;
+	uint32_t prev_size = 0;
+	for (int i = 0; i < SlabAllocator::SIZE_CLASS_COUNT; i++) {
+
+		uint32_t size = SlabAllocator::get_block_size(i);
+		ok = ok && size > prev_size && (size % 16) == 0;
+		ok = ok && SlabAllocator::get_size_class(size) == i && SlabAllocator::get_size_class(prev_size + 1) == i;
+		prev_size = size;
+	}
+
+	ok = ok && prev_size == SlabAllocator::MAX_BLOCK_SIZE;
+	ok = ok && SlabAllocator::get_size_class(SlabAllocator::MAX_BLOCK_SIZE + 1) == -1;
+
+	OS::get_singleton()->print("\tsizes map to their classes: %s\n", ok ? "yes" : "no");
+
+	return ok;
+}
+
+bool test_threads() {
+
+	OS::get_singleton()->print("\n\nTest 2: Allocate and free across threads\n");
+
+	SlabAllocator::release_thread_cache();
+	uint64_t used_before = _get_used_blocks();
+
+	Thread *threads[THREADS];
+	for (int i = 0; i < THREADS; i++) {
+		thread_data[i].index = i;
+		thread_data[i].seed = 1234 + i;
+		thread_data[i].handoff_ready = 0;
+		thread_data[i].ok = true;
+	}
+	for (int i = 0; i < THREADS; i++) {
+		threads[i] = Thread::create(_thread_func, &thread_data[i]);
+	}
+
+	bool ok = true;
+	for (int i = 0; i < THREADS; i++) {
+		Thread::wait_to_finish(threads[i]);
+		memdelete(threads[i]);
+		ok = ok && thread_data[i].ok;
+	}
+
+	OS::get_singleton()->print("\tblocks kept their contents: %s\n", ok ? "yes" : "no");
+
+	// Threads give their cached blocks back when they end, so all blocks must be free again.
+	SlabAllocator::release_thread_cache();
+	uint64_t used_after = _get_used_blocks();
+	OS::get_singleton()->print("\tused blocks before: %i, after: %i\n", int(used_before), int(used_after));
+	ok = ok && used_before == used_after;
+
+	uint64_t reserved = 0;
+	uint64_t free_memory = 0;
+	bool stats_ok = true;
+	for (int i = 0; i < SlabAllocator::SIZE_CLASS_COUNT; i++) {
+
+		SlabAllocator::Stats stats;
+		SlabAllocator::get_stats(i, &stats);
+		stats_ok = stats_ok && stats.block_count == uint64_t(stats.slab_count) * (SlabAllocator::SLAB_SIZE / stats.block_size);
+		stats_ok = stats_ok && stats.free_count <= stats.block_count;
+		reserved += uint64_t(stats.slab_count) * SlabAllocator::SLAB_SIZE;
+		free_memory += stats.free_count * stats.block_size;
+	}
+
+	stats_ok = stats_ok && reserved == SlabAllocator::get_reserved_memory() && free_memory == SlabAllocator::get_free_memory();
+	OS::get_singleton()->print("\treserved: %i KB, free: %i KB, stats consistent: %s\n", int(reserved / 1024), int(free_memory / 1024), stats_ok ? "yes" : "no");
+
+	return ok && stats_ok;
+}
+
+static uint32_t bench_done;
+static bool bench_use_slabs;
+
+static void _bench_func(void *p_userdata) {
+
+	uint32_t seed = 4321 + (int)(intptr_t)p_userdata;
+	void *blocks[LIVE_BLOCKS];
+	int classes[LIVE_BLOCKS];
+	for (int i = 0; i < LIVE_BLOCKS; i++) {
+		blocks[i] = NULL;
+	}
+
+	for (int i = 0; i < ROUNDS * 4; i++) {
+
+		int idx = _rand(&seed) % LIVE_BLOCKS;
+		int size = 16 + _rand(&seed) % 240; // most engine allocations are this small
+
+		if (bench_use_slabs) {
+			if (blocks[idx])
+				SlabAllocator::free(blocks[idx], classes[idx]);
+			classes[idx] = SlabAllocator::get_size_class(size);
+			blocks[idx] = SlabAllocator::alloc(classes[idx]);
+		} else {
+			if (blocks[idx])
+				::free(blocks[idx]);
+			blocks[idx] = malloc(size);
+		}
+	}
+
+	for (int i = 0; i < LIVE_BLOCKS; i++) {
+		if (!blocks[i])
+			continue;
+		if (bench_use_slabs)
+			SlabAllocator::free(blocks[i], classes[i]);
+		else
+			::free(blocks[i]);
+	}
+
+	atomic_increment(&bench_done);
+}
+
+static uint64_t _run_bench(bool p_use_slabs, int p_threads) {
+
+	bench_use_slabs = p_use_slabs;
+	bench_done = 0;
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+
+	Thread *threads[THREADS];
+	for (int i = 0; i < p_threads; i++) {
+		threads[i] = Thread::create(_bench_func, (void *)(intptr_t)i);
+	}
+	for (int i = 0; i < p_threads; i++) {
+		Thread::wait_to_finish(threads[i]);
+		memdelete(threads[i]);
+	}
+
+	return OS::get_singleton()->get_ticks_usec() - begin;
+}
+
+bool test_benchmark() {
+
+	OS::get_singleton()->print("\n\nTest 3: Benchmark against malloc\n");
+
+	for (int threads = 1; threads <= THREADS; threads *= 2) {
+
+		uint64_t malloc_usec = _run_bench(false, threads);
+		uint64_t slab_usec = _run_bench(true, threads);
+
+		OS::get_singleton()->print("\t%i threads, %i allocations each: malloc %i msec, slabs %i msec\n", threads, ROUNDS * 4, int(malloc_usec / 1000), int(slab_usec / 1000));
+	}
+
+	return bench_done == THREADS;
+}
+
+typedef bool (*TestFunc)(void);
+
+TestFunc test_funcs[] = {
+
+	test_size_classes,
+	test_threads,
+	test_benchmark,
+	0
+};
+
+MainLoop *test() {
+
+	int count = 0;
+	int passed = 0;
+
+	while (true) {
+		if (!test_funcs[count])
+			break;
+		bool pass = test_funcs[count]();
+		if (pass)
+			passed++;
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+
+		count++;
+	}
+
+	OS::get_singleton()->print("\n\n\n");
+	OS::get_singleton()->print("*************\n");
+	OS::get_singleton()->print("***TOTALS!***\n");
+	OS::get_singleton()->print("*************\n");
+
+	OS::get_singleton()->print("Passed %i of %i tests\n", passed, count);
+
+	return NULL;
+}
+} // namespace TestSlabAllocator
@@ -0,0 +1,188 @@
+/*************************************************************************/
+/*  test_string_name.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_string_name.h"
+
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/string_db.h"
+
+namespace TestStringName {
+
+enum {
+	THREADS = 4,
+	NAMES = 512,
+	ROUNDS = 200,
+};
+
+struct Context {
+
+	String names[NAMES];
+	uint32_t mismatches;
+};
+
+static void lookup_loop(void *p_context) {
+
+	Context *context = (Context *)p_context;
+
+	for (int r = 0; r < ROUNDS; r++) {
+		for (int i = 0; i < NAMES; i++) {
+
+			StringName a = context->names[i];
+			StringName b = context->names[i];
+			if (a != b || String(a) != context->names[i])
+				atomic_increment(&context->mismatches);
+		}
+	}
+}
+
+static bool test_threaded_lookup() {
+
+	OS::get_singleton()->print("\n\nTest 1: Look up %d names from %d threads\n", NAMES, THREADS);
+
+	Context context;
+	context.mismatches = 0;
+	for (int i = 0; i < NAMES; i++) {
+		context.names[i] = "name_" + itos(i);
+	}
+
+	// keep half of the names alive, the other half is inserted and removed over and over
+	StringName held[NAMES / 2];
+	for (int i = 0; i < NAMES / 2; i++) {
+		held[i] = context.names[i * 2];
+	}
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+
+	Thread *threads[THREADS];
+	for (int i = 0; i < THREADS; i++) {
+		threads[i] = Thread::create(lookup_loop, &context);
+	}
+	for (int i = 0; i < THREADS; i++) {
+		Thread::wait_to_finish(threads[i]);
+		memdelete(threads[i]);
+	}
+
+	uint64_t usec = OS::get_singleton()->get_ticks_usec() - t;
+	int lookups = THREADS * ROUNDS * NAMES * 2;
+	OS::get_singleton()->print("\t%f lookups/sec, %d mismatches\n", lookups * 1000000.0 / MAX(usec, 1), context.mismatches);
+
+	return context.mismatches == 0;
+}
+
+static bool test_static_names() {
+
+	OS::get_singleton()->print("\n\nTest 2: SNAME() against StringName from a literal\n");
+
+	StringName plain = "test_string_name_static";
+	const StringName &cached = SNAME("test_string_name_static");
+
+	bool ok = plain == cached && &cached == &SNAME("test_string_name_static") && SNAME("") == StringName();
+
+	int count = 1000000;
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < count; i++) {
+		StringName sn("test_string_name_static");
+		ok = ok && sn == plain;
+	}
+	uint64_t plain_usec = OS::get_singleton()->get_ticks_usec() - t;
+
+	t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < count; i++) {
+		ok = ok && SNAME("test_string_name_static") == plain;
+	}
+	uint64_t static_usec = OS::get_singleton()->get_ticks_usec() - t;
+
+	OS::get_singleton()->print("\tStringName(\"...\"): %f/sec, SNAME(\"...\"): %f/sec\n", count * 1000000.0 / MAX(plain_usec, 1), count * 1000000.0 / MAX(static_usec, 1));
+
+	return ok;
+}
+
+static bool test_table_stats() {
+
+	OS::get_singleton()->print("\n\nTest 3: Table statistics\n");
+
+	int before = StringName::get_name_count();
+
+	StringName names[100];
+	for (int i = 0; i < 100; i++) {
+		names[i] = "test_string_name_stats_" + itos(i);
+	}
+
+	StringName::TableStats stats;
+	StringName::get_table_stats(&stats);
+	OS::get_singleton()->print("\t%d names in %d of %d buckets, longest chain %d, %d static names\n", stats.name_count, stats.used_bucket_count, stats.bucket_count, stats.longest_chain, stats.static_name_count);
+
+	bool ok = StringName::get_name_count() == before + 100 && stats.name_count == StringName::get_name_count();
+	ok = ok && stats.used_bucket_count > 0 && stats.longest_chain > 0 && stats.static_name_count > 0;
+
+	for (int i = 0; i < 100; i++) {
+		names[i] = StringName();
+	}
+
+	return ok && StringName::get_name_count() == before;
+}
+
+typedef bool (*TestFunc)(void);
+
+TestFunc test_funcs[] = {
+
+	test_threaded_lookup,
+	test_static_names,
+	test_table_stats,
+	0
+};
+
+MainLoop *test() {
+
+	int count = 0;
+	int passed = 0;
+
+	while (true) {
+		if (!test_funcs[count])
+			break;
+		bool pass = test_funcs[count]();
+		if (pass)
+			passed++;
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+
+		count++;
+	}
+
+	OS::get_singleton()->print("\n\n\n");
+	OS::get_singleton()->print("*************\n");
+	OS::get_singleton()->print("***TOTALS!***\n");
+	OS::get_singleton()->print("*************\n");
+
+	OS::get_singleton()->print("Passed %i of %i tests\n", passed, count);
+
+	return NULL;
+}
+} // namespace TestStringName
@@ -0,0 +1,335 @@
+/*************************************************************************/
+/*  test_variant_parser.cpp                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_variant_parser.h"
+
+#include "core/os/file_access.h"
+#include "core/os/os.h"
+#include "core/variant_parser.h"
+
+namespace TestVariantParser {
+
+enum {
+	BENCH_VERTICES = 100000,
+	BENCH_TILES = 200000,
+	BENCH_NODES = 2000,
+};
+
+static String _get_path() {
+
+	return OS::get_singleton()->get_cache_path().plus_file("test_variant_parser.tres");
+}
+
+static bool _store(const String &p_text) {
+
+	FileAccess *f = FileAccess::open(_get_path(), FileAccess::WRITE);
+	ERR_FAIL_COND_V(!f, false);
+	f->store_string(p_text);
+	memdelete(f);
+	return true;
+}
+
+static Array _get_values() {
+
+	Array values;
+	values.push_back(Vector3(1.5, -2.25, 3e-5));
+	values.push_back(Transform(Basis(Vector3(0, 1, 0), 0.5), Vector3(10, -20, 30)));
+	values.push_back(Color(0.1, 0.2, 0.3, 0.4));
+	values.push_back(String::utf8("text with \"quotes\" and \xc3\xa1"));
+
+	PoolVector<Vector3> vertices;
+	PoolVector<int> ints;
+	PoolVector<uint8_t> bytes;
+	PoolVector<float> reals;
+	PoolVector<Color> colors;
+	for (int i = 0; i < 100; i++) {
+		vertices.push_back(Vector3(i * 0.5, -i, i * 1e-3));
+		ints.push_back(i * 1000 - 50000);
+		bytes.push_back(i * 2);
+		reals.push_back(i * -0.125);
+		colors.push_back(Color(i / 100.0, 0, 1, 0.5));
+	}
+	values.push_back(vertices);
+	values.push_back(ints);
+	values.push_back(bytes);
+	values.push_back(reals);
+	values.push_back(colors);
+	values.push_back(PoolVector<Vector2>());
+
+	Dictionary dict;
+	dict["array"] = ints;
+	dict["nested"] = values.duplicate();
+	values.push_back(dict);
+
+	return values;
+}
+
+static String _get_text(const Array &p_values) {
+
+	String text = "[gd_resource type=\"Resource\" format=2]\n\n[resource]\n\n";
+	for (int i = 0; i < p_values.size(); i++) {
+
+		String value;
+		VariantWriter::write_to_string(p_values[i], value);
+		text += "value" + itos(i) + " = " + value + "\n";
+	}
+
+	// comments and line breaks inside a constructor
+	text += "commented = PoolIntArray( 1, ; one\n2,\n 3 )\n";
+	return text;
+}
+
+// Floats are written with fewer digits than they have, so compare what they write.
+static bool _same_text(const Variant &p_a, const Variant &p_b) {
+
+	String a, b;
+	VariantWriter::write_to_string(p_a, a);
+	VariantWriter::write_to_string(p_b, b);
+	return a == b;
+}
+
+static bool _parse(VariantParser::Stream *p_stream, const Array &p_values) {
+
+	VariantParser::Tag tag;
+	String err_str;
+	int lines = 1;
+
+	Error err = VariantParser::parse_tag(p_stream, lines, err_str, tag);
+	if (err != OK || tag.name != "gd_resource")
+		return false;
+
+	Array parsed;
+	while (true) {
+
+		String assign;
+		Variant value;
+		err = VariantParser::parse_tag_assign_eof(p_stream, lines, err_str, tag, assign, value);
+		if (err == ERR_FILE_EOF)
+			break;
+		if (err != OK) {
+			OS::get_singleton()->print("\tline %i: %ls\n", lines, err_str.c_str());
+			return false;
+		}
+		if (assign != String())
+			parsed.push_back(value);
+	}
+
+	bool ok = parsed.size() == p_values.size() + 1;
+	for (int i = 0; ok && i < p_values.size(); i++) {
+		ok = _same_text(parsed[i], p_values[i]);
+	}
+
+	PoolVector<int> commented;
+	commented.push_back(1);
+	commented.push_back(2);
+	commented.push_back(3);
+
+	return ok && parsed.back() == Variant(commented);
+}
+
+bool test_values() {
+
+	OS::get_singleton()->print("\n\nTest 1: Values parse back from a file and a string\n");
+
+	Array values = _get_values();
+	String text = _get_text(values);
+	ERR_FAIL_COND_V(!_store(text), false);
+
+	FileAccess *f = FileAccess::open(_get_path(), FileAccess::READ);
+	ERR_FAIL_COND_V(!f, false);
+	VariantParser::StreamFile stream_file;
+	stream_file.f = f;
+	bool file_ok = _parse(&stream_file, values);
+	memdelete(f);
+
+	// string streams never report the end, so values go one by one
+	bool string_ok = true;
+	for (int i = 0; i < values.size(); i++) {
+
+		VariantParser::StreamString stream_string;
+		VariantWriter::write_to_string(values[i], stream_string.s);
+
+		Variant value;
+		String err_str;
+		int line;
+		Error err = VariantParser::parse(&stream_string, value, err_str, line);
+		string_ok = string_ok && err == OK && _same_text(value, values[i]);
+	}
+
+	OS::get_singleton()->print("\tfrom file: %s, from string: %s\n", file_ok ? "yes" : "no", string_ok ? "yes" : "no");
+
+	return file_ok && string_ok;
+}
+
+bool test_position() {
+
+	OS::get_singleton()->print("\n\nTest 2: File position after a tag\n");
+
+	String header = "[ext_resource path=\"res://a.png\" type=\"Texture\" id=1]";
+	ERR_FAIL_COND_V(!_store(header + "\n[node name=\"A\" type=\"Node\"]\n"), false);
+
+	FileAccess *f = FileAccess::open(_get_path(), FileAccess::READ);
+	ERR_FAIL_COND_V(!f, false);
+	VariantParser::StreamFile stream;
+	stream.f = f;
+
+	VariantParser::Tag tag;
+	String err_str;
+	int lines = 1;
+	Error err = VariantParser::parse_tag(&stream, lines, err_str, tag);
+	uint64_t pos = stream.get_position();
+	memdelete(f);
+
+	OS::get_singleton()->print("\tposition %i, expected %i\n", int(pos), header.utf8().length());
+
+	return err == OK && tag.name == "ext_resource" && pos == uint64_t(header.utf8().length());
+}
+
+bool test_benchmark() {
+
+	OS::get_singleton()->print("\n\nTest 3: Load a large generated scene\n");
+
+	// what big meshes and tile maps look like in a .tscn
+	FileAccess *f = FileAccess::open(_get_path(), FileAccess::WRITE);
+	ERR_FAIL_COND_V(!f, false);
+	f->store_string("[gd_scene load_steps=2 format=2]\n\n[sub_resource type=\"ArrayMesh\" id=1]\n\n");
+
+	PoolVector<Vector3> vertices;
+	vertices.resize(BENCH_VERTICES);
+	{
+		PoolVector<Vector3>::Write w = vertices.write();
+		for (int i = 0; i < BENCH_VERTICES; i++) {
+			w[i] = Vector3(Math::sin(i * 0.01) * 100, i * 0.125, Math::cos(i * 0.01) * -100);
+		}
+	}
+	String value;
+	VariantWriter::write_to_string(vertices, value);
+	f->store_string("vertices = " + value + "\n");
+
+	PoolVector<int> tiles;
+	tiles.resize(BENCH_TILES);
+	{
+		PoolVector<int>::Write w = tiles.write();
+		for (int i = 0; i < BENCH_TILES; i++) {
+			w[i] = (i % 3) ? i * 65536 + i % 1024 : 0;
+		}
+	}
+	VariantWriter::write_to_string(tiles, value);
+	f->store_string("tile_data = " + value + "\n\n");
+
+	for (int i = 0; i < BENCH_NODES; i++) {
+
+		VariantWriter::write_to_string(Transform(Basis(Vector3(0, 1, 0), i * 0.1), Vector3(i, 0, -i)), value);
+		f->store_string("[node name=\"Node" + itos(i) + "\" type=\"Spatial\" parent=\".\"]\n\ntransform = " + value + "\nvisible = false\n\n");
+	}
+	memdelete(f);
+
+	f = FileAccess::open(_get_path(), FileAccess::READ);
+	ERR_FAIL_COND_V(!f, false);
+	int size = f->get_len();
+	VariantParser::StreamFile stream;
+	stream.f = f;
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+
+	// same loop as the text scene loader
+	VariantParser::Tag tag;
+	String err_str;
+	int lines = 1;
+	int tags = 0;
+	int values = 0;
+	bool ok = true;
+	while (true) {
+
+		String assign;
+		Variant v;
+		Error err = VariantParser::parse_tag_assign_eof(&stream, lines, err_str, tag, assign, v);
+		if (err == ERR_FILE_EOF)
+			break;
+		if (err != OK) {
+			OS::get_singleton()->print("\tline %i: %ls\n", lines, err_str.c_str());
+			ok = false;
+			break;
+		}
+
+		if (assign == "vertices")
+			ok = ok && PoolVector<Vector3>(v).size() == BENCH_VERTICES;
+		else if (assign == "tile_data")
+			ok = ok && v == Variant(tiles);
+
+		if (assign != String())
+			values++;
+		else
+			tags++;
+	}
+
+	uint64_t usec = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+	memdelete(f);
+
+	OS::get_singleton()->print("\t%i KB, %i tags, %i values: %i msec, %i KB/s\n", size / 1024, tags, values, int(usec / 1000), int(uint64_t(size) * 1000000 / 1024 / usec));
+
+	return ok && tags == BENCH_NODES + 2 && values == BENCH_NODES * 2 + 2;
+}
+
+typedef bool (*TestFunc)(void);
+
+TestFunc test_funcs[] = {
+
+	test_values,
+	test_position,
+	test_benchmark,
+	0
+};
+
+MainLoop *test() {
+
+	int count = 0;
+	int passed = 0;
+
+	while (true) {
+		if (!test_funcs[count])
+			break;
+		bool pass = test_funcs[count]();
+		if (pass)
+			passed++;
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+
+		count++;
+	}
+
+	OS::get_singleton()->print("\n\n\n");
+	OS::get_singleton()->print("*************\n");
+	OS::get_singleton()->print("***TOTALS!***\n");
+	OS::get_singleton()->print("*************\n");
+
+	OS::get_singleton()->print("Passed %i of %i tests\n", passed, count);
+
+	return NULL;
+}
+} // namespace TestVariantParser
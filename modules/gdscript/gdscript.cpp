@@ -30,6 +30,7 @@
 #include "gdscript.h"
 
 #include "engine.h"
+#include "gdscript_compiled_buffer.h"
 #include "gdscript_compiler.h"
 #include "global_constants.h"
 #include "io/file_access_encrypted.h"
@@ -756,6 +757,24 @@ Error GDScript::load_byte_code(const String &p_path) {
 		basedir = basedir.get_base_dir();
 
 	valid = false;
+
+	if (GDScriptCompiledBuffer::is_compiled_buffer(bytecode)) {
+
+		if (GDScriptCompiledBuffer::load(this, bytecode) == OK) {
+
+			valid = true;
+			for (Map<StringName, Ref<GDScript> >::Element *E = subclasses.front(); E; E = E->next()) {
+
+				_set_subclass_path(E->get(), path);
+			}
+			return OK;
+		}
+
+		// compile the tokens it carries instead
+		bytecode = GDScriptCompiledBuffer::get_fallback(bytecode);
+		ERR_FAIL_COND_V(bytecode.size() == 0, ERR_PARSE_ERROR);
+	}
+
 	GDScriptParser parser;
 	Error err = parser.parse_bytecode(bytecode, basedir, get_path());
 	if (err) {
@@ -903,6 +922,8 @@ GDScript::GDScript() :
 }
 
 GDScript::~GDScript() {
+
+	GDScriptLanguage::get_singleton()->invalidate_inline_caches();
 	for (Map<StringName, GDScriptFunction *>::Element *E = member_functions.front(); E; E = E->next()) {
 		memdelete(E->get());
 	}
@@ -1796,6 +1817,7 @@ GDScriptLanguage::GDScriptLanguage() {
 #endif
 	profiling = false;
 	script_frame_time = 0;
+	inline_cache_epoch = 0;
 
 	_debug_call_stack_pos = 0;
 	int dmcs = GLOBAL_DEF("debug/settings/gdscript/max_call_stack", 1024);
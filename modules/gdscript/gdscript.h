@@ -70,6 +70,7 @@ class GDScript : public Script {
 	friend class GDScriptCompiler;
 	friend class GDScriptFunctions;
 	friend class GDScriptLanguage;
+	friend class GDScriptCompiledBuffer;
 
 	Variant _static_ref; //used for static call
 	Ref<GDScriptNativeClass> native;
@@ -293,6 +294,8 @@ class GDScriptLanguage : public ScriptLanguage {
 	bool profiling;
 	uint64_t script_frame_time;
 
+	uint32_t inline_cache_epoch;
+
 public:
 	int calls;
 
@@ -370,6 +373,10 @@ public:
 
 	_FORCE_INLINE_ static GDScriptLanguage *get_singleton() { return singleton; }
 
+	// Must be called before functions or members of a script go away or move.
+	_FORCE_INLINE_ void invalidate_inline_caches() { atomic_increment(&inline_cache_epoch); }
+	_FORCE_INLINE_ uint32_t get_inline_cache_epoch() const { return static_cast<const volatile uint32_t &>(inline_cache_epoch); }
+
 	virtual String get_name() const;
 
 	/* LANGUAGE FUNCTIONS */
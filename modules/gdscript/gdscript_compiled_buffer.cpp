@@ -0,0 +1,1147 @@
+/*************************************************************************/
+/*  gdscript_compiled_buffer.cpp                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "gdscript_compiled_buffer.h"
+
+#include "engine.h"
+#include "gdscript_function.h"
+#include "gdscript_functions.h"
+#include "io/marshalls.h"
+#include "io/resource_loader.h"
+#include "version.h"
+
+bool GDScriptCompiledBuffer::_decode_instruction(const int *p_code, int p_size, int p_ip, Instruction &r_instruction) {
+
+	r_instruction.size = 1;
+	r_instruction.address_count = 0;
+	r_instruction.range_from = 0;
+	r_instruction.range_to = 0;
+	r_instruction.jump = 0;
+
+#define ADDRESS(m_ofs) r_instruction.addresses[r_instruction.address_count++] = m_ofs
+#define ARGC(m_ofs)                           \
+	if (p_ip + m_ofs >= p_size)               \
+		return false;                         \
+	int argc = p_code[p_ip + m_ofs];          \
+	if (argc < 0 || argc > p_size - p_ip - 1) \
+		return false;
+
+	switch (p_code[p_ip]) {
+
+		case GDScriptFunction::OPCODE_OPERATOR: {
+
+			r_instruction.size = 5;
+			ADDRESS(2);
+			ADDRESS(3);
+			ADDRESS(4);
+		} break;
+		case GDScriptFunction::OPCODE_EXTENDS_TEST:
+		case GDScriptFunction::OPCODE_SET:
+		case GDScriptFunction::OPCODE_GET: {
+
+			r_instruction.size = 4;
+			ADDRESS(1);
+			ADDRESS(2);
+			ADDRESS(3);
+		} break;
+		case GDScriptFunction::OPCODE_SET_NAMED:
+		case GDScriptFunction::OPCODE_GET_NAMED: {
+
+			r_instruction.size = 5;
+			ADDRESS(1);
+			ADDRESS(4);
+		} break;
+		case GDScriptFunction::OPCODE_SET_MEMBER:
+		case GDScriptFunction::OPCODE_GET_MEMBER: {
+
+			r_instruction.size = 3;
+			ADDRESS(2);
+		} break;
+		case GDScriptFunction::OPCODE_ASSIGN: {
+
+			r_instruction.size = 3;
+			ADDRESS(1);
+			ADDRESS(2);
+		} break;
+		case GDScriptFunction::OPCODE_ASSIGN_TRUE:
+		case GDScriptFunction::OPCODE_ASSIGN_FALSE:
+		case GDScriptFunction::OPCODE_YIELD_RESUME:
+		case GDScriptFunction::OPCODE_RETURN:
+		case GDScriptFunction::OPCODE_ASSERT: {
+
+			r_instruction.size = 2;
+			ADDRESS(1);
+		} break;
+		case GDScriptFunction::OPCODE_CONSTRUCT: {
+
+			ARGC(2);
+			r_instruction.size = 4 + argc;
+			r_instruction.range_from = 3;
+			r_instruction.range_to = 4 + argc;
+		} break;
+		case GDScriptFunction::OPCODE_CONSTRUCT_ARRAY: {
+
+			ARGC(1);
+			r_instruction.size = 3 + argc;
+			r_instruction.range_from = 2;
+			r_instruction.range_to = 3 + argc;
+		} break;
+		case GDScriptFunction::OPCODE_CONSTRUCT_DICTIONARY: {
+
+			ARGC(1);
+			r_instruction.size = 3 + argc * 2;
+			r_instruction.range_from = 2;
+			r_instruction.range_to = 3 + argc * 2;
+		} break;
+		case GDScriptFunction::OPCODE_CALL:
+		case GDScriptFunction::OPCODE_CALL_RETURN:
+		case GDScriptFunction::OPCODE_CALL_BUILT_IN_METHOD: {
+
+			ARGC(1);
+			r_instruction.size = 6 + argc;
+			ADDRESS(2);
+			r_instruction.range_from = 5;
+			r_instruction.range_to = 6 + argc;
+		} break;
+		case GDScriptFunction::OPCODE_CALL_BUILT_IN:
+		case GDScriptFunction::OPCODE_CALL_SELF_BASE: {
+
+			ARGC(2);
+			r_instruction.size = 4 + argc;
+			r_instruction.range_from = 3;
+			r_instruction.range_to = 4 + argc;
+		} break;
+		case GDScriptFunction::OPCODE_YIELD_SIGNAL: {
+
+			r_instruction.size = 3;
+			ADDRESS(1);
+			ADDRESS(2);
+		} break;
+		case GDScriptFunction::OPCODE_JUMP: {
+
+			r_instruction.size = 2;
+			r_instruction.jump = 1;
+		} break;
+		case GDScriptFunction::OPCODE_JUMP_IF:
+		case GDScriptFunction::OPCODE_JUMP_IF_NOT: {
+
+			r_instruction.size = 3;
+			ADDRESS(1);
+			r_instruction.jump = 2;
+		} break;
+		case GDScriptFunction::OPCODE_ITERATE_BEGIN:
+		case GDScriptFunction::OPCODE_ITERATE: {
+
+			r_instruction.size = 5;
+			ADDRESS(1);
+			ADDRESS(2);
+			ADDRESS(4);
+			r_instruction.jump = 3;
+		} break;
+		case GDScriptFunction::OPCODE_LINE: {
+
+			r_instruction.size = 2;
+		} break;
+		case GDScriptFunction::OPCODE_YIELD:
+		case GDScriptFunction::OPCODE_JUMP_TO_DEF_ARGUMENT:
+		case GDScriptFunction::OPCODE_BREAKPOINT:
+		case GDScriptFunction::OPCODE_END: {
+
+			r_instruction.size = 1;
+		} break;
+		default: {
+
+			return false;
+		}
+	}
+
+#undef ADDRESS
+#undef ARGC
+
+	return p_ip + r_instruction.size <= p_size;
+}
+
+uint32_t GDScriptCompiledBuffer::get_format_hash() {
+
+	// anything the compiled code depends on that could change between builds
+	uint32_t hash = hash_djb2_one_32(FORMAT_VERSION);
+	hash = hash_djb2_one_32(VERSION_MAJOR, hash);
+	hash = hash_djb2_one_32(VERSION_MINOR, hash);
+	hash = hash_djb2_one_32(String(VERSION_STATUS).hash(), hash);
+	hash = hash_djb2_one_32(GDScriptFunction::OPCODE_END, hash);
+	hash = hash_djb2_one_32(GDScriptFunction::ADDR_BITS, hash);
+	hash = hash_djb2_one_32(GDScriptFunction::ADDR_TYPE_NIL, hash);
+	hash = hash_djb2_one_32(Variant::VARIANT_MAX, hash);
+	hash = hash_djb2_one_32(Variant::OP_MAX, hash);
+	for (int i = 0; i < GDScriptFunctions::FUNC_MAX; i++) {
+		hash = hash_djb2_one_32(String(GDScriptFunctions::get_func_name(GDScriptFunctions::Function(i))).hash(), hash);
+	}
+
+	return hash;
+}
+
+bool GDScriptCompiledBuffer::is_compiled_buffer(const Vector<uint8_t> &p_buffer) {
+
+	return p_buffer.size() >= HEADER_SIZE && p_buffer[0] == 'G' && p_buffer[1] == 'D' && p_buffer[2] == 'S' && p_buffer[3] == 'O';
+}
+
+Vector<uint8_t> GDScriptCompiledBuffer::get_fallback(const Vector<uint8_t> &p_buffer) {
+
+	ERR_FAIL_COND_V(!is_compiled_buffer(p_buffer), Vector<uint8_t>());
+
+	uint32_t compiled_size = decode_uint32(&p_buffer[12]);
+	ERR_FAIL_COND_V(compiled_size > uint32_t(p_buffer.size() - HEADER_SIZE), Vector<uint8_t>());
+
+	int from = HEADER_SIZE + compiled_size;
+	Vector<uint8_t> fallback;
+	fallback.resize(p_buffer.size() - from);
+	if (fallback.size()) {
+		copymem(fallback.ptrw(), &p_buffer[from], fallback.size());
+	}
+
+	return fallback;
+}
+
+/* SAVING */
+
+bool GDScriptCompiledBuffer::_is_local(const GDScript *p_script) const {
+
+	while (p_script->_owner) {
+		p_script = p_script->_owner;
+	}
+
+	return p_script == root;
+}
+
+int GDScriptCompiledBuffer::_get_string_index(const StringName &p_string) {
+
+	Map<StringName, int>::Element *E = string_map.find(p_string);
+	if (E)
+		return E->get();
+
+	int idx = strings.size();
+	strings.push_back(p_string);
+	string_map[p_string] = idx;
+	return idx;
+}
+
+void GDScriptCompiledBuffer::_put_u32(uint32_t p_value) {
+
+	int ofs = data.size();
+	data.resize(ofs + 4);
+	encode_uint32(p_value, &data[ofs]);
+}
+
+void GDScriptCompiledBuffer::_put_string(const StringName &p_string) {
+
+	_put_u32(_get_string_index(p_string));
+}
+
+bool GDScriptCompiledBuffer::_put_script_ref(const GDScript *p_script) {
+
+	// inner classes are found by name from the outermost one
+	Vector<StringName> names;
+	const GDScript *outer = p_script;
+	while (outer->_owner) {
+		names.push_back(outer->name);
+		outer = outer->_owner;
+	}
+
+	if (outer == root) {
+		_put_u32(SCRIPT_REF_LOCAL);
+	} else {
+		String path = outer->get_path();
+		if (path == "" || path.find("::") != -1)
+			return false; // built-in scripts can't be loaded by path
+		_put_u32(SCRIPT_REF_PATH);
+		_put_string(path);
+	}
+
+	_put_u32(names.size());
+	for (int i = names.size() - 1; i >= 0; i--) {
+		_put_string(names[i]);
+	}
+
+	return true;
+}
+
+bool GDScriptCompiledBuffer::_put_constant(const Variant &p_value) {
+
+	switch (p_value.get_type()) {
+
+		case Variant::OBJECT: {
+
+			Object *obj = p_value;
+			if (!obj)
+				break;
+
+			GDScriptNativeClass *native = Object::cast_to<GDScriptNativeClass>(obj);
+			if (native) {
+				_put_u32(CONSTANT_NATIVE_CLASS);
+				_put_string(native->get_name());
+				return true;
+			}
+
+			GDScript *script = Object::cast_to<GDScript>(obj);
+			if (script) {
+				_put_u32(CONSTANT_SCRIPT);
+				return _put_script_ref(script);
+			}
+
+			// preloaded resources are loaded again, anything else can't be saved
+			Resource *res = Object::cast_to<Resource>(obj);
+			if (!res || res->get_path() == "" || res->get_path().find("::") != -1)
+				return false;
+
+			_put_u32(CONSTANT_RESOURCE);
+			_put_string(res->get_path());
+			return true;
+		} break;
+		case Variant::ARRAY: {
+
+			// may hold objects too
+			Array array = p_value;
+			_put_u32(CONSTANT_ARRAY);
+			_put_u32(array.size());
+			for (int i = 0; i < array.size(); i++) {
+				if (!_put_constant(array[i]))
+					return false;
+			}
+			return true;
+		} break;
+		case Variant::DICTIONARY: {
+
+			Dictionary dict = p_value;
+			List<Variant> keys;
+			dict.get_key_list(&keys);
+
+			_put_u32(CONSTANT_DICTIONARY);
+			_put_u32(keys.size());
+			for (List<Variant>::Element *E = keys.front(); E; E = E->next()) {
+				if (!_put_constant(E->get()) || !_put_constant(dict[E->get()]))
+					return false;
+			}
+			return true;
+		} break;
+		default: {
+		}
+	}
+
+	int len;
+	Error err = encode_variant(p_value, NULL, len);
+	ERR_FAIL_COND_V(err != OK, false);
+
+	_put_u32(CONSTANT_VALUE);
+	_put_u32(len);
+	int ofs = data.size();
+	data.resize(ofs + len);
+	encode_variant(p_value, &data[ofs], len);
+	return true;
+}
+
+void GDScriptCompiledBuffer::_put_class_tree(GDScript *p_class) {
+
+	classes.push_back(p_class);
+	_put_string(p_class->name);
+	_put_u32(p_class->subclasses.size());
+	for (Map<StringName, Ref<GDScript> >::Element *E = p_class->subclasses.front(); E; E = E->next()) {
+		_put_class_tree(E->get().ptr());
+	}
+}
+
+bool GDScriptCompiledBuffer::_put_class(GDScript *p_class, Set<GDScript *> &r_saved) {
+
+	if (r_saved.has(p_class))
+		return true;
+
+	// member indices continue the ones of the base, so local bases go first
+	if (p_class->base.is_valid() && _is_local(p_class->base.ptr())) {
+		if (!_put_class(p_class->base.ptr(), r_saved))
+			return false;
+	}
+	r_saved.insert(p_class);
+
+	_put_u32(classes.find(p_class));
+	_put_u32(p_class->tool);
+
+	if (p_class->native.is_valid()) {
+		_put_u32(BASE_NATIVE);
+		_put_string(p_class->native->get_name());
+	} else if (p_class->base.is_valid()) {
+		_put_u32(BASE_SCRIPT);
+		if (!_put_script_ref(p_class->base.ptr()))
+			return false;
+	} else {
+		return false;
+	}
+
+	_put_u32(p_class->members.size());
+	for (Set<StringName>::Element *E = p_class->members.front(); E; E = E->next()) {
+
+		const GDScript::MemberInfo &minfo = p_class->member_indices[E->get()];
+		const PropertyInfo &pinfo = p_class->member_info[E->get()];
+
+		_put_string(E->get());
+		_put_u32(minfo.index);
+		_put_string(minfo.setter);
+		_put_string(minfo.getter);
+		_put_u32(minfo.rpc_mode);
+		_put_u32(pinfo.type);
+		_put_string(pinfo.name);
+		_put_string(pinfo.class_name);
+		_put_u32(pinfo.hint);
+		_put_string(pinfo.hint_string);
+		_put_u32(pinfo.usage);
+	}
+
+	// inner classes are constants too, they are already in the class tree
+	_put_u32(p_class->constants.size() - p_class->subclasses.size());
+	for (Map<StringName, Variant>::Element *E = p_class->constants.front(); E; E = E->next()) {
+
+		if (p_class->subclasses.has(E->key()))
+			continue;
+		_put_string(E->key());
+		if (!_put_constant(E->get()))
+			return false;
+	}
+
+	_put_u32(p_class->_signals.size());
+	for (Map<StringName, Vector<StringName> >::Element *E = p_class->_signals.front(); E; E = E->next()) {
+
+		_put_string(E->key());
+		_put_u32(E->get().size());
+		for (int i = 0; i < E->get().size(); i++) {
+			_put_string(E->get()[i]);
+		}
+	}
+
+	return true;
+}
+
+bool GDScriptCompiledBuffer::_put_function(const GDScriptFunction *p_function) {
+
+	_put_string(p_function->name);
+	_put_u32(p_function->_static);
+	_put_u32(p_function->rpc_mode);
+	_put_u32(p_function->_argument_count);
+	_put_u32(p_function->_stack_size);
+	_put_u32(p_function->_call_size);
+	_put_u32(p_function->_initial_line);
+
+	_put_u32(p_function->constants.size());
+	for (int i = 0; i < p_function->constants.size(); i++) {
+		if (!_put_constant(p_function->constants[i]))
+			return false;
+	}
+
+	_put_u32(p_function->global_names.size());
+	for (int i = 0; i < p_function->global_names.size(); i++) {
+		_put_string(p_function->global_names[i]);
+	}
+
+	// Copy the code with globals by index in the buffer, leaving out line
+	// and breakpoint opcodes for release exports. Jumps are moved to match.
+
+	const Vector<int> &code = p_function->code;
+	Vector<int> new_code;
+	Vector<int> new_ip;
+	Vector<int> jumps;
+	Vector<StringName> builtin_method_names;
+	new_ip.resize(code.size() + 1);
+	builtin_method_names.resize(p_function->builtin_methods.size());
+
+	int ip = 0;
+	while (ip < code.size()) {
+
+		Instruction ins;
+		if (!_decode_instruction(code.ptr(), code.size(), ip, ins))
+			return false;
+
+		new_ip[ip] = new_code.size();
+		int opcode = code[ip];
+
+		if (strip_debug && (opcode == GDScriptFunction::OPCODE_LINE || opcode == GDScriptFunction::OPCODE_BREAKPOINT)) {
+			ip += ins.size;
+			continue;
+		}
+
+		if (opcode == GDScriptFunction::OPCODE_CALL_BUILT_IN_METHOD) {
+			int name = code[ip + 3];
+			int method = code[ip + 4];
+			if (name < 0 || name >= p_function->global_names.size() || method < 0 || method >= builtin_method_names.size())
+				return false;
+			builtin_method_names[method] = p_function->global_names[name];
+		}
+
+		int from = new_code.size();
+		for (int i = 0; i < ins.size; i++) {
+			new_code.push_back(code[ip + i]);
+		}
+
+		for (int i = 0; i < ins.address_count + ins.range_to - ins.range_from; i++) {
+
+			int ofs = i < ins.address_count ? ins.addresses[i] : ins.range_from + i - ins.address_count;
+			int &address = new_code[from + ofs];
+			if (((address & GDScriptFunction::ADDR_TYPE_MASK) >> GDScriptFunction::ADDR_BITS) != GDScriptFunction::ADDR_TYPE_GLOBAL)
+				continue;
+
+			int idx = address & GDScriptFunction::ADDR_MASK;
+			if (idx >= language_globals.size())
+				return false;
+			if (!global_map.has(idx)) {
+				global_map[idx] = globals.size();
+				globals.push_back(idx);
+			}
+			address = global_map[idx] | (GDScriptFunction::ADDR_TYPE_GLOBAL << GDScriptFunction::ADDR_BITS);
+		}
+
+		if (ins.jump) {
+			jumps.push_back(from + ins.jump);
+		}
+
+		ip += ins.size;
+	}
+	new_ip[code.size()] = new_code.size();
+
+	for (int i = 0; i < jumps.size(); i++) {
+
+		int &to = new_code[jumps[i]];
+		if (to < 0 || to > code.size())
+			return false;
+		to = new_ip[to];
+	}
+
+	_put_u32(builtin_method_names.size());
+	for (int i = 0; i < builtin_method_names.size(); i++) {
+		if (builtin_method_names[i] == StringName())
+			return false;
+		_put_u32(p_function->builtin_methods[i]->type);
+		_put_string(builtin_method_names[i]);
+	}
+
+	_put_u32(p_function->inline_caches.size());
+
+	_put_u32(p_function->default_arguments.size());
+	for (int i = 0; i < p_function->default_arguments.size(); i++) {
+		int to = p_function->default_arguments[i];
+		if (to < 0 || to > code.size())
+			return false;
+		_put_u32(new_ip[to]);
+	}
+
+	_put_u32(new_code.size());
+	for (int i = 0; i < new_code.size(); i++) {
+		_put_u32(new_code[i]);
+	}
+
+	return true;
+}
+
+bool GDScriptCompiledBuffer::_save() {
+
+	_put_class_tree(root);
+
+	Set<GDScript *> saved;
+	_put_u32(classes.size());
+	for (int i = 0; i < classes.size(); i++) {
+		if (!_put_class(classes[i], saved))
+			return false;
+	}
+
+	for (int i = 0; i < classes.size(); i++) {
+
+		_put_u32(classes[i]->member_functions.size());
+		for (Map<StringName, GDScriptFunction *>::Element *E = classes[i]->member_functions.front(); E; E = E->next()) {
+			if (!_put_function(E->get()))
+				return false;
+		}
+	}
+
+	// strings and globals go before the classes, which refer to them by index
+
+	Vector<uint8_t> body = data;
+	data.clear();
+
+	Vector<int> global_names;
+	for (int i = 0; i < globals.size(); i++) {
+		global_names.push_back(_get_string_index(language_globals[globals[i]]));
+	}
+
+	_put_u32(strings.size());
+	for (int i = 0; i < strings.size(); i++) {
+
+		CharString cs = String(strings[i]).utf8();
+		_put_u32(cs.length());
+		int ofs = data.size();
+		data.resize(ofs + cs.length());
+		if (cs.length()) {
+			copymem(&data[ofs], cs.get_data(), cs.length());
+		}
+	}
+
+	_put_u32(global_names.size());
+	for (int i = 0; i < global_names.size(); i++) {
+		_put_u32(global_names[i]);
+	}
+
+	int ofs = data.size();
+	data.resize(ofs + body.size());
+	if (body.size()) {
+		copymem(&data[ofs], body.ptr(), body.size());
+	}
+
+	return true;
+}
+
+Vector<uint8_t> GDScriptCompiledBuffer::make_buffer(Ref<GDScript> p_script, const Vector<uint8_t> &p_fallback, bool p_debug) {
+
+	ERR_FAIL_COND_V(p_script.is_null(), Vector<uint8_t>());
+	if (!p_script->is_valid())
+		return Vector<uint8_t>();
+
+	GDScriptCompiledBuffer cb;
+	cb.root = p_script.ptr();
+	cb.strip_debug = !p_debug;
+
+	GDScriptLanguage *language = GDScriptLanguage::get_singleton();
+	cb.language_globals.resize(language->get_global_array_size());
+	for (const Map<StringName, int>::Element *E = language->get_global_map().front(); E; E = E->next()) {
+		cb.language_globals[E->get()] = E->key();
+	}
+
+	if (!cb._save())
+		return Vector<uint8_t>();
+
+	Vector<uint8_t> buf;
+	buf.resize(HEADER_SIZE + cb.data.size() + p_fallback.size());
+	buf[0] = 'G';
+	buf[1] = 'D';
+	buf[2] = 'S';
+	buf[3] = 'O';
+	encode_uint32(get_format_hash(), &buf[4]);
+	encode_uint32(p_debug ? FLAG_DEBUG : 0, &buf[8]);
+	encode_uint32(cb.data.size(), &buf[12]);
+	copymem(&buf[HEADER_SIZE], cb.data.ptr(), cb.data.size());
+	if (p_fallback.size()) {
+		copymem(&buf[HEADER_SIZE + cb.data.size()], p_fallback.ptr(), p_fallback.size());
+	}
+
+	return buf;
+}
+
+/* LOADING */
+
+void GDScriptCompiledBuffer::_fail(const String &p_error) {
+
+	if (!failed) {
+		failed = true;
+		error = p_error;
+	}
+}
+
+uint32_t GDScriptCompiledBuffer::_get_u32() {
+
+	if (offset + 4 > buffer_len) {
+		_fail("Unexpected end of buffer.");
+		return 0;
+	}
+
+	uint32_t value = decode_uint32(&buffer[offset]);
+	offset += 4;
+	return value;
+}
+
+StringName GDScriptCompiledBuffer::_get_string() {
+
+	uint32_t idx = _get_u32();
+	if (idx >= uint32_t(strings.size())) {
+		_fail("Invalid string index.");
+		return StringName();
+	}
+
+	return strings[idx];
+}
+
+Ref<GDScript> GDScriptCompiledBuffer::_get_script_ref() {
+
+	Ref<GDScript> script;
+
+	uint32_t type = _get_u32();
+	if (type == SCRIPT_REF_LOCAL) {
+
+		script = Ref<GDScript>(root);
+	} else if (type == SCRIPT_REF_PATH) {
+
+		String path = _get_string();
+		if (failed)
+			return Ref<GDScript>();
+		script = ResourceLoader::load(path);
+		if (script.is_null() || !script->is_valid()) {
+			_fail("Could not load script: " + path);
+			return Ref<GDScript>();
+		}
+	} else {
+
+		_fail("Invalid script reference.");
+		return Ref<GDScript>();
+	}
+
+	uint32_t count = _get_u32();
+	for (uint32_t i = 0; i < count && !failed; i++) {
+
+		StringName name = _get_string();
+		Map<StringName, Ref<GDScript> >::Element *E = script->subclasses.find(name);
+		if (!E) {
+			_fail("Could not find subclass: " + String(name));
+			return Ref<GDScript>();
+		}
+		script = E->get();
+	}
+
+	return failed ? Ref<GDScript>() : script;
+}
+
+Variant GDScriptCompiledBuffer::_get_constant() {
+
+	uint32_t type = _get_u32();
+
+	switch (type) {
+
+		case CONSTANT_VALUE: {
+
+			uint32_t len = _get_u32();
+			if (failed || len > uint32_t(buffer_len - offset)) {
+				_fail("Invalid constant.");
+				return Variant();
+			}
+
+			Variant value;
+			Error err = decode_variant(value, &buffer[offset], len, NULL, false);
+			if (err != OK) {
+				_fail("Invalid constant.");
+				return Variant();
+			}
+			offset += len;
+			return value;
+		} break;
+		case CONSTANT_ARRAY: {
+
+			uint32_t size = _get_u32();
+			Array array;
+			for (uint32_t i = 0; i < size && !failed; i++) {
+				array.push_back(_get_constant());
+			}
+			return array;
+		} break;
+		case CONSTANT_DICTIONARY: {
+
+			uint32_t size = _get_u32();
+			Dictionary dict;
+			for (uint32_t i = 0; i < size && !failed; i++) {
+				Variant key = _get_constant();
+				dict[key] = _get_constant();
+			}
+			return dict;
+		} break;
+		case CONSTANT_NATIVE_CLASS: {
+
+			StringName name = _get_string();
+			GDScriptLanguage *language = GDScriptLanguage::get_singleton();
+			const Map<StringName, int>::Element *E = language->get_global_map().find(name);
+			Variant native = E ? language->get_global_array()[E->get()] : Variant();
+			if (!Object::cast_to<GDScriptNativeClass>(native)) {
+				_fail("Unknown class: " + String(name));
+				return Variant();
+			}
+			return native;
+		} break;
+		case CONSTANT_SCRIPT: {
+
+			return _get_script_ref();
+		} break;
+		case CONSTANT_RESOURCE: {
+
+			String path = _get_string();
+			if (failed)
+				return Variant();
+			RES res = ResourceLoader::load(path);
+			if (res.is_null()) {
+				_fail("Could not load resource: " + path);
+				return Variant();
+			}
+			return res;
+		} break;
+	}
+
+	_fail("Invalid constant type.");
+	return Variant();
+}
+
+void GDScriptCompiledBuffer::_get_class_tree(GDScript *p_class) {
+
+	classes.push_back(p_class);
+	p_class->name = _get_string();
+
+	uint32_t count = _get_u32();
+	for (uint32_t i = 0; i < count && !failed; i++) {
+
+		Ref<GDScript> subclass;
+		subclass.instance();
+		subclass->_owner = p_class;
+		_get_class_tree(subclass.ptr());
+
+		p_class->subclasses.insert(subclass->name, subclass);
+		p_class->constants.insert(subclass->name, subclass);
+	}
+}
+
+void GDScriptCompiledBuffer::_get_class() {
+
+	uint32_t idx = _get_u32();
+	if (idx >= uint32_t(classes.size())) {
+		_fail("Invalid class index.");
+		return;
+	}
+
+	GDScript *c = classes[idx];
+	c->tool = _get_u32();
+
+	uint32_t base_type = _get_u32();
+	if (base_type == BASE_NATIVE) {
+
+		StringName name = _get_string();
+		GDScriptLanguage *language = GDScriptLanguage::get_singleton();
+		const Map<StringName, int>::Element *E = language->get_global_map().find(name);
+		Ref<GDScriptNativeClass> native = E ? language->get_global_array()[E->get()] : Variant();
+		if (native.is_null()) {
+			_fail("Unknown class: " + String(name));
+			return;
+		}
+		c->native = native;
+
+	} else if (base_type == BASE_SCRIPT) {
+
+		Ref<GDScript> base = _get_script_ref();
+		if (base.is_null()) {
+			_fail("Could not determine inheritance.");
+			return;
+		}
+		c->base = base;
+		c->_base = base.ptr();
+		c->member_indices = base->member_indices;
+
+	} else {
+
+		_fail("Invalid base type.");
+		return;
+	}
+
+	// the indices must still follow the base's ones
+	int first_index = c->member_indices.size();
+	uint32_t count = _get_u32();
+	for (uint32_t i = 0; i < count && !failed; i++) {
+
+		StringName name = _get_string();
+
+		GDScript::MemberInfo minfo;
+		minfo.index = _get_u32();
+		minfo.setter = _get_string();
+		minfo.getter = _get_string();
+		minfo.rpc_mode = ScriptInstance::RPCMode(_get_u32());
+
+		PropertyInfo pinfo;
+		pinfo.type = Variant::Type(_get_u32());
+		pinfo.name = _get_string();
+		pinfo.class_name = _get_string();
+		pinfo.hint = PropertyHint(_get_u32());
+		pinfo.hint_string = _get_string();
+		pinfo.usage = _get_u32();
+
+		if (minfo.index < first_index || minfo.index >= first_index + int(count)) {
+			_fail("Member indices don't match the base class.");
+			return;
+		}
+
+		c->member_indices[name] = minfo;
+		c->member_info[name] = pinfo;
+		c->members.insert(name);
+	}
+
+	if (c->member_indices.size() != first_index + int(count)) {
+		_fail("Member indices don't match the base class.");
+		return;
+	}
+
+	count = _get_u32();
+	for (uint32_t i = 0; i < count && !failed; i++) {
+
+		StringName name = _get_string();
+		c->constants[name] = _get_constant();
+	}
+
+	count = _get_u32();
+	for (uint32_t i = 0; i < count && !failed; i++) {
+
+		StringName name = _get_string();
+		uint32_t arg_count = _get_u32();
+		Vector<StringName> args;
+		for (uint32_t j = 0; j < arg_count && !failed; j++) {
+			args.push_back(_get_string());
+		}
+		c->_signals[name] = args;
+	}
+}
+
+void GDScriptCompiledBuffer::_get_function(GDScript *p_class) {
+
+	StringName name = _get_string();
+	if (failed || p_class->member_functions.has(name)) {
+		_fail("Invalid function.");
+		return;
+	}
+
+	GDScriptFunction *f = memnew(GDScriptFunction);
+	p_class->member_functions[name] = f;
+
+	f->name = name;
+	f->_static = _get_u32();
+	f->rpc_mode = ScriptInstance::RPCMode(_get_u32());
+	f->_argument_count = _get_u32();
+	f->_stack_size = _get_u32();
+	f->_call_size = _get_u32();
+	f->_initial_line = _get_u32();
+
+	uint32_t count = _get_u32();
+	for (uint32_t i = 0; i < count && !failed; i++) {
+		f->constants.push_back(_get_constant());
+	}
+
+	count = _get_u32();
+	for (uint32_t i = 0; i < count && !failed; i++) {
+		f->global_names.push_back(_get_string());
+	}
+
+	count = _get_u32();
+	for (uint32_t i = 0; i < count && !failed; i++) {
+
+		uint32_t type = _get_u32();
+		StringName method = _get_string();
+		const Variant::BuiltInMethod *builtin_method = type < Variant::VARIANT_MAX ? Variant::get_builtin_method(Variant::Type(type), method) : NULL;
+		if (!builtin_method) {
+			_fail("Unknown built-in method: " + String(method));
+			return;
+		}
+		f->builtin_methods.push_back(builtin_method);
+	}
+
+	count = _get_u32();
+	if (count > uint32_t(buffer_len)) {
+		_fail("Invalid inline cache count.");
+		return;
+	}
+	f->inline_caches.resize(count);
+
+	count = _get_u32();
+	for (uint32_t i = 0; i < count && !failed; i++) {
+		f->default_arguments.push_back(_get_u32());
+	}
+
+	count = _get_u32();
+	if (failed || count > uint32_t(buffer_len - offset) / 4) {
+		_fail("Invalid code size.");
+		return;
+	}
+	f->code.resize(count);
+	int *code = f->code.ptrw();
+	for (uint32_t i = 0; i < count; i++) {
+		code[i] = _get_u32();
+	}
+
+	// globals are saved by index in the buffer's table
+	int ip = 0;
+	while (ip < f->code.size()) {
+
+		Instruction ins;
+		if (!_decode_instruction(code, f->code.size(), ip, ins)) {
+			_fail("Invalid code.");
+			return;
+		}
+
+		for (int i = 0; i < ins.address_count + ins.range_to - ins.range_from; i++) {
+
+			int ofs = i < ins.address_count ? ins.addresses[i] : ins.range_from + i - ins.address_count;
+			int &address = code[ip + ofs];
+			if (((address & GDScriptFunction::ADDR_TYPE_MASK) >> GDScriptFunction::ADDR_BITS) != GDScriptFunction::ADDR_TYPE_GLOBAL)
+				continue;
+
+			int idx = address & GDScriptFunction::ADDR_MASK;
+			if (idx >= global_remap.size()) {
+				_fail("Invalid global index.");
+				return;
+			}
+			address = global_remap[idx] | (GDScriptFunction::ADDR_TYPE_GLOBAL << GDScriptFunction::ADDR_BITS);
+		}
+
+		ip += ins.size;
+	}
+
+	if (failed)
+		return;
+
+	f->_constant_count = f->constants.size();
+	f->_constants_ptr = f->constants.size() ? f->constants.ptrw() : NULL;
+	f->_global_names_count = f->global_names.size();
+	f->_global_names_ptr = f->global_names.size() ? f->global_names.ptr() : NULL;
+	f->_builtin_methods_count = f->builtin_methods.size();
+	f->_builtin_methods_ptr = f->builtin_methods.size() ? f->builtin_methods.ptr() : NULL;
+	f->_inline_cache_count = f->inline_caches.size();
+	f->_inline_caches_ptr = f->inline_caches.size() ? f->inline_caches.ptrw() : NULL;
+	f->_default_arg_count = f->default_arguments.size() ? f->default_arguments.size() - 1 : 0;
+	f->_default_arg_ptr = f->default_arguments.size() ? f->default_arguments.ptr() : NULL;
+	f->_code_size = f->code.size();
+	f->_code_ptr = f->code.size() ? f->code.ptr() : NULL;
+
+	f->_script = p_class;
+	f->source = root->get_path();
+#ifdef DEBUG_ENABLED
+	f->func_cname = (String(f->source) + " - " + String(f->name)).utf8();
+	f->_func_cname = f->func_cname.get_data();
+#endif
+}
+
+bool GDScriptCompiledBuffer::_load() {
+
+	uint32_t count = _get_u32();
+	if (count > uint32_t(buffer_len) / 4) {
+		_fail("Invalid string count.");
+		return false;
+	}
+	strings.resize(count);
+	for (uint32_t i = 0; i < count && !failed; i++) {
+
+		uint32_t len = _get_u32();
+		if (failed || len > uint32_t(buffer_len - offset)) {
+			_fail("Invalid string.");
+			break;
+		}
+		String s;
+		s.parse_utf8((const char *)&buffer[offset], len);
+		strings[i] = s;
+		offset += len;
+	}
+
+	GDScriptLanguage *language = GDScriptLanguage::get_singleton();
+	count = _get_u32();
+	for (uint32_t i = 0; i < count && !failed; i++) {
+
+		StringName name = _get_string();
+		const Map<StringName, int>::Element *E = language->get_global_map().find(name);
+		if (!E) {
+			_fail("Unknown identifier: " + String(name));
+			break;
+		}
+		global_remap.push_back(E->get());
+	}
+
+	if (failed)
+		return false;
+
+	_get_class_tree(root);
+
+	count = _get_u32();
+	if (count != uint32_t(classes.size())) {
+		_fail("Invalid class count.");
+		return false;
+	}
+	for (uint32_t i = 0; i < count && !failed; i++) {
+		_get_class();
+	}
+
+	for (int i = 0; i < classes.size() && !failed; i++) {
+
+		count = _get_u32();
+		for (uint32_t j = 0; j < count && !failed; j++) {
+			_get_function(classes[i]);
+		}
+	}
+
+	if (failed)
+		return false;
+
+	for (int i = 0; i < classes.size(); i++) {
+
+		Map<StringName, GDScriptFunction *>::Element *E = classes[i]->member_functions.find("_init");
+		classes[i]->initializer = E ? E->get() : NULL;
+		classes[i]->valid = true;
+	}
+
+	return true;
+}
+
+Error GDScriptCompiledBuffer::load(GDScript *p_script, const Vector<uint8_t> &p_buffer) {
+
+	ERR_FAIL_COND_V(!is_compiled_buffer(p_buffer), ERR_INVALID_DATA);
+	ERR_FAIL_COND_V(!p_script->member_functions.empty(), ERR_ALREADY_IN_USE);
+
+	if (decode_uint32(&p_buffer[4]) != get_format_hash())
+		return ERR_UNAVAILABLE; // made by another version
+
+	// the debugger needs what only the compiler knows (stack variables, profiling signatures)
+	if (ScriptDebugger::get_singleton())
+		return ERR_UNAVAILABLE;
+#ifdef TOOLS_ENABLED
+	if (Engine::get_singleton()->is_editor_hint())
+		return ERR_UNAVAILABLE;
+#endif
+
+	uint32_t compiled_size = decode_uint32(&p_buffer[12]);
+	ERR_FAIL_COND_V(compiled_size > uint32_t(p_buffer.size() - HEADER_SIZE), ERR_INVALID_DATA);
+
+	GDScriptCompiledBuffer cb;
+	cb.root = p_script;
+	cb.buffer = &p_buffer[HEADER_SIZE];
+	cb.buffer_len = compiled_size;
+
+	if (!cb._load()) {
+		ERR_PRINTS("Could not load compiled script '" + p_script->get_path() + "': " + cb.error);
+		return ERR_INVALID_DATA;
+	}
+
+	return OK;
+}
+
+GDScriptCompiledBuffer::GDScriptCompiledBuffer() {
+
+	root = NULL;
+	strip_debug = false;
+	buffer = NULL;
+	buffer_len = 0;
+	offset = 0;
+	failed = false;
+}
@@ -0,0 +1,140 @@
+/*************************************************************************/
+/*  gdscript_compiled_buffer.h                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef GDSCRIPT_COMPILED_BUFFER_H
+#define GDSCRIPT_COMPILED_BUFFER_H
+
+#include "gdscript.h"
+
+/*
+Compiled scripts in binary form, so exported games can skip the parser and
+compiler when loading them. The buffer also carries the tokenized code (see
+GDScriptTokenizerBuffer), which is compiled as usual whenever the compiled form
+can't be used: another engine version, a debugger attached, or something it
+refers to that isn't there anymore.
+
+Globals are stored by name and resolved when loading, as their indices depend
+on what is registered in the running engine.
+*/
+
+class GDScriptCompiledBuffer {
+
+	enum {
+		FORMAT_VERSION = 1,
+		HEADER_SIZE = 16,
+		FLAG_DEBUG = 1,
+	};
+
+	enum BaseType {
+		BASE_NATIVE,
+		BASE_SCRIPT,
+	};
+
+	enum ScriptRefType {
+		SCRIPT_REF_LOCAL, // the script being saved or one of its inner classes
+		SCRIPT_REF_PATH, // another script file or one of its inner classes
+	};
+
+	enum ConstantType {
+		CONSTANT_VALUE,
+		CONSTANT_ARRAY,
+		CONSTANT_DICTIONARY,
+		CONSTANT_NATIVE_CLASS,
+		CONSTANT_SCRIPT,
+		CONSTANT_RESOURCE,
+	};
+
+	struct Instruction {
+
+		int size;
+		int addresses[3]; // operands holding addresses
+		int address_count;
+		int range_from; // operands in [range_from, range_to) hold addresses too
+		int range_to;
+		int jump; // operand holding a jump target, 0 if none
+	};
+
+	static bool _decode_instruction(const int *p_code, int p_size, int p_ip, Instruction &r_instruction);
+
+	GDScript *root;
+	Vector<GDScript *> classes;
+	Vector<StringName> strings;
+
+	//saving
+	Vector<uint8_t> data;
+	Map<StringName, int> string_map;
+	Vector<StringName> language_globals;
+	Map<int, int> global_map;
+	Vector<int> globals;
+	bool strip_debug;
+
+	bool _is_local(const GDScript *p_script) const;
+	int _get_string_index(const StringName &p_string);
+	void _put_u32(uint32_t p_value);
+	void _put_string(const StringName &p_string);
+	bool _put_script_ref(const GDScript *p_script);
+	bool _put_constant(const Variant &p_value);
+	void _put_class_tree(GDScript *p_class);
+	bool _put_class(GDScript *p_class, Set<GDScript *> &r_saved);
+	bool _put_function(const GDScriptFunction *p_function);
+	bool _save();
+
+	//loading
+	const uint8_t *buffer;
+	int buffer_len;
+	int offset;
+	bool failed;
+	String error;
+	Vector<int> global_remap;
+
+	uint32_t _get_u32();
+	StringName _get_string();
+	Ref<GDScript> _get_script_ref();
+	Variant _get_constant();
+	void _get_class_tree(GDScript *p_class);
+	void _get_class();
+	void _get_function(GDScript *p_class);
+	void _fail(const String &p_error);
+	bool _load();
+
+	GDScriptCompiledBuffer();
+
+public:
+	static uint32_t get_format_hash();
+
+	static bool is_compiled_buffer(const Vector<uint8_t> &p_buffer);
+	static Vector<uint8_t> get_fallback(const Vector<uint8_t> &p_buffer);
+
+	// Empty if the script can't be saved this way, p_fallback should be used alone then.
+	static Vector<uint8_t> make_buffer(Ref<GDScript> p_script, const Vector<uint8_t> &p_fallback, bool p_debug);
+	// ERR_UNAVAILABLE if the buffer doesn't apply to this engine or session.
+	static Error load(GDScript *p_script, const Vector<uint8_t> &p_buffer);
+};
+
+#endif // GDSCRIPT_COMPILED_BUFFER_H
@@ -168,6 +168,38 @@ int GDScriptCompiler::_parse_assign_right_expression(CodeGen &codegen, const GDS
 	return dst_addr;
 }
 
+Variant::Type GDScriptCompiler::_get_known_builtin_type(const GDScriptParser::Node *p_expression) const {
+
+	switch (p_expression->type) {
+
+		case GDScriptParser::Node::TYPE_CONSTANT: {
+
+			const GDScriptParser::ConstantNode *cn = static_cast<const GDScriptParser::ConstantNode *>(p_expression);
+			return cn->value.get_type();
+		} break;
+		case GDScriptParser::Node::TYPE_ARRAY: {
+
+			return Variant::ARRAY;
+		} break;
+		case GDScriptParser::Node::TYPE_DICTIONARY: {
+
+			return Variant::DICTIONARY;
+		} break;
+		case GDScriptParser::Node::TYPE_OPERATOR: {
+
+			const GDScriptParser::OperatorNode *on = static_cast<const GDScriptParser::OperatorNode *>(p_expression);
+			if (on->op == GDScriptParser::OperatorNode::OP_CALL && on->arguments.size() && on->arguments[0]->type == GDScriptParser::Node::TYPE_TYPE) {
+				// constructor of a basic type
+				return static_cast<const GDScriptParser::TypeNode *>(on->arguments[0])->vtype;
+			}
+		} break;
+		default: {
+		}
+	}
+
+	return Variant::VARIANT_MAX;
+}
+
 int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::Node *p_expression, int p_stack_level, bool p_root, bool p_initializer) {
 
 	switch (p_expression->type) {
@@ -515,11 +547,34 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 							arguments.push_back(ret);
 						}
 
-						codegen.opcodes.push_back(p_root ? GDScriptFunction::OPCODE_CALL : GDScriptFunction::OPCODE_CALL_RETURN); // perform operator
-						codegen.opcodes.push_back(on->arguments.size() - 2);
-						codegen.alloc_call(on->arguments.size() - 2);
-						for (int i = 0; i < arguments.size(); i++)
-							codegen.opcodes.push_back(arguments[i]);
+						const Variant::BuiltInMethod *builtin_method = NULL;
+						Variant::Type base_type = _get_known_builtin_type(instance);
+						if (base_type != Variant::VARIANT_MAX && base_type != Variant::OBJECT && base_type != Variant::NIL) {
+							builtin_method = Variant::get_builtin_method(base_type, static_cast<const GDScriptParser::IdentifierNode *>(on->arguments[1])->name);
+						}
+
+						if (builtin_method) {
+
+							codegen.opcodes.push_back(GDScriptFunction::OPCODE_CALL_BUILT_IN_METHOD);
+							codegen.opcodes.push_back(on->arguments.size() - 2);
+							codegen.alloc_call(on->arguments.size() - 2);
+							codegen.opcodes.push_back(arguments[0]); //base
+							codegen.opcodes.push_back(arguments[1]); //name
+							codegen.opcodes.push_back(codegen.get_builtin_method_pos(builtin_method));
+							for (int i = 2; i < arguments.size(); i++)
+								codegen.opcodes.push_back(arguments[i]);
+
+						} else {
+
+							codegen.opcodes.push_back(p_root ? GDScriptFunction::OPCODE_CALL : GDScriptFunction::OPCODE_CALL_RETURN); // perform operator
+							codegen.opcodes.push_back(on->arguments.size() - 2);
+							codegen.alloc_call(on->arguments.size() - 2);
+							codegen.opcodes.push_back(arguments[0]); //base
+							codegen.opcodes.push_back(arguments[1]); //name
+							codegen.opcodes.push_back(codegen.alloc_inline_cache());
+							for (int i = 2; i < arguments.size(); i++)
+								codegen.opcodes.push_back(arguments[i]);
+						}
 					}
 				} break;
 				case GDScriptParser::OperatorNode::OP_YIELD: {
@@ -609,6 +664,8 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 					codegen.opcodes.push_back(named ? GDScriptFunction::OPCODE_GET_NAMED : GDScriptFunction::OPCODE_GET); // perform operator
 					codegen.opcodes.push_back(from); // argument 1
 					codegen.opcodes.push_back(index); // argument 2 (unary only takes one parameter)
+					if (named)
+						codegen.opcodes.push_back(codegen.alloc_inline_cache());
 
 				} break;
 				case GDScriptParser::OperatorNode::OP_AND: {
@@ -918,6 +975,8 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 							codegen.opcodes.push_back(named ? GDScriptFunction::OPCODE_GET_NAMED : GDScriptFunction::OPCODE_GET);
 							codegen.opcodes.push_back(prev_pos);
 							codegen.opcodes.push_back(key_idx);
+							if (named)
+								codegen.opcodes.push_back(codegen.alloc_inline_cache());
 							slevel++;
 							codegen.alloc_stack(slevel);
 							int dst_pos = (GDScriptFunction::ADDR_TYPE_STACK << GDScriptFunction::ADDR_BITS) | slevel;
@@ -927,6 +986,8 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 							//add in reverse order, since it will be reverted
 
 							setchain.push_back(dst_pos);
+							if (named)
+								setchain.push_back(codegen.alloc_inline_cache());
 							setchain.push_back(key_idx);
 							setchain.push_back(prev_pos);
 							setchain.push_back(named ? GDScriptFunction::OPCODE_SET_NAMED : GDScriptFunction::OPCODE_SET);
@@ -964,6 +1025,8 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 						codegen.opcodes.push_back(named ? GDScriptFunction::OPCODE_SET_NAMED : GDScriptFunction::OPCODE_SET);
 						codegen.opcodes.push_back(prev_pos);
 						codegen.opcodes.push_back(set_index);
+						if (named)
+							codegen.opcodes.push_back(codegen.alloc_inline_cache());
 						codegen.opcodes.push_back(set_value);
 
 						for (int i = 0; i < setchain.size(); i++) {
@@ -1368,6 +1431,7 @@ Error GDScriptCompiler::_parse_function(GDScript *p_script, const GDScriptParser
 	codegen.stack_max = 0;
 	codegen.current_line = 0;
 	codegen.call_max = 0;
+	codegen.inline_cache_count = 0;
 	codegen.debug_stack = ScriptDebugger::get_singleton() != NULL;
 	Vector<StringName> argnames;
 
@@ -1500,6 +1564,34 @@ Error GDScriptCompiler::_parse_function(GDScript *p_script, const GDScriptParser
 		gdfunc->_global_names_count = 0;
 	}
 
+	//inline caches
+	if (codegen.inline_cache_count) {
+
+		gdfunc->inline_caches.resize(codegen.inline_cache_count);
+		gdfunc->_inline_caches_ptr = gdfunc->inline_caches.ptrw();
+		gdfunc->_inline_cache_count = gdfunc->inline_caches.size();
+
+	} else {
+		gdfunc->_inline_caches_ptr = NULL;
+		gdfunc->_inline_cache_count = 0;
+	}
+
+	//built-in methods
+	if (codegen.builtin_method_map.size()) {
+
+		gdfunc->builtin_methods.resize(codegen.builtin_method_map.size());
+		for (Map<const Variant::BuiltInMethod *, int>::Element *E = codegen.builtin_method_map.front(); E; E = E->next()) {
+
+			gdfunc->builtin_methods[E->get()] = E->key();
+		}
+		gdfunc->_builtin_methods_ptr = &gdfunc->builtin_methods[0];
+		gdfunc->_builtin_methods_count = gdfunc->builtin_methods.size();
+
+	} else {
+		gdfunc->_builtin_methods_ptr = NULL;
+		gdfunc->_builtin_methods_count = 0;
+	}
+
 	if (codegen.opcodes.size()) {
 
 		gdfunc->code = codegen.opcodes;
@@ -1591,6 +1683,7 @@ Error GDScriptCompiler::_parse_class(GDScript *p_script, GDScript *p_owner, cons
 	p_script->native = Ref<GDScriptNativeClass>();
 	p_script->base = Ref<GDScript>();
 	p_script->_base = NULL;
+	GDScriptLanguage::get_singleton()->invalidate_inline_caches();
 	p_script->members.clear();
 	p_script->constants.clear();
 	for (Map<StringName, GDScriptFunction *>::Element *E = p_script->member_functions.front(); E; E = E->next()) {
@@ -105,6 +105,17 @@ class GDScriptCompiler {
 			return ret;
 		}
 
+		Map<const Variant::BuiltInMethod *, int> builtin_method_map;
+
+		int get_builtin_method_pos(const Variant::BuiltInMethod *p_method) {
+			const Map<const Variant::BuiltInMethod *, int>::Element *E = builtin_method_map.find(p_method);
+			if (E)
+				return E->get();
+			int pos = builtin_method_map.size();
+			builtin_method_map[p_method] = pos;
+			return pos;
+		}
+
 		int get_constant_pos(const Variant &p_constant) {
 			if (constant_map.has(p_constant))
 				return constant_map[p_constant];
@@ -124,6 +135,9 @@ class GDScriptCompiler {
 		int current_line;
 		int stack_max;
 		int call_max;
+		int inline_cache_count;
+
+		int alloc_inline_cache() { return inline_cache_count++; }
 	};
 
 	bool _is_class_member_property(CodeGen &codegen, const StringName &p_name);
@@ -134,6 +148,9 @@ class GDScriptCompiler {
 	bool _create_unary_operator(CodeGen &codegen, const GDScriptParser::OperatorNode *on, Variant::Operator op, int p_stack_level);
 	bool _create_binary_operator(CodeGen &codegen, const GDScriptParser::OperatorNode *on, Variant::Operator op, int p_stack_level, bool p_initializer = false);
 
+	// Type of the expression if it can be told without running it, Variant::VARIANT_MAX otherwise.
+	Variant::Type _get_known_builtin_type(const GDScriptParser::Node *p_expression) const;
+
 	int _parse_assign_right_expression(CodeGen &codegen, const GDScriptParser::OperatorNode *p_expression, int p_stack_level);
 	int _parse_expression(CodeGen &codegen, const GDScriptParser::Node *p_expression, int p_stack_level, bool p_root = false, bool p_initializer = false);
 	Error _parse_block(CodeGen &codegen, const GDScriptParser::BlockNode *p_block, int p_stack_level = 0, int p_break_addr = -1, int p_continue_addr = -1);
@@ -29,6 +29,7 @@
 /*************************************************************************/
 #include "gdscript_function.h"
 
+#include "core_string_names.h"
 #include "gdscript.h"
 #include "gdscript_functions.h"
 #include "os/os.h"
@@ -170,6 +171,348 @@ static String _get_var_type(const Variant *p_type) {
 	return basestr;
 }
 
+bool GDScriptFunction::_read_inline_cache(InlineCache *p_cache, InlineCacheData *r_data) {
+
+	// Caches are shared by all threads running the function. The atomic adds are full barriers,
+	// the data can't be read before the first one or after the second one.
+	uint32_t version = atomic_add(&p_cache->version, 0);
+	if (version & 1)
+		return false;
+	*r_data = p_cache->data;
+	return atomic_add(&p_cache->version, 0) == version;
+}
+
+void GDScriptFunction::_write_inline_cache(InlineCache *p_cache, const InlineCacheData &p_data) {
+
+	if (atomic_increment(&p_cache->writing) != 1) {
+		// another thread is writing it, the next run will try again
+		atomic_decrement(&p_cache->writing);
+		return;
+	}
+
+	atomic_increment(&p_cache->version);
+	p_cache->data = p_data;
+	atomic_increment(&p_cache->version);
+
+	atomic_decrement(&p_cache->writing);
+}
+
+bool GDScriptFunction::_get_inline_cache_key(const Variant *p_base, InlineCacheData *r_key, Object **r_object, GDScriptInstance **r_instance) {
+
+	r_key->kind = InlineCacheData::KIND_EMPTY;
+	r_key->epoch = GDScriptLanguage::get_singleton()->get_inline_cache_epoch();
+	r_key->type = p_base->get_type();
+	r_key->script = NULL;
+	r_key->class_name = NULL;
+	r_key->function = NULL;
+	r_key->method = NULL;
+	r_key->builtin_method = NULL;
+	r_key->index = -1;
+	*r_object = NULL;
+	*r_instance = NULL;
+
+	if (r_key->type != Variant::OBJECT)
+		return true;
+
+	// Null and freed instances are left to the lookup by name, which reports them.
+	Object *obj = *p_base;
+	if (!obj)
+		return false;
+#ifdef DEBUG_ENABLED
+	if (ScriptDebugger::get_singleton() && !p_base->is_ref() && !ObjectDB::instance_validate(obj))
+		return false;
+#endif
+
+	ScriptInstance *si = obj->get_script_instance();
+	if (si) {
+		if (si->get_language() != GDScriptLanguage::get_singleton() || si->is_placeholder())
+			return false;
+
+		GDScriptInstance *instance = static_cast<GDScriptInstance *>(si);
+		r_key->script = instance->script.ptr();
+		*r_instance = instance;
+	}
+
+	r_key->class_name = obj->get_class_name().data_unique_pointer();
+	*r_object = obj;
+	return true;
+}
+
+bool GDScriptFunction::_inline_cache_matches(const InlineCacheData &p_data, const InlineCacheData &p_key) {
+
+	return p_data.kind != InlineCacheData::KIND_EMPTY && p_data.epoch == p_key.epoch && p_data.type == p_key.type && p_data.script == p_key.script && p_data.class_name == p_key.class_name;
+}
+
+GDScriptFunction *GDScriptFunction::_find_script_function(GDScript *p_script, const StringName &p_name) {
+
+	for (GDScript *sptr = p_script; sptr; sptr = sptr->_base) {
+
+		Map<StringName, GDScriptFunction *>::Element *E = sptr->member_functions.find(p_name);
+		if (E)
+			return E->get();
+	}
+
+	return NULL;
+}
+
+bool GDScriptFunction::_call_cached(InlineCache *p_cache, Variant *p_base, const StringName &p_method, const Variant **p_args, int p_argcount, Variant *r_ret, Variant::CallError &r_err) {
+
+	InlineCacheData key;
+	Object *obj;
+	GDScriptInstance *instance;
+	if (!_get_inline_cache_key(p_base, &key, &obj, &instance))
+		return false;
+
+	InlineCacheData data;
+	if (!_read_inline_cache(p_cache, &data) || !_inline_cache_matches(data, key)) {
+
+		// resolve it the way Variant::call() and Object::call() do
+		data = key;
+
+		if (!obj) {
+
+			data.builtin_method = Variant::get_builtin_method(key.type, p_method);
+			if (!data.builtin_method)
+				return false;
+			data.kind = InlineCacheData::KIND_BUILT_IN_METHOD;
+
+		} else {
+
+			if (p_method == CoreStringNames::get_singleton()->_free)
+				return false;
+
+			if (instance) {
+				data.function = _find_script_function(instance->script.ptr(), p_method);
+			}
+
+			if (data.function) {
+				data.kind = InlineCacheData::KIND_SCRIPT_FUNCTION;
+			} else {
+				data.method = ClassDB::get_method(obj->get_class_name(), p_method);
+				if (!data.method)
+					return false;
+				data.kind = InlineCacheData::KIND_METHOD_BIND;
+			}
+		}
+
+		_write_inline_cache(p_cache, data);
+	}
+
+	r_err.error = Variant::CallError::CALL_OK;
+	Variant ret;
+
+	switch (data.kind) {
+
+		case InlineCacheData::KIND_SCRIPT_FUNCTION: {
+
+			ret = data.function->call(instance, p_args, p_argcount, r_err);
+		} break;
+		case InlineCacheData::KIND_METHOD_BIND: {
+
+			ret = data.method->call(obj, p_args, p_argcount, r_err);
+		} break;
+		case InlineCacheData::KIND_BUILT_IN_METHOD: {
+
+			data.builtin_method->call(*p_base, p_args, p_argcount, r_ret, r_err);
+			return true;
+		} break;
+		default: {
+
+			return false;
+		}
+	}
+
+	if (r_err.error == Variant::CallError::CALL_OK && r_ret)
+		*r_ret = ret;
+
+	return true;
+}
+
+bool GDScriptFunction::_get_cached(InlineCache *p_cache, const Variant *p_base, const StringName &p_name, Variant *r_ret) {
+
+	if (p_base->get_type() != Variant::OBJECT)
+		return false;
+
+	InlineCacheData key;
+	Object *obj;
+	GDScriptInstance *instance;
+	if (!_get_inline_cache_key(p_base, &key, &obj, &instance))
+		return false;
+
+	InlineCacheData data;
+	if (!_read_inline_cache(p_cache, &data) || !_inline_cache_matches(data, key)) {
+
+		// resolve it the way Object::get() does
+		data = key;
+
+		if (instance) {
+
+			GDScript *script = instance->script.ptr();
+			const Map<StringName, GDScript::MemberInfo>::Element *E = script->member_indices.find(p_name);
+			if (E) {
+				data.kind = InlineCacheData::KIND_MEMBER;
+				data.index = E->get().index;
+				if (E->get().getter) {
+					// a getter that can't be called falls back to the member, as in GDScriptInstance::get()
+					data.function = _find_script_function(script, E->get().getter);
+				}
+			} else {
+				// constants and _get() of the script come before native properties
+				for (GDScript *sptr = script; sptr; sptr = sptr->_base) {
+					if (sptr->constants.has(p_name) || sptr->member_functions.has(GDScriptLanguage::get_singleton()->strings._get))
+						return false;
+				}
+			}
+		}
+
+		if (data.kind == InlineCacheData::KIND_EMPTY) {
+
+			const ClassDB::PropertySetGet *psg = ClassDB::get_property_setget(obj->get_class_name(), p_name);
+			if (!psg || !psg->_getptr)
+				return false;
+			if (psg->index >= 0 && instance)
+				return false; // indexed getters are called by name, so scripts can override them
+
+			data.kind = InlineCacheData::KIND_PROPERTY;
+			data.method = psg->_getptr;
+			data.index = psg->index;
+		}
+
+		_write_inline_cache(p_cache, data);
+	}
+
+	Variant ret;
+
+	switch (data.kind) {
+
+		case InlineCacheData::KIND_MEMBER: {
+
+			Variant::CallError ce;
+			if (data.function) {
+				ret = data.function->call(instance, NULL, 0, ce);
+			}
+			if (!data.function || ce.error != Variant::CallError::CALL_OK) {
+				if (data.index >= instance->members.size())
+					return false; // instance not reloaded yet
+				ret = instance->members[data.index];
+			}
+		} break;
+		case InlineCacheData::KIND_PROPERTY: {
+
+			Variant::CallError ce;
+			if (data.index >= 0) {
+				Variant index = data.index;
+				const Variant *arg[1] = { &index };
+				ret = data.method->call(obj, arg, 1, ce);
+			} else {
+				ret = data.method->call(obj, NULL, 0, ce);
+			}
+		} break;
+		default: {
+
+			return false;
+		}
+	}
+
+	// assigned last, r_ret may be the base itself
+	*r_ret = ret;
+	return true;
+}
+
+bool GDScriptFunction::_set_cached(InlineCache *p_cache, Variant *p_base, const StringName &p_name, const Variant &p_value, bool *r_valid) {
+
+	if (p_base->get_type() != Variant::OBJECT)
+		return false;
+
+	InlineCacheData key;
+	Object *obj;
+	GDScriptInstance *instance;
+	if (!_get_inline_cache_key(p_base, &key, &obj, &instance))
+		return false;
+
+	InlineCacheData data;
+	if (!_read_inline_cache(p_cache, &data) || !_inline_cache_matches(data, key)) {
+
+		// resolve it the way Object::set() does
+		data = key;
+
+		if (instance) {
+
+			GDScript *script = instance->script.ptr();
+			const Map<StringName, GDScript::MemberInfo>::Element *E = script->member_indices.find(p_name);
+			if (E) {
+				data.kind = InlineCacheData::KIND_MEMBER;
+				data.index = E->get().index;
+				if (E->get().setter) {
+					data.function = _find_script_function(script, E->get().setter);
+					if (!data.function)
+						return false;
+				}
+			} else {
+				// _set() of the script comes before native properties
+				for (GDScript *sptr = script; sptr; sptr = sptr->_base) {
+					if (sptr->member_functions.has(GDScriptLanguage::get_singleton()->strings._set))
+						return false;
+				}
+			}
+		}
+
+		if (data.kind == InlineCacheData::KIND_EMPTY) {
+
+			const ClassDB::PropertySetGet *psg = ClassDB::get_property_setget(obj->get_class_name(), p_name);
+			if (!psg || !psg->_setptr)
+				return false;
+
+			data.kind = InlineCacheData::KIND_PROPERTY;
+			data.method = psg->_setptr;
+			data.index = psg->index;
+		}
+
+		_write_inline_cache(p_cache, data);
+	}
+
+#ifdef TOOLS_ENABLED
+	// Object::set() marks the object as edited
+	obj->set_edited(true);
+#endif
+
+	switch (data.kind) {
+
+		case InlineCacheData::KIND_MEMBER: {
+
+			if (data.function) {
+				const Variant *arg[1] = { &p_value };
+				Variant::CallError ce;
+				data.function->call(instance, arg, 1, ce);
+			} else {
+				if (data.index >= instance->members.size())
+					return false; // instance not reloaded yet
+				instance->members[data.index] = p_value;
+			}
+			*r_valid = true;
+		} break;
+		case InlineCacheData::KIND_PROPERTY: {
+
+			Variant::CallError ce;
+			if (data.index >= 0) {
+				Variant index = data.index;
+				const Variant *arg[2] = { &index, &p_value };
+				data.method->call(obj, arg, 2, ce);
+			} else {
+				const Variant *arg[1] = { &p_value };
+				data.method->call(obj, arg, 1, ce);
+			}
+			*r_valid = ce.error == Variant::CallError::CALL_OK;
+		} break;
+		default: {
+
+			return false;
+		}
+	}
+
+	return true;
+}
+
 #if defined(__GNUC__)
 #define OPCODES_TABLE                         \
 	static const void *switch_table_ops[] = { \
@@ -190,6 +533,7 @@ static String _get_var_type(const Variant *p_type) {
 		&&OPCODE_CALL,                        \
 		&&OPCODE_CALL_RETURN,                 \
 		&&OPCODE_CALL_BUILT_IN,               \
+		&&OPCODE_CALL_BUILT_IN_METHOD,        \
 		&&OPCODE_CALL_SELF,                   \
 		&&OPCODE_CALL_SELF_BASE,              \
 		&&OPCODE_YIELD,                       \
@@ -558,18 +902,23 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 			OPCODE(OPCODE_SET_NAMED) {
 
-				CHECK_SPACE(3);
+				CHECK_SPACE(4);
 
 				GET_VARIANT_PTR(dst, 1);
-				GET_VARIANT_PTR(value, 3);
+				GET_VARIANT_PTR(value, 4);
 
 				int indexname = _code_ptr[ip + 2];
 
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
+				int cacheidx = _code_ptr[ip + 3];
+				GD_ERR_BREAK(cacheidx < 0 || cacheidx >= _inline_cache_count);
+
 				bool valid;
-				dst->set_named(*index, *value, &valid);
+				if (!_set_cached(&_inline_caches_ptr[cacheidx], dst, *index, *value, &valid)) {
+					dst->set_named(*index, *value, &valid);
+				}
 
 #ifdef DEBUG_ENABLED
 				if (!valid) {
@@ -578,29 +927,37 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					OPCODE_BREAK;
 				}
 #endif
-				ip += 4;
+				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_GET_NAMED) {
 
-				CHECK_SPACE(4);
+				CHECK_SPACE(5);
 
 				GET_VARIANT_PTR(src, 1);
-				GET_VARIANT_PTR(dst, 3);
+				GET_VARIANT_PTR(dst, 4);
 
 				int indexname = _code_ptr[ip + 2];
 
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
-				bool valid;
+				int cacheidx = _code_ptr[ip + 3];
+				GD_ERR_BREAK(cacheidx < 0 || cacheidx >= _inline_cache_count);
+
+				bool valid = true;
 #ifdef DEBUG_ENABLED
 				//allow better error message in cases where src and dst are the same stack position
-				Variant ret = src->get_named(*index, &valid);
+				Variant ret;
+				if (!_get_cached(&_inline_caches_ptr[cacheidx], src, *index, &ret)) {
+					ret = src->get_named(*index, &valid);
+				}
 
 #else
-				*dst = src->get_named(*index, &valid);
+				if (!_get_cached(&_inline_caches_ptr[cacheidx], src, *index, dst)) {
+					*dst = src->get_named(*index, &valid);
+				}
 #endif
 #ifdef DEBUG_ENABLED
 				if (!valid) {
@@ -613,7 +970,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				}
 				*dst = ret;
 #endif
-				ip += 4;
+				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
@@ -769,7 +1126,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			OPCODE(OPCODE_CALL_RETURN)
 			OPCODE(OPCODE_CALL) {
 
-				CHECK_SPACE(4);
+				CHECK_SPACE(5);
 				bool call_ret = _code_ptr[ip] == OPCODE_CALL_RETURN;
 
 				int argc = _code_ptr[ip + 1];
@@ -779,8 +1136,12 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(nameg < 0 || nameg >= _global_names_count);
 				const StringName *methodname = &_global_names_ptr[nameg];
 
+				int cacheidx = _code_ptr[ip + 4];
+				GD_ERR_BREAK(cacheidx < 0 || cacheidx >= _inline_cache_count);
+				InlineCache *cache = &_inline_caches_ptr[cacheidx];
+
 				GD_ERR_BREAK(argc < 0);
-				ip += 4;
+				ip += 5;
 				CHECK_SPACE(argc + 1);
 				Variant **argptrs = call_args;
 
@@ -801,10 +1162,14 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				if (call_ret) {
 
 					GET_VARIANT_PTR(ret, argc);
-					base->call_ptr(*methodname, (const Variant **)argptrs, argc, ret, err);
+					if (!_call_cached(cache, base, *methodname, (const Variant **)argptrs, argc, ret, err)) {
+						base->call_ptr(*methodname, (const Variant **)argptrs, argc, ret, err);
+					}
 				} else {
 
-					base->call_ptr(*methodname, (const Variant **)argptrs, argc, NULL, err);
+					if (!_call_cached(cache, base, *methodname, (const Variant **)argptrs, argc, NULL, err)) {
+						base->call_ptr(*methodname, (const Variant **)argptrs, argc, NULL, err);
+					}
 				}
 #ifdef DEBUG_ENABLED
 				if (GDScriptLanguage::get_singleton()->profiling) {
@@ -887,6 +1252,64 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_CALL_BUILT_IN_METHOD) {
+
+				CHECK_SPACE(5);
+
+				int argc = _code_ptr[ip + 1];
+				GET_VARIANT_PTR(base, 2);
+				int nameg = _code_ptr[ip + 3];
+				int methodg = _code_ptr[ip + 4];
+
+				GD_ERR_BREAK(nameg < 0 || nameg >= _global_names_count);
+				GD_ERR_BREAK(methodg < 0 || methodg >= _builtin_methods_count);
+				const StringName *methodname = &_global_names_ptr[nameg];
+				const Variant::BuiltInMethod *method = _builtin_methods_ptr[methodg];
+
+				GD_ERR_BREAK(argc < 0);
+				ip += 5;
+				CHECK_SPACE(argc + 1);
+				Variant **argptrs = call_args;
+
+				for (int i = 0; i < argc; i++) {
+					GET_VARIANT_PTR(v, i);
+					argptrs[i] = v;
+				}
+
+				GET_VARIANT_PTR(ret, argc);
+
+#ifdef DEBUG_ENABLED
+				uint64_t call_time = 0;
+
+				if (GDScriptLanguage::get_singleton()->profiling) {
+					call_time = OS::get_singleton()->get_ticks_usec();
+				}
+
+#endif
+				Variant::CallError err;
+				if (base->get_type() == method->type) {
+					method->call(*base, (const Variant **)argptrs, argc, ret, err);
+				} else {
+					base->call_ptr(*methodname, (const Variant **)argptrs, argc, ret, err);
+				}
+#ifdef DEBUG_ENABLED
+				if (GDScriptLanguage::get_singleton()->profiling) {
+					function_call_time += OS::get_singleton()->get_ticks_usec() - call_time;
+				}
+
+				if (err.error != Variant::CallError::CALL_OK) {
+
+					String methodstr = *methodname;
+					String basestr = _get_var_type(base);
+					err_text = _get_call_error(err, "function '" + methodstr + "' in base '" + basestr + "'", (const Variant **)argptrs);
+					OPCODE_BREAK;
+				}
+#endif
+
+				ip += argc + 1;
+			}
+			DISPATCH_OPCODE;
+
 			OPCODE(OPCODE_CALL_SELF) {
 
 				OPCODE_BREAK;
@@ -1439,6 +1862,8 @@ GDScriptFunction::GDScriptFunction() :
 
 	_stack_size = 0;
 	_call_size = 0;
+	_inline_caches_ptr = NULL;
+	_inline_cache_count = 0;
 	rpc_mode = ScriptInstance::RPC_MODE_DISABLED;
 	name = "<anonymous>";
 #ifdef DEBUG_ENABLED
@@ -61,6 +61,7 @@ public:
 		OPCODE_CALL,
 		OPCODE_CALL_RETURN,
 		OPCODE_CALL_BUILT_IN,
+		OPCODE_CALL_BUILT_IN_METHOD, // method of a built-in type, resolved at compile time
 		OPCODE_CALL_SELF,
 		OPCODE_CALL_SELF_BASE,
 		OPCODE_YIELD,
@@ -112,6 +113,48 @@ public:
 
 private:
 	friend class GDScriptCompiler;
+	friend class GDScriptCompiledBuffer;
+
+	/*
+	Calls and named gets/sets remember what their name resolved to the last time, for the
+	script and class (or built-in type) of the base they ran on. The next run on the same
+	kind of base skips the lookups by name. Entries are stale once any script is compiled
+	or freed (see GDScriptLanguage::invalidate_inline_caches()).
+	*/
+	struct InlineCacheData {
+
+		enum Kind {
+			KIND_EMPTY,
+			KIND_SCRIPT_FUNCTION, // method of the base's script
+			KIND_METHOD_BIND, // native method of the base's class
+			KIND_BUILT_IN_METHOD, // method of a built-in type
+			KIND_MEMBER, // script member variable, function is its getter or setter if it has one
+			KIND_PROPERTY, // native property, method is its getter or setter
+		};
+
+		Kind kind;
+		uint32_t epoch;
+		Variant::Type type;
+		const void *script;
+		const void *class_name;
+		GDScriptFunction *function;
+		MethodBind *method;
+		const Variant::BuiltInMethod *builtin_method;
+		int index;
+	};
+
+	struct InlineCache {
+
+		uint32_t version; // odd while the data is being written
+		uint32_t writing;
+		InlineCacheData data;
+
+		InlineCache() {
+			version = 0;
+			writing = 0;
+			data.kind = InlineCacheData::KIND_EMPTY;
+		}
+	};
 
 	StringName source;
 
@@ -120,6 +163,10 @@ private:
 	int _constant_count;
 	const StringName *_global_names_ptr;
 	int _global_names_count;
+	const Variant::BuiltInMethod *const *_builtin_methods_ptr;
+	int _builtin_methods_count;
+	InlineCache *_inline_caches_ptr;
+	int _inline_cache_count;
 	const int *_default_arg_ptr;
 	int _default_arg_count;
 	const int *_code_ptr;
@@ -136,6 +183,8 @@ private:
 	StringName name;
 	Vector<Variant> constants;
 	Vector<StringName> global_names;
+	Vector<const Variant::BuiltInMethod *> builtin_methods;
+	Vector<InlineCache> inline_caches;
 	Vector<int> default_arguments;
 	Vector<int> code;
 
@@ -148,6 +197,15 @@ private:
 	_FORCE_INLINE_ Variant *_get_variant(int p_address, GDScriptInstance *p_instance, GDScript *p_script, Variant &self, Variant *p_stack, String &r_error) const;
 	_FORCE_INLINE_ String _get_call_error(const Variant::CallError &p_err, const String &p_where, const Variant **argptrs) const;
 
+	static bool _read_inline_cache(InlineCache *p_cache, InlineCacheData *r_data);
+	static void _write_inline_cache(InlineCache *p_cache, const InlineCacheData &p_data);
+	static _FORCE_INLINE_ bool _inline_cache_matches(const InlineCacheData &p_data, const InlineCacheData &p_key);
+	static GDScriptFunction *_find_script_function(GDScript *p_script, const StringName &p_name);
+	static bool _get_inline_cache_key(const Variant *p_base, InlineCacheData *r_key, Object **r_object, GDScriptInstance **r_instance);
+	static bool _call_cached(InlineCache *p_cache, Variant *p_base, const StringName &p_method, const Variant **p_args, int p_argcount, Variant *r_ret, Variant::CallError &r_err);
+	static bool _get_cached(InlineCache *p_cache, const Variant *p_base, const StringName &p_name, Variant *r_ret);
+	static bool _set_cached(InlineCache *p_cache, Variant *p_base, const StringName &p_name, const Variant &p_value, bool *r_valid);
+
 	friend class GDScriptLanguage;
 
 	SelfList<GDScriptFunction> function_list;
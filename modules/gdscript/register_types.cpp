@@ -30,6 +30,7 @@
 #include "register_types.h"
 
 #include "gdscript.h"
+#include "gdscript_compiled_buffer.h"
 #include "gdscript_tokenizer.h"
 #include "io/file_access_encrypted.h"
 #include "io/resource_loader.h"
@@ -49,7 +50,14 @@ class EditorExportGDScript : public EditorExportPlugin {
 
 	GDCLASS(EditorExportGDScript, EditorExportPlugin);
 
+	bool debug;
+
 public:
+	virtual void _export_begin(const Set<String> &p_features, bool p_debug, const String &p_path, int p_flags) {
+
+		debug = p_debug;
+	}
+
 	virtual void _export_file(const String &p_path, const String &p_type, const Set<String> &p_features) {
 
 		if (!p_path.ends_with(".gd"))
@@ -65,8 +73,21 @@ public:
 		if (file.empty())
 			return;
 
+		// ship what the editor compiled too, the tokens stay as a fallback
+		Ref<GDScript> script = ResourceLoader::load(p_path);
+		if (script.is_valid() && script->is_valid()) {
+			Vector<uint8_t> compiled = GDScriptCompiledBuffer::make_buffer(script, file, debug);
+			if (!compiled.empty())
+				file = compiled;
+		}
+
 		add_file(p_path.get_basename() + ".gdc", file, true);
 	}
+
+	EditorExportGDScript() {
+
+		debug = false;
+	}
 };
 
 static void _editor_init() {
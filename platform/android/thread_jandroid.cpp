@@ -29,8 +29,11 @@
 /*************************************************************************/
 #include "thread_jandroid.h"
 
+#include "core/dvector.h"
+#include "core/message_queue.h"
 #include "core/safe_refcount.h"
 #include "os/memory.h"
+#include "os/slab_allocator.h"
 #include "script_language.h"
 
 static pthread_key_t _create_thread_id_key() {
@@ -61,6 +64,9 @@ void *ThreadAndroid::thread_callback(void *userdata) {
 	pthread_setspecific(thread_id_key, (void *)t->id);
 	t->callback(t->user);
 	ScriptServer::thread_exit();
+	MessageQueue::release_thread_buffer();
+	MemoryPool::release_thread_cache();
+	SlabAllocator::release_thread_cache();
 	return NULL;
 }
 
@@ -27,10 +27,11 @@
 /* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
 /*************************************************************************/
-//#include "servers/visual/visual_server_raster.h"
-//#include "servers/visual/rasterizer_dummy.h"
 #include "os_server.h"
+#include "drivers/dummy/rasterizer_dummy.h"
 #include "print_string.h"
+#include "servers/visual/visual_server_raster.h"
+#include "servers/visual/visual_server_wrap_mt.h"
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -53,19 +54,15 @@ Error OS_Server::initialize(const VideoMode &p_desired, int p_video_driver, int
 	current_videomode = p_desired;
 	main_loop = NULL;
 
-	//rasterizer = memnew( RasterizerDummy );
+	RasterizerDummy::make_current();
 
-	//visual_server = memnew( VisualServerRaster(rasterizer) );
+	visual_server = memnew(VisualServerRaster);
+	if (get_render_thread_mode() != RENDER_THREAD_UNSAFE) {
 
-	AudioDriverManager::initialize(p_audio_driver);
+		visual_server = memnew(VisualServerWrapMT(visual_server, get_render_thread_mode() == RENDER_SEPARATE_THREAD));
+	}
 
-	sample_manager = memnew(SampleManagerMallocSW);
-	audio_server = memnew(AudioServerSW(sample_manager));
-	audio_server->init();
-	spatial_sound_server = memnew(SpatialSoundServerSW);
-	spatial_sound_server->init();
-	spatial_sound_2d_server = memnew(SpatialSound2DServerSW);
-	spatial_sound_2d_server->init();
+	AudioDriverManager::initialize(p_audio_driver);
 
 	ERR_FAIL_COND_V(!visual_server, ERR_UNAVAILABLE);
 
@@ -75,6 +72,8 @@ Error OS_Server::initialize(const VideoMode &p_desired, int p_video_driver, int
 
 	_ensure_user_data_dir();
 
+	power_manager = memnew(PowerX11);
+
 	return OK;
 }
 
@@ -84,28 +83,19 @@ void OS_Server::finalize() {
 		memdelete(main_loop);
 	main_loop = NULL;
 
-	spatial_sound_server->finish();
-	memdelete(spatial_sound_server);
-	spatial_sound_2d_server->finish();
-	memdelete(spatial_sound_2d_server);
-
 	/*
 	if (debugger_connection_console) {
 		memdelete(debugger_connection_console);
 	}
 	*/
 
-	memdelete(sample_manager);
-
-	audio_server->finish();
-	memdelete(audio_server);
-
 	visual_server->finish();
 	memdelete(visual_server);
-	//memdelete(rasterizer);
 
 	memdelete(input);
 
+	memdelete(power_manager);
+
 	args.clear();
 }
 
@@ -197,6 +187,11 @@ int OS_Server::get_power_percent_left() {
 	return power_manager->get_power_percent_left();
 }
 
+bool OS_Server::_check_internal_feature_support(const String &p_feature) {
+
+	return p_feature == "pc";
+}
+
 void OS_Server::run() {
 
 	force_quit = false;
@@ -217,6 +212,7 @@ void OS_Server::run() {
 
 OS_Server::OS_Server() {
 
-	//adriver here
+	AudioDriverManager::add_driver(&driver_dummy);
+
 	grab = false;
 };
@@ -31,9 +31,9 @@
 #define OS_SERVER_H
 
 #include "../x11/power_x11.h"
-#include "drivers/rtaudio/audio_driver_rtaudio.h"
 #include "drivers/unix/os_unix.h"
 #include "main/input_default.h"
+#include "servers/audio/audio_driver_dummy.h"
 #include "servers/audio_server.h"
 #include "servers/visual/rasterizer.h"
 #include "servers/visual_server.h"
@@ -45,7 +45,6 @@
 
 class OS_Server : public OS_Unix {
 
-	//Rasterizer *rasterizer;
 	VisualServer *visual_server;
 	VideoMode current_videomode;
 	List<String> args;
@@ -62,6 +61,8 @@ class OS_Server : public OS_Unix {
 
 	PowerX11 *power_manager;
 
+	AudioDriverDummy driver_dummy;
+
 protected:
 	virtual int get_video_driver_count() const;
 	virtual const char *get_video_driver_name(int p_driver) const;
@@ -98,6 +99,8 @@ public:
 
 	void run();
 
+	virtual bool _check_internal_feature_support(const String &p_feature);
+
 	virtual OS::PowerState get_power_state();
 	virtual int get_power_seconds_left();
 	virtual int get_power_percent_left();
@@ -29,12 +29,16 @@
 /*************************************************************************/
 #include "navigation.h"
 
+#include "message_queue.h"
+
 void Navigation::_navmesh_link(int p_id) {
 
 	ERR_FAIL_COND(!navmesh_map.has(p_id));
 	NavMesh &nm = navmesh_map[p_id];
 	ERR_FAIL_COND(nm.linked);
 
+	path_graph_dirty = true;
+
 	PoolVector<Vector3> vertices = nm.navmesh->get_vertices();
 	int len = vertices.size();
 	if (len == 0)
@@ -142,6 +146,8 @@ void Navigation::_navmesh_unlink(int p_id) {
 	NavMesh &nm = navmesh_map[p_id];
 	ERR_FAIL_COND(!nm.linked);
 
+	path_graph_dirty = true;
+
 	for (List<Polygon>::Element *E = nm.polygons.front(); E; E = E->next()) {
 
 		Polygon &p = E->get();
@@ -234,7 +240,67 @@ void Navigation::navmesh_remove(int p_id) {
 	navmesh_map.erase(p_id);
 }
 
-void Navigation::_clip_path(Vector<Vector3> &path, Polygon *from_poly, const Vector3 &p_to_point, Polygon *p_to_poly) {
+void Navigation::_update_path_graph() {
+
+	if (!path_graph_dirty)
+		return;
+
+	int poly_count = 0;
+	int edge_count = 0;
+
+	for (Map<int, NavMesh>::Element *E = navmesh_map.front(); E; E = E->next()) {
+
+		if (!E->get().linked)
+			continue;
+		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
+
+			F->get().index = poly_count++;
+			edge_count += F->get().edges.size();
+		}
+	}
+
+	// Build new arrays, batches still running keep the old ones.
+	PathGraph graph;
+	graph.polygons.resize(poly_count);
+	graph.edges.resize(edge_count);
+	graph.up = up;
+
+	PathGraph::Poly *polys = graph.polygons.ptrw();
+	PathGraph::Edge *edges = graph.edges.ptrw();
+	int e = 0;
+
+	for (Map<int, NavMesh>::Element *E = navmesh_map.front(); E; E = E->next()) {
+
+		if (!E->get().linked)
+			continue;
+		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
+
+			const Polygon &p = F->get();
+			PathGraph::Poly &gp = polys[p.index];
+			gp.first_edge = e;
+			gp.edge_count = p.edges.size();
+			gp.center = p.center;
+			gp.clockwise = p.clockwise;
+
+			for (int i = 0; i < p.edges.size(); i++) {
+
+				edges[e].vertex = _get_vertex(p.edges[i].point);
+				edges[e].C = p.edges[i].C ? p.edges[i].C->index : -1;
+				edges[e].C_edge = p.edges[i].C_edge;
+				e++;
+			}
+		}
+	}
+
+	path_graph = graph;
+	path_graph_dirty = false;
+}
+
+void Navigation::_clip_path(const PathGraph &p_graph, const PathState *p_states, Vector<Vector3> &path, int p_from_poly, const Vector3 &p_to_point, int p_to_poly) {
+
+	const Vector3 &up = p_graph.up;
+	const PathGraph::Poly *polys = p_graph.polygons.ptr();
+	const PathGraph::Edge *edges = p_graph.edges.ptr();
 
 	Vector3 from = path[path.size() - 1];
 
@@ -247,14 +313,17 @@ void Navigation::_clip_path(Vector<Vector3> &path, Polygon *from_poly, const Vec
 	cut_plane.normal.normalize();
 	cut_plane.d = cut_plane.normal.dot(from);
 
+	int from_poly = p_from_poly;
+
 	while (from_poly != p_to_poly) {
 
-		int pe = from_poly->prev_edge;
-		Vector3 a = _get_vertex(from_poly->edges[pe].point);
-		Vector3 b = _get_vertex(from_poly->edges[(pe + 1) % from_poly->edges.size()].point);
+		const PathGraph::Poly &fp = polys[from_poly];
+		int pe = p_states[from_poly].prev_edge;
+		Vector3 a = edges[fp.first_edge + pe].vertex;
+		Vector3 b = edges[fp.first_edge + (pe + 1) % fp.edge_count].vertex;
 
-		from_poly = from_poly->edges[pe].C;
-		ERR_FAIL_COND(!from_poly);
+		from_poly = edges[fp.first_edge + pe].C;
+		ERR_FAIL_COND(from_poly < 0);
 
 		if (a.distance_to(b) > CMP_EPSILON) {
 
@@ -268,47 +337,54 @@ void Navigation::_clip_path(Vector<Vector3> &path, Polygon *from_poly, const Vec
 	}
 }
 
-Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector3 &p_end, bool p_optimize) {
+Vector<Vector3> Navigation::_get_simple_path(const PathGraph &p_graph, Vector<PathState> &r_states, const Vector3 &p_start, const Vector3 &p_end, bool p_optimize) {
+
+	const Vector3 &up = p_graph.up;
+	const PathGraph::Poly *polys = p_graph.polygons.ptr();
+	const PathGraph::Edge *edges = p_graph.edges.ptr();
+	int poly_count = p_graph.polygons.size();
 
-	Polygon *begin_poly = NULL;
-	Polygon *end_poly = NULL;
+	if (r_states.size() < poly_count) {
+		r_states.resize(poly_count);
+	}
+	PathState *states = r_states.ptrw();
+
+	int begin_poly = -1;
+	int end_poly = -1;
 	Vector3 begin_point;
 	Vector3 end_point;
 	float begin_d = 1e20;
 	float end_d = 1e20;
 
-	for (Map<int, NavMesh>::Element *E = navmesh_map.front(); E; E = E->next()) {
-
-		if (!E->get().linked)
-			continue;
-		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
+	for (int pi = 0; pi < poly_count; pi++) {
 
-			Polygon &p = F->get();
-			for (int i = 2; i < p.edges.size(); i++) {
+		const PathGraph::Poly &p = polys[pi];
+		const PathGraph::Edge *pe = &edges[p.first_edge];
 
-				Face3 f(_get_vertex(p.edges[0].point), _get_vertex(p.edges[i - 1].point), _get_vertex(p.edges[i].point));
-				Vector3 spoint = f.get_closest_point_to(p_start);
-				float dpoint = spoint.distance_to(p_start);
-				if (dpoint < begin_d) {
-					begin_d = dpoint;
-					begin_poly = &p;
-					begin_point = spoint;
-				}
+		for (int i = 2; i < p.edge_count; i++) {
 
-				spoint = f.get_closest_point_to(p_end);
-				dpoint = spoint.distance_to(p_end);
-				if (dpoint < end_d) {
-					end_d = dpoint;
-					end_poly = &p;
-					end_point = spoint;
-				}
+			Face3 f(pe[0].vertex, pe[i - 1].vertex, pe[i].vertex);
+			Vector3 spoint = f.get_closest_point_to(p_start);
+			float dpoint = spoint.distance_to(p_start);
+			if (dpoint < begin_d) {
+				begin_d = dpoint;
+				begin_poly = pi;
+				begin_point = spoint;
 			}
 
-			p.prev_edge = -1;
+			spoint = f.get_closest_point_to(p_end);
+			dpoint = spoint.distance_to(p_end);
+			if (dpoint < end_d) {
+				end_d = dpoint;
+				end_poly = pi;
+				end_point = spoint;
+			}
 		}
+
+		states[pi].prev_edge = -1;
 	}
 
-	if (!begin_poly || !end_poly) {
+	if (begin_poly < 0 || end_poly < 0) {
 
 		//print_line("No Path Path");
 		return Vector<Vector3>(); //no path
@@ -326,17 +402,20 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 
 	bool found_route = false;
 
-	List<Polygon *> open_list;
+	Vector<int> open_list;
 
-	for (int i = 0; i < begin_poly->edges.size(); i++) {
+	const PathGraph::Poly &bp = polys[begin_poly];
+	for (int i = 0; i < bp.edge_count; i++) {
 
-		if (begin_poly->edges[i].C) {
+		const PathGraph::Edge &e = edges[bp.first_edge + i];
 
-			begin_poly->edges[i].C->prev_edge = begin_poly->edges[i].C_edge;
-			begin_poly->edges[i].C->distance = begin_poly->center.distance_to(begin_poly->edges[i].C->center);
-			open_list.push_back(begin_poly->edges[i].C);
+		if (e.C >= 0) {
 
-			if (begin_poly->edges[i].C == end_poly) {
+			states[e.C].prev_edge = e.C_edge;
+			states[e.C].distance = bp.center.distance_to(polys[e.C].center);
+			open_list.push_back(e.C);
+
+			if (e.C == end_poly) {
 				found_route = true;
 			}
 		}
@@ -350,49 +429,50 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 		}
 		//check open list
 
-		List<Polygon *>::Element *least_cost_poly = NULL;
+		int least_cost_poly = -1;
 		float least_cost = 1e30;
 
 		//this could be faster (cache previous results)
-		for (List<Polygon *>::Element *E = open_list.front(); E; E = E->next()) {
+		for (int i = 0; i < open_list.size(); i++) {
 
-			Polygon *p = E->get();
+			int pi = open_list[i];
 
-			float cost = p->distance;
-			cost += p->center.distance_to(end_point);
+			float cost = states[pi].distance;
+			cost += polys[pi].center.distance_to(end_point);
 
 			if (cost < least_cost) {
 
-				least_cost_poly = E;
+				least_cost_poly = i;
 				least_cost = cost;
 			}
 		}
 
-		Polygon *p = least_cost_poly->get();
+		int pi = open_list[least_cost_poly];
+		const PathGraph::Poly &p = polys[pi];
 		//open the neighbours for search
 
-		for (int i = 0; i < p->edges.size(); i++) {
+		for (int i = 0; i < p.edge_count; i++) {
 
-			Polygon::Edge &e = p->edges[i];
+			const PathGraph::Edge &e = edges[p.first_edge + i];
 
-			if (!e.C)
+			if (e.C < 0)
 				continue;
 
-			float distance = p->center.distance_to(e.C->center) + p->distance;
+			float distance = p.center.distance_to(polys[e.C].center) + states[pi].distance;
 
-			if (e.C->prev_edge != -1) {
+			if (states[e.C].prev_edge != -1) {
 				//oh this was visited already, can we win the cost?
 
-				if (e.C->distance > distance) {
+				if (states[e.C].distance > distance) {
 
-					e.C->prev_edge = e.C_edge;
-					e.C->distance = distance;
+					states[e.C].prev_edge = e.C_edge;
+					states[e.C].distance = distance;
 				}
 			} else {
 				//add to open neighbours
 
-				e.C->prev_edge = e.C_edge;
-				e.C->distance = distance;
+				states[e.C].prev_edge = e.C_edge;
+				states[e.C].distance = distance;
 				open_list.push_back(e.C);
 
 				if (e.C == end_poly) {
@@ -406,7 +486,7 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 		if (found_route)
 			break;
 
-		open_list.erase(least_cost_poly);
+		open_list.remove(least_cost_poly);
 	}
 
 	if (found_route) {
@@ -416,16 +496,16 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 		if (p_optimize) {
 			//string pulling
 
-			Polygon *apex_poly = end_poly;
+			int apex_poly = end_poly;
 			Vector3 apex_point = end_point;
 			Vector3 portal_left = apex_point;
 			Vector3 portal_right = apex_point;
-			Polygon *left_poly = end_poly;
-			Polygon *right_poly = end_poly;
-			Polygon *p = end_poly;
+			int left_poly = end_poly;
+			int right_poly = end_poly;
+			int p = end_poly;
 			path.push_back(end_point);
 
-			while (p) {
+			while (p >= 0) {
 
 				Vector3 left;
 				Vector3 right;
@@ -436,13 +516,14 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 					left = begin_point;
 					right = begin_point;
 				} else {
-					int prev = p->prev_edge;
-					int prev_n = (p->prev_edge + 1) % p->edges.size();
-					left = _get_vertex(p->edges[prev].point);
-					right = _get_vertex(p->edges[prev_n].point);
+					const PathGraph::Poly &pp = polys[p];
+					int prev = states[p].prev_edge;
+					int prev_n = (states[p].prev_edge + 1) % pp.edge_count;
+					left = edges[pp.first_edge + prev].vertex;
+					right = edges[pp.first_edge + prev_n].vertex;
 
 					//if (CLOCK_TANGENT(apex_point,left,(left+right)*0.5).dot(up) < 0){
-					if (p->clockwise) {
+					if (pp.clockwise) {
 						SWAP(left, right);
 					}
 				}
@@ -456,7 +537,7 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 						portal_left = left;
 					} else {
 
-						_clip_path(path, apex_poly, portal_right, right_poly);
+						_clip_path(p_graph, states, path, apex_poly, portal_right, right_poly);
 
 						apex_point = portal_right;
 						p = right_poly;
@@ -476,7 +557,7 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 						portal_right = right;
 					} else {
 
-						_clip_path(path, apex_poly, portal_left, left_poly);
+						_clip_path(p_graph, states, path, apex_poly, portal_left, left_poly);
 
 						apex_point = portal_left;
 						p = left_poly;
@@ -489,9 +570,9 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 				}
 
 				if (p != begin_poly)
-					p = p->edges[p->prev_edge].C;
+					p = edges[polys[p].first_edge + states[p].prev_edge].C;
 				else
-					p = NULL;
+					p = -1;
 			}
 
 			if (path[path.size() - 1] != begin_point)
@@ -501,15 +582,16 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 
 		} else {
 			//midpoints
-			Polygon *p = end_poly;
+			int p = end_poly;
 
 			path.push_back(end_point);
 			while (true) {
-				int prev = p->prev_edge;
-				int prev_n = (p->prev_edge + 1) % p->edges.size();
-				Vector3 point = (_get_vertex(p->edges[prev].point) + _get_vertex(p->edges[prev_n].point)) * 0.5;
+				const PathGraph::Poly &pp = polys[p];
+				int prev = states[p].prev_edge;
+				int prev_n = (states[p].prev_edge + 1) % pp.edge_count;
+				Vector3 point = (edges[pp.first_edge + prev].vertex + edges[pp.first_edge + prev_n].vertex) * 0.5;
 				path.push_back(point);
-				p = p->edges[prev].C;
+				p = edges[pp.first_edge + prev].C;
 				if (p == begin_poly)
 					break;
 			}
@@ -525,6 +607,134 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 	return Vector<Vector3>();
 }
 
+Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector3 &p_end, bool p_optimize) {
+
+	_update_path_graph();
+
+	return _get_simple_path(path_graph, path_states, p_start, p_end, p_optimize);
+}
+
+void Navigation::_solve_path_batch(void *p_batch, uint32_t p_chunk) {
+
+	PathBatch *batch = (PathBatch *)p_batch;
+
+	const Vector3 *queries = batch->queries.ptr();
+	Variant *paths = batch->paths.ptrw();
+
+	int from = p_chunk * batch->chunk_size;
+	int to = MIN(from + batch->chunk_size, batch->paths.size());
+
+	// Each chunk has its own scratch state, the graph is only read.
+	Vector<PathState> states;
+
+	for (int i = from; i < to; i++) {
+		paths[i] = _get_simple_path(batch->graph, states, queries[i * 2 + 0], queries[i * 2 + 1], batch->optimize);
+	}
+}
+
+void Navigation::_path_batch_done(void *p_batch) {
+
+	PathBatch *batch = (PathBatch *)p_batch;
+	MessageQueue::get_singleton()->push_call(batch->owner, "_path_batch_solved", batch->id);
+}
+
+Navigation::PathBatch *Navigation::_create_path_batch(const PoolVector<Vector3> &p_from_to, bool p_optimize) {
+
+	ERR_FAIL_COND_V(p_from_to.size() % 2 != 0, NULL);
+
+	_update_path_graph();
+
+	PathBatch *batch = memnew(PathBatch);
+	batch->id = ++last_batch_id;
+	batch->owner = get_instance_id();
+	batch->optimize = p_optimize;
+	batch->graph = path_graph;
+
+	int count = p_from_to.size() / 2;
+	batch->queries.resize(count * 2);
+	batch->paths.resize(count);
+
+	PoolVector<Vector3>::Read r = p_from_to.read();
+	Vector3 *queries = batch->queries.ptrw();
+	for (int i = 0; i < count * 2; i++) {
+		queries[i] = r[i];
+	}
+
+	return batch;
+}
+
+void Navigation::_run_path_batch(PathBatch *p_batch, bool p_notify) {
+
+	JobSystem *job_system = JobSystem::get_singleton();
+
+	if (p_notify) {
+		job_system->set_completion_callback(&p_batch->group, _path_batch_done, p_batch);
+	}
+
+	// A few chunks per thread balance the load without paying for many scratch states.
+	int count = p_batch->paths.size();
+	int chunks = MIN(count, (job_system->get_thread_count() + 1) * 4);
+	p_batch->chunk_size = chunks > 0 ? (count + chunks - 1) / chunks : 1;
+	chunks = (count + p_batch->chunk_size - 1) / p_batch->chunk_size;
+
+	job_system->submit(&p_batch->group, _solve_path_batch, p_batch, chunks);
+	job_system->close(&p_batch->group);
+}
+
+Array Navigation::_get_batch_paths(PathBatch *p_batch) {
+
+	Array paths;
+	paths.resize(p_batch->paths.size());
+
+	for (int i = 0; i < p_batch->paths.size(); i++) {
+		paths[i] = p_batch->paths[i];
+	}
+
+	return paths;
+}
+
+Array Navigation::get_simple_paths(const PoolVector<Vector3> &p_from_to, bool p_optimize) {
+
+	PathBatch *batch = _create_path_batch(p_from_to, p_optimize);
+	ERR_FAIL_COND_V(!batch, Array());
+
+	_run_path_batch(batch, false);
+	JobSystem::get_singleton()->wait(&batch->group);
+
+	Array paths = _get_batch_paths(batch);
+	memdelete(batch);
+
+	return paths;
+}
+
+int Navigation::request_simple_paths(const PoolVector<Vector3> &p_from_to, bool p_optimize) {
+
+	PathBatch *batch = _create_path_batch(p_from_to, p_optimize);
+	ERR_FAIL_COND_V(!batch, -1);
+
+	path_batches[batch->id] = batch;
+	_run_path_batch(batch, true);
+
+	return batch->id;
+}
+
+void Navigation::_path_batch_solved(int p_id) {
+
+	Map<int, PathBatch *>::Element *E = path_batches.find(p_id);
+	ERR_FAIL_COND(!E);
+
+	PathBatch *batch = E->get();
+	path_batches.erase(E);
+
+	// The message is sent right before the group is flagged as completed.
+	JobSystem::get_singleton()->wait(&batch->group);
+
+	Array paths = _get_batch_paths(batch);
+	memdelete(batch);
+
+	emit_signal("paths_solved", p_id, paths);
+}
+
 Vector3 Navigation::get_closest_point_to_segment(const Vector3 &p_from, const Vector3 &p_to, const bool &p_use_collision) {
 
 	bool use_collision = p_use_collision;
@@ -677,6 +887,7 @@ Object *Navigation::get_closest_point_owner(const Vector3 &p_point) {
 void Navigation::set_up_vector(const Vector3 &p_up) {
 
 	up = p_up;
+	path_graph_dirty = true;
 }
 
 Vector3 Navigation::get_up_vector() const {
@@ -691,6 +902,8 @@ void Navigation::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("navmesh_remove", "id"), &Navigation::navmesh_remove);
 
 	ClassDB::bind_method(D_METHOD("get_simple_path", "start", "end", "optimize"), &Navigation::get_simple_path, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("get_simple_paths", "start_end_pairs", "optimize"), &Navigation::get_simple_paths, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("request_simple_paths", "start_end_pairs", "optimize"), &Navigation::request_simple_paths, DEFVAL(true));
 	ClassDB::bind_method(D_METHOD("get_closest_point_to_segment", "start", "end", "use_collision"), &Navigation::get_closest_point_to_segment, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("get_closest_point", "to_point"), &Navigation::get_closest_point);
 	ClassDB::bind_method(D_METHOD("get_closest_point_normal", "to_point"), &Navigation::get_closest_point_normal);
@@ -699,7 +912,11 @@ void Navigation::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_up_vector", "up"), &Navigation::set_up_vector);
 	ClassDB::bind_method(D_METHOD("get_up_vector"), &Navigation::get_up_vector);
 
+	ClassDB::bind_method(D_METHOD("_path_batch_solved", "request_id"), &Navigation::_path_batch_solved);
+
 	ADD_PROPERTY(PropertyInfo(Variant::VECTOR3, "up_vector"), "set_up_vector", "get_up_vector");
+
+	ADD_SIGNAL(MethodInfo("paths_solved", PropertyInfo(Variant::INT, "request_id"), PropertyInfo(Variant::ARRAY, "paths")));
 }
 
 Navigation::Navigation() {
@@ -708,4 +925,15 @@ Navigation::Navigation() {
 	cell_size = 0.01; //one centimeter
 	last_id = 1;
 	up = Vector3(0, 1, 0);
+	path_graph_dirty = true;
+	last_batch_id = 0;
+}
+
+Navigation::~Navigation() {
+
+	for (Map<int, PathBatch *>::Element *E = path_batches.front(); E; E = E->next()) {
+
+		JobSystem::get_singleton()->wait(&E->get()->group);
+		memdelete(E->get());
+	}
 }
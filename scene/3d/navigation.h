@@ -30,6 +30,7 @@
 #ifndef NAVIGATION_H
 #define NAVIGATION_H
 
+#include "os/job_system.h"
 #include "scene/3d/navigation_mesh.h"
 #include "scene/3d/spatial.h"
 
@@ -94,9 +95,8 @@ class Navigation : public Spatial {
 
 		Vector3 center;
 
-		float distance;
-		int prev_edge;
 		bool clockwise;
+		int index; // in the path graph
 
 		NavMesh *owner;
 	};
@@ -156,7 +156,70 @@ class Navigation : public Spatial {
 	int last_id;
 
 	Vector3 up;
-	void _clip_path(Vector<Vector3> &path, Polygon *from_poly, const Vector3 &p_to_point, Polygon *p_to_poly);
+
+	// Flat copy of the linked polygons, which path queries read. It's rebuilt
+	// lazily after edits, and batches keep the copy they started with.
+	struct PathGraph {
+
+		struct Edge {
+
+			Vector3 vertex;
+			int C; // connected polygon, -1 if none
+			int C_edge;
+		};
+
+		struct Poly {
+
+			int first_edge;
+			int edge_count;
+			Vector3 center;
+			bool clockwise;
+		};
+
+		Vector<Poly> polygons;
+		Vector<Edge> edges;
+		Vector3 up;
+	};
+
+	// Scratch state of a search, one per polygon.
+	struct PathState {
+
+		float distance;
+		int prev_edge;
+	};
+
+	PathGraph path_graph;
+	bool path_graph_dirty;
+	Vector<PathState> path_states;
+
+	void _update_path_graph();
+
+	static void _clip_path(const PathGraph &p_graph, const PathState *p_states, Vector<Vector3> &path, int p_from_poly, const Vector3 &p_to_point, int p_to_poly);
+	static Vector<Vector3> _get_simple_path(const PathGraph &p_graph, Vector<PathState> &r_states, const Vector3 &p_start, const Vector3 &p_end, bool p_optimize);
+
+	// Batches of path queries, solved on the job system over a copy of the path graph.
+	struct PathBatch {
+
+		int id;
+		ObjectID owner;
+		bool optimize;
+		PathGraph graph;
+		Vector<Vector3> queries; // start and end pairs
+		Vector<Variant> paths;
+		int chunk_size;
+		JobSystem::Group group;
+	};
+
+	Map<int, PathBatch *> path_batches;
+	int last_batch_id;
+
+	PathBatch *_create_path_batch(const PoolVector<Vector3> &p_from_to, bool p_optimize);
+	void _run_path_batch(PathBatch *p_batch, bool p_notify);
+	Array _get_batch_paths(PathBatch *p_batch);
+	void _path_batch_solved(int p_id);
+
+	static void _solve_path_batch(void *p_batch, uint32_t p_chunk);
+	static void _path_batch_done(void *p_batch);
 
 protected:
 	static void _bind_methods();
@@ -171,12 +234,15 @@ public:
 	void navmesh_remove(int p_id);
 
 	Vector<Vector3> get_simple_path(const Vector3 &p_start, const Vector3 &p_end, bool p_optimize = true);
+	Array get_simple_paths(const PoolVector<Vector3> &p_from_to, bool p_optimize = true);
+	int request_simple_paths(const PoolVector<Vector3> &p_from_to, bool p_optimize = true);
 	Vector3 get_closest_point_to_segment(const Vector3 &p_from, const Vector3 &p_to, const bool &p_use_collision = false);
 	Vector3 get_closest_point(const Vector3 &p_point);
 	Vector3 get_closest_point_normal(const Vector3 &p_point);
 	Object *get_closest_point_owner(const Vector3 &p_point);
 
 	Navigation();
+	~Navigation();
 };
 
 #endif // NAVIGATION_H
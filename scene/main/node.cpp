@@ -34,6 +34,7 @@
 #include "io/resource_loader.h"
 #include "message_queue.h"
 #include "print_string.h"
+#include "scene/main/scene_pool.h"
 #include "scene/resources/packed_scene.h"
 #include "scene/scene_string_names.h"
 #include "viewport.h"
@@ -143,6 +144,10 @@ void Node::_notification(int p_notification) {
 		} break;
 		case NOTIFICATION_PREDELETE: {
 
+			if (data.pool_in_use && ScenePool::get_singleton()) {
+				ScenePool::get_singleton()->_instance_freed();
+			}
+
 			set_owner(NULL);
 
 			while (data.owned.size()) {
@@ -324,6 +329,10 @@ void Node::move_child(Node *p_child, int p_pos) {
 	data.children.remove(p_child->data.pos);
 	data.children.insert(p_pos, p_child);
 
+	if (data.child_index && data.child_index->has_duplicates) {
+		_clear_child_index(); // which one comes first may have changed
+	}
+
 	if (data.tree) {
 		data.tree->tree_changed();
 	}
@@ -1133,7 +1142,15 @@ StringName Node::get_name() const {
 
 void Node::_set_name_nocheck(const StringName &p_name) {
 
+	if (data.parent) {
+		data.parent->_child_index_remove(this);
+	}
+
 	data.name = p_name;
+
+	if (data.parent) {
+		data.parent->_child_index_add(this);
+	}
 }
 
 void Node::set_name(const String &p_name) {
@@ -1141,11 +1158,18 @@ void Node::set_name(const String &p_name) {
 	String name = p_name.replace(":", "").replace("/", "").replace("@", "");
 
 	ERR_FAIL_COND(name == "");
+
+	if (data.parent) {
+
+		data.parent->_child_index_remove(this);
+	}
+
 	data.name = name;
 
 	if (data.parent) {
 
 		data.parent->_validate_child_name(this);
+		data.parent->_child_index_add(this);
 	}
 
 	propagate_notification(NOTIFICATION_PATH_CHANGED);
@@ -1199,15 +1223,24 @@ void Node::_validate_child_name(Node *p_child, bool p_force_human_readable) {
 			unique = false;
 		} else {
 			//check if exists
-			Node **childs = data.children.ptrw();
-			int cc = data.children.size();
+			ChildIndex *index = _get_child_index();
 
-			for (int i = 0; i < cc; i++) {
-				if (childs[i] == p_child)
-					continue;
-				if (childs[i]->data.name == p_child->data.name) {
-					unique = false;
-					break;
+			if (index && !index->has_duplicates) {
+
+				Node **existing = index->nodes.getptr(p_child->data.name);
+				unique = !existing || *existing == p_child;
+			} else {
+
+				Node **childs = data.children.ptrw();
+				int cc = data.children.size();
+
+				for (int i = 0; i < cc; i++) {
+					if (childs[i] == p_child)
+						continue;
+					if (childs[i]->data.name == p_child->data.name) {
+						unique = false;
+						break;
+					}
 				}
 			}
 		}
@@ -1221,6 +1254,30 @@ void Node::_validate_child_name(Node *p_child, bool p_force_human_readable) {
 	}
 }
 
+// Splits a name into its base and trailing number, if they are apart by the separator.
+static bool _split_serial_name(const String &p_name, const String &p_separator, String &r_base, String &r_nums) {
+
+	String nums;
+	for (int i = p_name.length() - 1; i >= 0; i--) {
+		CharType n = p_name[i];
+		if (n >= '0' && n <= '9') {
+			nums = String::chr(p_name[i]) + nums;
+		} else {
+			break;
+		}
+	}
+
+	r_nums = nums;
+
+	if (nums.length() > 0 && p_name.substr(p_name.length() - p_separator.length() - nums.length(), p_separator.length()) == p_separator) {
+		r_base = p_name.substr(0, p_name.length() - p_separator.length() - nums.length());
+		return true;
+	}
+
+	r_base = p_name;
+	return false;
+}
+
 String Node::_generate_serial_child_name(Node *p_child) {
 
 	String name = p_child->data.name;
@@ -1242,41 +1299,55 @@ String Node::_generate_serial_child_name(Node *p_child) {
 	}
 
 	// Extract trailing number
-	String nums;
-	for (int i = name.length() - 1; i >= 0; i--) {
-		CharType n = name[i];
-		if (n >= '0' && n <= '9') {
-			nums = String::chr(name[i]) + nums;
-		} else {
-			break;
-		}
-	}
-
 	String nnsep = _get_name_num_separator();
+	String base, nums;
 	int num = 0;
 	bool explicit_zero = false;
-	if (nums.length() > 0 && name.substr(name.length() - nnsep.length() - nums.length(), nnsep.length()) == nnsep) {
+	if (_split_serial_name(name, nnsep, base, nums)) {
 		// Base name + Separator + Number
 		num = nums.to_int();
-		name = name.substr(0, name.length() - nnsep.length() - nums.length()); // Keep base name
+		name = base; // Keep base name
 		if (num == 0) {
 			explicit_zero = true;
 		}
 	}
 
+	ChildIndex *index = _get_child_index();
+	if (index && index->has_duplicates) {
+		index = NULL;
+	}
+
+	// Names without a number are the common case when adding many nodes of the same kind,
+	// so remember where the search ended to avoid trying all the taken numbers again.
+	bool use_hint = index && nums.length() == 0;
+	if (use_hint) {
+		const int *hint = index->serial_hints.getptr(name);
+		if (hint) {
+			num = *hint;
+		}
+	}
+
 	int num_places = nums.length();
 	for (;;) {
 		String attempt = (name + (num > 0 || explicit_zero ? nnsep + itos(num).pad_zeros(num_places) : "")).strip_edges();
 		bool found = false;
-		for (int i = 0; i < data.children.size(); i++) {
-			if (data.children[i] == p_child)
-				continue;
-			if (data.children[i]->data.name == attempt) {
-				found = true;
-				break;
+		if (index) {
+			Node **existing = index->nodes.getptr(attempt);
+			found = existing && *existing != p_child;
+		} else {
+			for (int i = 0; i < data.children.size(); i++) {
+				if (data.children[i] == p_child)
+					continue;
+				if (data.children[i]->data.name == attempt) {
+					found = true;
+					break;
+				}
 			}
 		}
 		if (!found) {
+			if (use_hint && num >= 2) {
+				index->serial_hints[name] = num;
+			}
 			return attempt;
 		} else {
 			if (num == 0) {
@@ -1300,6 +1371,7 @@ void Node::_add_child_nocheck(Node *p_child, const StringName &p_name) {
 	p_child->data.name = p_name;
 	p_child->data.pos = data.children.size();
 	data.children.push_back(p_child);
+	_child_index_add(p_child);
 	p_child->data.parent = this;
 	p_child->notification(NOTIFICATION_PARENTED);
 
@@ -1391,14 +1463,9 @@ void Node::remove_child(Node *p_child) {
 		ERR_FAIL_COND(data.blocked > 0);
 	}
 
-	int idx = -1;
-	for (int i = 0; i < data.children.size(); i++) {
-
-		if (data.children[i] == p_child) {
-
-			idx = i;
-			break;
-		}
+	int idx = p_child->data.pos;
+	if (p_child->data.parent != this || idx < 0 || idx >= data.children.size() || data.children[idx] != p_child) {
+		idx = -1;
 	}
 
 	ERR_FAIL_COND(idx == -1);
@@ -1412,6 +1479,7 @@ void Node::remove_child(Node *p_child) {
 	remove_child_notify(p_child);
 	p_child->notification(NOTIFICATION_UNPARENTED);
 
+	_child_index_remove(p_child);
 	data.children.remove(idx);
 
 	for (int i = idx; i < data.children.size(); i++) {
@@ -1439,6 +1507,12 @@ Node *Node::get_child(int p_index) const {
 
 Node *Node::_get_child_by_name(const StringName &p_name) const {
 
+	ChildIndex *index = _get_child_index();
+	if (index) {
+		Node *const *child = index->nodes.getptr(p_name);
+		return child ? *child : NULL;
+	}
+
 	int cc = data.children.size();
 	Node *const *cd = data.children.ptr();
 
@@ -1450,6 +1524,82 @@ Node *Node::_get_child_by_name(const StringName &p_name) const {
 	return NULL;
 }
 
+Node::ChildIndex *Node::_get_child_index() const {
+
+	if (data.child_index || data.children.size() < CHILD_INDEX_THRESHOLD)
+		return data.child_index;
+
+	ChildIndex *index = memnew(ChildIndex);
+	index->has_duplicates = false;
+
+	for (int i = 0; i < data.children.size(); i++) {
+
+		Node *child = data.children[i];
+		if (index->nodes.has(child->data.name)) {
+			index->has_duplicates = true;
+		} else {
+			index->nodes.set(child->data.name, child);
+		}
+	}
+
+	data.child_index = index;
+	return index;
+}
+
+void Node::_child_index_add(Node *p_child) {
+
+	if (!data.child_index)
+		return;
+
+	Node **existing = data.child_index->nodes.getptr(p_child->data.name);
+
+	if (!existing) {
+		data.child_index->nodes.set(p_child->data.name, p_child);
+	} else if (p_child->data.pos == data.children.size() - 1) {
+		data.child_index->has_duplicates = true; // the existing one comes first
+	} else {
+		_clear_child_index();
+	}
+}
+
+void Node::_child_index_remove(Node *p_child) {
+
+	if (!data.child_index)
+		return;
+
+	if (data.child_index->has_duplicates) {
+		_clear_child_index(); // another child may have the same name
+		return;
+	}
+
+	data.child_index->nodes.erase(p_child->data.name);
+
+	if (data.child_index->serial_hints.empty())
+		return;
+
+	// the name is free again, so searches for it must start there at most
+	String base, nums;
+	if (!_split_serial_name(p_child->data.name, _get_name_num_separator(), base, nums)) {
+		data.child_index->serial_hints.erase(p_child->data.name);
+		return;
+	}
+
+	// generated serials start at 2
+	int num = nums.to_int();
+	int *hint = data.child_index->serial_hints.getptr(base);
+	if (hint && num >= 2 && num < *hint) {
+		*hint = num;
+	}
+}
+
+void Node::_clear_child_index() {
+
+	if (data.child_index) {
+		memdelete(data.child_index);
+		data.child_index = NULL;
+	}
+}
+
 Node *Node::_get_node(const NodePath &p_path) const {
 
 	if (!data.inside_tree && p_path.is_absolute()) {
@@ -1491,18 +1641,7 @@ Node *Node::_get_node(const NodePath &p_path) const {
 
 		} else {
 
-			next = NULL;
-
-			for (int j = 0; j < current->data.children.size(); j++) {
-
-				Node *child = current->data.children[j];
-
-				if (child->data.name == name) {
-
-					next = child;
-					break;
-				}
-			}
+			next = current->_get_child_by_name(name);
 			if (next == NULL) {
 				return NULL;
 			};
@@ -2998,11 +3137,13 @@ Node::Node() {
 	data.pause_owner = NULL;
 	data.network_master = 1; //server by default
 	data.path_cache = NULL;
+	data.child_index = NULL;
 	data.parent_owned = false;
 	data.in_constructor = true;
 	data.viewport = NULL;
 	data.use_placeholder = false;
 	data.display_folded = false;
+	data.pool_in_use = false;
 	data.ready_first = true;
 }
 
@@ -3011,6 +3152,7 @@ Node::~Node() {
 	data.grouped.clear();
 	data.owned.clear();
 	data.children.clear();
+	_clear_child_index();
 
 	ERR_FAIL_COND(data.parent);
 	ERR_FAIL_COND(data.children.size());
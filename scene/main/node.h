@@ -31,6 +31,7 @@
 #define NODE_H
 
 #include "class_db.h"
+#include "hash_map.h"
 #include "map.h"
 #include "node_path.h"
 #include "object.h"
@@ -86,6 +87,18 @@ private:
 		GroupData() { persistent = false; }
 	};
 
+	enum {
+		CHILD_INDEX_THRESHOLD = 64, // parents with fewer children just scan them
+	};
+
+	// Children by name, built the first time it's needed once there are enough children.
+	struct ChildIndex {
+
+		HashMap<StringName, Node *> nodes;
+		HashMap<String, int> serial_hints; // base names and serials below the hint are taken, see _generate_serial_child_name()
+		bool has_duplicates; // names set without validation may repeat, then the first child wins
+	};
+
 	struct Data {
 
 		String filename;
@@ -140,7 +153,10 @@ private:
 
 		bool display_folded;
 
+		bool pool_in_use; // acquired from ScenePool and not released, the pool counts it
+
 		mutable NodePath *path_cache;
+		mutable ChildIndex *child_index;
 
 	} data;
 
@@ -155,6 +171,11 @@ private:
 	Node *_get_node(const NodePath &p_path) const;
 	Node *_get_child_by_name(const StringName &p_name) const;
 
+	ChildIndex *_get_child_index() const;
+	void _child_index_add(Node *p_child);
+	void _child_index_remove(Node *p_child);
+	void _clear_child_index();
+
 	void _replace_connections_target(Node *p_new_target);
 
 	void _validate_child_name(Node *p_child, bool p_force_human_readable = false);
@@ -183,6 +204,7 @@ private:
 	Variant _rpc_unreliable_id_bind(const Variant **p_args, int p_argcount, Variant::CallError &r_error);
 
 	friend class SceneTree;
+	friend class ScenePool;
 
 	void _set_tree(SceneTree *p_tree);
 
@@ -0,0 +1,340 @@
+/*************************************************************************/
+/*  scene_pool.cpp                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "scene_pool.h"
+
+#include "message_queue.h"
+#include "scene/scene_string_names.h"
+
+ScenePool *ScenePool::singleton = NULL;
+
+ScenePool *ScenePool::get_singleton() {
+
+	return singleton;
+}
+
+ScenePool::Pool *ScenePool::_get_pool(const Ref<PackedScene> &p_scene, bool p_create) {
+
+	Pool **pool = pools.getptr(p_scene->get_instance_id());
+	if (pool)
+		return *pool;
+
+	if (!p_create)
+		return NULL;
+
+	Pool *new_pool = memnew(Pool);
+	new_pool->scene = p_scene;
+	new_pool->max_available = -1;
+	pools[p_scene->get_instance_id()] = new_pool;
+	return new_pool;
+}
+
+void ScenePool::_sweep_in_use() {
+
+	// instances freed instead of released were counted out already, their ids are only removed here
+	List<ObjectID> freed;
+
+	const ObjectID *k = NULL;
+	while ((k = in_use.next(k))) {
+		if (!ObjectDB::get_instance(*k)) {
+			freed.push_back(*k);
+		}
+	}
+
+	for (List<ObjectID>::Element *E = freed.front(); E; E = E->next()) {
+		in_use.erase(E->get());
+	}
+
+	sweep_at = MAX(64, in_use.size() * 2);
+}
+
+void ScenePool::_store(Node *p_node, Pool *p_pool) {
+
+	p_node->data.pool_in_use = false;
+	in_use_count--;
+
+	if (p_node->get_parent()) {
+		p_node->get_parent()->remove_child(p_node);
+	}
+
+	p_node->call(SceneStringNames::get_singleton()->_pool_reset);
+
+	if (p_pool->max_available >= 0 && p_pool->available.size() >= p_pool->max_available) {
+		memdelete(p_node);
+		return;
+	}
+
+	p_pool->available.push_back(p_node->get_instance_id());
+	available_count++;
+}
+
+void ScenePool::_release_deferred(ObjectID p_node) {
+
+	releasing.erase(p_node);
+
+	Pool **pool = in_use.getptr(p_node);
+	if (!pool)
+		return; // cleared meanwhile
+
+	Pool *p = *pool;
+	in_use.erase(p_node);
+
+	Node *node = Object::cast_to<Node>(ObjectDB::get_instance(p_node));
+	if (node) {
+		_store(node, p);
+	}
+}
+
+Node *ScenePool::acquire(const Ref<PackedScene> &p_scene) {
+
+	ERR_FAIL_COND_V(p_scene.is_null(), NULL);
+
+	Pool *pool = _get_pool(p_scene, true);
+	Node *node = NULL;
+
+	while (!node && pool->available.size()) {
+
+		int last = pool->available.size() - 1;
+		node = Object::cast_to<Node>(ObjectDB::get_instance(pool->available[last])); // NULL if freed by someone else
+		pool->available.resize(last);
+		available_count--;
+	}
+
+	if (node) {
+		hits++;
+	} else {
+		misses++;
+		node = p_scene->instance();
+		ERR_FAIL_COND_V(!node, NULL);
+	}
+
+	in_use[node->get_instance_id()] = pool;
+	node->data.pool_in_use = true;
+	in_use_count++;
+
+	if (in_use.size() >= sweep_at) {
+		_sweep_in_use();
+	}
+
+	return node;
+}
+
+void ScenePool::release(Node *p_node) {
+
+	ERR_FAIL_NULL(p_node);
+
+	ObjectID id = p_node->get_instance_id();
+	Pool **pool = in_use.getptr(id);
+
+	if (!pool || releasing.has(id)) {
+		ERR_EXPLAIN("Node was not acquired from the pool, or was released already: " + String(p_node->get_name()));
+		ERR_FAIL();
+	}
+
+	if (p_node->is_inside_tree()) {
+
+		// the tree may be locked (physics callbacks), so leave it at idle time like queue_free() does
+		releasing.insert(id);
+		MessageQueue::get_singleton()->push_call(this, "_release_deferred", id);
+		return;
+	}
+
+	Pool *p = *pool;
+	in_use.erase(id);
+	_store(p_node, p);
+}
+
+bool ScenePool::is_pooled(Node *p_node) const {
+
+	ERR_FAIL_NULL_V(p_node, false);
+	return in_use.has(p_node->get_instance_id());
+}
+
+void ScenePool::prefill(const Ref<PackedScene> &p_scene, int p_count) {
+
+	ERR_FAIL_COND(p_scene.is_null());
+
+	Pool *pool = _get_pool(p_scene, true);
+
+	while (pool->available.size() < p_count) {
+
+		Node *node = p_scene->instance();
+		ERR_FAIL_COND(!node);
+		pool->available.push_back(node->get_instance_id());
+		available_count++;
+	}
+}
+
+void ScenePool::set_max_available(const Ref<PackedScene> &p_scene, int p_max) {
+
+	ERR_FAIL_COND(p_scene.is_null());
+
+	Pool *pool = _get_pool(p_scene, true);
+	pool->max_available = p_max;
+
+	while (p_max >= 0 && pool->available.size() > p_max) {
+
+		int last = pool->available.size() - 1;
+		Object *obj = ObjectDB::get_instance(pool->available[last]);
+		if (obj) {
+			memdelete(obj);
+		}
+		pool->available.resize(last);
+		available_count--;
+	}
+}
+
+int ScenePool::get_max_available(const Ref<PackedScene> &p_scene) {
+
+	ERR_FAIL_COND_V(p_scene.is_null(), -1);
+
+	Pool *pool = _get_pool(p_scene, false);
+	return pool ? pool->max_available : -1;
+}
+
+int ScenePool::get_available(const Ref<PackedScene> &p_scene) {
+
+	ERR_FAIL_COND_V(p_scene.is_null(), 0);
+
+	Pool *pool = _get_pool(p_scene, false);
+	return pool ? pool->available.size() : 0;
+}
+
+void ScenePool::clear(const Ref<PackedScene> &p_scene) {
+
+	List<ObjectID> cleared;
+
+	const ObjectID *k = NULL;
+	while ((k = pools.next(k))) {
+
+		Pool *pool = pools[*k];
+		if (p_scene.is_valid() && pool->scene != p_scene)
+			continue;
+
+		for (int i = 0; i < pool->available.size(); i++) {
+
+			Object *obj = ObjectDB::get_instance(pool->available[i]);
+			if (obj) {
+				memdelete(obj);
+			}
+		}
+		available_count -= pool->available.size();
+
+		// instances in use are left to their owners
+		List<ObjectID> forget;
+		const ObjectID *n = NULL;
+		while ((n = in_use.next(n))) {
+			if (in_use[*n] == pool) {
+				forget.push_back(*n);
+			}
+		}
+		for (List<ObjectID>::Element *E = forget.front(); E; E = E->next()) {
+
+			Node *node = Object::cast_to<Node>(ObjectDB::get_instance(E->get()));
+			if (node) {
+				node->data.pool_in_use = false;
+				in_use_count--;
+			}
+
+			in_use.erase(E->get());
+			releasing.erase(E->get());
+		}
+
+		memdelete(pool);
+		cleared.push_back(*k);
+	}
+
+	for (List<ObjectID>::Element *E = cleared.front(); E; E = E->next()) {
+		pools.erase(E->get());
+	}
+}
+
+int ScenePool::get_available_count() const {
+
+	return available_count;
+}
+
+void ScenePool::_instance_freed() {
+
+	in_use_count--;
+}
+
+int ScenePool::get_in_use_count() const {
+
+	return in_use_count;
+}
+
+uint64_t ScenePool::get_hit_count() const {
+
+	return hits;
+}
+
+uint64_t ScenePool::get_miss_count() const {
+
+	return misses;
+}
+
+void ScenePool::_bind_methods() {
+
+	ClassDB::bind_method(D_METHOD("acquire", "scene"), &ScenePool::acquire);
+	ClassDB::bind_method(D_METHOD("release", "node"), &ScenePool::release);
+	ClassDB::bind_method(D_METHOD("is_pooled", "node"), &ScenePool::is_pooled);
+
+	ClassDB::bind_method(D_METHOD("prefill", "scene", "count"), &ScenePool::prefill);
+	ClassDB::bind_method(D_METHOD("set_max_available", "scene", "max"), &ScenePool::set_max_available);
+	ClassDB::bind_method(D_METHOD("get_max_available", "scene"), &ScenePool::get_max_available);
+	ClassDB::bind_method(D_METHOD("get_available", "scene"), &ScenePool::get_available);
+
+	ClassDB::bind_method(D_METHOD("clear", "scene"), &ScenePool::clear, DEFVAL(Variant()));
+
+	ClassDB::bind_method(D_METHOD("get_available_count"), &ScenePool::get_available_count);
+	ClassDB::bind_method(D_METHOD("get_in_use_count"), &ScenePool::get_in_use_count);
+	ClassDB::bind_method(D_METHOD("get_hit_count"), &ScenePool::get_hit_count);
+	ClassDB::bind_method(D_METHOD("get_miss_count"), &ScenePool::get_miss_count);
+
+	ClassDB::bind_method(D_METHOD("_release_deferred"), &ScenePool::_release_deferred);
+}
+
+ScenePool::ScenePool() {
+
+	singleton = this;
+
+	sweep_at = 64;
+	available_count = 0;
+	in_use_count = 0;
+	hits = 0;
+	misses = 0;
+}
+
+ScenePool::~ScenePool() {
+
+	clear();
+
+	singleton = NULL;
+}
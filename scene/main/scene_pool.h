@@ -0,0 +1,96 @@
+/*************************************************************************/
+/*  scene_pool.h                                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef SCENE_POOL_H
+#define SCENE_POOL_H
+
+#include "hash_map.h"
+#include "set.h"
+#include "scene/resources/packed_scene.h"
+
+// Keeps instances of scenes that are spawned and freed often (projectiles,
+// pickups, effects) out of the tree, ready to be handed out again.
+class ScenePool : public Object {
+
+	GDCLASS(ScenePool, Object);
+
+	static ScenePool *singleton;
+
+	struct Pool {
+
+		Ref<PackedScene> scene;
+		Vector<ObjectID> available;
+		int max_available;
+	};
+
+	HashMap<ObjectID, Pool *> pools; // by scene
+	HashMap<ObjectID, Pool *> in_use; // by node, until released
+	Set<ObjectID> releasing; // waiting for idle time to leave the tree
+	uint32_t sweep_at;
+
+	int available_count;
+	int in_use_count; // in_use may still have instances that were freed, until the next sweep
+	uint64_t hits;
+	uint64_t misses;
+
+	Pool *_get_pool(const Ref<PackedScene> &p_scene, bool p_create);
+	void _sweep_in_use();
+	void _release_deferred(ObjectID p_node);
+	void _store(Node *p_node, Pool *p_pool);
+
+	friend class Node;
+	void _instance_freed();
+
+protected:
+	static void _bind_methods();
+
+public:
+	static ScenePool *get_singleton();
+
+	Node *acquire(const Ref<PackedScene> &p_scene);
+	void release(Node *p_node);
+	bool is_pooled(Node *p_node) const;
+
+	void prefill(const Ref<PackedScene> &p_scene, int p_count);
+	void set_max_available(const Ref<PackedScene> &p_scene, int p_max);
+	int get_max_available(const Ref<PackedScene> &p_scene);
+	int get_available(const Ref<PackedScene> &p_scene);
+
+	void clear(const Ref<PackedScene> &p_scene = Ref<PackedScene>());
+
+	int get_available_count() const;
+	int get_in_use_count() const;
+	uint64_t get_hit_count() const;
+	uint64_t get_miss_count() const;
+
+	ScenePool();
+	~ScenePool();
+};
+
+#endif // SCENE_POOL_H
@@ -38,6 +38,7 @@
 #include "os/os.h"
 #include "print_string.h"
 #include "project_settings.h"
+#include "scene/main/scene_pool.h"
 #include "scene/resources/dynamic_font.h"
 #include "scene/resources/material.h"
 #include "scene/resources/mesh.h"
@@ -453,7 +454,7 @@ bool SceneTree::iteration(float p_time) {
 	MainLoop::iteration(p_time);
 	physics_process_time = p_time;
 
-	emit_signal("physics_frame");
+	emit_signal(SNAME("physics_frame"));
 
 	_notify_group_pause("physics_process_internal", Node::NOTIFICATION_INTERNAL_PHYSICS_PROCESS);
 	_notify_group_pause("physics_process", Node::NOTIFICATION_PHYSICS_PROCESS);
@@ -483,7 +484,7 @@ bool SceneTree::idle(float p_time) {
 
 	_network_poll();
 
-	emit_signal("idle_frame");
+	emit_signal(SNAME("idle_frame"));
 
 	MessageQueue::get_singleton()->flush(); //small little hack
 
@@ -529,7 +530,7 @@ bool SceneTree::idle(float p_time) {
 		E->get()->set_time_left(time_left);
 
 		if (time_left < 0) {
-			E->get()->emit_signal("timeout");
+			E->get()->emit_signal(SNAME("timeout"));
 			timers.erase(E);
 		}
 		E = N;
@@ -582,6 +583,11 @@ void SceneTree::finish() {
 		root->_set_tree(NULL);
 		memdelete(root); //delete root
 	}
+
+	// pooled instances may hold scripts, which go away with the tree
+	if (ScenePool::get_singleton()) {
+		ScenePool::get_singleton()->clear();
+	}
 }
 
 void SceneTree::quit() {
@@ -1770,56 +1776,53 @@ void SceneTree::_rpc(Node *p_from, int p_to, bool p_unreliable, bool p_set, cons
 		psc->id = last_send_cache_id++;
 	}
 
-	//create base packet, lots of harcode because it must be tight
-
-	int ofs = 0;
-
-#define MAKE_ROOM(m_amount) \
-	if (packet_cache.size() < m_amount) packet_cache.resize(m_amount);
+	//see if the method or property name is cached for this node, ids are sent in 16 bits
+	NameSentCache *nsc = psc->names.getptr(p_name);
+	if (!nsc && psc->names.size() <= 0xFFFF) {
+		int name_id = psc->names.size();
+		psc->names[p_name] = NameSentCache();
+		nsc = psc->names.getptr(p_name);
+		nsc->id = name_id;
+	}
 
-	//encode type
-	MAKE_ROOM(1);
-	packet_cache[0] = p_set ? NETWORK_COMMAND_REMOTE_SET : NETWORK_COMMAND_REMOTE_CALL;
-	ofs += 1;
+	//encode arguments, they are the same in every packet sent
 
-	//encode ID
-	MAKE_ROOM(ofs + 4);
-	encode_uint32(psc->id, &packet_cache[ofs]);
-	ofs += 4;
+	int args_len = 0;
 
-	//encode function name
-	CharString name = String(p_name).utf8();
-	int len = encode_cstring(name.get_data(), NULL);
-	MAKE_ROOM(ofs + len);
-	encode_cstring(name.get_data(), &packet_cache[ofs]);
-	ofs += len;
+#define MAKE_ARGS_ROOM(m_amount) \
+	if (rpc_args_cache.size() < m_amount) rpc_args_cache.resize(m_amount);
 
 	if (p_set) {
 		//set argument
-		Error err = encode_variant(*p_arg[0], NULL, len);
+		int len;
+		Error err = encode_variant_compact(*p_arg[0], NULL, len);
 		ERR_FAIL_COND(err != OK);
-		MAKE_ROOM(ofs + len);
-		encode_variant(*p_arg[0], &packet_cache[ofs], len);
-		ofs += len;
+		MAKE_ARGS_ROOM(args_len + len);
+		encode_variant_compact(*p_arg[0], &rpc_args_cache[args_len], len);
+		args_len += len;
 
 	} else {
 		//call arguments
-		MAKE_ROOM(ofs + 1);
-		packet_cache[ofs] = p_argcount;
-		ofs += 1;
+		MAKE_ARGS_ROOM(args_len + 1);
+		rpc_args_cache[args_len] = p_argcount;
+		args_len += 1;
 		for (int i = 0; i < p_argcount; i++) {
-			Error err = encode_variant(*p_arg[i], NULL, len);
+			int len;
+			Error err = encode_variant_compact(*p_arg[i], NULL, len);
 			ERR_FAIL_COND(err != OK);
-			MAKE_ROOM(ofs + len);
-			encode_variant(*p_arg[i], &packet_cache[ofs], len);
-			ofs += len;
+			MAKE_ARGS_ROOM(args_len + len);
+			encode_variant_compact(*p_arg[i], &rpc_args_cache[args_len], len);
+			args_len += len;
 		}
 	}
 
-	//see if all peers have cached path (is so, call can be fast)
+#undef MAKE_ARGS_ROOM
+
+	//see if all peers have cached path and name (is so, call can be fast)
 	bool has_all_peers = true;
 
 	List<int> peers_to_add; //if one is missing, take note to add it
+	List<int> names_to_add;
 
 	for (Set<int>::Element *E = connected_peers.front(); E; E = E->next()) {
 
@@ -1840,6 +1843,20 @@ void SceneTree::_rpc(Node *p_from, int p_to, bool p_unreliable, bool p_set, cons
 
 			has_all_peers = false;
 		}
+
+		if (nsc) {
+
+			Map<int, bool>::Element *G = nsc->confirmed_peers.find(E->get());
+
+			if (!G || G->get() == false) {
+				//same for the name, it can only be sent once the path is
+				if (!G) {
+					names_to_add.push_back(E->get());
+				}
+
+				has_all_peers = false;
+			}
+		}
 	}
 
 	//those that need to be added, send a message for this
@@ -1864,22 +1881,41 @@ void SceneTree::_rpc(Node *p_from, int p_to, bool p_unreliable, bool p_set, cons
 		psc->confirmed_peers.insert(E->get(), false); //insert into confirmed, but as false since it was not confirmed
 	}
 
+	CharString name = String(p_name).utf8();
+
+	for (List<int>::Element *E = names_to_add.front(); E; E = E->next()) {
+
+		//reliable packets arrive in order, so the path is known by then
+		int len = encode_cstring(name.get_data(), NULL);
+
+		Vector<uint8_t> packet;
+
+		packet.resize(1 + 4 + 2 + len);
+		packet[0] = NETWORK_COMMAND_SIMPLIFY_NAME;
+		encode_uint32(psc->id, &packet[1]);
+		encode_uint16(nsc->id, &packet[5]);
+		encode_cstring(name.get_data(), &packet[7]);
+
+		network_peer->set_target_peer(E->get());
+		network_peer->set_transfer_mode(NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE);
+		network_peer->put_packet(packet.ptr(), packet.size());
+
+		nsc->confirmed_peers.insert(E->get(), false);
+	}
+
 	//take chance and set transfer mode, since all send methods will use it
 	network_peer->set_transfer_mode(p_unreliable ? NetworkedMultiplayerPeer::TRANSFER_MODE_UNRELIABLE : NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE);
 
 	if (has_all_peers) {
 
-		//they all have verified paths, so send fast
+		//they all have verified paths and names, so send fast
+		int len = _make_rpc_packet(p_set, psc->id, CharString(), nsc ? nsc->id : -1, name, args_len);
 		network_peer->set_target_peer(p_to); //to all of you
-		network_peer->put_packet(packet_cache.ptr(), ofs); //a message with love
+		network_peer->put_packet(packet_cache.ptr(), len); //a message with love
 	} else {
 		//not all verified path, so send one by one
 
-		//apend path at the end, since we will need it for some packets
 		CharString pname = String(from_path).utf8();
-		int path_len = encode_cstring(pname.get_data(), NULL);
-		MAKE_ROOM(ofs + path_len);
-		encode_cstring(pname.get_data(), &packet_cache[ofs]);
 
 		for (Set<int>::Element *E = connected_peers.front(); E; E = E->next()) {
 
@@ -1892,45 +1928,122 @@ void SceneTree::_rpc(Node *p_from, int p_to, bool p_unreliable, bool p_set, cons
 			Map<int, bool>::Element *F = psc->confirmed_peers.find(E->get());
 			ERR_CONTINUE(!F); //should never happen
 
+			//names are looked up along with the cached path, so they need it too
+			bool path_confirmed = F->get();
+			bool name_confirmed = false;
+			if (path_confirmed && nsc) {
+				Map<int, bool>::Element *G = nsc->confirmed_peers.find(E->get());
+				name_confirmed = G && G->get();
+			}
+
+			//use entire path if this one did not confirm it yet (sorry!)
+			int len = _make_rpc_packet(p_set, path_confirmed ? psc->id : -1, pname, name_confirmed ? nsc->id : -1, name, args_len);
+
 			network_peer->set_target_peer(E->get()); //to this one specifically
+			network_peer->put_packet(packet_cache.ptr(), len);
+		}
+	}
+}
 
-			if (F->get() == true) {
-				//this one confirmed path, so use id
-				encode_uint32(psc->id, &packet_cache[1]);
-				network_peer->put_packet(packet_cache.ptr(), ofs);
-			} else {
-				//this one did not confirm path yet, so use entire path (sorry!)
-				encode_uint32(0x80000000 | ofs, &packet_cache[1]); //offset to path and flag
-				network_peer->put_packet(packet_cache.ptr(), ofs + path_len);
-			}
+int SceneTree::_make_rpc_packet(bool p_set, int p_path_id, const CharString &p_path, int p_name_id, const CharString &p_name, int p_args_len) {
+
+	//create base packet, lots of harcode because it must be tight
+
+	int ofs = 0;
+
+#define MAKE_ROOM(m_amount) \
+	if (packet_cache.size() < m_amount) packet_cache.resize(m_amount);
+
+	//encode type, flags are added as the rest is encoded
+	uint8_t command = p_set ? NETWORK_COMMAND_REMOTE_SET : NETWORK_COMMAND_REMOTE_CALL;
+	MAKE_ROOM(1);
+	ofs += 1;
+
+	//encode ID
+	int path_ofs_pos = -1;
+	if (p_path_id >= 0 && p_path_id <= 0xFFFF) {
+		command |= NETWORK_FLAG_SHORT_PATH_ID;
+		MAKE_ROOM(ofs + 2);
+		encode_uint16(p_path_id, &packet_cache[ofs]);
+		ofs += 2;
+	} else {
+		MAKE_ROOM(ofs + 4);
+		if (p_path_id >= 0) {
+			encode_uint32(p_path_id, &packet_cache[ofs]);
+		} else {
+			path_ofs_pos = ofs; //offset to path and flag, known at the end
 		}
+		ofs += 4;
 	}
+
+	//encode function name
+	if (p_name_id >= 0) {
+		command |= NETWORK_FLAG_NAME_ID;
+		MAKE_ROOM(ofs + 2);
+		encode_uint16(p_name_id, &packet_cache[ofs]);
+		ofs += 2;
+	} else {
+		int len = encode_cstring(p_name.get_data(), NULL);
+		MAKE_ROOM(ofs + len);
+		encode_cstring(p_name.get_data(), &packet_cache[ofs]);
+		ofs += len;
+	}
+
+	//arguments
+	MAKE_ROOM(ofs + p_args_len);
+	copymem(&packet_cache[ofs], rpc_args_cache.ptr(), p_args_len);
+	ofs += p_args_len;
+
+	//apend path at the end if it's not cached
+	if (path_ofs_pos >= 0) {
+		encode_uint32(0x80000000 | ofs, &packet_cache[path_ofs_pos]);
+		int len = encode_cstring(p_path.get_data(), NULL);
+		MAKE_ROOM(ofs + len);
+		encode_cstring(p_path.get_data(), &packet_cache[ofs]);
+		ofs += len;
+	}
+
+#undef MAKE_ROOM
+
+	packet_cache[0] = command;
+
+	return ofs;
 }
 
 void SceneTree::_network_process_packet(int p_from, const uint8_t *p_packet, int p_packet_len) {
 
 	ERR_FAIL_COND(p_packet_len < 5);
 
-	uint8_t packet_type = p_packet[0];
+	uint8_t packet_type = p_packet[0] & NETWORK_COMMAND_MASK;
+	uint8_t packet_flags = p_packet[0] & ~NETWORK_COMMAND_MASK;
 
 	switch (packet_type) {
 
 		case NETWORK_COMMAND_REMOTE_CALL:
 		case NETWORK_COMMAND_REMOTE_SET: {
 
-			ERR_FAIL_COND(p_packet_len < 5);
-			uint32_t target = decode_uint32(&p_packet[1]);
+			int ofs = 1;
+			uint32_t target;
+
+			if (packet_flags & NETWORK_FLAG_SHORT_PATH_ID) {
+				target = decode_uint16(&p_packet[ofs]);
+				ofs += 2;
+			} else {
+				target = decode_uint32(&p_packet[ofs]);
+				ofs += 4;
+			}
 
 			Node *node = NULL;
+			PathGetCache::NodeInfo *ni = NULL;
 
 			if (target & 0x80000000) {
 				//use full path (not cached yet)
 
-				int ofs = target & 0x7FFFFFFF;
-				ERR_FAIL_COND(ofs >= p_packet_len);
+				int path_ofs = target & 0x7FFFFFFF;
+				ERR_FAIL_COND(path_ofs >= p_packet_len);
 
 				String paths;
-				paths.parse_utf8((const char *)&p_packet[ofs], p_packet_len - ofs);
+				paths.parse_utf8((const char *)&p_packet[path_ofs], p_packet_len - path_ofs);
 
 				NodePath np = paths;
 
@@ -1949,7 +2062,7 @@ void SceneTree::_network_process_packet(int p_from, const uint8_t *p_packet, int
 				Map<int, PathGetCache::NodeInfo>::Element *F = E->get().nodes.find(id);
 				ERR_FAIL_COND(!F);
 
-				PathGetCache::NodeInfo *ni = &F->get();
+				ni = &F->get();
 				//do proper caching later
 
 				node = get_root()->get_node(ni->path);
@@ -1959,27 +2072,41 @@ void SceneTree::_network_process_packet(int p_from, const uint8_t *p_packet, int
 				}
 			}
 
-			ERR_FAIL_COND(p_packet_len < 6);
+			StringName name;
 
-			//detect cstring end
-			int len_end = 5;
-			for (; len_end < p_packet_len; len_end++) {
-				if (p_packet[len_end] == 0) {
-					break;
+			if (packet_flags & NETWORK_FLAG_NAME_ID) {
+				//use cached name, they are only sent along with cached paths
+				ERR_FAIL_COND(!ni);
+				ERR_FAIL_COND(p_packet_len < ofs + 2);
+
+				Map<int, StringName>::Element *N = ni->names.find(decode_uint16(&p_packet[ofs]));
+				ERR_FAIL_COND(!N);
+
+				name = N->get();
+				ofs += 2;
+			} else {
+
+				ERR_FAIL_COND(p_packet_len < ofs + 1);
+
+				//detect cstring end
+				int len_end = ofs;
+				for (; len_end < p_packet_len; len_end++) {
+					if (p_packet[len_end] == 0) {
+						break;
+					}
 				}
-			}
 
-			ERR_FAIL_COND(len_end >= p_packet_len);
+				ERR_FAIL_COND(len_end >= p_packet_len);
 
-			StringName name = String::utf8((const char *)&p_packet[5]);
+				name = String::utf8((const char *)&p_packet[ofs]);
+				ofs = len_end + 1;
+			}
 
 			if (packet_type == NETWORK_COMMAND_REMOTE_CALL) {
 
 				if (!node->can_call_rpc(name, p_from))
 					return;
 
-				int ofs = len_end + 1;
-
 				ERR_FAIL_COND(ofs >= p_packet_len);
 
 				int argc = p_packet[ofs];
@@ -1994,7 +2121,7 @@ void SceneTree::_network_process_packet(int p_from, const uint8_t *p_packet, int
 
 					ERR_FAIL_COND(ofs >= p_packet_len);
 					int vlen;
-					Error err = decode_variant(args[i], &p_packet[ofs], p_packet_len - ofs, &vlen);
+					Error err = decode_variant_compact(args[i], &p_packet[ofs], p_packet_len - ofs, &vlen);
 					ERR_FAIL_COND(err != OK);
 					//args[i]=p_packet[3+i];
 					argp[i] = &args[i];
@@ -2015,12 +2142,11 @@ void SceneTree::_network_process_packet(int p_from, const uint8_t *p_packet, int
 				if (!node->can_call_rset(name, p_from))
 					return;
 
-				int ofs = len_end + 1;
-
 				ERR_FAIL_COND(ofs >= p_packet_len);
 
 				Variant value;
-				decode_variant(value, &p_packet[ofs], p_packet_len - ofs);
+				Error err = decode_variant_compact(value, &p_packet[ofs], p_packet_len - ofs);
+				ERR_FAIL_COND(err != OK);
 
 				bool valid;
 
@@ -2084,6 +2210,68 @@ void SceneTree::_network_process_packet(int p_from, const uint8_t *p_packet, int
 			ERR_FAIL_COND(!E);
 			E->get() = true;
 		} break;
+		case NETWORK_COMMAND_SIMPLIFY_NAME: {
+
+			ERR_FAIL_COND(p_packet_len < 8);
+			int id = decode_uint32(&p_packet[1]);
+			int name_id = decode_uint16(&p_packet[5]);
+
+			String names;
+			names.parse_utf8((const char *)&p_packet[7], p_packet_len - 7);
+
+			Map<int, PathGetCache>::Element *E = path_get_cache.find(p_from);
+			ERR_FAIL_COND(!E);
+
+			Map<int, PathGetCache::NodeInfo>::Element *F = E->get().nodes.find(id);
+			ERR_FAIL_COND(!F);
+
+			F->get().names[name_id] = names;
+
+			{
+				//send ack
+
+				//encode path
+				CharString pname = String(F->get().path).utf8();
+				int len = encode_cstring(pname.get_data(), NULL);
+
+				Vector<uint8_t> packet;
+
+				packet.resize(1 + 2 + len);
+				packet[0] = NETWORK_COMMAND_CONFIRM_NAME;
+				encode_uint16(name_id, &packet[1]);
+				encode_cstring(pname.get_data(), &packet[3]);
+
+				network_peer->set_transfer_mode(NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE);
+				network_peer->set_target_peer(p_from);
+				network_peer->put_packet(packet.ptr(), packet.size());
+			}
+		} break;
+		case NETWORK_COMMAND_CONFIRM_NAME: {
+
+			int name_id = decode_uint16(&p_packet[1]);
+
+			String paths;
+			paths.parse_utf8((const char *)&p_packet[3], p_packet_len - 3);
+
+			NodePath path = paths;
+
+			PathSentCache *psc = path_send_cache.getptr(path);
+			ERR_FAIL_COND(!psc);
+
+			NameSentCache *nsc = NULL;
+			for (const StringName *K = psc->names.next(NULL); K; K = psc->names.next(K)) {
+				NameSentCache *N = psc->names.getptr(*K);
+				if (N->id == name_id) {
+					nsc = N;
+					break;
+				}
+			}
+			ERR_FAIL_COND(!nsc);
+
+			Map<int, bool>::Element *E = nsc->confirmed_peers.find(p_from);
+			ERR_FAIL_COND(!E);
+			E->get() = true;
+		} break;
 	}
 }
 
@@ -189,6 +189,15 @@ private:
 		NETWORK_COMMAND_REMOTE_SET,
 		NETWORK_COMMAND_SIMPLIFY_PATH,
 		NETWORK_COMMAND_CONFIRM_PATH,
+		NETWORK_COMMAND_SIMPLIFY_NAME,
+		NETWORK_COMMAND_CONFIRM_NAME,
+	};
+
+	//flags in the command byte of remote calls and sets
+	enum NetworkCommandFlags {
+		NETWORK_COMMAND_MASK = 0x0F,
+		NETWORK_FLAG_SHORT_PATH_ID = 0x40, // cached path id sent in 16 bits
+		NETWORK_FLAG_NAME_ID = 0x80, // method or property sent as an id cached per node
 	};
 
 	Ref<NetworkedMultiplayerPeer> network_peer;
@@ -204,9 +213,15 @@ private:
 	int rpc_sender_id;
 
 	//path sent caches
+	struct NameSentCache {
+		Map<int, bool> confirmed_peers;
+		int id;
+	};
+
 	struct PathSentCache {
 		Map<int, bool> confirmed_peers;
 		int id;
+		HashMap<StringName, NameSentCache, StringNameHasher> names; //methods and properties of the node
 	};
 
 	HashMap<NodePath, PathSentCache> path_send_cache;
@@ -217,6 +232,7 @@ private:
 		struct NodeInfo {
 			NodePath path;
 			ObjectID instance;
+			Map<int, StringName> names;
 		};
 
 		Map<int, NodeInfo> nodes;
@@ -225,6 +241,9 @@ private:
 	Map<int, PathGetCache> path_get_cache;
 
 	Vector<uint8_t> packet_cache;
+	Vector<uint8_t> rpc_args_cache;
+
+	int _make_rpc_packet(bool p_set, int p_path_id, const CharString &p_path, int p_name_id, const CharString &p_name, int p_args_len);
 
 	void _network_process_packet(int p_from, const uint8_t *p_packet, int p_packet_len);
 	void _network_poll();
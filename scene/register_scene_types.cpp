@@ -111,6 +111,7 @@
 #include "scene/main/http_request.h"
 #include "scene/main/instance_placeholder.h"
 #include "scene/main/resource_preloader.h"
+#include "scene/main/scene_pool.h"
 #include "scene/main/scene_tree.h"
 #include "scene/main/timer.h"
 #include "scene/main/viewport.h"
@@ -203,6 +204,8 @@ static ResourceFormatLoaderStreamTexture *resource_loader_stream_texture = NULL;
 static ResourceFormatSaverShader *resource_saver_shader = NULL;
 static ResourceFormatLoaderShader *resource_loader_shader = NULL;
 
+static ScenePool *scene_pool = NULL;
+
 void register_scene_types() {
 
 	SceneStringNames::create();
@@ -581,6 +584,10 @@ void register_scene_types() {
 	ClassDB::register_class<SceneTree>();
 	ClassDB::register_virtual_class<SceneTreeTimer>(); //sorry, you can't create it
 
+	ClassDB::register_virtual_class<ScenePool>();
+	scene_pool = memnew(ScenePool);
+	Engine::get_singleton()->add_singleton(Engine::Singleton("ScenePool", scene_pool));
+
 #ifndef DISABLE_DEPRECATED
 	ClassDB::add_compatibility_class("ImageSkyBox", "PanoramaSky");
 	ClassDB::add_compatibility_class("FixedSpatialMaterial", "SpatialMaterial");
@@ -630,6 +637,8 @@ void register_scene_types() {
 
 void unregister_scene_types() {
 
+	memdelete(scene_pool);
+
 	clear_default_theme();
 
 	memdelete(resource_loader_dynamic_font);
@@ -84,6 +84,8 @@ public:
 	void set_instance_color(int p_instance, const Color &p_color);
 	Color get_instance_color(int p_instance) const;
 
+	void set_as_bulk_array(const PoolVector<float> &p_array);
+
 	virtual AABB get_aabb() const;
 
 	virtual RID get_rid() const;
@@ -78,6 +78,9 @@ Node *SceneState::instance(GenEditState p_edit_state) const {
 
 	Node **ret_nodes = (Node **)alloca(sizeof(Node *) * nc);
 
+	// editor instances go the slow way, they are few and the state changes often
+	const InstancePlan *plan = p_edit_state == GEN_EDIT_STATE_DISABLED ? _get_instance_plan() : NULL;
+
 	bool gen_node_path_cache = p_edit_state != GEN_EDIT_STATE_DISABLED && node_path_cache.empty();
 
 	Map<Ref<Resource>, Ref<Resource> > resources_local_to_scene;
@@ -149,6 +152,10 @@ Node *SceneState::instance(GenEditState p_edit_state) const {
 				}
 #endif
 			}
+		} else if (plan && plan->nodes[i].creation_func) {
+			//created, with the class already looked up
+			node = Object::cast_to<Node>(plan->nodes[i].creation_func());
+
 		} else if (ClassDB::is_class_enabled(snames[n.type])) {
 			//print_line("created");
 			//node belongs to this scene and must be created
@@ -191,6 +198,11 @@ Node *SceneState::instance(GenEditState p_edit_state) const {
 
 				const NodeData::Property *nprops = &n.properties[0];
 
+				const InstancePlan::PropertyPlan *pprops = NULL;
+				if (plan && plan->nodes[i].creation_func) {
+					pprops = &plan->properties[plan->nodes[i].property_from];
+				}
+
 				for (int j = 0; j < nprop_count; j++) {
 
 					bool valid;
@@ -251,7 +263,24 @@ Node *SceneState::instance(GenEditState p_edit_state) const {
 								}
 							}
 						}
-						node->set(snames[nprops[j].name], value, &valid);
+
+						if (pprops && pprops[j].setter && !node->get_script_instance()) {
+							//same setter Object::set() would find, without looking it up
+							Variant::CallError ce;
+							if (pprops[j].index >= 0) {
+								Variant index = pprops[j].index;
+								const Variant *args[2] = { &index, &value };
+								pprops[j].setter->call(node, args, 2, ce);
+							} else {
+								const Variant *args[1] = { &value };
+								pprops[j].setter->call(node, args, 1, ce);
+							}
+#ifdef TOOLS_ENABLED
+							node->set_edited(true);
+#endif
+						} else {
+							node->set(snames[nprops[j].name], value, &valid);
+						}
 					}
 				}
 			}
@@ -906,6 +935,7 @@ String SceneState::get_path() const {
 
 void SceneState::clear() {
 
+	_clear_instance_plan();
 	names.clear();
 	variants.clear();
 	nodes.clear();
@@ -1026,6 +1056,79 @@ void SceneState::set_disable_placeholders(bool p_disable) {
 	disable_placeholders = p_disable;
 }
 
+bool SceneState::disable_instance_plans = false;
+
+void SceneState::set_disable_instance_plans(bool p_disable) {
+
+	disable_instance_plans = p_disable;
+}
+
+const SceneState::InstancePlan *SceneState::_get_instance_plan() const {
+
+	if (disable_instance_plans)
+		return NULL;
+
+	_THREAD_SAFE_METHOD_
+
+	if (instance_plan)
+		return instance_plan;
+
+	InstancePlan *plan = memnew(InstancePlan);
+	plan->nodes.resize(nodes.size());
+
+	for (int i = 0; i < nodes.size(); i++) {
+
+		const NodeData &n = nodes[i];
+		InstancePlan::NodePlan &np = plan->nodes[i];
+		np.creation_func = NULL;
+		np.property_from = plan->properties.size();
+
+		if ((i == 0 && base_scene_idx >= 0) || n.instance >= 0 || n.type == TYPE_INSTANCED)
+			continue; // comes from another scene, its class is known only once instanced
+
+		if (n.type < 0 || n.type >= names.size() || !ClassDB::is_class_enabled(names[n.type]))
+			continue;
+
+		const ClassDB::ClassInfo *ti = ClassDB::get_instantiable_class(names[n.type]);
+		if (!ti || !ClassDB::is_parent_class(ti->name, "Node"))
+			continue; // instance() warns and puts something else instead
+
+		np.creation_func = ti->creation_func;
+
+		for (int j = 0; j < n.properties.size(); j++) {
+
+			InstancePlan::PropertyPlan pp;
+			pp.setter = NULL;
+			pp.index = -1;
+
+			int name = n.properties[j].name;
+			if (name >= 0 && name < names.size()) {
+
+				const ClassDB::PropertySetGet *psg = ClassDB::get_property_setget(ti->name, names[name]);
+				if (psg && psg->_setptr) {
+					pp.setter = psg->_setptr;
+					pp.index = psg->index;
+				}
+			}
+
+			plan->properties.push_back(pp);
+		}
+	}
+
+	instance_plan = plan;
+	return plan;
+}
+
+void SceneState::_clear_instance_plan() {
+
+	_THREAD_SAFE_METHOD_
+
+	if (instance_plan) {
+		memdelete(instance_plan);
+		instance_plan = NULL;
+	}
+}
+
 bool SceneState::is_connection(int p_node, const StringName &p_signal, int p_to_node, const StringName &p_to_method) const {
 
 	ERR_FAIL_COND_V(p_node < 0, false);
@@ -1082,6 +1185,8 @@ void SceneState::set_bundled_scene(const Dictionary &p_dictionary) {
 		ERR_FAIL();
 	}
 
+	_clear_instance_plan();
+
 	PoolVector<String> snames = p_dictionary["names"];
 	if (snames.size()) {
 
@@ -1541,6 +1646,8 @@ int SceneState::add_node_path(const NodePath &p_path) {
 }
 int SceneState::add_node(int p_parent, int p_owner, int p_type, int p_name, int p_instance, int p_index) {
 
+	_clear_instance_plan();
+
 	NodeData nd;
 	nd.parent = p_parent;
 	nd.owner = p_owner;
@@ -1559,6 +1666,8 @@ void SceneState::add_node_property(int p_node, int p_name, int p_value) {
 	ERR_FAIL_INDEX(p_name, names.size());
 	ERR_FAIL_INDEX(p_value, variants.size());
 
+	_clear_instance_plan();
+
 	NodeData::Property prop;
 	prop.name = p_name;
 	prop.value = p_value;
@@ -1573,6 +1682,7 @@ void SceneState::add_node_group(int p_node, int p_group) {
 void SceneState::set_base_scene(int p_idx) {
 
 	ERR_FAIL_INDEX(p_idx, variants.size());
+	_clear_instance_plan();
 	base_scene_idx = p_idx;
 }
 void SceneState::add_connection(int p_from, int p_to, int p_signal, int p_method, int p_flags, const Vector<int> &p_binds) {
@@ -1642,6 +1752,12 @@ SceneState::SceneState() {
 
 	base_scene_idx = -1;
 	last_modified_time = 0;
+	instance_plan = NULL;
+}
+
+SceneState::~SceneState() {
+
+	_clear_instance_plan();
 }
 
 ////////////////
@@ -30,12 +30,14 @@
 #ifndef PACKED_SCENE_H
 #define PACKED_SCENE_H
 
+#include "os/thread_safe.h"
 #include "resource.h"
 #include "scene/main/node.h"
 
 class SceneState : public Reference {
 
 	GDCLASS(SceneState, Reference);
+	_THREAD_SAFE_CLASS_
 
 	Vector<StringName> names;
 	Vector<Variant> variants;
@@ -91,6 +93,32 @@ class SceneState : public Reference {
 
 	Vector<ConnectionData> connections;
 
+	// What instance() would look up by name for the nodes it creates, resolved
+	// on first use and kept until the state changes.
+	struct InstancePlan {
+
+		struct NodePlan {
+
+			Object *(*creation_func)(); // NULL if the node is not created from its type
+			int property_from;
+		};
+
+		struct PropertyPlan {
+
+			MethodBind *setter; // NULL if the property must go through Object::set()
+			int index;
+		};
+
+		Vector<NodePlan> nodes;
+		Vector<PropertyPlan> properties;
+	};
+
+	mutable InstancePlan *instance_plan;
+	static bool disable_instance_plans;
+
+	const InstancePlan *_get_instance_plan() const;
+	void _clear_instance_plan();
+
 	Error _parse_node(Node *p_owner, Node *p_node, int p_parent_idx, Map<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, Map<Node *, int> &node_map, Map<Node *, int> &nodepath_map);
 	Error _parse_connections(Node *p_owner, Node *p_node, Map<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, Map<Node *, int> &node_map, Map<Node *, int> &nodepath_map);
 
@@ -124,6 +152,7 @@ public:
 	};
 
 	static void set_disable_placeholders(bool p_disable);
+	static void set_disable_instance_plans(bool p_disable);
 
 	int find_node_by_path(const NodePath &p_node) const;
 	Variant get_property_value(int p_node, const StringName &p_property, bool &found) const;
@@ -189,6 +218,7 @@ public:
 	uint64_t get_last_modified_time() const { return last_modified_time; }
 
 	SceneState();
+	~SceneState();
 };
 
 VARIANT_ENUM_CAST(SceneState::GenEditState)
@@ -184,6 +184,8 @@ SceneStringNames::SceneStringNames() {
 
 	node_configuration_warning_changed = StaticCString::create("node_configuration_warning_changed");
 
+	_pool_reset = StaticCString::create("_pool_reset");
+
 	path_pp = NodePath("..");
 
 	_default = StaticCString::create("default");
@@ -196,6 +196,8 @@ public:
 
 	StringName node_configuration_warning_changed;
 
+	StringName _pool_reset;
+
 	enum {
 		MAX_MATERIALS = 32
 	};
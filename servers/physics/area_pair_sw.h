@@ -45,6 +45,7 @@ class AreaPairSW : public ConstraintSW {
 public:
 	bool setup(real_t p_step);
 	void solve(real_t p_step);
+	bool can_setup_in_parallel() const { return false; } // areas track bodies for all islands
 
 	AreaPairSW(BodySW *p_body, int p_body_shape, AreaSW *p_area, int p_area_shape);
 	~AreaPairSW();
@@ -61,6 +62,7 @@ class Area2PairSW : public ConstraintSW {
 public:
 	bool setup(real_t p_step);
 	void solve(real_t p_step);
+	bool can_setup_in_parallel() const { return false; } // areas track bodies for all islands
 
 	Area2PairSW(AreaSW *p_area_a, int p_shape_a, AreaSW *p_area_b, int p_shape_b);
 	~Area2PairSW();
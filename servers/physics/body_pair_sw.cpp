@@ -464,6 +464,20 @@ void BodyPairSW::solve(real_t p_step) {
 	}
 }
 
+bool BodyPairSW::can_setup_in_parallel() const {
+
+	if (space->is_debugging_contacts())
+		return false;
+
+	// static and kinematic bodies belong to no island, so contacts reported to them are shared
+	if (A->get_mode() <= PhysicsServer::BODY_MODE_KINEMATIC && A->can_report_contacts())
+		return false;
+	if (B->get_mode() <= PhysicsServer::BODY_MODE_KINEMATIC && B->can_report_contacts())
+		return false;
+
+	return true;
+}
+
 BodyPairSW::BodyPairSW(BodySW *p_A, int p_shape_A, BodySW *p_B, int p_shape_B) :
 		ConstraintSW(_arr, 2) {
 
@@ -556,21 +556,28 @@ void BodySW::integrate_forces(real_t p_step) {
 	biased_linear_velocity = Vector3();
 
 	if (do_motion) { //shapes temporarily extend for raycast
-		_update_shapes_with_motion(motion);
+		pending_motion = motion;
+		pending_motion_update = true;
 	}
 
 	def_area = NULL; // clear the area, so it is set in the next frame
 	contact_count = 0;
 }
 
+void BodySW::commit_forces() {
+
+	if (!pending_motion_update)
+		return;
+
+	_update_shapes_with_motion(pending_motion);
+	pending_motion_update = false;
+}
+
 void BodySW::integrate_velocities(real_t p_step) {
 
 	if (mode == PhysicsServer::BODY_MODE_STATIC)
 		return;
 
-	if (fi_callback)
-		get_space()->body_add_to_state_query_list(&direct_state_query_list);
-
 	//apply axis lock linear
 	for (int i = 0; i < 3; i++) {
 		if (is_axis_locked((PhysicsServer::BodyAxis)(1 << i))) {
@@ -592,7 +599,7 @@ void BodySW::integrate_velocities(real_t p_step) {
 		_set_transform(new_transform, false);
 		_set_inv_transform(new_transform.affine_inverse());
 		if (contacts.size() == 0 && linear_velocity == Vector3() && angular_velocity == Vector3())
-			set_active(false); //stopped moving, deactivate
+			pending_deactivation = true; //stopped moving, deactivate
 
 		return;
 	}
@@ -620,8 +627,9 @@ void BodySW::integrate_velocities(real_t p_step) {
 
 	transform.origin += total_linear_velocity * p_step;
 
-	_set_transform(transform);
+	_set_transform(transform, false);
 	_set_inv_transform(get_transform().inverse());
+	pending_shape_update = true;
 
 	_update_transform_dependant();
 
@@ -631,6 +639,25 @@ void BodySW::integrate_velocities(real_t p_step) {
 	*/
 }
 
+void BodySW::commit_velocities() {
+
+	if (mode == PhysicsServer::BODY_MODE_STATIC)
+		return;
+
+	if (fi_callback)
+		get_space()->body_add_to_state_query_list(&direct_state_query_list);
+
+	if (pending_shape_update) {
+		_update_shapes();
+		pending_shape_update = false;
+	}
+
+	if (pending_deactivation) {
+		set_active(false);
+		pending_deactivation = false;
+	}
+}
+
 /*
 void BodySW::simulate_motion(const Transform& p_xform,real_t p_step) {
 
@@ -788,6 +815,10 @@ BodySW::BodySW() :
 	continuous_cd = false;
 	can_sleep = false;
 	fi_callback = NULL;
+
+	pending_motion_update = false;
+	pending_shape_update = false;
+	pending_deactivation = false;
 }
 
 BodySW::~BodySW() {
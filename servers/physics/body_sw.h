@@ -137,6 +137,12 @@ class BodySW : public CollisionObjectSW {
 
 	ForceIntegrationCallback *fi_callback;
 
+	// Changes to the space left by the integration, applied by commit_forces() and commit_velocities().
+	Vector3 pending_motion;
+	bool pending_motion_update;
+	bool pending_shape_update;
+	bool pending_deactivation;
+
 	uint64_t island_step;
 	BodySW *island_next;
 	BodySW *island_list_next;
@@ -291,8 +297,12 @@ public:
 	void set_axis_lock(PhysicsServer::BodyAxis p_axis, bool lock);
 	bool is_axis_locked(PhysicsServer::BodyAxis p_axis) const;
 
+	// Integration only touches the body, so bodies can be integrated from several threads.
+	// The commits update the space and must then run on a single thread, in body order.
 	void integrate_forces(real_t p_step);
+	void commit_forces();
 	void integrate_velocities(real_t p_step);
+	void commit_velocities();
 
 	_FORCE_INLINE_ Vector3 get_velocity_in_local_point(const Vector3 &rel_pos) const {
 
@@ -0,0 +1,695 @@
+/*************************************************************************/
+/*  broad_phase_aabb_tree.cpp                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "broad_phase_aabb_tree.h"
+#include "collision_object_sw.h"
+
+static _FORCE_INLINE_ real_t _aabb_surface(const AABB &p_aabb) {
+
+	const Vector3 &s = p_aabb.size;
+	return 2.0 * (s.x * s.y + s.y * s.z + s.z * s.x);
+}
+
+/* TREE */
+
+int BroadPhaseAABBTree::Tree::allocate_node() {
+
+	if (free_node == -1) {
+
+		int new_capacity = node_capacity ? node_capacity * 2 : 16;
+		nodes = (Node *)memrealloc(nodes, sizeof(Node) * new_capacity);
+		for (int i = node_capacity; i < new_capacity; i++) {
+			nodes[i].parent = i + 1;
+			nodes[i].height = -1;
+		}
+		nodes[new_capacity - 1].parent = -1;
+		free_node = node_capacity;
+		node_capacity = new_capacity;
+	}
+
+	int node = free_node;
+	free_node = nodes[node].parent;
+
+	Node &n = nodes[node];
+	n.parent = -1;
+	n.children[0] = -1;
+	n.children[1] = -1;
+	n.height = 0;
+	n.element = 0;
+	node_count++;
+
+	return node;
+}
+
+void BroadPhaseAABBTree::Tree::free_node_at(int p_node) {
+
+	nodes[p_node].parent = free_node;
+	nodes[p_node].height = -1;
+	free_node = p_node;
+	node_count--;
+}
+
+void BroadPhaseAABBTree::Tree::insert_leaf(int p_leaf) {
+
+	if (root == -1) {
+		root = p_leaf;
+		nodes[p_leaf].parent = -1;
+		return;
+	}
+
+	// Find the sibling that makes the tree grow the least.
+	AABB leaf_aabb = nodes[p_leaf].aabb;
+	int index = root;
+
+	while (!nodes[index].is_leaf()) {
+
+		const Node &n = nodes[index];
+
+		real_t area = _aabb_surface(n.aabb);
+		real_t combined_area = _aabb_surface(n.aabb.merge(leaf_aabb));
+
+		// cost of making a new parent for this node and the leaf
+		real_t cost = 2.0 * combined_area;
+
+		// cost pushed down to the children if descending
+		real_t inheritance_cost = 2.0 * (combined_area - area);
+
+		real_t child_cost[2];
+		for (int i = 0; i < 2; i++) {
+
+			const Node &child = nodes[n.children[i]];
+			real_t merged_area = _aabb_surface(child.aabb.merge(leaf_aabb));
+			child_cost[i] = (child.is_leaf() ? merged_area : merged_area - _aabb_surface(child.aabb)) + inheritance_cost;
+		}
+
+		if (cost < child_cost[0] && cost < child_cost[1])
+			break;
+
+		index = child_cost[0] < child_cost[1] ? n.children[0] : n.children[1];
+	}
+
+	int sibling = index;
+	int old_parent = nodes[sibling].parent;
+	int new_parent = allocate_node(); // may move the nodes, don't keep references across this
+
+	nodes[new_parent].parent = old_parent;
+	nodes[new_parent].aabb = leaf_aabb.merge(nodes[sibling].aabb);
+	nodes[new_parent].height = nodes[sibling].height + 1;
+	nodes[new_parent].children[0] = sibling;
+	nodes[new_parent].children[1] = p_leaf;
+	nodes[sibling].parent = new_parent;
+	nodes[p_leaf].parent = new_parent;
+
+	if (old_parent != -1) {
+
+		Node &p = nodes[old_parent];
+		p.children[p.children[0] == sibling ? 0 : 1] = new_parent;
+	} else {
+
+		root = new_parent;
+	}
+
+	// Fix the bounds and heights up to the root.
+	index = nodes[p_leaf].parent;
+	while (index != -1) {
+
+		index = balance(index);
+
+		Node &n = nodes[index];
+		const Node &c0 = nodes[n.children[0]];
+		const Node &c1 = nodes[n.children[1]];
+		n.height = 1 + MAX(c0.height, c1.height);
+		n.aabb = c0.aabb.merge(c1.aabb);
+
+		index = n.parent;
+	}
+}
+
+void BroadPhaseAABBTree::Tree::remove_leaf(int p_leaf) {
+
+	if (p_leaf == root) {
+		root = -1;
+		return;
+	}
+
+	int parent = nodes[p_leaf].parent;
+	int grand_parent = nodes[parent].parent;
+	int sibling = nodes[parent].children[0] == p_leaf ? nodes[parent].children[1] : nodes[parent].children[0];
+
+	free_node_at(parent);
+
+	if (grand_parent == -1) {
+
+		root = sibling;
+		nodes[sibling].parent = -1;
+		return;
+	}
+
+	Node &g = nodes[grand_parent];
+	g.children[g.children[0] == parent ? 0 : 1] = sibling;
+	nodes[sibling].parent = grand_parent;
+
+	int index = grand_parent;
+	while (index != -1) {
+
+		index = balance(index);
+
+		Node &n = nodes[index];
+		const Node &c0 = nodes[n.children[0]];
+		const Node &c1 = nodes[n.children[1]];
+		n.height = 1 + MAX(c0.height, c1.height);
+		n.aabb = c0.aabb.merge(c1.aabb);
+
+		index = n.parent;
+	}
+}
+
+int BroadPhaseAABBTree::Tree::balance(int p_node) {
+
+	Node &a = nodes[p_node];
+	if (a.is_leaf() || a.height < 2)
+		return p_node;
+
+	int ib = a.children[0];
+	int ic = a.children[1];
+	Node &b = nodes[ib];
+	Node &c = nodes[ic];
+
+	int bal = c.height - b.height;
+
+	if (bal > 1) {
+
+		// rotate c up
+		int f = c.children[0];
+		int g = c.children[1];
+
+		c.children[0] = p_node;
+		c.parent = a.parent;
+		a.parent = ic;
+
+		if (c.parent != -1) {
+			Node &p = nodes[c.parent];
+			p.children[p.children[0] == p_node ? 0 : 1] = ic;
+		} else {
+			root = ic;
+		}
+
+		if (nodes[f].height > nodes[g].height) {
+			SWAP(f, g);
+		}
+
+		// keep the taller grandchild next to a's new parent
+		c.children[1] = g;
+		a.children[1] = f;
+		nodes[f].parent = p_node;
+
+		a.aabb = b.aabb.merge(nodes[f].aabb);
+		c.aabb = a.aabb.merge(nodes[g].aabb);
+		a.height = 1 + MAX(b.height, nodes[f].height);
+		c.height = 1 + MAX(a.height, nodes[g].height);
+
+		return ic;
+	}
+
+	if (bal < -1) {
+
+		// rotate b up
+		int d = b.children[0];
+		int e = b.children[1];
+
+		b.children[0] = p_node;
+		b.parent = a.parent;
+		a.parent = ib;
+
+		if (b.parent != -1) {
+			Node &p = nodes[b.parent];
+			p.children[p.children[0] == p_node ? 0 : 1] = ib;
+		} else {
+			root = ib;
+		}
+
+		if (nodes[d].height > nodes[e].height) {
+			SWAP(d, e);
+		}
+
+		b.children[1] = e;
+		a.children[0] = d;
+		nodes[d].parent = p_node;
+
+		a.aabb = c.aabb.merge(nodes[d].aabb);
+		b.aabb = a.aabb.merge(nodes[e].aabb);
+		a.height = 1 + MAX(c.height, nodes[d].height);
+		b.height = 1 + MAX(a.height, nodes[e].height);
+
+		return ib;
+	}
+
+	return p_node;
+}
+
+BroadPhaseAABBTree::Tree::Tree() {
+
+	nodes = NULL;
+	node_count = 0;
+	node_capacity = 0;
+	free_node = -1;
+	root = -1;
+}
+
+BroadPhaseAABBTree::Tree::~Tree() {
+
+	if (nodes)
+		memfree(nodes);
+}
+
+/* PAIRS */
+
+void BroadPhaseAABBTree::_add_pair(ID p_A, ID p_B) {
+
+	uint64_t key = _pair_key(p_A, p_B);
+	if (pair_map.has(key))
+		return;
+
+	uint32_t index;
+	if (free_pairs.size()) {
+		index = free_pairs[free_pairs.size() - 1];
+		free_pairs.resize(free_pairs.size() - 1);
+	} else {
+		index = pairs.size();
+		pairs.resize(index + 1);
+	}
+
+	Pair &p = pairs[index];
+	p.A = p_A;
+	p.B = p_B;
+	p.colliding = false;
+	p.ud = NULL;
+
+	pair_map[key] = index;
+	elements[p_A - 1].pairs.push_back(index);
+	elements[p_B - 1].pairs.push_back(index);
+}
+
+void BroadPhaseAABBTree::_remove_pair(uint32_t p_pair) {
+
+	Pair p = pairs[p_pair];
+	Element &A = elements[p.A - 1];
+	Element &B = elements[p.B - 1];
+
+	if (p.colliding && unpair_callback) {
+		unpair_callback(A.owner, A.subindex, B.owner, B.subindex, p.ud, unpair_userdata);
+	}
+
+	A.pairs.erase(p_pair);
+	B.pairs.erase(p_pair);
+	pair_map.erase(_pair_key(p.A, p.B));
+	free_pairs.push_back(p_pair);
+}
+
+void BroadPhaseAABBTree::_check_pair(uint32_t p_pair) {
+
+	Pair &p = pairs[p_pair];
+	const Element &A = elements[p.A - 1];
+	const Element &B = elements[p.B - 1];
+
+	bool colliding = A.aabb.intersects_inclusive(B.aabb);
+	if (colliding == p.colliding)
+		return;
+
+	p.colliding = colliding;
+
+	if (colliding) {
+		if (pair_callback) {
+			// the callback may create pairs of other broad phases, but not of this one
+			void *ud = pair_callback(A.owner, A.subindex, B.owner, B.subindex, pair_userdata);
+			pairs[p_pair].ud = ud;
+		}
+	} else {
+		if (unpair_callback) {
+			unpair_callback(A.owner, A.subindex, B.owner, B.subindex, p.ud, unpair_userdata);
+		}
+		pairs[p_pair].ud = NULL;
+	}
+}
+
+void BroadPhaseAABBTree::_find_pairs(ID p_id) {
+
+	Element &e = elements[p_id - 1];
+	int tree_index = e._static ? TREE_STATIC : TREE_DYNAMIC;
+	AABB fat = trees[tree_index].nodes[e.leaf].aabb;
+
+	// Drop the pairs whose fattened bounds stopped overlapping.
+	for (int i = e.pairs.size() - 1; i >= 0; i--) {
+
+		const Pair &p = pairs[e.pairs[i]];
+		const Element &other = elements[(p.A == p_id ? p.B : p.A) - 1];
+		const Tree &other_tree = trees[other._static ? TREE_STATIC : TREE_DYNAMIC];
+
+		if ((e._static && other._static) || !fat.intersects_inclusive(other_tree.nodes[other.leaf].aabb)) {
+			_remove_pair(elements[p_id - 1].pairs[i]);
+		}
+	}
+
+	// Static objects only pair with moving ones.
+	for (int t = e._static ? TREE_DYNAMIC : TREE_STATIC; t < TREE_MAX; t++) {
+
+		const Tree &tree = trees[t];
+		if (tree.root == -1)
+			continue;
+
+		int stack[STACK_SIZE];
+		int stack_size = 0;
+		stack[stack_size++] = tree.root;
+
+		while (stack_size) {
+
+			const Tree::Node &n = tree.nodes[stack[--stack_size]];
+			if (!n.aabb.intersects_inclusive(fat))
+				continue;
+
+			if (n.is_leaf()) {
+				if (n.element != p_id && elements[n.element - 1].owner != elements[p_id - 1].owner) {
+					_add_pair(p_id, n.element);
+				}
+			} else {
+				ERR_CONTINUE(stack_size + 2 > STACK_SIZE);
+				stack[stack_size++] = n.children[0];
+				stack[stack_size++] = n.children[1];
+			}
+		}
+	}
+
+	// Copy, callbacks may not touch this broad phase but keep it safe against reallocation.
+	Vector<uint32_t> to_check = elements[p_id - 1].pairs;
+	for (int i = 0; i < to_check.size(); i++) {
+		_check_pair(to_check[i]);
+	}
+}
+
+/* ELEMENTS */
+
+void BroadPhaseAABBTree::_insert(ID p_id, const Vector3 &p_motion) {
+
+	Element &e = elements[p_id - 1];
+	Tree &tree = trees[e._static ? TREE_STATIC : TREE_DYNAMIC];
+
+	AABB fat = e.aabb;
+	if (!e._static) { // static objects don't need room to move
+
+		fat.grow_by(margin);
+		// expect the object to keep going the same way for a while
+		fat.expand_to(fat.position + p_motion * 2.0);
+		fat.expand_to(fat.position + fat.size + p_motion * 2.0);
+	}
+
+	int leaf = tree.allocate_node();
+	tree.nodes[leaf].aabb = fat;
+	tree.nodes[leaf].element = p_id;
+	tree.insert_leaf(leaf);
+
+	e.leaf = leaf;
+}
+
+void BroadPhaseAABBTree::_remove(ID p_id) {
+
+	Element &e = elements[p_id - 1];
+	Tree &tree = trees[e._static ? TREE_STATIC : TREE_DYNAMIC];
+
+	tree.remove_leaf(e.leaf);
+	tree.free_node_at(e.leaf);
+	e.leaf = -1;
+}
+
+BroadPhaseSW::ID BroadPhaseAABBTree::create(CollisionObjectSW *p_object, int p_subindex) {
+
+	ID id;
+	if (free_ids.size()) {
+		id = free_ids[free_ids.size() - 1];
+		free_ids.resize(free_ids.size() - 1);
+	} else {
+		elements.resize(elements.size() + 1);
+		id = elements.size();
+	}
+
+	Element &e = elements[id - 1];
+	e.owner = p_object;
+	e.subindex = p_subindex;
+	e._static = true; // like the octree, nothing pairs until set_static() is called
+	e.in_use = true;
+	e.aabb = AABB();
+	e.leaf = -1;
+
+	return id;
+}
+
+void BroadPhaseAABBTree::move(ID p_id, const AABB &p_aabb) {
+
+	ERR_FAIL_COND(p_id == 0 || p_id > (ID)elements.size() || !elements[p_id - 1].in_use);
+
+	Element &e = elements[p_id - 1];
+	Vector3 motion = p_aabb.position - e.aabb.position;
+	e.aabb = p_aabb;
+
+	if (p_aabb.has_no_surface()) {
+
+		if (e.leaf != -1) {
+			while (elements[p_id - 1].pairs.size()) {
+				_remove_pair(elements[p_id - 1].pairs[0]);
+			}
+			_remove(p_id);
+		}
+		return;
+	}
+
+	if (e.leaf == -1) {
+
+		_insert(p_id);
+	} else {
+
+		Tree &tree = trees[e._static ? TREE_STATIC : TREE_DYNAMIC];
+		if (tree.nodes[e.leaf].aabb.encloses(p_aabb)) {
+
+			// still inside the fattened bounds, only the pairs may change
+			Vector<uint32_t> to_check = e.pairs;
+			for (int i = 0; i < to_check.size(); i++) {
+				_check_pair(to_check[i]);
+			}
+			return;
+		}
+
+		_remove(p_id);
+		_insert(p_id, motion);
+	}
+
+	_find_pairs(p_id);
+}
+
+void BroadPhaseAABBTree::set_static(ID p_id, bool p_static) {
+
+	ERR_FAIL_COND(p_id == 0 || p_id > (ID)elements.size() || !elements[p_id - 1].in_use);
+
+	Element &e = elements[p_id - 1];
+	if (e._static == p_static)
+		return;
+
+	if (e.leaf == -1) {
+		e._static = p_static;
+		return;
+	}
+
+	_remove(p_id);
+	elements[p_id - 1]._static = p_static;
+	_insert(p_id);
+	_find_pairs(p_id);
+}
+
+void BroadPhaseAABBTree::remove(ID p_id) {
+
+	ERR_FAIL_COND(p_id == 0 || p_id > (ID)elements.size() || !elements[p_id - 1].in_use);
+
+	while (elements[p_id - 1].pairs.size()) {
+		_remove_pair(elements[p_id - 1].pairs[0]);
+	}
+
+	if (elements[p_id - 1].leaf != -1) {
+		_remove(p_id);
+	}
+
+	Element &e = elements[p_id - 1];
+	e.in_use = false;
+	e.owner = NULL;
+	e.pairs.clear();
+	free_ids.push_back(p_id);
+}
+
+CollisionObjectSW *BroadPhaseAABBTree::get_object(ID p_id) const {
+
+	ERR_FAIL_COND_V(p_id == 0 || p_id > (ID)elements.size() || !elements[p_id - 1].in_use, NULL);
+	return elements[p_id - 1].owner;
+}
+
+bool BroadPhaseAABBTree::is_static(ID p_id) const {
+
+	ERR_FAIL_COND_V(p_id == 0 || p_id > (ID)elements.size() || !elements[p_id - 1].in_use, false);
+	return elements[p_id - 1]._static;
+}
+
+int BroadPhaseAABBTree::get_subindex(ID p_id) const {
+
+	ERR_FAIL_COND_V(p_id == 0 || p_id > (ID)elements.size() || !elements[p_id - 1].in_use, -1);
+	return elements[p_id - 1].subindex;
+}
+
+/* QUERIES */
+
+struct _BroadPhaseAABBTreePointTest {
+
+	Vector3 point;
+	_FORCE_INLINE_ bool operator()(const AABB &p_aabb) const { return p_aabb.has_point(point); }
+};
+
+struct _BroadPhaseAABBTreeSegmentTest {
+
+	Vector3 from;
+	Vector3 to;
+	_FORCE_INLINE_ bool operator()(const AABB &p_aabb) const { return p_aabb.intersects_segment(from, to); }
+};
+
+struct _BroadPhaseAABBTreeAABBTest {
+
+	AABB aabb;
+	_FORCE_INLINE_ bool operator()(const AABB &p_aabb) const { return aabb.intersects_inclusive(p_aabb); }
+};
+
+// Only reads, so queries may run from several threads while nothing moves.
+template <class T>
+void BroadPhaseAABBTree::_cull(const T &p_test, CollisionObjectSW **p_results, int p_max_results, int *p_result_indices, int &r_count) const {
+
+	for (int t = 0; t < TREE_MAX; t++) {
+
+		const Tree &tree = trees[t];
+		if (tree.root == -1)
+			continue;
+
+		int stack[STACK_SIZE];
+		int stack_size = 0;
+		stack[stack_size++] = tree.root;
+
+		while (stack_size) {
+
+			const Tree::Node &n = tree.nodes[stack[--stack_size]];
+			if (!p_test(n.aabb))
+				continue;
+
+			if (n.is_leaf()) {
+
+				const Element &e = elements[n.element - 1];
+				if (!p_test(e.aabb))
+					continue;
+
+				if (r_count >= p_max_results)
+					return;
+
+				p_results[r_count] = e.owner;
+				if (p_result_indices)
+					p_result_indices[r_count] = e.subindex;
+				r_count++;
+			} else {
+				ERR_CONTINUE(stack_size + 2 > STACK_SIZE);
+				stack[stack_size++] = n.children[0];
+				stack[stack_size++] = n.children[1];
+			}
+		}
+	}
+}
+
+int BroadPhaseAABBTree::cull_point(const Vector3 &p_point, CollisionObjectSW **p_results, int p_max_results, int *p_result_indices) {
+
+	_BroadPhaseAABBTreePointTest test;
+	test.point = p_point;
+
+	int count = 0;
+	_cull(test, p_results, p_max_results, p_result_indices, count);
+	return count;
+}
+
+int BroadPhaseAABBTree::cull_segment(const Vector3 &p_from, const Vector3 &p_to, CollisionObjectSW **p_results, int p_max_results, int *p_result_indices) {
+
+	_BroadPhaseAABBTreeSegmentTest test;
+	test.from = p_from;
+	test.to = p_to;
+
+	int count = 0;
+	_cull(test, p_results, p_max_results, p_result_indices, count);
+	return count;
+}
+
+int BroadPhaseAABBTree::cull_aabb(const AABB &p_aabb, CollisionObjectSW **p_results, int p_max_results, int *p_result_indices) {
+
+	_BroadPhaseAABBTreeAABBTest test;
+	test.aabb = p_aabb;
+
+	int count = 0;
+	_cull(test, p_results, p_max_results, p_result_indices, count);
+	return count;
+}
+
+void BroadPhaseAABBTree::set_pair_callback(PairCallback p_pair_callback, void *p_userdata) {
+
+	pair_callback = p_pair_callback;
+	pair_userdata = p_userdata;
+}
+
+void BroadPhaseAABBTree::set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata) {
+
+	unpair_callback = p_unpair_callback;
+	unpair_userdata = p_userdata;
+}
+
+void BroadPhaseAABBTree::update() {
+	// pairs are updated as objects move
+}
+
+BroadPhaseSW *BroadPhaseAABBTree::_create() {
+
+	return memnew(BroadPhaseAABBTree);
+}
+
+BroadPhaseAABBTree::BroadPhaseAABBTree() {
+
+	margin = 0.1;
+
+	pair_callback = NULL;
+	pair_userdata = NULL;
+	unpair_callback = NULL;
+	unpair_userdata = NULL;
+}
+
+BroadPhaseAABBTree::~BroadPhaseAABBTree() {
+}
@@ -0,0 +1,159 @@
+/*************************************************************************/
+/*  broad_phase_aabb_tree.h                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef BROAD_PHASE_AABB_TREE_H
+#define BROAD_PHASE_AABB_TREE_H
+
+#include "broad_phase_sw.h"
+#include "hash_map.h"
+#include "vector.h"
+
+/**
+	Broad phase based on dynamic AABB trees, one for static and one for moving objects.
+	Leaves are fattened by a margin, and stretched along the motion when reinserted,
+	so objects moving a little don't touch the tree.
+	Pairs are kept between objects whose fattened bounds overlap, and reported as
+	colliding when their real bounds do, like the octree does.
+*/
+
+class BroadPhaseAABBTree : public BroadPhaseSW {
+
+	enum {
+		TREE_STATIC,
+		TREE_DYNAMIC,
+		TREE_MAX,
+		STACK_SIZE = 128,
+	};
+
+	struct Tree {
+
+		struct Node {
+
+			AABB aabb;
+			int parent; // next free node when not in use
+			int children[2];
+			int height; // 0 for leaves, -1 for free nodes
+			ID element;
+
+			_FORCE_INLINE_ bool is_leaf() const { return children[0] == -1; }
+		};
+
+		Node *nodes;
+		int node_count;
+		int node_capacity;
+		int free_node;
+		int root;
+
+		int allocate_node();
+		void free_node_at(int p_node);
+
+		void insert_leaf(int p_leaf);
+		void remove_leaf(int p_leaf);
+		int balance(int p_node);
+
+		Tree();
+		~Tree();
+	};
+
+	struct Element {
+
+		CollisionObjectSW *owner;
+		int subindex;
+		bool _static;
+		bool in_use;
+		AABB aabb;
+		int leaf; // -1 if not in the tree
+		Vector<uint32_t> pairs;
+	};
+
+	struct Pair {
+
+		ID A;
+		ID B;
+		bool colliding;
+		void *ud;
+	};
+
+	Tree trees[TREE_MAX];
+
+	Vector<Element> elements; // indexed by ID - 1
+	Vector<ID> free_ids;
+
+	Vector<Pair> pairs;
+	Vector<uint32_t> free_pairs;
+	HashMap<uint64_t, uint32_t> pair_map;
+
+	real_t margin;
+
+	PairCallback pair_callback;
+	void *pair_userdata;
+	UnpairCallback unpair_callback;
+	void *unpair_userdata;
+
+	static _FORCE_INLINE_ uint64_t _pair_key(ID p_A, ID p_B) {
+		return p_A < p_B ? (uint64_t(p_A) << 32) | p_B : (uint64_t(p_B) << 32) | p_A;
+	}
+
+	void _insert(ID p_id, const Vector3 &p_motion = Vector3());
+	void _remove(ID p_id);
+
+	void _add_pair(ID p_A, ID p_B);
+	void _remove_pair(uint32_t p_pair);
+	void _check_pair(uint32_t p_pair);
+	void _find_pairs(ID p_id);
+
+	template <class T>
+	_FORCE_INLINE_ void _cull(const T &p_test, CollisionObjectSW **p_results, int p_max_results, int *p_result_indices, int &r_count) const;
+
+public:
+	virtual ID create(CollisionObjectSW *p_object, int p_subindex = 0);
+	virtual void move(ID p_id, const AABB &p_aabb);
+	virtual void set_static(ID p_id, bool p_static);
+	virtual void remove(ID p_id);
+
+	virtual CollisionObjectSW *get_object(ID p_id) const;
+	virtual bool is_static(ID p_id) const;
+	virtual int get_subindex(ID p_id) const;
+
+	virtual int cull_point(const Vector3 &p_point, CollisionObjectSW **p_results, int p_max_results, int *p_result_indices = NULL);
+	virtual int cull_segment(const Vector3 &p_from, const Vector3 &p_to, CollisionObjectSW **p_results, int p_max_results, int *p_result_indices = NULL);
+	virtual int cull_aabb(const AABB &p_aabb, CollisionObjectSW **p_results, int p_max_results, int *p_result_indices = NULL);
+
+	virtual void set_pair_callback(PairCallback p_pair_callback, void *p_userdata);
+	virtual void set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata);
+
+	virtual void update();
+	virtual bool is_cull_thread_safe() const { return true; }
+
+	static BroadPhaseSW *_create();
+	BroadPhaseAABBTree();
+	~BroadPhaseAABBTree();
+};
+
+#endif // BROAD_PHASE_AABB_TREE_H
@@ -99,6 +99,7 @@ public:
 	virtual void set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata);
 
 	virtual void update();
+	virtual bool is_cull_thread_safe() const { return true; }
 
 	static BroadPhaseSW *_create();
 	BroadPhaseBasic();
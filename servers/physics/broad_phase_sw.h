@@ -66,6 +66,9 @@ public:
 
 	virtual void update() = 0;
 
+	// Whether cull_*() may be called from several threads at once. Batched queries serialize them otherwise.
+	virtual bool is_cull_thread_safe() const { return false; }
+
 	virtual ~BroadPhaseSW();
 };
 
@@ -73,6 +73,9 @@ public:
 	virtual bool setup(real_t p_step) = 0;
 	virtual void solve(real_t p_step) = 0;
 
+	// False if setup() writes to objects shared with other islands, which forces serial setup.
+	virtual bool can_setup_in_parallel() const { return true; }
+
 	virtual ~ConstraintSW() {}
 };
 
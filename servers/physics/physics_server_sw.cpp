@@ -29,6 +29,7 @@
 /*************************************************************************/
 #include "physics_server_sw.h"
 
+#include "broad_phase_aabb_tree.h"
 #include "broad_phase_basic.h"
 #include "broad_phase_octree.h"
 #include "joints/cone_twist_joint_sw.h"
@@ -37,6 +38,7 @@
 #include "joints/pin_joint_sw.h"
 #include "joints/slider_joint_sw.h"
 #include "os/os.h"
+#include "project_settings.h"
 #include "script_language.h"
 
 RID PhysicsServerSW::shape_create(ShapeType p_shape) {
@@ -1481,7 +1483,15 @@ void PhysicsServerSW::_shape_col_cbk(const Vector3 &p_point_A, const Vector3 &p_
 PhysicsServerSW *PhysicsServerSW::singleton = NULL;
 PhysicsServerSW::PhysicsServerSW() {
 	singleton = this;
-	BroadPhaseSW::create_func = BroadPhaseOctree::_create;
+
+	String broad_phase = GLOBAL_DEF("physics/3d/broad_phase", "Octree");
+	ProjectSettings::get_singleton()->set_custom_property_info("physics/3d/broad_phase", PropertyInfo(Variant::STRING, "physics/3d/broad_phase", PROPERTY_HINT_ENUM, "Octree,AABBTree"));
+
+	if (broad_phase == "AABBTree") {
+		BroadPhaseSW::create_func = BroadPhaseAABBTree::_create;
+	} else {
+		BroadPhaseSW::create_func = BroadPhaseOctree::_create;
+	}
 	island_count = 0;
 	active_objects = 0;
 	collision_pairs = 0;
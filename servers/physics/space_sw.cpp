@@ -82,9 +82,42 @@ int PhysicsDirectSpaceStateSW::intersect_point(const Vector3 &p_point, ShapeResu
 	return cc;
 }
 
-bool PhysicsDirectSpaceStateSW::intersect_ray(const Vector3 &p_from, const Vector3 &p_to, RayResult &r_result, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_pick_ray) {
+// Exclude lists as the single queries get them.
+struct _SpaceSWExcludeSet {
 
-	ERR_FAIL_COND_V(space->locked, false);
+	const Set<RID> *exclude;
+
+	_FORCE_INLINE_ bool has(const CollisionObjectSW *p_object) const { return exclude->has(p_object->get_self()); }
+};
+
+// Exclude lists of batched queries, sorted once per batch and shared by all of its queries.
+struct _SpaceSWExcludeSorted {
+
+	const RID *exclude;
+	int count;
+
+	_FORCE_INLINE_ bool has(const CollisionObjectSW *p_object) const {
+
+		RID self = p_object->get_self();
+		int low = 0;
+		int high = count;
+		while (low < high) {
+			int middle = (low + high) / 2;
+			if (exclude[middle] < self)
+				low = middle + 1;
+			else
+				high = middle;
+		}
+
+		return low < count && exclude[low] == self;
+	}
+};
+
+// The narrow phase of the queries below works on what the broad phase culled, so that single and
+// batched queries share it while culling into different buffers.
+
+template <class E>
+static bool _intersect_ray_culled(CollisionObjectSW **p_objects, const int *p_subindices, int p_amount, const Vector3 &p_from, const Vector3 &p_to, PhysicsDirectSpaceState::RayResult &r_result, const E &p_exclude, uint32_t p_collision_mask, bool p_pick_ray) {
 
 	Vector3 begin, end;
 	Vector3 normal;
@@ -92,8 +125,6 @@ bool PhysicsDirectSpaceStateSW::intersect_ray(const Vector3 &p_from, const Vecto
 	end = p_to;
 	normal = (end - begin).normalized();
 
-	int amount = space->broadphase->cull_segment(begin, end, space->intersection_query_results, SpaceSW::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
-
 	//todo, create another array tha references results, compute AABBs and check closest point to ray origin, sort, and stop evaluating results when beyond first collision
 
 	bool collided = false;
@@ -102,20 +133,20 @@ bool PhysicsDirectSpaceStateSW::intersect_ray(const Vector3 &p_from, const Vecto
 	const CollisionObjectSW *res_obj;
 	real_t min_d = 1e10;
 
-	for (int i = 0; i < amount; i++) {
+	for (int i = 0; i < p_amount; i++) {
 
-		if (!_can_collide_with(space->intersection_query_results[i], p_collision_mask))
+		if (!_can_collide_with(p_objects[i], p_collision_mask))
 			continue;
 
-		if (p_pick_ray && !(static_cast<CollisionObjectSW *>(space->intersection_query_results[i])->is_ray_pickable()))
+		if (p_pick_ray && !(static_cast<CollisionObjectSW *>(p_objects[i])->is_ray_pickable()))
 			continue;
 
-		if (p_exclude.has(space->intersection_query_results[i]->get_self()))
+		if (p_exclude.has(p_objects[i]))
 			continue;
 
-		const CollisionObjectSW *col_obj = space->intersection_query_results[i];
+		const CollisionObjectSW *col_obj = p_objects[i];
 
-		int shape_idx = space->intersection_query_subindex_results[i];
+		int shape_idx = p_subindices[i];
 		Transform inv_xform = col_obj->get_shape_inv_transform(shape_idx) * col_obj->get_inv_transform();
 
 		Vector3 local_from = inv_xform.xform(begin);
@@ -160,39 +191,30 @@ bool PhysicsDirectSpaceStateSW::intersect_ray(const Vector3 &p_from, const Vecto
 	return true;
 }
 
-int PhysicsDirectSpaceStateSW::intersect_shape(const RID &p_shape, const Transform &p_xform, real_t p_margin, ShapeResult *r_results, int p_result_max, const Set<RID> &p_exclude, uint32_t p_collision_mask) {
-
-	if (p_result_max <= 0)
-		return 0;
-
-	ShapeSW *shape = static_cast<PhysicsServerSW *>(PhysicsServer::get_singleton())->shape_owner.get(p_shape);
-	ERR_FAIL_COND_V(!shape, 0);
-
-	AABB aabb = p_xform.xform(shape->get_aabb());
-
-	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, SpaceSW::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+template <class E>
+static int _intersect_shape_culled(const ShapeSW *p_shape, const Transform &p_xform, real_t p_margin, CollisionObjectSW **p_objects, const int *p_subindices, int p_amount, PhysicsDirectSpaceState::ShapeResult *r_results, int p_result_max, const E &p_exclude, uint32_t p_collision_mask) {
 
 	int cc = 0;
 
 	//Transform ai = p_xform.affine_inverse();
 
-	for (int i = 0; i < amount; i++) {
+	for (int i = 0; i < p_amount; i++) {
 
 		if (cc >= p_result_max)
 			break;
 
-		if (!_can_collide_with(space->intersection_query_results[i], p_collision_mask))
+		if (!_can_collide_with(p_objects[i], p_collision_mask))
 			continue;
 
 		//area can't be picked by ray (default)
 
-		if (p_exclude.has(space->intersection_query_results[i]->get_self()))
+		if (p_exclude.has(p_objects[i]))
 			continue;
 
-		const CollisionObjectSW *col_obj = space->intersection_query_results[i];
-		int shape_idx = space->intersection_query_subindex_results[i];
+		const CollisionObjectSW *col_obj = p_objects[i];
+		int shape_idx = p_subindices[i];
 
-		if (!CollisionSolverSW::solve_static(shape, p_xform, col_obj->get_shape(shape_idx), col_obj->get_transform() * col_obj->get_shape_transform(shape_idx), NULL, NULL, NULL, p_margin, 0))
+		if (!CollisionSolverSW::solve_static(p_shape, p_xform, col_obj->get_shape(shape_idx), col_obj->get_transform() * col_obj->get_shape_transform(shape_idx), NULL, NULL, NULL, p_margin, 0))
 			continue;
 
 		if (r_results) {
@@ -211,51 +233,47 @@ int PhysicsDirectSpaceStateSW::intersect_shape(const RID &p_shape, const Transfo
 	return cc;
 }
 
-bool PhysicsDirectSpaceStateSW::cast_motion(const RID &p_shape, const Transform &p_xform, const Vector3 &p_motion, real_t p_margin, real_t &p_closest_safe, real_t &p_closest_unsafe, const Set<RID> &p_exclude, uint32_t p_collision_mask, ShapeRestInfo *r_info) {
-
-	ShapeSW *shape = static_cast<PhysicsServerSW *>(PhysicsServer::get_singleton())->shape_owner.get(p_shape);
-	ERR_FAIL_COND_V(!shape, false);
+static AABB _cast_motion_aabb(const ShapeSW *p_shape, const Transform &p_xform, const Vector3 &p_motion, real_t p_margin) {
 
-	AABB aabb = p_xform.xform(shape->get_aabb());
+	AABB aabb = p_xform.xform(p_shape->get_aabb());
 	aabb = aabb.merge(AABB(aabb.position + p_motion, aabb.size)); //motion
 	aabb = aabb.grow(p_margin);
 
-	/*
-	if (p_motion!=Vector3())
-		print_line(p_motion);
-	*/
+	return aabb;
+}
 
-	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, SpaceSW::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+template <class E>
+static bool _cast_motion_culled(ShapeSW *p_shape, const Transform &p_xform, const Vector3 &p_motion, const AABB &p_aabb, CollisionObjectSW **p_objects, const int *p_subindices, int p_amount, real_t &p_closest_safe, real_t &p_closest_unsafe, const E &p_exclude, uint32_t p_collision_mask, PhysicsDirectSpaceState::ShapeRestInfo *r_info) {
 
 	real_t best_safe = 1;
 	real_t best_unsafe = 1;
 
 	Transform xform_inv = p_xform.affine_inverse();
 	MotionShapeSW mshape;
-	mshape.shape = shape;
+	mshape.shape = p_shape;
 	mshape.motion = xform_inv.basis.xform(p_motion);
 
 	bool best_first = true;
 
 	Vector3 closest_A, closest_B;
 
-	for (int i = 0; i < amount; i++) {
+	for (int i = 0; i < p_amount; i++) {
 
-		if (!_can_collide_with(space->intersection_query_results[i], p_collision_mask))
+		if (!_can_collide_with(p_objects[i], p_collision_mask))
 			continue;
 
-		if (p_exclude.has(space->intersection_query_results[i]->get_self()))
+		if (p_exclude.has(p_objects[i]))
 			continue; //ignore excluded
 
-		const CollisionObjectSW *col_obj = space->intersection_query_results[i];
-		int shape_idx = space->intersection_query_subindex_results[i];
+		const CollisionObjectSW *col_obj = p_objects[i];
+		int shape_idx = p_subindices[i];
 
 		Vector3 point_A, point_B;
 		Vector3 sep_axis = p_motion.normalized();
 
 		Transform col_obj_xform = col_obj->get_transform() * col_obj->get_shape_transform(shape_idx);
 		//test initial overlap, does it collide if going all the way?
-		if (CollisionSolverSW::solve_distance(&mshape, p_xform, col_obj->get_shape(shape_idx), col_obj_xform, point_A, point_B, aabb, &sep_axis)) {
+		if (CollisionSolverSW::solve_distance(&mshape, p_xform, col_obj->get_shape(shape_idx), col_obj_xform, point_A, point_B, p_aabb, &sep_axis)) {
 			//print_line("failed motion cast (no collision)");
 			continue;
 		}
@@ -263,7 +281,7 @@ bool PhysicsDirectSpaceStateSW::cast_motion(const RID &p_shape, const Transform
 		//test initial overlap
 		sep_axis = p_motion.normalized();
 
-		if (!CollisionSolverSW::solve_distance(shape, p_xform, col_obj->get_shape(shape_idx), col_obj_xform, point_A, point_B, aabb, &sep_axis)) {
+		if (!CollisionSolverSW::solve_distance(p_shape, p_xform, col_obj->get_shape(shape_idx), col_obj_xform, point_A, point_B, p_aabb, &sep_axis)) {
 			//print_line("failed motion cast (no collision)");
 			return false;
 		}
@@ -283,7 +301,7 @@ bool PhysicsDirectSpaceStateSW::cast_motion(const RID &p_shape, const Transform
 
 			Vector3 lA, lB;
 
-			bool collided = !CollisionSolverSW::solve_distance(&mshape, p_xform, col_obj->get_shape(shape_idx), col_obj_xform, lA, lB, aabb, &sep);
+			bool collided = !CollisionSolverSW::solve_distance(&mshape, p_xform, col_obj->get_shape(shape_idx), col_obj_xform, lA, lB, p_aabb, &sep);
 
 			if (collided) {
 
@@ -325,6 +343,251 @@ bool PhysicsDirectSpaceStateSW::cast_motion(const RID &p_shape, const Transform
 	return true;
 }
 
+bool PhysicsDirectSpaceStateSW::intersect_ray(const Vector3 &p_from, const Vector3 &p_to, RayResult &r_result, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_pick_ray) {
+
+	ERR_FAIL_COND_V(space->locked, false);
+
+	int amount = space->broadphase->cull_segment(p_from, p_to, space->intersection_query_results, SpaceSW::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+
+	_SpaceSWExcludeSet exclude;
+	exclude.exclude = &p_exclude;
+
+	return _intersect_ray_culled(space->intersection_query_results, space->intersection_query_subindex_results, amount, p_from, p_to, r_result, exclude, p_collision_mask, p_pick_ray);
+}
+
+int PhysicsDirectSpaceStateSW::intersect_shape(const RID &p_shape, const Transform &p_xform, real_t p_margin, ShapeResult *r_results, int p_result_max, const Set<RID> &p_exclude, uint32_t p_collision_mask) {
+
+	if (p_result_max <= 0)
+		return 0;
+
+	ShapeSW *shape = static_cast<PhysicsServerSW *>(PhysicsServer::get_singleton())->shape_owner.get(p_shape);
+	ERR_FAIL_COND_V(!shape, 0);
+
+	AABB aabb = p_xform.xform(shape->get_aabb());
+
+	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, SpaceSW::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+
+	_SpaceSWExcludeSet exclude;
+	exclude.exclude = &p_exclude;
+
+	return _intersect_shape_culled(shape, p_xform, p_margin, space->intersection_query_results, space->intersection_query_subindex_results, amount, r_results, p_result_max, exclude, p_collision_mask);
+}
+
+bool PhysicsDirectSpaceStateSW::cast_motion(const RID &p_shape, const Transform &p_xform, const Vector3 &p_motion, real_t p_margin, real_t &p_closest_safe, real_t &p_closest_unsafe, const Set<RID> &p_exclude, uint32_t p_collision_mask, ShapeRestInfo *r_info) {
+
+	ShapeSW *shape = static_cast<PhysicsServerSW *>(PhysicsServer::get_singleton())->shape_owner.get(p_shape);
+	ERR_FAIL_COND_V(!shape, false);
+
+	AABB aabb = _cast_motion_aabb(shape, p_xform, p_motion, p_margin);
+
+	/*
+	if (p_motion!=Vector3())
+		print_line(p_motion);
+	*/
+
+	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, SpaceSW::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+
+	_SpaceSWExcludeSet exclude;
+	exclude.exclude = &p_exclude;
+
+	return _cast_motion_culled(shape, p_xform, p_motion, aabb, space->intersection_query_results, space->intersection_query_subindex_results, amount, p_closest_safe, p_closest_unsafe, exclude, p_collision_mask, r_info);
+}
+
+/* BATCHED QUERIES */
+
+// Every query culls into its own buffers, on the stack of whichever thread runs it.
+struct _SpaceSWBatch {
+
+	SpaceSW *space;
+	Mutex *cull_mutex; // only when the broad phase can't be culled from several threads at once
+	_SpaceSWExcludeSorted exclude;
+	uint32_t collision_mask;
+
+	_FORCE_INLINE_ void lock_cull() {
+		if (cull_mutex)
+			cull_mutex->lock();
+	}
+
+	_FORCE_INLINE_ void unlock_cull() {
+		if (cull_mutex)
+			cull_mutex->unlock();
+	}
+};
+
+struct _SpaceSWRayBatch : public _SpaceSWBatch {
+
+	const Vector3 *from;
+	const Vector3 *to;
+	PhysicsDirectSpaceState::RayResult *results;
+	bool *hits;
+	bool pick_ray;
+};
+
+struct _SpaceSWShapeBatch : public _SpaceSWBatch {
+
+	ShapeSW *shape;
+	const Transform *xforms;
+	real_t margin;
+	PhysicsDirectSpaceState::ShapeResult *results;
+	int result_max;
+	int *result_counts;
+};
+
+struct _SpaceSWMotionBatch : public _SpaceSWBatch {
+
+	ShapeSW *shape;
+	const Transform *xforms;
+	const Vector3 *motions;
+	real_t margin;
+	real_t *closest_safe;
+	real_t *closest_unsafe;
+};
+
+void PhysicsDirectSpaceStateSW::_intersect_ray_batch_job(void *p_batch, uint32_t p_index) {
+
+	_SpaceSWRayBatch *batch = (_SpaceSWRayBatch *)p_batch;
+
+	CollisionObjectSW *objects[SpaceSW::INTERSECTION_QUERY_MAX];
+	int subindices[SpaceSW::INTERSECTION_QUERY_MAX];
+
+	batch->lock_cull();
+	int amount = batch->space->get_broadphase()->cull_segment(batch->from[p_index], batch->to[p_index], objects, SpaceSW::INTERSECTION_QUERY_MAX, subindices);
+	batch->unlock_cull();
+
+	batch->hits[p_index] = _intersect_ray_culled(objects, subindices, amount, batch->from[p_index], batch->to[p_index], batch->results[p_index], batch->exclude, batch->collision_mask, batch->pick_ray);
+}
+
+void PhysicsDirectSpaceStateSW::_intersect_shape_batch_job(void *p_batch, uint32_t p_index) {
+
+	_SpaceSWShapeBatch *batch = (_SpaceSWShapeBatch *)p_batch;
+
+	CollisionObjectSW *objects[SpaceSW::INTERSECTION_QUERY_MAX];
+	int subindices[SpaceSW::INTERSECTION_QUERY_MAX];
+
+	const Transform &xform = batch->xforms[p_index];
+	AABB aabb = xform.xform(batch->shape->get_aabb());
+
+	batch->lock_cull();
+	int amount = batch->space->get_broadphase()->cull_aabb(aabb, objects, SpaceSW::INTERSECTION_QUERY_MAX, subindices);
+	batch->unlock_cull();
+
+	batch->result_counts[p_index] = _intersect_shape_culled(batch->shape, xform, batch->margin, objects, subindices, amount, &batch->results[p_index * batch->result_max], batch->result_max, batch->exclude, batch->collision_mask);
+}
+
+void PhysicsDirectSpaceStateSW::_cast_motion_batch_job(void *p_batch, uint32_t p_index) {
+
+	_SpaceSWMotionBatch *batch = (_SpaceSWMotionBatch *)p_batch;
+
+	CollisionObjectSW *objects[SpaceSW::INTERSECTION_QUERY_MAX];
+	int subindices[SpaceSW::INTERSECTION_QUERY_MAX];
+
+	const Transform &xform = batch->xforms[p_index];
+	const Vector3 &motion = batch->motions[p_index];
+	AABB aabb = _cast_motion_aabb(batch->shape, xform, motion, batch->margin);
+
+	batch->lock_cull();
+	int amount = batch->space->get_broadphase()->cull_aabb(aabb, objects, SpaceSW::INTERSECTION_QUERY_MAX, subindices);
+	batch->unlock_cull();
+
+	if (!_cast_motion_culled(batch->shape, xform, motion, aabb, objects, subindices, amount, batch->closest_safe[p_index], batch->closest_unsafe[p_index], batch->exclude, batch->collision_mask, NULL)) {
+		batch->closest_safe[p_index] = 0;
+		batch->closest_unsafe[p_index] = 0;
+	}
+}
+
+void PhysicsDirectSpaceStateSW::_process_batch(_SpaceSWBatch *p_batch, const Vector<RID> &p_exclude, uint32_t p_collision_mask, int p_count, JobSystem::JobFunc p_func) {
+
+	Vector<RID> exclude = p_exclude;
+	exclude.sort();
+
+	p_batch->space = space;
+	p_batch->cull_mutex = NULL;
+	p_batch->exclude.exclude = exclude.ptr();
+	p_batch->exclude.count = exclude.size();
+	p_batch->collision_mask = p_collision_mask;
+
+	JobSystem *job_system = JobSystem::get_singleton();
+
+	if (!job_system || job_system->get_thread_count() == 0 || p_count <= BATCH_QUERY_GRAIN) {
+
+		for (int i = 0; i < p_count; i++) {
+			p_func(p_batch, i);
+		}
+		return;
+	}
+
+	if (!space->get_broadphase()->is_cull_thread_safe()) {
+		p_batch->cull_mutex = Mutex::create();
+	}
+
+	job_system->parallel_for(p_count, p_func, p_batch, BATCH_QUERY_GRAIN);
+
+	if (p_batch->cull_mutex) {
+		memdelete(p_batch->cull_mutex);
+	}
+}
+
+int PhysicsDirectSpaceStateSW::intersect_ray_batch(const Vector3 *p_from, const Vector3 *p_to, int p_count, RayResult *r_results, bool *r_hits, const Vector<RID> &p_exclude, uint32_t p_collision_mask, bool p_pick_ray) {
+
+	ERR_FAIL_COND_V(space->locked, 0);
+
+	_SpaceSWRayBatch batch;
+	batch.from = p_from;
+	batch.to = p_to;
+	batch.results = r_results;
+	batch.hits = r_hits;
+	batch.pick_ray = p_pick_ray;
+
+	_process_batch(&batch, p_exclude, p_collision_mask, p_count, _intersect_ray_batch_job);
+
+	int hits = 0;
+	for (int i = 0; i < p_count; i++) {
+		if (r_hits[i])
+			hits++;
+	}
+
+	return hits;
+}
+
+void PhysicsDirectSpaceStateSW::intersect_shape_batch(const RID &p_shape, const Transform *p_xforms, int p_count, real_t p_margin, ShapeResult *r_results, int p_result_max, int *r_result_counts, const Vector<RID> &p_exclude, uint32_t p_collision_mask) {
+
+	ShapeSW *shape = static_cast<PhysicsServerSW *>(PhysicsServer::get_singleton())->shape_owner.get(p_shape);
+	ERR_FAIL_COND(!shape);
+
+	if (p_result_max <= 0) {
+		for (int i = 0; i < p_count; i++) {
+			r_result_counts[i] = 0;
+		}
+		return;
+	}
+
+	_SpaceSWShapeBatch batch;
+	batch.shape = shape;
+	batch.xforms = p_xforms;
+	batch.margin = p_margin;
+	batch.results = r_results;
+	batch.result_max = p_result_max;
+	batch.result_counts = r_result_counts;
+
+	_process_batch(&batch, p_exclude, p_collision_mask, p_count, _intersect_shape_batch_job);
+}
+
+void PhysicsDirectSpaceStateSW::cast_motion_batch(const RID &p_shape, const Transform *p_xforms, const Vector3 *p_motions, int p_count, real_t p_margin, real_t *r_closest_safe, real_t *r_closest_unsafe, const Vector<RID> &p_exclude, uint32_t p_collision_mask) {
+
+	ShapeSW *shape = static_cast<PhysicsServerSW *>(PhysicsServer::get_singleton())->shape_owner.get(p_shape);
+	ERR_FAIL_COND(!shape);
+
+	_SpaceSWMotionBatch batch;
+	batch.shape = shape;
+	batch.xforms = p_xforms;
+	batch.motions = p_motions;
+	batch.margin = p_margin;
+	batch.closest_safe = r_closest_safe;
+	batch.closest_unsafe = r_closest_unsafe;
+
+	_process_batch(&batch, p_exclude, p_collision_mask, p_count, _cast_motion_batch_job);
+}
+
 bool PhysicsDirectSpaceStateSW::collide_shape(RID p_shape, const Transform &p_shape_xform, real_t p_margin, Vector3 *r_results, int p_result_max, int &r_result_count, const Set<RID> &p_exclude, uint32_t p_collision_mask) {
 
 	if (p_result_max <= 0)
@@ -37,13 +37,26 @@
 #include "broad_phase_sw.h"
 #include "collision_object_sw.h"
 #include "hash_map.h"
+#include "os/job_system.h"
 #include "project_settings.h"
 #include "typedefs.h"
 
+struct _SpaceSWBatch;
+
 class PhysicsDirectSpaceStateSW : public PhysicsDirectSpaceState {
 
 	GDCLASS(PhysicsDirectSpaceStateSW, PhysicsDirectSpaceState);
 
+	enum {
+		BATCH_QUERY_GRAIN = 16 // queries per job, smaller batches run on the calling thread
+	};
+
+	static void _intersect_ray_batch_job(void *p_batch, uint32_t p_index);
+	static void _intersect_shape_batch_job(void *p_batch, uint32_t p_index);
+	static void _cast_motion_batch_job(void *p_batch, uint32_t p_index);
+
+	void _process_batch(_SpaceSWBatch *p_batch, const Vector<RID> &p_exclude, uint32_t p_collision_mask, int p_count, JobSystem::JobFunc p_func);
+
 public:
 	SpaceSW *space;
 
@@ -55,6 +68,10 @@ public:
 	virtual bool rest_info(RID p_shape, const Transform &p_shape_xform, real_t p_margin, ShapeRestInfo *r_info, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF);
 	virtual Vector3 get_closest_point_to_object_volume(RID p_object, const Vector3 p_point) const;
 
+	virtual int intersect_ray_batch(const Vector3 *p_from, const Vector3 *p_to, int p_count, RayResult *r_results, bool *r_hits, const Vector<RID> &p_exclude = Vector<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_pick_ray = false);
+	virtual void intersect_shape_batch(const RID &p_shape, const Transform *p_xforms, int p_count, real_t p_margin, ShapeResult *r_results, int p_result_max, int *r_result_counts, const Vector<RID> &p_exclude = Vector<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF);
+	virtual void cast_motion_batch(const RID &p_shape, const Transform *p_xforms, const Vector3 *p_motions, int p_count, real_t p_margin, real_t *r_closest_safe, real_t *r_closest_unsafe, const Vector<RID> &p_exclude = Vector<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF);
+
 	PhysicsDirectSpaceStateSW();
 };
 
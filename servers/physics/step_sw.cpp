@@ -31,6 +31,7 @@
 #include "joints_sw.h"
 
 #include "os/os.h"
+#include "project_settings.h"
 
 void StepSW::_populate_island(BodySW *p_body, BodySW **p_island, ConstraintSW **p_constraint_island) {
 
@@ -106,7 +107,7 @@ void StepSW::_solve_island(ConstraintSW *p_island, int p_iterations, real_t p_de
 	}
 }
 
-void StepSW::_check_suspend(BodySW *p_island, real_t p_delta) {
+bool StepSW::_can_island_sleep(BodySW *p_island, real_t p_delta) {
 
 	bool can_sleep = true;
 
@@ -124,9 +125,14 @@ void StepSW::_check_suspend(BodySW *p_island, real_t p_delta) {
 		b = b->get_island_next();
 	}
 
+	return can_sleep;
+}
+
+void StepSW::_check_suspend(BodySW *p_island, bool p_can_sleep) {
+
 	//put all to sleep or wake up everyoen
 
-	b = p_island;
+	BodySW *b = p_island;
 	while (b) {
 
 		if (b->get_mode() == PhysicsServer::BODY_MODE_STATIC || b->get_mode() == PhysicsServer::BODY_MODE_KINEMATIC) {
@@ -136,19 +142,98 @@ void StepSW::_check_suspend(BodySW *p_island, real_t p_delta) {
 
 		bool active = b->is_active();
 
-		if (active == can_sleep)
-			b->set_active(!can_sleep);
+		if (active == p_can_sleep)
+			b->set_active(!p_can_sleep);
 
 		b = b->get_island_next();
 	}
 }
 
+struct StepSWChunkedJob {
+
+	StepSW *step;
+	JobSystem::JobFunc func;
+	int count;
+	int chunks;
+};
+
+static void _step_sw_chunk_job(void *p_job, uint32_t p_chunk) {
+
+	StepSWChunkedJob *job = (StepSWChunkedJob *)p_job;
+	int from = (int)((int64_t)job->count * p_chunk / job->chunks);
+	int to = (int)((int64_t)job->count * (p_chunk + 1) / job->chunks);
+
+	for (int i = from; i < to; i++) {
+		job->func(job->step, i);
+	}
+}
+
+void StepSW::_process(int p_count, JobSystem::JobFunc p_func) {
+
+	JobSystem *job_system = JobSystem::get_singleton();
+
+	int threads = thread_count;
+	if (threads < 0)
+		threads = job_system ? job_system->get_thread_count() + 1 : 1;
+
+	if (!job_system || threads <= 1 || p_count <= 1) {
+
+		for (int i = 0; i < p_count; i++) {
+			p_func(this, i);
+		}
+		return;
+	}
+
+	// No more chunks than threads when limited, otherwise a few per thread so islands of uneven size balance out.
+	StepSWChunkedJob job;
+	job.step = this;
+	job.func = p_func;
+	job.count = p_count;
+	job.chunks = MIN(p_count, thread_count < 0 ? threads * 4 : threads);
+
+	job_system->parallel_for(job.chunks, _step_sw_chunk_job, &job);
+}
+
+void StepSW::_integrate_forces_job(void *p_step, uint32_t p_index) {
+
+	StepSW *step = (StepSW *)p_step;
+	step->active_bodies.get(p_index)->integrate_forces(step->step_delta);
+}
+
+void StepSW::_setup_island_job(void *p_step, uint32_t p_index) {
+
+	StepSW *step = (StepSW *)p_step;
+	step->_setup_island(step->parallel_setup_islands.get(p_index), step->step_delta);
+}
+
+void StepSW::_solve_island_job(void *p_step, uint32_t p_index) {
+
+	StepSW *step = (StepSW *)p_step;
+	//iterating each island separatedly improves cache efficiency
+	step->_solve_island(step->constraint_islands.get(p_index), step->step_iterations, step->step_delta);
+}
+
+void StepSW::_integrate_velocities_job(void *p_step, uint32_t p_index) {
+
+	StepSW *step = (StepSW *)p_step;
+	step->active_bodies.get(p_index)->integrate_velocities(step->step_delta);
+}
+
+void StepSW::_sleep_test_job(void *p_step, uint32_t p_index) {
+
+	StepSW *step = (StepSW *)p_step;
+	step->island_can_sleep[p_index] = step->_can_island_sleep(step->body_islands.get(p_index), step->step_delta);
+}
+
 void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
 
 	p_space->lock(); // can't access space during this
 
 	p_space->setup(); //update inertias, etc
 
+	step_delta = p_delta;
+	step_iterations = p_iterations;
+
 	const SelfList<BodySW>::List *body_list = &p_space->get_active_body_list();
 
 	/* INTEGRATE FORCES */
@@ -156,14 +241,21 @@ void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
 	uint64_t profile_begtime = OS::get_singleton()->get_ticks_usec();
 	uint64_t profile_endtime = 0;
 
-	int active_count = 0;
+	active_bodies.clear();
 
 	const SelfList<BodySW> *b = body_list->first();
 	while (b) {
 
-		b->self()->integrate_forces(p_delta);
+		active_bodies.push_back(b->self());
 		b = b->next();
-		active_count++;
+	}
+
+	int active_count = active_bodies.size();
+
+	_process(active_count, _integrate_forces_job);
+
+	for (int i = 0; i < active_count; i++) {
+		active_bodies[i]->commit_forces();
 	}
 
 	p_space->set_active_objects(active_count);
@@ -176,14 +268,12 @@ void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
 
 	/* GENERATE CONSTRAINT ISLANDS */
 
-	BodySW *island_list = NULL;
-	ConstraintSW *constraint_island_list = NULL;
-	b = body_list->first();
+	body_islands.clear();
+	constraint_islands.clear();
 
-	int island_count = 0;
+	for (int i = 0; i < active_count; i++) {
 
-	while (b) {
-		BodySW *body = b->self();
+		BodySW *body = active_bodies[i];
 
 		if (body->get_island_step() != _step) {
 
@@ -191,19 +281,15 @@ void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
 			ConstraintSW *constraint_island = NULL;
 			_populate_island(body, &island, &constraint_island);
 
-			island->set_island_list_next(island_list);
-			island_list = island;
+			body_islands.push_back(island);
 
 			if (constraint_island) {
-				constraint_island->set_island_list_next(constraint_island_list);
-				constraint_island_list = constraint_island;
-				island_count++;
+				constraint_islands.push_back(constraint_island);
 			}
 		}
-		b = b->next();
 	}
 
-	p_space->set_island_count(island_count);
+	p_space->set_island_count(constraint_islands.size());
 
 	const SelfList<AreaSW>::List &aml = p_space->get_moved_area_list();
 
@@ -215,8 +301,7 @@ void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
 				continue;
 			c->set_island_step(_step);
 			c->set_island_next(NULL);
-			c->set_island_list_next(constraint_island_list);
-			constraint_island_list = c;
+			constraint_islands.push_back(c);
 		}
 		p_space->area_remove_from_moved_list((SelfList<AreaSW> *)aml.first()); //faster to remove here
 	}
@@ -231,12 +316,26 @@ void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
 	/* SETUP CONSTRAINT ISLANDS */
 
 	{
-		ConstraintSW *ci = constraint_island_list;
-		while (ci) {
+		// Islands touching shared objects are set up here in order, the rest in parallel.
+		parallel_setup_islands.clear();
+
+		for (int i = 0; i < constraint_islands.size(); i++) {
+
+			ConstraintSW *island = constraint_islands[i];
+
+			bool parallel = true;
+			for (ConstraintSW *ci = island; ci && parallel; ci = ci->get_island_next()) {
+				parallel = ci->can_setup_in_parallel();
+			}
 
-			_setup_island(ci, p_delta);
-			ci = ci->get_island_list_next();
+			if (parallel) {
+				parallel_setup_islands.push_back(island);
+			} else {
+				_setup_island(island, p_delta);
+			}
 		}
+
+		_process(parallel_setup_islands.size(), _setup_island_job);
 	}
 
 	{ //profile
@@ -247,14 +346,7 @@ void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
 
 	/* SOLVE CONSTRAINT ISLANDS */
 
-	{
-		ConstraintSW *ci = constraint_island_list;
-		while (ci) {
-			//iterating each island separatedly improves cache efficiency
-			_solve_island(ci, p_iterations, p_delta);
-			ci = ci->get_island_list_next();
-		}
-	}
+	_process(constraint_islands.size(), _solve_island_job);
 
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
@@ -264,22 +356,28 @@ void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
 
 	/* INTEGRATE VELOCITIES */
 
+	active_bodies.clear();
+
 	b = body_list->first();
 	while (b) {
-		const SelfList<BodySW> *n = b->next();
-		b->self()->integrate_velocities(p_delta);
-		b = n;
+
+		active_bodies.push_back(b->self());
+		b = b->next();
+	}
+
+	_process(active_bodies.size(), _integrate_velocities_job);
+
+	for (int i = 0; i < active_bodies.size(); i++) {
+		active_bodies[i]->commit_velocities();
 	}
 
 	/* SLEEP / WAKE UP ISLANDS */
 
-	{
-		BodySW *bi = island_list;
-		while (bi) {
+	island_can_sleep.resize(body_islands.size());
+	_process(body_islands.size(), _sleep_test_job);
 
-			_check_suspend(bi, p_delta);
-			bi = bi->get_island_list_next();
-		}
+	for (int i = 0; i < body_islands.size(); i++) {
+		_check_suspend(body_islands[i], island_can_sleep[i]);
 	}
 
 	{ //profile
@@ -291,9 +389,28 @@ void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
 	p_space->update();
 	p_space->unlock();
 	_step++;
+
+	active_bodies.reset();
+	body_islands.reset();
+	constraint_islands.reset();
+	parallel_setup_islands.reset();
+	island_can_sleep.reset();
+	step_arena.reset();
 }
 
-StepSW::StepSW() {
+StepSW::StepSW() :
+		active_bodies(&step_arena),
+		body_islands(&step_arena),
+		constraint_islands(&step_arena),
+		parallel_setup_islands(&step_arena),
+		island_can_sleep(&step_arena) {
 
 	_step = 1;
+
+	// -1 uses every thread of the job system, 1 or 0 keeps the whole step on the physics thread.
+	thread_count = GLOBAL_DEF("physics/3d/thread_count", -1);
+	ProjectSettings::get_singleton()->set_custom_property_info("physics/3d/thread_count", PropertyInfo(Variant::INT, "physics/3d/thread_count", PROPERTY_HINT_RANGE, "-1,64,1"));
+
+	step_delta = 0;
+	step_iterations = 0;
 }
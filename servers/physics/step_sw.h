@@ -30,16 +30,41 @@
 #ifndef STEP_SW_H
 #define STEP_SW_H
 
+#include "frame_arena.h"
+#include "os/job_system.h"
 #include "space_sw.h"
 
 class StepSW {
 
 	uint64_t _step;
 
+	// Islands share no dynamic bodies, so each one is processed by a single thread and the
+	// results don't depend on how many threads are used.
+	int thread_count;
+	real_t step_delta;
+	int step_iterations;
+
+	// scratch data of the step, reset when it ends
+	FrameArena step_arena;
+	ArenaVector<BodySW *> active_bodies;
+	ArenaVector<BodySW *> body_islands;
+	ArenaVector<ConstraintSW *> constraint_islands;
+	ArenaVector<ConstraintSW *> parallel_setup_islands;
+	ArenaVector<uint8_t> island_can_sleep;
+
 	void _populate_island(BodySW *p_body, BodySW **p_island, ConstraintSW **p_constraint_island);
 	void _setup_island(ConstraintSW *p_island, real_t p_delta);
 	void _solve_island(ConstraintSW *p_island, int p_iterations, real_t p_delta);
-	void _check_suspend(BodySW *p_island, real_t p_delta);
+	bool _can_island_sleep(BodySW *p_island, real_t p_delta);
+	void _check_suspend(BodySW *p_island, bool p_can_sleep);
+
+	void _process(int p_count, JobSystem::JobFunc p_func);
+
+	static void _integrate_forces_job(void *p_step, uint32_t p_index);
+	static void _setup_island_job(void *p_step, uint32_t p_index);
+	static void _solve_island_job(void *p_step, uint32_t p_index);
+	static void _integrate_velocities_job(void *p_step, uint32_t p_index);
+	static void _sleep_test_job(void *p_step, uint32_t p_index);
 
 public:
 	void step(SpaceSW *p_space, real_t p_delta, int p_iterations);
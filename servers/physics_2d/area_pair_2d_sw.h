@@ -45,6 +45,7 @@ class AreaPair2DSW : public Constraint2DSW {
 public:
 	bool setup(real_t p_step);
 	void solve(real_t p_step);
+	bool can_setup_in_parallel() const { return false; } // areas track bodies for all islands
 
 	AreaPair2DSW(Body2DSW *p_body, int p_body_shape, Area2DSW *p_area, int p_area_shape);
 	~AreaPair2DSW();
@@ -61,6 +62,7 @@ class Area2Pair2DSW : public Constraint2DSW {
 public:
 	bool setup(real_t p_step);
 	void solve(real_t p_step);
+	bool can_setup_in_parallel() const { return false; } // areas track bodies for all islands
 
 	Area2Pair2DSW(Area2DSW *p_area_a, int p_shape_a, Area2DSW *p_area_b, int p_shape_b);
 	~Area2Pair2DSW();
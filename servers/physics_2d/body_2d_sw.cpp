@@ -523,7 +523,8 @@ void Body2DSW::integrate_forces(real_t p_step) {
 	biased_linear_velocity = Vector2();
 
 	if (do_motion) { //shapes temporarily extend for raycast
-		_update_shapes_with_motion(motion);
+		pending_motion = motion;
+		pending_motion_update = true;
 	}
 
 	// damp_area=NULL; // clear the area, so it is set in the next frame
@@ -531,20 +532,26 @@ void Body2DSW::integrate_forces(real_t p_step) {
 	contact_count = 0;
 }
 
+void Body2DSW::commit_forces() {
+
+	if (!pending_motion_update)
+		return;
+
+	_update_shapes_with_motion(pending_motion);
+	pending_motion_update = false;
+}
+
 void Body2DSW::integrate_velocities(real_t p_step) {
 
 	if (mode == Physics2DServer::BODY_MODE_STATIC)
 		return;
 
-	if (fi_callback)
-		get_space()->body_add_to_state_query_list(&direct_state_query_list);
-
 	if (mode == Physics2DServer::BODY_MODE_KINEMATIC) {
 
 		_set_transform(new_transform, false);
 		_set_inv_transform(new_transform.affine_inverse());
 		if (contacts.size() == 0 && linear_velocity == Vector2() && angular_velocity == 0)
-			set_active(false); //stopped moving, deactivate
+			pending_deactivation = true; //stopped moving, deactivate
 		return;
 	}
 
@@ -554,8 +561,9 @@ void Body2DSW::integrate_velocities(real_t p_step) {
 	real_t angle = get_transform().get_rotation() + total_angular_velocity * p_step;
 	Vector2 pos = get_transform().get_origin() + total_linear_velocity * p_step;
 
-	_set_transform(Transform2D(angle, pos), continuous_cd_mode == Physics2DServer::CCD_MODE_DISABLED);
+	_set_transform(Transform2D(angle, pos), false);
 	_set_inv_transform(get_transform().inverse());
+	pending_shape_update = continuous_cd_mode == Physics2DServer::CCD_MODE_DISABLED;
 
 	if (continuous_cd_mode != Physics2DServer::CCD_MODE_DISABLED)
 		new_transform = get_transform();
@@ -563,6 +571,25 @@ void Body2DSW::integrate_velocities(real_t p_step) {
 	//_update_inertia_tensor();
 }
 
+void Body2DSW::commit_velocities() {
+
+	if (mode == Physics2DServer::BODY_MODE_STATIC)
+		return;
+
+	if (fi_callback)
+		get_space()->body_add_to_state_query_list(&direct_state_query_list);
+
+	if (pending_shape_update) {
+		_update_shapes();
+		pending_shape_update = false;
+	}
+
+	if (pending_deactivation) {
+		set_active(false);
+		pending_deactivation = false;
+	}
+}
+
 void Body2DSW::wakeup_neighbours() {
 
 	for (Map<Constraint2DSW *, int>::Element *E = constraint_map.front(); E; E = E->next()) {
@@ -685,6 +712,10 @@ Body2DSW::Body2DSW() :
 	continuous_cd_mode = Physics2DServer::CCD_MODE_DISABLED;
 	can_sleep = false;
 	fi_callback = NULL;
+
+	pending_motion_update = false;
+	pending_shape_update = false;
+	pending_deactivation = false;
 }
 
 Body2DSW::~Body2DSW() {
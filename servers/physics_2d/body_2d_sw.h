@@ -124,6 +124,12 @@ class Body2DSW : public CollisionObject2DSW {
 
 	ForceIntegrationCallback *fi_callback;
 
+	// Changes to the space left by the integration, applied by commit_forces() and commit_velocities().
+	Vector2 pending_motion;
+	bool pending_motion_update;
+	bool pending_shape_update;
+	bool pending_deactivation;
+
 	uint64_t island_step;
 	Body2DSW *island_next;
 	Body2DSW *island_list_next;
@@ -255,8 +261,12 @@ public:
 	_FORCE_INLINE_ real_t get_linear_damp() const { return linear_damp; }
 	_FORCE_INLINE_ real_t get_angular_damp() const { return angular_damp; }
 
+	// Integration only touches the body, so bodies can be integrated from several threads.
+	// The commits update the space and must then run on a single thread, in body order.
 	void integrate_forces(real_t p_step);
+	void commit_forces();
 	void integrate_velocities(real_t p_step);
+	void commit_velocities();
 
 	_FORCE_INLINE_ Vector2 get_motion() const {
 
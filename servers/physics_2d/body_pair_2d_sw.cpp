@@ -500,6 +500,20 @@ void BodyPair2DSW::solve(real_t p_step) {
 	}
 }
 
+bool BodyPair2DSW::can_setup_in_parallel() const {
+
+	if (space->is_debugging_contacts())
+		return false;
+
+	// static and kinematic bodies belong to no island, so contacts reported to them are shared
+	if (A->get_mode() <= Physics2DServer::BODY_MODE_KINEMATIC && A->can_report_contacts())
+		return false;
+	if (B->get_mode() <= Physics2DServer::BODY_MODE_KINEMATIC && B->can_report_contacts())
+		return false;
+
+	return true;
+}
+
 BodyPair2DSW::BodyPair2DSW(Body2DSW *p_A, int p_shape_A, Body2DSW *p_B, int p_shape_B) :
 		Constraint2DSW(_arr, 2) {
 
@@ -87,6 +87,7 @@ class BodyPair2DSW : public Constraint2DSW {
 public:
 	bool setup(real_t p_step);
 	void solve(real_t p_step);
+	bool can_setup_in_parallel() const;
 
 	BodyPair2DSW(Body2DSW *p_A, int p_shape_A, Body2DSW *p_B, int p_shape_B);
 	~BodyPair2DSW();
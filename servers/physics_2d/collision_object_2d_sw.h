@@ -74,9 +74,8 @@ private:
 	uint32_t collision_layer;
 	bool _static;
 
-	void _update_shapes();
-
 protected:
+	void _update_shapes();
 	void _update_shapes_with_motion(const Vector2 &p_motion);
 	void _unregister_shapes();
 
@@ -39,7 +39,23 @@ void Physics2DServerWrapMT::thread_exit() {
 void Physics2DServerWrapMT::thread_step(real_t p_delta) {
 
 	physics_2d_server->step(p_delta);
-	step_sem->post();
+	if (!overlap_step)
+		step_sem->post();
+}
+
+void Physics2DServerWrapMT::thread_park() {
+
+	parking = true;
+}
+
+void Physics2DServerWrapMT::_park_thread() {
+
+	// everything queued before is done once the thread parks, then the server belongs to this thread
+	command_queue.push(this, &Physics2DServerWrapMT::thread_park);
+	park_sem->wait();
+
+	server_thread = main_thread;
+	parked = true;
 }
 
 void Physics2DServerWrapMT::_thread_callback(void *_instance) {
@@ -51,7 +67,8 @@ void Physics2DServerWrapMT::_thread_callback(void *_instance) {
 
 void Physics2DServerWrapMT::thread_loop() {
 
-	server_thread = Thread::get_caller_id();
+	thread_id = Thread::get_caller_id();
+	server_thread = thread_id;
 
 	OS::get_singleton()->make_rendering_thread();
 
@@ -62,6 +79,13 @@ void Physics2DServerWrapMT::thread_loop() {
 	while (!exit) {
 		// flush commands one by one, until exit is requested
 		command_queue.wait_and_flush_one();
+
+		if (parking) {
+			// hand the server to the main thread until the next step
+			parking = false;
+			park_sem->post();
+			resume_sem->wait();
+		}
 	}
 
 	command_queue.flush_all(); // flush all
@@ -73,7 +97,17 @@ void Physics2DServerWrapMT::thread_loop() {
 
 void Physics2DServerWrapMT::step(real_t p_step) {
 
-	if (create_thread) {
+	if (overlap_step) {
+
+		if (!parked)
+			_park_thread(); //previous step was not synced
+
+		command_queue.flush_all(); //flush all pending from other threads while the server is still ours
+		server_thread = thread_id;
+		parked = false;
+		command_queue.push(this, &Physics2DServerWrapMT::thread_step, p_step);
+		resume_sem->post();
+	} else if (create_thread) {
 
 		command_queue.push(this, &Physics2DServerWrapMT::thread_step, p_step);
 	} else {
@@ -85,7 +119,10 @@ void Physics2DServerWrapMT::step(real_t p_step) {
 
 void Physics2DServerWrapMT::sync() {
 
-	if (step_sem) {
+	if (overlap_step) {
+		if (!parked)
+			_park_thread(); //waits for the step and for the calls queued while it ran
+	} else if (step_sem) {
 		if (first_frame)
 			first_frame = false;
 		else
@@ -109,6 +146,10 @@ void Physics2DServerWrapMT::init() {
 	if (create_thread) {
 
 		step_sem = Semaphore::create();
+		if (overlap_step) {
+			park_sem = Semaphore::create();
+			resume_sem = Semaphore::create();
+		}
 		//OS::get_singleton()->release_rendering_thread();
 		if (create_thread) {
 			thread = Thread::create(_thread_callback, this);
@@ -116,6 +157,9 @@ void Physics2DServerWrapMT::init() {
 		while (!step_thread_up) {
 			OS::get_singleton()->delay_usec(1000);
 		}
+		if (overlap_step) {
+			_park_thread();
+		}
 	} else {
 
 		physics_2d_server->init();
@@ -126,7 +170,13 @@ void Physics2DServerWrapMT::finish() {
 
 	if (thread) {
 
-		command_queue.push(this, &Physics2DServerWrapMT::thread_exit);
+		if (parked) {
+			exit = true;
+			server_thread = thread_id;
+			resume_sem->post();
+		} else {
+			command_queue.push(this, &Physics2DServerWrapMT::thread_exit);
+		}
 		Thread::wait_to_finish(thread);
 		memdelete(thread);
 
@@ -149,15 +199,25 @@ void Physics2DServerWrapMT::finish() {
 
 	if (step_sem)
 		memdelete(step_sem);
+	if (park_sem)
+		memdelete(park_sem);
+	if (resume_sem)
+		memdelete(resume_sem);
 }
 
-Physics2DServerWrapMT::Physics2DServerWrapMT(Physics2DServer *p_contained, bool p_create_thread) :
+Physics2DServerWrapMT::Physics2DServerWrapMT(Physics2DServer *p_contained, bool p_create_thread, bool p_overlap_step) :
 		command_queue(p_create_thread) {
 
 	physics_2d_server = p_contained;
 	create_thread = p_create_thread;
+	overlap_step = p_create_thread && p_overlap_step;
+	parked = false;
+	parking = false;
 	thread = NULL;
+	thread_id = 0;
 	step_sem = NULL;
+	park_sem = NULL;
+	resume_sem = NULL;
 	step_pending = 0;
 	step_thread_up = false;
 	alloc_mutex = Mutex::create();
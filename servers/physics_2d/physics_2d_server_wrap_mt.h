@@ -52,6 +52,7 @@ class Physics2DServerWrapMT : public Physics2DServer {
 
 	Thread::ID server_thread;
 	Thread::ID main_thread;
+	Thread::ID thread_id;
 	volatile bool exit;
 	Thread *thread;
 	volatile bool step_thread_up;
@@ -64,6 +65,16 @@ class Physics2DServerWrapMT : public Physics2DServer {
 
 	void thread_exit();
 
+	// When overlapping, the server thread only owns the server from step() to sync(), so the step
+	// runs along with the game's process. Outside of that the main thread calls the server directly.
+	bool overlap_step;
+	bool parked;
+	volatile bool parking;
+	Semaphore *park_sem;
+	Semaphore *resume_sem;
+	void thread_park();
+	void _park_thread();
+
 	bool first_frame;
 
 	Mutex *alloc_mutex;
@@ -296,7 +307,7 @@ public:
 		return physics_2d_server->get_process_info(p_info);
 	}
 
-	Physics2DServerWrapMT(Physics2DServer *p_contained, bool p_create_thread);
+	Physics2DServerWrapMT(Physics2DServer *p_contained, bool p_create_thread, bool p_overlap_step = false);
 	~Physics2DServerWrapMT();
 
 	template <class T>
@@ -307,8 +318,10 @@ public:
 			return memnew(T);
 		else if (tm == 1) //single saef
 			return memnew(Physics2DServerWrapMT(memnew(T), false));
-		else //single unsafe
+		else if (tm == 2) //multi threaded
 			return memnew(Physics2DServerWrapMT(memnew(T), true));
+		else //multi threaded, stepping along with process
+			return memnew(Physics2DServerWrapMT(memnew(T), true, true));
 	}
 
 #undef ServerNameWrapMT
@@ -88,9 +88,42 @@ int Physics2DDirectSpaceStateSW::intersect_point(const Vector2 &p_point, ShapeRe
 	return cc;
 }
 
-bool Physics2DDirectSpaceStateSW::intersect_ray(const Vector2 &p_from, const Vector2 &p_to, RayResult &r_result, const Set<RID> &p_exclude, uint32_t p_collision_mask) {
+// Exclude lists as the single queries get them.
+struct _Space2DSWExcludeSet {
 
-	ERR_FAIL_COND_V(space->locked, false);
+	const Set<RID> *exclude;
+
+	_FORCE_INLINE_ bool has(const CollisionObject2DSW *p_object) const { return exclude->has(p_object->get_self()); }
+};
+
+// Exclude lists of batched queries, sorted once per batch and shared by all of its queries.
+struct _Space2DSWExcludeSorted {
+
+	const RID *exclude;
+	int count;
+
+	_FORCE_INLINE_ bool has(const CollisionObject2DSW *p_object) const {
+
+		RID self = p_object->get_self();
+		int low = 0;
+		int high = count;
+		while (low < high) {
+			int middle = (low + high) / 2;
+			if (exclude[middle] < self)
+				low = middle + 1;
+			else
+				high = middle;
+		}
+
+		return low < count && exclude[low] == self;
+	}
+};
+
+// The narrow phase of the queries below works on what the broad phase culled, so that single and
+// batched queries share it while culling into different buffers.
+
+template <class E>
+static bool _intersect_ray_culled(CollisionObject2DSW **p_objects, const int *p_subindices, int p_amount, const Vector2 &p_from, const Vector2 &p_to, Physics2DDirectSpaceState::RayResult &r_result, const E &p_exclude, uint32_t p_collision_mask) {
 
 	Vector2 begin, end;
 	Vector2 normal;
@@ -98,8 +131,6 @@ bool Physics2DDirectSpaceStateSW::intersect_ray(const Vector2 &p_from, const Vec
 	end = p_to;
 	normal = (end - begin).normalized();
 
-	int amount = space->broadphase->cull_segment(begin, end, space->intersection_query_results, Space2DSW::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
-
 	//todo, create another array tha references results, compute AABBs and check closest point to ray origin, sort, and stop evaluating results when beyond first collision
 
 	bool collided = false;
@@ -108,17 +139,17 @@ bool Physics2DDirectSpaceStateSW::intersect_ray(const Vector2 &p_from, const Vec
 	const CollisionObject2DSW *res_obj;
 	real_t min_d = 1e10;
 
-	for (int i = 0; i < amount; i++) {
+	for (int i = 0; i < p_amount; i++) {
 
-		if (!_can_collide_with(space->intersection_query_results[i], p_collision_mask))
+		if (!_can_collide_with(p_objects[i], p_collision_mask))
 			continue;
 
-		if (p_exclude.has(space->intersection_query_results[i]->get_self()))
+		if (p_exclude.has(p_objects[i]))
 			continue;
 
-		const CollisionObject2DSW *col_obj = space->intersection_query_results[i];
+		const CollisionObject2DSW *col_obj = p_objects[i];
 
-		int shape_idx = space->intersection_query_subindex_results[i];
+		int shape_idx = p_subindices[i];
 		Transform2D inv_xform = col_obj->get_shape_inv_transform(shape_idx) * col_obj->get_inv_transform();
 
 		Vector2 local_from = inv_xform.xform(begin);
@@ -168,33 +199,23 @@ bool Physics2DDirectSpaceStateSW::intersect_ray(const Vector2 &p_from, const Vec
 	return true;
 }
 
-int Physics2DDirectSpaceStateSW::intersect_shape(const RID &p_shape, const Transform2D &p_xform, const Vector2 &p_motion, real_t p_margin, ShapeResult *r_results, int p_result_max, const Set<RID> &p_exclude, uint32_t p_collision_mask) {
-
-	if (p_result_max <= 0)
-		return 0;
-
-	Shape2DSW *shape = Physics2DServerSW::singletonsw->shape_owner.get(p_shape);
-	ERR_FAIL_COND_V(!shape, 0);
-
-	Rect2 aabb = p_xform.xform(shape->get_aabb());
-	aabb = aabb.grow(p_margin);
-
-	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, p_result_max, space->intersection_query_subindex_results);
+template <class E>
+static int _intersect_shape_culled(Shape2DSW *p_shape, const Transform2D &p_xform, const Vector2 &p_motion, real_t p_margin, CollisionObject2DSW **p_objects, const int *p_subindices, int p_amount, Physics2DDirectSpaceState::ShapeResult *r_results, const E &p_exclude, uint32_t p_collision_mask) {
 
 	int cc = 0;
 
-	for (int i = 0; i < amount; i++) {
+	for (int i = 0; i < p_amount; i++) {
 
-		if (!_can_collide_with(space->intersection_query_results[i], p_collision_mask))
+		if (!_can_collide_with(p_objects[i], p_collision_mask))
 			continue;
 
-		if (p_exclude.has(space->intersection_query_results[i]->get_self()))
+		if (p_exclude.has(p_objects[i]))
 			continue;
 
-		const CollisionObject2DSW *col_obj = space->intersection_query_results[i];
-		int shape_idx = space->intersection_query_subindex_results[i];
+		const CollisionObject2DSW *col_obj = p_objects[i];
+		int shape_idx = p_subindices[i];
 
-		if (!CollisionSolver2DSW::solve(shape, p_xform, p_motion, col_obj->get_shape(shape_idx), col_obj->get_transform() * col_obj->get_shape_transform(shape_idx), Vector2(), NULL, NULL, NULL, p_margin))
+		if (!CollisionSolver2DSW::solve(p_shape, p_xform, p_motion, col_obj->get_shape(shape_idx), col_obj->get_transform() * col_obj->get_shape_transform(shape_idx), Vector2(), NULL, NULL, NULL, p_margin))
 			continue;
 
 		r_results[cc].collider_id = col_obj->get_instance_id();
@@ -210,35 +231,31 @@ int Physics2DDirectSpaceStateSW::intersect_shape(const RID &p_shape, const Trans
 	return cc;
 }
 
-bool Physics2DDirectSpaceStateSW::cast_motion(const RID &p_shape, const Transform2D &p_xform, const Vector2 &p_motion, real_t p_margin, real_t &p_closest_safe, real_t &p_closest_unsafe, const Set<RID> &p_exclude, uint32_t p_collision_mask) {
-
-	Shape2DSW *shape = Physics2DServerSW::singletonsw->shape_owner.get(p_shape);
-	ERR_FAIL_COND_V(!shape, false);
+static Rect2 _cast_motion_aabb(const Shape2DSW *p_shape, const Transform2D &p_xform, const Vector2 &p_motion, real_t p_margin) {
 
-	Rect2 aabb = p_xform.xform(shape->get_aabb());
+	Rect2 aabb = p_xform.xform(p_shape->get_aabb());
 	aabb = aabb.merge(Rect2(aabb.position + p_motion, aabb.size)); //motion
 	aabb = aabb.grow(p_margin);
 
-	/*
-	if (p_motion!=Vector2())
-		print_line(p_motion);
-	*/
+	return aabb;
+}
 
-	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, Space2DSW::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+template <class E>
+static bool _cast_motion_culled(Shape2DSW *p_shape, const Transform2D &p_xform, const Vector2 &p_motion, real_t p_margin, CollisionObject2DSW **p_objects, const int *p_subindices, int p_amount, real_t &p_closest_safe, real_t &p_closest_unsafe, const E &p_exclude, uint32_t p_collision_mask) {
 
 	real_t best_safe = 1;
 	real_t best_unsafe = 1;
 
-	for (int i = 0; i < amount; i++) {
+	for (int i = 0; i < p_amount; i++) {
 
-		if (!_can_collide_with(space->intersection_query_results[i], p_collision_mask))
+		if (!_can_collide_with(p_objects[i], p_collision_mask))
 			continue;
 
-		if (p_exclude.has(space->intersection_query_results[i]->get_self()))
+		if (p_exclude.has(p_objects[i]))
 			continue; //ignore excluded
 
-		const CollisionObject2DSW *col_obj = space->intersection_query_results[i];
-		int shape_idx = space->intersection_query_subindex_results[i];
+		const CollisionObject2DSW *col_obj = p_objects[i];
+		int shape_idx = p_subindices[i];
 
 		/*if (col_obj->get_type()==CollisionObject2DSW::TYPE_BODY) {
 
@@ -251,12 +268,12 @@ bool Physics2DDirectSpaceStateSW::cast_motion(const RID &p_shape, const Transfor
 
 		Transform2D col_obj_xform = col_obj->get_transform() * col_obj->get_shape_transform(shape_idx);
 		//test initial overlap, does it collide if going all the way?
-		if (!CollisionSolver2DSW::solve(shape, p_xform, p_motion, col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), NULL, NULL, NULL, p_margin)) {
+		if (!CollisionSolver2DSW::solve(p_shape, p_xform, p_motion, col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), NULL, NULL, NULL, p_margin)) {
 			continue;
 		}
 
 		//test initial overlap
-		if (CollisionSolver2DSW::solve(shape, p_xform, Vector2(), col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), NULL, NULL, NULL, p_margin)) {
+		if (CollisionSolver2DSW::solve(p_shape, p_xform, Vector2(), col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), NULL, NULL, NULL, p_margin)) {
 
 			return false;
 		}
@@ -271,7 +288,7 @@ bool Physics2DDirectSpaceStateSW::cast_motion(const RID &p_shape, const Transfor
 			real_t ofs = (low + hi) * 0.5;
 
 			Vector2 sep = mnormal; //important optimization for this to work fast enough
-			bool collided = CollisionSolver2DSW::solve(shape, p_xform, p_motion * ofs, col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), NULL, NULL, &sep, p_margin);
+			bool collided = CollisionSolver2DSW::solve(p_shape, p_xform, p_motion * ofs, col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), NULL, NULL, &sep, p_margin);
 
 			if (collided) {
 
@@ -294,6 +311,254 @@ bool Physics2DDirectSpaceStateSW::cast_motion(const RID &p_shape, const Transfor
 	return true;
 }
 
+bool Physics2DDirectSpaceStateSW::intersect_ray(const Vector2 &p_from, const Vector2 &p_to, RayResult &r_result, const Set<RID> &p_exclude, uint32_t p_collision_mask) {
+
+	ERR_FAIL_COND_V(space->locked, false);
+
+	int amount = space->broadphase->cull_segment(p_from, p_to, space->intersection_query_results, Space2DSW::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+
+	_Space2DSWExcludeSet exclude;
+	exclude.exclude = &p_exclude;
+
+	return _intersect_ray_culled(space->intersection_query_results, space->intersection_query_subindex_results, amount, p_from, p_to, r_result, exclude, p_collision_mask);
+}
+
+int Physics2DDirectSpaceStateSW::intersect_shape(const RID &p_shape, const Transform2D &p_xform, const Vector2 &p_motion, real_t p_margin, ShapeResult *r_results, int p_result_max, const Set<RID> &p_exclude, uint32_t p_collision_mask) {
+
+	if (p_result_max <= 0)
+		return 0;
+
+	Shape2DSW *shape = Physics2DServerSW::singletonsw->shape_owner.get(p_shape);
+	ERR_FAIL_COND_V(!shape, 0);
+
+	Rect2 aabb = p_xform.xform(shape->get_aabb());
+	aabb = aabb.grow(p_margin);
+
+	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, p_result_max, space->intersection_query_subindex_results);
+
+	_Space2DSWExcludeSet exclude;
+	exclude.exclude = &p_exclude;
+
+	return _intersect_shape_culled(shape, p_xform, p_motion, p_margin, space->intersection_query_results, space->intersection_query_subindex_results, amount, r_results, exclude, p_collision_mask);
+}
+
+bool Physics2DDirectSpaceStateSW::cast_motion(const RID &p_shape, const Transform2D &p_xform, const Vector2 &p_motion, real_t p_margin, real_t &p_closest_safe, real_t &p_closest_unsafe, const Set<RID> &p_exclude, uint32_t p_collision_mask) {
+
+	Shape2DSW *shape = Physics2DServerSW::singletonsw->shape_owner.get(p_shape);
+	ERR_FAIL_COND_V(!shape, false);
+
+	Rect2 aabb = _cast_motion_aabb(shape, p_xform, p_motion, p_margin);
+
+	/*
+	if (p_motion!=Vector2())
+		print_line(p_motion);
+	*/
+
+	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, Space2DSW::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+
+	_Space2DSWExcludeSet exclude;
+	exclude.exclude = &p_exclude;
+
+	return _cast_motion_culled(shape, p_xform, p_motion, p_margin, space->intersection_query_results, space->intersection_query_subindex_results, amount, p_closest_safe, p_closest_unsafe, exclude, p_collision_mask);
+}
+
+/* BATCHED QUERIES */
+
+// Every query culls into its own buffers, on the stack of whichever thread runs it.
+struct _Space2DSWBatch {
+
+	Space2DSW *space;
+	Mutex *cull_mutex; // only when the broad phase can't be culled from several threads at once
+	_Space2DSWExcludeSorted exclude;
+	uint32_t collision_mask;
+
+	_FORCE_INLINE_ void lock_cull() {
+		if (cull_mutex)
+			cull_mutex->lock();
+	}
+
+	_FORCE_INLINE_ void unlock_cull() {
+		if (cull_mutex)
+			cull_mutex->unlock();
+	}
+};
+
+struct _Space2DSWRayBatch : public _Space2DSWBatch {
+
+	const Vector2 *from;
+	const Vector2 *to;
+	Physics2DDirectSpaceState::RayResult *results;
+	bool *hits;
+};
+
+struct _Space2DSWShapeBatch : public _Space2DSWBatch {
+
+	Shape2DSW *shape;
+	const Transform2D *xforms;
+	Vector2 motion;
+	real_t margin;
+	Physics2DDirectSpaceState::ShapeResult *results;
+	int result_max;
+	int *result_counts;
+};
+
+struct _Space2DSWMotionBatch : public _Space2DSWBatch {
+
+	Shape2DSW *shape;
+	const Transform2D *xforms;
+	const Vector2 *motions;
+	real_t margin;
+	real_t *closest_safe;
+	real_t *closest_unsafe;
+};
+
+void Physics2DDirectSpaceStateSW::_intersect_ray_batch_job(void *p_batch, uint32_t p_index) {
+
+	_Space2DSWRayBatch *batch = (_Space2DSWRayBatch *)p_batch;
+
+	CollisionObject2DSW *objects[Space2DSW::INTERSECTION_QUERY_MAX];
+	int subindices[Space2DSW::INTERSECTION_QUERY_MAX];
+
+	batch->lock_cull();
+	int amount = batch->space->get_broadphase()->cull_segment(batch->from[p_index], batch->to[p_index], objects, Space2DSW::INTERSECTION_QUERY_MAX, subindices);
+	batch->unlock_cull();
+
+	batch->hits[p_index] = _intersect_ray_culled(objects, subindices, amount, batch->from[p_index], batch->to[p_index], batch->results[p_index], batch->exclude, batch->collision_mask);
+}
+
+void Physics2DDirectSpaceStateSW::_intersect_shape_batch_job(void *p_batch, uint32_t p_index) {
+
+	_Space2DSWShapeBatch *batch = (_Space2DSWShapeBatch *)p_batch;
+
+	CollisionObject2DSW *objects[Space2DSW::INTERSECTION_QUERY_MAX];
+	int subindices[Space2DSW::INTERSECTION_QUERY_MAX];
+
+	const Transform2D &xform = batch->xforms[p_index];
+	Rect2 aabb = xform.xform(batch->shape->get_aabb());
+	aabb = aabb.grow(batch->margin);
+
+	// as with single queries, no more objects are culled than results fit
+	batch->lock_cull();
+	int amount = batch->space->get_broadphase()->cull_aabb(aabb, objects, MIN(batch->result_max, (int)Space2DSW::INTERSECTION_QUERY_MAX), subindices);
+	batch->unlock_cull();
+
+	batch->result_counts[p_index] = _intersect_shape_culled(batch->shape, xform, batch->motion, batch->margin, objects, subindices, amount, &batch->results[p_index * batch->result_max], batch->exclude, batch->collision_mask);
+}
+
+void Physics2DDirectSpaceStateSW::_cast_motion_batch_job(void *p_batch, uint32_t p_index) {
+
+	_Space2DSWMotionBatch *batch = (_Space2DSWMotionBatch *)p_batch;
+
+	CollisionObject2DSW *objects[Space2DSW::INTERSECTION_QUERY_MAX];
+	int subindices[Space2DSW::INTERSECTION_QUERY_MAX];
+
+	const Transform2D &xform = batch->xforms[p_index];
+	const Vector2 &motion = batch->motions[p_index];
+	Rect2 aabb = _cast_motion_aabb(batch->shape, xform, motion, batch->margin);
+
+	batch->lock_cull();
+	int amount = batch->space->get_broadphase()->cull_aabb(aabb, objects, Space2DSW::INTERSECTION_QUERY_MAX, subindices);
+	batch->unlock_cull();
+
+	if (!_cast_motion_culled(batch->shape, xform, motion, batch->margin, objects, subindices, amount, batch->closest_safe[p_index], batch->closest_unsafe[p_index], batch->exclude, batch->collision_mask)) {
+		batch->closest_safe[p_index] = 0;
+		batch->closest_unsafe[p_index] = 0;
+	}
+}
+
+void Physics2DDirectSpaceStateSW::_process_batch(_Space2DSWBatch *p_batch, const Vector<RID> &p_exclude, uint32_t p_collision_mask, int p_count, JobSystem::JobFunc p_func) {
+
+	Vector<RID> exclude = p_exclude;
+	exclude.sort();
+
+	p_batch->space = space;
+	p_batch->cull_mutex = NULL;
+	p_batch->exclude.exclude = exclude.ptr();
+	p_batch->exclude.count = exclude.size();
+	p_batch->collision_mask = p_collision_mask;
+
+	JobSystem *job_system = JobSystem::get_singleton();
+
+	if (!job_system || job_system->get_thread_count() == 0 || p_count <= BATCH_QUERY_GRAIN) {
+
+		for (int i = 0; i < p_count; i++) {
+			p_func(p_batch, i);
+		}
+		return;
+	}
+
+	if (!space->get_broadphase()->is_cull_thread_safe()) {
+		p_batch->cull_mutex = Mutex::create();
+	}
+
+	job_system->parallel_for(p_count, p_func, p_batch, BATCH_QUERY_GRAIN);
+
+	if (p_batch->cull_mutex) {
+		memdelete(p_batch->cull_mutex);
+	}
+}
+
+int Physics2DDirectSpaceStateSW::intersect_ray_batch(const Vector2 *p_from, const Vector2 *p_to, int p_count, RayResult *r_results, bool *r_hits, const Vector<RID> &p_exclude, uint32_t p_collision_mask) {
+
+	ERR_FAIL_COND_V(space->locked, 0);
+
+	_Space2DSWRayBatch batch;
+	batch.from = p_from;
+	batch.to = p_to;
+	batch.results = r_results;
+	batch.hits = r_hits;
+
+	_process_batch(&batch, p_exclude, p_collision_mask, p_count, _intersect_ray_batch_job);
+
+	int hits = 0;
+	for (int i = 0; i < p_count; i++) {
+		if (r_hits[i])
+			hits++;
+	}
+
+	return hits;
+}
+
+void Physics2DDirectSpaceStateSW::intersect_shape_batch(const RID &p_shape, const Transform2D *p_xforms, int p_count, const Vector2 &p_motion, real_t p_margin, ShapeResult *r_results, int p_result_max, int *r_result_counts, const Vector<RID> &p_exclude, uint32_t p_collision_mask) {
+
+	Shape2DSW *shape = Physics2DServerSW::singletonsw->shape_owner.get(p_shape);
+	ERR_FAIL_COND(!shape);
+
+	if (p_result_max <= 0) {
+		for (int i = 0; i < p_count; i++) {
+			r_result_counts[i] = 0;
+		}
+		return;
+	}
+
+	_Space2DSWShapeBatch batch;
+	batch.shape = shape;
+	batch.xforms = p_xforms;
+	batch.motion = p_motion;
+	batch.margin = p_margin;
+	batch.results = r_results;
+	batch.result_max = p_result_max;
+	batch.result_counts = r_result_counts;
+
+	_process_batch(&batch, p_exclude, p_collision_mask, p_count, _intersect_shape_batch_job);
+}
+
+void Physics2DDirectSpaceStateSW::cast_motion_batch(const RID &p_shape, const Transform2D *p_xforms, const Vector2 *p_motions, int p_count, real_t p_margin, real_t *r_closest_safe, real_t *r_closest_unsafe, const Vector<RID> &p_exclude, uint32_t p_collision_mask) {
+
+	Shape2DSW *shape = Physics2DServerSW::singletonsw->shape_owner.get(p_shape);
+	ERR_FAIL_COND(!shape);
+
+	_Space2DSWMotionBatch batch;
+	batch.shape = shape;
+	batch.xforms = p_xforms;
+	batch.motions = p_motions;
+	batch.margin = p_margin;
+	batch.closest_safe = r_closest_safe;
+	batch.closest_unsafe = r_closest_unsafe;
+
+	_process_batch(&batch, p_exclude, p_collision_mask, p_count, _cast_motion_batch_job);
+}
+
 bool Physics2DDirectSpaceStateSW::collide_shape(RID p_shape, const Transform2D &p_shape_xform, const Vector2 &p_motion, real_t p_margin, Vector2 *r_results, int p_result_max, int &r_result_count, const Set<RID> &p_exclude, uint32_t p_collision_mask) {
 
 	if (p_result_max <= 0)
@@ -37,13 +37,26 @@
 #include "broad_phase_2d_sw.h"
 #include "collision_object_2d_sw.h"
 #include "hash_map.h"
+#include "os/job_system.h"
 #include "project_settings.h"
 #include "typedefs.h"
 
+struct _Space2DSWBatch;
+
 class Physics2DDirectSpaceStateSW : public Physics2DDirectSpaceState {
 
 	GDCLASS(Physics2DDirectSpaceStateSW, Physics2DDirectSpaceState);
 
+	enum {
+		BATCH_QUERY_GRAIN = 16 // queries per job, smaller batches run on the calling thread
+	};
+
+	static void _intersect_ray_batch_job(void *p_batch, uint32_t p_index);
+	static void _intersect_shape_batch_job(void *p_batch, uint32_t p_index);
+	static void _cast_motion_batch_job(void *p_batch, uint32_t p_index);
+
+	void _process_batch(_Space2DSWBatch *p_batch, const Vector<RID> &p_exclude, uint32_t p_collision_mask, int p_count, JobSystem::JobFunc p_func);
+
 public:
 	Space2DSW *space;
 
@@ -54,6 +67,10 @@ public:
 	virtual bool collide_shape(RID p_shape, const Transform2D &p_shape_xform, const Vector2 &p_motion, real_t p_margin, Vector2 *r_results, int p_result_max, int &r_result_count, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF);
 	virtual bool rest_info(RID p_shape, const Transform2D &p_shape_xform, const Vector2 &p_motion, real_t p_margin, ShapeRestInfo *r_info, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF);
 
+	virtual int intersect_ray_batch(const Vector2 *p_from, const Vector2 *p_to, int p_count, RayResult *r_results, bool *r_hits, const Vector<RID> &p_exclude = Vector<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF);
+	virtual void intersect_shape_batch(const RID &p_shape, const Transform2D *p_xforms, int p_count, const Vector2 &p_motion, real_t p_margin, ShapeResult *r_results, int p_result_max, int *r_result_counts, const Vector<RID> &p_exclude = Vector<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF);
+	virtual void cast_motion_batch(const RID &p_shape, const Transform2D *p_xforms, const Vector2 *p_motions, int p_count, real_t p_margin, real_t *r_closest_safe, real_t *r_closest_unsafe, const Vector<RID> &p_exclude = Vector<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF);
+
 	Physics2DDirectSpaceStateSW();
 };
 
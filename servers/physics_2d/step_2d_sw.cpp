@@ -29,6 +29,7 @@
 /*************************************************************************/
 #include "step_2d_sw.h"
 #include "os/os.h"
+#include "project_settings.h"
 
 void Step2DSW::_populate_island(Body2DSW *p_body, Body2DSW **p_island, Constraint2DSW **p_constraint_island) {
 
@@ -93,7 +94,7 @@ void Step2DSW::_solve_island(Constraint2DSW *p_island, int p_iterations, real_t
 	}
 }
 
-void Step2DSW::_check_suspend(Body2DSW *p_island, real_t p_delta) {
+bool Step2DSW::_can_island_sleep(Body2DSW *p_island, real_t p_delta) {
 
 	bool can_sleep = true;
 
@@ -111,9 +112,14 @@ void Step2DSW::_check_suspend(Body2DSW *p_island, real_t p_delta) {
 		b = b->get_island_next();
 	}
 
+	return can_sleep;
+}
+
+void Step2DSW::_check_suspend(Body2DSW *p_island, bool p_can_sleep) {
+
 	//put all to sleep or wake up everyoen
 
-	b = p_island;
+	Body2DSW *b = p_island;
 	while (b) {
 
 		if (b->get_mode() == Physics2DServer::BODY_MODE_STATIC || b->get_mode() == Physics2DServer::BODY_MODE_KINEMATIC) {
@@ -123,19 +129,102 @@ void Step2DSW::_check_suspend(Body2DSW *p_island, real_t p_delta) {
 
 		bool active = b->is_active();
 
-		if (active == can_sleep)
-			b->set_active(!can_sleep);
+		if (active == p_can_sleep)
+			b->set_active(!p_can_sleep);
 
 		b = b->get_island_next();
 	}
 }
 
+struct Step2DSWChunkedJob {
+
+	Step2DSW *step;
+	JobSystem::JobFunc func;
+	int count;
+	int chunks;
+};
+
+static void _step_2d_sw_chunk_job(void *p_job, uint32_t p_chunk) {
+
+	Step2DSWChunkedJob *job = (Step2DSWChunkedJob *)p_job;
+	int from = (int)((int64_t)job->count * p_chunk / job->chunks);
+	int to = (int)((int64_t)job->count * (p_chunk + 1) / job->chunks);
+
+	for (int i = from; i < to; i++) {
+		job->func(job->step, i);
+	}
+}
+
+void Step2DSW::_process(int p_count, JobSystem::JobFunc p_func) {
+
+	JobSystem *job_system = JobSystem::get_singleton();
+
+	int threads = thread_count;
+	if (threads < 0)
+		threads = job_system ? job_system->get_thread_count() + 1 : 1;
+
+	if (!job_system || threads <= 1 || p_count <= 1) {
+
+		for (int i = 0; i < p_count; i++) {
+			p_func(this, i);
+		}
+		return;
+	}
+
+	// No more chunks than threads when limited, otherwise a few per thread so islands of uneven size balance out.
+	Step2DSWChunkedJob job;
+	job.step = this;
+	job.func = p_func;
+	job.count = p_count;
+	job.chunks = MIN(p_count, thread_count < 0 ? threads * 4 : threads);
+
+	job_system->parallel_for(job.chunks, _step_2d_sw_chunk_job, &job);
+}
+
+void Step2DSW::_integrate_forces_job(void *p_step, uint32_t p_index) {
+
+	Step2DSW *step = (Step2DSW *)p_step;
+	step->active_bodies.get(p_index)->integrate_forces(step->step_delta);
+}
+
+void Step2DSW::_setup_island_job(void *p_step, uint32_t p_index) {
+
+	Step2DSW *step = (Step2DSW *)p_step;
+	int island = step->parallel_setup_islands.get(p_index);
+	step->island_removed_root[island] = step->_setup_island(step->constraint_islands.get(island), step->step_delta);
+}
+
+void Step2DSW::_solve_island_job(void *p_step, uint32_t p_index) {
+
+	Step2DSW *step = (Step2DSW *)p_step;
+	Constraint2DSW *island = step->constraint_islands.get(p_index);
+	if (island) {
+		//iterating each island separatedly improves cache efficiency
+		step->_solve_island(island, step->step_iterations, step->step_delta);
+	}
+}
+
+void Step2DSW::_integrate_velocities_job(void *p_step, uint32_t p_index) {
+
+	Step2DSW *step = (Step2DSW *)p_step;
+	step->active_bodies.get(p_index)->integrate_velocities(step->step_delta);
+}
+
+void Step2DSW::_sleep_test_job(void *p_step, uint32_t p_index) {
+
+	Step2DSW *step = (Step2DSW *)p_step;
+	step->island_can_sleep[p_index] = step->_can_island_sleep(step->body_islands.get(p_index), step->step_delta);
+}
+
 void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 
 	p_space->lock(); // can't access space during this
 
 	p_space->setup(); //update inertias, etc
 
+	step_delta = p_delta;
+	step_iterations = p_iterations;
+
 	const SelfList<Body2DSW>::List *body_list = &p_space->get_active_body_list();
 
 	/* INTEGRATE FORCES */
@@ -143,14 +232,21 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 	uint64_t profile_begtime = OS::get_singleton()->get_ticks_usec();
 	uint64_t profile_endtime = 0;
 
-	int active_count = 0;
+	active_bodies.clear();
 
 	const SelfList<Body2DSW> *b = body_list->first();
 	while (b) {
 
-		b->self()->integrate_forces(p_delta);
+		active_bodies.push_back(b->self());
 		b = b->next();
-		active_count++;
+	}
+
+	int active_count = active_bodies.size();
+
+	_process(active_count, _integrate_forces_job);
+
+	for (int i = 0; i < active_count; i++) {
+		active_bodies[i]->commit_forces();
 	}
 
 	p_space->set_active_objects(active_count);
@@ -163,14 +259,12 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 
 	/* GENERATE CONSTRAINT ISLANDS */
 
-	Body2DSW *island_list = NULL;
-	Constraint2DSW *constraint_island_list = NULL;
-	b = body_list->first();
+	body_islands.clear();
+	constraint_islands.clear();
 
-	int island_count = 0;
+	for (int i = 0; i < active_count; i++) {
 
-	while (b) {
-		Body2DSW *body = b->self();
+		Body2DSW *body = active_bodies[i];
 
 		if (body->get_island_step() != _step) {
 
@@ -178,19 +272,15 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 			Constraint2DSW *constraint_island = NULL;
 			_populate_island(body, &island, &constraint_island);
 
-			island->set_island_list_next(island_list);
-			island_list = island;
+			body_islands.push_back(island);
 
 			if (constraint_island) {
-				constraint_island->set_island_list_next(constraint_island_list);
-				constraint_island_list = constraint_island;
-				island_count++;
+				constraint_islands.push_back(constraint_island);
 			}
 		}
-		b = b->next();
 	}
 
-	p_space->set_island_count(island_count);
+	p_space->set_island_count(constraint_islands.size());
 
 	const SelfList<Area2DSW>::List &aml = p_space->get_moved_area_list();
 
@@ -202,8 +292,7 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 				continue;
 			c->set_island_step(_step);
 			c->set_island_next(NULL);
-			c->set_island_list_next(constraint_island_list);
-			constraint_island_list = c;
+			constraint_islands.push_back(c);
 		}
 		p_space->area_remove_from_moved_list((SelfList<Area2DSW> *)aml.first()); //faster to remove here
 	}
@@ -219,40 +308,34 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 	/* SETUP CONSTRAINT ISLANDS */
 
 	{
-		Constraint2DSW *ci = constraint_island_list;
-		Constraint2DSW *prev_ci = NULL;
-		while (ci) {
-
-			if (_setup_island(ci, p_delta) == true) {
+		// Islands touching shared objects are set up here in order, the rest in parallel.
+		parallel_setup_islands.clear();
+		island_removed_root.resize(constraint_islands.size());
 
-				//removed the root from the island graph because it is not to be processed
+		for (int i = 0; i < constraint_islands.size(); i++) {
 
-				Constraint2DSW *next = ci->get_island_next();
+			Constraint2DSW *island = constraint_islands[i];
 
-				if (next) {
-					//root from list being deleted no longer exists, replace by next
-					next->set_island_list_next(ci->get_island_list_next());
-					if (prev_ci) {
-						prev_ci->set_island_list_next(next);
-					} else {
-						constraint_island_list = next;
-					}
-					prev_ci = next;
-				} else {
-
-					//list is empty, just skip
-					if (prev_ci) {
-						prev_ci->set_island_list_next(ci->get_island_list_next());
+			bool parallel = true;
+			for (Constraint2DSW *ci = island; ci && parallel; ci = ci->get_island_next()) {
+				parallel = ci->can_setup_in_parallel();
+			}
 
-					} else {
-						constraint_island_list = ci->get_island_list_next();
-					}
-				}
+			if (parallel) {
+				parallel_setup_islands.push_back(i);
 			} else {
-				prev_ci = ci;
+				island_removed_root[i] = _setup_island(island, p_delta);
 			}
+		}
 
-			ci = ci->get_island_list_next();
+		_process(parallel_setup_islands.size(), _setup_island_job);
+
+		for (int i = 0; i < constraint_islands.size(); i++) {
+
+			if (island_removed_root[i]) {
+				//removed the root from the island graph because it is not to be processed, may leave the island empty
+				constraint_islands[i] = constraint_islands[i]->get_island_next();
+			}
 		}
 	}
 
@@ -264,14 +347,7 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 
 	/* SOLVE CONSTRAINT ISLANDS */
 
-	{
-		Constraint2DSW *ci = constraint_island_list;
-		while (ci) {
-			//iterating each island separatedly improves cache efficiency
-			_solve_island(ci, p_iterations, p_delta);
-			ci = ci->get_island_list_next();
-		}
-	}
+	_process(constraint_islands.size(), _solve_island_job);
 
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
@@ -281,23 +357,28 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 
 	/* INTEGRATE VELOCITIES */
 
+	active_bodies.clear();
+
 	b = body_list->first();
 	while (b) {
 
-		const SelfList<Body2DSW> *n = b->next();
-		b->self()->integrate_velocities(p_delta);
-		b = n; // in case it shuts itself down
+		active_bodies.push_back(b->self());
+		b = b->next();
+	}
+
+	_process(active_bodies.size(), _integrate_velocities_job);
+
+	for (int i = 0; i < active_bodies.size(); i++) {
+		active_bodies[i]->commit_velocities();
 	}
 
 	/* SLEEP / WAKE UP ISLANDS */
 
-	{
-		Body2DSW *bi = island_list;
-		while (bi) {
+	island_can_sleep.resize(body_islands.size());
+	_process(body_islands.size(), _sleep_test_job);
 
-			_check_suspend(bi, p_delta);
-			bi = bi->get_island_list_next();
-		}
+	for (int i = 0; i < body_islands.size(); i++) {
+		_check_suspend(body_islands[i], island_can_sleep[i]);
 	}
 
 	{ //profile
@@ -314,4 +395,11 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 Step2DSW::Step2DSW() {
 
 	_step = 1;
+
+	// -1 uses every thread of the job system, 1 or 0 keeps the whole step on the physics thread.
+	thread_count = GLOBAL_DEF("physics/2d/thread_count", -1);
+	ProjectSettings::get_singleton()->set_custom_property_info("physics/2d/thread_count", PropertyInfo(Variant::INT, "physics/2d/thread_count", PROPERTY_HINT_RANGE, "-1,64,1"));
+
+	step_delta = 0;
+	step_iterations = 0;
 }
@@ -30,16 +30,39 @@
 #ifndef STEP_2D_SW_H
 #define STEP_2D_SW_H
 
+#include "os/job_system.h"
 #include "space_2d_sw.h"
 
 class Step2DSW {
 
 	uint64_t _step;
 
+	// Islands share no dynamic bodies, so each one is processed by a single thread and the
+	// results don't depend on how many threads are used.
+	int thread_count;
+	real_t step_delta;
+	int step_iterations;
+
+	Vector<Body2DSW *> active_bodies;
+	Vector<Body2DSW *> body_islands;
+	Vector<Constraint2DSW *> constraint_islands;
+	Vector<int> parallel_setup_islands;
+	Vector<uint8_t> island_removed_root;
+	Vector<uint8_t> island_can_sleep;
+
 	void _populate_island(Body2DSW *p_body, Body2DSW **p_island, Constraint2DSW **p_constraint_island);
 	bool _setup_island(Constraint2DSW *p_island, real_t p_delta);
 	void _solve_island(Constraint2DSW *p_island, int p_iterations, real_t p_delta);
-	void _check_suspend(Body2DSW *p_island, real_t p_delta);
+	bool _can_island_sleep(Body2DSW *p_island, real_t p_delta);
+	void _check_suspend(Body2DSW *p_island, bool p_can_sleep);
+
+	void _process(int p_count, JobSystem::JobFunc p_func);
+
+	static void _integrate_forces_job(void *p_step, uint32_t p_index);
+	static void _setup_island_job(void *p_step, uint32_t p_index);
+	static void _solve_island_job(void *p_step, uint32_t p_index);
+	static void _integrate_velocities_job(void *p_step, uint32_t p_index);
+	static void _sleep_test_job(void *p_step, uint32_t p_index);
 
 public:
 	void step(Space2DSW *p_space, real_t p_delta, int p_iterations);
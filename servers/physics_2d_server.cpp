@@ -331,6 +331,232 @@ Dictionary Physics2DDirectSpaceState::_get_rest_info(const Ref<Physics2DShapeQue
 	return r;
 }
 
+Dictionary Physics2DDirectSpaceState::_intersect_ray_batch(const PoolVector<Vector2> &p_from, const PoolVector<Vector2> &p_to, const Vector<RID> &p_exclude, uint32_t p_layers) {
+
+	ERR_FAIL_COND_V(p_from.size() != p_to.size(), Dictionary());
+
+	int count = p_from.size();
+	Vector<RayResult> results;
+	results.resize(count);
+	Vector<bool> hits;
+	hits.resize(count);
+
+	{
+		PoolVector<Vector2>::Read from = p_from.read();
+		PoolVector<Vector2>::Read to = p_to.read();
+		intersect_ray_batch(from.ptr(), to.ptr(), count, results.ptrw(), hits.ptrw(), p_exclude, p_layers);
+	}
+
+	PoolVector<uint8_t> hit;
+	hit.resize(count);
+	PoolVector<Vector2> position;
+	position.resize(count);
+	PoolVector<Vector2> normal;
+	normal.resize(count);
+	PoolVector<int> collider_id;
+	collider_id.resize(count);
+	PoolVector<int> shape;
+	shape.resize(count);
+	Array rid;
+	rid.resize(count);
+	Array metadata;
+	metadata.resize(count);
+
+	{
+		PoolVector<uint8_t>::Write hitw = hit.write();
+		PoolVector<Vector2>::Write positionw = position.write();
+		PoolVector<Vector2>::Write normalw = normal.write();
+		PoolVector<int>::Write collider_idw = collider_id.write();
+		PoolVector<int>::Write shapew = shape.write();
+
+		for (int i = 0; i < count; i++) {
+
+			hitw[i] = hits[i];
+			if (!hits[i]) {
+				positionw[i] = Vector2();
+				normalw[i] = Vector2();
+				collider_idw[i] = 0;
+				shapew[i] = -1;
+				continue;
+			}
+
+			positionw[i] = results[i].position;
+			normalw[i] = results[i].normal;
+			collider_idw[i] = results[i].collider_id;
+			shapew[i] = results[i].shape;
+			rid[i] = results[i].rid;
+			metadata[i] = results[i].metadata;
+		}
+	}
+
+	Dictionary d;
+	d["hit"] = hit;
+	d["position"] = position;
+	d["normal"] = normal;
+	d["collider_id"] = collider_id;
+	d["shape"] = shape;
+	d["rid"] = rid;
+	d["metadata"] = metadata;
+
+	return d;
+}
+
+Dictionary Physics2DDirectSpaceState::_intersect_shape_batch(const Ref<Physics2DShapeQueryParameters> &p_shape_query, const PoolVector<Vector2> &p_origins, int p_max_results) {
+
+	ERR_FAIL_COND_V(p_shape_query.is_null(), Dictionary());
+	ERR_FAIL_COND_V(p_max_results <= 0, Dictionary());
+
+	int count = p_origins.size();
+	Vector<Transform2D> xforms;
+	xforms.resize(count);
+	{
+		PoolVector<Vector2>::Read origins = p_origins.read();
+		for (int i = 0; i < count; i++) {
+			xforms[i] = p_shape_query->transform;
+			xforms[i].set_origin(origins[i]);
+		}
+	}
+
+	Vector<ShapeResult> results;
+	results.resize(count * p_max_results);
+	Vector<int> result_counts;
+	result_counts.resize(count);
+
+	Vector<RID> exclude = p_shape_query->get_exclude();
+	intersect_shape_batch(p_shape_query->shape, xforms.ptr(), count, p_shape_query->motion, p_shape_query->margin, results.ptrw(), p_max_results, result_counts.ptrw(), exclude, p_shape_query->collision_mask);
+
+	int total = 0;
+	for (int i = 0; i < count; i++) {
+		total += result_counts[i];
+	}
+
+	// results of all the queries one after the other, "count" tells how many each one got
+	PoolVector<int> counts;
+	counts.resize(count);
+	PoolVector<int> collider_id;
+	collider_id.resize(total);
+	PoolVector<int> shape;
+	shape.resize(total);
+	Array rid;
+	rid.resize(total);
+	Array metadata;
+	metadata.resize(total);
+
+	{
+		PoolVector<int>::Write countsw = counts.write();
+		PoolVector<int>::Write collider_idw = collider_id.write();
+		PoolVector<int>::Write shapew = shape.write();
+
+		int idx = 0;
+		for (int i = 0; i < count; i++) {
+
+			countsw[i] = result_counts[i];
+			for (int j = 0; j < result_counts[i]; j++) {
+
+				const ShapeResult &sr = results[i * p_max_results + j];
+				collider_idw[idx] = sr.collider_id;
+				shapew[idx] = sr.shape;
+				rid[idx] = sr.rid;
+				metadata[idx] = sr.metadata;
+				idx++;
+			}
+		}
+	}
+
+	Dictionary d;
+	d["count"] = counts;
+	d["collider_id"] = collider_id;
+	d["shape"] = shape;
+	d["rid"] = rid;
+	d["metadata"] = metadata;
+
+	return d;
+}
+
+Dictionary Physics2DDirectSpaceState::_cast_motion_batch(const Ref<Physics2DShapeQueryParameters> &p_shape_query, const PoolVector<Vector2> &p_origins, const PoolVector<Vector2> &p_motions) {
+
+	ERR_FAIL_COND_V(p_shape_query.is_null(), Dictionary());
+	ERR_FAIL_COND_V(p_origins.size() != p_motions.size(), Dictionary());
+
+	int count = p_origins.size();
+	Vector<Transform2D> xforms;
+	xforms.resize(count);
+	{
+		PoolVector<Vector2>::Read origins = p_origins.read();
+		for (int i = 0; i < count; i++) {
+			xforms[i] = p_shape_query->transform;
+			xforms[i].set_origin(origins[i]);
+		}
+	}
+
+	PoolVector<real_t> safe;
+	safe.resize(count);
+	PoolVector<real_t> unsafe;
+	unsafe.resize(count);
+
+	{
+		Vector<RID> exclude = p_shape_query->get_exclude();
+		PoolVector<Vector2>::Read motions = p_motions.read();
+		PoolVector<real_t>::Write safew = safe.write();
+		PoolVector<real_t>::Write unsafew = unsafe.write();
+		cast_motion_batch(p_shape_query->shape, xforms.ptr(), motions.ptr(), count, p_shape_query->margin, safew.ptr(), unsafew.ptr(), exclude, p_shape_query->collision_mask);
+	}
+
+	Dictionary d;
+	d["safe"] = safe;
+	d["unsafe"] = unsafe;
+
+	return d;
+}
+
+int Physics2DDirectSpaceState::intersect_ray_batch(const Vector2 *p_from, const Vector2 *p_to, int p_count, RayResult *r_results, bool *r_hits, const Vector<RID> &p_exclude, uint32_t p_collision_layer) {
+
+	Set<RID> exclude;
+	for (int i = 0; i < p_exclude.size(); i++)
+		exclude.insert(p_exclude[i]);
+
+	int hits = 0;
+	for (int i = 0; i < p_count; i++) {
+
+		r_hits[i] = intersect_ray(p_from[i], p_to[i], r_results[i], exclude, p_collision_layer);
+		if (r_hits[i])
+			hits++;
+	}
+
+	return hits;
+}
+
+void Physics2DDirectSpaceState::intersect_shape_batch(const RID &p_shape, const Transform2D *p_xforms, int p_count, const Vector2 &p_motion, real_t p_margin, ShapeResult *r_results, int p_result_max, int *r_result_counts, const Vector<RID> &p_exclude, uint32_t p_collision_layer) {
+
+	Set<RID> exclude;
+	for (int i = 0; i < p_exclude.size(); i++)
+		exclude.insert(p_exclude[i]);
+
+	for (int i = 0; i < p_count; i++) {
+
+		r_result_counts[i] = intersect_shape(p_shape, p_xforms[i], p_motion, p_margin, &r_results[i * p_result_max], p_result_max, exclude, p_collision_layer);
+	}
+}
+
+void Physics2DDirectSpaceState::cast_motion_batch(const RID &p_shape, const Transform2D *p_xforms, const Vector2 *p_motions, int p_count, real_t p_margin, real_t *r_closest_safe, real_t *r_closest_unsafe, const Vector<RID> &p_exclude, uint32_t p_collision_layer) {
+
+	Set<RID> exclude;
+	for (int i = 0; i < p_exclude.size(); i++)
+		exclude.insert(p_exclude[i]);
+
+	for (int i = 0; i < p_count; i++) {
+
+		float closest_safe, closest_unsafe;
+		if (cast_motion(p_shape, p_xforms[i], p_motions[i], p_margin, closest_safe, closest_unsafe, exclude, p_collision_layer)) {
+			r_closest_safe[i] = closest_safe;
+			r_closest_unsafe[i] = closest_unsafe;
+		} else {
+			r_closest_safe[i] = 0;
+			r_closest_unsafe[i] = 0;
+		}
+	}
+}
+
 Physics2DDirectSpaceState::Physics2DDirectSpaceState() {
 }
 
@@ -342,6 +568,9 @@ void Physics2DDirectSpaceState::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("cast_motion", "shape"), &Physics2DDirectSpaceState::_cast_motion);
 	ClassDB::bind_method(D_METHOD("collide_shape", "shape", "max_results"), &Physics2DDirectSpaceState::_collide_shape, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("get_rest_info", "shape"), &Physics2DDirectSpaceState::_get_rest_info);
+	ClassDB::bind_method(D_METHOD("intersect_ray_batch", "from", "to", "exclude", "collision_layer"), &Physics2DDirectSpaceState::_intersect_ray_batch, DEFVAL(Array()), DEFVAL(0x7FFFFFFF));
+	ClassDB::bind_method(D_METHOD("intersect_shape_batch", "shape", "origins", "max_results"), &Physics2DDirectSpaceState::_intersect_shape_batch, DEFVAL(32));
+	ClassDB::bind_method(D_METHOD("cast_motion_batch", "shape", "origins", "motions"), &Physics2DDirectSpaceState::_cast_motion_batch);
 	//ClassDB::bind_method(D_METHOD("cast_motion","shape","xform","motion","exclude","umask"),&Physics2DDirectSpaceState::_intersect_shape,DEFVAL(Array()),DEFVAL(0));
 }
 
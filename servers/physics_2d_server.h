@@ -137,6 +137,10 @@ class Physics2DDirectSpaceState : public Object {
 	Array _collide_shape(const Ref<Physics2DShapeQueryParameters> &p_shape_query, int p_max_results = 32);
 	Dictionary _get_rest_info(const Ref<Physics2DShapeQueryParameters> &p_shape_query);
 
+	Dictionary _intersect_ray_batch(const PoolVector<Vector2> &p_from, const PoolVector<Vector2> &p_to, const Vector<RID> &p_exclude = Vector<RID>(), uint32_t p_layers = 0);
+	Dictionary _intersect_shape_batch(const Ref<Physics2DShapeQueryParameters> &p_shape_query, const PoolVector<Vector2> &p_origins, int p_max_results = 32);
+	Dictionary _cast_motion_batch(const Ref<Physics2DShapeQueryParameters> &p_shape_query, const PoolVector<Vector2> &p_origins, const PoolVector<Vector2> &p_motions);
+
 protected:
 	static void _bind_methods();
 
@@ -184,6 +188,18 @@ public:
 
 	virtual bool rest_info(RID p_shape, const Transform2D &p_shape_xform, const Vector2 &p_motion, float p_margin, ShapeRestInfo *r_info, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_layer = 0xFFFFFFFF) = 0;
 
+	/* BATCHED QUERIES */
+
+	// Answer many queries of one kind in a single call, all sharing the same exclude list and layers.
+	// Servers may spread them over worker threads; the default versions run the queries above one by one.
+
+	// Returns how many rays hit something, r_hits tells which ones.
+	virtual int intersect_ray_batch(const Vector2 *p_from, const Vector2 *p_to, int p_count, RayResult *r_results, bool *r_hits, const Vector<RID> &p_exclude = Vector<RID>(), uint32_t p_collision_layer = 0xFFFFFFFF);
+	// r_results has room for p_result_max results per query, the ones of query i start at i * p_result_max.
+	virtual void intersect_shape_batch(const RID &p_shape, const Transform2D *p_xforms, int p_count, const Vector2 &p_motion, real_t p_margin, ShapeResult *r_results, int p_result_max, int *r_result_counts, const Vector<RID> &p_exclude = Vector<RID>(), uint32_t p_collision_layer = 0xFFFFFFFF);
+	// Shapes that already collide where they start can't move at all, both fractions are 0 for them.
+	virtual void cast_motion_batch(const RID &p_shape, const Transform2D *p_xforms, const Vector2 *p_motions, int p_count, real_t p_margin, real_t *r_closest_safe, real_t *r_closest_unsafe, const Vector<RID> &p_exclude = Vector<RID>(), uint32_t p_collision_layer = 0xFFFFFFFF);
+
 	Physics2DDirectSpaceState();
 };
 
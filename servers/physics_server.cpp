@@ -325,6 +325,222 @@ Dictionary PhysicsDirectSpaceState::_get_rest_info(const Ref<PhysicsShapeQueryPa
 	return r;
 }
 
+Dictionary PhysicsDirectSpaceState::_intersect_ray_batch(const PoolVector<Vector3> &p_from, const PoolVector<Vector3> &p_to, const Vector<RID> &p_exclude, uint32_t p_collision_mask) {
+
+	ERR_FAIL_COND_V(p_from.size() != p_to.size(), Dictionary());
+
+	int count = p_from.size();
+	Vector<RayResult> results;
+	results.resize(count);
+	Vector<bool> hits;
+	hits.resize(count);
+
+	{
+		PoolVector<Vector3>::Read from = p_from.read();
+		PoolVector<Vector3>::Read to = p_to.read();
+		intersect_ray_batch(from.ptr(), to.ptr(), count, results.ptrw(), hits.ptrw(), p_exclude, p_collision_mask);
+	}
+
+	PoolVector<uint8_t> hit;
+	hit.resize(count);
+	PoolVector<Vector3> position;
+	position.resize(count);
+	PoolVector<Vector3> normal;
+	normal.resize(count);
+	PoolVector<int> collider_id;
+	collider_id.resize(count);
+	PoolVector<int> shape;
+	shape.resize(count);
+	Array rid;
+	rid.resize(count);
+
+	{
+		PoolVector<uint8_t>::Write hitw = hit.write();
+		PoolVector<Vector3>::Write positionw = position.write();
+		PoolVector<Vector3>::Write normalw = normal.write();
+		PoolVector<int>::Write collider_idw = collider_id.write();
+		PoolVector<int>::Write shapew = shape.write();
+
+		for (int i = 0; i < count; i++) {
+
+			hitw[i] = hits[i];
+			if (!hits[i]) {
+				positionw[i] = Vector3();
+				normalw[i] = Vector3();
+				collider_idw[i] = 0;
+				shapew[i] = -1;
+				continue;
+			}
+
+			positionw[i] = results[i].position;
+			normalw[i] = results[i].normal;
+			collider_idw[i] = results[i].collider_id;
+			shapew[i] = results[i].shape;
+			rid[i] = results[i].rid;
+		}
+	}
+
+	Dictionary d;
+	d["hit"] = hit;
+	d["position"] = position;
+	d["normal"] = normal;
+	d["collider_id"] = collider_id;
+	d["shape"] = shape;
+	d["rid"] = rid;
+
+	return d;
+}
+
+Dictionary PhysicsDirectSpaceState::_intersect_shape_batch(const Ref<PhysicsShapeQueryParameters> &p_shape_query, const PoolVector<Vector3> &p_origins, int p_max_results) {
+
+	ERR_FAIL_COND_V(p_shape_query.is_null(), Dictionary());
+	ERR_FAIL_COND_V(p_max_results <= 0, Dictionary());
+
+	int count = p_origins.size();
+	Vector<Transform> xforms;
+	xforms.resize(count);
+	{
+		PoolVector<Vector3>::Read origins = p_origins.read();
+		for (int i = 0; i < count; i++) {
+			xforms[i] = Transform(p_shape_query->transform.basis, origins[i]);
+		}
+	}
+
+	Vector<ShapeResult> results;
+	results.resize(count * p_max_results);
+	Vector<int> result_counts;
+	result_counts.resize(count);
+
+	Vector<RID> exclude = p_shape_query->get_exclude();
+	intersect_shape_batch(p_shape_query->shape, xforms.ptr(), count, p_shape_query->margin, results.ptrw(), p_max_results, result_counts.ptrw(), exclude, p_shape_query->collision_mask);
+
+	int total = 0;
+	for (int i = 0; i < count; i++) {
+		total += result_counts[i];
+	}
+
+	// results of all the queries one after the other, "count" tells how many each one got
+	PoolVector<int> counts;
+	counts.resize(count);
+	PoolVector<int> collider_id;
+	collider_id.resize(total);
+	PoolVector<int> shape;
+	shape.resize(total);
+	Array rid;
+	rid.resize(total);
+
+	{
+		PoolVector<int>::Write countsw = counts.write();
+		PoolVector<int>::Write collider_idw = collider_id.write();
+		PoolVector<int>::Write shapew = shape.write();
+
+		int idx = 0;
+		for (int i = 0; i < count; i++) {
+
+			countsw[i] = result_counts[i];
+			for (int j = 0; j < result_counts[i]; j++) {
+
+				const ShapeResult &sr = results[i * p_max_results + j];
+				collider_idw[idx] = sr.collider_id;
+				shapew[idx] = sr.shape;
+				rid[idx] = sr.rid;
+				idx++;
+			}
+		}
+	}
+
+	Dictionary d;
+	d["count"] = counts;
+	d["collider_id"] = collider_id;
+	d["shape"] = shape;
+	d["rid"] = rid;
+
+	return d;
+}
+
+Dictionary PhysicsDirectSpaceState::_cast_motion_batch(const Ref<PhysicsShapeQueryParameters> &p_shape_query, const PoolVector<Vector3> &p_origins, const PoolVector<Vector3> &p_motions) {
+
+	ERR_FAIL_COND_V(p_shape_query.is_null(), Dictionary());
+	ERR_FAIL_COND_V(p_origins.size() != p_motions.size(), Dictionary());
+
+	int count = p_origins.size();
+	Vector<Transform> xforms;
+	xforms.resize(count);
+	{
+		PoolVector<Vector3>::Read origins = p_origins.read();
+		for (int i = 0; i < count; i++) {
+			xforms[i] = Transform(p_shape_query->transform.basis, origins[i]);
+		}
+	}
+
+	PoolVector<real_t> safe;
+	safe.resize(count);
+	PoolVector<real_t> unsafe;
+	unsafe.resize(count);
+
+	{
+		Vector<RID> exclude = p_shape_query->get_exclude();
+		PoolVector<Vector3>::Read motions = p_motions.read();
+		PoolVector<real_t>::Write safew = safe.write();
+		PoolVector<real_t>::Write unsafew = unsafe.write();
+		cast_motion_batch(p_shape_query->shape, xforms.ptr(), motions.ptr(), count, p_shape_query->margin, safew.ptr(), unsafew.ptr(), exclude, p_shape_query->collision_mask);
+	}
+
+	Dictionary d;
+	d["safe"] = safe;
+	d["unsafe"] = unsafe;
+
+	return d;
+}
+
+int PhysicsDirectSpaceState::intersect_ray_batch(const Vector3 *p_from, const Vector3 *p_to, int p_count, RayResult *r_results, bool *r_hits, const Vector<RID> &p_exclude, uint32_t p_collision_mask, bool p_pick_ray) {
+
+	Set<RID> exclude;
+	for (int i = 0; i < p_exclude.size(); i++)
+		exclude.insert(p_exclude[i]);
+
+	int hits = 0;
+	for (int i = 0; i < p_count; i++) {
+
+		r_hits[i] = intersect_ray(p_from[i], p_to[i], r_results[i], exclude, p_collision_mask, p_pick_ray);
+		if (r_hits[i])
+			hits++;
+	}
+
+	return hits;
+}
+
+void PhysicsDirectSpaceState::intersect_shape_batch(const RID &p_shape, const Transform *p_xforms, int p_count, real_t p_margin, ShapeResult *r_results, int p_result_max, int *r_result_counts, const Vector<RID> &p_exclude, uint32_t p_collision_mask) {
+
+	Set<RID> exclude;
+	for (int i = 0; i < p_exclude.size(); i++)
+		exclude.insert(p_exclude[i]);
+
+	for (int i = 0; i < p_count; i++) {
+
+		r_result_counts[i] = intersect_shape(p_shape, p_xforms[i], p_margin, &r_results[i * p_result_max], p_result_max, exclude, p_collision_mask);
+	}
+}
+
+void PhysicsDirectSpaceState::cast_motion_batch(const RID &p_shape, const Transform *p_xforms, const Vector3 *p_motions, int p_count, real_t p_margin, real_t *r_closest_safe, real_t *r_closest_unsafe, const Vector<RID> &p_exclude, uint32_t p_collision_mask) {
+
+	Set<RID> exclude;
+	for (int i = 0; i < p_exclude.size(); i++)
+		exclude.insert(p_exclude[i]);
+
+	for (int i = 0; i < p_count; i++) {
+
+		float closest_safe, closest_unsafe;
+		if (cast_motion(p_shape, p_xforms[i], p_motions[i], p_margin, closest_safe, closest_unsafe, exclude, p_collision_mask)) {
+			r_closest_safe[i] = closest_safe;
+			r_closest_unsafe[i] = closest_unsafe;
+		} else {
+			r_closest_safe[i] = 0;
+			r_closest_unsafe[i] = 0;
+		}
+	}
+}
+
 PhysicsDirectSpaceState::PhysicsDirectSpaceState() {
 }
 
@@ -338,6 +554,10 @@ void PhysicsDirectSpaceState::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("cast_motion", "shape", "motion"), &PhysicsDirectSpaceState::_cast_motion);
 	ClassDB::bind_method(D_METHOD("collide_shape", "shape", "max_results"), &PhysicsDirectSpaceState::_collide_shape, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("get_rest_info", "shape"), &PhysicsDirectSpaceState::_get_rest_info);
+
+	ClassDB::bind_method(D_METHOD("intersect_ray_batch", "from", "to", "exclude", "collision_layer"), &PhysicsDirectSpaceState::_intersect_ray_batch, DEFVAL(Array()), DEFVAL(0x7FFFFFFF));
+	ClassDB::bind_method(D_METHOD("intersect_shape_batch", "shape", "origins", "max_results"), &PhysicsDirectSpaceState::_intersect_shape_batch, DEFVAL(32));
+	ClassDB::bind_method(D_METHOD("cast_motion_batch", "shape", "origins", "motions"), &PhysicsDirectSpaceState::_cast_motion_batch);
 }
 
 int PhysicsShapeQueryResult::get_result_count() const {
@@ -137,6 +137,10 @@ private:
 	Array _collide_shape(const Ref<PhysicsShapeQueryParameters> &p_shape_query, int p_max_results = 32);
 	Dictionary _get_rest_info(const Ref<PhysicsShapeQueryParameters> &p_shape_query);
 
+	Dictionary _intersect_ray_batch(const PoolVector<Vector3> &p_from, const PoolVector<Vector3> &p_to, const Vector<RID> &p_exclude = Vector<RID>(), uint32_t p_collision_mask = 0);
+	Dictionary _intersect_shape_batch(const Ref<PhysicsShapeQueryParameters> &p_shape_query, const PoolVector<Vector3> &p_origins, int p_max_results = 32);
+	Dictionary _cast_motion_batch(const Ref<PhysicsShapeQueryParameters> &p_shape_query, const PoolVector<Vector3> &p_origins, const PoolVector<Vector3> &p_motions);
+
 protected:
 	static void _bind_methods();
 
@@ -183,6 +187,18 @@ public:
 
 	virtual Vector3 get_closest_point_to_object_volume(RID p_object, const Vector3 p_point) const = 0;
 
+	/* BATCHED QUERIES */
+
+	// Answer many queries of one kind in a single call, all sharing the same exclude list and mask.
+	// Servers may spread them over worker threads; the default versions run the queries above one by one.
+
+	// Returns how many rays hit something, r_hits tells which ones.
+	virtual int intersect_ray_batch(const Vector3 *p_from, const Vector3 *p_to, int p_count, RayResult *r_results, bool *r_hits, const Vector<RID> &p_exclude = Vector<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_pick_ray = false);
+	// r_results has room for p_result_max results per query, the ones of query i start at i * p_result_max.
+	virtual void intersect_shape_batch(const RID &p_shape, const Transform *p_xforms, int p_count, real_t p_margin, ShapeResult *r_results, int p_result_max, int *r_result_counts, const Vector<RID> &p_exclude = Vector<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF);
+	// Shapes that already collide where they start can't move at all, both fractions are 0 for them.
+	virtual void cast_motion_batch(const RID &p_shape, const Transform *p_xforms, const Vector3 *p_motions, int p_count, real_t p_margin, real_t *r_closest_safe, real_t *r_closest_unsafe, const Vector<RID> &p_exclude = Vector<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF);
+
 	PhysicsDirectSpaceState();
 };
 
@@ -80,8 +80,7 @@ void VisualServerCanvas::_render_canvas_item(Item *p_canvas_item, const Transfor
 		return;
 
 	int child_item_count = ci->child_items.size();
-	Item **child_items = (Item **)alloca(child_item_count * sizeof(Item *));
-	copymem(child_items, ci->child_items.ptr(), child_item_count * sizeof(Item *));
+	Item *const *child_items = ci->child_items.ptr();
 
 	if (ci->clip) {
 		if (p_canvas_clip != NULL) {
@@ -97,8 +96,13 @@ void VisualServerCanvas::_render_canvas_item(Item *p_canvas_item, const Transfor
 
 	if (ci->sort_y) {
 
+		// sorted in a copy, the children keep their order
+		Item **sorted_items = frame_arena.alloc_array<Item *>(child_item_count);
+		copymem(sorted_items, child_items, child_item_count * sizeof(Item *));
+
 		SortArray<Item *, ItemPtrSort> sorter;
-		sorter.sort(child_items, child_item_count);
+		sorter.sort(sorted_items, child_item_count);
+		child_items = sorted_items;
 	}
 
 	if (ci->z_relative)
@@ -173,6 +177,8 @@ void VisualServerCanvas::_light_mask_canvas_items(int p_z, RasterizerCanvas::Ite
 
 void VisualServerCanvas::render_canvas(Canvas *p_canvas, const Transform2D &p_transform, RasterizerCanvas::Light *p_lights, RasterizerCanvas::Light *p_masked_lights, const Rect2 &p_clip_rect) {
 
+	frame_arena.reset();
+
 	VSG::canvas_render->canvas_begin();
 
 	if (p_canvas->children_order_dirty) {
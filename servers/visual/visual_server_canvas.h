@@ -30,6 +30,7 @@
 #ifndef VISUALSERVERCANVAS_H
 #define VISUALSERVERCANVAS_H
 
+#include "frame_arena.h"
 #include "rasterizer.h"
 #include "visual_server_viewport.h"
 
@@ -144,6 +145,8 @@ public:
 	RID_Owner<RasterizerCanvas::Light> canvas_light_owner;
 
 private:
+	FrameArena frame_arena; // scratch data of the canvas being rendered
+
 	void _render_canvas_item_tree(Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, RasterizerCanvas::Light *p_lights);
 	void _render_canvas_item(Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RasterizerCanvas::Item **z_list, RasterizerCanvas::Item **z_last_list, Item *p_canvas_clip, Item *p_material_owner);
 	void _light_mask_canvas_items(int p_z, RasterizerCanvas::Item *p_canvas_item, RasterizerCanvas::Light *p_masked_lights);
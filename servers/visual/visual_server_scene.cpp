@@ -1248,7 +1248,39 @@ void VisualServerScene::_update_instance_lightmap_captures(Instance *p_instance)
 	}
 }
 
-void VisualServerScene::_light_instance_update_shadow(Instance *p_instance, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_shadow_atlas, Scenario *p_scenario) {
+VisualServerScene::Instance **VisualServerScene::_get_shadow_cull_buffer(int p_index) {
+
+	while (shadow_cull_buffers.size() <= p_index) {
+		shadow_cull_buffers.push_back((Instance **)memalloc(sizeof(Instance *) * MAX_INSTANCE_CULL));
+	}
+
+	return shadow_cull_buffers[p_index];
+}
+
+// The planes are left for the caller to fill.
+VisualServerScene::ShadowPass &VisualServerScene::_add_shadow_pass(Instance *p_light, int p_pass, int p_plane_count, const Plane &p_near_plane) {
+
+	ShadowPass pass;
+	pass.light = p_light;
+	pass.pass = p_pass;
+	pass.planes = frame_arena.alloc_array<Plane>(p_plane_count);
+	pass.plane_count = p_plane_count;
+	pass.near_plane = p_near_plane;
+	pass.far = 0;
+	pass.split = 0;
+	pass.bias_scale = 1.0;
+	pass.restore_transform = false;
+	pass.fit_depth = false;
+	pass.depth_min = 0;
+	pass.depth_max = 0;
+	pass.cull_result = _get_shadow_cull_buffer(shadow_passes.size());
+	pass.cull_count = 0;
+
+	shadow_passes.push_back(pass);
+	return shadow_passes[shadow_passes.size() - 1];
+}
+
+void VisualServerScene::_light_instance_setup_shadow(Instance *p_instance, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, Scenario *p_scenario) {
 
 	InstanceLightData *light = static_cast<InstanceLightData *>(p_instance->base_data);
 
@@ -1268,8 +1300,10 @@ void VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 
 			if (depth_range_mode == VS::LIGHT_DIRECTIONAL_SHADOW_DEPTH_RANGE_OPTIMIZED) {
 				//optimize min/max
-				Vector<Plane> planes = p_cam_projection.get_projection_planes(p_cam_transform);
-				int cull_count = p_scenario->octree.cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
+				Plane planes[6];
+				p_cam_projection.get_projection_planes(p_cam_transform, planes);
+				Instance **cull_result = _get_shadow_cull_buffer(shadow_passes.size()); // not taken by a pass yet
+				int cull_count = p_scenario->octree.cull_convex(planes, 6, cull_result, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
 				Plane base(p_cam_transform.origin, -p_cam_transform.basis.get_axis(2));
 				//check distance max and min
 
@@ -1279,7 +1313,7 @@ void VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 
 				for (int i = 0; i < cull_count; i++) {
 
-					Instance *instance = instance_shadow_cull_result[i];
+					Instance *instance = cull_result[i];
 					if (!instance->visible || !((1 << instance->base_type) & VS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
 						continue;
 					}
@@ -1447,59 +1481,30 @@ void VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 
 				//now that we now all ranges, we can proceed to make the light frustum planes, for culling octree
 
-				Vector<Plane> light_frustum_planes;
-				light_frustum_planes.resize(6);
+				Plane near_plane(p_instance->transform.origin, -p_instance->transform.basis.get_axis(2));
+
+				ShadowPass &pass = _add_shadow_pass(p_instance, i, 6, near_plane);
 
 				//right/left
-				light_frustum_planes[0] = Plane(x_vec, x_max);
-				light_frustum_planes[1] = Plane(-x_vec, -x_min);
+				pass.planes[0] = Plane(x_vec, x_max);
+				pass.planes[1] = Plane(-x_vec, -x_min);
 				//top/bottom
-				light_frustum_planes[2] = Plane(y_vec, y_max);
-				light_frustum_planes[3] = Plane(-y_vec, -y_min);
+				pass.planes[2] = Plane(y_vec, y_max);
+				pass.planes[3] = Plane(-y_vec, -y_min);
 				//near/far
-				light_frustum_planes[4] = Plane(z_vec, z_max + 1e6);
-				light_frustum_planes[5] = Plane(-z_vec, -z_min); // z_min is ok, since casters further than far-light plane are not needed
-
-				int cull_count = p_scenario->octree.cull_convex(light_frustum_planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
-
-				// a pre pass will need to be needed to determine the actual z-near to be used
-
-				Plane near_plane(p_instance->transform.origin, -p_instance->transform.basis.get_axis(2));
-
-				for (int j = 0; j < cull_count; j++) {
-
-					float min, max;
-					Instance *instance = instance_shadow_cull_result[j];
-					if (!instance->visible || !((1 << instance->base_type) & VS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
-						cull_count--;
-						SWAP(instance_shadow_cull_result[j], instance_shadow_cull_result[cull_count]);
-						j--;
-						continue;
-					}
-
-					instance->transformed_aabb.project_range_in_plane(Plane(z_vec, 0), min, max);
-					instance->depth = near_plane.distance_to(instance->transform.origin);
-					instance->depth_layer = 0;
-					if (max > z_max)
-						z_max = max;
-				}
-
-				{
-
-					CameraMatrix ortho_camera;
-					real_t half_x = (x_max_cam - x_min_cam) * 0.5;
-					real_t half_y = (y_max_cam - y_min_cam) * 0.5;
-
-					ortho_camera.set_orthogonal(-half_x, half_x, -half_y, half_y, 0, (z_max - z_min_cam));
-
-					Transform ortho_transform;
-					ortho_transform.basis = transform.basis;
-					ortho_transform.origin = x_vec * (x_min_cam + half_x) + y_vec * (y_min_cam + half_y) + z_vec * z_max;
-
-					VSG::scene_render->light_instance_set_shadow_transform(light->instance, ortho_camera, ortho_transform, 0, distances[i + 1], i, bias_scale);
-				}
-
-				VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
+				pass.planes[4] = Plane(z_vec, z_max + 1e6);
+				pass.planes[5] = Plane(-z_vec, -z_min); // z_min is ok, since casters further than far-light plane are not needed
+
+				// the depth range is completed by the casters found when culling
+				pass.fit_depth = true;
+				pass.depth_axis = z_vec;
+				pass.depth_min = z_min_cam;
+				pass.depth_max = z_max;
+				pass.half_size = Vector2(x_max_cam - x_min_cam, y_max_cam - y_min_cam) * 0.5;
+				pass.transform.basis = transform.basis;
+				pass.transform.origin = x_vec * (x_min_cam + pass.half_size.x) + y_vec * (y_min_cam + pass.half_size.y);
+				pass.split = distances[i + 1];
+				pass.bias_scale = bias_scale;
 			}
 
 		} break;
@@ -1517,32 +1522,16 @@ void VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 						float radius = VSG::storage->light_get_param(p_instance->base, VS::LIGHT_PARAM_RANGE);
 
 						float z = i == 0 ? -1 : 1;
-						Vector<Plane> planes;
-						planes.resize(5);
-						planes[0] = p_instance->transform.xform(Plane(Vector3(0, 0, z), radius));
-						planes[1] = p_instance->transform.xform(Plane(Vector3(1, 0, z).normalized(), radius));
-						planes[2] = p_instance->transform.xform(Plane(Vector3(-1, 0, z).normalized(), radius));
-						planes[3] = p_instance->transform.xform(Plane(Vector3(0, 1, z).normalized(), radius));
-						planes[4] = p_instance->transform.xform(Plane(Vector3(0, -1, z).normalized(), radius));
-
-						int cull_count = p_scenario->octree.cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
 						Plane near_plane(p_instance->transform.origin, p_instance->transform.basis.get_axis(2) * z);
 
-						for (int j = 0; j < cull_count; j++) {
-
-							Instance *instance = instance_shadow_cull_result[j];
-							if (!instance->visible || !((1 << instance->base_type) & VS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
-								cull_count--;
-								SWAP(instance_shadow_cull_result[j], instance_shadow_cull_result[cull_count]);
-								j--;
-							} else {
-								instance->depth = near_plane.distance_to(instance->transform.origin);
-								instance->depth_layer = 0;
-							}
-						}
-
-						VSG::scene_render->light_instance_set_shadow_transform(light->instance, CameraMatrix(), p_instance->transform, radius, 0, i);
-						VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
+						ShadowPass &pass = _add_shadow_pass(p_instance, i, 5, near_plane);
+						pass.planes[0] = p_instance->transform.xform(Plane(Vector3(0, 0, z), radius));
+						pass.planes[1] = p_instance->transform.xform(Plane(Vector3(1, 0, z).normalized(), radius));
+						pass.planes[2] = p_instance->transform.xform(Plane(Vector3(-1, 0, z).normalized(), radius));
+						pass.planes[3] = p_instance->transform.xform(Plane(Vector3(0, 1, z).normalized(), radius));
+						pass.planes[4] = p_instance->transform.xform(Plane(Vector3(0, -1, z).normalized(), radius));
+						pass.transform = p_instance->transform;
+						pass.far = radius;
 					}
 				} break;
 				case VS::LIGHT_OMNI_SHADOW_CUBE: {
@@ -1574,31 +1563,17 @@ void VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 
 						Transform xform = p_instance->transform * Transform().looking_at(view_normals[i], view_up[i]);
 
-						Vector<Plane> planes = cm.get_projection_planes(xform);
-
-						int cull_count = p_scenario->octree.cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
-
 						Plane near_plane(xform.origin, -xform.basis.get_axis(2));
-						for (int j = 0; j < cull_count; j++) {
 
-							Instance *instance = instance_shadow_cull_result[j];
-							if (!instance->visible || !((1 << instance->base_type) & VS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
-								cull_count--;
-								SWAP(instance_shadow_cull_result[j], instance_shadow_cull_result[cull_count]);
-								j--;
-							} else {
-								instance->depth = near_plane.distance_to(instance->transform.origin);
-								instance->depth_layer = 0;
-							}
-						}
-
-						VSG::scene_render->light_instance_set_shadow_transform(light->instance, cm, xform, radius, 0, i);
-						VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
+						ShadowPass &pass = _add_shadow_pass(p_instance, i, 6, near_plane);
+						cm.get_projection_planes(xform, pass.planes);
+						pass.projection = cm;
+						pass.transform = xform;
+						pass.far = radius;
+						//restore the regular DP matrix after the last face
+						pass.restore_transform = i == 5;
 					}
 
-					//restore the regular DP matrix
-					VSG::scene_render->light_instance_set_shadow_transform(light->instance, CameraMatrix(), p_instance->transform, radius, 0, 0);
-
 				} break;
 			}
 
@@ -1611,30 +1586,186 @@ void VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 			CameraMatrix cm;
 			cm.set_perspective(angle * 2.0, 1.0, 0.01, radius);
 
-			Vector<Plane> planes = cm.get_projection_planes(p_instance->transform);
-			int cull_count = p_scenario->octree.cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
-
 			Plane near_plane(p_instance->transform.origin, -p_instance->transform.basis.get_axis(2));
-			for (int j = 0; j < cull_count; j++) {
 
-				Instance *instance = instance_shadow_cull_result[j];
-				if (!instance->visible || !((1 << instance->base_type) & VS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
-					cull_count--;
-					SWAP(instance_shadow_cull_result[j], instance_shadow_cull_result[cull_count]);
-					j--;
-				} else {
-					instance->depth = near_plane.distance_to(instance->transform.origin);
-					instance->depth_layer = 0;
-				}
-			}
-
-			VSG::scene_render->light_instance_set_shadow_transform(light->instance, cm, p_instance->transform, radius, 0, 0);
-			VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, 0, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
+			ShadowPass &pass = _add_shadow_pass(p_instance, 0, 6, near_plane);
+			cm.get_projection_planes(p_instance->transform, pass.planes);
+			pass.projection = cm;
+			pass.transform = p_instance->transform;
+			pass.far = radius;
 
 		} break;
 	}
 }
 
+void VisualServerScene::_light_instance_render_shadow(ShadowPass &p_pass, RID p_shadow_atlas) {
+
+	InstanceLightData *light = static_cast<InstanceLightData *>(p_pass.light->base_data);
+
+	for (int i = 0; i < p_pass.cull_count; i++) {
+
+		Instance *instance = p_pass.cull_result[i];
+		instance->depth = p_pass.near_plane.distance_to(instance->transform.origin);
+		instance->depth_layer = 0;
+	}
+
+	if (p_pass.fit_depth) {
+
+		p_pass.projection.set_orthogonal(-p_pass.half_size.x, p_pass.half_size.x, -p_pass.half_size.y, p_pass.half_size.y, 0, p_pass.depth_max - p_pass.depth_min);
+		p_pass.transform.origin += p_pass.depth_axis * p_pass.depth_max;
+	}
+
+	VSG::scene_render->light_instance_set_shadow_transform(light->instance, p_pass.projection, p_pass.transform, p_pass.far, p_pass.split, p_pass.pass, p_pass.bias_scale);
+	VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, p_pass.pass, (RasterizerScene::InstanceBase **)p_pass.cull_result, p_pass.cull_count);
+
+	if (p_pass.restore_transform) {
+		VSG::scene_render->light_instance_set_shadow_transform(light->instance, CameraMatrix(), p_pass.light->transform, p_pass.far, 0, 0);
+	}
+}
+
+void VisualServerScene::_process(int p_count, JobSystem::JobFunc p_func, int p_grain) {
+
+	JobSystem *job_system = JobSystem::get_singleton();
+
+	if (!job_system || job_system->get_thread_count() == 0 || p_count <= p_grain) {
+
+		for (int i = 0; i < p_count; i++) {
+			p_func(this, i);
+		}
+		return;
+	}
+
+	job_system->parallel_for(p_count, p_func, this, p_grain);
+}
+
+void VisualServerScene::_cull_views(Scenario *p_scenario, bool p_camera) {
+
+	cull_scenario = p_scenario;
+	cull_camera = p_camera;
+	cull_camera_count = 0;
+	cull_shadow_passes = shadow_passes.ptrw();
+
+	_process(shadow_passes.size() + (p_camera ? 1 : 0), _cull_view_job);
+}
+
+void VisualServerScene::_cull_view_job(void *p_self, uint32_t p_index) {
+
+	VisualServerScene *self = (VisualServerScene *)p_self;
+
+	if (self->cull_camera) {
+
+		if (p_index == 0) {
+			self->cull_camera_count = self->cull_scenario->octree.cull_convex_read_only(self->cull_camera_planes, 6, self->instance_cull_result, MAX_INSTANCE_CULL);
+			return;
+		}
+
+		p_index--;
+	}
+
+	ShadowPass &pass = self->cull_shadow_passes[p_index];
+
+	int cull_count = self->cull_scenario->octree.cull_convex_read_only(pass.planes, pass.plane_count, pass.cull_result, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
+
+	for (int j = 0; j < cull_count; j++) {
+
+		Instance *instance = pass.cull_result[j];
+		if (!instance->visible || !((1 << instance->base_type) & VS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
+			cull_count--;
+			SWAP(pass.cull_result[j], pass.cull_result[cull_count]);
+			j--;
+			continue;
+		}
+
+		if (pass.fit_depth) {
+
+			float min, max;
+			instance->transformed_aabb.project_range_in_plane(Plane(pass.depth_axis, 0), min, max);
+			if (max > pass.depth_max)
+				pass.depth_max = max;
+		}
+	}
+
+	pass.cull_count = cull_count;
+}
+
+void VisualServerScene::_filter_instance_job(void *p_self, uint32_t p_index) {
+
+	VisualServerScene *self = (VisualServerScene *)p_self;
+	Instance *ins = self->instance_cull_result[p_index];
+	uint8_t &state = self->instance_cull_state[p_index];
+
+	if ((self->cull_layer_mask & ins->layer_mask) == 0 || !ins->visible) {
+
+		state = INSTANCE_CULL_DISCARD;
+		return;
+	}
+
+	if (ins->base_type == VS::INSTANCE_LIGHT || ins->base_type == VS::INSTANCE_REFLECTION_PROBE || ins->base_type == VS::INSTANCE_GI_PROBE) {
+
+		// they touch lists shared by all instances
+		state = INSTANCE_CULL_PROCESS;
+		return;
+	}
+
+	if (!((1 << ins->base_type) & VS::INSTANCE_GEOMETRY_MASK) || ins->cast_shadows == VS::SHADOW_CASTING_SETTING_SHADOWS_ONLY) {
+
+		state = INSTANCE_CULL_DISCARD;
+		return;
+	}
+
+	InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(ins->base_data);
+
+	if (geom->lighting_dirty) {
+		int l = 0;
+		//only called when lights AABB enter/exit this geometry
+		ins->light_instances.resize(geom->lighting.size());
+
+		for (List<Instance *>::Element *E = geom->lighting.front(); E; E = E->next()) {
+
+			InstanceLightData *light = static_cast<InstanceLightData *>(E->get()->base_data);
+
+			ins->light_instances[l++] = light->instance;
+		}
+
+		geom->lighting_dirty = false;
+	}
+
+	if (geom->reflection_dirty) {
+		int l = 0;
+		//only called when reflection probe AABB enter/exit this geometry
+		ins->reflection_probe_instances.resize(geom->reflection_probes.size());
+
+		for (List<Instance *>::Element *E = geom->reflection_probes.front(); E; E = E->next()) {
+
+			InstanceReflectionProbeData *reflection_probe = static_cast<InstanceReflectionProbeData *>(E->get()->base_data);
+
+			ins->reflection_probe_instances[l++] = reflection_probe->instance;
+		}
+
+		geom->reflection_dirty = false;
+	}
+
+	if (geom->gi_probes_dirty) {
+		int l = 0;
+		//only called when reflection probe AABB enter/exit this geometry
+		ins->gi_probe_instances.resize(geom->gi_probes.size());
+
+		for (List<Instance *>::Element *E = geom->gi_probes.front(); E; E = E->next()) {
+
+			InstanceGIProbeData *gi_probe = static_cast<InstanceGIProbeData *>(E->get()->base_data);
+
+			ins->gi_probe_instances[l++] = gi_probe->probe_instance;
+		}
+
+		geom->gi_probes_dirty = false;
+	}
+
+	ins->depth = self->cull_near_plane.distance_to(ins->transform.origin);
+	ins->depth_layer = CLAMP(int(ins->depth * 16 / self->cull_z_far), 0, 15);
+
+	state = ins->base_type == VS::INSTANCE_PARTICLES ? INSTANCE_CULL_KEEP_PARTICLES : INSTANCE_CULL_KEEP;
+}
+
 void VisualServerScene::render_camera(RID p_camera, RID p_scenario, Size2 p_viewport_size, RID p_shadow_atlas) {
 	// render to mono camera
 
@@ -1702,166 +1833,159 @@ void VisualServerScene::_render_scene(const Transform p_cam_transform, const Cam
 
 	//rasterizer->set_camera(camera->transform, camera_matrix,ortho);
 
-	Vector<Plane> planes = p_cam_projection.get_projection_planes(p_cam_transform);
+	shadow_passes.reset();
+	frame_arena.reset();
+
+	Plane planes[6];
+	p_cam_projection.get_projection_planes(p_cam_transform, planes);
 
 	Plane near_plane(p_cam_transform.origin, -p_cam_transform.basis.get_axis(2).normalized());
 	float z_far = p_cam_projection.get_z_far();
 
 	/* STEP 2 - CULL */
-	int cull_count = scenario->octree.cull_convex(planes, instance_cull_result, MAX_INSTANCE_CULL);
-	light_cull_count = 0;
 
-	reflection_probe_cull_count = 0;
+	// directional shadows only depend on the camera, so they are culled along with it
+	Instance **lights_with_shadow = (Instance **)alloca(sizeof(Instance *) * scenario->directional_lights.size());
+	int directional_shadow_count = 0;
 
-	//light_samplers_culled=0;
+	// room is kept for the directional lights after the positional ones, so all that get a shadow here are added in step 5
+	int directional_reserved = 0;
 
-	/*	print_line("OT: "+rtos( (OS::get_singleton()->get_ticks_usec()-t)/1000.0));
-	print_line("OTO: "+itos(p_scenario->octree.get_octant_count()));
-	//print_line("OTE: "+itos(p_scenario->octree.get_elem_count()));
-	print_line("OTP: "+itos(p_scenario->octree.get_pair_count()));
-*/
+	for (List<Instance *>::Element *E = scenario->directional_lights.front(); E; E = E->next()) {
 
-	/* STEP 3 - PROCESS PORTALS, VALIDATE ROOMS */
-	//removed, will replace with culling
-
-	/* STEP 4 - REMOVE FURTHER CULLED OBJECTS, ADD LIGHTS */
-
-	for (int i = 0; i < cull_count; i++) {
-
-		Instance *ins = instance_cull_result[i];
-
-		bool keep = false;
+		if (directional_reserved >= MAX_LIGHTS_CULLED) {
+			break;
+		}
 
-		if ((camera_layer_mask & ins->layer_mask) == 0) {
+		if (!E->get()->visible || !E->get()->base_data)
+			continue;
 
-			//failure
-		} else if (ins->base_type == VS::INSTANCE_LIGHT && ins->visible) {
+		directional_reserved++;
 
-			if (ins->visible && light_cull_count < MAX_LIGHTS_CULLED) {
+		if (p_shadow_atlas.is_valid() && VSG::storage->light_has_shadow(E->get()->base)) {
+			lights_with_shadow[directional_shadow_count++] = E->get();
+		}
+	}
 
-				InstanceLightData *light = static_cast<InstanceLightData *>(ins->base_data);
+	VSG::scene_render->set_directional_shadow_count(directional_shadow_count);
 
-				if (!light->geometries.empty()) {
-					//do not add this light if no geometry is affected by it..
-					light_cull_result[light_cull_count] = ins;
-					light_instance_cull_result[light_cull_count] = light->instance;
-					if (p_shadow_atlas.is_valid() && VSG::storage->light_has_shadow(ins->base)) {
-						VSG::scene_render->light_instance_mark_visible(light->instance); //mark it visible for shadow allocation later
-					}
+	shadow_passes.clear();
+	for (int i = 0; i < directional_shadow_count; i++) {
 
-					light_cull_count++;
-				}
-			}
-		} else if (ins->base_type == VS::INSTANCE_REFLECTION_PROBE && ins->visible) {
+		_light_instance_setup_shadow(lights_with_shadow[i], p_cam_transform, p_cam_projection, p_cam_orthogonal, scenario);
+	}
 
-			if (ins->visible && reflection_probe_cull_count < MAX_REFLECTION_PROBES_CULLED) {
+	cull_camera_planes = planes;
+	_cull_views(scenario, true);
 
-				InstanceReflectionProbeData *reflection_probe = static_cast<InstanceReflectionProbeData *>(ins->base_data);
+	int cull_count = cull_camera_count;
+	light_cull_count = 0;
 
-				if (p_reflection_probe != reflection_probe->instance) {
-					//avoid entering The Matrix
+	reflection_probe_cull_count = 0;
 
-					if (!reflection_probe->geometries.empty()) {
-						//do not add this light if no geometry is affected by it..
+	//light_samplers_culled=0;
 
-						if (reflection_probe->reflection_dirty || VSG::scene_render->reflection_probe_instance_needs_redraw(reflection_probe->instance)) {
-							if (!reflection_probe->update_list.in_list()) {
-								reflection_probe->render_step = 0;
-								reflection_probe_render_list.add_last(&reflection_probe->update_list);
-							}
+	/*	print_line("OT: "+rtos( (OS::get_singleton()->get_ticks_usec()-t)/1000.0));
+	print_line("OTO: "+itos(p_scenario->octree.get_octant_count()));
+	//print_line("OTE: "+itos(p_scenario->octree.get_elem_count()));
+	print_line("OTP: "+itos(p_scenario->octree.get_pair_count()));
+*/
 
-							reflection_probe->reflection_dirty = false;
-						}
+	/* STEP 3 - PROCESS PORTALS, VALIDATE ROOMS */
+	//removed, will replace with culling
 
-						if (VSG::scene_render->reflection_probe_instance_has_reflection(reflection_probe->instance)) {
-							reflection_probe_instance_cull_result[reflection_probe_cull_count] = reflection_probe->instance;
-							reflection_probe_cull_count++;
-						}
-					}
-				}
-			}
+	/* STEP 4 - REMOVE FURTHER CULLED OBJECTS, ADD LIGHTS */
 
-		} else if (ins->base_type == VS::INSTANCE_GI_PROBE && ins->visible) {
+	// geometry is processed on the job system, the rest goes through the lists of the scene here
+	cull_layer_mask = camera_layer_mask;
+	cull_near_plane = near_plane;
+	cull_z_far = z_far;
+	_process(cull_count, _filter_instance_job, 128);
 
-			InstanceGIProbeData *gi_probe = static_cast<InstanceGIProbeData *>(ins->base_data);
-			if (!gi_probe->update_element.in_list()) {
-				gi_probe_update_list.add(&gi_probe->update_element);
-			}
+	int keep_count = 0;
 
-		} else if (((1 << ins->base_type) & VS::INSTANCE_GEOMETRY_MASK) && ins->visible && ins->cast_shadows != VS::SHADOW_CASTING_SETTING_SHADOWS_ONLY) {
+	for (int i = 0; i < cull_count; i++) {
 
-			keep = true;
+		Instance *ins = instance_cull_result[i];
 
-			InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(ins->base_data);
+		switch (instance_cull_state[i]) {
 
-			if (ins->base_type == VS::INSTANCE_PARTICLES) {
+			case INSTANCE_CULL_KEEP_PARTICLES: {
 				//particles visible? process them
 				VSG::storage->particles_request_process(ins->base);
 				//particles visible? request redraw
 				VisualServerRaster::redraw_request();
-			}
+			} // fallthrough
+			case INSTANCE_CULL_KEEP: {
 
-			if (geom->lighting_dirty) {
-				int l = 0;
-				//only called when lights AABB enter/exit this geometry
-				ins->light_instances.resize(geom->lighting.size());
-
-				for (List<Instance *>::Element *E = geom->lighting.front(); E; E = E->next()) {
+				instance_cull_result[keep_count++] = ins;
+				ins->last_render_pass = render_pass;
+				continue;
+			} break;
+			case INSTANCE_CULL_PROCESS: {
 
-					InstanceLightData *light = static_cast<InstanceLightData *>(E->get()->base_data);
+				if (ins->base_type == VS::INSTANCE_LIGHT) {
 
-					ins->light_instances[l++] = light->instance;
-				}
+					if (light_cull_count < MAX_LIGHTS_CULLED - directional_reserved) {
 
-				geom->lighting_dirty = false;
-			}
+						InstanceLightData *light = static_cast<InstanceLightData *>(ins->base_data);
 
-			if (geom->reflection_dirty) {
-				int l = 0;
-				//only called when reflection probe AABB enter/exit this geometry
-				ins->reflection_probe_instances.resize(geom->reflection_probes.size());
+						if (!light->geometries.empty()) {
+							//do not add this light if no geometry is affected by it..
+							light_cull_result[light_cull_count] = ins;
+							light_instance_cull_result[light_cull_count] = light->instance;
+							if (p_shadow_atlas.is_valid() && VSG::storage->light_has_shadow(ins->base)) {
+								VSG::scene_render->light_instance_mark_visible(light->instance); //mark it visible for shadow allocation later
+							}
 
-				for (List<Instance *>::Element *E = geom->reflection_probes.front(); E; E = E->next()) {
+							light_cull_count++;
+						}
+					}
+				} else if (ins->base_type == VS::INSTANCE_REFLECTION_PROBE) {
 
-					InstanceReflectionProbeData *reflection_probe = static_cast<InstanceReflectionProbeData *>(E->get()->base_data);
+					if (reflection_probe_cull_count < MAX_REFLECTION_PROBES_CULLED) {
 
-					ins->reflection_probe_instances[l++] = reflection_probe->instance;
-				}
+						InstanceReflectionProbeData *reflection_probe = static_cast<InstanceReflectionProbeData *>(ins->base_data);
 
-				geom->reflection_dirty = false;
-			}
+						if (p_reflection_probe != reflection_probe->instance) {
+							//avoid entering The Matrix
 
-			if (geom->gi_probes_dirty) {
-				int l = 0;
-				//only called when reflection probe AABB enter/exit this geometry
-				ins->gi_probe_instances.resize(geom->gi_probes.size());
+							if (!reflection_probe->geometries.empty()) {
+								//do not add this light if no geometry is affected by it..
 
-				for (List<Instance *>::Element *E = geom->gi_probes.front(); E; E = E->next()) {
+								if (reflection_probe->reflection_dirty || VSG::scene_render->reflection_probe_instance_needs_redraw(reflection_probe->instance)) {
+									if (!reflection_probe->update_list.in_list()) {
+										reflection_probe->render_step = 0;
+										reflection_probe_render_list.add_last(&reflection_probe->update_list);
+									}
 
-					InstanceGIProbeData *gi_probe = static_cast<InstanceGIProbeData *>(E->get()->base_data);
+									reflection_probe->reflection_dirty = false;
+								}
 
-					ins->gi_probe_instances[l++] = gi_probe->probe_instance;
-				}
+								if (VSG::scene_render->reflection_probe_instance_has_reflection(reflection_probe->instance)) {
+									reflection_probe_instance_cull_result[reflection_probe_cull_count] = reflection_probe->instance;
+									reflection_probe_cull_count++;
+								}
+							}
+						}
+					}
 
-				geom->gi_probes_dirty = false;
-			}
+				} else if (ins->base_type == VS::INSTANCE_GI_PROBE) {
 
-			ins->depth = near_plane.distance_to(ins->transform.origin);
-			ins->depth_layer = CLAMP(int(ins->depth * 16 / z_far), 0, 15);
+					InstanceGIProbeData *gi_probe = static_cast<InstanceGIProbeData *>(ins->base_data);
+					if (!gi_probe->update_element.in_list()) {
+						gi_probe_update_list.add(&gi_probe->update_element);
+					}
+				}
+			} break;
 		}
 
-		if (!keep) {
-			// remove, no reason to keep
-			cull_count--;
-			SWAP(instance_cull_result[i], instance_cull_result[cull_count]);
-			i--;
-			ins->last_render_pass = 0; // make invalid
-		} else {
-
-			ins->last_render_pass = render_pass;
-		}
+		// remove, no reason to keep
+		ins->last_render_pass = 0; // make invalid
 	}
 
+	cull_count = keep_count;
+
 	/* STEP 5 - PROCESS LIGHTS */
 
 	RID *directional_light_ptr = &light_instance_cull_result[light_cull_count];
@@ -1870,9 +1994,6 @@ void VisualServerScene::_render_scene(const Transform p_cam_transform, const Cam
 	// directional lights
 	{
 
-		Instance **lights_with_shadow = (Instance **)alloca(sizeof(Instance *) * scenario->directional_lights.size());
-		int directional_shadow_count = 0;
-
 		for (List<Instance *>::Element *E = scenario->directional_lights.front(); E; E = E->next()) {
 
 			if (light_cull_count + directional_light_count >= MAX_LIGHTS_CULLED) {
@@ -1884,27 +2005,23 @@ void VisualServerScene::_render_scene(const Transform p_cam_transform, const Cam
 
 			InstanceLightData *light = static_cast<InstanceLightData *>(E->get()->base_data);
 
-			//check shadow..
-
 			if (light) {
-				if (p_shadow_atlas.is_valid() && VSG::storage->light_has_shadow(E->get()->base)) {
-					lights_with_shadow[directional_shadow_count++] = E->get();
-				}
 				//add to list
 				directional_light_ptr[directional_light_count++] = light->instance;
 			}
 		}
 
-		VSG::scene_render->set_directional_shadow_count(directional_shadow_count);
-
-		for (int i = 0; i < directional_shadow_count; i++) {
+		for (int i = 0; i < shadow_passes.size(); i++) {
 
-			_light_instance_update_shadow(lights_with_shadow[i], p_cam_transform, p_cam_projection, p_cam_orthogonal, p_shadow_atlas, scenario);
+			_light_instance_render_shadow(shadow_passes[i], p_shadow_atlas);
 		}
 	}
 
 	{ //setup shadow maps
 
+		Instance **lights_to_redraw = (Instance **)alloca(sizeof(Instance *) * MAX(light_cull_count, 1));
+		int redraw_count = 0;
+
 		//SortArray<Instance*,_InstanceLightsort> sorter;
 		//sorter.sort(light_cull_result,light_cull_count);
 		for (int i = 0; i < light_cull_count; i++) {
@@ -1998,7 +2115,26 @@ void VisualServerScene::_render_scene(const Transform p_cam_transform, const Cam
 
 			if (redraw) {
 				//must redraw!
-				_light_instance_update_shadow(ins, p_cam_transform, p_cam_projection, p_cam_orthogonal, p_shadow_atlas, scenario);
+				lights_to_redraw[redraw_count++] = ins;
+			}
+		}
+
+		// cull a few lights at once, so passes of small lights still run in parallel
+		int from = 0;
+
+		while (from < redraw_count) {
+
+			shadow_passes.clear();
+
+			while (from < redraw_count && shadow_passes.size() < SHADOW_CULL_BATCH_PASSES) {
+				_light_instance_setup_shadow(lights_to_redraw[from++], p_cam_transform, p_cam_projection, p_cam_orthogonal, scenario);
+			}
+
+			_cull_views(scenario, false);
+
+			for (int i = 0; i < shadow_passes.size(); i++) {
+
+				_light_instance_render_shadow(shadow_passes[i], p_shadow_atlas);
 			}
 		}
 	}
@@ -3315,7 +3451,8 @@ bool VisualServerScene::free(RID p_rid) {
 
 VisualServerScene *VisualServerScene::singleton = NULL;
 
-VisualServerScene::VisualServerScene() {
+VisualServerScene::VisualServerScene() :
+		shadow_passes(&frame_arena) {
 
 #ifndef NO_THREADS
 	probe_bake_sem = Semaphore::create();
@@ -3326,6 +3463,14 @@ VisualServerScene::VisualServerScene() {
 
 	render_pass = 1;
 	singleton = this;
+
+	cull_scenario = NULL;
+	cull_camera = false;
+	cull_camera_planes = NULL;
+	cull_camera_count = 0;
+	cull_shadow_passes = NULL;
+	cull_layer_mask = 0;
+	cull_z_far = 0;
 }
 
 VisualServerScene::~VisualServerScene() {
@@ -3338,4 +3483,8 @@ VisualServerScene::~VisualServerScene() {
 	memdelete(probe_bake_mutex);
 
 #endif
+
+	for (int i = 0; i < shadow_cull_buffers.size(); i++) {
+		memfree(shadow_cull_buffers[i]);
+	}
 }
@@ -33,8 +33,10 @@
 #include "servers/visual/rasterizer.h"
 
 #include "allocators.h"
+#include "frame_arena.h"
 #include "geometry.h"
 #include "octree.h"
+#include "os/job_system.h"
 #include "os/semaphore.h"
 #include "os/thread.h"
 #include "self_list.h"
@@ -433,8 +435,51 @@ public:
 		}
 	};
 
+	enum {
+		SHADOW_CULL_BATCH_PASSES = 8, // shadow passes of positional lights culled at once
+	};
+
+	enum InstanceCullState {
+		INSTANCE_CULL_DISCARD,
+		INSTANCE_CULL_KEEP,
+		INSTANCE_CULL_KEEP_PARTICLES,
+		INSTANCE_CULL_PROCESS, // lights and probes, handled after the parallel filter
+	};
+
+	// A pass of a shadow map, culled on the job system and rendered afterwards.
+	struct ShadowPass {
+
+		Instance *light;
+		int pass;
+		Plane *planes; // in frame_arena
+		int plane_count;
+		Plane near_plane; // sorts the casters
+
+		CameraMatrix projection;
+		Transform transform;
+		float far;
+		float split;
+		float bias_scale;
+		bool restore_transform; // cube maps leave the dual paraboloid transform when done
+
+		// directional splits fit the depth of the projection to the casters found
+		bool fit_depth;
+		Vector3 depth_axis;
+		real_t depth_min;
+		real_t depth_max;
+		Vector2 half_size;
+
+		Instance **cull_result;
+		int cull_count;
+	};
+
 	Instance *instance_cull_result[MAX_INSTANCE_CULL];
-	Instance *instance_shadow_cull_result[MAX_INSTANCE_CULL]; //used for generating shadowmaps
+	uint8_t instance_cull_state[MAX_INSTANCE_CULL];
+	Vector<Instance **> shadow_cull_buffers; //used for generating shadowmaps, one per pass culled at once
+
+	// scratch data of the scene being rendered, reset when the next one starts
+	FrameArena frame_arena;
+	ArenaVector<ShadowPass> shadow_passes;
 	Instance *light_cull_result[MAX_LIGHTS_CULLED];
 	RID light_instance_cull_result[MAX_LIGHTS_CULLED];
 	int light_cull_count;
@@ -480,7 +525,25 @@ public:
 	_FORCE_INLINE_ void _update_dirty_instance(Instance *p_instance);
 	_FORCE_INLINE_ void _update_instance_lightmap_captures(Instance *p_instance);
 
-	_FORCE_INLINE_ void _light_instance_update_shadow(Instance *p_instance, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_shadow_atlas, Scenario *p_scenario);
+	Instance **_get_shadow_cull_buffer(int p_index);
+	ShadowPass &_add_shadow_pass(Instance *p_light, int p_pass, int p_plane_count, const Plane &p_near_plane);
+	void _light_instance_setup_shadow(Instance *p_instance, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, Scenario *p_scenario);
+	void _light_instance_render_shadow(ShadowPass &p_pass, RID p_shadow_atlas);
+
+	// state of the culling jobs
+	Scenario *cull_scenario;
+	bool cull_camera;
+	const Plane *cull_camera_planes;
+	int cull_camera_count;
+	ShadowPass *cull_shadow_passes;
+	uint32_t cull_layer_mask;
+	Plane cull_near_plane;
+	float cull_z_far;
+
+	void _process(int p_count, JobSystem::JobFunc p_func, int p_grain = 1);
+	void _cull_views(Scenario *p_scenario, bool p_camera);
+	static void _cull_view_job(void *p_self, uint32_t p_index);
+	static void _filter_instance_job(void *p_self, uint32_t p_index);
 
 	void _render_scene(const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_force_environment, uint32_t p_visible_layers, RID p_scenario, RID p_shadow_atlas, RID p_reflection_probe, int p_reflection_probe_pass);
 	void render_empty_scene(RID p_scenario, RID p_shadow_atlas);
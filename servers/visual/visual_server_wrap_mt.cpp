@@ -159,6 +159,58 @@ void VisualServerWrapMT::finish() {
 	canvas_occluder_polygon_free_cached_ids();
 }
 
+Array VisualServerWrapMT::mesh_surface_get_arrays(RID p_mesh, int p_surface) const {
+
+	if (Thread::get_caller_id() == server_thread) {
+		return visual_server->mesh_surface_get_arrays(p_mesh, p_surface);
+	}
+
+	PoolVector<uint8_t> vertex_data;
+	int vertex_len;
+	PoolVector<uint8_t> index_data;
+	int index_len;
+	uint32_t format;
+
+	command_queue.push_ret(visual_server, &VisualServer::mesh_surface_get_array, p_mesh, p_surface, &vertex_data);
+	command_queue.push_ret(visual_server, &VisualServer::mesh_surface_get_array_len, p_mesh, p_surface, &vertex_len);
+	command_queue.push_ret(visual_server, &VisualServer::mesh_surface_get_index_array, p_mesh, p_surface, &index_data);
+	command_queue.push_ret(visual_server, &VisualServer::mesh_surface_get_array_index_len, p_mesh, p_surface, &index_len);
+	command_queue.push_ret(visual_server, &VisualServer::mesh_surface_get_format, p_mesh, p_surface, &format);
+	command_queue.sync_rets();
+
+	ERR_FAIL_COND_V(vertex_data.size() == 0, Array());
+
+	return _get_array_from_surface(format, vertex_data, vertex_len, index_data, index_len);
+}
+
+Array VisualServerWrapMT::mesh_surface_get_blend_shape_arrays(RID p_mesh, int p_surface) const {
+
+	if (Thread::get_caller_id() == server_thread) {
+		return visual_server->mesh_surface_get_blend_shape_arrays(p_mesh, p_surface);
+	}
+
+	Vector<PoolVector<uint8_t> > blend_shape_data;
+	int vertex_len;
+	PoolVector<uint8_t> index_data;
+	int index_len;
+	uint32_t format;
+
+	command_queue.push_ret(visual_server, &VisualServer::mesh_surface_get_blend_shapes, p_mesh, p_surface, &blend_shape_data);
+	command_queue.push_ret(visual_server, &VisualServer::mesh_surface_get_array_len, p_mesh, p_surface, &vertex_len);
+	command_queue.push_ret(visual_server, &VisualServer::mesh_surface_get_index_array, p_mesh, p_surface, &index_data);
+	command_queue.push_ret(visual_server, &VisualServer::mesh_surface_get_array_index_len, p_mesh, p_surface, &index_len);
+	command_queue.push_ret(visual_server, &VisualServer::mesh_surface_get_format, p_mesh, p_surface, &format);
+	command_queue.sync_rets();
+
+	Array blend_shape_array;
+	blend_shape_array.resize(blend_shape_data.size());
+	for (int i = 0; i < blend_shape_data.size(); i++) {
+		blend_shape_array.set(i, _get_array_from_surface(format, blend_shape_data[i], vertex_len, index_data, index_len));
+	}
+
+	return blend_shape_array;
+}
+
 void VisualServerWrapMT::set_use_vsync_callback(bool p_enable) {
 
 	singleton_mt->call_set_use_vsync(p_enable);